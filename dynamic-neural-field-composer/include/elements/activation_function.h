@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <span>
 
 #include "tools/logger.h"
 #include "tools/math.h"
@@ -38,7 +39,7 @@ namespace dnf_composer::element
 
 		/// @brief Apply the activation function in-place into a pre-allocated @p out buffer.
 		/// @p out must already be sized to @p input.size(). No heap allocation occurs.
-		virtual void apply(const std::vector<double>& input, std::vector<double>& out) const = 0;
+		virtual void apply(std::span<const double> input, std::span<double> out) const = 0;
 
 		[[nodiscard]] virtual std::unique_ptr<ActivationFunction> clone() const = 0;
 		[[nodiscard]] virtual std::string toString() const = 0;
@@ -65,7 +66,7 @@ namespace dnf_composer::element
 		SigmoidFunction(double x_shift, double steepness);
 
 		std::vector<double> operator()(const std::vector<double>& input) override;
-		void apply(const std::vector<double>& input, std::vector<double>& out) const override;
+		void apply(std::span<const double> input, std::span<double> out) const override;
 		bool operator==(const SigmoidFunction& other) const;
 		[[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override;
 		[[nodiscard]] std::string toString() const override;
@@ -93,7 +94,7 @@ namespace dnf_composer::element
 		explicit HeavisideFunction(double x_shift);
 
 		std::vector<double> operator()(const std::vector<double>& input) override;
-		void apply(const std::vector<double>& input, std::vector<double>& out) const override;
+		void apply(std::span<const double> input, std::span<double> out) const override;
 		bool operator==(const HeavisideFunction& other) const;
 		[[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override;
 		[[nodiscard]] std::string toString() const override;
@@ -126,7 +127,7 @@ namespace dnf_composer::element
 		AbsSigmoidFunction(double x_shift, double beta);
 
 		std::vector<double> operator()(const std::vector<double>& input) override;
-		void apply(const std::vector<double>& input, std::vector<double>& out) const override;
+		void apply(std::span<const double> input, std::span<double> out) const override;
 		bool operator==(const AbsSigmoidFunction& other) const;
 		[[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override;
 		[[nodiscard]] std::string toString() const override;
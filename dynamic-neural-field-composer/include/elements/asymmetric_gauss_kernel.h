@@ -2,6 +2,7 @@
 
 #include "kernel.h"
 #include "tools/math.h"
+#include "tools/fft_convolution.h"
 
 namespace dnf_composer::element
 {
@@ -65,6 +66,8 @@ namespace dnf_composer::element
 		std::vector<double> gaussDerivative;
 		std::vector<double> scratchExtended;
 		std::vector<double> scratchConvolution;
+		bool useFFT_ = false;                       ///< Spectral path, chosen by tools::math::shouldUseSpectral1D() in init().
+		tools::math::SpectralConvolver1D spectral_; ///< FFTW plans and kernel spectrum for that path.
 	public:
 		/// @brief Construct an AsymmetricGaussKernel.
 		/// @param elementCommonParameters  Name, label, and spatial dimensions.
@@ -100,6 +100,14 @@ namespace dnf_composer::element
 		// wrap-embedding sign convention (see embedWrapped1D in tools/math.h).
 		bool useFFT_ = false;
 		tools::math::SpectralConvolver2D spectral_;
+
+		// Precision::Single (tools/precision.h): the same convolution in float,
+		// directly through direct32_ or spectrally through spectral_ planned in
+		// float. The field comes in as Kernel::singleInput() and the result
+		// stays in float storage until writeOutput() widens it.
+		bool single_ = false;
+		tools::math::SeparableConvolver2DSingle direct32_;
+		std::vector<float> convolution32_;
 	public:
 		AsymmetricGaussKernel2D(const ElementCommonParameters& elementCommonParameters,
 		                        AsymmetricGaussKernel2DParameters  parameters);
@@ -108,6 +116,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		[[nodiscard]] std::string toString() const override;
 		[[nodiscard]] std::shared_ptr<Element> clone() const override;
+		tools::math::SpectralConvolver2D* getSpectralConvolver2D() override { return useFFT_ ? &spectral_ : nullptr; }
 
 		void setParameters(const AsymmetricGaussKernel2DParameters& parameters);
 		[[nodiscard]] AsymmetricGaussKernel2DParameters getParameters() const;
@@ -4,6 +4,7 @@
 
 
 #include "tools/math.h"
+#include "tools/fft_convolution.h"
 #include "element.h"
 
 namespace dnf_composer::element
@@ -69,6 +70,8 @@ namespace dnf_composer::element
 		std::vector<double> correlationKernel; ///< Precomputed normalised Gaussian kernel.
 		std::vector<int> extIndex;             ///< Extended index for circular convolution.
 		std::vector<double> whiteNoise_;       ///< Reusable white-noise buffer (avoids per-step alloc).
+		bool useFFT_ = false;                  ///< Spectral path, chosen by tools::math::shouldUseSpectral1D() in init().
+		tools::math::SpectralConvolver1D spectral_; ///< FFTW plans and kernel spectrum for that path.
 	public:
 		/// @brief Construct a CorrelatedNormalNoise element.
 		/// @param elementCommonParameters  Name, label, and spatial dimensions.
@@ -80,6 +83,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::shared_ptr<Element> clone() const override;
 		std::string toString() const override;
+		bool usesThreadRandomStream() const override { return true; }
 
 		void setParameters(const CorrelatedNormalNoiseParameters& parameters);
 		CorrelatedNormalNoiseParameters getParameters() const;
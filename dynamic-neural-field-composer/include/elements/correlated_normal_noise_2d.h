@@ -69,6 +69,14 @@ namespace dnf_composer::element
 		// before each run rather than compare live stochastic output.
 		bool useFFT_ = false;
 		tools::math::SpectralConvolver2D spectral_;
+
+		// Precision::Single (tools/precision.h): the same convolution in float,
+		// directly through direct32_ or spectrally through spectral_ planned in
+		// float, on float copies of the noise and of the result.
+		bool single_ = false;
+		tools::math::SeparableConvolver2DSingle direct32_;
+		std::vector<float> whiteNoise32_;
+		std::vector<float> conv32_;
 	public:
 		CorrelatedNormalNoise2D(const ElementCommonParameters& elementCommonParameters,
 		                        CorrelatedNormalNoise2DParameters  parameters);
@@ -77,6 +85,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::string toString() const override;
 		std::shared_ptr<Element> clone() const override;
+		bool usesThreadRandomStream() const override { return true; }
 
 		void setParameters(const CorrelatedNormalNoise2DParameters& parameters);
 		CorrelatedNormalNoise2DParameters getParameters() const;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -8,10 +9,13 @@
 #include <ranges>
 #include <algorithm>
 #include <numeric>
+#include <cstdint>
+#include <span>
 
 #include "exceptions/exception.h"
 #include "tools/logger.h"
 #include "element_parameters/element_parameters.h"
+#include "elements/element_components.h"
 
 /// @defgroup elements Elements
 /// @brief DFT element primitives: fields, kernels, stimuli, noise, and couplings.
@@ -23,13 +27,15 @@ namespace dnf_composer::element
 	/// Every element owns a set of named data components (e.g. "activation", "output"),
 	/// a list of input elements, and a list of output elements. Concrete subclasses
 	/// implement the @c init / @c step lifecycle and exchange data via @c addInput().
+	/// Components are looked up by name everywhere except the step path, which
+	/// resolves each name to a ComponentSlot once and indexes by that.
 	///
 	/// @ingroup elements
 	class Element : public std::enable_shared_from_this<Element>
 	{
 	protected:
 		ElementCommonParameters commonParameters;                            ///< Name, label, and spatial dimensions.
-		std::unordered_map<std::string, std::vector<double>> components;    ///< Named data arrays (e.g. "output").
+		ComponentTable components;                                            ///< Named, slot-indexed data arrays (e.g. "output").
 
 		/// Upstream elements and the component they expose. Owning: an element
 		/// depends on its inputs staying alive for as long as it does, so it holds
@@ -48,16 +54,28 @@ namespace dnf_composer::element
 		/// connected", never dereference it.
 		std::map<std::weak_ptr<Element>, std::string, std::owner_less<std::weak_ptr<Element>>> outputs;
 	private:
-		// Caches a pointer to each connected input's *vector object* (not a raw
-		// data() snapshot). A std::vector stored as an unordered_map value keeps its
-		// address stable across resizes (only its internal buffer reallocates), so
+		// Caches a pointer to each connected input's *buffer object* (not a raw
+		// data() snapshot). A ComponentBuffer keeps its address for its element's
+		// lifetime (only its storage moves, on a resize or arena packing), so
 		// re-reading ->size()/data() from it on every updateInput() call can never
 		// dangle -- it always reflects the source's current dimensions, even if the
 		// source was resized via changeDimensions() after this cache was built.
-		std::vector<const std::vector<double>*> cachedInputs;
+		std::vector<const ComponentBuffer*> cachedInputs;
 		double*     inputPtr  = nullptr;
 		std::size_t inputSize = 0;
 
+		// Synchronous (Jacobi) update mode: a copy of each component other
+		// elements can read ("output", and "activation" where it exists), as of
+		// the end of the previous step. Empty unless setFrontBuffered(true).
+		// Deliberately not copied by the copy constructor/assignment -- a clone
+		// starts in the default sequential mode until a Simulation enables it.
+		ComponentTable frontComponents;
+
+		// Bumped by every connection edit that touches this element. Not copied:
+		// a copy is a different element as far as a cached schedule is concerned.
+		std::atomic<std::uint64_t> connectionRevision{ 0 };
+		void bumpConnectionRevision();
+
 		/// @brief Remove any input whose source component no longer fits within
 		///        this element's "input" buffer (e.g. the source was resized larger
 		///        via changeDimensions() after the cache was built, so accumulating
@@ -81,6 +99,15 @@ namespace dnf_composer::element
 		/// override that resizes "input" or another routed-into buffer outside
 		/// of the base class's own changeDimensions()).
 		void invalidateInputCache();
+
+		/// @brief The sources updateInput() would sum into "input", in the order
+		///        it sums them, for a subclass that folds the summation into its
+		///        own step loop (NeuralField's fused step). Builds the cache if
+		///        needed and severs, up front, any source that no longer fits
+		///        "input" -- updateInput() skips such a source and severs it
+		///        afterwards, so the sum is the same -- leaving every returned
+		///        buffer at most as long as "input".
+		std::span<const ComponentBuffer* const> inputSources();
 	public:
 		/// @brief Construct an element with the given common parameters.
 		/// @param parameters  Name, label, and spatial dimensions.
@@ -194,11 +221,11 @@ namespace dnf_composer::element
 		/// @param componentName  E.g. "activation", "output", "input".
 		std::vector<double> getComponent(const std::string& componentName);
 
-		std::vector<double>* getComponentPtr(const std::string& componentName);
+		ComponentBuffer* getComponentPtr(const std::string& componentName);
 		std::vector<std::string> getComponentList() const;
 
-		/// @brief Return a read-only pointer to the full components map.
-		const std::unordered_map<std::string, std::vector<double>>* getComponents() const;
+		/// @brief Return a read-only pointer to the full component table.
+		const ComponentTable* getComponents() const;
 
 		std::vector<std::shared_ptr<Element>> getInputs();
 
@@ -210,5 +237,81 @@ namespace dnf_composer::element
 		///        (without going through removeInput()/removeInputs()) is skipped
 		///        rather than surfaced as a null pointer (#168).
 		std::vector<std::shared_ptr<Element>> getOutputs();
+
+		/// @brief Return the component as other elements should read it during
+		///        step(): the front buffer (the value published at the end of the
+		///        previous step) when front-buffering is on, otherwise the live
+		///        component. Every cross-element read goes through this.
+		/// @throws std::out_of_range if the element has no such component.
+		const ComponentBuffer& getPublishedComponent(const std::string& componentName) const;
+
+		/// @brief Turn front-buffered reads on or off (Simulation's synchronous
+		///        update mode). Enabling snapshots the current "output" and
+		///        "activation" components; either way, downstream input caches
+		///        are invalidated so they re-point at the right buffer.
+		void setFrontBuffered(bool enable);
+		bool isFrontBuffered() const { return !frontComponents.empty(); }
+
+		/// @brief True if other elements read @p componentName from a front buffer.
+		///        Only "output" and "activation" are front-buffered; any other
+		///        component (e.g. "input", a coupling's "weights") is read live even
+		///        in synchronous mode.
+		bool isFrontBuffered(const std::string& componentName) const { return frontComponents.contains(componentName); }
+
+		/// @brief Precision::Single: the live "output" narrowed to float, kept by
+		///        elements whose consumers convolve in float (NeuralField2D), so
+		///        that a 2D kernel reading them skips its own narrowing pass.
+		///        Empty when the element keeps no such copy.
+		virtual std::span<const float> getSingleOutput() const { return {}; }
+
+		/// @brief Copy the live readable components into the front buffers.
+		///        No-op unless front-buffered.
+		void publishFrontBuffers();
+
+		/// @brief Doubles this element's components (and front buffers) need in a
+		///        ComponentArena, each padded to whole cache lines.
+		std::size_t getComponentArenaFootprint() const;
+
+		/// @brief Move this element's components, then its front buffers, into
+		///        @p arena from @p offset on, advancing @p offset past them. Values
+		///        are preserved; the input cache is invalidated, since "input"
+		///        moved. Called by Simulation::init() for every element, in step
+		///        order, after the elements have initialised.
+		void bindComponentArena(const std::shared_ptr<ComponentArena>& arena, std::size_t& offset);
+
+		/// @brief Move the components back into storage of their own.
+		void releaseComponentArena();
+
+		/// @brief Return every element whose components this element reads
+		///        during step(). The parallel scheduler (ElementScheduler) orders
+		///        steps by these edges, so an element that reads anything beyond
+		///        its `inputs` (e.g. FieldCoupling's learning rules reading the
+		///        downstream field's activation) must override this to say so.
+		virtual std::vector<std::shared_ptr<Element>> getStepDependencies();
+
+		/// @brief The subset of getStepDependencies() this element reads a live
+		///        (not front-buffered) component of. In synchronous mode these are
+		///        the only reads that can race, so they are the only edges the
+		///        scheduler keeps. An element whose `inputs` name something other
+		///        than the component it reads, or that reads beyond its `inputs`,
+		///        must override this along with getStepDependencies().
+		virtual std::vector<std::shared_ptr<Element>> getLiveStepDependencies();
+
+		/// @brief True if step() draws from the calling thread's random stream
+		///        (tools::math::fillNormal). The parallel scheduler runs such
+		///        elements on the simulation's own thread, in registry order, so
+		///        a seeded run draws the same sequence at any thread count.
+		virtual bool usesThreadRandomStream() const { return false; }
+
+		/// @brief Counter bumped whenever a connection to or from this element is
+		///        added or removed (both ends of the connection are bumped).
+		std::uint64_t getConnectionRevision() const;
+
+		/// @brief Sum of getConnectionRevision() over @p elements. It changes
+		///        exactly when a connection touching one of them does, so a
+		///        Simulation compares it between steps to know when its cached
+		///        step schedule has gone stale, unaffected by edits in other
+		///        simulations.
+		static std::uint64_t getConnectionRevision(const std::vector<std::shared_ptr<Element>>& elements);
 	};
 }
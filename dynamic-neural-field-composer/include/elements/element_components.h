@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace dnf_composer::element
+{
+	/// @brief Index of a component in its element's ComponentTable.
+	///
+	/// Resolved from the component's name once (ComponentTable::slot()), then
+	/// used on the step path instead of the name, so stepping an element does no
+	/// string hashing or comparison. A slot stays valid for the element's
+	/// lifetime and in its clones: components are never removed, and a copy
+	/// keeps the original's slot order.
+	struct ComponentSlot
+	{
+		std::uint32_t index = 0;
+
+		constexpr bool operator==(const ComponentSlot&) const = default;
+	};
+
+	/// Every element's first two components, created by the Element constructor.
+	inline constexpr ComponentSlot OUTPUT_SLOT{ 0 };
+	inline constexpr ComponentSlot INPUT_SLOT{ 1 };
+
+	/// @brief One 64-byte-aligned block that holds the components of many elements.
+	///
+	/// Simulation::init() sizes one arena for every element it owns and lays their
+	/// components out back to back, in step order, each starting on a cache line
+	/// (see Element::bindComponentArena()). Shared ownership: every ComponentTable
+	/// bound into an arena keeps it alive, so an element that outlives its
+	/// simulation (or is moved to another one) never reads freed memory.
+	class ComponentArena
+	{
+	public:
+		static constexpr std::size_t ALIGNMENT = 64;
+
+		/// @brief Doubles a component of @p size values occupies in an arena:
+		///        @p size rounded up to a whole number of cache lines.
+		static constexpr std::size_t paddedSize(std::size_t size)
+		{
+			constexpr std::size_t perLine = ALIGNMENT / sizeof(double);
+			return (size + perLine - 1) / perLine * perLine;
+		}
+
+		explicit ComponentArena(std::size_t size);
+		~ComponentArena();
+		ComponentArena(const ComponentArena&) = delete;
+		ComponentArena& operator=(const ComponentArena&) = delete;
+
+		double* data() const { return storage; }
+		std::size_t size() const { return count; }
+
+	private:
+		double* storage = nullptr;
+		std::size_t count = 0;
+	};
+
+	/// @brief Contiguous array of doubles holding one element component.
+	///
+	/// A std::vector<double> look-alike (size/data/iterators/resize/assign, and
+	/// comparison with std::vector) whose storage is either its own 64-byte-aligned
+	/// allocation or a region of a ComponentArena. An arena-backed buffer resizes
+	/// in place while the new size fits its region, and moves to its own storage
+	/// when it outgrows it (e.g. after changeDimensions()); the next
+	/// Simulation::init() packs it back into a fresh arena. Copies always own
+	/// their storage.
+	///
+	/// A buffer can also be attached to external storage kept alive by an owner
+	/// object, such as a copy-on-write mapping of a weight file (attach()). Such
+	/// a buffer behaves like an arena-backed one, except that arena packing leaves
+	/// it where it is, so a large mapped matrix is never copied or touched as a
+	/// whole; only the pages that are used are read in.
+	///
+	/// The buffer object's address is stable for its element's lifetime; its
+	/// data() is not (resize, arena packing), so cache the buffer, not data().
+	class ComponentBuffer
+	{
+	public:
+		using value_type = double;
+		using size_type = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = double&;
+		using const_reference = const double&;
+		using pointer = double*;
+		using const_pointer = const double*;
+		using iterator = double*;
+		using const_iterator = const double*;
+
+		ComponentBuffer() = default;
+		explicit ComponentBuffer(size_type size, double value = 0.0);
+		explicit ComponentBuffer(const std::vector<double>& values);
+		ComponentBuffer(const ComponentBuffer& other);
+		ComponentBuffer(ComponentBuffer&& other);
+		ComponentBuffer& operator=(const ComponentBuffer& other);
+		ComponentBuffer& operator=(ComponentBuffer&& other);
+		ComponentBuffer& operator=(const std::vector<double>& values);
+		ComponentBuffer& operator=(std::initializer_list<double> values);
+		~ComponentBuffer();
+
+		size_type size() const { return count; }
+		size_type capacity() const { return regionSize; }
+		bool empty() const { return count == 0; }
+		double* data() { return storage; }
+		const double* data() const { return storage; }
+
+		iterator begin() { return storage; }
+		iterator end() { return storage + count; }
+		const_iterator begin() const { return storage; }
+		const_iterator end() const { return storage + count; }
+		const_iterator cbegin() const { return storage; }
+		const_iterator cend() const { return storage + count; }
+
+		double& operator[](size_type i) { return storage[i]; }
+		const double& operator[](size_type i) const { return storage[i]; }
+		/// @throws std::out_of_range if @p i >= size().
+		double& at(size_type i);
+		const double& at(size_type i) const;
+		double& front() { return storage[0]; }
+		const double& front() const { return storage[0]; }
+		double& back() { return storage[count - 1]; }
+		const double& back() const { return storage[count - 1]; }
+
+		/// @brief Resize, value-initialising (zeroing) any new elements.
+		void resize(size_type size) { resize(size, 0.0); }
+		void resize(size_type size, double value);
+		void assign(size_type size, double value);
+		void assign(const double* first, const double* last);
+		template <typename InputIterator>
+		void assign(InputIterator first, InputIterator last)
+		{
+			const std::vector<double> values(first, last);
+			assign(values.data(), values.data() + values.size());
+		}
+		void clear() { count = 0; }
+		void push_back(double value);
+
+		/// Explicit, so that binding a buffer to a `const std::vector<double>&`
+		/// is a compile error rather than a silent copy on every step.
+		std::vector<double> toVector() const { return { begin(), end() }; }
+		explicit operator std::vector<double>() const { return toVector(); }
+
+		/// @brief True while the values live in a ComponentArena region.
+		bool isArenaBacked() const { return storage != nullptr && !ownsStorage && !backing; }
+
+		/// @brief Use the @p size values at @p values, in place, as this buffer's
+		///        storage. @p owner keeps them valid for as long as the buffer (or
+		///        a buffer it is moved into) uses them; the buffer lets go of it
+		///        when it outgrows them or is assigned another buffer by move.
+		void attach(double* values, size_type size, std::shared_ptr<const void> owner);
+
+		/// @brief True while the values live in storage handed to attach().
+		bool isExternallyBacked() const { return backing != nullptr; }
+
+		/// @brief Copy attached values into storage of the buffer's own and let
+		///        go of their owner, so that, say, a mapped file can be unmapped.
+		///        A no-op unless the buffer is externally backed.
+		void releaseBacking();
+
+		friend bool operator==(const ComponentBuffer& a, const ComponentBuffer& b);
+		friend bool operator==(const ComponentBuffer& a, const std::vector<double>& b);
+
+	private:
+		friend class ComponentTable;
+
+		/// Move the values into [region, region + regionCapacity), which the
+		/// caller guarantees holds at least size() values.
+		void bind(double* region, size_type regionCapacity);
+		/// Move the values out of the arena into owned storage.
+		void unbind();
+		/// Make sure at least @p size values fit, keeping the current ones.
+		void reserveFor(size_type size);
+		/// Forget attached storage without copying it; the buffer is left empty.
+		void detach();
+
+		double* storage = nullptr;
+		size_type count = 0;
+		size_type regionSize = 0;  ///< Capacity of storage: owned, arena region or attached.
+		bool ownsStorage = true;
+		std::shared_ptr<const void> backing;  ///< Owner of attached storage; null otherwise.
+	};
+
+	/// @brief An element's components: named, slot-indexed ComponentBuffers.
+	///
+	/// The string interface (operator[], at, contains, find, iteration as
+	/// name/buffer pairs) mirrors the std::unordered_map it replaces and is the
+	/// compatibility layer for the UI, file I/O and tests. The step path uses
+	/// ComponentSlot instead. Slots are assigned in creation order and never
+	/// removed, and a buffer's address never changes (deque storage), so both
+	/// slots and ComponentBuffer pointers stay valid as components are added.
+	class ComponentTable
+	{
+	public:
+		using value_type = std::pair<const std::string, ComponentBuffer>;
+		using iterator = std::deque<value_type>::iterator;
+		using const_iterator = std::deque<value_type>::const_iterator;
+
+		ComponentTable() = default;
+		ComponentTable(const ComponentTable& other);
+		ComponentTable& operator=(const ComponentTable& other);
+		ComponentTable(ComponentTable&&) noexcept = default;
+		ComponentTable& operator=(ComponentTable&&) noexcept = default;
+
+		/// @brief The buffer named @p name, created empty if there is none.
+		ComponentBuffer& operator[](const std::string& name);
+		ComponentBuffer& operator[](ComponentSlot slot) { return entries[slot.index].second; }
+		const ComponentBuffer& operator[](ComponentSlot slot) const { return entries[slot.index].second; }
+
+		/// @throws std::out_of_range if there is no component named @p name.
+		ComponentBuffer& at(const std::string& name);
+		const ComponentBuffer& at(const std::string& name) const;
+		/// @throws std::out_of_range if there is no component named @p name.
+		ComponentSlot slot(const std::string& name) const;
+
+		bool contains(const std::string& name) const { return find(name) != end(); }
+		iterator find(const std::string& name);
+		const_iterator find(const std::string& name) const;
+
+		iterator begin() { return entries.begin(); }
+		iterator end() { return entries.end(); }
+		const_iterator begin() const { return entries.begin(); }
+		const_iterator end() const { return entries.end(); }
+		std::size_t size() const { return entries.size(); }
+		bool empty() const { return entries.empty(); }
+		void clear();
+
+		/// @brief Doubles this table needs in a ComponentArena. Externally backed
+		///        components need none.
+		std::size_t arenaFootprint() const;
+
+		/// @brief Move every component into @p arena, starting at @p offset
+		///        (a multiple of the cache line) and advancing it past them.
+		///        Externally backed components stay where they are.
+		void bindArena(const std::shared_ptr<ComponentArena>& arena, std::size_t& offset);
+
+		/// @brief Move every component back into its own storage.
+		void releaseArena();
+
+	private:
+		std::shared_ptr<ComponentArena> arena;  ///< Declared first: outlives the buffers pointing into it.
+		std::deque<value_type> entries;
+	};
+}
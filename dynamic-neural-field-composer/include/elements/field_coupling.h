@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "tools/math.h"
+#include "tools/sparse_matrix.h"
 #include "element.h"
 #include "neural_field.h"
 #include "tools/utils.h"
@@ -28,6 +29,35 @@ namespace dnf_composer
 		{LearningRule::DELTA, "Delta"}
 	};
 
+	/// @brief How FieldCoupling stores its weight matrix.
+	/// @ingroup elements
+	enum class WeightStorage : int
+	{
+		DENSE,  ///< All input_size × output_size weights, in components["weights"].
+		SPARSE  ///< Only the weights with |w| > pruneThreshold, in compressed sparse
+		        ///< row form (tools/sparse_matrix.h). components["weights"] is empty.
+	};
+
+	/// @brief Maps WeightStorage values to human-readable strings.
+	inline const std::map<WeightStorage, std::string> WeightStorageToString = {
+		{WeightStorage::DENSE, "Dense"},
+		{WeightStorage::SPARSE, "Sparse"}
+	};
+
+	/// @brief File format FieldCoupling::writeWeights() uses.
+	/// @ingroup elements
+	enum class WeightFileFormat : int
+	{
+		TEXT,   ///< <name>_weights.txt: whitespace-separated values, one input row per line.
+		BINARY  ///< <name>_weights.dnfw: header + raw values, memory-mapped on load (tools/weight_file.h).
+	};
+
+	/// @brief Maps WeightFileFormat values to human-readable strings.
+	inline const std::map<WeightFileFormat, std::string> WeightFileFormatToString = {
+		{WeightFileFormat::TEXT, "Text"},
+		{WeightFileFormat::BINARY, "Binary"}
+	};
+
 	namespace element
 	{
 		/// @brief Parameters for a learned full-matrix field coupling.
@@ -40,6 +70,8 @@ namespace dnf_composer
 			double learningRate;                    ///< Learning rate η (step size for weight updates).
 			double decayRate{0.0};                  ///< Weight decay coefficient, DELTA rule only. 0.0 disables decay.
 			bool isLearningActive{false};                  ///< If true, weights are updated each step.
+			WeightStorage weightStorage{WeightStorage::DENSE}; ///< Dense matrix or pruned sparse (CSR) weights.
+			double pruneThreshold{0.0};             ///< SPARSE only: weights with |w| <= this are dropped. 0.0 drops exact zeros only.
 
 			/// @brief Construct FieldCoupling parameters.
 			/// @param inputFieldDimensions  Dimensions of the source field.
@@ -47,13 +79,18 @@ namespace dnf_composer
 			/// @param scalar                Output scaling factor (default 1.0).
 			/// @param learningRate          Learning rate η (default 0.01).
 			/// @param decayRate             Weight decay coefficient, DELTA rule only (default 0.0, disabled).
+			/// @param weightStorage         Dense or pruned sparse weights (default DENSE).
+			/// @param pruneThreshold        SPARSE only: magnitude at or below which weights are dropped (default 0.0).
 			explicit FieldCouplingParameters(const ElementDimensions& inputFieldDimensions = ElementDimensions{},
 				const LearningRule learningRule = LearningRule::HEBB,
 				const double scalar = 1.0, const double learningRate = 0.01,
-				const double decayRate = 0.0)
+				const double decayRate = 0.0,
+				const WeightStorage weightStorage = WeightStorage::DENSE,
+				const double pruneThreshold = 0.0)
 					: inputFieldDimensions(inputFieldDimensions),
 				learningRule(learningRule), scalar(scalar),
-				learningRate(learningRate), decayRate(decayRate)
+				learningRate(learningRate), decayRate(decayRate),
+				weightStorage(weightStorage), pruneThreshold(pruneThreshold)
 			{}
 
 			bool operator==(const FieldCouplingParameters& other) const
@@ -65,7 +102,9 @@ namespace dnf_composer
 					learningRule == other.learningRule &&
 					std::abs(scalar - other.scalar) < epsilon &&
 					std::abs(learningRate - other.learningRate) < epsilon &&
-					std::abs(decayRate - other.decayRate) < epsilon;
+					std::abs(decayRate - other.decayRate) < epsilon &&
+					weightStorage == other.weightStorage &&
+					std::abs(pruneThreshold - other.pruneThreshold) < epsilon;
 			}
 
 			[[nodiscard]] std::string toString() const override
@@ -77,8 +116,12 @@ namespace dnf_composer
 					<< "Learning rule: " << LearningRuleToString.at(learningRule) << ", "
 					<< "Learning rate: " << learningRate << ", "
 					<< "Decay rate: " << decayRate << ", "
-					<< "Scalar: " << scalar
-					<< "]";
+					<< "Scalar: " << scalar << ", "
+					<< "Weight storage: " << WeightStorageToString.at(weightStorage);
+				if (weightStorage == WeightStorage::SPARSE) {
+					result << ", Prune threshold: " << std::setprecision(6) << pruneThreshold;
+				}
+				result << "]";
 				return result.str();
 			}
 		};
@@ -104,7 +147,17 @@ namespace dnf_composer
 		///    the forward pass, and for DELTA the "pre"/error term, use raw activation
 		///    instead of g(u). HEBB/OJA are unaffected -- they always read "activation".
 		///
-		/// Weights can be persisted to and loaded from disk via @c writeWeights() / @c readWeights().
+		/// Weights can be persisted to and loaded from disk via @c writeWeights() / @c readWeights(),
+		/// as text or as a binary file (see WeightFileFormat).
+		///
+		/// With WeightStorage::SPARSE the weights are pruned by magnitude into a CSR
+		/// matrix (@c getSparseWeights()) and components["weights"] is left empty:
+		/// memory and step time then scale with the retained entries. The forward
+		/// pass and the learning rules visit the retained entries in the dense
+		/// order, so at a prune threshold of 0 the output is bit-identical to DENSE.
+		/// Learning only updates retained entries; a pruned weight stays at zero
+		/// until the coupling is switched back to DENSE (which re-densifies the
+		/// matrix) and, optionally, pruned again.
 		///
 		/// @ingroup elements
 		class FieldCoupling final : public Element
@@ -126,6 +179,16 @@ namespace dnf_composer
 			std::string inputSourceComponent{ "output" }; ///< Component read from `input` ("output" or "activation").
 			std::string targetSourceComponent{ "output" }; ///< Component read from `targetField` ("output" or "activation").
 			std::string weightsDirectory; ///< Directory used for weight serialization.
+			/// Format writeWeights() uses; readWeights() sets it to the format it found.
+			WeightFileFormat weightFileFormat{ WeightFileFormat::TEXT };
+			bool verifyWeightChecksum = false; ///< readWeights() checks a binary file's checksum first.
+			/// The file mapped as the dense weights' storage while components["weights"]
+			/// is externally backed (readWeights()); meaningless otherwise.
+			std::string mappedWeightsFile;
+			ComponentSlot weightsSlot; ///< "weights", resolved once for the step path.
+			ComponentSlot targetSlot;  ///< "target", resolved once for the step path.
+			/// The weights under WeightStorage::SPARSE; empty (no rows) under DENSE.
+			tools::math::CsrMatrix sparseWeights;
 		public:
 			/// @brief Construct a FieldCoupling.
 			/// @param elementCommonParameters  Name, label, and dimensions of the output field.
@@ -154,6 +217,12 @@ namespace dnf_composer
 			std::string toString() const override;
 			std::shared_ptr<Element> clone() const override;
 
+			/// @brief Inputs plus the downstream output field: the HEBB/OJA rules
+			/// read that field's "activation" in updateWeights(), a read that
+			/// does not show up in `inputs`.
+			std::vector<std::shared_ptr<Element>> getStepDependencies() override;
+			std::vector<std::shared_ptr<Element>> getLiveStepDependencies() override;
+
 			/// @brief Resize the output field dimensions and rebuild the weight matrix.
 			/// Preserves input field dimensions and clears weights. Connections are not
 			/// removed — call removeInputs()/removeOutputs() first if needed. Any
@@ -175,29 +244,82 @@ namespace dnf_composer
 			/// @param learning  True to activate learning.
 			void setLearning(bool learning);
 
+			/// @brief Replace the parameters. A change of weightStorage or
+			/// pruneThreshold converts the current weights: DENSE -> SPARSE prunes
+			/// them, SPARSE -> DENSE re-densifies them (pruned entries become 0), and
+			/// a new threshold under SPARSE prunes the retained entries further.
 			void setParameters(const FieldCouplingParameters& fcp);
 
 			/// @brief Set the directory used for @c readWeights() / @c writeWeights().
 			void setWeightsDirectory(const std::string& dir);
 
+			/// @brief Select the format @c writeWeights() writes. @c readWeights() reads
+			/// either, and switches this to the format it loaded.
+			void setWeightFileFormat(WeightFileFormat format);
+
+			/// @brief Make @c readWeights() verify a binary file's checksum before
+			/// using it. Off by default: verifying reads the whole payload, which
+			/// gives up the page-on-demand loading of a large matrix. The
+			/// `dnf_composer_weights info --verify` command checks a file offline.
+			void setVerifyWeightChecksum(bool verify);
+
 			FieldCouplingParameters getParameters() const;
 			std::string getWeightsDirectory() const;
+			WeightFileFormat getWeightFileFormat() const;
+			bool getVerifyWeightChecksum() const;
+
+			/// @brief Path of this coupling's weight file in @p format under @c weightsDirectory.
+			std::string getWeightsFilename(WeightFileFormat format) const;
 
 			/// @brief The DELTA rule's connected teaching-signal field, or nullptr if none.
 			std::shared_ptr<Element> getTargetField() const;
 
-			/// @brief Load the weight matrix from a binary file in @c weightsDirectory.
-			void readWeights();
+			/// @brief The pruned weights under WeightStorage::SPARSE (no rows under DENSE).
+			const tools::math::CsrMatrix& getSparseWeights() const;
+
+			/// @brief Bytes the weights currently occupy, dense or sparse.
+			std::size_t getWeightsBytes() const;
+
+			/// @brief Load the weight matrix from @c weightsDirectory: the binary
+			/// <name>_weights.dnfw if there is one, otherwise the text
+			/// <name>_weights.txt. Logs an ERROR and leaves the weights unchanged if
+			/// the file is missing, the wrong size or malformed (or, with
+			/// @c setVerifyWeightChecksum(), fails its checksum).
+			///
+			/// A dense binary file loaded into WeightStorage::DENSE is not copied:
+			/// components["weights"] uses a copy-on-write mapping of the file as its
+			/// storage, so loading takes constant time and a page of the matrix is
+			/// read from disk when it is first used. Changes to the weights (learning,
+			/// edits) copy the pages they touch and never reach the file; save them
+			/// with @c writeWeights(), which replaces the file rather than writing
+			/// into it. The file stays mapped until the weights are saved over it,
+			/// cleared or released with @c releaseWeightsFile().
+			/// @return Whether the weights were loaded.
+			bool readWeights();
+
+			/// @brief Copy weights that use a mapped weight file as their storage
+			/// (see @c readWeights()) into memory of their own and unmap the file.
+			/// Windows refuses to replace or delete a file while a view of it is
+			/// mapped; call this before removing a file this coupling loaded from.
+			/// A no-op if the weights are not mapped.
+			void releaseWeightsFile();
 
 			/// @brief Load weights if the file exists; log INFO in either case.
 			/// Unlike @c readWeights(), this never logs an error — use it when weights
 			/// may legitimately be absent (e.g. first run of a programmatic simulation).
 			void tryReadWeights();
 
-			/// @brief Save the current weight matrix to a binary file in @c weightsDirectory.
-			void writeWeights() const;
+			/// @brief Save the current weight matrix to @c weightsDirectory in the
+			/// selected WeightFileFormat. Binary files hold the CSR matrix as-is under
+			/// WeightStorage::SPARSE. Writing text removes a binary file of the same
+			/// name, which readWeights() would otherwise prefer, and logs an ERROR if
+			/// it cannot. Weights mapped from the file being replaced or removed are
+			/// copied into memory first (@c releaseWeightsFile()).
+			void writeWeights();
 
-			/// @brief Reset the weight matrix to all zeros.
+			/// @brief Reset the weight matrix to all zeros. Under SPARSE the retained
+			/// entries are zeroed but kept, so learning can rebuild within the same
+			/// sparsity pattern.
 			void clearWeights();
 		private:
 			/// @brief Pull data from all registered sources. Overrides Element::updateInput()
@@ -220,7 +342,19 @@ namespace dnf_composer
 			/// @brief Reset targetField to nullptr and zero components["target"].
 			void clearTarget();
 			void updateWeights();
+			/// @brief The learning rule step on @p weights: the dense component or,
+			/// under SPARSE, the CSR matrix (same rules, retained entries only).
+			template<typename Weights>
+			void updateWeights(Weights& weights);
 			bool checkValidConnections();
+			/// @brief Bring the weights into parameters.weightStorage form: prune
+			/// components["weights"] into sparseWeights (re-pruning an existing CSR
+			/// at the current threshold), or expand sparseWeights back into it.
+			void applyWeightStorage();
+			bool readTextWeights(const std::string& filename);
+			bool readBinaryWeights(const std::string& filename);
+			/// @brief releaseWeightsFile() if the weights are mapped from @p filename.
+			void releaseWeightsFileAt(const std::string& filename);
 
 			/// @brief Split a stored input-slot string into (is-target-slot, source component).
 			/// "target" -> {true, "output"}; "target:activation" -> {true, "activation"};
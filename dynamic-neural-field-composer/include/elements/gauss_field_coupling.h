@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include "element.h"
 #include "tools/math.h"
 #include "tools/utils.h"
@@ -56,6 +58,20 @@ namespace dnf_composer::element
 	};
 
 
+	/// @brief How GaussFieldCoupling evaluates its projection each step.
+	/// @ingroup elements
+	enum class GaussCouplingEvaluation : int
+	{
+		DENSE,   ///< Build the input×output "weights" matrix at init() and multiply through it.
+		ANALYTIC ///< Never build the matrix; evaluate each coupling as a separable outer product.
+	};
+
+	/// @brief Maps GaussCouplingEvaluation values to human-readable strings.
+	inline const std::map<GaussCouplingEvaluation, std::string> GaussCouplingEvaluationToString = {
+		{GaussCouplingEvaluation::DENSE, "dense"},
+		{GaussCouplingEvaluation::ANALYTIC, "analytic"}
+	};
+
 	/// @brief Parameters for a sparse Gaussian field coupling (fixed projection).
 	/// @ingroup elements
 	struct GaussFieldCouplingParameters final : ElementSpecificParameters
@@ -64,17 +80,20 @@ namespace dnf_composer::element
 		bool normalized;                        ///< If true, each coupling Gaussian is area-normalised.
 		bool circular;                          ///< If true, convolution wraps at field boundaries.
 		std::vector<GaussCoupling> couplings;   ///< List of explicit point-to-point Gaussian couplings.
+		GaussCouplingEvaluation evaluation;     ///< Dense weight matrix or matrix-free evaluation.
 
 		/// @brief Construct GaussFieldCoupling parameters.
 		/// @param inputFieldDimensions  Source field dimensions.
 		/// @param normalized            Normalise individual Gaussians (default true).
 		/// @param circular              Circular boundary (default false).
 		/// @param couplings             Initial coupling list (default empty).
+		/// @param evaluation            Evaluation mode (default DENSE).
 		explicit GaussFieldCouplingParameters(const ElementDimensions& inputFieldDimensions = ElementDimensions{},
 		                             bool normalized = true, bool circular = false,
-		                             const std::vector<GaussCoupling>& couplings = {})
+		                             const std::vector<GaussCoupling>& couplings = {},
+		                             GaussCouplingEvaluation evaluation = GaussCouplingEvaluation::DENSE)
 			: inputFieldDimensions(inputFieldDimensions),
-			  normalized(normalized), circular(circular), couplings(couplings)
+			  normalized(normalized), circular(circular), couplings(couplings), evaluation(evaluation)
 		{}
 
 		/// @brief Append a coupling to the list.
@@ -90,6 +109,7 @@ namespace dnf_composer::element
 			result << "Parameters: ["
 				<< "Circular: " << (circular ? "true" : "false") << ", "
 				<< "Normalized: " << (normalized ? "true" : "false") << ", "
+				<< "Evaluation: " << GaussCouplingEvaluationToString.at(evaluation) << ", "
 				<< "Input field dimensions: " + inputFieldDimensions.toString() << "]\n";
 
 			for (const auto& coupling : couplings) {
@@ -108,11 +128,30 @@ namespace dnf_composer::element
 	/// Gaussian spread. This is useful for hand-crafted or evolution-derived projections
 	/// where the exact connectivity is known in advance.
 	///
+	/// Each coupling's weight, A·exp(-(d_in² + d_out²) / 2σ²), factors into a
+	/// Gaussian over the input index times one over the output index. In
+	/// GaussCouplingEvaluation::ANALYTIC mode init() keeps only those two 1D
+	/// profiles per coupling, cut off at 5σ (the cutoff the kernels use), and the
+	/// "weights" component stays empty. A step then costs
+	/// O(couplings·(support_in + support_out)) instead of O(N_in·N_out). The
+	/// output agrees with DENSE mode to rounding, apart from the tails beyond 5σ.
+	///
 	/// @ingroup elements
 	class GaussFieldCoupling final : public Element
 	{
 	private:
+		/// One coupling's two truncated 1D Gaussians (ANALYTIC mode).
+		struct SeparableCoupling
+		{
+			int inputFirst = 0;           ///< Input index of inputProfile[0].
+			int outputFirst = 0;          ///< Output index of outputProfile[0].
+			std::vector<double> inputProfile;  ///< exp(-d_in² / 2σ²); indices wrap when circular.
+			std::vector<double> outputProfile; ///< Amplitude · exp(-d_out² / 2σ²); indices wrap when circular.
+		};
+
 		GaussFieldCouplingParameters parameters;
+		ComponentSlot weightsSlot; ///< "weights", resolved once for the step path.
+		std::vector<SeparableCoupling> separableCouplings; ///< Built by init() in ANALYTIC mode.
 	public:
 		/// @brief Construct a GaussFieldCoupling.
 		/// @param elementCommonParameters  Name, label, and output field dimensions.
@@ -144,6 +183,9 @@ namespace dnf_composer::element
 		ElementDimensions getInputFieldDimensions() const;
 	private:
 		void updateOutput();
+		void updateOutputAnalytic();
+		void buildDenseWeights();
+		void buildSeparableCouplings();
 		void updateInputFieldDimensions();
 	};
 
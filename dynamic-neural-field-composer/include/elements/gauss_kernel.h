@@ -3,6 +3,7 @@
 #include <array>
 
 #include "tools/math.h"
+#include "tools/fft_convolution.h"
 #include "kernel.h"
 
 namespace dnf_composer::element
@@ -61,6 +62,8 @@ namespace dnf_composer::element
 		GaussKernelParameters parameters;
 		std::vector<double> scratchExtended;
 		std::vector<double> scratchConvolution;
+		bool useFFT_ = false;                       ///< Spectral path, chosen by tools::math::shouldUseSpectral1D() in init().
+		tools::math::SpectralConvolver1D spectral_; ///< FFTW plans and kernel spectrum for that path.
 	public:
 		/// @brief Construct a GaussKernel.
 		/// @param elementCommonParameters  Name, label, and dimensions.
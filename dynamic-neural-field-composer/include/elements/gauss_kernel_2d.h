@@ -70,6 +70,14 @@ namespace dnf_composer::element
 		// every other 2D convolution element (see MexicanHatKernel2D).
 		bool useFFT_ = false;
 		tools::math::SpectralConvolver2D spectral_;
+
+		// Precision::Single (tools/precision.h): the same convolution in float,
+		// directly through direct32_ or spectrally through spectral_ planned in
+		// float. The field comes in as Kernel::singleInput() and the result
+		// stays in float storage until writeOutput() widens it.
+		bool single_ = false;
+		tools::math::SeparableConvolver2DSingle direct32_;
+		std::vector<float> convolution32_;
 	public:
 		GaussKernel2D(const ElementCommonParameters& elementCommonParameters,
 		              GaussKernel2DParameters  parameters);
@@ -78,6 +86,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::string toString() const override;
 		std::shared_ptr<Element> clone() const override;
+		tools::math::SpectralConvolver2D* getSpectralConvolver2D() override { return useFFT_ ? &spectral_ : nullptr; }
 
 		void setParameters(const GaussKernel2DParameters& parameters);
 		GaussKernel2DParameters getParameters() const;
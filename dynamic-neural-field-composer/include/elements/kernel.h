@@ -1,7 +1,11 @@
 #pragma once
 
 #include "element.h"
+#include "tools/fft_convolution.h"
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
 
 namespace dnf_composer::element
 {
@@ -20,8 +24,71 @@ namespace dnf_composer::element
 		std::vector<int> extIndex;      ///< Extended index array for circular (toroidal) convolution.
 		double fullSum;                 ///< Spatial integral of the kernel (used for global inhibition baseline).
 		int cutOfFactor;                ///< Controls how far from the centre the kernel is truncated.
+		ComponentSlot kernelSlot;       ///< "kernel", resolved once for the step path.
+
+		/// @brief Drop this kernel's spectrum sharing and tell Simulation to
+		///        re-plan it. 2D kernels call this from init(), since re-planning
+		///        their convolver can change its size, precision or taps.
+		void resetSpectrumSharing();
+
+		/// @brief Convolve @p input into @p out on the 2D spectral path, through
+		///        whatever spectrum sharing Simulation has set up for this kernel:
+		///        the shared forward transform of the source, a fused kernel
+		///        spectrum (lead) or nothing at all (fused away: @p out is zeroed,
+		///        the lead carries this kernel's convolution).
+		void convolveSpectrally2D(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, double* out);
+
+		/// @brief Precision::Single: convolveSpectrally2D() from singleInput()
+		///        into float storage. @p spectral must be in Single precision.
+		void convolveSpectrally2D(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, float* out);
+
+		/// @brief Precision::Single: @p input as floats. When this kernel's only
+		///        input is the live "output" of an element that keeps a float
+		///        copy of it (Element::getSingleOutput()), that copy is returned
+		///        as is; otherwise @p input is narrowed into this kernel's own
+		///        float storage.
+		std::span<const float> singleInput(const ComponentBuffer& input);
+
+		/// @brief output = convolution, plus @p globalOffset when @p hasGlobal
+		///        (skipping the add otherwise keeps the result bit-identical).
+		///        A float convolution is widened in the same pass.
+		template<typename T>
+		static void writeOutput(ComponentBuffer& output, const std::vector<T>& convolution,
+			bool hasGlobal, double globalOffset)
+		{
+			const std::size_t n = output.size();
+			if (hasGlobal)
+			{
+				for (std::size_t i = 0; i < n; ++i) {
+					output[i] = static_cast<double>(convolution[i]) + globalOffset;
+				}
+			}
+			else
+			{
+				for (std::size_t i = 0; i < n; ++i) {
+					output[i] = convolution[i];
+				}
+			}
+		}
+	private:
+		template<typename T>
+		void convolveSpectrally2DInto(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, T* out);
+
+		std::vector<float> singleInput_;
+
+		// Set by SpectralSharing (simulation/spectral_sharing.h). Not copied: a
+		// clone is not part of any simulation's sharing plan.
+		tools::math::SharedSpectrum2D* sharedSpectrum = nullptr;
+		const ComponentBuffer* sharedSource = nullptr;
+		std::unique_ptr<tools::math::SpectralConvolver2D> fusedSpectral;
+		bool fusedAway = false;
 	public:
 		Kernel(const ElementCommonParameters& elementCommonParameters);
+		Kernel(const Kernel& other);
+		Kernel& operator=(const Kernel& other);
 		~Kernel() override = default;
 
 		/// @brief Return the non-negligible index range [min, max] of the kernel.
@@ -29,5 +96,30 @@ namespace dnf_composer::element
 
 		/// @brief Return the extended index used for circular convolution.
 		std::vector<int> getExtIndex() const;
+
+		/// @brief The convolver this kernel's step() uses on the 2D spectral
+		///        path, or nullptr if it convolves directly (or is 1D).
+		virtual tools::math::SpectralConvolver2D* getSpectralConvolver2D() { return nullptr; }
+
+		/// @brief Read @p source (this kernel's only input) through @p spectrum's
+		///        shared forward transform instead of transforming it here.
+		///        nullptr unbinds.
+		void bindSharedSpectrum(tools::math::SharedSpectrum2D* spectrum, const ComponentBuffer* source);
+
+		/// @brief Make this kernel the lead of a fused group: @p fused holds its
+		///        own kernel spectrum plus those of the kernels fused into it.
+		///        nullptr unfuses.
+		void setFusedSpectral(std::unique_ptr<tools::math::SpectralConvolver2D> fused);
+
+		/// @brief Let another kernel's fused spectrum carry this kernel's
+		///        convolution; this kernel's output then holds only its global
+		///        offset term.
+		void setFusedAway(bool away);
+		bool isFusedAway() const { return fusedAway; }
+
+		/// @brief Process-wide counter bumped whenever a 2D kernel re-plans its
+		///        spectral path. Simulation compares it between steps to know
+		///        when its spectrum sharing has gone stale.
+		static std::uint64_t getSpectralRevision();
 	};
 }
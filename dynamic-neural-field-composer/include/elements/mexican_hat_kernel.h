@@ -6,6 +6,7 @@
 
 #include "kernel.h"
 #include "tools/math.h"
+#include "tools/fft_convolution.h"
 
 #ifdef max
 #undef max
@@ -87,6 +88,8 @@ namespace dnf_composer::element
 		MexicanHatKernelParameters parameters;
 		std::vector<double> scratchExtended;
 		std::vector<double> scratchConvolution;
+		bool useFFT_ = false;                       ///< Spectral path, chosen by tools::math::shouldUseSpectral1D() in init().
+		tools::math::SpectralConvolver1D spectral_; ///< FFTW plans and kernel spectrum for that path.
 	public:
 		/// @brief Construct a MexicanHatKernel.
 		/// @param elementCommonParameters  Name, label, and dimensions.
@@ -91,6 +91,17 @@ namespace dnf_composer::element
 		// unchanged in shape, by every other 2D convolution element.
 		bool useFFT_ = false;
 		tools::math::SpectralConvolver2D spectral_;
+
+		// Precision::Single (tools/precision.h): the same convolutions in float,
+		// directly through directExc32_/directInh32_ or spectrally through
+		// spectral_ planned in float. The field comes in as
+		// Kernel::singleInput(), narrowed once for both terms, and the results
+		// stay in float storage until the output pass widens them.
+		bool single_ = false;
+		tools::math::SeparableConvolver2DSingle directExc32_;
+		tools::math::SeparableConvolver2DSingle directInh32_;
+		std::vector<float> excConv32_;
+		std::vector<float> inhConv32_;
 	public:
 		MexicanHatKernel2D(const ElementCommonParameters& elementCommonParameters,
 		                   MexicanHatKernel2DParameters  parameters);
@@ -99,6 +110,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::string toString() const override;
 		std::shared_ptr<Element> clone() const override;
+		tools::math::SpectralConvolver2D* getSpectralConvolver2D() override { return useFFT_ ? &spectral_ : nullptr; }
 
 		void setParameters(const MexicanHatKernel2DParameters& parameters);
 		MexicanHatKernel2DParameters getParameters() const;
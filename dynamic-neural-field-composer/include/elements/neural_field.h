@@ -2,6 +2,7 @@
 
 #include "element.h"
 #include "activation_function.h"
+#include "neural_field_step.h"
 #include "simulation/simulation.h"
 #include "elements/kernel.h"
 
@@ -269,9 +270,12 @@ namespace dnf_composer::element
 		NeuralFieldParameters parameters; ///< Dynamics parameters (tau, h, activation function).
 		NeuralFieldState state;           ///< Runtime state (bumps, stability, min/max).
 	private:
-		// Cached raw pointers into component vectors — valid between init() calls, never resized during step().
-		double* act_  = nullptr; ///< components["activation"].data()
-		double* inp_  = nullptr; ///< components["input"].data()
+		ComponentSlot activationSlot_; ///< components["activation"], resolved in the constructor.
+		// Raw pointers into the activation and input buffers, re-read at the top of
+		// init() and step(): the buffers move when Simulation::init() packs them
+		// into its component arena, but never during a step.
+		double* act_  = nullptr; ///< components[activationSlot_].data()
+		double* inp_  = nullptr; ///< components[INPUT_SLOT].data()
 		// The resting level is homogeneous by construction (init() fills
 		// components["resting level"] uniformly with startingRestingLevel, and
 		// nothing ever writes to it per-cell afterward), so the integration loop
@@ -307,6 +311,8 @@ namespace dnf_composer::element
 
 		/// @brief Return all currently detected above-threshold bumps.
 		std::vector<NeuralFieldBump> getBumps() const { return state.bumps; }
+		/// @brief Return the number of detected bumps, without copying them.
+		std::size_t getBumpCount() const { return state.bumps.size(); }
 
 		/// @brief Return the registered self-excitation kernel, if any.
 		std::shared_ptr<Kernel> getSelfExcitationKernel() const;
@@ -324,6 +330,7 @@ namespace dnf_composer::element
 		void calculateActivation(double t, double deltaT);
 		void calculateOutput();
 		void updateState(double deltaT);
+		void updateState(const detail::ActivationStats& stats, double deltaT);
 		void updateBumps(double deltaT);
 	};
 }
@@ -7,6 +7,7 @@
 
 #include "element.h"
 #include "activation_function.h"
+#include "neural_field_step.h"
 
 namespace dnf_composer::element
 {
@@ -126,12 +127,17 @@ namespace dnf_composer::element
 	private:
 		NeuralField2DParameters        parameters;
 		NeuralField2DState             state;
+		ComponentSlot activationSlot_;
+		// Re-read at the top of init() and step() -- see NeuralField.
 		double* act_  = nullptr;
 		double* inp_  = nullptr;
 		// Homogeneous by construction (see NeuralField's restScalar_) — cached
 		// scalar instead of a third N-double array stream in calculateActivation.
 		double restScalar_ = 0.0;
 		bool    computeStateMetrics_ = true;
+		// Precision::Single (read in init()): "output" narrowed to float in the
+		// same sweep that writes it, for the 2D kernels reading this field.
+		std::vector<float> singleOutput_;
 		std::vector<NeuralField2DBump> prevBumps_;
 		std::vector<char> visited_; // reusable flood-fill scratch (avoids per-step alloc)
 		std::vector<int> stack_;    // reusable flood-fill frontier (avoids per-bump alloc)
@@ -153,13 +159,17 @@ namespace dnf_composer::element
 		double getLowestActivation()    const { return state.lowestActivation; }
 		double getHighestActivation()   const { return state.highestActivation; }
 		std::vector<NeuralField2DBump> getBumps() const { return state.bumps; }
+		std::size_t getBumpCount()      const { return state.bumps.size(); }
 		void   setComputeStateMetrics(bool enable) { computeStateMetrics_ = enable; }
 		bool   getComputeStateMetrics() const { return computeStateMetrics_; }
+		std::span<const float> getSingleOutput() const override { return singleOutput_; }
 
 	private:
 		void calculateActivation(double t, double deltaT);
 		void calculateOutput();
+		void narrowOutput();
 		void updateState(double deltaT);
+		void updateState(const detail::ActivationStats& stats, double deltaT);
 		void updateBumps(double deltaT, double vmax);
 	};
 }
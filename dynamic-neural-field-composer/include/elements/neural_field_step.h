@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+
+#include "elements/activation_function.h"
+#include "elements/element_components.h"
+#include "tools/simd_dispatch.h"
+
+namespace dnf_composer::element::detail
+{
+	/// @brief Sum, sum of squares, minimum and maximum of a field's activation,
+	///        the inputs to NeuralField/NeuralField2D's stability check.
+	struct ActivationStats
+	{
+		double sum   = 0.0;
+		double sumSq = 0.0;
+		double min   = 0.0;
+		double max   = 0.0;
+	};
+
+	/// @brief Fold @p activation[begin, end) into @p stats, in index order.
+	///
+	/// Folding a field tile by tile from 0 to N gives exactly the sums of one
+	/// front-to-back pass; the first tile seeds min/max from element 0.
+	inline void foldActivationStats(ActivationStats& stats, const double* activation,
+		std::size_t begin, std::size_t end)
+	{
+		if (begin == 0 && end > 0) {
+			stats.min = stats.max = activation[0];
+		}
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			const double v = activation[i];
+			stats.sum   += v;
+			stats.sumSq += v * v;
+			if (v < stats.min) { stats.min = v; }
+			if (v > stats.max) { stats.max = v; }
+		}
+	}
+
+	/// @brief The buffers one fused field step reads and writes, all @c size long.
+	///
+	/// @c sources are the field's input sources in Element::inputSources()
+	/// order: none is longer than @c size, a shorter one covers a prefix.
+	struct FieldStepBuffers
+	{
+		std::span<const ComponentBuffer* const> sources;
+		double* input;
+		double* activation;
+		double* output;
+		std::size_t size;
+		/// Precision::Single: also narrow each output tile into this float copy.
+		float* singleOutput = nullptr;
+	};
+
+	/// Doubles per tile of the fused step. The tile's input, activation and
+	/// output (3 x 2 KiB) stay in L1 between the three phases that touch them.
+	/// A multiple of 8, so the SIMD kernels split each tile into the same
+	/// 4- or 8-lane blocks as they split the whole field.
+	inline constexpr std::size_t FIELD_STEP_TILE = 256;
+
+	/// @brief Sum the input sources into @c input[begin, end), exactly as
+	///        Element::updateInput() does for those indices: copy the first
+	///        source, zero what it does not cover, add the others in order.
+	inline void accumulateInputTile(const FieldStepBuffers& buffers, std::size_t begin, std::size_t end)
+	{
+		double* input = buffers.input;
+		if (buffers.sources.empty())
+		{
+			std::fill(input + begin, input + end, 0.0);
+			return;
+		}
+
+		const ComponentBuffer& first = *buffers.sources.front();
+		const std::size_t copied = std::clamp(first.size(), begin, end);
+		std::copy(first.data() + begin, first.data() + copied, input + begin);
+		std::fill(input + copied, input + end, 0.0);
+
+		for (const ComponentBuffer* source : buffers.sources.subspan(1))
+		{
+			const std::size_t added = std::clamp(source->size(), begin, end);
+			tools::math::detail::simdKernels().accumulate_f64(input + begin, source->data() + begin, added - begin);
+		}
+	}
+
+	/// @brief One Euler step of a neural field in a single tiled sweep.
+	///
+	/// The unfused step streams the field through memory four times: summing
+	/// the inputs, integrating, applying the activation function and folding
+	/// the state metrics. Here each tile of FIELD_STEP_TILE cells goes through
+	/// all four while it is still in L1. Every cell sees the same operations in
+	/// the same order as before, so the results are bit-identical.
+	///
+	/// Instantiated once per (final) activation function type, so the call to
+	/// @c apply() is direct. @p stats may be null when the caller does not
+	/// track state metrics.
+	template<typename Activation>
+	void fieldStepKernel(const Activation& activation, const FieldStepBuffers& buffers,
+		double dtOverTau, double restingLevel, ActivationStats* stats)
+	{
+		double* act = buffers.activation;
+		const double* inp = buffers.input;
+		const auto& simd = tools::math::detail::simdKernels();
+		for (std::size_t begin = 0; begin < buffers.size; begin += FIELD_STEP_TILE)
+		{
+			const std::size_t end = std::min(buffers.size, begin + FIELD_STEP_TILE);
+
+			accumulateInputTile(buffers, begin, end);
+			simd.euler_f64(act + begin, inp + begin, end - begin, dtOverTau, restingLevel);
+			if (stats != nullptr) {
+				foldActivationStats(*stats, act, begin, end);
+			}
+			activation.Activation::apply(std::span<const double>(act + begin, end - begin),
+				std::span<double>(buffers.output + begin, end - begin));
+			if (buffers.singleOutput != nullptr) {
+				std::copy(buffers.output + begin, buffers.output + end, buffers.singleOutput + begin);
+			}
+		}
+	}
+
+	/// @brief Run fieldStepKernel() for @p function's concrete type.
+	/// @return false, leaving every buffer untouched, if @p function is not one
+	///         of the built-in activation functions; the caller then takes its
+	///         unfused path.
+	inline bool fusedFieldStep(const ActivationFunction& function, const FieldStepBuffers& buffers,
+		double dtOverTau, double restingLevel, ActivationStats* stats)
+	{
+		if (const auto* sigmoid = dynamic_cast<const SigmoidFunction*>(&function))
+		{
+			fieldStepKernel(*sigmoid, buffers, dtOverTau, restingLevel, stats);
+			return true;
+		}
+		if (const auto* heaviside = dynamic_cast<const HeavisideFunction*>(&function))
+		{
+			fieldStepKernel(*heaviside, buffers, dtOverTau, restingLevel, stats);
+			return true;
+		}
+		if (const auto* absSigmoid = dynamic_cast<const AbsSigmoidFunction*>(&function))
+		{
+			fieldStepKernel(*absSigmoid, buffers, dtOverTau, restingLevel, stats);
+			return true;
+		}
+		return false;
+	}
+}
@@ -52,6 +52,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::shared_ptr<Element> clone() const override;
 		std::string toString() const override;
+		bool usesThreadRandomStream() const override { return true; }
 
 		void setParameters(NormalNoiseParameters parameters);
 		NormalNoiseParameters getParameters() const;
@@ -44,6 +44,7 @@ namespace dnf_composer::element
 		void step(double t, double deltaT) override;
 		std::string toString() const override;
 		std::shared_ptr<Element> clone() const override;
+		bool usesThreadRandomStream() const override { return true; }
 
 		void setParameters(const NormalNoise2DParameters& parameters);
 		NormalNoise2DParameters getParameters() const;
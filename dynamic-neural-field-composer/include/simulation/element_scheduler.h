@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "elements/element.h"
+#include "tools/thread_pool.h"
+
+namespace dnf_composer
+{
+	class StepProfiler;
+
+	/// @brief Dependency graph over a simulation's elements, stepped on a ThreadPool.
+	///
+	/// The serial loop in Simulation::step() defines the reference semantics:
+	/// elements step in registry order, and an element that reads a source
+	/// registered *after* it sees that source's value from the previous step.
+	/// The graph reproduces exactly that, and nothing stricter:
+	///
+	///  - consumer i reads source j with j < i: edge j -> i (i needs j's new value);
+	///  - consumer i reads source j with j > i: edge i -> j (i must read j's old
+	///    value before j overwrites it);
+	///  - elements that draw from the thread-local random stream
+	///    (Element::usesThreadRandomStream) are chained in registry order and
+	///    pinned to the driving thread, so they consume the stream in the same
+	///    order as the serial loop.
+	///
+	/// Every edge points from a lower to a higher registry index, so the graph
+	/// is acyclic by construction, and any execution order it admits produces
+	/// bit-identical results to the serial loop. Elements with no path between
+	/// them (e.g. two fields and their kernels in independent sub-architectures,
+	/// or all stimuli of a field) step concurrently.
+	///
+	/// @ingroup simulation
+	class ElementScheduler
+	{
+	public:
+		ElementScheduler() = default;
+		ElementScheduler(const ElementScheduler&) = delete;
+		ElementScheduler& operator=(const ElementScheduler&) = delete;
+
+		/// @brief (Re)build the graph for @p elements, in registry order.
+		/// @param synchronous  True for UpdateMode::Synchronous. Reads of front
+		///                     buffers, which no element writes during the step,
+		///                     need no edge; only reads of live components
+		///                     (Element::getLiveStepDependencies) and the
+		///                     random-stream chain are ordered.
+		void build(const std::vector<std::shared_ptr<element::Element>>& elements, bool synchronous = false);
+
+		/// @brief True if the graph was built for exactly @p elements and no
+		///        connection touching them has changed since (Element::getConnectionRevision).
+		bool isCurrent(const std::vector<std::shared_ptr<element::Element>>& elements) const;
+
+		/// @brief Step every element once, honouring the graph's edges. Blocks until
+		///        all elements are done. If any element throws, no further element
+		///        is started (ones already running finish), and the first exception
+		///        is rethrown here on the calling thread. With a @p profiler, each
+		///        element's step is timed into its slot (its registry index).
+		void step(tools::threading::ThreadPool& pool, double t, double deltaT, StepProfiler* profiler = nullptr);
+
+		/// @brief Drop the graph (and the element references it holds).
+		void clear();
+
+		std::size_t getNumberOfNodes() const { return nodes.size(); }
+		const std::vector<std::size_t>& getSuccessors(std::size_t node) const { return nodes.at(node).successors; }
+		std::size_t getPredecessorCount(std::size_t node) const { return nodes.at(node).predecessorCount; }
+
+		/// @brief Number of elements on the longest dependency chain; the step can
+		///        never be faster than stepping these one after another.
+		std::size_t getCriticalPathLength() const { return criticalPathLength; }
+
+	private:
+		struct Node
+		{
+			std::shared_ptr<element::Element> element;
+			std::vector<std::size_t> successors;
+			std::size_t predecessorCount = 0;
+			bool pinned = false;
+		};
+
+		static void runNode(void* context, std::size_t index);
+		void enqueue(std::size_t index);
+
+		std::vector<Node> nodes;
+		std::vector<std::size_t> roots;
+		std::unique_ptr<std::atomic<std::size_t>[]> remaining;
+		std::uint64_t builtRevision = 0;
+		std::size_t criticalPathLength = 0;
+
+		// Per-step state, read by runNode() on the workers.
+		tools::threading::ThreadPool* activePool = nullptr;
+		double stepT = 0.0;
+		double stepDeltaT = 0.0;
+		StepProfiler* activeProfiler = nullptr;
+		bool tracing = false; // tools::trace was active when the step began
+		std::atomic<std::size_t> pending{ 0 };
+		std::atomic<bool> failed{ false };
+		std::mutex errorMutex;
+		std::exception_ptr error;
+	};
+}
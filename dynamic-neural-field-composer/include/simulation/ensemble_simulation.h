@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "elements/activation_function.h"
+#include "simulation/simulation.h"
+#include "tools/fft_convolution.h"
+#include "tools/math.h"
+
+namespace dnf_composer
+{
+	/// @brief Steps K copies of one architecture together, in a structure-of-arrays batch.
+	///
+	/// Parameter sweeps and noise ensembles run hundreds of copies of the same
+	/// architecture. As separate Simulations, every copy pays its own per-element
+	/// dispatch, component map lookups and short vector loops. An EnsembleSimulation
+	/// takes one prototype Simulation and stores each component of each element
+	/// for all K instances *interleaved*: value @c i of instance @c k lives at
+	/// @c i*K+k. Every inner loop then runs over the K instances of one cell, which
+	/// are contiguous, so one vectorised sweep of the field integration, the
+	/// activation function, the input sum and the kernel convolution advances
+	/// all K instances at once.
+	///
+	/// Each instance computes what a standalone Simulation with the same
+	/// parameters would: the same formulas in the same summation order, inputs
+	/// summed in name order, and kernel taps and stimulus shapes produced by the
+	/// library's own elements' init(). A circular kernel folds mirror taps only
+	/// when every instance's kernel is symmetric; otherwise an instance whose
+	/// own kernel is symmetric differs from its standalone run by rounding. The
+	/// prototype's update mode (Simulation::setUpdateMode) carries over.
+	///
+	/// Kernels are dispatched per instance as the standalone ones are
+	/// (tools::math::shouldUseSpectral1D): an instance whose circular kernel is
+	/// wide enough for the spectral path is convolved with its own
+	/// SpectralConvolver1D, on the shared plan of its size, and only the
+	/// instances on the direct path are batched.
+	///
+	/// Supported elements (1D): NeuralField (sigmoid, heaviside and abs-sigmoid
+	/// activation), GaussStimulus, GaussKernel, MexicanHatKernel and NormalNoise.
+	/// Any other element in the prototype makes the constructor throw. The
+	/// per-field state metrics (bumps, stability) are not tracked.
+	///
+	/// Per instance, every scalar parameter can be overridden by its .json name
+	/// (setParameter), and every instance draws noise from its own seeded stream
+	/// (setSeed). Structural parameters (sizes, circular, normalized,
+	/// activation-function type) are shared by all instances.
+	///
+	/// @ingroup simulation
+	class EnsembleSimulation
+	{
+	public:
+		/// @brief Snapshot @p prototype's elements and connections for @p instanceCount instances.
+		/// @throws Exception if @p instanceCount is 0 or the prototype contains an
+		///         unsupported element or connection.
+		EnsembleSimulation(const Simulation& prototype, std::size_t instanceCount);
+
+		/// @brief True if every element and connection of @p prototype is supported.
+		///        Any 2D element makes it false.
+		/// @param reason  If non-null and the result is false, receives why.
+		static bool supports(const Simulation& prototype, std::string* reason = nullptr);
+
+		std::size_t getInstanceCount() const { return instanceCount; }
+
+		/// @brief Override one scalar parameter of one element for one instance.
+		///        Takes effect at the next init().
+		/// @param parameterName  The parameter's .json key, e.g. "tau", "restingLevel",
+		///        "steepness", "x_shift", "beta" (NeuralField); "amplitude", "width",
+		///        "position" (GaussStimulus); "amplitude", "width", "amplitudeGlobal"
+		///        (GaussKernel); "amplitudeExc", "widthExc", "amplitudeInh",
+		///        "widthInh", "amplitudeGlobal" (MexicanHatKernel); "amplitude"
+		///        (NormalNoise).
+		/// @throws Exception on an unknown instance, element or parameter name.
+		void setParameter(std::size_t instance, const std::string& elementName,
+		                  const std::string& parameterName, double value);
+
+		/// @brief Seed instance @p instance's noise stream. Takes effect at the next
+		///        init(). An instance seeded with @c s draws the same samples as a
+		///        standalone Simulation after @c tools::math::seedNormal(s).
+		///        Unseeded instances are seeded from std::random_device.
+		void setSeed(std::size_t instance, std::uint64_t seed);
+
+		/// @brief Build every instance's parameters, kernels and stimuli, and reset
+		///        all state to t = tZero.
+		void init();
+		void step();
+
+		/// @brief Instance @p instance's copy of a component ("activation", "output"
+		///        or "input"), de-interleaved.
+		std::vector<double> getComponent(std::size_t instance, const std::string& elementName,
+		                                 const std::string& componentName) const;
+
+		double getT() const { return t; }
+		double getDeltaT() const { return deltaT; }
+		bool isInitialized() const { return initialized; }
+
+	private:
+		enum class NodeKind { Field, Stimulus, Kernel, Noise };
+
+		struct Source
+		{
+			std::size_t node;
+			bool activation; ///< Reads the field's "activation" instead of "output".
+		};
+
+		struct Node
+		{
+			NodeKind kind;
+			std::string name;
+			std::shared_ptr<element::Element> prototype;
+			int size = 0;
+			std::vector<Source> sources; ///< In name order, as Element::buildInputCache sums them.
+
+			// Interleaved [size * K] buffers.
+			std::vector<double> input;
+			std::vector<double> output;
+			std::vector<double> activation;      ///< Field only.
+			std::vector<double> frontOutput;     ///< UpdateMode::Synchronous only.
+			std::vector<double> frontActivation; ///< UpdateMode::Synchronous, field only.
+
+			// Per-instance scalars [K]. Field: a = deltaT/tau, b = resting level,
+			// c/d = activation-function parameters. Kernel: a = amplitudeGlobal.
+			// Noise: a = amplitude / sqrt(deltaT).
+			std::vector<double> a, b, c, d;
+			std::shared_ptr<element::ActivationFunction> activationFunction; ///< Instance 0's.
+			bool uniformActivation = true; ///< All instances share activationFunction's parameters.
+
+			// Kernel: out[i] = sum_m taps[m] * extended[i + m], per instance.
+			bool circular = true;
+			int tapCount = 0;
+			bool symmetric = false;          ///< Every instance's taps are a palindrome.
+			std::vector<int> extendedIndex;  ///< Circular: source cell of each extended cell.
+			int padding = 0;                 ///< Non-circular: zero cells on each side.
+			std::vector<double> taps;        ///< [tapCount * K]
+			std::vector<double> extended;    ///< [(size + tapCount - 1) * K]
+			/// Instances convolved spectrally, each with its convolver in @c spectral.
+			std::vector<std::size_t> spectralInstances;
+			std::vector<tools::math::SpectralConvolver1D> spectral;
+			std::vector<double> column;      ///< One spectral instance's input, then output [2 * size].
+		};
+
+		const std::vector<double>& readable(const Source& source) const;
+		std::size_t findNode(const std::string& elementName) const;
+		std::shared_ptr<element::Element> instantiate(const Node& node, std::size_t instance) const;
+
+		void initField(Node& node);
+		void initStimulus(Node& node);
+		void initKernel(Node& node);
+		void initNoise(Node& node);
+
+		void sumInputs(Node& node) const;
+		/// Integrate (unless @p integrate is false, as in init()) and apply the activation function.
+		void stepField(Node& node, bool integrate);
+		void convolveDirect(Node& node);
+		void stepKernel(Node& node);
+		void stepNoise(Node& node);
+
+		std::size_t instanceCount;
+		std::vector<Node> nodes;
+		UpdateMode updateMode;
+		double deltaT;
+		double tZero;
+		double t;
+		bool initialized = false;
+
+		std::map<std::tuple<std::size_t, std::size_t, std::string>, double> overrides; ///< (instance, node, name)
+		std::vector<std::uint64_t> seeds;
+		std::vector<bool> seeded;
+		std::vector<tools::math::NormalStream> streams;
+		std::vector<double> scratch;
+	};
+}
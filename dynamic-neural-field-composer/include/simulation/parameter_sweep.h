@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "simulation/simulation.h"
+
+namespace dnf_composer
+{
+	/// @brief How ParameterSweep turns the swept ranges into variants.
+	enum class SweepDesign
+	{
+		Cartesian,      ///< Every combination of every parameter's values.
+		LatinHypercube, ///< @c samples points, each parameter's range split into @c samples strata hit once each.
+	};
+
+	/// @brief One swept parameter: an element's .json key and the values it takes.
+	struct SweepParameter
+	{
+		std::string element;        ///< The element's unique name.
+		std::string parameter;      ///< The .json key, e.g. "restingLevel", "amplitude", "steepness".
+		std::vector<double> values; ///< Cartesian: explicit values, or @c count points over [min, max].
+		double min = 0.0;
+		double max = 0.0;
+	};
+
+	/// @brief A sweep, as read from a sweep .json file.
+	///
+	/// ```json
+	/// {
+	///   "architecture": "sim_001_sigmoid_b100.json",
+	///   "design": "cartesian",
+	///   "steps": 1000,
+	///   "seed": 1,
+	///   "parameters": [
+	///     { "element": "neural field u", "parameter": "restingLevel", "values": [-8, -6, -4] },
+	///     { "element": "gauss kernel",   "parameter": "amplitude", "min": 4, "max": 12, "count": 5 }
+	///   ]
+	/// }
+	/// ```
+	/// A "latin_hypercube" design takes "samples" and a "min"/"max" per parameter.
+	/// A relative "architecture" path is resolved against the sweep file's directory.
+	struct SweepSpecification
+	{
+		std::filesystem::path architecture;
+		SweepDesign design = SweepDesign::Cartesian;
+		std::vector<SweepParameter> parameters;
+		int samples = 0;          ///< LatinHypercube only.
+		int steps = 1000;         ///< Steps each variant is run for.
+		std::uint64_t seed = 1;   ///< Latin-hypercube sampling and per-variant noise seeds.
+
+		/// @throws Exception on a missing or malformed field.
+		static SweepSpecification fromJson(const nlohmann::json& json, const std::filesystem::path& baseDirectory = {});
+		static SweepSpecification fromFile(const std::filesystem::path& path);
+		nlohmann::json toJson() const;
+	};
+
+	/// @brief One point of a sweep: a value for every swept parameter.
+	struct SweepVariant
+	{
+		std::size_t index = 0;
+		std::vector<double> values; ///< In SweepSpecification::parameters order.
+		std::uint64_t seed = 0;     ///< Passed to tools::math::seedNormal before the run.
+	};
+
+	/// @brief Summary of one neural field at the end of a variant's run.
+	struct SweepFieldSummary
+	{
+		std::string name;
+		bool stable = false;
+		std::optional<double> stabilityTime; ///< When the field last became stable; empty if unstable at the end.
+		int bumpCount = 0;
+		double lowestActivation = 0.0;
+		double highestActivation = 0.0;
+		std::vector<double> activation;      ///< Final activation.
+	};
+
+	/// @brief Outcome of one variant. @c error is set instead of @c fields when it failed.
+	struct SweepResult
+	{
+		SweepVariant variant;
+		std::vector<SweepFieldSummary> fields;
+		std::string error;
+		double wallSeconds = 0.0;
+	};
+
+	/// @brief Cartesian or Latin-hypercube variants of @p specification, in index order.
+	std::vector<SweepVariant> generateSweepVariants(const SweepSpecification& specification);
+
+	/// @brief Runs every variant of a sweep and streams one result line per variant.
+	///
+	/// Each variant is the base architecture's .json document with the swept keys
+	/// patched, loaded into its own Simulation, seeded with tools::math::seedNormal
+	/// and stepped on one thread, so its result does not depend on which worker ran
+	/// it or how many ran at once. Variants run on a tools::threading::ThreadPool.
+	///
+	/// The results file is JSON Lines: a header line holding the specification and
+	/// a hash of the base architecture, then one line per finished variant, in
+	/// completion order, flushed as soon as it is written. Resuming reads the file
+	/// back, drops a line torn by the interruption, and runs only the variants
+	/// that have no line yet. A header that does not match this sweep refuses the
+	/// resume rather than mixing two sweeps' results.
+	///
+	/// @ingroup simulation
+	class ParameterSweep
+	{
+	public:
+		/// @brief Reads the base architecture and checks that every swept key exists.
+		/// @throws Exception if the architecture cannot be read or a key is unknown.
+		explicit ParameterSweep(SweepSpecification specification);
+
+		const SweepSpecification& getSpecification() const { return specification; }
+		const std::vector<SweepVariant>& getVariants() const { return variants; }
+
+		/// @brief A fresh, initialised Simulation for @p variant. Thread-safe. Under a
+		///        measuring tools::math::PlanRigor it returns only once every measured
+		///        FFT plan it needs is in use, so the variant runs on the same plans
+		///        from the first step to the last.
+		std::shared_ptr<Simulation> buildSimulation(const SweepVariant& variant) const;
+
+		/// @brief Under a measuring tools::math::PlanRigor, plan the deck's FFT
+		///        shapes and wait until their measured plans are in use, so that no
+		///        variant starts on Estimate plans. A no-op under Estimate. @c run()
+		///        calls it before dispatching.
+		void prepareFftPlans() const;
+
+		/// @brief Build, seed and run @p variant, and summarise its fields. Thread-safe;
+		///        a failing variant is reported in SweepResult::error, not thrown.
+		SweepResult runVariant(const SweepVariant& variant) const;
+
+		/// @brief Run every variant not yet in @p resultsPath on @p concurrency threads.
+		/// @param resume      Keep the variants already in @p resultsPath. Without it an
+		///                    existing file is overwritten. The kept lines are rewritten
+		///                    to @p resultsPath ".tmp", which is renamed over the results
+		///                    once complete; new lines are then appended.
+		/// @param onResult    Called (serialised) after each variant's line is written.
+		/// @return The results of the variants run by this call.
+		/// @throws Exception if @p resume finds a results file from a different sweep, or
+		///         if the results file cannot be rewritten (it is then left as it was).
+		std::vector<SweepResult> run(const std::filesystem::path& resultsPath, int concurrency, bool resume,
+		                             const std::function<void(const SweepResult&, std::size_t done, std::size_t total)>& onResult = {}) const;
+
+		/// @brief Indices of the variants recorded in @p resultsPath. A torn last
+		///        line is ignored. Empty if the file does not exist.
+		/// @throws Exception if the file's header is not this sweep's.
+		std::vector<std::size_t> completedVariants(const std::filesystem::path& resultsPath) const;
+
+		nlohmann::json headerJson() const;
+		nlohmann::json resultJson(const SweepResult& result) const;
+
+	private:
+		SweepSpecification specification;
+		std::vector<SweepVariant> variants;
+		nlohmann::json architecture;      ///< The parsed base document.
+		std::string architectureHash;     ///< FNV-1a64 of the base document's bytes.
+	};
+}
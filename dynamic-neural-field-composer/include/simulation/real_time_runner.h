@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "simulation/simulation.h"
+
+namespace dnf_composer
+{
+	/// @brief What RealTimeRunner does when a step ends after the next deadline.
+	/// @ingroup simulation
+	enum class OverrunPolicy
+	{
+		/// Step the missed periods back to back, without sleeping, until the
+		/// runner is on time again, so every period still gets its step and
+		/// simulation time keeps pace with wall time. A backlog longer than
+		/// @c RealTimeOptions::maxCatchUp periods is skipped instead.
+		CatchUp,
+		/// Drop the missed periods and wait for the next deadline still in the
+		/// future. Every step starts on a deadline; simulation time falls behind
+		/// wall time by one @c deltaT per skipped period.
+		Skip,
+	};
+
+	/// @brief How RealTimeRunner paces a Simulation.
+	/// @ingroup simulation
+	struct RealTimeOptions
+	{
+		std::chrono::nanoseconds period{ std::chrono::milliseconds(10) }; ///< Wall time between deadlines; one step per period.
+		OverrunPolicy overrunPolicy = OverrunPolicy::Skip;
+		std::uint32_t maxCatchUp = 8; ///< CatchUp only: longest backlog, in periods, that is stepped rather than skipped.
+		int priority = 0;             ///< SCHED_FIFO priority (1 to 99) for the stepping thread; 0 keeps its policy.
+		int cpu = -1;                 ///< CPU to pin the stepping thread to; -1 keeps its affinity.
+	};
+
+	/// @brief Timing of one period, passed to the @c run() callback.
+	/// @ingroup simulation
+	struct RealTimePeriod
+	{
+		std::uint64_t index = 0;                ///< Period number, counting skipped ones, from 0.
+		std::chrono::nanoseconds lateness{ 0 }; ///< Step start minus deadline: wake-up jitter, or the backlog when catching up.
+		std::chrono::nanoseconds stepTime{ 0 }; ///< Duration of @c Simulation::step().
+		std::chrono::nanoseconds slack{ 0 };    ///< Next deadline minus step end; negative on an overrun.
+		std::uint64_t skipped = 0;              ///< Periods dropped after this one.
+	};
+
+	/// @brief What @c RealTimeRunner::run() returns. Percentiles are within
+	/// about 3% of the exact values (tools/latency_histogram.h).
+	/// @ingroup simulation
+	struct RealTimeStats
+	{
+		std::chrono::nanoseconds period{ 0 };
+		std::uint64_t periods = 0;          ///< Deadlines passed: steps plus skipped periods.
+		std::uint64_t steps = 0;
+		std::uint64_t overruns = 0;         ///< Steps started on time that ended after the next deadline.
+		std::uint64_t skipped = 0;          ///< Periods without a step.
+		std::uint64_t lateStarts = 0;       ///< Catch-up steps, started on a deadline already past.
+
+		std::chrono::nanoseconds jitterP50{ 0 };  ///< Wake-up lateness of the steps started from a sleep.
+		std::chrono::nanoseconds jitterP99{ 0 };
+		std::chrono::nanoseconds jitterMax{ 0 };
+		std::chrono::nanoseconds stepP50{ 0 };
+		std::chrono::nanoseconds stepP99{ 0 };
+		std::chrono::nanoseconds stepMax{ 0 };
+		std::chrono::nanoseconds slackMin{ 0 };   ///< Tightest period; negative if any overran.
+		std::chrono::nanoseconds slackP01{ 0 };   ///< 1st-percentile slack, overruns counted as 0.
+		std::chrono::nanoseconds slackMean{ 0 };
+		std::chrono::nanoseconds wallTime{ 0 };   ///< From the first deadline to the end of the last step.
+
+		bool realTimePriority = false; ///< SCHED_FIFO was in effect.
+		bool pinned = false;           ///< The CPU pinning was in effect.
+		std::string note;              ///< Why a requested priority or pinning was not applied; empty otherwise.
+
+		/// @brief Fraction of periods that overran or were skipped.
+		double missRate() const { return periods > 0 ? static_cast<double>(overruns + skipped) / static_cast<double>(periods) : 0.0; }
+	};
+
+	/// @brief Steps a Simulation once per fixed wall-clock period.
+	///
+	/// Where @c Simulation::runForRealTime() steps as fast as it can until a
+	/// budget runs out, a RealTimeRunner steps on a grid of absolute deadlines
+	/// @c start + k * period. It sleeps until each deadline with
+	/// @c clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME), so the time spent
+	/// stepping and bookkeeping never accumulates as drift; elsewhere it falls
+	/// back to @c std::this_thread::sleep_until on the steady clock.
+	///
+	/// For the duration of @c run() the calling thread can be given SCHED_FIFO
+	/// priority and pinned to one CPU; both are restored afterwards. Either is
+	/// best effort: without the privilege (CAP_SYS_NICE, an rtprio limit) the run
+	/// goes ahead at normal priority and @c RealTimeStats::note says why.
+	///
+	/// One runner drives one simulation from one thread at a time. @c stop() may
+	/// be called from any thread.
+	///
+	/// @ingroup simulation
+	class RealTimeRunner
+	{
+	public:
+		/// @throws Exception if @p simulation is null, the period is not positive
+		///         or the priority is outside 0 to 99.
+		explicit RealTimeRunner(std::shared_ptr<Simulation> simulation, RealTimeOptions options = {});
+
+		/// @brief Step for @p periods periods (blocking), initialising the simulation
+		///        if needed.
+		/// @param onPeriod  Called after each step, on the stepping thread. Its time
+		///                  counts against the next period.
+		RealTimeStats run(std::uint64_t periods, const std::function<void(const RealTimePeriod&)>& onPeriod = {});
+
+		/// @brief Step for @p duration of wall time, rounded up to whole periods.
+		RealTimeStats runFor(std::chrono::nanoseconds duration, const std::function<void(const RealTimePeriod&)>& onPeriod = {});
+
+		/// @brief Make a running @c run() return after its current step. A call made
+		///        before @c run() starts has no effect.
+		void stop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+		const RealTimeOptions& getOptions() const { return options; }
+
+	private:
+		std::shared_ptr<Simulation> simulation;
+		RealTimeOptions options;
+		std::atomic<bool> stopRequested{ false };
+	};
+}
@@ -10,6 +10,12 @@
 #include "exceptions/exception.h"
 #include "tools/utils.h"
 #include "simulation/simulation_recorder.h"
+#include "simulation/weight_checkpointer.h"
+#include "simulation/element_scheduler.h"
+#include "simulation/spectral_sharing.h"
+#include "simulation/step_profiler.h"
+#include "tools/thread_pool.h"
+#include "tools/trace.h"
 
 /// @defgroup simulation Simulation
 /// @brief Core simulation loop and element registry.
@@ -18,6 +24,22 @@ namespace dnf_composer
 {
 	class Simulation;
 
+	/// @brief How elements observe each other's state within one @c Simulation::step().
+	/// @ingroup simulation
+	enum class UpdateMode
+	{
+		/// Gauss-Seidel-style (default): elements step in registry order and
+		/// read live components, so a consumer sees a source's value from this
+		/// step if the source is registered before it, or from the previous
+		/// step if it is registered after.
+		Sequential,
+		/// Jacobi-style: every element reads a frozen snapshot of the previous
+		/// step's "output"/"activation" components and writes its own live
+		/// buffers; the snapshot is refreshed at the end of @c step(). Results
+		/// do not depend on registry order.
+		Synchronous
+	};
+
 	/// @brief Factory helper — create a Simulation with the given parameters.
 	/// @param identifier  Human-readable name for the simulation.
 	/// @param deltaT      Integration step size.
@@ -83,7 +105,8 @@ namespace dnf_composer
 		///
 		/// Unlike @c run(), this is bounded by wall-clock time: it steps the simulation
 		/// repeatedly until @p milliseconds of real time have elapsed, regardless of how
-		/// many simulation-time units that corresponds to.
+		/// many simulation-time units that corresponds to. It steps as fast as it can;
+		/// to step once per fixed wall-clock period, use a @c RealTimeRunner.
 		///
 		/// @param milliseconds   Wall-clock duration to run for, in milliseconds.
 		/// @param closeOnFinish  If true, calls @c close() after the run, releasing
@@ -160,7 +183,7 @@ namespace dnf_composer
 		std::shared_ptr<element::Element> getElement(int index) const;
 
 		std::vector<double> getComponent(const std::string& id, const std::string& componentName) const;
-		std::vector<double>* getComponentPtr(const std::string& id, const std::string& componentName) const;
+		element::ComponentBuffer* getComponentPtr(const std::string& id, const std::string& componentName) const;
 		int getNumberOfElements() const;
 
 		/// @brief Return all elements that list @p specifiedElement as an input.
@@ -205,14 +228,125 @@ namespace dnf_composer
 		void setMeasureStepDuration(bool enable) { measureStepDuration = enable; }
 		bool getMeasureStepDuration() const { return measureStepDuration; }
 
+		/// @brief Set how many threads @c step() uses to advance the elements (default 1).
+		///
+		/// With 1, elements step one after another in registry order on the calling
+		/// thread. With more, @c step() runs them on a work-stealing pool of that many
+		/// threads (the calling thread included), ordered by an ElementScheduler
+		/// dependency graph built from each element's inputs, so elements with no
+		/// data dependency between them step concurrently. Results are bit-identical
+		/// to the single-threaded path. Values below 1 are treated as 1.
+		///
+		/// The count is the simulation's whole thread budget: large 2D convolutions
+		/// split their row/column passes and FFTW transforms into chunks that run
+		/// on the same pool (tools::threading::parallelFor), so one wide kernel can
+		/// use the idle threads while the element level has nothing else ready, and
+		/// the two levels together never run more than this many threads.
+		void setThreadCount(int threads);
+		int getThreadCount() const { return threadCount; }
+
+		/// @brief Select the update semantics (default @c UpdateMode::Sequential).
+		///
+		/// Switching to @c UpdateMode::Synchronous front-buffers every element
+		/// (Element::setFrontBuffered) and publishes its current state, so the
+		/// next @c step() reads exactly what the elements hold now. Elements added
+		/// or reset afterwards are front-buffered as they join. Only "output" and
+		/// "activation" are front-buffered: an interaction that reads any other
+		/// component (e.g. "input") reads it live, in registry order, as in
+		/// sequential mode. A multi-threaded step orders just those reads and
+		/// the noise elements' shared random stream.
+		void setUpdateMode(UpdateMode mode);
+		UpdateMode getUpdateMode() const { return updateMode; }
+
+		/// @brief Select how much spectral work 2D kernels reading the same
+		///        source share (default @c SpectrumSharing::ForwardTransforms).
+		/// @see SpectrumSharing
+		void setSpectrumSharing(SpectrumSharing mode);
+		SpectrumSharing getSpectrumSharing() const { return spectrumSharing; }
+
+		/// @brief Time every element's @c step() into a per-element histogram
+		/// (default: off).
+		///
+		/// On, @c step() reads the steady clock around each element and records
+		/// the duration, serially or on the scheduler's threads; @c getProfile()
+		/// reports percentiles per element and per element type. Off, the step
+		/// takes the same path as if profiling did not exist. Turning it off keeps
+		/// the recorded steps for @c getProfile(); @c resetProfile() clears them.
+		void setProfiling(bool enable);
+		bool isProfiling() const { return profiling; }
+
+		/// @brief p50/p99/max step times per element and per element type, since
+		/// profiling was first enabled or last reset. Empty if it never was.
+		/// Safe to call from any thread.
+		StepProfile getProfile() const;
+		void resetProfile();
+
+		/// @brief Start a timeline trace (tools/trace.h) of element steps, FFT
+		/// plans and transforms, recorder and checkpoint I/O and GUI frames.
+		///
+		/// @c stopTrace() writes it as a Chrome trace-event file that
+		/// ui.perfetto.dev opens. Tracing is process-wide: the file also holds
+		/// any other simulation stepped meanwhile. Setting DNF_COMPOSER_TRACE to
+		/// a file name traces the whole run instead, from the first @c init().
+		/// @param filePath Output file; empty for
+		///        data/<id>/traces/<id>_<timestamp>.json under the resource root.
+		void startTrace(const std::string& filePath = "");
+		/// @return The file written, or an empty string if no trace was running.
+		std::string stopTrace();
+		bool isTracing() const { return tools::trace::isActive(); }
+
 		/// @brief Access the recorder to start/stop time-series recordings or take snapshots.
 		/// @return Non-const reference to the internal @c SimulationRecorder.
 		/// @see SimulationRecorder
 		SimulationRecorder& getRecorder() { return recorder; }
 
+		/// @brief Access the weight checkpointer to start/stop periodic background
+		/// checkpoints of every FieldCoupling's weights. @c step() calls its
+		/// @c update() after the elements have stepped; @c close() and @c clean()
+		/// stop it once the queued checkpoint is written.
+		/// @see WeightCheckpointer
+		WeightCheckpointer& getCheckpointer() { return checkpointer; }
+
 	private:
 		bool measureStepDuration = true;
+		// Neither is copied or moved: each owns a writer thread.
 		SimulationRecorder recorder;
+		WeightCheckpointer checkpointer;
+
+		int threadCount = 1;
+		UpdateMode updateMode = UpdateMode::Sequential;
+		// Both created lazily by the first multi-threaded step(), and held by
+		// pointer so Simulation stays copy/move-assignable (the pool owns threads,
+		// the scheduler owns atomics).
+		std::unique_ptr<tools::threading::ThreadPool> threadPool;
+		std::unique_ptr<ElementScheduler> scheduler;
+
+		SpectrumSharing spectrumSharing = SpectrumSharing::ForwardTransforms;
+		// Re-validated before every step like the scheduler; held by pointer for
+		// the same reason (the shared spectra own mutexes and FFTW plans).
+		std::unique_ptr<SpectralSharing> spectralSharing;
+
+		bool profiling = false;
+		// Created by the first setProfiling(true) and kept when profiling is
+		// turned off, so the recorded steps can still be read.
+		std::unique_ptr<StepProfiler> profiler;
+
+		/// @brief Advance every element by one deltaT at the current t, serially or
+		///        through the scheduler depending on threadCount.
+		void stepElements();
+
+		/// @brief Bring the spectrum sharing plan up to date and mark its
+		///        spectra stale for the coming step.
+		void prepareSpectralSharing();
+
+		/// @brief Copy every element's live readable components into its front
+		///        buffers (synchronous mode's end-of-step "swap").
+		void publishFrontBuffers() const;
+
+		/// @brief Move every element's components into one new ComponentArena,
+		///        in registry (step) order, so a step walks memory front to back.
+		void packComponentArena() const;
+
 		void generateUniqueIdentifier();
 
 		/// @brief Break every input/output connection between this simulation's
@@ -56,6 +56,7 @@ namespace dnf_composer
 	/// data/<identifier>/
 	///   <identifier>.dnf            ← element graph
 	///   <coupling_name>_weights.txt ← one file per FieldCoupling element
+	///                                 (_weights.dnfw for WeightFileFormat::BINARY)
 	/// ```
 	///
 	/// When loading, FieldCoupling weight files are resolved relative to the
@@ -95,6 +96,13 @@ namespace dnf_composer
 		/// the parent directory of the JSON file and their weights are re-read from there.
 		void loadElementsFromJson() const;
 
+		/// @brief Deserialize elements and connections from an already-parsed document.
+		///
+		/// Same as loadElementsFromJson(), for a caller that edits the document first
+		/// (e.g. a parameter sweep patching one value per variant). @c FieldCoupling
+		/// weights are still resolved relative to this manager's file path.
+		void loadElementsFromJson(const json& root) const;
+
 	private:
 		static json elementToJson(const std::shared_ptr<element::Element>& element);
 
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
-#include <fstream>
+
+#include "tools/recording_file.h"
 
 /// @defgroup simulation_recorder Simulation Recorder
 /// @brief Time-series recording and snapshot export of element component data.
@@ -12,10 +21,112 @@ namespace dnf_composer
 {
 	class Simulation;
 
+	namespace element
+	{
+		class Element;
+	}
+
 	/// @brief Unit for the recording sample interval.
 	/// @ingroup simulation_recorder
 	enum class RecordingIntervalUnit { Ticks, Milliseconds };
 
+	/// @brief File format of a continuous recording.
+	/// @ingroup simulation_recorder
+	enum class RecordingFormat
+	{
+		Csv,   ///< Text rows, `<elementId>_<componentName>_<timestamp>.csv` (default).
+		Binary ///< Header plus fixed-size raw frames, `.dnfr` (tools/recording_file.h).
+	};
+
+	/// @brief What @c SimulationRecorder::update() does when the frame queue is full.
+	/// @ingroup simulation_recorder
+	enum class RecordingOverflow
+	{
+		Block,      ///< Wait for the writer to free a frame (default): nothing is lost, the step stalls.
+		DropOldest, ///< Discard the oldest queued frame to make room; counted in @c RecorderStats::framesDropped.
+		DropNewest  ///< Discard the new sample; counted in @c RecorderStats::framesDropped.
+	};
+
+	/// @brief Size and overflow behaviour of the recorder's frame queue.
+	/// @ingroup simulation_recorder
+	struct RecordingQueuePolicy
+	{
+		std::size_t capacity = 256; ///< Frames the queue holds, across all recordings (at least 1).
+		RecordingOverflow overflow = RecordingOverflow::Block;
+	};
+
+	/// @brief Counters reported by @c SimulationRecorder::getStats().
+	/// @ingroup simulation_recorder
+	struct RecorderStats
+	{
+		std::size_t queueDepth = 0;       ///< Frames waiting for the writer now.
+		std::size_t maxQueueDepth = 0;    ///< Deepest the queue has been.
+		std::size_t capacity = 0;         ///< Queue capacity in frames.
+		std::uint64_t framesQueued = 0;   ///< Samples copied into the queue.
+		std::uint64_t framesWritten = 0;  ///< Frames handed to their file by the writer.
+		std::uint64_t framesDropped = 0;  ///< Samples discarded by a drop overflow policy.
+		std::uint64_t bytesWritten = 0;   ///< File bytes flushed by the writer, headers included.
+		std::uint64_t writeFailures = 0;  ///< Recordings whose file stopped accepting writes (logged).
+		std::uint64_t triggers = 0;       ///< Events that opened or extended a triggered recording's window.
+		std::chrono::nanoseconds blockedTime{ 0 }; ///< Stepping-thread time spent waiting under @c RecordingOverflow::Block.
+	};
+
+	/// @brief The part of a component a recording samples: a window, optionally
+	/// thinned by a stride. For a 1D component only the x fields apply.
+	/// @ingroup simulation_recorder
+	struct RecordingRegion
+	{
+		int x = 0;       ///< First column (1D: first index).
+		int y = 0;       ///< First row.
+		int width = 0;   ///< Columns from @c x; 0 runs to the edge.
+		int height = 0;  ///< Rows from @c y; 0 runs to the edge.
+		int strideX = 1; ///< Sample every @c strideX -th column of the window.
+		int strideY = 1; ///< Sample every @c strideY -th row of the window.
+	};
+
+	/// @brief Field event that makes a triggered recording write samples.
+	/// @ingroup simulation_recorder
+	enum class RecordingTrigger
+	{
+		None,              ///< Write every due sample (default).
+		StabilityChange,   ///< The field becomes stable, or stops being stable.
+		BumpCountChange,   ///< A bump forms or decays.
+		ThresholdCrossing  ///< The field's highest activation crosses @c RecordingTriggerOptions::threshold, either way.
+	};
+
+	/// @brief When a triggered recording writes. Samples are still taken every
+	/// @c RecordingOptions::sampleInterval, but only those around an event reach
+	/// the file.
+	/// @ingroup simulation_recorder
+	struct RecordingTriggerOptions
+	{
+		RecordingTrigger on = RecordingTrigger::None;
+		/// @brief The @c NeuralField or @c NeuralField2D whose state is watched;
+		/// empty watches the recorded element. Its state metrics must be enabled.
+		std::string elementId;
+		double threshold = 0.0; ///< @c ThresholdCrossing only.
+		int preSamples = 0;     ///< Samples before the event, held in memory and written with it.
+		int postSamples = 0;    ///< Samples written after the event; another event restarts the count.
+	};
+
+	/// @brief How a recording samples and stores a component.
+	/// @ingroup simulation_recorder
+	struct RecordingOptions
+	{
+		int sampleInterval = 1;                                    ///< How often to sample, in @c unit.
+		RecordingIntervalUnit unit = RecordingIntervalUnit::Ticks;
+		RecordingFormat format = RecordingFormat::Csv;
+		/// @brief Binary only: frame codec (tools/recording_codec.h). The default
+		/// stores raw frames; @c XorDelta is lossless, @c Quantized keeps every
+		/// value within @c tolerance.
+		tools::recording_file::CodecOptions codec;
+		/// @brief The values sampled; the default is the whole component.
+		RecordingRegion region;
+		/// @brief The events around which samples are written; by default every
+		/// sample is.
+		RecordingTriggerOptions trigger;
+	};
+
 	/// @brief Manages ongoing time-series recordings and snapshot exports of element
 	/// component data for a simulation.
 	///
@@ -27,13 +138,47 @@ namespace dnf_composer
 	/// For 2D elements a `# size_x=W,size_y=H` comment line precedes the header so readers
 	/// can reshape the flat row-major columns back into a 2D grid.
 	///
+	/// A recording started with @c RecordingFormat::Binary writes the same samples as
+	/// raw doubles instead: a header naming the element, component, dimensions and
+	/// sample interval, then one fixed-size frame per sample. Nothing is formatted on
+	/// the step path, the values are exact, and the file can be memory-mapped with
+	/// tools::recording_file::MappedRecording or converted to the CSV above with the
+	/// `dnf_composer_recording` tool. Binary recordings can also be coded, each frame
+	/// against the previous one (@c RecordingOptions::codec), which shrinks recordings
+	/// of slowly changing fields many times over.
+	///
+	/// A recording can also sample less: part of the component
+	/// (@c RecordingOptions::region), or only the samples around events in a
+	/// field's state (@c RecordingOptions::trigger), such as a bump forming. The
+	/// samples before an event come from an in-memory ring per recording, so
+	/// nothing reaches the queue or the disk between events.
+	///
+	/// Files are written on a background thread. @c update() only copies each due
+	/// sample into a preallocated ring of frame buffers (no allocation once the
+	/// buffers have grown to the component size) and returns; the writer drains
+	/// the ring to disk and flushes whenever it runs dry. The ring is shared by
+	/// all recordings and bounded by @c RecordingQueuePolicy::capacity; when the
+	/// disk falls behind, @c RecordingQueuePolicy::overflow decides whether the
+	/// step waits or a frame is dropped. @c getStats() reports the queue depth,
+	/// bytes written and dropped frames.
+	///
+	/// All members except @c getStats() are called from the thread that steps
+	/// the simulation.
+	///
 	/// @ingroup simulation_recorder
 	class SimulationRecorder
 	{
 	public:
+		SimulationRecorder();
+		/// @brief Writes the queued frames and stops the writer thread.
+		~SimulationRecorder();
+		SimulationRecorder(const SimulationRecorder&) = delete;
+		SimulationRecorder& operator=(const SimulationRecorder&) = delete;
+
 		/// @brief Start a new continuous recording for the given element/component pair.
 		/// Creates `data/<simName>/recordings/<elementId>_<componentName>_<timestamp>.csv`
-		/// and writes the header row. No-op if an identical recording is already active.
+		/// (`.dnfr` for @c RecordingFormat::Binary); the header is written with the first
+		/// sample. No-op if an identical recording is already active.
 		///
 		/// On failure (directory could not be created, or the file could not be opened)
 		/// a distinct, descriptive error is logged and no session is created — the
@@ -44,24 +189,56 @@ namespace dnf_composer
 		/// @param componentName   Name of the component vector (e.g. "activation").
 		/// @param sampleInterval  How often to sample (in the chosen unit).
 		/// @param unit            Whether @p sampleInterval is in ticks or milliseconds.
+		/// @param format          CSV text (default) or binary frames.
 		/// @return true if the recording session was started successfully, false otherwise.
 		bool startRecording(const std::string& simName,
 		                    const std::string& elementId,
 		                    const std::string& componentName,
 		                    int sampleInterval,
-		                    RecordingIntervalUnit unit);
+		                    RecordingIntervalUnit unit,
+		                    RecordingFormat format = RecordingFormat::Csv);
+
+		/// @brief Start a recording as described by @p options; see the overload above.
+		/// Also fails, logging an error, if @p options sets a codec for a CSV recording
+		/// or an invalid one, a negative region or a stride below 1, or negative
+		/// trigger sample counts. A region outside the component or a trigger element
+		/// that is not a neural field stops the recording at its first step, with a
+		/// warning.
+		bool startRecording(const std::string& simName,
+		                    const std::string& elementId,
+		                    const std::string& componentName,
+		                    const RecordingOptions& options);
 
 		/// @brief Stop the recording for a specific element/component pair.
-		/// The CSV file is closed and the session is removed. No-op if not recording.
+		/// Waits for its queued frames to be written, then closes the file and removes
+		/// the session. No-op if not recording.
 		/// @param elementId      Unique name of the element.
 		/// @param componentName  Name of the component.
 		void stopRecording(const std::string& elementId, const std::string& componentName);
 
-		/// @brief Stop all active recordings and close all open files.
+		/// @brief Stop all active recordings, write their queued frames, close all
+		/// open files and stop the writer thread.
 		void stopAll();
 
-		/// @brief Called each simulation step to append rows to active recordings.
-		/// Ticks are derived from `sim.t`, `sim.tZero`, and `sim.deltaT`.
+		/// @brief Block until every frame queued so far is written and flushed. For
+		/// tests and shutdown paths; never called from @c update().
+		void flush();
+
+		/// @brief Set the queue capacity and overflow behaviour. The ring is
+		/// reallocated, so this is only allowed while no recording is active.
+		/// @return false (and logs a WARNING) if a recording is active.
+		bool setQueuePolicy(const RecordingQueuePolicy& policy);
+		[[nodiscard]] const RecordingQueuePolicy& getQueuePolicy() const { return queuePolicy; }
+
+		/// @brief Queue and writer counters, safe to call from any thread. They
+		/// restart when the first recording after @c stopAll() starts.
+		[[nodiscard]] RecorderStats getStats() const;
+
+		/// @brief Called each simulation step to queue frames for active recordings.
+		/// Ticks are derived from `sim.t`, `sim.tZero`, and `sim.deltaT`. A binary
+		/// or region recording whose component changes size is stopped with a
+		/// warning, since its frames have a fixed size. Triggers are checked every
+		/// step; the step an event happens on is written even if no sample is due.
 		/// @param sim  The simulation whose components are being recorded.
 		void update(const Simulation& sim);
 
@@ -83,24 +260,88 @@ namespace dnf_composer
 		[[nodiscard]] bool hasActiveRecordings() const;
 
 	private:
-		// NOLINTNEXTLINE(bugprone-exception-escape) - implicit move uses std::ofstream's move, which is formally allowed to throw
+		/// @brief A recording's file, shared by its session and its queued frames so
+		/// the writer can finish a recording whose session is already gone. Only the
+		/// writer thread touches the stream.
+		struct Sink
+		{
+			std::ofstream file;
+			RecordingFormat format = RecordingFormat::Csv;
+			tools::recording_file::RecordingInfo info; ///< Set by the stepping thread before the first frame is queued.
+			std::string filename;
+			std::unique_ptr<tools::recording_file::FrameEncoder> encoder; ///< Coded binary recordings.
+			std::vector<std::byte> payload; ///< The encoder's output, reused.
+			std::streamoff flushedBytes = 0;
+			bool headerWritten = false;
+			bool failed = false;
+		};
+
+		struct Frame
+		{
+			std::shared_ptr<Sink> sink;
+			long long ticks = 0;
+			double ms = 0.0;
+			std::vector<double> values; ///< Swapped, never reallocated, between the ring and the threads.
+		};
+
 		struct Session
 		{
 			std::string elementId;
 			std::string componentName;
-			int sampleInterval;
-			RecordingIntervalUnit unit;
-			std::ofstream file;
-			double nextSampleAt; ///< Next tick (or ms) at which to append a row.
+			RecordingOptions options;
+			std::shared_ptr<Sink> sink;
+			std::size_t frameValues = 0; ///< Values per frame, fixed by the first sample.
+			std::size_t componentValues = 0; ///< Component size at the first sample.
+			tools::recording_file::SampledRegion region; ///< The region resolved against the component.
+			int sourceSizeX = 0; ///< Row length of the component.
+			bool whole = true;   ///< The region is the whole component: frames are plain copies.
+			double nextSampleAt; ///< Next tick (or ms) at which to queue a frame.
+			std::vector<Frame> history; ///< Triggered: the last preSamples samples, oldest at historyHead.
+			std::size_t historyHead = 0;
+			std::size_t historyDepth = 0;
+			int postRemaining = 0;   ///< Triggered: samples still to write after the last event.
+			long long watched = -1;  ///< Triggered: the watched state at the last step; -1 before the first.
+
+			/// @brief Copy the sampled values of @p component into @p out.
+			void select(std::span<const double> component, std::vector<double>& out) const;
 		};
 
+		/// @brief Fix the frame layout of @p s from its first sample. Returns false,
+		/// after logging a warning, if its region misses the component.
+		bool resolveFrame(Session& s, const element::Element& element, std::size_t componentValues);
+		/// @brief Whether a trigger event happened this step. Returns -1, after
+		/// logging a warning, if the watched element is not a neural field.
+		int checkTrigger(Session& s, const Simulation& sim);
+		/// @brief Wait for, or make, room in the ring under the overflow policy.
+		/// Returns false if the sample is dropped instead.
+		bool reserveSlot();
+		/// @brief Queue @c spare, which the caller has filled, and take the slot's old buffer in its place.
+		void pushSpare();
+		/// @brief Queue a sample of @p component for @p s.
+		void enqueue(const Session& s, long long ticks, double ms, std::span<const double> component);
+		/// @brief Queue the samples held in the history of @p s, oldest first.
+		void enqueueHistory(Session& s);
+		void startWriter();
+		void stopWriter();
+		void writerLoop();
+		static void writeFrame(const Frame& frame);
+		/// @brief Flush @p sink and return the bytes that reached its file since the last flush.
+		static std::uint64_t flushSink(Sink& sink);
+
 		std::vector<Session> sessions;
+		RecordingQueuePolicy queuePolicy;
 
-		/// @brief Write the CSV header. For 2D elements (sizeY > 1) a metadata comment
-		/// line `# size_x=W,size_y=H` is emitted first so readers can reconstruct the grid.
-		static void writeHeader(std::ofstream& file, size_t componentSize,
-		                        int sizeX = 1, int sizeY = 1);
-		static void writeRow(std::ofstream& file, int ticks, double ms,
-		                     const std::vector<double>& component);
+		std::vector<Frame> ring;   ///< queuePolicy.capacity slots; [head, head + depth) are queued.
+		std::size_t head = 0;
+		std::size_t depth = 0;
+		Frame spare;               ///< The stepping thread's fill buffer, swapped into the ring.
+		bool writing = false;      ///< The writer holds a frame it has not finished with.
+		bool stopping = false;
+		RecorderStats stats;
+		mutable std::mutex mutex;  ///< Guards the ring, writing, stopping and stats.
+		std::condition_variable queued;
+		std::condition_variable space;
+		std::condition_variable idle;
+		std::thread writer;
 	};
 }
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "elements/kernel.h"
+#include "tools/fft_convolution.h"
+
+namespace dnf_composer
+{
+	/// @brief How much spectral work 2D kernels reading the same source share.
+	/// @ingroup simulation
+	enum class SpectrumSharing
+	{
+		/// Every spectral kernel transforms its own input.
+		Off,
+		/// Default. Spectral kernels that read the same source component see
+		/// the same values within a step, so its forward FFT runs once and each
+		/// kernel only does its complex multiply and inverse transform. Results
+		/// are bit-identical to @c Off.
+		ForwardTransforms,
+		/// @c ForwardTransforms, plus kernels that also feed the same single
+		/// consumer are fused: the first one's kernel spectrum is the sum of
+		/// all of theirs, so the group runs one inverse transform. The consumer
+		/// sees the same total input up to rounding, but the other kernels'
+		/// "output" then holds only their global offset term, so plots and
+		/// recordings of those kernels no longer show their convolution.
+		Fused
+	};
+
+	/// @brief The spectrum sharing plan for a simulation's 2D spectral kernels.
+	///
+	/// Kernels are grouped by the source component they read, and by whether
+	/// they see its value from this step or the previous one: in
+	/// UpdateMode::Sequential a kernel registered after its source reads the
+	/// new value and one registered before it the old one, so the two sides
+	/// get separate spectra. In UpdateMode::Synchronous every kernel of a
+	/// front-buffered source reads the front buffer and one spectrum serves
+	/// them all; a source read live is split as in sequential mode. Only kernels with a
+	/// single input qualify, since their "input" is then exactly the source.
+	///
+	/// The scheduler's edges already order every kernel of a group the same
+	/// way relative to the source, so whichever kernel of a group steps first
+	/// computes the spectrum and the others reuse it, at any thread count.
+	///
+	/// @ingroup simulation
+	class SpectralSharing
+	{
+	public:
+		SpectralSharing() = default;
+		SpectralSharing(const SpectralSharing&) = delete;
+		SpectralSharing& operator=(const SpectralSharing&) = delete;
+		~SpectralSharing();
+
+		/// @brief (Re)build the plan for @p elements, in registry order, and bind
+		///        the kernels it covers.
+		void build(const std::vector<std::shared_ptr<element::Element>>& elements,
+			bool synchronous, SpectrumSharing mode);
+
+		/// @brief True if the plan was built for exactly @p elements and neither
+		///        a connection nor a 2D kernel's spectral path has changed since.
+		bool isCurrent(const std::vector<std::shared_ptr<element::Element>>& elements) const;
+
+		/// @brief Mark every shared spectrum stale; call before each step.
+		void beginStep();
+
+		/// @brief Unbind every kernel and drop the plan.
+		void clear();
+
+		/// @brief Number of forward transforms shared by two or more kernels.
+		std::size_t getNumberOfSharedSpectra() const { return spectra.size(); }
+
+		/// @brief Number of kernels whose convolution another kernel carries.
+		std::size_t getNumberOfFusedKernels() const { return fusedKernels; }
+
+	private:
+		std::vector<std::shared_ptr<element::Element>> builtFor;
+		std::vector<std::shared_ptr<element::Kernel>> boundKernels;
+		std::vector<std::unique_ptr<tools::math::SharedSpectrum2D>> spectra;
+		std::size_t fusedKernels = 0;
+		std::uint64_t builtConnectionRevision = 0;
+		std::uint64_t builtSpectralRevision = 0;
+		bool built = false;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "elements/element.h"
+#include "tools/latency_histogram.h"
+
+namespace dnf_composer
+{
+	/// @brief Step-time distribution of one element, or of all elements of one type.
+	/// @ingroup simulation
+	struct StepTiming
+	{
+		std::string name;                   ///< Element unique name, or element type (e.g. "neural field").
+		std::uint64_t steps = 0;            ///< Timed calls to @c Element::step().
+		std::chrono::nanoseconds p50{ 0 };  ///< Median step time.
+		std::chrono::nanoseconds p99{ 0 };  ///< 99th-percentile step time.
+		std::chrono::nanoseconds max{ 0 };  ///< Longest step.
+		std::chrono::nanoseconds mean{ 0 }; ///< Mean step time.
+		std::chrono::nanoseconds total{ 0 };///< Time spent in @c Element::step() since the last reset.
+	};
+
+	/// @brief What @c Simulation::getProfile() returns. Percentiles are within
+	/// about 3% of the exact values (tools/latency_histogram.h).
+	/// @ingroup simulation
+	struct StepProfile
+	{
+		std::vector<StepTiming> elements; ///< In registry order.
+		std::vector<StepTiming> types;    ///< One per element type, by descending total time.
+	};
+
+	/// @brief Per-element step-time histograms for a @c Simulation.
+	///
+	/// Holds one tools::profiling::LatencyHistogram per element, in registry
+	/// order, so the serial loop and the ElementScheduler record into slot @c i
+	/// for element @c i without a lookup. Each element is stepped by one thread at
+	/// a time, which is all the histograms need to stay lock-free. The registry
+	/// can change between steps; @c sync() keeps the histograms of elements that
+	/// are still present.
+	///
+	/// @c profile() and @c reset() may be called from any thread.
+	///
+	/// @ingroup simulation
+	class StepProfiler
+	{
+	public:
+		/// @brief Match the slots to @p elements. Called by the stepping thread
+		///        before each timed step; an owner compare per element when nothing
+		///        changed.
+		void sync(const std::vector<std::shared_ptr<element::Element>>& elements);
+
+		/// @brief Relabel the slot of @p element after it was renamed; its steps are kept.
+		void rename(const std::shared_ptr<element::Element>& element);
+
+		/// @brief Record one step of the element in slot @p index.
+		void record(std::size_t index, std::chrono::nanoseconds duration) { slots[index]->histogram.record(duration); }
+
+		/// @brief Percentiles per element and per element type.
+		StepProfile profile() const;
+
+		/// @brief Forget every recorded step.
+		void reset();
+
+	private:
+		struct Slot
+		{
+			/// Identity only; never locked. A weak reference pins the element's
+			/// control block, so a new element can never take over this slot by
+			/// being allocated where a removed one used to be.
+			std::weak_ptr<element::Element> element;
+			std::string name;
+			std::string type;
+			tools::profiling::LatencyHistogram histogram;
+		};
+
+		std::vector<std::unique_ptr<Slot>> slots; ///< Heap-held: histograms are not movable.
+		mutable std::mutex mutex;                 ///< Guards the slot list against profile() and reset().
+	};
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tools/sparse_matrix.h"
+
+namespace dnf_composer
+{
+	class Simulation;
+
+	/// @brief When @c WeightCheckpointer takes a checkpoint, and how many it keeps.
+	/// @ingroup simulation
+	struct CheckpointPolicy
+	{
+		int everySteps = 0;        ///< Checkpoint every N steps; 0 disables the step trigger.
+		double everySeconds = 0.0; ///< Checkpoint every T wall-clock seconds; 0 disables the time trigger.
+		int keep = 3;              ///< Newest checkpoints kept on disk; older ones are deleted. 0 keeps all.
+	};
+
+	/// @brief Counters reported by @c WeightCheckpointer::getStats().
+	/// @ingroup simulation
+	struct CheckpointStats
+	{
+		std::uint64_t snapshotsTaken = 0;      ///< Snapshots copied at a step boundary.
+		std::uint64_t snapshotsSuperseded = 0; ///< Snapshots replaced by a newer one before the writer reached them.
+		std::uint64_t checkpointsWritten = 0;  ///< Checkpoints completely on disk.
+		std::uint64_t writeFailures = 0;       ///< Checkpoints abandoned on an I/O error (logged).
+		std::uint64_t bytesWritten = 0;        ///< Weight file bytes written, headers included.
+		std::chrono::nanoseconds writeTime{ 0 };        ///< Writer thread time spent on checkpoints.
+		std::chrono::nanoseconds lastSnapshotTime{ 0 }; ///< Stepping-thread cost of the latest snapshot.
+		std::chrono::nanoseconds maxSnapshotTime{ 0 };  ///< Largest stepping-thread snapshot cost.
+		std::string lastCheckpoint; ///< Directory of the newest complete checkpoint; empty if none.
+
+		/// @brief Writer throughput in MB/s (10^6 bytes) over all checkpoints; 0 before the first.
+		[[nodiscard]] double throughputMBps() const;
+	};
+
+	/// @brief Periodically saves every FieldCoupling's weights without stalling the step loop.
+	///
+	/// @c update() runs at the end of each @c Simulation::step(). When the policy
+	/// says a checkpoint is due it copies the weights of every FieldCoupling (the
+	/// dense matrix, or the CSR arrays under WeightStorage::SPARSE) into one of two
+	/// preallocated snapshot buffers -- a memcpy per coupling, no allocation once
+	/// the buffers have grown to size -- and hands it to a background thread. The
+	/// writer saves each coupling as a binary weight file
+	/// (<name>_weights.dnfw, tools/weight_file.h) into a temporary directory and
+	/// renames it to `checkpoint_<sequence>_<ticks>` once complete, so a checkpoint
+	/// on disk is always whole. The sequence number counts checkpoints in the order
+	/// they were taken and carries on from the checkpoints already in the directory
+	/// when @c start() is called again, so a restarted simulation, whose ticks begin
+	/// at 0 again, neither overwrites an older run's checkpoint nor has its own
+	/// rotated away first. After each write the writer deletes the oldest
+	/// checkpoints, in that order, beyond @c CheckpointPolicy::keep; one it
+	/// cannot delete is logged and tried again after the next write.
+	///
+	/// The stepping thread never waits for the writer: it only fills the buffer the
+	/// writer is not reading. If a checkpoint falls due while the previous one is
+	/// still queued, the queued one is replaced (counted in
+	/// @c CheckpointStats::snapshotsSuperseded), so a slow disk drops intermediate
+	/// checkpoints rather than slowing the simulation.
+	///
+	/// A checkpoint directory is a valid weights directory: point a coupling's
+	/// @c setWeightsDirectory() at it, or use @c restore().
+	///
+	/// @ingroup simulation
+	class WeightCheckpointer
+	{
+	public:
+		WeightCheckpointer() = default;
+		/// @brief Stops the writer, finishing a queued checkpoint first.
+		~WeightCheckpointer();
+		WeightCheckpointer(const WeightCheckpointer&) = delete;
+		WeightCheckpointer& operator=(const WeightCheckpointer&) = delete;
+
+		/// @brief Start checkpointing into @p directory (created if missing) and
+		/// start the writer thread. Restarts the step/time triggers and the
+		/// statistics. If already active, stops first.
+		/// @return false (and logs an ERROR) if the directory cannot be created.
+		bool start(const std::string& directory, const CheckpointPolicy& policy);
+
+		/// @brief Write the queued checkpoint, if any, and stop the writer thread.
+		void stop();
+
+		/// @brief Step-boundary hook called by @c Simulation::step(): takes a
+		/// snapshot when a trigger is due. A no-op while inactive.
+		void update(const Simulation& sim);
+
+		/// @brief Snapshot now, regardless of the triggers (which restart from here).
+		/// @return false if the checkpointer is not active.
+		bool checkpointNow(const Simulation& sim);
+
+		/// @brief Block until every snapshot taken so far is on disk. For tests and
+		/// shutdown paths; never called from @c step().
+		void flush();
+
+		[[nodiscard]] bool isActive() const { return active; }
+		[[nodiscard]] const std::string& getDirectory() const { return directory; }
+		[[nodiscard]] const CheckpointPolicy& getPolicy() const { return policy; }
+		[[nodiscard]] CheckpointStats getStats() const;
+
+		/// @brief Complete checkpoint directories under @p directory, oldest first
+		/// (by sequence number, not tick).
+		[[nodiscard]] static std::vector<std::string> listCheckpoints(const std::string& directory);
+
+		/// @brief The default checkpoint directory, `data/<simName>/checkpoints`.
+		[[nodiscard]] static std::string defaultDirectory(const std::string& simName);
+
+		/// @brief Load every FieldCoupling of @p sim that has a file in
+		/// @p checkpointDirectory from it. Each coupling keeps its own weights
+		/// directory and file format, and copies the weights into memory rather
+		/// than keeping the checkpoint's files mapped, so rotation can delete them.
+		/// @return The number of couplings whose weights were loaded; a file that
+		///         fails to load (logged) is not counted.
+		static int restore(const Simulation& sim, const std::string& checkpointDirectory);
+
+	private:
+		struct CouplingWeights
+		{
+			std::string name;
+			std::size_t rows = 0;
+			std::size_t cols = 0;
+			bool sparse = false;
+			std::vector<double> dense;
+			tools::math::CsrMatrix csr;
+		};
+
+		struct Snapshot
+		{
+			long long ticks = 0;
+			std::uint64_t sequence = 0;
+			std::vector<CouplingWeights> couplings; ///< Reused, so its buffers keep their capacity.
+		};
+
+		enum class SlotState { Free, Filling, Queued, Writing };
+
+		void takeSnapshot(const Simulation& sim);
+		void writerLoop();
+		/// @brief Write @p snapshot as one checkpoint directory; returns its bytes.
+		std::uint64_t writeCheckpoint(const Snapshot& snapshot) const;
+		void rotate() const;
+
+		bool active = false;
+		std::string directory;
+		CheckpointPolicy policy;
+		int stepsSinceCheckpoint = 0;
+		std::uint64_t nextSequence = 0; ///< Stepping thread only.
+		std::chrono::steady_clock::time_point lastCheckpointAt;
+
+		std::array<Snapshot, 2> slots;
+		std::array<SlotState, 2> states{ SlotState::Free, SlotState::Free };
+		bool stopping = false;
+		CheckpointStats stats;
+		mutable std::mutex mutex; ///< Guards states, stopping and stats.
+		std::condition_variable queued;
+		std::condition_variable idle;
+		std::thread writer;
+	};
+}
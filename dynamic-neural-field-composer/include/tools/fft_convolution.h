@@ -1,10 +1,16 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
-// FFTW-backed circular 2D convolution, for kernels wide enough that the
-// direct/separable path (tools/math.h conv2d_separable_into) is no longer the
-// cheaper option (see kFFTTapThreshold below for the dispatch rule). Only
+#include "tools/precision.h"
+
+// FFTW-backed circular 2D and 1D convolution, for kernels wide enough that the
+// direct path (tools/math.h conv2d_separable_into in 2D, conv_valid_into in
+// 1D) is no longer the cheaper option (see kFFTTapThreshold and
+// kFFTTapThreshold1D below for the dispatch rules). Only
 // supports CIRCULAR boundaries — an FFT of the full field natively computes a
 // periodic convolution, which is exactly what `circular = true` means;
 // non-circular kernels keep using the direct path.
@@ -77,6 +83,133 @@ namespace dnf_composer::tools::math
 	// between the direct separable path and the fused spectral path.
 	bool shouldUseSpectral2D(bool circular, int totalTaps, int size_x, int size_y);
 
+	// 1D crossover, in taps of the (already fused) kernel window. Measured
+	// with kernelbench's BM_Conv1dCircularDirect / BM_Conv1dSpectral grid
+	// (fields of 128 to 16,384 samples, 15 to 255 taps, FFTW_ESTIMATE plans):
+	// the direct path (circular gather plus conv_valid_into) wins or ties at
+	// 31 taps and below at every size, the spectral path wins from 79 taps
+	// at every size, and in between the winner flips with the size (63 taps:
+	// spectral by 1.4x at 2,048 samples, direct by 1.3x at 16,384). 64 sits
+	// in that band and errs towards the direct path, which is exact and
+	// keeps each window's summation order.
+	inline constexpr int kFFTTapThreshold1D = 64;
+
+	// Minimum field size for the 1D Auto dispatch to pick spectral. Not a
+	// speed crossover: above kFFTTapThreshold1D the spectral path measured
+	// faster at every size down to 50 samples (2x at 100). It keeps the
+	// 100-sample 1D validation decks on the exact direct path, as
+	// kFFTMinAxisSize does for the 50x50 2D decks; a field that small costs
+	// about a microsecond per kernel either way.
+	inline constexpr int kFFTMinSize1D = 128;
+
+	// The 1D counterpart of shouldUseSpectral2D, used by GaussKernel,
+	// MexicanHatKernel, OscillatoryKernel, AsymmetricGaussKernel and
+	// CorrelatedNormalNoise. Honours the same ConvolutionMode override.
+	bool shouldUseSpectral1D(bool circular, int totalTaps, int size);
+
+
+	// How hard FFTW searches for a fast plan when a transform shape is first
+	// needed. Estimate (the default) picks an algorithm by heuristic, with no
+	// timing trials, so planning never stalls the UI while a slider is dragged.
+	// Measure and Patient time candidate algorithms and typically run the
+	// transforms noticeably faster, but planning one shape takes from tens of
+	// milliseconds to seconds, so they never plan in the caller's thread:
+	// a shape not yet covered by wisdom gets an Estimate plan at once, and its
+	// measured plan is built on a background thread and swapped in when ready
+	// (see waitForFftPlans()). A shape already cached is handed out without
+	// waiting for a measurement in progress; a new one waits out at most one
+	// transform's timing trials, since FFTW's planner serves one caller at a
+	// time. Measured plans are picked by timing, so results
+	// can differ from Estimate's, and between machines, at rounding level.
+	//
+	// Process-global, like ConvolutionMode. The first switch away from
+	// Estimate loads the wisdom saved under defaultFftWisdomDirectory(), so a
+	// deployment that pre-generated it (dnf_composer_wisdom) gets its measured
+	// plans without any timing trials at all.
+	enum class PlanRigor { Estimate, Measure, Patient };
+
+	void setPlanRigor(PlanRigor rigor);
+	PlanRigor planRigor();
+
+	// RAII scoped rigor: restores the previous one on destruction. Not
+	// copyable/movable.
+	class ScopedPlanRigor
+	{
+	public:
+		explicit ScopedPlanRigor(PlanRigor rigor);
+		~ScopedPlanRigor();
+		ScopedPlanRigor(const ScopedPlanRigor&) = delete;
+		ScopedPlanRigor& operator=(const ScopedPlanRigor&) = delete;
+		ScopedPlanRigor(ScopedPlanRigor&&) = delete;
+		ScopedPlanRigor& operator=(ScopedPlanRigor&&) = delete;
+	private:
+		PlanRigor previous_;
+	};
+
+	// Every SpectralConvolver2D, SpectralConvolver1D and SharedSpectrum2D
+	// executes its transforms through one process-wide plan cache, keyed by
+	// transform shape: N convolvers of one shape plan once, a kernel's
+	// setParameters() re-init finds its plans already there, and a plan
+	// upgraded to Measure reaches every convolver of that shape, live ones
+	// included. The cache keeps a shape's plans until clearFftPlanCache().
+	struct FftPlanShape
+	{
+		int rank = 2;       // 1 for SpectralConvolver1D's transforms
+		int size_x = 0;
+		int size_y = 1;     // 1 when rank == 1
+		Precision precision = Precision::Double;
+		PlanRigor rigor = PlanRigor::Estimate;   // of the plans in use now
+		int jobs = 1;       // kFFTThreadedJobs from kFFTThreadedMinCells up
+	};
+
+	// Transforms of at least this many samples are planned as threaded FFTW
+	// plans (fftw_plan_with_nthreads) split into kFFTThreadedJobs jobs. FFTW
+	// starts no threads of its own: its parallel loops are handed to
+	// tools::threading::parallelFor, so the jobs run on the pool of the
+	// simulation that is stepping the convolving element, within that
+	// simulation's thread budget, and inline where there is no pool. The job
+	// count is a constant rather than the budget so a shape's plan, and with it
+	// the result, is the same whatever the thread count. 256x256 is where one
+	// transform first costs well over a millisecond; below it splitting costs
+	// about what it saves.
+	inline constexpr int kFFTThreadedMinCells = 256 * 256;
+	inline constexpr int kFFTThreadedJobs = 8;
+
+	// Whether the FFTW loaded at run time hands threaded plans' jobs to
+	// parallelFor. The hook (fftw_threads_set_callback) arrived in FFTW 3.3.9;
+	// an older shared FFTW than the headers built against still runs the jobs,
+	// but on threads it starts itself, outside any simulation's budget.
+	bool fftJobsRunOnThreadPool();
+
+	std::vector<FftPlanShape> cachedFftPlans();
+
+	// Ahead-of-time planning: makes sure the shape's plans are at least
+	// `rigor`, planning in the calling thread (blocking) if they are not.
+	void prepareFftPlans2D(int size_x, int size_y, Precision precision, PlanRigor rigor);
+	void prepareFftPlans1D(int size, PlanRigor rigor);
+
+	// Blocks until every background measurement started so far has finished
+	// and its plans are in use. Threads may wait at the same time.
+	void waitForFftPlans();
+
+	// Drops the cache's hold on every shape (after waitForFftPlans()). Live
+	// convolvers keep the plans they hold; the next init() of a new convolver
+	// plans again at the current rigor.
+	void clearFftPlanCache();
+
+	// FFTW wisdom: what the Measure/Patient planner learned, so it never has
+	// to time the same shape twice. Kept as two files (double.wisdom and
+	// single.wisdom, one per FFTW precision) in a directory. load merges into
+	// the process's wisdom and returns true if either file was read; save
+	// creates the directory and returns true if both files were written.
+	std::string defaultFftWisdomDirectory();   // <resource root>/data/fftw-wisdom
+	bool loadFftWisdom(const std::string& directory);
+	bool saveFftWisdom(const std::string& directory);
+
+	// The cached plans of one transform shape (defined in fft_convolution.cpp).
+	struct FftPlanSlot;
+
+	class SharedSpectrum2D;
 
 	class SpectralConvolver2D
 	{
@@ -84,11 +217,12 @@ namespace dnf_composer::tools::math
 		SpectralConvolver2D() = default;
 		~SpectralConvolver2D();
 
-		// Deep copies: re-plans independently for the same size and duplicates the
-		// stored spectral kernel, rather than sharing the source's FFTW plan/buffer
-		// pointers. Needed because Element::clone() copy-constructs the owning
-		// kernel element (see MexicanHatKernel2D::clone()) — a shallow pointer copy
-		// here would double-free the FFTW plans when both copies are destroyed.
+		// Deep copies: allocates its own buffers (the cached plans are shared)
+		// and duplicates the stored spectral kernel, rather than sharing the
+		// source's buffer pointers. Needed because Element::clone()
+		// copy-constructs the owning kernel element (see
+		// MexicanHatKernel2D::clone()) — a shallow pointer copy here would
+		// double-free the FFTW buffers when both copies are destroyed.
 		SpectralConvolver2D(const SpectralConvolver2D& other);
 		SpectralConvolver2D& operator=(const SpectralConvolver2D& other);
 		SpectralConvolver2D(SpectralConvolver2D&& other) noexcept;
@@ -96,12 +230,20 @@ namespace dnf_composer::tools::math
 
 		// (Re)plan for a row-major, y-major field of size_x * size_y
 		// (field[y * size_x + x]) — matches the layout conv2d_separable_into
-		// uses. Safe to call again, including with an unchanged size (a no-op:
-		// the existing plans and kernel spectrum are left untouched) or a
-		// different size (destroys and re-plans). Because same-size calls are a
-		// no-op, every caller whose taps may have changed — even when the grid
-		// did not — must still call setKernel() after init(); see setKernel().
-		void init(int size_x, int size_y);
+		// uses. Safe to call again, including with an unchanged size and
+		// precision (a no-op: the existing plans and kernel spectrum are left
+		// untouched) or a different one (destroys and re-plans). Because
+		// same-size calls are a no-op, every caller whose taps may have changed
+		// — even when the grid did not — must still call setKernel() after
+		// init(); see setKernel(). The plans come from the process-wide cache
+		// (see FftPlanShape above), so only a shape new to the process plans.
+		//
+		// Precision::Single plans with fftwf and keeps every buffer and the
+		// kernel spectrum in float. The double apply() still works, narrowing
+		// the field on the way in and widening the result on the way out; the
+		// 2D elements, which keep their field and result in float, use the
+		// float overloads instead (see tools/precision.h).
+		void init(int size_x, int size_y, Precision precision = Precision::Double);
 
 		// Sets the frequency-domain kernel from a real, size_x*size_y spatial
 		// kernel that has already been "wrap embedded" — i.e. kernel[0,0] holds
@@ -119,20 +261,133 @@ namespace dnf_composer::tools::math
 		// and setKernel().
 		void apply(const double* field, double* out);
 
+		// apply() without its forward transform: out = circular_convolve(field,
+		// kernel) for the field whose spectrum `spectrum` holds, which must have
+		// been computed at this convolver's size and precision. The same complex
+		// multiply and inverse transform as apply(), so the result is
+		// bit-identical to apply() on that field.
+		void applySpectrum(const SharedSpectrum2D& spectrum, double* out);
+
+		// apply() and applySpectrum() on float buffers, with no conversion
+		// pass. Precision::Single only; throws std::invalid_argument otherwise.
+		void apply(const float* field, float* out);
+		void applySpectrum(const SharedSpectrum2D& spectrum, float* out);
+
+		// Adds `other`'s kernel spectrum to this one's, so that apply() returns
+		// the sum of both convolutions through a single inverse transform. Both
+		// must share size and precision; throws std::invalid_argument otherwise.
+		void addKernelSpectrum(const SpectralConvolver2D& other);
+
+		int sizeX() const { return size_x_; }
+		int sizeY() const { return size_y_; }
+		Precision precision() const { return precision_; }
+
 	private:
 		void destroy();
 		void copyFrom(const SpectralConvolver2D& other);
 
 		int size_x_ = 0;
 		int size_y_ = 0;
+		Precision precision_ = Precision::Double;
+
+		// Opaque FFTW buffers (fftw_malloc'd double* / fftw_complex*, or their
+		// fftwf float counterparts in Precision::Single), cast in
+		// fft_convolution.cpp. void* keeps <fftw3.h> out of this header. The
+		// plans are the cache's, executed on these buffers.
+		void* fieldReal_    = nullptr;
+		void* fieldFreq_    = nullptr;
+		void* kernelFreq_   = nullptr;
+		void* resultReal_   = nullptr;
+		std::shared_ptr<FftPlanSlot> plans_;
+	};
+
+	// The forward transform of one field, shared by every SpectralConvolver2D
+	// that convolves that field in the same step (Simulation's spectrum
+	// sharing, see simulation/spectral_sharing.h). forward() transforms the
+	// field once and returns immediately on every later call until
+	// invalidate() marks the held spectrum stale, so N kernels reading one
+	// source pay one r2c instead of N. forward() may be called concurrently
+	// from several threads: the first caller transforms, the others wait for
+	// it. invalidate() must not race with forward(). Not copyable or movable.
+	class SharedSpectrum2D
+	{
+	public:
+		SharedSpectrum2D() = default;
+		~SharedSpectrum2D();
+		SharedSpectrum2D(const SharedSpectrum2D&) = delete;
+		SharedSpectrum2D& operator=(const SharedSpectrum2D&) = delete;
+		SharedSpectrum2D(SharedSpectrum2D&&) = delete;
+		SharedSpectrum2D& operator=(SharedSpectrum2D&&) = delete;
+
+		// (Re)plan for a size_x * size_y field, laid out as in
+		// SpectralConvolver2D::init(). Leaves the spectrum stale.
+		void init(int size_x, int size_y, Precision precision = Precision::Double);
+
+		// Transform `field` (size_x*size_y) unless the spectrum is current.
+		void forward(const double* field);
+		void invalidate() { current_ = false; }
+
+		bool matches(const SpectralConvolver2D& convolver) const
+		{
+			return convolver.sizeX() == size_x_ && convolver.sizeY() == size_y_ &&
+				convolver.precision() == precision_;
+		}
+
+	private:
+		friend class SpectralConvolver2D;
+		void destroy();
+
+		int size_x_ = 0;
+		int size_y_ = 0;
+		Precision precision_ = Precision::Double;
+		bool current_ = false;
+		std::mutex mutex_;
+
+		// Opaque FFTW buffers and the cached plans, as in SpectralConvolver2D.
+		// The forward plan is the one the convolvers of this shape execute.
+		void* fieldReal_   = nullptr;
+		void* spectrum_    = nullptr;
+		std::shared_ptr<FftPlanSlot> plans_;
+	};
+
+	// FFTW-backed circular 1D convolution, the 1D counterpart of
+	// SpectralConvolver2D: same lifecycle (deep copies, same-size init() is a
+	// no-op that keeps the kernel spectrum), same normalization folded into
+	// setKernel(). Double precision only; Precision::Single covers the 2D path.
+	class SpectralConvolver1D
+	{
+	public:
+		SpectralConvolver1D() = default;
+		~SpectralConvolver1D();
+
+		SpectralConvolver1D(const SpectralConvolver1D& other);
+		SpectralConvolver1D& operator=(const SpectralConvolver1D& other);
+		SpectralConvolver1D(SpectralConvolver1D&& other) noexcept;
+		SpectralConvolver1D& operator=(SpectralConvolver1D&& other) noexcept;
+
+		// (Re)plan for a field of `size` samples. Callers must still call
+		// setKernel() afterwards whenever the taps may have changed.
+		void init(int size);
+
+		// Sets the kernel from a size-long, wrap-embedded real kernel (see
+		// buildWrappedKernel1D in tools/math.h). Must be called after init().
+		void setKernel(const std::vector<double>& wrappedKernelReal);
+
+		// out = circular_convolve(field, kernel) over the first `size` samples
+		// of field. out may not overlap field.
+		void apply(const double* field, double* out);
+
+	private:
+		void destroy();
+		void copyFrom(const SpectralConvolver1D& other);
+
+		int size_ = 0;
 
-		// Opaque FFTW handles (fftw_plan / fftw_malloc'd double* / fftw_complex*),
-		// cast in fft_convolution.cpp. void* keeps <fftw3.h> out of this header.
+		// Opaque FFTW buffers and the cached plans, as in SpectralConvolver2D.
 		void* fieldReal_    = nullptr;
 		void* fieldFreq_    = nullptr;
 		void* kernelFreq_   = nullptr;
 		void* resultReal_   = nullptr;
-		void* forwardPlan_  = nullptr;
-		void* inversePlan_  = nullptr;
+		std::shared_ptr<FftPlanSlot> plans_;
 	};
 }
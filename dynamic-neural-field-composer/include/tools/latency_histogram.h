@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// A histogram of durations with bounded relative error, in the style of an HDR
+// histogram: values below 16 ns have a bucket each, and every power of two
+// above is split into 16 buckets, so a reported value is within 1/32 of the
+// recorded one. Durations up to 2^40 ns (about 18 minutes) are resolved; longer
+// ones land in the last bucket, and max() still reports them exactly.
+//
+// record() is lock-free and meant for one writer at a time: counts are updated
+// with relaxed loads and stores, not read-modify-writes. Successive writers
+// must be ordered by some other synchronisation (a simulation step boundary,
+// for instance). snapshot() may run on any thread at any time; a snapshot taken
+// during a record() may miss that one duration.
+namespace dnf_composer::tools::profiling
+{
+	class LatencyHistogram
+	{
+	public:
+		static constexpr std::size_t kSubBuckets = 16;
+		static constexpr int kMaxExponent = 40;
+		static constexpr std::size_t kBuckets = kSubBuckets + (kMaxExponent - 4) * kSubBuckets;
+
+		// Plain counts, for reading and merging.
+		struct Snapshot
+		{
+			std::array<std::uint64_t, kBuckets> counts{};
+			std::uint64_t count = 0;
+			std::chrono::nanoseconds total{ 0 };
+			std::chrono::nanoseconds max{ 0 };
+
+			// The duration at quantile `q` (0 to 1) of the recorded ones: the middle
+			// of its bucket, never more than max, and max itself for the largest.
+			// 0 for an empty snapshot.
+			std::chrono::nanoseconds percentile(double q) const;
+			std::chrono::nanoseconds mean() const;
+
+			Snapshot& operator+=(const Snapshot& other);
+		};
+
+		void record(std::chrono::nanoseconds duration);
+		Snapshot snapshot() const;
+		// A record() running at the same time may be partly lost.
+		void reset();
+
+		static std::size_t bucketOf(std::uint64_t nanoseconds);
+		// The smallest duration that falls in `bucket`, and the width of the bucket.
+		static std::uint64_t bucketStart(std::size_t bucket);
+		static std::uint64_t bucketWidth(std::size_t bucket);
+
+	private:
+		std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+		std::atomic<std::uint64_t> total_{ 0 };
+		std::atomic<std::uint64_t> max_{ 0 };
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+// A memory mapping of a whole file (mmap, or MapViewOfFile on Windows),
+// shared by the binary file readers (weight_file.h, recording_file.h). The
+// mapping is private: later writes to the file, such as frames appended to a
+// recording, are not guaranteed to show up in it.
+//
+// A CopyOnWrite mapping may also be written through mutableData(): a page is
+// copied the first time it is written, and neither the file nor other
+// mappings of it ever see the change. Pages that are only read stay shared
+// with the page cache.
+namespace dnf_composer::tools
+{
+	class MappedFile
+	{
+	public:
+		enum class Access { ReadOnly, CopyOnWrite };
+
+		MappedFile() = default;
+		// Throws std::runtime_error if the file cannot be opened or mapped. An
+		// empty file maps to no bytes.
+		explicit MappedFile(const std::string& path, Access access = Access::ReadOnly);
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		const std::byte* data() const { return data_; }
+		std::size_t size() const { return size_; }
+		std::span<const std::byte> bytes() const { return { data_, size_ }; }
+		// The mapping for writing; nullptr unless mapped CopyOnWrite.
+		std::byte* mutableData() const { return writable_ ? const_cast<std::byte*>(data_) : nullptr; }
+
+		void reset() noexcept;
+
+	private:
+		const std::byte* data_ = nullptr;
+		std::size_t size_ = 0;
+		bool writable_ = false;
+	};
+}
@@ -35,11 +35,12 @@
 #include <span>
 #include <cstdint>
 
-// Runtime-dispatched AVX2+FMA convolution kernel (see simd_dispatch.h): the
-// decision to use it is a runtime cpuid check, not a compile-time macro, so this
-// header compiles and the resulting binary runs correctly whether or not the
-// host CPU has AVX2.
+// Runtime-dispatched SIMD convolution kernels (see simd_dispatch.h): the tier is
+// chosen by a runtime cpuid check, not a compile-time macro, so this header
+// compiles and the resulting binary runs correctly whether or not the host CPU
+// has AVX2 or AVX-512.
 #include "tools/simd_dispatch.h"
+#include "tools/thread_pool.h"
 
 namespace dnf_composer::tools::math
 {
@@ -113,14 +114,17 @@ namespace dnf_composer::tools::math
 
 	// In-place variants — write into a caller-supplied buffer (no heap allocation).
 	// `out` must be pre-sized to the correct output length before calling.
+	// The inputs are spans (T is deduced from `out` alone), so an element's
+	// ComponentBuffer passes straight in without a copy.
 
 	template<typename T>
-	void conv_valid_into(std::vector<T>& out, const std::vector<T>& f, const std::vector<T>& g)
+	void conv_valid_into(std::vector<T>& out, std::type_identity_t<std::span<const T>> f,
+	                     std::type_identity_t<std::span<const T>> g)
 	{
 		const int nf = static_cast<int>(f.size());
 		const int ng = static_cast<int>(g.size());
-		const std::vector<T>& min_v = (nf < ng) ? f : g;
-		const std::vector<T>& max_v = (nf < ng) ? g : f;
+		const std::span<const T> min_v = (nf < ng) ? f : g;
+		const std::span<const T> max_v = (nf < ng) ? g : f;
 		const int M = static_cast<int>(min_v.size());
 		const int n = std::max(nf, ng) - std::min(nf, ng) + 1;
 
@@ -150,15 +154,17 @@ namespace dnf_composer::tools::math
 
 		if constexpr (std::is_same_v<T, double>)
 		{
-			// Runtime dispatch (checked once, cached): use the AVX2+FMA kernel only
-			// if the host CPU actually supports it. See simd_dispatch.h/.cpp — this
-			// replaces what used to be a compile-time #if on the caller's own build
-			// flags, so this same binary is correct on pre-AVX2 x86-64 CPUs too.
-			if (detail::avx2_fma_available())
-			{
-				detail::conv_valid_into_avx2_f64(kr, M, mx, out.data(), n);
-				return;
-			}
+			// Runtime dispatch (tier chosen once, cached): the widest kernel the
+			// host CPU supports. See simd_dispatch.h/.cpp — this replaces what
+			// used to be a compile-time #if on the caller's own build flags, so
+			// this same binary is correct on pre-AVX2 x86-64 CPUs too.
+			detail::simdKernels().conv_valid_f64(kr, M, mx, out.data(), n);
+			return;
+		}
+		else if constexpr (std::is_same_v<T, float>)
+		{
+			detail::simdKernels().conv_valid_f32(kr, M, mx, out.data(), n);
+			return;
 		}
 		for (int i = 0; i < n; ++i)
 		{
@@ -172,7 +178,8 @@ namespace dnf_composer::tools::math
 	}
 
 	template<typename T>
-	void conv_same_into(std::vector<T>& out, const std::vector<T>& f, const std::vector<T>& g)
+	void conv_same_into(std::vector<T>& out, std::type_identity_t<std::span<const T>> f,
+	                    std::type_identity_t<std::span<const T>> g)
 	{
 		const int nf = static_cast<int>(f.size());
 		const int ng = static_cast<int>(g.size());
@@ -238,7 +245,7 @@ namespace dnf_composer::tools::math
 	/// fills @p out with `T()` rather than touching out-of-bounds memory.
 	template<typename T>
 	void obtainCircularVector_into(std::vector<T>& out, const std::vector<int>& indices,
-	                               const std::vector<T>& contents)
+	                               std::type_identity_t<std::span<const T>> contents)
 	{
 		const std::size_t size = contents.size();
 		const bool allInRange = std::ranges::all_of(indices,
@@ -479,6 +486,20 @@ namespace dnf_composer::tools::math
 	// spectral convolution paths can be compared against identical input.
 	void seedNormal(std::uint64_t seed);
 
+	// A normal generator with its own state, for callers that need several
+	// independent, reproducible streams on one thread (e.g. one per
+	// EnsembleSimulation instance). Same algorithm as fillNormal: a stream
+	// constructed with `seed` yields exactly the samples fillNormal yields
+	// after seedNormal(seed).
+	class NormalStream
+	{
+	public:
+		explicit NormalStream(std::uint64_t seed);
+		void fill(double* dst, std::size_t n);
+	private:
+		std::array<std::uint64_t, 4> state;
+	};
+
 	// One separable term of a wrapped 2D kernel: sign * outer(taps_x, taps_y).
 	// taps_x/taps_y are ordered ascending offset -kR0..+kR1 (the layout every 2D
 	// kernel element's std::iota(-kernelRange[0]) already produces).
@@ -525,6 +546,11 @@ namespace dnf_composer::tools::math
 			std::span<const SeparableKernelTerm2D>(terms.begin(), terms.size()));
 	}
 
+	// The 1D counterpart: a size-long real kernel holding `window` (ordered
+	// ascending offset -kR0..+kR1) wrap embedded, which is what
+	// SpectralConvolver1D::setKernel expects. Returns {} for a non-positive size.
+	std::vector<double> buildWrappedKernel1D(int size, std::span<const double> window, int kR0);
+
 	template <typename T>
 	std::vector<T> normalize(const std::vector<T>& vector)
 	{
@@ -549,9 +575,58 @@ namespace dnf_composer::tools::math
 		return normalizedVector;
 	}
 
-	template <typename T>
-	std::vector<T> hebbLearningRule(std::vector<T>& weights, const std::vector<T>& input, const std::vector<T>& output, double learningRate)
+	// Output columns gemv_into() accumulates at a time: 4 KiB of partial sums,
+	// which stay in L1 while every active weight row streams past them.
+	inline constexpr std::size_t kGemvBlock = 512;
+
+	// The couplings' forward pass:
+	//   out[j] = sum_i (scale * weights[i * out.size() + j]) * in[i]
+	// weights is a flattened (in.size() x out.size()) row-major matrix, the layout
+	// the learning rules below update, so each input's row is contiguous. Rather
+	// than dotting a strided column per output, this adds whole rows into the
+	// output (one SIMD axpy per input, detail::simdKernels().scaled_axpy_f64), a
+	// kGemvBlock-wide block of outputs at a time.
+	//
+	// Inputs that are exactly zero (a Heaviside field at rest, an unconnected
+	// input) are skipped. Their terms are +-0, and adding a zero to a sum that
+	// starts at +0 never changes it, so every output still receives the same
+	// products in ascending input order: the result is bit-identical to the
+	// column-by-column loop for finite weights.
+	inline void gemv_into(std::span<double> out, std::span<const double> weights,
+		std::span<const double> in, double scale)
+	{
+		const std::size_t outputSize = out.size();
+		if (weights.size() != in.size() * outputSize) {
+			throw std::invalid_argument("Weight matrix size mismatch");
+}
+
+		static thread_local std::vector<std::size_t> active;
+		active.clear();
+		for (std::size_t i = 0; i < in.size(); ++i) {
+			if (in[i] != 0.0) {
+				active.push_back(i);
+}
+		}
+
+		std::ranges::fill(out, 0.0);
+		const auto axpy = detail::simdKernels().scaled_axpy_f64;
+		for (std::size_t j0 = 0; j0 < outputSize; j0 += kGemvBlock)
+		{
+			const std::size_t n = std::min(kGemvBlock, outputSize - j0);
+			for (const std::size_t i : active) {
+				axpy(out.data() + j0, weights.data() + i * outputSize + j0, n, scale, in[i]);
+}
+		}
+	}
+
+	// The learning rules update `weights` in place (a std::vector or an element's
+	// ComponentBuffer) and return a copy of the updated weights.
+	template <typename Weights>
+	std::vector<typename Weights::value_type> hebbLearningRule(Weights& weights,
+		std::span<const typename Weights::value_type> input,
+		std::span<const typename Weights::value_type> output, double learningRate)
 	{
+		using T = typename Weights::value_type;
 		if (input.empty() || output.empty()) {
 			throw std::invalid_argument("Input and output vectors cannot be empty");
 }
@@ -574,11 +649,13 @@ namespace dnf_composer::tools::math
 }
 		}
 
-		return weights;
+		return { weights.begin(), weights.end() };
 	}
 
-	template <typename T>
-	std::vector<T> ojaLearningRule(std::vector<T>& weights, const std::vector<T>& input, const std::vector<T>& output, double learningRate)
+	template <typename Weights>
+	std::vector<typename Weights::value_type> ojaLearningRule(Weights& weights,
+		std::span<const typename Weights::value_type> input,
+		std::span<const typename Weights::value_type> output, double learningRate)
 	{
 		const int inputSize = input.size();
 		const int outputSize = output.size();
@@ -591,7 +668,7 @@ namespace dnf_composer::tools::math
 			}
 }
 
-		return weights;
+		return { weights.begin(), weights.end() };
 	}
 
 	/// @brief Supervised Widrow-Hoff / delta rule with weight decay, used by
@@ -628,11 +705,13 @@ namespace dnf_composer::tools::math
 	/// @param decayRate     Weight decay coefficient (0.0 disables decay).
 	/// @throws std::invalid_argument if `pre` or `target` is empty, if `target`/`actual`
 	///         sizes disagree, or if `weights.size() != pre.size() * target.size()`.
-	template <typename T>
-	std::vector<T> deltaLearningRuleWidrowHoff(std::vector<T>& weights,
-		const std::vector<T>& pre, const std::vector<T>& target,
-		const std::vector<T>& actual, double learningRate, double decayRate = 0.0)
+	template <typename Weights>
+	std::vector<typename Weights::value_type> deltaLearningRuleWidrowHoff(Weights& weights,
+		std::span<const typename Weights::value_type> pre,
+		std::span<const typename Weights::value_type> target,
+		std::span<const typename Weights::value_type> actual, double learningRate, double decayRate = 0.0)
 	{
+		using T = typename Weights::value_type;
 		if (pre.empty() || target.empty()) {
 			throw std::invalid_argument("Pre-synaptic and target vectors cannot be empty");
 }
@@ -668,7 +747,7 @@ namespace dnf_composer::tools::math
 }
 		}
 
-		return weights;
+		return { weights.begin(), weights.end() };
 	}
 
 	template <typename T>
@@ -787,8 +866,8 @@ namespace dnf_composer::tools::math
 	}
 
 	// In-place variant: writes into a pre-sized output buffer to avoid heap allocation.
-	template<typename T>
-	void resampleInto(const std::vector<T>& input, std::vector<T>& output)
+	template<typename Buffer>
+	void resampleInto(std::span<const typename Buffer::value_type> input, Buffer& output)
 	{
 		const int N = static_cast<int>(input.size());
 		const int outputSize = static_cast<int>(output.size());
@@ -806,8 +885,8 @@ namespace dnf_composer::tools::math
 		}
 	}
 
-	template<typename T>
-	void resampleNearestInto(const std::vector<T>& input, std::vector<T>& output)
+	template<typename Buffer>
+	void resampleNearestInto(std::span<const typename Buffer::value_type> input, Buffer& output)
 	{
 		const int N = static_cast<int>(input.size());
 		const int M = static_cast<int>(output.size());
@@ -823,9 +902,10 @@ namespace dnf_composer::tools::math
 	}
 
 	// Catmull-Rom cubic spline resampling.
-	template<typename T>
-	void resampleCubicInto(const std::vector<T>& input, std::vector<T>& output)
+	template<typename Buffer>
+	void resampleCubicInto(std::span<const typename Buffer::value_type> input, Buffer& output)
 	{
+		using T = typename Buffer::value_type;
 		const int N = static_cast<int>(input.size());
 		const int M = static_cast<int>(output.size());
 		if (input.empty() || M <= 0) { return;
@@ -925,6 +1005,10 @@ namespace dnf_composer::tools::math
 		std::vector<T> row, col, convRow, convCol, extRow, extCol;
 		// Column-major tiles for the cache-blocked y-pass (up to 64 columns).
 		std::vector<T> tileIn, tileOut;
+		// One more set of the buffers above per extra chunk when
+		// conv2d_separable_into splits its passes over a thread pool; chunk 0
+		// uses this scratch itself. Grown on the first parallel call, then kept.
+		std::vector<Conv2dScratch> lanes;
 
 		void ensure(int size_x, int size_y, std::size_t extX, std::size_t extY)
 		{
@@ -954,23 +1038,59 @@ namespace dnf_composer::tools::math
 				tileOut.assign(tile, T());
 			}
 		}
+
+		// Buffers for `count` chunks. Called before the chunks start, so no
+		// chunk ever resizes `lanes` under another's feet.
+		void ensureLanes(std::size_t count, int size_x, int size_y, std::size_t extX, std::size_t extY)
+		{
+			if (lanes.size() + 1 < count) {
+				lanes.resize(count - 1);
+			}
+			for (std::size_t i = 0; i + 1 < count; ++i)
+			{
+				Conv2dScratch& lane = lanes[i];
+				if (lane.row.size() != static_cast<std::size_t>(size_x) || lane.col.size() != static_cast<std::size_t>(size_y)) {
+					lane.ensure(size_x, size_y, extX, extY);
+				}
+			}
+		}
+
+		Conv2dScratch& lane(std::size_t index) { return index == 0 ? *this : lanes[index - 1]; }
 	};
 
+	// conv2d_separable_into splits its passes over the current thread pool
+	// (tools::threading::parallelFor — the pool of the simulation stepping the
+	// element) only from this many cells up. Below it a whole pass costs a few
+	// tens of microseconds at typical kernel widths, the same order as handing
+	// chunks to other threads and waiting for them.
+	inline constexpr std::size_t kParallelConvMinCells = 128 * 128;
+
+	// Fewest rows one x-pass chunk convolves; the y-pass is split in whole
+	// 64-column tiles.
+	inline constexpr int kParallelConvMinRows = 16;
+
 	// In-place 2D separable convolution into caller-supplied buffers, reusing the
 	// temporaries held in `scratch` (no per-call heap allocation). `out` and
 	// `tmp` must be pre-sized to size_x * size_y and must be DISTINCT buffers
 	// (the y-pass reads tmp rows while writing out rows); `scratch` must be
 	// ensure()'d for these dimensions and extension lengths. This is the
-	// hot-path overload.
+	// hot-path overload. T is deduced from `scratch`; the buffers are spans, so
+	// an element's ComponentBuffers pass straight in.
+	//
+	// On grids of kParallelConvMinCells or more, called on a thread with a
+	// current pool, the x-pass is split in row blocks and the y-pass in blocks
+	// of column tiles, each block on its own scratch lane. Every output cell is
+	// still computed by the same calls in the same order, so the result is
+	// bit-identical to the single-threaded one at any thread count.
 	template<typename T>
 	// NOLINTNEXTLINE(readability-function-cognitive-complexity) - x-pass + tiled y-pass convolution; splitting would obscure the single cache-blocking pass
 	void conv2d_separable_into(
-		std::vector<T>& out,
-		std::vector<T>& tmp,
+		std::type_identity_t<std::span<T>> out,
+		std::type_identity_t<std::span<T>> tmp,
 		Conv2dScratch<T>& scratch,
-		const std::vector<T>& field,
-		const std::vector<T>& kernel_x,
-		const std::vector<T>& kernel_y,
+		std::type_identity_t<std::span<const T>> field,
+		std::type_identity_t<std::span<const T>> kernel_x,
+		std::type_identity_t<std::span<const T>> kernel_y,
 		int size_x, int size_y,
 		const std::vector<int>& extIndex_x,
 		const std::vector<int>& extIndex_y)
@@ -978,21 +1098,6 @@ namespace dnf_composer::tools::math
 		const bool circular_x = !extIndex_x.empty();
 		const bool circular_y = !extIndex_y.empty();
 
-		std::vector<T>& row     = scratch.row;
-		std::vector<T>& col     = scratch.col;
-		std::vector<T>& convRow = scratch.convRow;
-		std::vector<T>& extRow  = scratch.extRow;
-
-		// conv_valid_into derives its output length from extRow .size(), so it
-		// must match THIS call's extension length exactly — not the scratch's
-		// high-water capacity. (MexicanHat calls this twice with different kernel
-		// widths sharing one scratch; sizing to the max would make the narrower
-		// kernel emit > size_x outputs and overflow convRow.) resize() keeps the
-		// capacity ensure() reserved, so no reallocation occurs.
-		if (circular_x) {
-			extRow.resize(extIndex_x.size());
-		}
-
 		// x-pass: convolve each row (fixed y) with kernel_x. The circular
 		// extension is three contiguous copies — createExtendedIndex lays the
 		// extended row out as [last kR1 elems | whole row | first kR0 elems]
@@ -1005,25 +1110,42 @@ namespace dnf_composer::tools::math
 			kR1_x = size_x - extIndex_x[0] + 1;
 			kR0_x = static_cast<int>(extIndex_x.size()) - size_x - kR1_x;
 		}
-		for (int y = 0; y < size_y; ++y)
-		{
-			if (circular_x)
-			{
-				const T* rowBase = fld + static_cast<std::size_t>(y) * size_x;
-				std::copy(rowBase + size_x - kR1_x, rowBase + size_x, extRow.begin());
-				std::copy(rowBase, rowBase + size_x, extRow.begin() + kR1_x);
-				std::copy(rowBase, rowBase + kR0_x, extRow.begin() + kR1_x + size_x);
-				conv_valid_into(convRow, extRow, kernel_x);
-			}
-			else
+		const auto xPass = [&](Conv2dScratch<T>& lane, int y0, int y1)
 			{
-				std::copy(fld + y * size_x, fld + y * size_x + size_x, row.begin());
-				conv_same_into(convRow, row, kernel_x);
-			}
-			for (int x = 0; x < size_x; ++x) {
-				tmp[y * size_x + x] = convRow[x];
+				std::vector<T>& row     = lane.row;
+				std::vector<T>& convRow = lane.convRow;
+				std::vector<T>& extRow  = lane.extRow;
+
+				// conv_valid_into derives its output length from extRow .size(), so it
+				// must match THIS call's extension length exactly — not the scratch's
+				// high-water capacity. (MexicanHat calls this twice with different kernel
+				// widths sharing one scratch; sizing to the max would make the narrower
+				// kernel emit > size_x outputs and overflow convRow.) resize() keeps the
+				// capacity ensure() reserved, so no reallocation occurs.
+				if (circular_x) {
+					extRow.resize(extIndex_x.size());
+				}
+
+				for (int y = y0; y < y1; ++y)
+				{
+					if (circular_x)
+					{
+						const T* rowBase = fld + static_cast<std::size_t>(y) * size_x;
+						std::copy(rowBase + size_x - kR1_x, rowBase + size_x, extRow.begin());
+						std::copy(rowBase, rowBase + size_x, extRow.begin() + kR1_x);
+						std::copy(rowBase, rowBase + kR0_x, extRow.begin() + kR1_x + size_x);
+						conv_valid_into(convRow, extRow, kernel_x);
+					}
+					else
+					{
+						std::copy(fld + y * size_x, fld + y * size_x + size_x, row.begin());
+						conv_same_into(convRow, row, kernel_x);
+					}
+					for (int x = 0; x < size_x; ++x) {
+						tmp[y * size_x + x] = convRow[x];
 }
-		}
+				}
+			};
 
 		// y-pass: per-column convolution with the SAME conv_valid_into /
 		// conv_same_into calls as before — the per-element arithmetic is
@@ -1038,13 +1160,6 @@ namespace dnf_composer::tools::math
 		// into a column-major tile (contiguous reads of tmp), the per-column
 		// convs run on contiguous L1/L2-resident columns, and one row-streamed
 		// scatter writes the results back (contiguous writes of out).
-		std::vector<T>& extCol  = scratch.extCol;
-		std::vector<T>& convCol = scratch.convCol;
-		std::vector<T>& tileIn  = scratch.tileIn;
-		std::vector<T>& tileOut = scratch.tileOut;
-		if (circular_y) {
-			extCol.resize(extIndex_y.size());
-		}
 
 		// Circular extension layout, as for the x-pass: [last kR1 | col | first kR0].
 		int kR0_y = 0;
@@ -1058,47 +1173,88 @@ namespace dnf_composer::tools::math
 		const T* __restrict tp = tmp.data();
 		T* __restrict op = out.data();
 		const int W = std::min(64, size_x);
-		for (int x0 = 0; x0 < size_x; x0 += W)
-		{
-			const int w = std::min(W, size_x - x0);
-
-			// gather: contiguous reads of tmp rows into the column-major tile
-			for (int y = 0; y < size_y; ++y)
+		const auto yPass = [&](Conv2dScratch<T>& lane, int tile0, int tile1)
 			{
-				const T* __restrict src = tp + static_cast<std::size_t>(y) * size_x + x0;
-				for (int c = 0; c < w; ++c) {
-					tileIn[static_cast<std::size_t>(c) * size_y + y] = src[c];
+				std::vector<T>& col     = lane.col;
+				std::vector<T>& extCol  = lane.extCol;
+				std::vector<T>& convCol = lane.convCol;
+				std::vector<T>& tileIn  = lane.tileIn;
+				std::vector<T>& tileOut = lane.tileOut;
+				if (circular_y) {
+					extCol.resize(extIndex_y.size());
 				}
-			}
 
-			for (int c = 0; c < w; ++c)
-			{
-				const T* colBase = tileIn.data() + static_cast<std::size_t>(c) * size_y;
-				if (circular_y)
-				{
-					std::copy(colBase + size_y - kR1_y, colBase + size_y, extCol.begin());
-					std::copy(colBase, colBase + size_y, extCol.begin() + kR1_y);
-					std::copy(colBase, colBase + kR0_y, extCol.begin() + kR1_y + size_y);
-					conv_valid_into(convCol, extCol, kernel_y);
-				}
-				else
+				for (int x0 = tile0 * W; x0 < size_x && x0 < tile1 * W; x0 += W)
 				{
-					std::copy(colBase, colBase + size_y, col.begin());
-					conv_same_into(convCol, col, kernel_y);
+					const int w = std::min(W, size_x - x0);
+
+					// gather: contiguous reads of tmp rows into the column-major tile
+					for (int y = 0; y < size_y; ++y)
+					{
+						const T* __restrict src = tp + static_cast<std::size_t>(y) * size_x + x0;
+						for (int c = 0; c < w; ++c) {
+							tileIn[static_cast<std::size_t>(c) * size_y + y] = src[c];
+						}
+					}
+
+					for (int c = 0; c < w; ++c)
+					{
+						const T* colBase = tileIn.data() + static_cast<std::size_t>(c) * size_y;
+						if (circular_y)
+						{
+							std::copy(colBase + size_y - kR1_y, colBase + size_y, extCol.begin());
+							std::copy(colBase, colBase + size_y, extCol.begin() + kR1_y);
+							std::copy(colBase, colBase + kR0_y, extCol.begin() + kR1_y + size_y);
+							conv_valid_into(convCol, extCol, kernel_y);
+						}
+						else
+						{
+							std::copy(colBase, colBase + size_y, col.begin());
+							conv_same_into(convCol, col, kernel_y);
+						}
+						std::copy(convCol.begin(), convCol.end(),
+						          tileOut.begin() + static_cast<std::size_t>(c) * size_y);
+					}
+
+					// scatter: contiguous writes of out rows from the tile
+					for (int y = 0; y < size_y; ++y)
+					{
+						T* __restrict dst = op + static_cast<std::size_t>(y) * size_x + x0;
+						for (int c = 0; c < w; ++c) {
+							dst[c] = tileOut[static_cast<std::size_t>(c) * size_y + y];
+						}
+					}
 				}
-				std::copy(convCol.begin(), convCol.end(),
-				          tileOut.begin() + static_cast<std::size_t>(c) * size_y);
-			}
+			};
 
-			// scatter: contiguous writes of out rows from the tile
-			for (int y = 0; y < size_y; ++y)
-			{
-				T* __restrict dst = op + static_cast<std::size_t>(y) * size_x + x0;
-				for (int c = 0; c < w; ++c) {
-					dst[c] = tileOut[static_cast<std::size_t>(c) * size_y + y];
-				}
-			}
+		const int tiles = W > 0 ? (size_x + W - 1) / W : 0;
+		int rowChunks = 1;
+		int tileChunks = 1;
+		if (static_cast<std::size_t>(size_x) * size_y >= kParallelConvMinCells)
+		{
+			const int threads = threading::currentParallelism();
+			rowChunks = std::clamp(size_y / kParallelConvMinRows, 1, threads);
+			tileChunks = std::clamp(tiles, 1, threads);
+		}
+		if (rowChunks == 1 && tileChunks == 1)
+		{
+			xPass(scratch, 0, size_y);
+			yPass(scratch, 0, tiles);
+			return;
 		}
+
+		scratch.ensureLanes(static_cast<std::size_t>(std::max(rowChunks, tileChunks)),
+			size_x, size_y, extIndex_x.size(), extIndex_y.size());
+		threading::parallelFor(static_cast<std::size_t>(rowChunks), [&](std::size_t chunk)
+			{
+				const int c = static_cast<int>(chunk);
+				xPass(scratch.lane(chunk), size_y * c / rowChunks, size_y * (c + 1) / rowChunks);
+			});
+		threading::parallelFor(static_cast<std::size_t>(tileChunks), [&](std::size_t chunk)
+			{
+				const int c = static_cast<int>(chunk);
+				yPass(scratch.lane(chunk), tiles * c / tileChunks, tiles * (c + 1) / tileChunks);
+			});
 	}
 
 	// In-place 2D separable convolution — owns its temporaries (allocates six
@@ -1121,6 +1277,61 @@ namespace dnf_composer::tools::math
 		                      size_x, size_y, extIndex_x, extIndex_y);
 	}
 
+	// The direct separable 2D convolution (conv2d_separable_into) carried out in
+	// float, for the 2D elements' direct path in Precision::Single (see
+	// tools/precision.h). setKernel() stores float copies of the taps and sizes
+	// every scratch buffer once. The elements keep their field and result in
+	// float and call the float apply(); the double one narrows the field,
+	// convolves, and widens the result into `out`.
+	class SeparableConvolver2DSingle
+	{
+	public:
+		void setKernel(std::span<const double> kernel_x, std::span<const double> kernel_y,
+		               int size_x, int size_y,
+		               const std::vector<int>& extIndex_x, const std::vector<int>& extIndex_y)
+		{
+			kernel_x_.assign(kernel_x.begin(), kernel_x.end());
+			kernel_y_.assign(kernel_y.begin(), kernel_y.end());
+			size_x_ = size_x;
+			size_y_ = size_y;
+			extIndex_x_ = extIndex_x;
+			extIndex_y_ = extIndex_y;
+
+			const std::size_t total = static_cast<std::size_t>(size_x) * size_y;
+			field_.assign(total, 0.0f);
+			tmp_.assign(total, 0.0f);
+			result_.assign(total, 0.0f);
+			scratch_.ensure(size_x, size_y, extIndex_x.size(), extIndex_y.size());
+		}
+
+		// field and out are size_x*size_y; they may alias.
+		void apply(std::span<const double> field, std::span<double> out)
+		{
+			std::ranges::transform(field, field_.begin(), [](double v) { return static_cast<float>(v); });
+			apply(field_, result_);
+			std::ranges::copy(result_, out.begin());
+		}
+
+		// field and out are size_x*size_y; they may not alias.
+		void apply(std::span<const float> field, std::span<float> out)
+		{
+			conv2d_separable_into<float>(out, tmp_, scratch_, field, kernel_x_, kernel_y_,
+				size_x_, size_y_, extIndex_x_, extIndex_y_);
+		}
+
+	private:
+		std::vector<float> kernel_x_;
+		std::vector<float> kernel_y_;
+		std::vector<int> extIndex_x_;
+		std::vector<int> extIndex_y_;
+		int size_x_ = 0;
+		int size_y_ = 0;
+		std::vector<float> field_;
+		std::vector<float> tmp_;
+		std::vector<float> result_;
+		Conv2dScratch<float> scratch_;
+	};
+
 	// Reduction operation used when collapsing one axis of a 2D buffer.
 	enum class ReduceOp { SUM, AVERAGE, MAXIMUM, MINIMUM };
 
@@ -1128,10 +1339,11 @@ namespace dnf_composer::tools::math
 	// result, writing into a pre-sized output buffer.
 	// keepX == true:  output has size_x entries; each out[x] reduces over all y.
 	// keepX == false: output has size_y entries; each out[y] reduces over all x.
-	template<typename T>
-	void reduce2DAxis_into(std::vector<T>& out, const std::vector<T>& field,
+	template<typename Buffer>
+	void reduce2DAxis_into(Buffer& out, std::span<const typename Buffer::value_type> field,
 		int size_x, int size_y, bool keepX, ReduceOp op)
 	{
+		using T = typename Buffer::value_type;
 		// Reject non-positive dimensions or a field smaller than size_x*size_y
 		// (malformed dimensions / JSON) before sizing or indexing: produce an
 		// empty result rather than over-allocating or reading out of bounds.
@@ -1178,10 +1390,11 @@ namespace dnf_composer::tools::math
 	// into a pre-sized output buffer.
 	// alongX == true:  profile indexes x (size must be size_x); repeated for every y.
 	// alongX == false: profile indexes y (size must be size_y); repeated for every x.
-	template<typename T>
-	void broadcast1DTo2D_into(std::vector<T>& out, const std::vector<T>& profile,
+	template<typename Buffer>
+	void broadcast1DTo2D_into(Buffer& out, std::span<const typename Buffer::value_type> profile,
 		int size_x, int size_y, bool alongX)
 	{
+		using T = typename Buffer::value_type;
 		// Reject non-positive dimensions (malformed dimensions / JSON) before sizing:
 		// a negative size would wrap to an enormous allocation.
 		if (size_x <= 0 || size_y <= 0) { out.clear(); return; }
@@ -0,0 +1,45 @@
+#pragma once
+
+// Arithmetic precision of the 2D convolution hot path. In Single mode the 2D
+// kernels and the 2D correlated noise convolve in float, which doubles the SIMD
+// width and halves the memory traffic of the one pass that dominates a 2D step:
+//  - their taps, separable scratch rows, FFT buffers (fftwf) and convolution
+//    results are stored in float, and their double result buffers are not
+//    allocated;
+//  - NeuralField2D keeps a float copy of its "output", written in the same
+//    sweep as the double one, and a kernel whose only input is that output
+//    convolves the copy (Kernel::singleInput()); any other input is narrowed
+//    once per step.
+// The published components stay double -- they are what the recorder, the GUI,
+// the JSON files and every coupling read -- and the field integrates in double.
+// The output pass that adds a kernel's global offset widens its result.
+//
+// Process-global, like the ConvolutionMode override in tools/fft_convolution.h,
+// and read by each element in its init(): a change takes effect the next time
+// an element (re)initializes, typically at the next Simulation::init(). The
+// startup value is Double, or Single in a build configured with
+// -DDNF_COMPOSER_SINGLE_PRECISION=ON. Single mode is not bit-compatible with
+// the double-precision golden references; tests/validation's single-precision
+// report lists how far each 2D validation deck moves.
+namespace dnf_composer::tools::math
+{
+	enum class Precision { Double, Single };
+
+	void setPrecision(Precision precision);
+	Precision precision();
+
+	// RAII scoped precision: restores the previous one on destruction. Not
+	// copyable/movable.
+	class ScopedPrecision
+	{
+	public:
+		explicit ScopedPrecision(Precision precision);
+		~ScopedPrecision();
+		ScopedPrecision(const ScopedPrecision&) = delete;
+		ScopedPrecision& operator=(const ScopedPrecision&) = delete;
+		ScopedPrecision(ScopedPrecision&&) = delete;
+		ScopedPrecision& operator=(ScopedPrecision&&) = delete;
+	private:
+		Precision previous_;
+	};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Frame codecs for binary recordings (recording_file.h). A relaxed field
+// changes little from one sample to the next, so each frame is coded against
+// the previous one:
+//
+//   XorDelta   lossless. Each value's bits are XORed with the previous frame's;
+//              unchanged values give 0, slowly changing ones give residuals
+//              whose high bytes (sign, exponent, top of the mantissa) are 0.
+//   Quantized  lossy, every value within `tolerance` of the original. Values
+//              are rounded to multiples of 2 * tolerance, and the integer
+//              difference from the previous frame is zigzag-coded, so small
+//              changes give small residuals.
+//
+// The 64-bit residuals are then split into byte planes (byte p of every
+// residual, then byte p + 1, ...), which gathers the zero bytes into long
+// runs, and the planes are run-length coded: a LEB128 token
+// (length << 1 | isZeroRun) followed, for a literal run, by its bytes.
+//
+// Every `keyframeInterval`-th frame is coded against an all-zero frame, so a
+// reader can start decoding there instead of at the first frame.
+namespace dnf_composer::tools::recording_file
+{
+	enum class RecordingCodec : std::uint8_t { None = 0, XorDelta = 1, Quantized = 2 };
+
+	struct CodecOptions
+	{
+		RecordingCodec codec = RecordingCodec::None;
+		double tolerance = 0.0;              // Quantized: largest absolute error; must be > 0.
+		std::uint32_t keyframeInterval = 256; // Frames from one keyframe to the next (at least 1).
+
+		bool operator==(const CodecOptions&) const = default;
+	};
+
+	// Throws std::invalid_argument if `options` cannot be used to code frames.
+	void validate(const CodecOptions& options);
+
+	// Codes the frames of one recording, in order. Throws std::invalid_argument
+	// for invalid options or RecordingCodec::None (FrameDecoder likewise).
+	class FrameEncoder
+	{
+	public:
+		FrameEncoder(const CodecOptions& options, std::size_t frameValues);
+
+		// Code `values` (frameValues of them) into `payload`, replacing its
+		// contents. Returns true if the frame is a keyframe.
+		bool encode(std::span<const double> values, std::vector<std::byte>& payload);
+
+		// Make the next frame a keyframe.
+		void reset() { framesSinceKeyframe_ = options_.keyframeInterval; }
+
+	private:
+		CodecOptions options_;
+		std::vector<std::uint64_t> previous_; // Bits (XorDelta) or quantized values (Quantized).
+		std::vector<std::uint64_t> residuals_;
+		std::vector<std::uint8_t> planes_;
+		std::uint32_t framesSinceKeyframe_;
+	};
+
+	// Decodes the frames of one recording, in order, starting at a keyframe.
+	class FrameDecoder
+	{
+	public:
+		FrameDecoder(const CodecOptions& options, std::size_t frameValues);
+
+		// Decode `payload` into `values` (frameValues of them). A frame that is
+		// not a keyframe must follow the frame decoded last. Throws
+		// std::runtime_error if the payload is corrupt.
+		void decode(std::span<const std::byte> payload, bool keyframe, std::span<double> values);
+
+	private:
+		CodecOptions options_;
+		std::vector<std::uint64_t> previous_;
+		std::vector<std::uint8_t> planes_;
+	};
+}
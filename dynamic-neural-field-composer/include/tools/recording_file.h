@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tools/mapped_file.h"
+#include "tools/recording_codec.h"
+
+// SimulationRecorder's file formats: CSV (<id>_<component>_<ts>.csv), one text
+// row per sample, and binary recordings (<id>_<component>_<ts>.dnfr), a header
+// followed by fixed-size raw frames in the host's (little-endian) byte order.
+// Because every frame has the same size, a recording is appended to by writing
+// frames at its end (there is no frame count to update), and a reader maps it
+// and addresses frame k at headerSize + k * frameSize.
+//
+// Binary header, all fields little-endian:
+//   0  char[4]   magic "DNFR"
+//   4  uint16    version
+//   6  uint8     dtype (RecordingDtype)
+//   7  uint8     sample interval unit (SampleUnit)
+//   8  uint32    header size in bytes: 64 + both names, padded to a multiple of 64
+//  12  int32     sample interval
+//  16  uint32    size_x
+//  20  uint32    size_y (1 for 1D elements)
+//  24  uint64    values per frame (the component size)
+//  32  uint64    frame size in bytes (16 + 8 * values per frame); 0 for coded frames
+//  40  uint16    element id length in bytes
+//  42  uint16    component name length in bytes
+//  44  uint8     codec (RecordingCodec, recording_codec.h); 0 (None) in version 1
+//  45  uint8     flags (bit 0: a region block follows the names)
+//  46  uint8[2]  reserved, 0
+//  48  float64   Quantized: tolerance; otherwise 0
+//  56  uint32    coded: keyframe interval; otherwise 0
+//  60  uint32    reserved, 0
+//  64  char[]    element id, then component name, not NUL-terminated
+//      uint32[4] if flagged: origin_x, origin_y, stride_x, stride_y (SampledRegion)
+//      zero padding
+//
+// Frame: int64 ticks, float64 simulation time (ms), then the component values,
+// 2D components in row-major order (index i is x = i % size_x, y = i / size_x).
+// A recording of part of a component (a region) describes the sampled grid:
+// size_x and size_y count the sampled columns and rows, and the region block
+// maps them back to the element's.
+//
+// Version 2 files are coded (codec != None): their frames vary in size, so a
+// reader indexes them by walking the file once. A coded frame is int64 ticks,
+// float64 ms, uint32 payload size, uint8 flags (bit 0: keyframe), uint8[3]
+// reserved, then the payload. Uncoded recordings are still written as
+// version 1.
+//
+// A trailing partial frame -- a write cut short by a crash -- is not a frame:
+// readers ignore it and prepareAppend() truncates it.
+namespace dnf_composer::tools::recording_file
+{
+	inline constexpr std::uint16_t kVersion = 1;      // Raw frames.
+	inline constexpr std::uint16_t kCodedVersion = 2; // Coded frames.
+	inline constexpr std::size_t kFixedHeaderSize = 64;
+	inline constexpr std::size_t kFramePrefixSize = 16;
+	inline constexpr std::size_t kCodedFramePrefixSize = 24;
+
+	enum class RecordingDtype : std::uint8_t { Float64 = 0 };
+	enum class SampleUnit : std::uint8_t { Ticks = 0, Milliseconds = 1 };
+
+	struct RecordingFileHeader
+	{
+		char magic[4];
+		std::uint16_t version;
+		RecordingDtype dtype;
+		SampleUnit unit;
+		std::uint32_t headerSize;
+		std::int32_t sampleInterval;
+		std::uint32_t sizeX;
+		std::uint32_t sizeY;
+		std::uint64_t frameValues;
+		std::uint64_t frameSize;
+		std::uint16_t elementIdLength;
+		std::uint16_t componentNameLength;
+		RecordingCodec codec;
+		std::uint8_t flags;
+		std::uint8_t reserved0[2];
+		double tolerance;
+		std::uint32_t keyframeInterval;
+		std::uint32_t reserved1;
+	};
+	static_assert(sizeof(RecordingFileHeader) == kFixedHeaderSize);
+
+	// Where the recorded values sit in the element: value i of a frame is at
+	// x = originX + strideX * (i % sizeX), y = originY + strideY * (i / sizeX).
+	// The default is the whole component.
+	struct SampledRegion
+	{
+		int originX = 0;
+		int originY = 0;
+		int strideX = 1;
+		int strideY = 1;
+
+		bool operator==(const SampledRegion&) const = default;
+	};
+
+	// What a recording holds; written into the binary header.
+	struct RecordingInfo
+	{
+		std::string elementId;
+		std::string componentName;
+		std::size_t frameValues = 0;
+		int sizeX = 1;
+		int sizeY = 1;
+		int sampleInterval = 1;
+		SampleUnit unit = SampleUnit::Ticks;
+		CodecOptions codec; ///< RecordingCodec::None stores raw frames.
+		SampledRegion region;
+
+		bool operator==(const RecordingInfo&) const = default;
+	};
+
+	// Bytes of one binary frame of `frameValues` values.
+	constexpr std::size_t frameSize(std::size_t frameValues)
+	{
+		return kFramePrefixSize + frameValues * sizeof(double);
+	}
+
+	// Write the binary header. Throws std::invalid_argument if a name is longer
+	// than 65535 bytes or the codec options are invalid.
+	void writeHeader(std::ostream& out, const RecordingInfo& info);
+
+	// Append one binary frame; `values` must hold info.frameValues values (the
+	// caller checks, this is the per-sample path).
+	void writeFrame(std::ostream& out, long long ticks, double ms, std::span<const double> values);
+
+	// Append one coded frame: `payload` from FrameEncoder::encode().
+	void writeCodedFrame(std::ostream& out, long long ticks, double ms, bool keyframe, std::span<const std::byte> payload);
+
+	// Get `path` ready to be appended to with frames of `info`: a missing or
+	// empty file is left for the caller to write the header, an existing one
+	// must describe the same recording (std::runtime_error otherwise) and is
+	// truncated to whole frames. Returns the number of frames already in it.
+	// The first frame appended to a coded recording must be a keyframe (a new
+	// FrameEncoder starts with one).
+	std::size_t prepareAppend(const std::string& path, const RecordingInfo& info);
+
+	// CSV: a `# size_x=W,size_y=H` line for 2D components, a
+	// `# origin_x=X,origin_y=Y,stride_x=SX,stride_y=SY` line for a region, then
+	// `ticks,ms,0,1,...,N-1`; rows hold the time and values in fixed notation
+	// with 6 decimals.
+	void writeCsvHeader(std::ostream& out, std::size_t componentSize, int sizeX = 1, int sizeY = 1,
+		const SampledRegion& region = {});
+	void writeCsvRow(std::ostream& out, long long ticks, double ms, std::span<const double> values);
+
+	// A read-only mapping of a binary recording. The constructor maps the file
+	// and validates the header (std::runtime_error if it cannot be opened or is
+	// not a valid recording). Frames appended after construction are not seen;
+	// map the file again to pick them up.
+	//
+	// readFrame() and column() decode coded recordings, keeping the last decoded
+	// frame so that reading frames in order decodes each once; they are not
+	// safe to call from several threads at a time. frame() reads raw
+	// recordings in place.
+	class MappedRecording
+	{
+	public:
+		explicit MappedRecording(const std::string& path);
+
+		const RecordingFileHeader& header() const { return *reinterpret_cast<const RecordingFileHeader*>(file_.data()); }
+		const RecordingInfo& info() const { return info_; }
+		bool coded() const { return info_.codec.codec != RecordingCodec::None; }
+
+		std::size_t frameCount() const { return frameCount_; }
+		std::size_t frameValues() const { return info_.frameValues; }
+		// Bytes after the last whole frame (a torn write); 0 for a clean file.
+		std::size_t trailingBytes() const;
+
+		long long ticks(std::size_t frame) const;
+		double ms(std::size_t frame) const;
+		// The values of `frame` of a raw recording, in place. Throws
+		// std::logic_error for a coded recording.
+		std::span<const double> frame(std::size_t frame) const;
+		// The values of `frame`: in place for a raw recording, decoded into a
+		// buffer that the next call reuses for a coded one.
+		std::span<const double> readFrame(std::size_t frame) const;
+		// One value across all frames: the time series at component index `index`.
+		// Throws std::out_of_range for an index past the frame.
+		std::vector<double> column(std::size_t index) const;
+
+	private:
+		const std::byte* frameData(std::size_t frame) const
+		{
+			return file_.data() + (coded() ? offsets_[frame] : header().headerSize + frame * header().frameSize);
+		}
+		void checkFrame(std::size_t frame) const;
+
+		MappedFile file_;
+		RecordingInfo info_;
+		std::size_t frameCount_ = 0;
+		std::size_t end_ = 0;               // Byte after the last whole frame.
+		std::vector<std::size_t> offsets_;  // Coded: where each frame starts.
+		mutable std::unique_ptr<FrameDecoder> decoder_;
+		mutable std::vector<double> decoded_;
+		mutable std::size_t decodedFrame_ = 0; // Frame in decoded_; frameCount_ when none.
+	};
+}
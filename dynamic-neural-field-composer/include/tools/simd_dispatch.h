@@ -2,20 +2,71 @@
 
 #include <cstddef>
 
-// Runtime CPU-feature dispatch for the AVX2+FMA convolution kernel — mirrors how
-// OpenCV/FFTW select their SIMD code path at runtime rather than at compile time,
-// so a single dnf-composer binary runs correctly on any x86-64 CPU instead of
-// requiring AVX2 to be present at all (see TRADE_OFF_CAVEATS.md in the benchmark
-// repo for why this matters).
+// Runtime CPU-feature dispatch for the hand-vectorized per-cell kernels — mirrors
+// how OpenCV/FFTW select their SIMD code path at runtime rather than at compile
+// time, so a single dnf-composer binary runs correctly on any x86-64 CPU instead
+// of requiring AVX2 to be present at all (see TRADE_OFF_CAVEATS.md in the
+// benchmark repo for why this matters).
 //
-// conv_valid_into_avx2_f64 is defined in simd_dispatch_avx2.cpp, the ONLY
-// translation unit in this library compiled with AVX2+FMA enabled; every other
-// file (including this header's caller, tools/math.h) is compiled at the
-// toolchain's default baseline. Calling this function is only safe after
-// avx2_fma_available() has returned true — the function boundary itself is
-// ABI-safe to declare/call from baseline code (it passes only pointers and
-// ints, no vector registers), but executing its body on a CPU without AVX2+FMA
-// would fault.
+// Every kernel exists once per SimdTier. The scalar forms live in
+// simd_dispatch.cpp, compiled at the toolchain's default baseline like every
+// other file; the vector forms live in the only translation units built with
+// wider instruction sets (see CMakeLists.txt):
+//   simd_dispatch_avx2.cpp          convolution + sigmoid, AVX2+FMA
+//   simd_elementwise_avx2.cpp       the element-wise kernels, AVX2 without FMA
+//   simd_dispatch_avx512.cpp        convolution + sigmoid, AVX-512F
+//   simd_elementwise_avx512.cpp     the element-wise kernels, AVX-512F, no contraction
+// Calling a vector form is only safe once detectedSimdTier() has confirmed the
+// host supports it — the function boundaries pass only pointers and scalars,
+// so they are ABI-safe to declare/call from baseline code, but executing their
+// bodies on an older CPU would fault. Callers go through detail::simdKernels(),
+// which holds the table for the active tier and never exceeds the detected one.
+//
+// The element-wise kernels (Heaviside, AbsSigmoid, the Euler update, the
+// memory trace, input accumulation and the coupling GEMV's row update) are
+// bit-identical across tiers: each lane performs exactly the scalar loop's
+// operations, and their translation units are built so the compiler cannot
+// fuse a multiply and an add into an FMA. The convolutions are bit-identical between AVX2 and AVX-512 (same
+// per-output operation sequence, and every tail shorter than a 512-bit vector
+// goes through the AVX2 form) but, as before, not to the scalar tier, which
+// does not fold symmetric taps. The sigmoid's exp is the same algorithm at
+// every vector width; it agrees with the AVX2 sigmoid to the last bit whenever
+// both translation units get the same floating-point contraction rules.
+
+namespace dnf_composer::tools::math
+{
+	// Widest instruction set the kernels use. Ordered: a tier implies the ones
+	// before it.
+	enum class SimdTier { Scalar, Avx2, Avx512 };
+
+	const char* toString(SimdTier tier);
+
+	// Widest tier the host CPU and OS support, found once via cpuid. Avx512
+	// means AVX-512F (with OS ZMM state) on top of AVX2+FMA.
+	SimdTier detectedSimdTier();
+
+	// Tier the kernels currently run at. Starts at detectedSimdTier();
+	// setSimdTier() lowers it (a request above the detected tier is capped to
+	// it), e.g. to A/B the tiers or to reproduce a result from an older CPU.
+	// Process-global and takes effect on the next kernel call.
+	void setSimdTier(SimdTier tier);
+	SimdTier simdTier();
+
+	// RAII scoped tier: restores the previous one on destruction. Not
+	// copyable/movable.
+	class ScopedSimdTier
+	{
+	public:
+		explicit ScopedSimdTier(SimdTier tier);
+		~ScopedSimdTier();
+		ScopedSimdTier(const ScopedSimdTier&) = delete;
+		ScopedSimdTier& operator=(const ScopedSimdTier&) = delete;
+		ScopedSimdTier(ScopedSimdTier&&) = delete;
+		ScopedSimdTier& operator=(ScopedSimdTier&&) = delete;
+	private:
+		SimdTier previous_;
+	};
+}
 
 namespace dnf_composer::tools::math::detail
 {
@@ -23,6 +74,66 @@ namespace dnf_composer::tools::math::detail
 	// Safe to call from a baseline-compiled translation unit.
 	bool avx2_fma_available();
 
+	// Detects AVX-512F + OS ZMM-state support once and caches the result.
+	bool avx512f_available();
+
+	// One tier's kernels. Every entry is set in every table.
+	struct SimdKernels
+	{
+		SimdTier tier;
+
+		// out[i] = sum_{m=0..M-1} kr[m] * mx[i+m], for i in [0, n). `o` must have
+		// at least n elements; `kr` has M elements; `mx` must be readable up to
+		// index n + M - 2. The vector tiers fold mirror taps when kr is a
+		// palindrome.
+		void (*conv_valid_f64)(const double* kr, int M, const double* mx, double* o, int n);
+		void (*conv_valid_f32)(const float* kr, int M, const float* mx, float* o, int n);
+
+		// out[i] = 1 / (1 + exp(clamp(-s * (in[i] - xs), -88, 88)))
+		void (*sigmoid_f64)(const double* in, double* out, std::size_t n, double s, double xs);
+		// out[i] = in[i] > xs ? 1 : 0
+		void (*heaviside_f64)(const double* in, double* out, std::size_t n, double xs);
+		// out[i] = 0.5 * (1 + beta*d / (1 + beta*|d|)), d = in[i] - xs
+		void (*abs_sigmoid_f64)(const double* in, double* out, std::size_t n, double beta, double xs);
+
+		// act[i] += dtOverTau * (-act[i] + rest + inp[i])
+		void (*euler_f64)(double* act, const double* inp, std::size_t n, double dtOverTau, double rest);
+
+		// out[i] += buildRate * (-out[i] + in[i]) where in[i] > threshold,
+		// out[i] += decayRate * (-out[i]) elsewhere. The rates are deltaT / tau.
+		void (*memory_trace_f64)(const double* in, double* out, std::size_t n,
+		                         double threshold, double buildRate, double decayRate);
+
+		// dst[i] += src[i]
+		void (*accumulate_f64)(double* dst, const double* src, std::size_t n);
+
+		// y[i] += (scale * w[i]) * x, one input row of gemv_into() (tools/math.h)
+		void (*scaled_axpy_f64)(double* y, const double* w, std::size_t n, double scale, double x);
+	};
+
+	// The active tier's table (see setSimdTier()). Cheap enough to call per
+	// kernel invocation.
+	const SimdKernels& simdKernels();
+
+	// A given tier's table, for tests and benchmarks. @p tier must not exceed
+	// detectedSimdTier().
+	const SimdKernels& simdKernelsFor(SimdTier tier);
+
+	// ── Scalar tier (simd_dispatch.cpp) ─────────────────────────────────────────
+	// The loops the callers used to run inline, unchanged.
+	void conv_valid_into_scalar_f64(const double* kr, int M, const double* mx, double* o, int n);
+	void conv_valid_into_scalar_f32(const float* kr, int M, const float* mx, float* o, int n);
+	void sigmoid_scalar_f64(const double* in, double* out, std::size_t n, double s, double xs);
+	void heaviside_scalar_f64(const double* in, double* out, std::size_t n, double xs);
+	void abs_sigmoid_scalar_f64(const double* in, double* out, std::size_t n, double beta, double xs);
+	void euler_scalar_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest);
+	void memory_trace_scalar_f64(const double* in, double* out, std::size_t n,
+	                             double threshold, double buildRate, double decayRate);
+	void accumulate_scalar_f64(double* dst, const double* src, std::size_t n);
+	void scaled_axpy_scalar_f64(double* y, const double* w, std::size_t n, double scale, double x);
+
+	// ── AVX2 tier (simd_dispatch_avx2.cpp, simd_elementwise_avx2.cpp) ───────────
+
 	// Bit-identical to the AVX2 branch previously inlined in conv_valid_into<double>:
 	// out[i] = sum_{m=0..M-1} kr[m] * mx[i+m], for i in [0, n), with the symmetric-
 	// kernel folding optimization applied when kr is a palindrome. `o` must have at
@@ -30,6 +141,22 @@ namespace dnf_composer::tools::math::detail
 	// n + M - 2.
 	void conv_valid_into_avx2_f64(const double* kr, int M, const double* mx, double* o, int n);
 
+	// Single-precision form of the same kernel, for conv_valid_into<float>
+	// (the 2D direct path in Precision::Single, tools/precision.h): 8 lanes per
+	// vector, same folding and operation order, so it differs from the double
+	// kernel only by float rounding. Same preconditions.
+	void conv_valid_into_avx2_f32(const float* kr, int M, const float* mx, float* o, int n);
+
+	// Batched (interleaved) form of the same sum, for EnsembleSimulation: K
+	// independent convolutions stored lane-interleaved, value i of batch k at
+	// i*K+k. o[i*K+k] = sum_{m=0..M-1} taps[m*K+k] * ext[(i+m)*K+k], for i in
+	// [0, n) and k in [0, K). Vectorized across k; each lane performs the same
+	// operation sequence as conv_valid_into_avx2_f64 on that batch member,
+	// folding mirror taps when `symmetric` (the caller checks every member's
+	// taps are palindromes). `o` has n*K elements, `taps` M*K, `ext` (n+M-1)*K.
+	void conv_valid_batched_avx2_f64(const double* taps, int M, bool symmetric,
+	                                 const double* ext, double* o, int n, int K);
+
 	// Vectorized double-precision logistic sigmoid:
 	//   out[i] = 1 / (1 + exp(clamp(-s * (in[i] - xs), -88, 88)))
 	// Same denormal-avoidance clamp as the scalar SigmoidFunction::apply (see
@@ -40,4 +167,27 @@ namespace dnf_composer::tools::math::detail
 	// may alias (element-wise, read-before-write per lane). Safe to call only
 	// after avx2_fma_available() has returned true.
 	void sigmoid_avx2_f64(const double* in, double* out, std::size_t n, double s, double xs);
+
+	void heaviside_avx2_f64(const double* in, double* out, std::size_t n, double xs);
+	void abs_sigmoid_avx2_f64(const double* in, double* out, std::size_t n, double beta, double xs);
+	void euler_avx2_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest);
+	void memory_trace_avx2_f64(const double* in, double* out, std::size_t n,
+	                           double threshold, double buildRate, double decayRate);
+	void accumulate_avx2_f64(double* dst, const double* src, std::size_t n);
+	void scaled_axpy_avx2_f64(double* y, const double* w, std::size_t n, double scale, double x);
+
+	// ── AVX-512 tier (simd_dispatch_avx512.cpp, simd_elementwise_avx512.cpp) ────
+	// The AVX2 kernels at 8 (double) / 16 (float) lanes. The element-wise ones
+	// handle their tail with a masked vector; the convolutions and the sigmoid
+	// hand any tail shorter than a vector to their AVX2 form.
+	void conv_valid_into_avx512_f64(const double* kr, int M, const double* mx, double* o, int n);
+	void conv_valid_into_avx512_f32(const float* kr, int M, const float* mx, float* o, int n);
+	void sigmoid_avx512_f64(const double* in, double* out, std::size_t n, double s, double xs);
+	void heaviside_avx512_f64(const double* in, double* out, std::size_t n, double xs);
+	void abs_sigmoid_avx512_f64(const double* in, double* out, std::size_t n, double beta, double xs);
+	void euler_avx512_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest);
+	void memory_trace_avx512_f64(const double* in, double* out, std::size_t n,
+	                             double threshold, double buildRate, double decayRate);
+	void accumulate_avx512_f64(double* dst, const double* src, std::size_t n);
+	void scaled_axpy_avx512_f64(double* y, const double* w, std::size_t n, double scale, double x);
 }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Compressed sparse row (CSR) storage for a coupling's weight matrix, for
+// FieldCoupling's WeightStorage::SPARSE mode. After training most weights are
+// close to zero; pruning them by magnitude leaves a matrix that costs memory
+// and step time in proportion to what is left.
+//
+// The matrix has the layout of the dense weights the learning rules in
+// tools/math.h update: rows are inputs, columns are outputs, the dense entry
+// (i, j) at i * cols + j. A row's retained columns are stored in ascending
+// order, so the forward pass and the learning rules below visit entries in the
+// same order as their dense forms and, entry for entry, do the same
+// arithmetic. With a prune threshold of 0 (drop exact zeros only) the forward
+// pass is bit-identical to gemv_into() on the dense matrix.
+namespace dnf_composer::tools::math
+{
+	struct CsrMatrix
+	{
+		std::size_t rows = 0;
+		std::size_t cols = 0;
+		std::vector<std::size_t> rowStart;   // rows + 1 entries; row i is [rowStart[i], rowStart[i + 1])
+		std::vector<std::uint32_t> columns;  // column of each retained entry
+		std::vector<double> values;          // value of each retained entry
+
+		std::size_t nonZeros() const { return values.size(); }
+		// Bytes the three arrays occupy, for comparing against rows * cols doubles.
+		std::size_t bytes() const;
+	};
+
+	// The entries of a (rows x cols) dense matrix with |w| > threshold. A
+	// threshold of 0 keeps every non-zero entry (NaNs are kept too).
+	// Throws std::invalid_argument if dense.size() != rows * cols.
+	CsrMatrix csr_from_dense(std::span<const double> dense, std::size_t rows, std::size_t cols, double threshold);
+
+	// Drops the stored entries with |w| <= threshold, in place.
+	void csr_prune(CsrMatrix& matrix, double threshold);
+
+	// Writes the matrix back out densely, zeros where nothing is stored.
+	// Throws std::invalid_argument if dense.size() != rows * cols.
+	void csr_to_dense(const CsrMatrix& matrix, std::span<double> dense);
+
+	// The CSR form of gemv_into(): out[j] = sum_i (scale * w(i, j)) * in[i] over
+	// the stored entries, skipping inputs that are exactly zero. out.size() must
+	// be cols and in.size() rows (std::invalid_argument otherwise).
+	void spmv_into(std::span<double> out, const CsrMatrix& weights, std::span<const double> in, double scale);
+
+	// The learning rules of tools/math.h restricted to the stored entries: each
+	// stored weight changes exactly as its dense counterpart would, and pruned
+	// entries stay pruned. Same preconditions and exceptions as the dense rules.
+	void hebbLearningRule(CsrMatrix& weights, std::span<const double> input,
+		std::span<const double> output, double learningRate);
+	void ojaLearningRule(CsrMatrix& weights, std::span<const double> input,
+		std::span<const double> output, double learningRate);
+	void deltaLearningRuleWidrowHoff(CsrMatrix& weights, std::span<const double> pre,
+		std::span<const double> target, std::span<const double> actual,
+		double learningRate, double decayRate = 0.0);
+}
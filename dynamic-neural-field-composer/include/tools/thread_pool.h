@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dnf_composer::tools::threading
+{
+	/// @brief One unit of work for a ThreadPool.
+	///
+	/// A plain function pointer + opaque context + index rather than a
+	/// std::function: the scheduler submits one of these per element per
+	/// step, and a std::function capturing anything non-trivial would heap
+	/// allocate on every submission. The index lets one static trampoline
+	/// serve every node of a graph (or every chunk of a parallel loop).
+	struct Task
+	{
+		void (*run)(void* context, std::size_t index) = nullptr;
+		void* context = nullptr;
+		std::size_t index = 0;
+	};
+
+	/// @brief Fixed-size work-stealing thread pool.
+	///
+	/// The pool is sized by the *total* number of threads that execute work,
+	/// including the thread that drives it: a pool of N spawns N-1 workers and
+	/// the driving thread joins in from runUntil() as slot 0. A pool of 1 spawns
+	/// nothing and runs every task inline on the driving thread, so callers can
+	/// use the same code path for the serial case.
+	///
+	/// Each slot owns a deque. Tasks submitted from inside a task go to the
+	/// submitting slot's own deque and are popped LIFO by their owner (the
+	/// successor that was just made ready is usually the one whose inputs are
+	/// still hot in that core's cache); idle slots steal FIFO from the other
+	/// end of someone else's deque. The deques are mutex-guarded rather than
+	/// lock-free Chase-Lev deques -- tasks here are whole element steps
+	/// (microseconds to milliseconds each), so a short uncontended lock per
+	/// push/pop is noise, and the mutex keeps the memory-ordering argument
+	/// trivially correct.
+	///
+	/// Tasks submitted with submitPinned() are only ever executed by the thread
+	/// currently inside runUntil() at the outermost level. The scheduler uses
+	/// this for elements whose result depends on thread-local state (the
+	/// thread_local normal-noise engine, see tools::math::fillNormal), so a
+	/// parallel run draws exactly the same random sequence as the serial one.
+	///
+	/// Not copyable or movable: workers hold a pointer back to the pool.
+	class ThreadPool
+	{
+	public:
+		/// @param threadCount  Total threads executing work, including the
+		///                     driving thread. Values below 1 are clamped to 1.
+		explicit ThreadPool(int threadCount);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+
+		/// @brief Total threads executing work (workers + the driving thread).
+		int getThreadCount() const { return static_cast<int>(slots.size()); }
+
+		/// @brief Tasks this pool has run so far, pinned ones included. Work a
+		///        parallelFor() keeps on the calling thread (its index 0, or
+		///        every index without a pool) is not a task and is not counted.
+		std::size_t getExecutedTaskCount() const { return executed.load(std::memory_order_relaxed); }
+
+		/// @brief Queue @p task on the calling thread's own deque (slot 0 if
+		///        the caller is not one of this pool's threads).
+		void submit(const Task& task);
+
+		/// @brief Queue @p task so that only the outermost runUntil() caller
+		///        executes it.
+		void submitPinned(const Task& task);
+
+		/// @brief Execute queued tasks on the calling thread until @p pending
+		///        reads zero. The caller is responsible for decrementing
+		///        @p pending as its tasks complete. Safe to call from inside a
+		///        task (the calling worker keeps its own slot and helps drain
+		///        the queues instead of blocking).
+		void runUntil(const std::atomic<std::size_t>& pending);
+
+		/// @brief The pool the calling thread is working for: its own pool on a
+		///        worker, the pool whose runUntil() it is inside or that a
+		///        ScopedCurrentPool installed otherwise; null when none.
+		///
+		/// parallelFor() spreads its chunks over this pool, so work an element
+		/// splits up inside its step() runs on the threads of the simulation
+		/// stepping it and never on threads of its own.
+		static ThreadPool* current();
+
+	private:
+		struct Slot
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		bool tryRunOne(std::size_t self);
+		bool tryRunPinned();
+		void workerLoop(std::size_t self);
+
+		std::vector<std::unique_ptr<Slot>> slots;     ///< [0] belongs to the driving thread.
+		Slot pinned;
+		std::vector<std::thread> workers;
+
+		/// Tasks sitting in `slots` (not `pinned`); workers sleep while it is 0.
+		std::atomic<std::size_t> queued{ 0 };
+		std::atomic<std::size_t> executed{ 0 };
+		std::atomic<int> sleepers{ 0 };
+		std::atomic<bool> stopping{ false };
+		std::mutex sleepMutex;
+		std::condition_variable wake;
+	};
+
+	/// @brief Makes @p pool the calling thread's current pool (see
+	///        ThreadPool::current()) for the lifetime of the scope, as if it
+	///        were the pool's driving thread; null makes parallelFor() run
+	///        inline. Restores the previous one on destruction.
+	///
+	/// Simulation installs its own pool, or null when it steps serially, so
+	/// a simulation stepped from inside another pool's task (a parameter-sweep
+	/// variant) keeps to its own thread budget. Not copyable/movable.
+	class ScopedCurrentPool
+	{
+	public:
+		explicit ScopedCurrentPool(ThreadPool* pool);
+		~ScopedCurrentPool();
+		ScopedCurrentPool(const ScopedCurrentPool&) = delete;
+		ScopedCurrentPool& operator=(const ScopedCurrentPool&) = delete;
+		ScopedCurrentPool(ScopedCurrentPool&&) = delete;
+		ScopedCurrentPool& operator=(ScopedCurrentPool&&) = delete;
+	private:
+		ThreadPool* previousPool;
+		std::size_t previousSlot;
+		bool previousIsDriver;
+	};
+
+	/// @brief Threads parallelFor() can spread over on the calling thread:
+	///        the current pool's thread count, or 1 without one.
+	inline int currentParallelism()
+	{
+		const ThreadPool* pool = ThreadPool::current();
+		return pool != nullptr ? pool->getThreadCount() : 1;
+	}
+
+	/// @brief Calls @p body(i) for every i in [0, count), spread over the
+	///        current pool, and returns once all calls have finished.
+	///
+	/// The calling thread runs index 0 itself and then helps drain the pool
+	/// (runUntil() nests), so calling this from inside a task is fine and
+	/// never blocks a thread the pool needs. Without a current pool, or with
+	/// a pool of 1, the calls run inline in index order. Which thread runs
+	/// which index is unspecified, so each index must touch its own data
+	/// only. @p body must not throw.
+	template<typename Body>
+	void parallelFor(std::size_t count, Body&& body)
+	{
+		ThreadPool* const pool = ThreadPool::current();
+		if (pool == nullptr || pool->getThreadCount() <= 1 || count <= 1)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				body(i);
+			}
+			return;
+		}
+
+		struct Loop
+		{
+			std::remove_reference_t<Body>* body;
+			std::atomic<std::size_t> pending;
+		};
+		Loop loop{ &body, count - 1 };
+		const auto run = [](void* context, std::size_t index)
+			{
+				auto& self = *static_cast<Loop*>(context);
+				(*self.body)(index);
+				self.pending.fetch_sub(1, std::memory_order_release);
+			};
+		for (std::size_t i = 1; i < count; ++i)
+		{
+			pool->submit(Task{ run, &loop, i });
+		}
+		body(0);
+		pool->runUntil(loop.pending);
+	}
+}
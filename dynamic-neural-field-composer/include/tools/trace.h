@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Timeline tracing in the Chrome trace-event format, which ui.perfetto.dev and
+// chrome://tracing open as is.
+//
+// A Span marks one interval on the calling thread: it reads the clock when
+// constructed and records the interval when destroyed. Spans on one thread
+// nest, and each thread has its own row in the viewer. Events go into a
+// per-thread buffer, so recording one takes no shared lock; stop() collects
+// every buffer and writes the file.
+//
+// Tracing is process-wide and off by default. Off, a Span costs one relaxed
+// atomic load. It is turned on by start(), by Simulation::startTrace(), or by
+// setting DNF_COMPOSER_TRACE to an output file: the first Simulation::init()
+// then starts a session that is written when the process exits.
+namespace dnf_composer::tools::trace
+{
+	// Events kept per thread and session; later ones are counted and dropped.
+	// An event takes about 64 bytes.
+	constexpr std::size_t kDefaultEventsPerThread = 1 << 20;
+
+	// The environment variable read by startFromEnvironment().
+	constexpr const char* kEnvironmentVariable = "DNF_COMPOSER_TRACE";
+
+	namespace detail
+	{
+		inline std::atomic<bool> active{ false };
+	}
+
+	inline bool isActive() { return detail::active.load(std::memory_order_relaxed); }
+
+	// Starts a session that stop() writes to `path`, discarding any events left
+	// from an earlier one. A session already running is written first.
+	void start(const std::string& path, std::size_t eventsPerThread = kDefaultEventsPerThread);
+	// Ends the session and writes its events. Returns the path written, or an
+	// empty string if no session was running or the file could not be written
+	// (the error is logged).
+	std::string stop();
+	// The file the running session will be written to; empty if none.
+	std::string outputPath();
+
+	// Starts a session writing to $DNF_COMPOSER_TRACE, and arranges for it to be
+	// written at exit. Does nothing if the variable is unset or empty, or after
+	// the first call. Returns whether this call started a session.
+	bool startFromEnvironment();
+
+	// Names the calling thread's row in the viewer ("thread <n>" by default).
+	void setThreadName(std::string name);
+
+	// Records an interval measured by the caller, for code that already reads
+	// the clock. Does nothing unless a session is running.
+	void record(std::string_view name, const char* category,
+		std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+	// `name` must outlive the span; `category` must be a string literal.
+	class Span
+	{
+	public:
+		Span(std::string_view name, const char* category)
+			: name(name), category(category)
+		{
+			if (isActive()) {
+				begin = std::chrono::steady_clock::now();
+			}
+		}
+
+		~Span()
+		{
+			if (begin != std::chrono::steady_clock::time_point{}) {
+				record(name, category, begin, std::chrono::steady_clock::now());
+			}
+		}
+
+		Span(const Span&) = delete;
+		Span& operator=(const Span&) = delete;
+
+	private:
+		std::string_view name;
+		const char* category;
+		std::chrono::steady_clock::time_point begin{};
+	};
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "tools/mapped_file.h"
+#include "tools/sparse_matrix.h"
+
+// Binary weight files (<name>_weights.dnfw) for FieldCoupling, next to the
+// whitespace-separated text files it has always written. A file is a 64-byte
+// header followed by the raw payload, in the host's (little-endian) byte
+// order, so a reader maps it and uses the numbers in place: opening is a
+// header check, and the payload is paged in as it is touched.
+//
+// Header (version 1), all fields little-endian:
+//   0  char[4]   magic "DNFW"
+//   4  uint16    version
+//   6  uint8     dtype   (WeightDtype)
+//   7  uint8     layout  (WeightLayout)
+//   8  uint32    header size in bytes (64)
+//  12  uint32    reserved, 0
+//  16  uint64    rows    (input size)
+//  24  uint64    cols    (output size)
+//  32  uint64    stored entries (rows * cols for Dense)
+//  40  uint64    payload size in bytes
+//  48  uint64    checksum of the payload (payloadChecksum())
+//  56  uint64    reserved, 0
+//
+// Payload, Dense: rows * cols values, entry (i, j) at i * cols + j -- the
+// layout of components["weights"] and the text file.
+// Payload, Csr: rows + 1 uint64 row offsets, then the uint32 column of each
+// stored entry, zero-padded to a multiple of 8 bytes, then the stored values
+// (the arrays of a tools::math::CsrMatrix).
+//
+// A reader rejects a newer version, an unknown dtype or layout, and any size
+// that does not add up. The checksum is only checked on request, since that
+// reads the whole payload.
+namespace dnf_composer::tools::weight_file
+{
+	inline constexpr std::uint16_t kVersion = 1;
+	inline constexpr std::size_t kHeaderSize = 64;
+
+	enum class WeightDtype : std::uint8_t { Float64 = 0 };
+	enum class WeightLayout : std::uint8_t { Dense = 0, Csr = 1 };
+
+	const char* toString(WeightLayout layout);
+
+	struct WeightFileHeader
+	{
+		char magic[4];
+		std::uint16_t version;
+		WeightDtype dtype;
+		WeightLayout layout;
+		std::uint32_t headerSize;
+		std::uint32_t reserved0;
+		std::uint64_t rows;
+		std::uint64_t cols;
+		std::uint64_t entries;
+		std::uint64_t payloadSize;
+		std::uint64_t checksum;
+		std::uint64_t reserved1;
+	};
+	static_assert(sizeof(WeightFileHeader) == kHeaderSize);
+
+	// 64-bit FNV-1a over 8-byte words (bytes, for a tail shorter than a word).
+	std::uint64_t payloadChecksum(std::span<const std::byte> payload);
+
+	// Write a (rows x cols) dense matrix / a CSR matrix. The file is written
+	// next to `path` and renamed over it once complete, so a reader never sees
+	// a partial file. Throws std::invalid_argument on a size mismatch and
+	// std::runtime_error if the file cannot be written.
+	void writeDense(const std::string& path, std::span<const double> weights, std::size_t rows, std::size_t cols);
+	void writeCsr(const std::string& path, const math::CsrMatrix& weights);
+
+	// A mapping of a weight file. The constructor maps the file and validates
+	// the header against the file size (std::runtime_error if it cannot be
+	// opened or is not a valid weight file); nothing else is read until it is
+	// used. Mapped CopyOnWrite, the dense values can be used in place as a
+	// writable matrix (mutableDense()) that is paged in as it is touched.
+	class MappedWeightFile
+	{
+	public:
+		explicit MappedWeightFile(const std::string& path, MappedFile::Access access = MappedFile::Access::ReadOnly);
+
+		const WeightFileHeader& header() const { return *reinterpret_cast<const WeightFileHeader*>(file_.data()); }
+		std::size_t rows() const { return header().rows; }
+		std::size_t cols() const { return header().cols; }
+		WeightLayout layout() const { return header().layout; }
+
+		// Reads the whole payload.
+		bool verifyChecksum() const;
+
+		// The values in place, Dense layout only (std::logic_error otherwise).
+		std::span<const double> dense() const;
+		// The same values, writable: Dense layout and a CopyOnWrite mapping only
+		// (std::logic_error otherwise). Writes never reach the file.
+		std::span<double> mutableDense() const;
+
+		// Dense copy of either layout; `out` must hold rows * cols values.
+		// Throws std::invalid_argument on a size mismatch and std::runtime_error
+		// if the CSR arrays are inconsistent.
+		void copyDenseInto(std::span<double> out) const;
+
+		// Either layout as CSR, dropping |w| <= threshold like csr_from_dense().
+		math::CsrMatrix toCsr(double threshold) const;
+
+	private:
+		std::span<const std::byte> payload() const { return file_.bytes().subspan(kHeaderSize); }
+
+		MappedFile file_;
+	};
+}
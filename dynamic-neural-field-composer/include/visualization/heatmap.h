@@ -109,6 +109,6 @@ namespace dnf_composer
 		[[nodiscard]] std::pair<double, double> getScale() const;
 		void setDimensionHint(int rows, int cols);
 		[[nodiscard]] std::string toString() const override;
-		void render(const std::vector<std::vector<double>*>& data, const std::vector<std::string>& legends) override;
+		void render(const std::vector<element::ComponentBuffer*>& data, const std::vector<std::string>& legends) override;
 	};
 }
\ No newline at end of file
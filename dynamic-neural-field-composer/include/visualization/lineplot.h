@@ -35,6 +35,6 @@ namespace dnf_composer
 		[[nodiscard]] double getLineThickness() const;
 		[[nodiscard]] double getAutoFit() const;
 		[[nodiscard]] std::string toString() const override;
-		void render(const std::vector<std::vector<double>*>& data, const std::vector<std::string>& legends) override;
+		void render(const std::vector<element::ComponentBuffer*>& data, const std::vector<std::string>& legends) override;
 	};
 }
@@ -3,6 +3,7 @@
 #include <atomic>
 
 #include "plot_parameters.h"
+#include "elements/element_components.h"
 
 namespace dnf_composer
 {
@@ -37,6 +38,6 @@ namespace dnf_composer
 		/// @brief Render the plot using the provided data and legends.
 		/// @param data     Pointers to the component vectors to display.
 		/// @param legends  Legend label for each data series.
-		virtual void render(const std::vector<std::vector<double>*>& data, const std::vector<std::string>& legends) = 0;
+		virtual void render(const std::vector<element::ComponentBuffer*>& data, const std::vector<std::string>& legends) = 0;
 	};
 }
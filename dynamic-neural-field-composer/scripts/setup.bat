@@ -27,7 +27,7 @@ echo Installing vcpkg packages...
     "imgui-node-editor:x64-windows" ^
     "nlohmann-json:x64-windows" ^
     "gtest:x64-windows" ^
-    "fftw3:x64-windows" ^
+    "fftw3[threads]:x64-windows" ^
     "benchmark:x64-windows"
 if errorlevel 1 ( echo ERROR: vcpkg install failed. & exit /b 1 )
 
@@ -36,7 +36,7 @@ echo "Installing vcpkg packages..."
     "imgui-node-editor:$TRIPLET" \
     "nlohmann-json:$TRIPLET" \
     "gtest:$TRIPLET" \
-    "fftw3:$TRIPLET" \
+    "fftw3[threads]:$TRIPLET" \
     "benchmark:$TRIPLET"
 
 # ── imgui-platform-kit ────────────────────────────────────────────────────────
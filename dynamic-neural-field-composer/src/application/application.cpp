@@ -11,6 +11,7 @@
 #include "user_interface/fonts/fa.h"
 #include "user_interface/log_window.h"
 #include "tools/utils.h"
+#include "tools/trace.h"
 
 namespace dnf_composer
 {
@@ -96,6 +97,7 @@ namespace dnf_composer
 		if (guiActive)
 		{
 			ImGui::GetIO().FontGlobalScale = uiScalePct / 100.0F;
+			const tools::trace::Span span("GUI frame", "gui");
 			gui->render();
 		}
 	}
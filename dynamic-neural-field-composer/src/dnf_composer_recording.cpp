@@ -0,0 +1,263 @@
+// dnf_composer_recording — converts binary recordings (<id>_<component>_<ts>.dnfr,
+// see include/tools/recording_file.h) to the CSV files SimulationRecorder writes in
+// RecordingFormat::Csv, so scripts that read those keep working, codes raw ones
+// (include/tools/recording_codec.h) and describes them. A directory converts every
+// recording in it, e.g. a simulation's data/<identifier>/recordings/ folder.
+//
+// Usage: dnf_composer_recording to-csv <file|directory> [--remove]
+//        dnf_composer_recording compress <file|directory> [--tolerance T] [--keyframe K]
+//        dnf_composer_recording info <file.dnfr>
+//   to-csv      writes <name>.csv next to each <name>.dnfr, row for row the file the
+//               CSV recorder would have written (values rounded to 6 decimals)
+//   --remove    delete each recording once it has been converted
+//   compress    replaces each raw recording with a coded one: lossless (XorDelta), or
+//               with --tolerance every value within T of the original (Quantized).
+//               Coded recordings are left alone.
+//   --keyframe  frames from one keyframe to the next (default 256)
+//   info        prints the header, the frame count, the recorded tick range and, for
+//               a coded recording, its size relative to raw frames
+//
+// Exit codes: 0 success; 1 bad arguments; 2 a file could not be read, converted or
+// written.
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "tools/recording_file.h"
+
+using namespace dnf_composer::tools;
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	constexpr const char* kBinaryExtension = ".dnfr";
+
+	// The files `target` names: itself, or a directory's recordings.
+	std::vector<fs::path> collect(const fs::path& target)
+	{
+		if (!fs::is_directory(target))
+			return { target };
+		std::vector<fs::path> files;
+		for (const auto& entry : fs::directory_iterator(target))
+			if (entry.is_regular_file() && entry.path().extension() == kBinaryExtension)
+				files.push_back(entry.path());
+		return files;
+	}
+
+	void toCsv(const recording_file::MappedRecording& recording, const fs::path& destination)
+	{
+		std::ofstream out(destination, std::ios::trunc);
+		if (!out.is_open())
+			throw std::runtime_error("cannot write " + destination.string());
+		const auto& info = recording.info();
+		recording_file::writeCsvHeader(out, info.frameValues, info.sizeX, info.sizeY, info.region);
+		for (std::size_t k = 0; k < recording.frameCount(); ++k)
+			recording_file::writeCsvRow(out, recording.ticks(k), recording.ms(k), recording.readFrame(k));
+		if (!out.flush())
+			throw std::runtime_error("cannot write " + destination.string());
+	}
+
+	// Code a raw recording into `destination`; returns false for one that is already coded.
+	bool compress(const fs::path& source, const fs::path& destination, const recording_file::CodecOptions& codec)
+	{
+		const recording_file::MappedRecording recording(source.string());
+		if (recording.coded())
+			return false;
+		recording_file::RecordingInfo info = recording.info();
+		info.codec = codec;
+		std::ofstream out(destination, std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+			throw std::runtime_error("cannot write " + destination.string());
+		recording_file::writeHeader(out, info);
+		recording_file::FrameEncoder encoder(codec, info.frameValues);
+		std::vector<std::byte> payload;
+		for (std::size_t k = 0; k < recording.frameCount(); ++k)
+		{
+			const bool keyframe = encoder.encode(recording.frame(k), payload);
+			recording_file::writeCodedFrame(out, recording.ticks(k), recording.ms(k), keyframe, payload);
+		}
+		if (!out.flush())
+			throw std::runtime_error("cannot write " + destination.string());
+		return true;
+	}
+
+	const char* codecName(recording_file::RecordingCodec codec)
+	{
+		switch (codec)
+		{
+		case recording_file::RecordingCodec::XorDelta: return "XorDelta (lossless)";
+		case recording_file::RecordingCodec::Quantized: return "Quantized";
+		default: return "none (raw frames)";
+		}
+	}
+
+	void info(const fs::path& path)
+	{
+		const recording_file::MappedRecording recording(path.string());
+		const auto& info = recording.info();
+		std::printf("%s\n  version %u, float64\n  element '%s', component '%s', %d x %d (%zu values per frame)\n"
+			"  sampled every %d %s\n  %zu frames",
+			path.string().c_str(), static_cast<unsigned>(recording.header().version),
+			info.elementId.c_str(), info.componentName.c_str(), info.sizeX, info.sizeY, info.frameValues,
+			info.sampleInterval, info.unit == recording_file::SampleUnit::Ticks ? "ticks" : "ms",
+			recording.frameCount());
+		if (recording.frameCount() > 0)
+			std::printf(", ticks %lld to %lld", recording.ticks(0), recording.ticks(recording.frameCount() - 1));
+		if (info.region != recording_file::SampledRegion{})
+			std::printf("\n  region from (%d, %d), every %d x %d values", info.region.originX, info.region.originY,
+				info.region.strideX, info.region.strideY);
+		std::printf("\n  codec %s", codecName(info.codec.codec));
+		if (info.codec.codec == recording_file::RecordingCodec::Quantized)
+			std::printf(", tolerance %g", info.codec.tolerance);
+		if (recording.coded())
+		{
+			const double raw = static_cast<double>(recording_file::frameSize(info.frameValues) * recording.frameCount());
+			const double coded = static_cast<double>(fs::file_size(path) - recording.header().headerSize - recording.trailingBytes());
+			std::printf(", keyframe every %u frames, %.1f%% of raw frames (%.1fx)", info.codec.keyframeInterval,
+				raw > 0.0 ? 100.0 * coded / raw : 0.0, coded > 0.0 ? raw / coded : 0.0);
+		}
+		std::printf("\n");
+		if (recording.trailingBytes() > 0)
+			std::printf("  %zu bytes after the last whole frame (an interrupted write) are ignored\n",
+				recording.trailingBytes());
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto usage = []
+	{
+		std::fprintf(stderr,
+			"Usage: dnf_composer_recording to-csv <file|directory> [--remove]\n"
+			"       dnf_composer_recording compress <file|directory> [--tolerance T] [--keyframe K]\n"
+			"       dnf_composer_recording info <file.dnfr>\n");
+		return 1;
+	};
+	if (argc < 3)
+		return usage();
+
+	const std::string command = argv[1];
+	const fs::path target = argv[2];
+	bool remove = false;
+	recording_file::CodecOptions codec{ recording_file::RecordingCodec::XorDelta };
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string a = argv[i];
+		if (a == "--remove")
+			remove = true;
+		else if ((a == "--tolerance" || a == "--keyframe") && i + 1 < argc)
+		{
+			char* end = nullptr;
+			const char* value = argv[++i];
+			if (a == "--tolerance")
+			{
+				codec.codec = recording_file::RecordingCodec::Quantized;
+				codec.tolerance = std::strtod(value, &end);
+			}
+			else
+				codec.keyframeInterval = static_cast<std::uint32_t>(std::strtoul(value, &end, 10));
+			if (end == value || *end != '\0')
+			{
+				std::fprintf(stderr, "Bad value for %s: %s\n", a.c_str(), value);
+				return 1;
+			}
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown argument: %s\n", a.c_str());
+			return 1;
+		}
+	}
+	if (command != "to-csv" && command != "compress" && command != "info")
+		return usage();
+	try
+	{
+		recording_file::validate(codec);
+	}
+	catch (const std::invalid_argument& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	if (!fs::exists(target))
+	{
+		std::fprintf(stderr, "No such file or directory: %s\n", target.string().c_str());
+		return 1;
+	}
+
+	int failures = 0;
+	if (command == "info")
+	{
+		try
+		{
+			info(target);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s\n", e.what());
+			++failures;
+		}
+		return failures == 0 ? 0 : 2;
+	}
+
+	const auto files = collect(target);
+	if (files.empty())
+		std::printf("No %s files in %s\n", kBinaryExtension, target.string().c_str());
+	if (command == "compress")
+	{
+		for (const auto& source : files)
+		{
+			// Written next to the source and renamed over it once complete.
+			const fs::path staging = fs::path(source).concat(".tmp");
+			try
+			{
+				if (!compress(source, staging, codec))
+				{
+					std::printf("%s is already coded\n", source.string().c_str());
+					continue;
+				}
+				const auto before = fs::file_size(source);
+				const auto after = fs::file_size(staging);
+				fs::rename(staging, source);
+				std::printf("%s: %ju -> %ju bytes (%.1fx)\n", source.string().c_str(), static_cast<std::uintmax_t>(before),
+					static_cast<std::uintmax_t>(after), after > 0 ? static_cast<double>(before) / static_cast<double>(after) : 0.0);
+			}
+			catch (const std::exception& e)
+			{
+				std::error_code ec;
+				fs::remove(staging, ec);
+				std::fprintf(stderr, "%s: %s\n", source.string().c_str(), e.what());
+				++failures;
+			}
+		}
+		return failures == 0 ? 0 : 2;
+	}
+
+	for (const auto& source : files)
+	{
+		const fs::path destination = fs::path(source).replace_extension(".csv");
+		try
+		{
+			std::size_t frames = 0;
+			{
+				const recording_file::MappedRecording recording(source.string());
+				toCsv(recording, destination);
+				frames = recording.frameCount();
+			}
+			std::printf("%s -> %s (%zu frames)\n", source.string().c_str(), destination.string().c_str(), frames);
+			if (remove)
+				fs::remove(source);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s: %s\n", source.string().c_str(), e.what());
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,191 @@
+// dnf_composer_sweep — runs a parameter sweep over a base architecture in parallel and
+// streams one summary line per variant into a JSON Lines results file. The parallel
+// successor of examples/cross_platform_validation_runner.cpp for exploring a deck's
+// parameters: variants run on a thread pool instead of one after another.
+//
+// Usage: dnf_composer_sweep <sweep.json> [--out <results.jsonl>] [--jobs N]
+//                           [--architecture <deck.json>] [--resume | --force]
+//                           [--fft-plans estimate|measure|patient]
+//   sweep.json      the sweep specification (see SweepSpecification in
+//                   include/simulation/parameter_sweep.h)
+//   --out           results file, default <sweep>.results.jsonl next to the sweep file
+//   --jobs          variants run at once, default std::thread::hardware_concurrency()
+//   --architecture  overrides the sweep file's "architecture"
+//   --resume        keep the variants already in the results file and run the rest
+//   --force         overwrite an existing results file
+//   --fft-plans     FFTW planner rigor (tools::math::PlanRigor), default estimate. measure
+//                   or patient load the wisdom under the resource root, plan any shape it
+//                   lacks once, before the first variant runs, and save the wisdom back so
+//                   a --resume plans the same shapes the same way
+//
+// Exit codes: 0 every variant ran; 1 bad arguments or sweep specification; 2 --resume
+// found a results file from a different sweep; 3 at least one variant failed (its line
+// holds the error).
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "simulation/parameter_sweep.h"
+#include "tools/fft_convolution.h"
+#include "tools/logger.h"
+
+using namespace dnf_composer;
+
+int main(int argc, char* argv[])
+{
+	tools::logger::Logger::setMinLogLevel(tools::logger::LogLevel::WARNING);
+
+	std::string sweepArg;
+	std::string outArg;
+	std::string architectureArg;
+	int  jobs   = static_cast<int>(std::thread::hardware_concurrency());
+	bool resume = false;
+	bool force  = false;
+	tools::math::PlanRigor planRigor = tools::math::PlanRigor::Estimate;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string a = argv[i];
+		if (a == "--out" && i + 1 < argc)                outArg          = argv[++i];
+		else if (a == "--architecture" && i + 1 < argc)  architectureArg = argv[++i];
+		else if (a == "--resume")                        resume          = true;
+		else if (a == "--force")                         force           = true;
+		else if (a == "--fft-plans" && i + 1 < argc)
+		{
+			const std::string text = argv[++i];
+			if (text == "estimate")     planRigor = tools::math::PlanRigor::Estimate;
+			else if (text == "measure") planRigor = tools::math::PlanRigor::Measure;
+			else if (text == "patient") planRigor = tools::math::PlanRigor::Patient;
+			else
+			{
+				std::fprintf(stderr, "--fft-plans expects estimate, measure or patient, got '%s'.\n", text.c_str());
+				return 1;
+			}
+		}
+		else if (a == "--jobs" && i + 1 < argc)
+		{
+			const char* text = argv[++i];
+			try
+			{
+				jobs = std::stoi(text);
+			}
+			catch (const std::exception&)
+			{
+				jobs = 0;
+			}
+			if (jobs <= 0)
+			{
+				std::fprintf(stderr, "--jobs must be a positive integer, got '%s'.\n", text);
+				return 1;
+			}
+		}
+		else if (sweepArg.empty() && !a.starts_with("--"))  sweepArg = a;
+		else
+		{
+			std::fprintf(stderr, "Unknown argument: %s\n", a.c_str());
+			return 1;
+		}
+	}
+	if (sweepArg.empty())
+	{
+		std::fprintf(stderr, "Usage: dnf_composer_sweep <sweep.json> [--out <results.jsonl>] [--jobs N]\n"
+		                     "                          [--architecture <deck.json>] [--resume | --force]\n"
+		                     "                          [--fft-plans estimate|measure|patient]\n");
+		return 1;
+	}
+	if (resume && force)
+	{
+		std::fprintf(stderr, "--resume and --force are mutually exclusive.\n");
+		return 1;
+	}
+	if (jobs <= 0)
+		jobs = 1;
+	tools::math::setPlanRigor(planRigor);
+
+	const std::filesystem::path sweepPath = sweepArg;
+	const std::filesystem::path outPath = outArg.empty()
+		? std::filesystem::path(sweepPath).replace_extension(".results.jsonl") : std::filesystem::path(outArg);
+	if (std::filesystem::exists(outPath) && !resume && !force)
+	{
+		std::fprintf(stderr, "%s already exists; pass --resume to continue it or --force to overwrite it.\n",
+			outPath.string().c_str());
+		return 1;
+	}
+
+	std::unique_ptr<ParameterSweep> sweep;
+	try
+	{
+		SweepSpecification specification = SweepSpecification::fromFile(sweepPath);
+		if (!architectureArg.empty())
+			specification.architecture = architectureArg;
+		sweep = std::make_unique<ParameterSweep>(std::move(specification));
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	std::size_t alreadyDone = 0;
+	if (resume)
+	{
+		try
+		{
+			alreadyDone = sweep->completedVariants(outPath).size();
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s\n", e.what());
+			return 2;
+		}
+	}
+
+	if (planRigor != tools::math::PlanRigor::Estimate)
+	{
+		// Measured plans are picked by timing; saving them as wisdom is what makes
+		// a resumed sweep, in a new process, run on the same plans.
+		std::printf("Planning FFT shapes...\n");
+		std::fflush(stdout);
+		sweep->prepareFftPlans();
+		if (!tools::math::saveFftWisdom(tools::math::defaultFftWisdomDirectory()))
+			std::fprintf(stderr, "Could not save FFTW wisdom to %s; a resumed sweep may plan differently.\n",
+				tools::math::defaultFftWisdomDirectory().c_str());
+	}
+
+	const std::size_t total = sweep->getVariants().size();
+	std::printf("Sweep: %zu variants (%zu already done), %d jobs, results in %s\n",
+		total, alreadyDone, jobs, outPath.string().c_str());
+
+	std::size_t failed = 0;
+	try
+	{
+		sweep->run(outPath, jobs, resume, [&failed](const SweepResult& result, std::size_t done, std::size_t all) {
+			if (!result.error.empty())
+			{
+				++failed;
+				std::printf("[%zu/%zu] variant %zu FAILED: %s\n", done, all, result.variant.index, result.error.c_str());
+			}
+			else
+			{
+				std::printf("[%zu/%zu] variant %zu (%.2f s)\n", done, all, result.variant.index, result.wallSeconds);
+			}
+			std::fflush(stdout);
+		});
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+
+	if (failed > 0)
+	{
+		std::fprintf(stderr, "%zu variant(s) failed; see the \"error\" field of their lines in %s.\n",
+			failed, outPath.string().c_str());
+		return 3;
+	}
+	return 0;
+}
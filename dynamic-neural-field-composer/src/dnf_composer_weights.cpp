@@ -0,0 +1,257 @@
+// dnf_composer_weights — converts FieldCoupling weight files between the text format
+// (<name>_weights.txt, whitespace-separated values, one input row per line) and the
+// binary one (<name>_weights.dnfw, see include/tools/weight_file.h), and describes
+// binary files. A directory converts every weight file in it, e.g. a simulation's
+// data/<identifier>/ folder.
+//
+// Usage: dnf_composer_weights to-binary <file|directory> [--csr] [--threshold T] [--remove]
+//        dnf_composer_weights to-text <file|directory> [--remove]
+//        dnf_composer_weights info <file.dnfw> [--verify]
+//   to-binary    writes <name>_weights.dnfw next to each <name>_weights.txt; the matrix
+//                dimensions come from the text file's shape
+//   --csr        store only the entries with |w| > threshold (for couplings using
+//                WeightStorage::SPARSE; any coupling can load it)
+//   --threshold  pruning threshold for --csr, default 0 (drop exact zeros only)
+//   to-text      writes <name>_weights.txt next to each <name>_weights.dnfw, with
+//                enough digits to read back the same doubles
+//   --remove     delete each source file once it has been converted. Without it, a
+//                .dnfw left next to its .txt is the one FieldCoupling::readWeights() loads.
+//   info         prints the header; --verify also checks the payload checksum
+//
+// Exit codes: 0 success; 1 bad arguments; 2 a file could not be read, converted or
+// written (or failed --verify).
+
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "tools/sparse_matrix.h"
+#include "tools/weight_file.h"
+
+using namespace dnf_composer::tools;
+
+namespace
+{
+	namespace fs = std::filesystem;
+
+	constexpr const char* kTextSuffix = "_weights.txt";
+	constexpr const char* kBinarySuffix = "_weights.dnfw";
+
+	struct TextMatrix
+	{
+		std::size_t rows = 0;
+		std::size_t cols = 0;
+		std::vector<double> values;
+	};
+
+	// Parses a text weight file; each non-blank line is one row. Throws
+	// std::runtime_error on a malformed value or rows of different lengths.
+	TextMatrix readText(const fs::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open())
+			throw std::runtime_error("cannot open " + path.string());
+		const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		TextMatrix matrix;
+		const char* p = text.data();
+		const char* const end = p + text.size();
+		std::size_t inRow = 0;
+		const auto endRow = [&]
+		{
+			if (inRow == 0)
+				return;
+			if (matrix.rows == 0)
+				matrix.cols = inRow;
+			else if (inRow != matrix.cols)
+				throw std::runtime_error("row " + std::to_string(matrix.rows + 1) + " has " + std::to_string(inRow)
+					+ " values, the first has " + std::to_string(matrix.cols));
+			++matrix.rows;
+			inRow = 0;
+		};
+		while (p < end)
+		{
+			if (*p == '\n') { endRow(); ++p; continue; }
+			if (*p == ' ' || *p == '\t' || *p == '\r') { ++p; continue; }
+			double value = 0.0;
+			const auto [next, error] = std::from_chars(p, end, value);
+			if (error != std::errc())
+				throw std::runtime_error("not a number at byte " + std::to_string(p - text.data()));
+			matrix.values.push_back(value);
+			++inRow;
+			p = next;
+		}
+		endRow();
+		return matrix;
+	}
+
+	void writeText(const fs::path& path, const weight_file::MappedWeightFile& file)
+	{
+		std::vector<double> dense(file.rows() * file.cols());
+		file.copyDenseInto(dense);
+
+		std::string out;
+		out.reserve(dense.size() * 12);
+		char buffer[32];
+		for (std::size_t i = 0; i < file.rows(); ++i)
+		{
+			for (std::size_t j = 0; j < file.cols(); ++j)
+			{
+				// Shortest form that reads back to the same double.
+				const auto result = std::to_chars(buffer, buffer + sizeof(buffer), dense[i * file.cols() + j]);
+				out.append(buffer, result.ptr);
+				out.push_back(' ');
+			}
+			out.push_back('\n');
+		}
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+		stream.write(out.data(), static_cast<std::streamsize>(out.size()));
+		if (!stream)
+			throw std::runtime_error("cannot write " + path.string());
+	}
+
+	fs::path withSuffix(const fs::path& path, const char* from, const char* to)
+	{
+		const std::string name = path.filename().string();
+		const std::string stem = name.ends_with(from) ? name.substr(0, name.size() - std::string(from).size()) : path.stem().string();
+		return path.parent_path() / (stem + to);
+	}
+
+	// The files `target` names: itself, or a directory's files with the suffix.
+	std::vector<fs::path> collect(const fs::path& target, const char* suffix)
+	{
+		if (!fs::is_directory(target))
+			return { target };
+		std::vector<fs::path> files;
+		for (const auto& entry : fs::directory_iterator(target))
+			if (entry.is_regular_file() && entry.path().filename().string().ends_with(suffix))
+				files.push_back(entry.path());
+		return files;
+	}
+
+	bool info(const fs::path& path, bool verify)
+	{
+		const weight_file::MappedWeightFile file(path.string());
+		const auto& header = file.header();
+		std::printf("%s\n  version %u, float64, %s layout\n  %llu x %llu, %llu stored entries (%.1f%%), payload %llu bytes\n",
+			path.string().c_str(), static_cast<unsigned>(header.version), weight_file::toString(header.layout),
+			static_cast<unsigned long long>(header.rows), static_cast<unsigned long long>(header.cols),
+			static_cast<unsigned long long>(header.entries),
+			header.rows * header.cols == 0 ? 0.0 : 100.0 * static_cast<double>(header.entries) / static_cast<double>(header.rows * header.cols),
+			static_cast<unsigned long long>(header.payloadSize));
+		if (!verify)
+			return true;
+		const bool ok = file.verifyChecksum();
+		std::printf("  checksum %s\n", ok ? "ok" : "MISMATCH");
+		return ok;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const auto usage = []
+	{
+		std::fprintf(stderr,
+			"Usage: dnf_composer_weights to-binary <file|directory> [--csr] [--threshold T] [--remove]\n"
+			"       dnf_composer_weights to-text <file|directory> [--remove]\n"
+			"       dnf_composer_weights info <file.dnfw> [--verify]\n");
+		return 1;
+	};
+	if (argc < 3)
+		return usage();
+
+	const std::string command = argv[1];
+	const fs::path target = argv[2];
+	bool csr = false, remove = false, verify = false;
+	double threshold = 0.0;
+	for (int i = 3; i < argc; ++i)
+	{
+		const std::string a = argv[i];
+		if (a == "--csr")                             csr = true;
+		else if (a == "--remove")                     remove = true;
+		else if (a == "--verify")                     verify = true;
+		else if (a == "--threshold" && i + 1 < argc)
+		{
+			try { threshold = std::stod(argv[++i]); }
+			catch (const std::exception&)
+			{
+				std::fprintf(stderr, "--threshold expects a number, got '%s'.\n", argv[i]);
+				return 1;
+			}
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown argument: %s\n", a.c_str());
+			return 1;
+		}
+	}
+	if (command != "to-binary" && command != "to-text" && command != "info")
+		return usage();
+	if (!fs::exists(target))
+	{
+		std::fprintf(stderr, "No such file or directory: %s\n", target.string().c_str());
+		return 1;
+	}
+
+	int failures = 0;
+	if (command == "info")
+	{
+		try
+		{
+			if (!info(target, verify))
+				++failures;
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s\n", e.what());
+			++failures;
+		}
+		return failures == 0 ? 0 : 2;
+	}
+
+	const bool toBinary = command == "to-binary";
+	const auto files = collect(target, toBinary ? kTextSuffix : kBinarySuffix);
+	if (files.empty())
+		std::printf("No %s files in %s\n", toBinary ? kTextSuffix : kBinarySuffix, target.string().c_str());
+	for (const auto& source : files)
+	{
+		const fs::path destination = toBinary
+			? withSuffix(source, kTextSuffix, kBinarySuffix)
+			: withSuffix(source, kBinarySuffix, kTextSuffix);
+		try
+		{
+			if (toBinary)
+			{
+				const TextMatrix matrix = readText(source);
+				if (csr)
+					weight_file::writeCsr(destination.string(),
+						math::csr_from_dense(matrix.values, matrix.rows, matrix.cols, threshold));
+				else
+					weight_file::writeDense(destination.string(), matrix.values, matrix.rows, matrix.cols);
+				std::printf("%s -> %s (%zu x %zu)\n", source.string().c_str(), destination.string().c_str(),
+					matrix.rows, matrix.cols);
+			}
+			else
+			{
+				const weight_file::MappedWeightFile file(source.string());
+				if (!file.verifyChecksum())
+					throw std::runtime_error("checksum mismatch, file is corrupt");
+				writeText(destination, file);
+				std::printf("%s -> %s (%zu x %zu)\n", source.string().c_str(), destination.string().c_str(),
+					file.rows(), file.cols());
+			}
+			if (remove)
+				fs::remove(source);
+		}
+		catch (const std::exception& e)
+		{
+			std::fprintf(stderr, "%s: %s\n", source.string().c_str(), e.what());
+			++failures;
+		}
+	}
+	return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,210 @@
+// dnf_composer_wisdom — pre-generates FFTW wisdom for the transform shapes a deployment
+// uses, so runs under tools::math::PlanRigor::Measure or Patient get their measured plans
+// at once instead of timing them on first use (see PlanRigor in
+// include/tools/fft_convolution.h). Existing wisdom in the target directory is loaded
+// first and kept, so the tool can be run again to add shapes.
+//
+// Usage: dnf_composer_wisdom [SIZE ...] [--deck <deck.json> ...] [--rigor measure|patient]
+//                            [--precision double|single|both] [--dir <directory>]
+//   SIZE         WxH for a 2D grid (e.g. 256x256), or N for a 1D field (e.g. 4000)
+//   --deck       a simulation file: plans every shape its spectral elements use, found by
+//                initializing it under the selected precision(s)
+//   --rigor      planner rigor, default measure
+//   --precision  precision of the 2D shapes, default double (1D is always double)
+//   --dir        wisdom directory, default <resource root>/data/fftw-wisdom, the one
+//                setPlanRigor() loads from
+//
+// Exit codes: 0 wisdom written; 1 bad arguments or a deck that failed to load; 2 the
+// wisdom files could not be written.
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "simulation/simulation_file_manager.h"
+#include "tools/fft_convolution.h"
+#include "tools/logger.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::tools::math;
+
+namespace
+{
+	// "256x256" -> 2D, "4000" -> 1D; false on anything else.
+	bool parseSize(const std::string& text, FftPlanShape& shape)
+	{
+		try
+		{
+			std::size_t used = 0;
+			const int first = std::stoi(text, &used);
+			if (used == text.size())
+			{
+				shape = FftPlanShape{ 1, first, 1, Precision::Double, PlanRigor::Estimate };
+				return first > 0;
+			}
+			if (text[used] != 'x')
+				return false;
+			const std::string rest = text.substr(used + 1);
+			const int second = std::stoi(rest, &used);
+			if (used != rest.size())
+				return false;
+			shape = FftPlanShape{ 2, first, second, Precision::Double, PlanRigor::Estimate };
+			return first > 0 && second > 0;
+		}
+		catch (const std::exception&)
+		{
+			return false;
+		}
+	}
+
+	const char* toString(Precision precision)
+	{
+		return precision == Precision::Single ? "single" : "double";
+	}
+
+	void addShape(std::vector<FftPlanShape>& shapes, const FftPlanShape& shape)
+	{
+		for (const auto& s : shapes)
+			if (s.rank == shape.rank && s.size_x == shape.size_x && s.size_y == shape.size_y &&
+				s.precision == shape.precision)
+				return;
+		shapes.push_back(shape);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	tools::logger::Logger::setMinLogLevel(tools::logger::LogLevel::WARNING);
+
+	std::vector<FftPlanShape> sizes;
+	std::vector<std::string> decks;
+	std::string dirArg;
+	PlanRigor rigor = PlanRigor::Measure;
+	std::vector<Precision> precisions{ Precision::Double };
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string a = argv[i];
+		if (a == "--deck" && i + 1 < argc)      decks.emplace_back(argv[++i]);
+		else if (a == "--dir" && i + 1 < argc)  dirArg = argv[++i];
+		else if (a == "--rigor" && i + 1 < argc)
+		{
+			const std::string text = argv[++i];
+			if (text == "measure")      rigor = PlanRigor::Measure;
+			else if (text == "patient") rigor = PlanRigor::Patient;
+			else
+			{
+				std::fprintf(stderr, "--rigor expects measure or patient, got '%s'.\n", text.c_str());
+				return 1;
+			}
+		}
+		else if (a == "--precision" && i + 1 < argc)
+		{
+			const std::string text = argv[++i];
+			if (text == "double")      precisions = { Precision::Double };
+			else if (text == "single") precisions = { Precision::Single };
+			else if (text == "both")   precisions = { Precision::Double, Precision::Single };
+			else
+			{
+				std::fprintf(stderr, "--precision expects double, single or both, got '%s'.\n", text.c_str());
+				return 1;
+			}
+		}
+		else if (!a.starts_with("--"))
+		{
+			FftPlanShape shape;
+			if (!parseSize(a, shape))
+			{
+				std::fprintf(stderr, "Not a size: '%s' (expected WxH or N).\n", a.c_str());
+				return 1;
+			}
+			sizes.push_back(shape);
+		}
+		else
+		{
+			std::fprintf(stderr, "Unknown argument: %s\n", a.c_str());
+			return 1;
+		}
+	}
+	if (sizes.empty() && decks.empty())
+	{
+		std::fprintf(stderr, "Usage: dnf_composer_wisdom [SIZE ...] [--deck <deck.json> ...] [--rigor measure|patient]\n"
+		                     "                           [--precision double|single|both] [--dir <directory>]\n");
+		return 1;
+	}
+
+	std::vector<FftPlanShape> shapes;
+	for (const auto& size : sizes)
+	{
+		if (size.rank == 1)
+		{
+			addShape(shapes, size);
+			continue;
+		}
+		for (const Precision precision : precisions)
+		{
+			FftPlanShape shape = size;
+			shape.precision = precision;
+			addShape(shapes, shape);
+		}
+	}
+
+	// A deck's shapes are whatever its elements put in the plan cache at init(), which
+	// covers exactly the ones Auto dispatch sends down the spectral path.
+	for (const auto& deck : decks)
+	{
+		for (const Precision precision : precisions)
+		{
+			const ScopedPrecision scoped(precision);
+			clearFftPlanCache();
+			try
+			{
+				const auto sim = std::make_shared<Simulation>(std::filesystem::path(deck).stem().string());
+				const SimulationFileManager sfm(sim, deck);
+				sfm.loadElementsFromJson();
+				sim->init();
+			}
+			catch (const std::exception& e)
+			{
+				std::fprintf(stderr, "Failed to load deck %s: %s\n", deck.c_str(), e.what());
+				return 1;
+			}
+			for (const auto& shape : cachedFftPlans())
+				addShape(shapes, shape);
+		}
+	}
+	clearFftPlanCache();
+
+	const std::string dir = dirArg.empty() ? defaultFftWisdomDirectory() : dirArg;
+	if (loadFftWisdom(dir))
+		std::printf("Loaded existing wisdom from %s\n", dir.c_str());
+	std::printf("Planning %zu shape(s) at %s:\n", shapes.size(), rigor == PlanRigor::Patient ? "patient" : "measure");
+
+	for (const auto& shape : shapes)
+	{
+		const auto t0 = std::chrono::steady_clock::now();
+		if (shape.rank == 1)
+			prepareFftPlans1D(shape.size_x, rigor);
+		else
+			prepareFftPlans2D(shape.size_x, shape.size_y, shape.precision, rigor);
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+		const std::string name = shape.rank == 1
+			? std::to_string(shape.size_x)
+			: std::to_string(shape.size_x) + "x" + std::to_string(shape.size_y);
+		std::printf("  %-12s %s  %.2f s\n", name.c_str(), toString(shape.precision), seconds);
+		std::fflush(stdout);
+	}
+
+	if (!saveFftWisdom(dir))
+	{
+		std::fprintf(stderr, "Could not write the wisdom files under %s.\n", dir.c_str());
+		return 2;
+	}
+	std::printf("Wrote %s\n", dir.c_str());
+	return 0;
+}
@@ -15,7 +15,7 @@ namespace dnf_composer::element
 		return tools::math::sigmoid(input, steepness, x_shift);
 	}
 
-	void SigmoidFunction::apply(const std::vector<double>& input, std::vector<double>& out) const
+	void SigmoidFunction::apply(std::span<const double> input, std::span<double> out) const
 	{
 		// Full double-precision logistic sigmoid: 1/(1+exp(-s(x-xs))). The exponent is
 		// clamped to [-88, 88] — not the wider [-708, 708] double-exp range. At the
@@ -25,29 +25,11 @@ namespace dnf_composer::element
 		// weights in the downstream convolution, and each denormal costs a microcode
 		// assist (measured: >50x slower on resting-cell-dominated fields). Clamping to
 		// [-88,88] keeps every value a normal double, no FTZ flush needed.
-		const double s  = steepness;
-		const double xs = x_shift;
-		const std::size_t n = input.size();
-
-		// Runtime-dispatched AVX2+FMA path (see simd_dispatch.h) — same clamp,
-		// same formula, ~1e-15-accurate vectorized exp; falls back to the scalar
-		// loop below on pre-AVX2 hosts.
-		if (tools::math::detail::avx2_fma_available())
-		{
-			tools::math::detail::sigmoid_avx2_f64(input.data(), out.data(), n, s, xs);
-			return;
-		}
-
-		for (std::size_t i = 0; i < n; ++i)
-		{
-			double e = -s * (input[i] - xs);
-			if (e < -88.0) {
-				e = -88.0;
-			} else if (e > 88.0) {
-				e = 88.0;
-			}
-			out[i] = 1.0 / (1.0 + std::exp(e));
-		}
+		//
+		// Runtime-dispatched kernel (see simd_dispatch.h): the scalar tier is the
+		// plain loop, the vector tiers the same clamp and formula over a
+		// ~1e-15-accurate vectorized exp.
+		tools::math::detail::simdKernels().sigmoid_f64(input.data(), out.data(), input.size(), steepness, x_shift);
 	}
 
 	bool SigmoidFunction::operator==(const SigmoidFunction& other) const
@@ -99,11 +81,9 @@ namespace dnf_composer::element
 		return tools::math::heaviside(input, x_shift);
 	}
 
-	void HeavisideFunction::apply(const std::vector<double>& input, std::vector<double>& out) const
+	void HeavisideFunction::apply(std::span<const double> input, std::span<double> out) const
 	{
-		for (std::size_t i = 0; i < input.size(); ++i) {
-			out[i] = (input[i] > x_shift) ? 1.0 : 0.0;
-}
+		tools::math::detail::simdKernels().heaviside_f64(input.data(), out.data(), input.size(), x_shift);
 	}
 
 	bool HeavisideFunction::operator==(const HeavisideFunction& other) const
@@ -147,12 +127,9 @@ namespace dnf_composer::element
 		return tools::math::absSigmoid(input, beta, x_shift);
 	}
 
-	void AbsSigmoidFunction::apply(const std::vector<double>& input, std::vector<double>& out) const
+	void AbsSigmoidFunction::apply(std::span<const double> input, std::span<double> out) const
 	{
-		for (std::size_t i = 0; i < input.size(); ++i) {
-			const double diff = input[i] - x_shift;
-			out[i] = 0.5 * (1.0 + beta * diff / (1.0 + beta * std::abs(diff)));
-		}
+		tools::math::detail::simdKernels().abs_sigmoid_f64(input.data(), out.data(), input.size(), beta, x_shift);
 	}
 
 	bool AbsSigmoidFunction::operator==(const AbsSigmoidFunction& other) const
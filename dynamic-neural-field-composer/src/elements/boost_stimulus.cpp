@@ -15,13 +15,13 @@
 		void BoostStimulus::init()
 		{
 			const double value = parameters.isActive ? parameters.amplitude : 0.0;
-			std::fill(components["output"].begin(), components["output"].end(), value);
+			std::fill(components[OUTPUT_SLOT].begin(), components[OUTPUT_SLOT].end(), value);
 		}
 
 		void BoostStimulus::step(double t, double deltaT)
 		{
 			const double value = parameters.isActive ? parameters.amplitude : 0.0;
-			std::fill(components["output"].begin(), components["output"].end(), value);
+			std::fill(components[OUTPUT_SLOT].begin(), components[OUTPUT_SLOT].end(), value);
 		}
 
 		std::string BoostStimulus::toString() const
@@ -18,13 +18,13 @@ namespace dnf_composer::element
 	void BoostStimulus2D::init()
 	{
 		const double value = parameters.isActive ? parameters.amplitude : 0.0;
-		std::ranges::fill(components["output"], value);
+		std::ranges::fill(components[OUTPUT_SLOT], value);
 	}
 
 	void BoostStimulus2D::step(double t, double deltaT)
 	{
 		const double value = parameters.isActive ? parameters.amplitude : 0.0;
-		std::ranges::fill(components["output"], value);
+		std::ranges::fill(components[OUTPUT_SLOT], value);
 	}
 
 	std::string BoostStimulus2D::toString() const
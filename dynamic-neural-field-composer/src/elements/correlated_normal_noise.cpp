@@ -23,7 +23,7 @@ namespace dnf_composer::element
 
 	void CorrelatedNormalNoise::init()
 	{
-		std::ranges::fill(components["output"], 0.0);
+		std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 
 		const int fieldSize = commonParameters.dimensionParameters.size;
 
@@ -47,6 +47,13 @@ namespace dnf_composer::element
 		{
 			extIndex.clear();
 		}
+
+		useFFT_ = tools::math::shouldUseSpectral1D(parameters.circular, kernelSize, fieldSize);
+		if (useFFT_)
+		{
+			spectral_.init(fieldSize);
+			spectral_.setKernel(tools::math::buildWrappedKernel1D(fieldSize, correlationKernel, halfWidth));
+		}
 	}
 
 	void CorrelatedNormalNoise::step(double t, double deltaT)
@@ -56,7 +63,7 @@ namespace dnf_composer::element
 		// Zero amplitude => output is identically zero; skip RNG + convolution.
 		if (parameters.amplitude == 0.0)
 		{
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 			return;
 		}
 
@@ -68,7 +75,12 @@ namespace dnf_composer::element
 		const std::vector<double>& whiteNoise = whiteNoise_;
 
 		std::vector<double> smoothed;
-		if (parameters.circular && !extIndex.empty())
+		if (useFFT_)
+		{
+			smoothed.resize(fieldSize);
+			spectral_.apply(whiteNoise.data(), smoothed.data());
+		}
+		else if (parameters.circular && !extIndex.empty())
 		{
 			const auto extended = tools::math::obtainCircularVector(extIndex, whiteNoise);
 			smoothed = tools::math::conv_valid(extended, correlationKernel);
@@ -80,7 +92,7 @@ namespace dnf_composer::element
 
 		const double scale = parameters.amplitude / std::sqrt(deltaT);
 		for (int i = 0; i < fieldSize; i++) {
-			components["output"][i] = scale * smoothed[i];
+			components[OUTPUT_SLOT][i] = scale * smoothed[i];
 		}
 	}
 
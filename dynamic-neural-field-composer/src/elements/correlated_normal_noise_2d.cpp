@@ -27,7 +27,7 @@ namespace dnf_composer::element
 
 	void CorrelatedNormalNoise2D::init()
 	{
-		std::ranges::fill(components["output"], 0.0);
+		std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 
 		const int size_x = commonParameters.dimensionParameters.size_x;
 		const int size_y = commonParameters.dimensionParameters.size_y;
@@ -69,8 +69,12 @@ namespace dnf_composer::element
 		}
 
 		const int totalSize = size_x * size_y;
-		scratchTmp_.assign(totalSize, 0.0);
-		scratchConv_.assign(totalSize, 0.0);
+		single_ = tools::math::precision() == tools::math::Precision::Single;
+		// Only one precision's result buffers are needed.
+		scratchTmp_.assign(single_ ? 0 : totalSize, 0.0);
+		scratchConv_.assign(single_ ? 0 : totalSize, 0.0);
+		whiteNoise32_.assign(single_ ? totalSize : 0, 0.0f);
+		conv32_.assign(single_ ? totalSize : 0, 0.0f);
 		scratch2d_.ensure(size_x, size_y, extIndex_x.size(), extIndex_y.size());
 
 		const int totalTaps = (kernelRange_x[0] + kernelRange_x[1] + 1)
@@ -78,10 +82,14 @@ namespace dnf_composer::element
 		useFFT_ = tools::math::shouldUseSpectral2D(parameters.circular, totalTaps, size_x, size_y);
 		if (useFFT_)
 		{
-			spectral_.init(size_x, size_y);
+			spectral_.init(size_x, size_y, tools::math::precision());
 			spectral_.setKernel(tools::math::buildWrappedSeparableKernel2D(size_x, size_y,
 				{ tools::math::SeparableKernelTerm2D{ correlationKernel_x, kernelRange_x[0], correlationKernel_y, kernelRange_y[0], +1.0 } }));
 		}
+		else if (single_)
+		{
+			direct32_.setKernel(correlationKernel_x, correlationKernel_y, size_x, size_y, extIndex_x, extIndex_y);
+		}
 	}
 
 	void CorrelatedNormalNoise2D::step(double t, double deltaT)
@@ -93,7 +101,7 @@ namespace dnf_composer::element
 		// Zero amplitude => output is identically zero; skip RNG + convolution.
 		if (parameters.amplitude == 0.0)
 		{
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 			return;
 		}
 
@@ -103,6 +111,25 @@ namespace dnf_composer::element
 		}
 		tools::math::fillNormal(whiteNoise_.data(), static_cast<std::size_t>(totalSize));
 		const std::vector<double>& whiteNoise = whiteNoise_;
+		const double scale = parameters.amplitude / std::sqrt(deltaT);
+		// Hoist the output buffer out of the per-cell loop (unordered_map lookup).
+		double* __restrict out = components[OUTPUT_SLOT].data();
+
+		if (single_)
+		{
+			// The draws stay double, so a seed gives the same noise in either
+			// precision; only their convolution runs in float.
+			std::ranges::copy(whiteNoise, whiteNoise32_.begin());
+			if (useFFT_) {
+				spectral_.apply(whiteNoise32_.data(), conv32_.data());
+			} else {
+				direct32_.apply(whiteNoise32_, conv32_);
+			}
+			for (int i = 0; i < totalSize; ++i) {
+				out[i] = scale * static_cast<double>(conv32_[i]);
+			}
+			return;
+		}
 
 		if (useFFT_) {
 			spectral_.apply(whiteNoise.data(), scratchConv_.data());
@@ -113,9 +140,6 @@ namespace dnf_composer::element
 				size_x, size_y, extIndex_x, extIndex_y);
 		}
 
-		const double scale = parameters.amplitude / std::sqrt(deltaT);
-		// Hoist the output buffer out of the per-cell loop (unordered_map lookup).
-		double* __restrict out = components["output"].data();
 		for (int i = 0; i < totalSize; ++i) {
 			out[i] = scale * scratchConv_[i];
 		}
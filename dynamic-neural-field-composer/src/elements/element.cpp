@@ -1,9 +1,26 @@
 ﻿#include "elements/element.h"
 
+#include <atomic>
 #include <format>
+#include <mutex>
+
+#include "tools/simd_dispatch.h"
 
 namespace dnf_composer::element
 {
+	namespace
+	{
+		// severIncompatibleInputs() is the one connection edit that can happen
+		// from inside step(), i.e. on a scheduler worker. Two consumers of the
+		// same resized source may sever it concurrently, and both erase from
+		// that source's `outputs` map, so serialize the (rare) edit.
+		std::mutex& severMutex()
+		{
+			static std::mutex m;
+			return m;
+		}
+	}
+
 	Element::Element(const ElementCommonParameters& parameters)
 	{
 		// A constructor that cannot establish its invariants must not return a live,
@@ -54,6 +71,7 @@ namespace dnf_composer::element
 			inputPtr = nullptr;
 			inputSize = 0;
 			cachedInputs.clear();
+			bumpConnectionRevision();
 		}
 		return *this;
 	}
@@ -118,6 +136,8 @@ namespace dnf_composer::element
 		inputs[inputElement] = inputComponent;
 		inputElement->outputs[std::weak_ptr<Element>(this->shared_from_this())] = inputComponent;
 		inputPtr = nullptr;
+		bumpConnectionRevision();
+		inputElement->bumpConnectionRevision();
 
 		const std::string logMessage = std::format("Input '{}' added successfully to '{}.", inputElement->getUniqueName(), this->getUniqueName());
 		log(tools::logger::LogLevel::INFO, logMessage);
@@ -129,8 +149,10 @@ namespace dnf_composer::element
 		{
 			if (key->commonParameters.identifiers.uniqueName == inputElementId) {
 				key->outputs.erase(this->shared_from_this());
+				key->bumpConnectionRevision();
 				inputs.erase(key);
 				inputPtr = nullptr;
+				bumpConnectionRevision();
 				log(tools::logger::LogLevel::INFO, std::format("Input '{}' removed successfully from '{}. ",
 				                                   inputElementId, this->getUniqueName()));
 				return;
@@ -144,8 +166,10 @@ namespace dnf_composer::element
 		{
 			if (key->commonParameters.identifiers.uniqueIdentifier == uniqueId) {
 				key->outputs.erase(this->shared_from_this());
+				key->bumpConnectionRevision();
 				inputs.erase(key);
 				inputPtr = nullptr;
+				bumpConnectionRevision();
 				log(tools::logger::LogLevel::INFO, std::format("Input '{}' removed successfully from '{}.",
 				                                   uniqueId, this->getUniqueName()));
 				return;
@@ -178,22 +202,36 @@ namespace dnf_composer::element
 		{
 			const auto inputElement = input_pair.first;
 			inputElement->outputs.erase(this->shared_from_this());
+			inputElement->bumpConnectionRevision();
 		}
 		inputs.clear();
 		inputPtr = nullptr; // cachedInputs_ is now stale; rebuild on next updateInput()
+		bumpConnectionRevision();
 	}
 
 	void Element::buildInputCache()
 	{
-		auto& inputVec = components["input"];
+		auto& inputVec = components[INPUT_SLOT];
 		inputPtr  = inputVec.data();
 		inputSize = inputVec.size();
 
-		cachedInputs.clear();
-		cachedInputs.reserve(inputs.size());
+		// Sum the sources in a fixed order (by name). `inputs` is keyed by pointer,
+		// so iterating it follows heap addresses: the same architecture built twice
+		// could add its inputs in a different order and, through the recurrent
+		// dynamics, drift apart in the last bits. Names are unique per simulation.
+		std::vector<std::pair<std::string, const ComponentBuffer*>> ordered;
+		ordered.reserve(inputs.size());
 		for (const auto& [elem, compName] : inputs)
 		{
-			cachedInputs.push_back(&elem->components.at(compName));
+			ordered.emplace_back(elem->getUniqueName(), &elem->getPublishedComponent(compName));
+		}
+		std::ranges::sort(ordered, {}, &std::pair<std::string, const ComponentBuffer*>::first);
+
+		cachedInputs.clear();
+		cachedInputs.reserve(ordered.size());
+		for (const auto& source : ordered | std::views::values)
+		{
+			cachedInputs.push_back(source);
 		}
 	}
 
@@ -238,7 +276,7 @@ namespace dnf_composer::element
 		}
 		else
 		{
-			const std::vector<double>& first = *cachedInputs[firstIndex];
+			const ComponentBuffer& first = *cachedInputs[firstIndex];
 			const std::size_t n0 = first.size() < inputSize ? first.size() : inputSize;
 			for (std::size_t i = 0; i < n0; ++i) {
 				inputPtr[i] = first[i];
@@ -249,15 +287,13 @@ namespace dnf_composer::element
 
 			for (std::size_t k = firstIndex + 1; k < cachedInputs.size(); ++k)
 			{
-				const std::vector<double>& srcVec = *cachedInputs[k];
+				const ComponentBuffer& srcVec = *cachedInputs[k];
 				if (srcVec.size() > inputSize)
 				{
 					incompatibleSourceFound = true;
 					continue;
 				}
-				for (std::size_t i = 0; i < srcVec.size(); ++i) {
-					inputPtr[i] += srcVec[i];
-				}
+				tools::math::detail::simdKernels().accumulate_f64(inputPtr, srcVec.data(), srcVec.size());
 			}
 		}
 
@@ -266,16 +302,32 @@ namespace dnf_composer::element
 }
 	}
 
+	std::span<const ComponentBuffer* const> Element::inputSources()
+	{
+		if (inputPtr == nullptr) {
+			buildInputCache();
+		}
+		const bool incompatibleSourceFound = std::ranges::any_of(cachedInputs,
+			[this](const ComponentBuffer* source) { return source->size() > inputSize; });
+		if (incompatibleSourceFound)
+		{
+			severIncompatibleInputs();
+			buildInputCache();
+		}
+		return cachedInputs;
+	}
+
 	void Element::severIncompatibleInputs()
 	{
 		std::vector<std::shared_ptr<Element>> toSever;
 		for (const auto& [elem, compName] : inputs)
 		{
-			if (elem->components.at(compName).size() > inputSize) {
+			if (elem->getPublishedComponent(compName).size() > inputSize) {
 				toSever.push_back(elem);
 }
 		}
 
+		const std::lock_guard<std::mutex> lock(severMutex());
 		for (const auto& elem : toSever)
 		{
 			const std::string logMessage = R"(Input ")" + elem->getUniqueName() +
@@ -283,10 +335,12 @@ namespace dnf_composer::element
 				R"(" after being resized; severing the connection.)";
 			log(tools::logger::LogLevel::WARNING, logMessage);
 			elem->outputs.erase(this->shared_from_this());
+			elem->bumpConnectionRevision();
 			inputs.erase(elem);
 		}
 
 		inputPtr = nullptr; // inputs changed; rebuild cache on next updateInput()
+		bumpConnectionRevision();
 	}
 
 	int Element::getMaxSpatialDimension() const
@@ -339,9 +393,11 @@ namespace dnf_composer::element
 			{
 				outputElement->inputs.erase(this->shared_from_this());
 				outputElement->inputPtr = nullptr; // cachedInputs_ is now stale; rebuild on next updateInput()
+				outputElement->bumpConnectionRevision();
 			}
 		}
 		outputs.clear();
+		bumpConnectionRevision();
 	}
 
 	int Element::getSize() const
@@ -356,6 +412,8 @@ namespace dnf_composer::element
 			const auto key = weakKey.lock();
 			if (key && key->commonParameters.identifiers.uniqueIdentifier == uniqueId) {
 				outputs.erase(weakKey);
+				bumpConnectionRevision();
+				key->bumpConnectionRevision();
 				log(tools::logger::LogLevel::INFO, std::format("Output '{}' removed successfully from '{}.",
 				                                   uniqueId, this->getUniqueName()));
 				return;
@@ -370,6 +428,8 @@ namespace dnf_composer::element
 			const auto key = weakKey.lock();
 			if (key && key->commonParameters.identifiers.uniqueName == outputElementId) {
 				outputs.erase(weakKey);
+				bumpConnectionRevision();
+				key->bumpConnectionRevision();
 				log(tools::logger::LogLevel::INFO, std::format("Output '{}' removed successfully from '{}.",
 				                                   outputElementId, this->getUniqueName()));
 				return;
@@ -400,12 +460,12 @@ namespace dnf_composer::element
 	std::vector<double> Element::getComponent(const std::string& componentName)
 	{
 		if (components.contains(componentName)) {
-			return components.at(componentName);
+			return components.at(componentName).toVector();
 }
 		throw Exception(ErrorCode::ELEM_COMP_NOT_FOUND, commonParameters.identifiers.uniqueName, componentName);
 	}
 
-	std::vector<double>* Element::getComponentPtr(const std::string& componentName)
+	ComponentBuffer* Element::getComponentPtr(const std::string& componentName)
 	{
 		if (components.contains(componentName)) {
 			return &components.at(componentName);
@@ -428,7 +488,7 @@ namespace dnf_composer::element
 		return componentNames;
 	}
 
-	const std::unordered_map<std::string, std::vector<double>>* Element::getComponents() const
+	const ComponentTable* Element::getComponents() const
 	{
 		return &components;
 	}
@@ -478,4 +538,108 @@ namespace dnf_composer::element
 		return outputVec;
 	}
 
+	const ComponentBuffer& Element::getPublishedComponent(const std::string& componentName) const
+	{
+		if (const auto front = frontComponents.find(componentName); front != frontComponents.end())
+		{
+			return front->second;
+		}
+		return components.at(componentName);
+	}
+
+	void Element::setFrontBuffered(bool enable)
+	{
+		frontComponents.clear();
+		if (enable)
+		{
+			for (const char* name : { "output", "activation" })
+			{
+				if (const auto it = components.find(name); it != components.end())
+				{
+					frontComponents[name] = it->second;
+				}
+			}
+		}
+
+		// Consumers cached a pointer to whichever buffer getPublishedComponent()
+		// returned when their cache was built; make them look again.
+		pruneExpiredOutputs();
+		for (const auto& weakKey : outputs | std::views::keys)
+		{
+			if (const auto outputElement = weakKey.lock())
+			{
+				outputElement->inputPtr = nullptr;
+			}
+		}
+	}
+
+	void Element::publishFrontBuffers()
+	{
+		for (auto& [name, front] : frontComponents)
+		{
+			// assign(), not swap(): elements keep raw pointers into their own live
+			// components (e.g. NeuralField's act_/inp_), which a swap would
+			// silently redirect at the front buffer.
+			const auto& live = components.at(name);
+			front.assign(live.begin(), live.end());
+		}
+	}
+
+	std::size_t Element::getComponentArenaFootprint() const
+	{
+		return components.arenaFootprint() + frontComponents.arenaFootprint();
+	}
+
+	void Element::bindComponentArena(const std::shared_ptr<ComponentArena>& arena, std::size_t& offset)
+	{
+		components.bindArena(arena, offset);
+		frontComponents.bindArena(arena, offset);
+		invalidateInputCache();
+	}
+
+	void Element::releaseComponentArena()
+	{
+		components.releaseArena();
+		frontComponents.releaseArena();
+		invalidateInputCache();
+	}
+
+	std::vector<std::shared_ptr<Element>> Element::getStepDependencies()
+	{
+		return getInputs();
+	}
+
+	std::vector<std::shared_ptr<Element>> Element::getLiveStepDependencies()
+	{
+		std::vector<std::shared_ptr<Element>> live;
+		for (const auto& [elem, compName] : inputs)
+		{
+			if (!elem->isFrontBuffered(compName))
+			{
+				live.push_back(elem);
+			}
+		}
+		return live;
+	}
+
+	void Element::bumpConnectionRevision()
+	{
+		connectionRevision.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::uint64_t Element::getConnectionRevision() const
+	{
+		return connectionRevision.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t Element::getConnectionRevision(const std::vector<std::shared_ptr<Element>>& elements)
+	{
+		std::uint64_t revision = 0;
+		for (const auto& element : elements)
+		{
+			revision += element->getConnectionRevision();
+		}
+		return revision;
+	}
+
 }
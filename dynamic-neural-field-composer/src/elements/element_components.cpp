@@ -0,0 +1,343 @@
+#include "elements/element_components.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+namespace dnf_composer::element
+{
+	namespace
+	{
+		double* allocateAligned(std::size_t size)
+		{
+			if (size == 0)
+				return nullptr;
+			return static_cast<double*>(::operator new(size * sizeof(double), std::align_val_t{ ComponentArena::ALIGNMENT }));
+		}
+
+		void freeAligned(double* storage)
+		{
+			if (storage != nullptr)
+				::operator delete(storage, std::align_val_t{ ComponentArena::ALIGNMENT });
+		}
+	}
+
+	ComponentArena::ComponentArena(std::size_t size)
+		: storage(allocateAligned(size)), count(size)
+	{
+		std::fill_n(storage, count, 0.0);
+	}
+
+	ComponentArena::~ComponentArena()
+	{
+		freeAligned(storage);
+	}
+
+	ComponentBuffer::ComponentBuffer(size_type size, double value)
+	{
+		assign(size, value);
+	}
+
+	ComponentBuffer::ComponentBuffer(const std::vector<double>& values)
+	{
+		assign(values.data(), values.data() + values.size());
+	}
+
+	ComponentBuffer::ComponentBuffer(const ComponentBuffer& other)
+	{
+		assign(other.begin(), other.end());
+	}
+
+	ComponentBuffer::ComponentBuffer(ComponentBuffer&& other)
+	{
+		*this = std::move(other);
+	}
+
+	ComponentBuffer& ComponentBuffer::operator=(const ComponentBuffer& other)
+	{
+		if (this != &other)
+			assign(other.begin(), other.end());
+		return *this;
+	}
+
+	ComponentBuffer& ComponentBuffer::operator=(ComponentBuffer&& other)
+	{
+		if (this == &other)
+			return *this;
+		detach();
+		if (other.backing && !isArenaBacked())
+		{
+			// Attached storage changes hands along with its owner.
+			if (ownsStorage)
+				freeAligned(storage);
+			storage = std::exchange(other.storage, nullptr);
+			count = std::exchange(other.count, 0);
+			regionSize = std::exchange(other.regionSize, 0);
+			backing = std::move(other.backing);
+			ownsStorage = false;
+			other.ownsStorage = true;
+			return *this;
+		}
+		if (!other.ownsStorage || !ownsStorage)
+		{
+			// Either side is arena-backed: an arena region cannot change hands, so
+			// copy the values (into this buffer's own region when they fit).
+			assign(other.begin(), other.end());
+			return *this;
+		}
+		freeAligned(storage);
+		storage = std::exchange(other.storage, nullptr);
+		count = std::exchange(other.count, 0);
+		regionSize = std::exchange(other.regionSize, 0);
+		return *this;
+	}
+
+	ComponentBuffer& ComponentBuffer::operator=(const std::vector<double>& values)
+	{
+		assign(values.data(), values.data() + values.size());
+		return *this;
+	}
+
+	ComponentBuffer& ComponentBuffer::operator=(std::initializer_list<double> values)
+	{
+		assign(values.begin(), values.end());
+		return *this;
+	}
+
+	ComponentBuffer::~ComponentBuffer()
+	{
+		if (ownsStorage)
+			freeAligned(storage);
+	}
+
+	double& ComponentBuffer::at(size_type i)
+	{
+		if (i >= count)
+			throw std::out_of_range("ComponentBuffer::at");
+		return storage[i];
+	}
+
+	const double& ComponentBuffer::at(size_type i) const
+	{
+		if (i >= count)
+			throw std::out_of_range("ComponentBuffer::at");
+		return storage[i];
+	}
+
+	void ComponentBuffer::reserveFor(size_type size)
+	{
+		if (size <= regionSize)
+			return;
+		double* grown = allocateAligned(size);
+		std::copy_n(storage, count, grown);
+		if (ownsStorage)
+			freeAligned(storage);
+		storage = grown;
+		regionSize = size;
+		ownsStorage = true;
+		backing.reset();
+	}
+
+	void ComponentBuffer::attach(double* values, size_type size, std::shared_ptr<const void> owner)
+	{
+		if (ownsStorage)
+			freeAligned(storage);
+		storage = values;
+		count = size;
+		regionSize = size;
+		ownsStorage = false;
+		backing = std::move(owner);
+	}
+
+	void ComponentBuffer::releaseBacking()
+	{
+		if (!backing)
+			return;
+		double* own = allocateAligned(count);
+		std::copy_n(storage, count, own);
+		storage = own;
+		regionSize = count;
+		ownsStorage = true;
+		backing.reset();
+	}
+
+	void ComponentBuffer::detach()
+	{
+		if (!backing)
+			return;
+		storage = nullptr;
+		count = 0;
+		regionSize = 0;
+		ownsStorage = true;
+		backing.reset();
+	}
+
+	void ComponentBuffer::resize(size_type size, double value)
+	{
+		reserveFor(size);
+		if (size > count)
+			std::fill(storage + count, storage + size, value);
+		count = size;
+	}
+
+	void ComponentBuffer::assign(size_type size, double value)
+	{
+		if (size > regionSize)
+		{
+			count = 0;  // nothing worth copying across
+			reserveFor(size);
+		}
+		std::fill_n(storage, size, value);
+		count = size;
+	}
+
+	void ComponentBuffer::assign(const double* first, const double* last)
+	{
+		const auto size = static_cast<size_type>(last - first);
+		if (size > regionSize)
+		{
+			// first/last may point into this buffer only if size <= count <=
+			// regionSize, so the old storage is never read after it is freed.
+			count = 0;
+			reserveFor(size);
+		}
+		std::copy(first, last, storage);
+		count = size;
+	}
+
+	void ComponentBuffer::push_back(double value)
+	{
+		if (count == regionSize)
+			reserveFor(std::max<size_type>(2 * regionSize, ComponentArena::paddedSize(1)));
+		storage[count++] = value;
+	}
+
+	void ComponentBuffer::bind(double* region, size_type regionCapacity)
+	{
+		std::copy_n(storage, count, region);
+		if (ownsStorage)
+			freeAligned(storage);
+		storage = region;
+		regionSize = regionCapacity;
+		ownsStorage = false;
+	}
+
+	void ComponentBuffer::unbind()
+	{
+		if (ownsStorage || backing)
+			return;
+		double* own = allocateAligned(count);
+		std::copy_n(storage, count, own);
+		storage = own;
+		regionSize = count;
+		ownsStorage = true;
+	}
+
+	bool operator==(const ComponentBuffer& a, const ComponentBuffer& b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end());
+	}
+
+	bool operator==(const ComponentBuffer& a, const std::vector<double>& b)
+	{
+		return std::equal(a.begin(), a.end(), b.begin(), b.end());
+	}
+
+	ComponentTable::ComponentTable(const ComponentTable& other)
+		: entries(other.entries)
+	{
+	}
+
+	ComponentTable& ComponentTable::operator=(const ComponentTable& other)
+	{
+		if (this != &other)
+		{
+			// The keys are const (as in a map), so rebuild rather than assign
+			// entry by entry; the copies own their storage, so drop the arena.
+			entries.clear();
+			for (const auto& [name, values] : other.entries)
+				entries.emplace_back(name, values);
+			arena.reset();
+		}
+		return *this;
+	}
+
+	ComponentBuffer& ComponentTable::operator[](const std::string& name)
+	{
+		if (const auto it = find(name); it != end())
+			return it->second;
+		return entries.emplace_back(name, ComponentBuffer{}).second;
+	}
+
+	ComponentBuffer& ComponentTable::at(const std::string& name)
+	{
+		if (const auto it = find(name); it != end())
+			return it->second;
+		throw std::out_of_range("ComponentTable::at: no component '" + name + "'");
+	}
+
+	const ComponentBuffer& ComponentTable::at(const std::string& name) const
+	{
+		if (const auto it = find(name); it != end())
+			return it->second;
+		throw std::out_of_range("ComponentTable::at: no component '" + name + "'");
+	}
+
+	ComponentSlot ComponentTable::slot(const std::string& name) const
+	{
+		const auto it = find(name);
+		if (it == end())
+			throw std::out_of_range("ComponentTable::slot: no component '" + name + "'");
+		return ComponentSlot{ static_cast<std::uint32_t>(it - begin()) };
+	}
+
+	// A linear scan: an element has a handful of components, and comparing a few
+	// short strings is cheaper than hashing one.
+	ComponentTable::iterator ComponentTable::find(const std::string& name)
+	{
+		return std::ranges::find(entries, name, &value_type::first);
+	}
+
+	ComponentTable::const_iterator ComponentTable::find(const std::string& name) const
+	{
+		return std::ranges::find(entries, name, &value_type::first);
+	}
+
+	void ComponentTable::clear()
+	{
+		entries.clear();
+		arena.reset();
+	}
+
+	std::size_t ComponentTable::arenaFootprint() const
+	{
+		std::size_t total = 0;
+		for (const auto& entry : entries)
+		{
+			if (!entry.second.isExternallyBacked())
+				total += ComponentArena::paddedSize(entry.second.size());
+		}
+		return total;
+	}
+
+	void ComponentTable::bindArena(const std::shared_ptr<ComponentArena>& newArena, std::size_t& offset)
+	{
+		for (auto& entry : entries)
+		{
+			ComponentBuffer& buffer = entry.second;
+			if (buffer.isExternallyBacked())
+				continue;
+			const std::size_t region = ComponentArena::paddedSize(buffer.size());
+			buffer.bind(newArena->data() + offset, region);
+			offset += region;
+		}
+		arena = newArena;
+	}
+
+	void ComponentTable::releaseArena()
+	{
+		for (auto& entry : entries)
+			entry.second.unbind();
+		arena.reset();
+	}
+}
@@ -30,16 +30,16 @@
 				throw Exception(ErrorCode::ELEM_INVALID_SIZE, this->getUniqueName());
 			}
 
-			components["input"].assign(parameters.inputDimensions.size, 0.0);
-			components["output"].assign(commonParameters.dimensionParameters.size, 0.0);
+			components[INPUT_SLOT].assign(parameters.inputDimensions.size, 0.0);
+			components[OUTPUT_SLOT].assign(commonParameters.dimensionParameters.size, 0.0);
 		}
 
 		void Expand::step(double t, double deltaT)
 		{
 			updateInput();
 
-			const auto& in = components["input"];
-			auto& out = components["output"];
+			const auto& in = components[INPUT_SLOT];
+			auto& out = components[OUTPUT_SLOT];
 
 			const bool alongX = parameters.broadcastProfileAxis == ProjectionAxis::X;
 			tools::math::broadcast1DTo2D_into(out, in,
@@ -95,7 +95,7 @@
 			// Size the input buffer to the source's output size before delegating, so the
 			// base size check passes and the input cache is invalidated correctly.
 			parameters.inputDimensions = srcDims;
-			components["input"].assign(inputElement->getComponentPtr("output")->size(), 0.0);
+			components[INPUT_SLOT].assign(inputElement->getComponentPtr("output")->size(), 0.0);
 
 			Element::addInput(inputElement, inputComponent);
 		}
@@ -122,7 +122,7 @@
 			removeInputs();
 			removeOutputs();
 			parameters.inputDimensions = newInputDimensions;
-			components["input"].assign(newInputDimensions.size, 0.0);
+			components[INPUT_SLOT].assign(newInputDimensions.size, 0.0);
 			init();
 		}
 
@@ -1,5 +1,7 @@
 ﻿#include "elements/field_coupling.h"
 #include "tools/utils.h"
+#include "tools/trace.h"
+#include "tools/weight_file.h"
 #include <filesystem>
 #include <format>
 
@@ -15,17 +17,20 @@
 			components["input"] = std::vector<double>(parameters.inputFieldDimensions.size);
 			components["output"] = std::vector<double>(commonParameters.dimensionParameters.size);
 			components["target"] = std::vector<double>(commonParameters.dimensionParameters.size);
-			components["weights"] = std::vector<double>(components.at("input").size()
-				* components.at("output").size());
+			components["weights"] = std::vector<double>(components[INPUT_SLOT].size()
+				* components[OUTPUT_SLOT].size());
 			std::ranges::fill(components["weights"], 0);
+			weightsSlot = components.slot("weights");
+			targetSlot = components.slot("target");
 			weightsDirectory = tools::utils::getResourceRoot() + "/data";
+			applyWeightStorage();
 		}
 
 		void FieldCoupling::init()
 		{
 			parameters.isLearningActive = false;
-			std::ranges::fill(components["input"], 0);
-			std::ranges::fill(components["output"], 0);
+			std::ranges::fill(components[INPUT_SLOT], 0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0);
 			std::ranges::fill(components["target"], 0);
 
 			updateInputField();
@@ -59,13 +64,48 @@
 			return cloned;
 		}
 
+		std::vector<std::shared_ptr<Element>> FieldCoupling::getStepDependencies()
+		{
+			auto dependencies = getInputs();
+			for (auto& downstream : getOutputs())
+			{
+				dependencies.push_back(std::move(downstream));
+			}
+			return dependencies;
+		}
+
+		std::vector<std::shared_ptr<Element>> FieldCoupling::getLiveStepDependencies()
+		{
+			// The target is stored under its slot name ("target"), not the
+			// component it reads, and the learning rules read the downstream
+			// field's activation without an `inputs` entry.
+			std::vector<std::shared_ptr<Element>> live;
+			for (const auto& [elem, slot] : inputs)
+			{
+				if (!elem->isFrontBuffered(parseSlot(slot).second))
+				{
+					live.push_back(elem);
+				}
+			}
+			for (auto& downstream : getOutputs())
+			{
+				if (!downstream->isFrontBuffered("activation"))
+				{
+					live.push_back(std::move(downstream));
+				}
+			}
+			return live;
+		}
+
 		void FieldCoupling::changeDimensions(const ElementDimensions& newDimensions)
 		{
 			commonParameters.dimensionParameters = newDimensions;
-			const int inputSize = static_cast<int>(components["input"].size());
-			components["output"].assign(newDimensions.size, 0.0);
+			const int inputSize = static_cast<int>(components[INPUT_SLOT].size());
+			components[OUTPUT_SLOT].assign(newDimensions.size, 0.0);
 			components["target"].assign(newDimensions.size, 0.0);
 			components["weights"].assign(static_cast<std::size_t>(inputSize) * newDimensions.size, 0.0);
+			sparseWeights = {};
+			applyWeightStorage();
 			// A previously connected target field is now size-mismatched: sever it from
 			// the input graph too, not just the targetField pointer, or updateInput()
 			// keeps summing its stale entry into components["target"].
@@ -79,16 +119,23 @@
 		void FieldCoupling::changeInputDimensions(const ElementDimensions& newInputDimensions)
 		{
 			parameters.inputFieldDimensions = newInputDimensions;
-			const int outputSize = static_cast<int>(components["output"].size());
-			components["input"].assign(newInputDimensions.size, 0.0);
+			const int outputSize = static_cast<int>(components[OUTPUT_SLOT].size());
+			components[INPUT_SLOT].assign(newInputDimensions.size, 0.0);
 			components["weights"].assign(static_cast<std::size_t>(newInputDimensions.size) * outputSize, 0.0);
+			sparseWeights = {};
+			applyWeightStorage();
 			invalidateInputCache(); // "input" was just reallocated
 			init();
 		}
 
 		void FieldCoupling::setParameters(const FieldCouplingParameters& fcp)
 		{
+			const bool storageChanged = fcp.weightStorage != parameters.weightStorage
+				|| fcp.pruneThreshold != parameters.pruneThreshold;
 			parameters = fcp;
+			if (storageChanged) {
+				applyWeightStorage();
+			}
 		}
 
 		void FieldCoupling::setWeightsDirectory(const std::string& dir)
@@ -111,6 +158,32 @@
 			parameters.isLearningActive = learning;
 		}
 
+		void FieldCoupling::setWeightFileFormat(WeightFileFormat format)
+		{
+			weightFileFormat = format;
+		}
+
+		WeightFileFormat FieldCoupling::getWeightFileFormat() const
+		{
+			return weightFileFormat;
+		}
+
+		void FieldCoupling::setVerifyWeightChecksum(bool verify)
+		{
+			verifyWeightChecksum = verify;
+		}
+
+		bool FieldCoupling::getVerifyWeightChecksum() const
+		{
+			return verifyWeightChecksum;
+		}
+
+		std::string FieldCoupling::getWeightsFilename(WeightFileFormat format) const
+		{
+			return weightsDirectory + "/" + commonParameters.identifiers.uniqueName
+				+ (format == WeightFileFormat::BINARY ? "_weights.dnfw" : "_weights.txt");
+		}
+
 		FieldCouplingParameters FieldCoupling::getParameters() const
 		{
 			return parameters;
@@ -126,20 +199,51 @@
 			return targetField;
 		}
 
-		void FieldCoupling::updateOutput()
+		const tools::math::CsrMatrix& FieldCoupling::getSparseWeights() const
+		{
+			return sparseWeights;
+		}
+
+		std::size_t FieldCoupling::getWeightsBytes() const
 		{
-			std::ranges::fill(components["output"], 0.0);
+			return components[weightsSlot].size() * sizeof(double) + sparseWeights.bytes();
+		}
 
-			for (size_t i = 0; i < components["output"].size(); i++)
+		void FieldCoupling::applyWeightStorage()
+		{
+			const bool isSparse = !sparseWeights.rowStart.empty();
+			if (parameters.weightStorage == WeightStorage::SPARSE)
 			{
-				for (size_t j = 0; j < components["input"].size(); j++)
-				{
-					const size_t index = j * components["output"].size() + i;
-					components["output"][i] += parameters.scalar * components["weights"][index] * components["input"][j];
+				if (isSparse) {
+					tools::math::csr_prune(sparseWeights, parameters.pruneThreshold);
+				} else {
+					sparseWeights = tools::math::csr_from_dense(components[weightsSlot],
+						components[INPUT_SLOT].size(), components[OUTPUT_SLOT].size(), parameters.pruneThreshold);
 				}
+				components[weightsSlot] = ComponentBuffer{};
+			}
+			else if (isSparse)
+			{
+				ComponentBuffer& weights = components[weightsSlot];
+				weights.assign(sparseWeights.rows * sparseWeights.cols, 0.0);
+				tools::math::csr_to_dense(sparseWeights, weights);
+				sparseWeights = {};
 			}
 		}
 
+		void FieldCoupling::updateOutput()
+		{
+			ComponentBuffer& out = components[OUTPUT_SLOT];
+			const ComponentBuffer& in = components[INPUT_SLOT];
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+			{
+				tools::math::spmv_into(out, sparseWeights, in, parameters.scalar);
+				return;
+			}
+			const ComponentBuffer& weights = components[weightsSlot];
+			tools::math::gemv_into(out, weights, in, parameters.scalar);
+		}
+
 		std::pair<bool, std::string> FieldCoupling::parseSlot(const std::string& declaredComponent)
 		{
 			if (declaredComponent == "target") {
@@ -217,8 +321,8 @@
 
 		void FieldCoupling::updateInput()
 		{
-			std::ranges::fill(components["input"], 0.0);
-			std::ranges::fill(components["target"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
+			std::ranges::fill(components[targetSlot], 0.0);
 
 			for (const auto& [src, declaredComponent] : inputs)
 			{
@@ -226,8 +330,8 @@
 				// teaching signal itself is read from the source field's own component,
 				// as declared (defaults to "output" for plain "target").
 				const auto [isTarget, sourceComponent] = parseSlot(declaredComponent);
-				const auto& srcVec = src->getComponents()->at(sourceComponent);
-				auto& dst = components[isTarget ? "target" : "input"];
+				const auto& srcVec = src->getPublishedComponent(sourceComponent);
+				auto& dst = components[isTarget ? targetSlot : INPUT_SLOT];
 				const std::size_t n = std::min(srcVec.size(), dst.size());
 				for (std::size_t i = 0; i < n; ++i) {
 					dst[i] += srcVec[i];
@@ -348,6 +452,16 @@
 		}
 
 		void FieldCoupling::updateWeights()
+		{
+			if (parameters.weightStorage == WeightStorage::SPARSE) {
+				updateWeights(sparseWeights);
+			} else {
+				updateWeights(components[weightsSlot]);
+			}
+		}
+
+		template<typename Weights>
+		void FieldCoupling::updateWeights(Weights& weights)
 		{
 			switch (parameters.learningRule)
 			{
@@ -365,10 +479,10 @@
 				// pre/target here are already in their wired range, and normalize()
 				// would map a uniform (e.g. constant) signal to all-zeros, silently
 				// discarding it.
-				tools::math::deltaLearningRuleWidrowHoff(components.at("weights"),
-					input->getComponents()->at(inputSourceComponent), // pre  = g(u_in) or activation
-					components.at("target"),                          // target = g(u_out^tar)
-					components.at("output"),                          // actual = U(x_out,t)
+				tools::math::deltaLearningRuleWidrowHoff(weights,
+					input->getPublishedComponent(inputSourceComponent), // pre  = g(u_in) or activation
+					components[targetSlot],                             // target = g(u_out^tar)
+					components[OUTPUT_SLOT],                            // actual = U(x_out,t)
 					parameters.learningRate, parameters.decayRate);
 				break;
 			}
@@ -379,25 +493,33 @@
 				if (!outputElement) {
 					break; // Output field destroyed since checkValidConnections() last ran; skip this step's update.
 				}
-				std::vector<double> inputActivation = tools::math::normalize(input->getComponents()->at("activation"));
-				std::vector<double> outputActivation = tools::math::normalize(outputElement->getComponents()->at("activation"));
+				std::vector<double> inputActivation = tools::math::normalize(input->getPublishedComponent("activation").toVector());
+				std::vector<double> outputActivation = tools::math::normalize(outputElement->getPublishedComponent("activation").toVector());
 				if (parameters.learningRule == LearningRule::HEBB) {
-					tools::math::hebbLearningRule(components["weights"], inputActivation, outputActivation, parameters.learningRate);
+					tools::math::hebbLearningRule(weights, inputActivation, outputActivation, parameters.learningRate);
 				} else {
-					tools::math::ojaLearningRule(components["weights"], inputActivation, outputActivation, parameters.learningRate);
+					tools::math::ojaLearningRule(weights, inputActivation, outputActivation, parameters.learningRate);
 }
 				break;
 			}
 			}
 		}
 
-		void FieldCoupling::readWeights()
+		bool FieldCoupling::readWeights()
+		{
+			const std::string binaryFilename = getWeightsFilename(WeightFileFormat::BINARY);
+			if (std::filesystem::exists(binaryFilename)) {
+				return readBinaryWeights(binaryFilename);
+			}
+			return readTextWeights(getWeightsFilename(WeightFileFormat::TEXT));
+		}
+
+		bool FieldCoupling::readTextWeights(const std::string& filename)
 		{
-			const std::string filename = weightsDirectory + "/" + commonParameters.identifiers.uniqueName + "_weights.txt";
 			std::ifstream file(filename);
 
-			const size_t inputSize = components.at("input").size();
-			const size_t outputSize = components.at("output").size();
+			const size_t inputSize = components[INPUT_SLOT].size();
+			const size_t outputSize = components[OUTPUT_SLOT].size();
 			const size_t expectedSize = inputSize * outputSize;
 
 			if (file.is_open()) 
@@ -418,24 +540,86 @@
 					log(tools::logger::LogLevel::ERROR, std::format(
 						"Weight matrix read from file has a different size than expected! Expected: {}, Got: {}",
 						expectedSize, weights.size()));
-					return;
+					return false;
 				}
 
 				components["weights"] = weights;
+				if (parameters.weightStorage == WeightStorage::SPARSE)
+				{
+					sparseWeights = {};
+					applyWeightStorage();
+				}
+				weightFileFormat = WeightFileFormat::TEXT;
 
 				const std::string message = std::format("Weights '{}' read successfully from: {}.", this->getUniqueName(), filename);
 				log(tools::logger::LogLevel::INFO, message);
+				return true;
 			}
-			else {
-				const std::string message = std::format("Failed to read weights '{}' from: {}.", this->getUniqueName(), filename);
-				log(tools::logger::LogLevel::ERROR, message);
+			const std::string message = std::format("Failed to read weights '{}' from: {}.", this->getUniqueName(), filename);
+			log(tools::logger::LogLevel::ERROR, message);
+			return false;
+		}
+
+		bool FieldCoupling::readBinaryWeights(const std::string& filename)
+		{
+			const size_t inputSize = components[INPUT_SLOT].size();
+			const size_t outputSize = components[OUTPUT_SLOT].size();
+			try
+			{
+				auto file = std::make_shared<const tools::weight_file::MappedWeightFile>(
+					filename, tools::MappedFile::Access::CopyOnWrite);
+				if (file->rows() != inputSize || file->cols() != outputSize)
+				{
+					log(tools::logger::LogLevel::ERROR, std::format(
+						"Weight matrix read from file has a different size than expected! Expected: {}x{}, Got: {}x{}",
+						inputSize, outputSize, file->rows(), file->cols()));
+					return false;
+				}
+				if (verifyWeightChecksum && !file->verifyChecksum())
+				{
+					log(tools::logger::LogLevel::ERROR, std::format(
+						"Weights '{}' in {} fail their checksum; the file is corrupt. Weights left unchanged.",
+						this->getUniqueName(), filename));
+					return false;
+				}
+
+				// Straight from the mapping into the storage in use: a sparse
+				// coupling never materializes the dense matrix, and a dense file
+				// becomes the dense weights' storage, paged in as it is used.
+				if (parameters.weightStorage == WeightStorage::SPARSE)
+				{
+					sparseWeights = file->toCsr(parameters.pruneThreshold);
+					components[weightsSlot] = ComponentBuffer{};
+				}
+				else if (file->layout() == tools::weight_file::WeightLayout::Dense)
+				{
+					const std::span<double> values = file->mutableDense();
+					components[weightsSlot].attach(values.data(), values.size(), std::move(file));
+					mappedWeightsFile = filename;
+				}
+				else
+				{
+					ComponentBuffer weights(inputSize * outputSize, 0.0);
+					file->copyDenseInto(weights);
+					components[weightsSlot] = std::move(weights);
+				}
+			}
+			catch (const std::exception& e)
+			{
+				log(tools::logger::LogLevel::ERROR, std::format(
+					"Failed to read weights '{}' from: {}. {}", this->getUniqueName(), filename, e.what()));
+				return false;
 			}
+			weightFileFormat = WeightFileFormat::BINARY;
+			log(tools::logger::LogLevel::INFO, std::format(
+				"Weights '{}' read successfully from: {}.", this->getUniqueName(), filename));
+			return true;
 		}
 
 		void FieldCoupling::tryReadWeights()
 		{
-			const std::string filename = weightsDirectory + "/" + commonParameters.identifiers.uniqueName + "_weights.txt";
-			if (std::filesystem::exists(filename))
+			const std::string filename = getWeightsFilename(WeightFileFormat::TEXT);
+			if (std::filesystem::exists(getWeightsFilename(WeightFileFormat::BINARY)) || std::filesystem::exists(filename))
 			{
 				readWeights();
 			}
@@ -447,22 +631,71 @@
 			}
 		}
 
-		void FieldCoupling::writeWeights() const
+		void FieldCoupling::releaseWeightsFile()
+		{
+			components[weightsSlot].releaseBacking();
+		}
+
+		void FieldCoupling::releaseWeightsFileAt(const std::string& filename)
+		{
+			std::error_code ec;
+			if (components[weightsSlot].isExternallyBacked() && std::filesystem::equivalent(mappedWeightsFile, filename, ec))
+			{
+				releaseWeightsFile();
+			}
+		}
+
+		void FieldCoupling::writeWeights()
 		{
-			const std::string filename = weightsDirectory + "/" + commonParameters.identifiers.uniqueName + "_weights.txt";
+			const tools::trace::Span span("FieldCoupling::writeWeights", "weights");
+			if (weightFileFormat == WeightFileFormat::BINARY)
+			{
+				const std::string filename = getWeightsFilename(WeightFileFormat::BINARY);
+				releaseWeightsFileAt(filename);
+				try
+				{
+					if (parameters.weightStorage == WeightStorage::SPARSE) {
+						tools::weight_file::writeCsr(filename, sparseWeights);
+					} else {
+						tools::weight_file::writeDense(filename, components[weightsSlot],
+							components[INPUT_SLOT].size(), components[OUTPUT_SLOT].size());
+					}
+				}
+				catch (const std::exception& e)
+				{
+					log(tools::logger::LogLevel::ERROR, std::format(
+						"Failed to save weights '{}' to: {}. {}", this->getUniqueName(), filename, e.what()));
+					return;
+				}
+				log(tools::logger::LogLevel::INFO, std::format("Saved weights '{}' to: {}.", this->getUniqueName(), filename));
+				return;
+			}
+
+			const std::string filename = getWeightsFilename(WeightFileFormat::TEXT);
 			std::ofstream file(filename);
 
 			if (file.is_open()) 
 			{
-				const size_t inputSize = components.at("input").size();
-				const size_t outputSize = components.at("output").size();
+				const size_t inputSize = components[INPUT_SLOT].size();
+				const size_t outputSize = components[OUTPUT_SLOT].size();
+
+				// Sparse weights are written densely, so the file reads back into
+				// either storage mode.
+				std::vector<double> densified;
+				std::span<const double> weights = components.at("weights");
+				if (parameters.weightStorage == WeightStorage::SPARSE)
+				{
+					densified.resize(inputSize * outputSize);
+					tools::math::csr_to_dense(sparseWeights, densified);
+					weights = densified;
+				}
 
 				for (size_t i = 0; i < inputSize; i++) 
 				{
 					for (size_t j = 0; j < outputSize; j++) 
 					{
 						const size_t index = i * outputSize + j;
-						file << components.at("weights")[index] << " ";
+						file << weights[index] << " ";
 					}
 					file << '\n';
 				}
@@ -471,6 +704,19 @@
 
 				const std::string message = std::format("Saved weights '{}' to: {}.", this->getUniqueName(), filename);
 				log(tools::logger::LogLevel::INFO, message);
+
+				// readWeights() prefers a binary file; one left over from an
+				// earlier save would shadow what was just written.
+				const std::string binaryFilename = getWeightsFilename(WeightFileFormat::BINARY);
+				releaseWeightsFileAt(binaryFilename);
+				std::error_code ec;
+				std::filesystem::remove(binaryFilename, ec);
+				if (ec)
+				{
+					log(tools::logger::LogLevel::ERROR, std::format(
+						"Could not remove {} ({}); readWeights() will load it instead of the weights '{}' just saved to {}.",
+						binaryFilename, ec.message(), this->getUniqueName(), filename));
+				}
 			}
 			else {
 				const std::string message = std::format("Failed to save weights '{}' to: {}.", this->getUniqueName(), filename);
@@ -480,7 +726,10 @@
 
 		void FieldCoupling::clearWeights()
 		{
-			components["weights"] = std::vector<double>(components["weights"].size(), 0);
+			// A fresh buffer rather than zeroing in place, which would copy every
+			// page of a mapped weight file just to overwrite it.
+			components["weights"] = ComponentBuffer(components["weights"].size(), 0.0);
+			std::ranges::fill(sparseWeights.values, 0.0);
 		}
 
 		bool FieldCoupling::checkValidConnections()
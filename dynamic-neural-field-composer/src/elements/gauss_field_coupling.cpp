@@ -6,6 +6,49 @@
 
 	namespace dnf_composer::element
 	{
+		namespace
+		{
+			// Cutoff of the ANALYTIC profiles, in widths: the cutOfFactor the
+			// kernels pass to computeKernelRange().
+			constexpr double kAnalyticCutoff = 5.0;
+
+			// exp(-d² / 2σ²) for the cells within kAnalyticCutoff·σ of mu on an axis
+			// of `size` cells, with d measured as gaussian_2d()/gaussian_2d_periodic()
+			// measure it. Returns the cell of profile[0]; a circular profile may run
+			// past the last cell and continue at 0.
+			int gaussProfile(std::vector<double>& profile, double mu, double sigma, int size, bool circular)
+			{
+				const int radius = static_cast<int>(std::ceil(kAnalyticCutoff * sigma));
+				const int centre = static_cast<int>(std::lround(mu));
+				int first = centre - radius;
+				int last = centre + radius;
+				if (!circular) {
+					first = std::max(first, 0);
+					last = std::min(last, size - 1);
+				} else if (last - first + 1 >= size) {
+					first = 0;
+					last = size - 1;
+				}
+
+				profile.clear();
+				if (last < first) {
+					return 0;
+}
+				profile.reserve(static_cast<std::size_t>(last - first) + 1);
+				for (int k = first; k <= last; ++k)
+				{
+					double d = k - mu;
+					if (circular)
+					{
+						const int cell = (k % size + size) % size;
+						d = std::min(std::abs(cell - mu), size - std::abs(cell - mu));
+					}
+					profile.push_back(std::exp(-(std::pow(d, 2) / (2 * std::pow(sigma, 2)))));
+				}
+				return circular ? (first % size + size) % size : first;
+			}
+		}
+
 		GaussFieldCoupling::GaussFieldCoupling(const ElementCommonParameters& elementCommonParameters, 
 			GaussFieldCouplingParameters  gfc_parameters)
 			: Element(elementCommonParameters), parameters(std::move(gfc_parameters))
@@ -13,24 +56,41 @@
 			commonParameters.identifiers.label = ElementLabel::GAUSS_FIELD_COUPLING;
 			components["input"] = std::vector<double>(parameters.inputFieldDimensions.size);
 			components["output"] = std::vector<double>(commonParameters.dimensionParameters.size);
-			components["weights"] = std::vector<double>(components.at("input").size() * components.at("output").size());
+			// ANALYTIC mode never holds the matrix, so don't allocate it here either.
+			const std::size_t weightsSize = parameters.evaluation == GaussCouplingEvaluation::DENSE
+				? components[INPUT_SLOT].size() * components[OUTPUT_SLOT].size() : 0;
+			components["weights"] = std::vector<double>(weightsSize);
+			weightsSlot = components.slot("weights");
 		}
 
 		void GaussFieldCoupling::init()
 		{
 			updateInputFieldDimensions();
 
-			std::ranges::fill(components["input"], 0);
-			std::ranges::fill(components["output"], 0);
-			std::ranges::fill(components["weights"], 0);
+			std::ranges::fill(components[INPUT_SLOT], 0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0);
+
+			if (parameters.evaluation == GaussCouplingEvaluation::ANALYTIC)
+			{
+				components[weightsSlot] = ComponentBuffer{};
+				buildSeparableCouplings();
+			}
+			else
+			{
+				separableCouplings.clear();
+				buildDenseWeights();
+			}
+		}
 
-			const unsigned int cols = static_cast<int>(components["output"].size());
-			const unsigned int rows = static_cast<int>(components["input"].size());
+		void GaussFieldCoupling::buildDenseWeights()
+		{
+			const unsigned int cols = static_cast<int>(components[OUTPUT_SLOT].size());
+			const unsigned int rows = static_cast<int>(components[INPUT_SLOT].size());
+			components[weightsSlot].assign(static_cast<std::size_t>(rows) * cols, 0.0);
+			double* weights = components[weightsSlot].data();
 
 			for (unsigned int i = 0; i < cols; i++)
 			{
-				std::vector<double> col;
-				col.reserve(rows);
 				for (unsigned int j = 0; j < rows; j++)
 				{
 					double value = 0.0;
@@ -52,11 +112,37 @@
 }
 					}
 					const size_t index = j * cols + i;
-					components["weights"][index] = value;
+					weights[index] = value;
 				}
 			}
 		}
 
+		void GaussFieldCoupling::buildSeparableCouplings()
+		{
+			const int rows = static_cast<int>(components[INPUT_SLOT].size());
+			const int cols = static_cast<int>(components[OUTPUT_SLOT].size());
+
+			separableCouplings.clear();
+			separableCouplings.reserve(parameters.couplings.size());
+			for (const auto& coupling : parameters.couplings)
+			{
+				double amplitude = coupling.amplitude;
+				if (parameters.normalized) {
+					amplitude /= sqrt(2 * std::numbers::pi * std::pow(coupling.width, 2));
+}
+
+				SeparableCoupling separable;
+				separable.inputFirst = gaussProfile(separable.inputProfile,
+					coupling.x_i / parameters.inputFieldDimensions.d_x, coupling.width, rows, parameters.circular);
+				separable.outputFirst = gaussProfile(separable.outputProfile,
+					coupling.x_j / commonParameters.dimensionParameters.d_x, coupling.width, cols, parameters.circular);
+				for (double& value : separable.outputProfile) {
+					value *= amplitude;
+}
+				separableCouplings.push_back(std::move(separable));
+			}
+		}
+
 		void GaussFieldCoupling::step(double t, double deltaT)
 		{
 			updateInput();
@@ -79,14 +165,51 @@
 
 		void GaussFieldCoupling::updateOutput()
 		{
-			std::ranges::fill(components["output"], 0.0);
+			ComponentBuffer& out = components[OUTPUT_SLOT];
+			const ComponentBuffer& in = components[INPUT_SLOT];
+			if (parameters.evaluation == GaussCouplingEvaluation::ANALYTIC)
+			{
+				updateOutputAnalytic();
+				return;
+			}
 
-			for (size_t i = 0; i < components["output"].size(); i++)
+			const ComponentBuffer& weights = components[weightsSlot];
+			// (1.0 * w) * x == w * x exactly, so this is the unscaled product.
+			tools::math::gemv_into(out, weights, in, 1.0);
+		}
+
+		void GaussFieldCoupling::updateOutputAnalytic()
+		{
+			ComponentBuffer& out = components[OUTPUT_SLOT];
+			const ComponentBuffer& in = components[INPUT_SLOT];
+			const int inputSize = static_cast<int>(in.size());
+			const int outputSize = static_cast<int>(out.size());
+			std::ranges::fill(out, 0.0);
+
+			// output = sum_c outputProfile_c * (inputProfile_c · input). A profile is
+			// never longer than its axis, so a wrapped index needs one subtraction.
+			for (const auto& coupling : separableCouplings)
 			{
-				for (size_t j = 0; j < components["input"].size(); j++)
+				double drive = 0.0;
+				int index = coupling.inputFirst;
+				for (const double value : coupling.inputProfile)
+				{
+					drive += value * in[index];
+					if (++index == inputSize) {
+						index = 0;
+}
+				}
+				if (drive == 0.0) {
+					continue;
+}
+
+				index = coupling.outputFirst;
+				for (const double value : coupling.outputProfile)
 				{
-					const size_t index = j * components["output"].size() + i;
-					components["output"][i] += components["weights"][index] * components["input"][j];
+					out[index] += value * drive;
+					if (++index == outputSize) {
+						index = 0;
+}
 				}
 			}
 		}
@@ -104,18 +227,14 @@
 		void GaussFieldCoupling::changeDimensions(const ElementDimensions& newDimensions)
 		{
 			commonParameters.dimensionParameters = newDimensions;
-			const int inputSize = static_cast<int>(components["input"].size());
-			components["output"].assign(newDimensions.size, 0.0);
-			components["weights"].assign(static_cast<std::size_t>(inputSize) * newDimensions.size, 0.0);
+			components[OUTPUT_SLOT].assign(newDimensions.size, 0.0);
 			init();
 		}
 
 		void GaussFieldCoupling::changeInputDimensions(const ElementDimensions& newInputDimensions)
 		{
 			parameters.inputFieldDimensions = newInputDimensions;
-			const int outputSize = static_cast<int>(components["output"].size());
-			components["input"].assign(newInputDimensions.size, 0.0);
-			components["weights"].assign(static_cast<std::size_t>(newInputDimensions.size) * outputSize, 0.0);
+			components[INPUT_SLOT].assign(newInputDimensions.size, 0.0);
 			init();
 		}
 
@@ -18,13 +18,14 @@
 			if (parameters.circular)
 			{
 				extIndex = tools::math::createExtendedIndex(commonParameters.dimensionParameters.size, kernelRange);
-				components["input"].resize(extIndex.size()); 
+				components[INPUT_SLOT].resize(extIndex.size()); 
 			}
 			else
 			{
 				extIndex = {};
-				components["input"].resize(commonParameters.dimensionParameters.size);
+				components[INPUT_SLOT].resize(commonParameters.dimensionParameters.size);
 			}
+			invalidateInputCache(); // "input" may just have been reallocated
 
 			int rangeXsize = kernelRange[0] + kernelRange[1] + 1;
 			std::vector<int> rangeX(rangeXsize);
@@ -45,31 +46,43 @@
 			 
 			scratchExtended.assign(extIndex.empty() ? 0 : extIndex.size(), 0.0);
 			scratchConvolution.assign(commonParameters.dimensionParameters.size, 0.0);
+
+			const int size = commonParameters.dimensionParameters.size;
+			useFFT_ = tools::math::shouldUseSpectral1D(parameters.circular,
+				static_cast<int>(components[kernelSlot].size()), size);
+			if (useFFT_)
+			{
+				spectral_.init(size);
+				spectral_.setKernel(tools::math::buildWrappedKernel1D(size, components[kernelSlot], kernelRange[0]));
+			}
+
 			fullSum = 0.0;
-			std::ranges::fill(components["input"], 0.0);
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 		}
 
 		void GaussKernel::step(double t, double deltaT)
 		{
 			updateInput();
 
-			const auto& inp = components["input"];
+			const auto& inp = components[INPUT_SLOT];
 			// Skip the O(N) accumulate when amplitudeGlobal == 0 (globalOffset would
 			// be 0 either way) — mirrors the same guard in GaussKernel2D::step.
 			const bool hasGlobal = parameters.amplitudeGlobal != 0.0;
 			fullSum = hasGlobal ? std::accumulate(inp.begin(), inp.begin() + commonParameters.dimensionParameters.size,
 				0.0) : 0.0;
 
-			if (parameters.circular) {
+			if (useFFT_) {
+				spectral_.apply(inp.data(), scratchConvolution.data());
+			} else if (parameters.circular) {
 				tools::math::obtainCircularVector_into(scratchExtended, extIndex, inp);
-				tools::math::conv_valid_into(scratchConvolution, scratchExtended, components["kernel"]);
+				tools::math::conv_valid_into(scratchConvolution, scratchExtended, components[kernelSlot]);
 			} else {
-				tools::math::conv_same_into(scratchConvolution, inp, components["kernel"]);
+				tools::math::conv_same_into(scratchConvolution, inp, components[kernelSlot]);
 			}
 
 			const double globalOffset = parameters.amplitudeGlobal * fullSum;
-			auto& out = components["output"];
+			auto& out = components[OUTPUT_SLOT];
 			for (int i = 0; i < static_cast<int>(out.size()); i++) {
 				out[i] = scratchConvolution[i] + globalOffset;
 }
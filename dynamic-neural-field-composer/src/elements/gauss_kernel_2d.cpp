@@ -18,6 +18,8 @@
 
 		void GaussKernel2D::init()
 		{
+			resetSpectrumSharing();
+
 			const int size_x = commonParameters.dimensionParameters.size_x;
 			const int size_y = commonParameters.dimensionParameters.size_y;
 
@@ -68,8 +70,11 @@
 }
 
 			const int totalSize = size_x * size_y;
-			scratchTmp_.assign(totalSize, 0.0);
-			scratchConvolution_.assign(totalSize, 0.0);
+			single_ = tools::math::precision() == tools::math::Precision::Single;
+			// Only one precision's result buffers are needed.
+			scratchTmp_.assign(single_ ? 0 : totalSize, 0.0);
+			scratchConvolution_.assign(single_ ? 0 : totalSize, 0.0);
+			convolution32_.assign(single_ ? totalSize : 0, 0.0f);
 			scratch2d_.ensure(size_x, size_y, extIndex_x.size(), extIndex_y.size());
 
 			const int totalTaps = (kernelRange_x[0] + kernelRange_x[1] + 1)
@@ -77,22 +82,26 @@
 			useFFT_ = tools::math::shouldUseSpectral2D(parameters.circular, totalTaps, size_x, size_y);
 			if (useFFT_)
 			{
-				spectral_.init(size_x, size_y);
+				spectral_.init(size_x, size_y, tools::math::precision());
 				spectral_.setKernel(tools::math::buildWrappedSeparableKernel2D(size_x, size_y,
 					{ tools::math::SeparableKernelTerm2D{ kernel_1d_x, kernelRange_x[0], kernel_1d_y, kernelRange_y[0], +1.0 } }));
 			}
+			else if (single_)
+			{
+				direct32_.setKernel(kernel_1d_x, kernel_1d_y, size_x, size_y, extIndex_x, extIndex_y);
+			}
 
 			fullSum = 0.0;
-			std::ranges::fill(components["input"], 0.0);
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 		}
 
 		void GaussKernel2D::step(double t, double deltaT)
 		{
 			updateInput();
 
-			const std::vector<double>& input = components["input"];
-			std::vector<double>& output = components["output"];
+			const ComponentBuffer& input = components[INPUT_SLOT];
+			ComponentBuffer& output = components[OUTPUT_SLOT];
 
 			// The global offset (amplitudeGlobal * sum-of-input) is only needed when
 			// amplitudeGlobal != 0. Skip the O(N) accumulate and the per-cell add when
@@ -103,29 +112,25 @@
 			const int size_x = commonParameters.dimensionParameters.size_x;
 			const int size_y = commonParameters.dimensionParameters.size_y;
 
+			if (single_) {
+				if (useFFT_) {
+					convolveSpectrally2D(spectral_, input, convolution32_.data());
+				} else {
+					direct32_.apply(singleInput(input), convolution32_);
+				}
+				writeOutput(output, convolution32_, hasGlobal, parameters.amplitudeGlobal * fullSum);
+				return;
+			}
+
 			if (useFFT_) {
-				spectral_.apply(input.data(), scratchConvolution_.data());
+				convolveSpectrally2D(spectral_, input, scratchConvolution_.data());
 			} else {
 				tools::math::conv2d_separable_into(
 					scratchConvolution_, scratchTmp_, scratch2d_,
 					input, kernel_1d_x, kernel_1d_y,
 					size_x, size_y, extIndex_x, extIndex_y);
 			}
-
-			const int n = static_cast<int>(output.size());
-			if (hasGlobal)
-			{
-				const double globalOffset = parameters.amplitudeGlobal * fullSum;
-				for (int i = 0; i < n; ++i) {
-					output[i] = scratchConvolution_[i] + globalOffset;
-				}
-			}
-			else
-			{
-				for (int i = 0; i < n; ++i) {
-					output[i] = scratchConvolution_[i];
-				}
-			}
+			writeOutput(output, scratchConvolution_, hasGlobal, parameters.amplitudeGlobal * fullSum);
 		}
 
 		std::string GaussKernel2D::toString() const
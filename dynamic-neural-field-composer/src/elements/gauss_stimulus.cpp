@@ -31,14 +31,14 @@
 
 			if (!parameters.normalized) {
 				for (int i = 0; i < commonParameters.dimensionParameters.size; i++) {
-					components["output"][i] = parameters.amplitude * g[i];
+					components[OUTPUT_SLOT][i] = parameters.amplitude * g[i];
 }
 			} else
 			{
 				const double sum = tools::math::calculateVectorSum(g);
 				if(sum != 0.0) {
 					for (int i = 0; i < commonParameters.dimensionParameters.size; i++) {
-						components["output"][i] = parameters.amplitude * g[i] / sum;
+						components[OUTPUT_SLOT][i] = parameters.amplitude * g[i] / sum;
 }
 				} else
 				{
@@ -49,10 +49,10 @@
 				}
 			}
 
-			std::ranges::fill(components["input"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
 			updateInput();
 			for (int i = 0; i < commonParameters.dimensionParameters.size; i++) {
-				components["output"][i] += components["input"][i];
+				components[OUTPUT_SLOT][i] += components[INPUT_SLOT][i];
 }
 		}
 
@@ -48,14 +48,14 @@
 							parameters.position_x, parameters.position_y,
 							parameters.width, parameters.width, 1.0);
 }
-					components["output"][yi * size_x + xi] = val;
+					components[OUTPUT_SLOT][yi * size_x + xi] = val;
 					sum += val;
 				}
 			}
 
 			if (!parameters.normalized)
 			{
-				for (auto& v : components["output"]) {
+				for (auto& v : components[OUTPUT_SLOT]) {
 					v *= parameters.amplitude;
 }
 			}
@@ -63,7 +63,7 @@
 			{
 				if (sum > 1e-12)
 				{
-					for (auto& v : components["output"]) {
+					for (auto& v : components[OUTPUT_SLOT]) {
 						v = parameters.amplitude * v / sum;
 }
 				}
@@ -76,11 +76,11 @@
 				}
 			}
 
-			std::ranges::fill(components["input"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
 			updateInput();
 			const int totalSize = size_x * size_y;
 			for (int i = 0; i < totalSize; ++i) {
-				components["output"][i] += components["input"][i];
+				components[OUTPUT_SLOT][i] += components[INPUT_SLOT][i];
 }
 		}
 
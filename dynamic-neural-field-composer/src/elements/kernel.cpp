@@ -1,5 +1,9 @@
 ﻿#include "elements/kernel.h"
 
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
 
 	namespace dnf_composer::element
 	{
@@ -12,6 +16,126 @@
 			fullSum = 0.0;
 			cutOfFactor = 5;
 			components["kernel"] = std::vector<double>(commonParameters.dimensionParameters.size);
+			kernelSlot = components.slot("kernel");
+		}
+
+		namespace
+		{
+			std::atomic<std::uint64_t> spectralRevision{ 0 };
+		}
+
+		Kernel::Kernel(const Kernel& other)
+			: Element(other), kernelRange(other.kernelRange), extIndex(other.extIndex),
+			  fullSum(other.fullSum), cutOfFactor(other.cutOfFactor), kernelSlot(other.kernelSlot)
+		{
+		}
+
+		Kernel& Kernel::operator=(const Kernel& other)
+		{
+			if (this != &other)
+			{
+				Element::operator=(other);
+				kernelRange = other.kernelRange;
+				extIndex = other.extIndex;
+				fullSum = other.fullSum;
+				cutOfFactor = other.cutOfFactor;
+				kernelSlot = other.kernelSlot;
+				resetSpectrumSharing();
+			}
+			return *this;
+		}
+
+		void Kernel::resetSpectrumSharing()
+		{
+			sharedSpectrum = nullptr;
+			sharedSource = nullptr;
+			fusedSpectral.reset();
+			fusedAway = false;
+			spectralRevision.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Kernel::convolveSpectrally2D(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, double* out)
+		{
+			convolveSpectrally2DInto(spectral, input, out);
+		}
+
+		void Kernel::convolveSpectrally2D(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, float* out)
+		{
+			convolveSpectrally2DInto(spectral, input, out);
+		}
+
+		template<typename T>
+		void Kernel::convolveSpectrally2DInto(tools::math::SpectralConvolver2D& spectral,
+			const ComponentBuffer& input, T* out)
+		{
+			if (fusedAway)
+			{
+				std::fill_n(out, input.size(), T(0));
+				return;
+			}
+
+			tools::math::SpectralConvolver2D& convolver = fusedSpectral ? *fusedSpectral : spectral;
+			// The binding is re-validated by Simulation before every step; this
+			// only guards a kernel stepped on its own after being rewired.
+			if (sharedSpectrum != nullptr && sharedSpectrum->matches(convolver))
+			{
+				const auto sources = inputSources();
+				if (sources.size() == 1 && sources.front() == sharedSource)
+				{
+					sharedSpectrum->forward(sharedSource->data());
+					convolver.applySpectrum(*sharedSpectrum, out);
+					return;
+				}
+			}
+			if constexpr (std::is_same_v<T, float>) {
+				convolver.apply(singleInput(input).data(), out);
+			} else {
+				convolver.apply(input.data(), out);
+			}
+		}
+
+		std::span<const float> Kernel::singleInput(const ComponentBuffer& input)
+		{
+			if (inputs.size() == 1)
+			{
+				const auto& [source, componentName] = *inputs.begin();
+				// A front-buffered source publishes last step's output, which the
+				// float copy (always the live one) is not.
+				if (componentName == "output" && !source->isFrontBuffered(componentName))
+				{
+					const std::span<const float> copy = source->getSingleOutput();
+					if (copy.size() == input.size()) {
+						return copy;
+					}
+				}
+			}
+
+			singleInput_.resize(input.size());
+			std::ranges::copy(input, singleInput_.begin());
+			return singleInput_;
+		}
+
+		void Kernel::bindSharedSpectrum(tools::math::SharedSpectrum2D* spectrum, const ComponentBuffer* source)
+		{
+			sharedSpectrum = spectrum;
+			sharedSource = spectrum != nullptr ? source : nullptr;
+		}
+
+		void Kernel::setFusedSpectral(std::unique_ptr<tools::math::SpectralConvolver2D> fused)
+		{
+			fusedSpectral = std::move(fused);
+		}
+
+		void Kernel::setFusedAway(bool away)
+		{
+			fusedAway = away;
+		}
+
+		std::uint64_t Kernel::getSpectralRevision()
+		{
+			return spectralRevision.load(std::memory_order_relaxed);
 		}
 
 		std::array<int, 2> Kernel::getKernelRange() const
@@ -1,6 +1,7 @@
 ﻿#include <utility>
 
 #include "elements/memory_trace.h"
+#include "tools/simd_dispatch.h"
 
 
 	namespace dnf_composer::element
@@ -14,8 +15,8 @@
 
 		void MemoryTrace::init()
 		{
-			std::fill(components["input"].begin(),  components["input"].end(),  0.0);
-			std::fill(components["output"].begin(), components["output"].end(), 0.0);
+			std::fill(components[INPUT_SLOT].begin(),  components[INPUT_SLOT].end(),  0.0);
+			std::fill(components[OUTPUT_SLOT].begin(), components[OUTPUT_SLOT].end(), 0.0);
 		}
 
 		void MemoryTrace::step(double t, double deltaT)
@@ -25,18 +26,12 @@
 			const int size = commonParameters.dimensionParameters.size;
 			// Hoist component buffers out of the per-cell loop (see MemoryTrace2D):
 			// avoids an unordered_map<string> hash lookup per cell.
-			const double* __restrict in  = components["input"].data();
-			double* __restrict       out = components["output"].data();
+			const double* __restrict in  = components[INPUT_SLOT].data();
+			double* __restrict       out = components[OUTPUT_SLOT].data();
 			const double invBuild = 1.0 / parameters.tauBuild;
 			const double invDecay = 1.0 / parameters.tauDecay;
-			for (int i = 0; i < size; ++i)
-			{
-				if (in[i] > parameters.threshold) {
-					out[i] += deltaT * invBuild * (-out[i] + in[i]);
-				} else {
-					out[i] += deltaT * invDecay * (-out[i]);
-				}
-			}
+			tools::math::detail::simdKernels().memory_trace_f64(in, out, static_cast<std::size_t>(size),
+				parameters.threshold, deltaT * invBuild, deltaT * invDecay);
 		}
 
 		std::string MemoryTrace::toString() const
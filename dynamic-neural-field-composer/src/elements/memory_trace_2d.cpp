@@ -5,6 +5,7 @@
 #include <utility>
 
 #include "elements/memory_trace_2d.h"
+#include "tools/simd_dispatch.h"
 
 namespace dnf_composer::element
 {
@@ -17,8 +18,8 @@ namespace dnf_composer::element
 
 	void MemoryTrace2D::init()
 	{
-		std::ranges::fill(components["input"],  0.0);
-		std::ranges::fill(components["output"], 0.0);
+		std::ranges::fill(components[INPUT_SLOT],  0.0);
+		std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 	}
 
 	void MemoryTrace2D::step(double t, double deltaT)
@@ -27,20 +28,15 @@ namespace dnf_composer::element
 
 		const int size = commonParameters.dimensionParameters.size;
 		// Hoist the component buffers out of the per-cell loop: indexing
-		// components["..."] inside the loop is an unordered_map<string> hash lookup
-		// per cell (profiled as the dominant cost of this element).
-		const double* __restrict in  = components["input"].data();
-		double* __restrict       out = components["output"].data();
+		// components[...] inside the loop is a lookup per cell (a string hash, back
+		// when components were an unordered_map; profiled as the dominant cost of
+		// this element).
+		const double* __restrict in  = components[INPUT_SLOT].data();
+		double* __restrict       out = components[OUTPUT_SLOT].data();
 		const double invBuild = 1.0 / parameters.tauBuild;
 		const double invDecay = 1.0 / parameters.tauDecay;
-		for (int i = 0; i < size; ++i)
-		{
-			if (in[i] > parameters.threshold) {
-				out[i] += deltaT * invBuild * (-out[i] + in[i]);
-			} else {
-				out[i] += deltaT * invDecay * (-out[i]);
-			}
-		}
+		tools::math::detail::simdKernels().memory_trace_f64(in, out, static_cast<std::size_t>(size),
+			parameters.threshold, deltaT * invBuild, deltaT * invDecay);
 	}
 
 	std::string MemoryTrace2D::toString() const
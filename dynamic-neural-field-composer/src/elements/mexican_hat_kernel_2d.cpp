@@ -18,6 +18,8 @@
 
 		void MexicanHatKernel2D::init()
 		{
+			resetSpectrumSharing();
+
 			const int size_x = commonParameters.dimensionParameters.size_x;
 			const int size_y = commonParameters.dimensionParameters.size_y;
 
@@ -88,9 +90,13 @@
 			addProduct(kernelInh_x, kernelInh_y, -1.0);
 
 			const int totalSize = size_x * size_y;
-			scratchTmp_.assign(totalSize, 0.0);
-			scratchExcConv_.assign(totalSize, 0.0);
-			scratchInhConv_.assign(totalSize, 0.0);
+			single_ = tools::math::precision() == tools::math::Precision::Single;
+			// Only one precision's result buffers are needed.
+			scratchTmp_.assign(single_ ? 0 : totalSize, 0.0);
+			scratchExcConv_.assign(single_ ? 0 : totalSize, 0.0);
+			scratchInhConv_.assign(single_ ? 0 : totalSize, 0.0);
+			excConv32_.assign(single_ ? totalSize : 0, 0.0f);
+			inhConv32_.assign(single_ ? totalSize : 0, 0.0f);
 			scratch2d_.ensure(size_x, size_y,
 				std::max(extIndexExc_x.size(), extIndexInh_x.size()),
 				std::max(extIndexExc_y.size(), extIndexInh_y.size()));
@@ -101,23 +107,28 @@
 			useFFT_ = tools::math::shouldUseSpectral2D(parameters.circular, totalTaps, size_x, size_y);
 			if (useFFT_)
 			{
-				spectral_.init(size_x, size_y);
+				spectral_.init(size_x, size_y, tools::math::precision());
 				spectral_.setKernel(tools::math::buildWrappedSeparableKernel2D(size_x, size_y,
 					{ tools::math::SeparableKernelTerm2D{ kernelExc_x, kernelRangeExc_x[0], kernelExc_y, kernelRangeExc_y[0], +1.0 },
 					  tools::math::SeparableKernelTerm2D{ kernelInh_x, kernelRangeInh_x[0], kernelInh_y, kernelRangeInh_y[0], -1.0 } }));
 			}
+			else if (single_)
+			{
+				directExc32_.setKernel(kernelExc_x, kernelExc_y, size_x, size_y, extIndexExc_x, extIndexExc_y);
+				directInh32_.setKernel(kernelInh_x, kernelInh_y, size_x, size_y, extIndexInh_x, extIndexInh_y);
+			}
 
 			fullSum = 0.0;
-			std::ranges::fill(components["input"], 0.0);
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 		}
 
 		void MexicanHatKernel2D::step(double t, double deltaT)
 		{
 			updateInput();
 
-			const std::vector<double>& input = components["input"];
-			std::vector<double>& output = components["output"];
+			const ComponentBuffer& input = components[INPUT_SLOT];
+			ComponentBuffer& output = components[OUTPUT_SLOT];
 
 			// Skip the O(N) accumulate when the global offset is disabled.
 			const bool hasGlobal = parameters.amplitudeGlobal != 0.0;
@@ -125,6 +136,27 @@
 
 			const int n = static_cast<int>(output.size());
 
+			if (single_)
+			{
+				// Same two paths in float; excConv32_ holds the combined result
+				// on the spectral one.
+				if (useFFT_)
+				{
+					convolveSpectrally2D(spectral_, input, excConv32_.data());
+					writeOutput(output, excConv32_, hasGlobal, parameters.amplitudeGlobal * fullSum);
+					return;
+				}
+				const std::span<const float> field = singleInput(input);
+				directExc32_.apply(field, excConv32_);
+				directInh32_.apply(field, inhConv32_);
+				const double globalOffset = hasGlobal ? parameters.amplitudeGlobal * fullSum : 0.0;
+				for (int i = 0; i < n; ++i) {
+					const double difference = static_cast<double>(excConv32_[i]) - static_cast<double>(inhConv32_[i]);
+					output[i] = hasGlobal ? difference + globalOffset : difference;
+				}
+				return;
+			}
+
 			if (useFFT_)
 			{
 				// Fused spectral path: one forward transform of the field, one
@@ -132,7 +164,7 @@
 				// one inverse transform — replacing the two separable convolutions
 				// below. scratchExcConv_ is reused as the generic "combined
 				// convolution result" buffer (scratchInhConv_ is unused on this path).
-				spectral_.apply(input.data(), scratchExcConv_.data());
+				convolveSpectrally2D(spectral_, input, scratchExcConv_.data());
 				if (hasGlobal)
 				{
 					const double globalOffset = parameters.amplitudeGlobal * fullSum;
@@ -1,4 +1,5 @@
 #include "elements/neural_field.h"
+#include "tools/simd_dispatch.h"
 
 
 
@@ -24,17 +25,18 @@
 			commonParameters.identifiers.label = ElementLabel::NEURAL_FIELD;
 			components["activation"] = std::vector<double>(commonParameters.dimensionParameters.size);
 			components["resting level"] = std::vector<double>(commonParameters.dimensionParameters.size);
+			activationSlot_ = components.slot("activation");
 		}
 
 		void NeuralField::init()
 		{
 			std::ranges::fill(components["activation"], parameters.startingRestingLevel);
-			std::ranges::fill(components["input"], 0.0);
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[INPUT_SLOT], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 			std::ranges::fill(components["resting level"], parameters.startingRestingLevel);
 
-			act_  = components["activation"].data();
-			inp_  = components["input"].data();
+			act_  = components[activationSlot_].data();
+			inp_  = components[INPUT_SLOT].data();
 			restScalar_ = parameters.startingRestingLevel;
 
 			calculateOutput();
@@ -42,6 +44,25 @@
 
 		void NeuralField::step(double t, double deltaT)
 		{
+			// Sum the inputs, integrate, apply the activation function and fold the
+			// state metrics in one cache-tiled sweep (see detail::fieldStepKernel);
+			// the four separate passes below remain for activation functions other
+			// than the built-in ones.
+			const std::span<const ComponentBuffer* const> sources = inputSources();
+			act_ = components[activationSlot_].data();
+			inp_ = components[INPUT_SLOT].data();
+			const detail::FieldStepBuffers buffers{ sources, inp_, act_, components[OUTPUT_SLOT].data(),
+				static_cast<std::size_t>(commonParameters.dimensionParameters.size) };
+			detail::ActivationStats stats;
+			if (detail::fusedFieldStep(*parameters.activationFunction, buffers, deltaT / parameters.tau,
+				restScalar_, computeStateMetrics_ ? &stats : nullptr))
+			{
+				if (computeStateMetrics_) {
+					updateState(stats, deltaT);
+				}
+				return;
+			}
+
 			updateInput();
 			calculateActivation(t, deltaT);
 			calculateOutput();
@@ -103,41 +124,31 @@
 		void NeuralField::calculateActivation(double t, double deltaT)
 		{
 			const double dtOverTau = deltaT / parameters.tau;
-			const int sz = commonParameters.dimensionParameters.size;
-			for (int i = 0; i < sz; ++i) {
-				act_[i] += dtOverTau * (-act_[i] + restScalar_ + inp_[i]);
-			}
+			const auto sz = static_cast<std::size_t>(commonParameters.dimensionParameters.size);
+			tools::math::detail::simdKernels().euler_f64(act_, inp_, sz, dtOverTau, restScalar_);
 		}
 
 		void NeuralField::calculateOutput()
 		{
-			parameters.activationFunction->apply(components["activation"], components["output"]);
+			parameters.activationFunction->apply(components[activationSlot_], components[OUTPUT_SLOT]);
 		}
 
 		void NeuralField::updateState(double deltaT)
 		{
-			const auto n = static_cast<std::size_t>(commonParameters.dimensionParameters.size);
+			detail::ActivationStats stats;
+			detail::foldActivationStats(stats, act_, 0, static_cast<std::size_t>(commonParameters.dimensionParameters.size));
+			updateState(stats, deltaT);
+		}
 
-			// One pass over act_: compute sum, sumSq (for norm), min, max simultaneously.
-			// Replaces 5 separate O(N) passes that each also did a string hash-map lookup.
-			double sum = 0.0;
-			double sumSq = 0.0;
-			double vmin = act_[0];
-			double vmax = act_[0];
-			for (std::size_t i = 0; i < n; ++i)
-			{
-				const double v = act_[i];
-				sum   += v;
-				sumSq += v * v;
-				if (v < vmin) { vmin = v;
-}
-				if (v > vmax) { vmax = v;
-}
-			}
-			const double norm = std::sqrt(sumSq);
+		void NeuralField::updateState(const detail::ActivationStats& stats, double deltaT)
+		{
+			const auto n = static_cast<std::size_t>(commonParameters.dimensionParameters.size);
+			const double sum  = stats.sum;
+			const double vmax = stats.max;
+			const double norm = std::sqrt(stats.sumSq);
 			const double avg  = sum / static_cast<double>(n);
 
-			state.lowestActivation  = vmin;
+			state.lowestActivation  = stats.min;
 			state.highestActivation = vmax;
 
 			state.stable =
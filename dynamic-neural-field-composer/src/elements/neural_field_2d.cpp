@@ -1,4 +1,6 @@
 #include "elements/neural_field_2d.h"
+#include "tools/precision.h"
+#include "tools/simd_dispatch.h"
 
 #include <array>
 
@@ -12,27 +14,54 @@ namespace dnf_composer::element
 		commonParameters.identifiers.label = ElementLabel::NEURAL_FIELD_2D;
 		components["activation"]    = std::vector<double>(commonParameters.dimensionParameters.size);
 		components["resting level"] = std::vector<double>(commonParameters.dimensionParameters.size);
+		activationSlot_ = components.slot("activation");
 	}
 
 	void NeuralField2D::init()
 	{
 		std::ranges::fill(components["activation"],    parameters.startingRestingLevel);
 		std::ranges::fill(components["resting level"], parameters.startingRestingLevel);
-		std::ranges::fill(components["input"],  0.0);
-		std::ranges::fill(components["output"], 0.0);
+		std::ranges::fill(components[INPUT_SLOT],  0.0);
+		std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 
-		act_  = components["activation"].data();
-		inp_  = components["input"].data();
+		act_  = components[activationSlot_].data();
+		inp_  = components[INPUT_SLOT].data();
 		restScalar_ = parameters.startingRestingLevel;
 
+		if (tools::math::precision() == tools::math::Precision::Single) {
+			singleOutput_.assign(static_cast<std::size_t>(commonParameters.dimensionParameters.size), 0.0f);
+		} else {
+			singleOutput_.clear();
+		}
+
 		calculateOutput();
+		narrowOutput();
 	}
 
 	void NeuralField2D::step(double t, double deltaT)
 	{
+		// Same fused sweep as NeuralField::step(); falls through to the separate
+		// passes for a custom activation function.
+		const std::span<const ComponentBuffer* const> sources = inputSources();
+		act_ = components[activationSlot_].data();
+		inp_ = components[INPUT_SLOT].data();
+		const detail::FieldStepBuffers buffers{ sources, inp_, act_, components[OUTPUT_SLOT].data(),
+			static_cast<std::size_t>(commonParameters.dimensionParameters.size),
+			singleOutput_.empty() ? nullptr : singleOutput_.data() };
+		detail::ActivationStats stats;
+		if (detail::fusedFieldStep(*parameters.activationFunction, buffers, deltaT / parameters.tau,
+			restScalar_, computeStateMetrics_ ? &stats : nullptr))
+		{
+			if (computeStateMetrics_) {
+				updateState(stats, deltaT);
+			}
+			return;
+		}
+
 		updateInput();
 		calculateActivation(t, deltaT);
 		calculateOutput();
+		narrowOutput();
 		if (computeStateMetrics_) {
 			updateState(deltaT);
 }
@@ -41,38 +70,38 @@ namespace dnf_composer::element
 	void NeuralField2D::calculateActivation(double /*t*/, double deltaT)
 	{
 		const double dtOverTau = deltaT / parameters.tau;
-		const int sz = commonParameters.dimensionParameters.size;
-		for (int i = 0; i < sz; ++i) {
-			act_[i] += dtOverTau * (-act_[i] + restScalar_ + inp_[i]);
-		}
+		const auto sz = static_cast<std::size_t>(commonParameters.dimensionParameters.size);
+		tools::math::detail::simdKernels().euler_f64(act_, inp_, sz, dtOverTau, restScalar_);
 	}
 
 	void NeuralField2D::calculateOutput()
 	{
-		parameters.activationFunction->apply(components["activation"], components["output"]);
+		parameters.activationFunction->apply(components[activationSlot_], components[OUTPUT_SLOT]);
+	}
+
+	void NeuralField2D::narrowOutput()
+	{
+		if (!singleOutput_.empty()) {
+			std::ranges::copy(components[OUTPUT_SLOT], singleOutput_.begin());
+		}
 	}
 
 	void NeuralField2D::updateState(double deltaT)
+	{
+		detail::ActivationStats stats;
+		detail::foldActivationStats(stats, act_, 0, static_cast<std::size_t>(commonParameters.dimensionParameters.size));
+		updateState(stats, deltaT);
+	}
+
+	void NeuralField2D::updateState(const detail::ActivationStats& stats, double deltaT)
 	{
 		const auto n = static_cast<std::size_t>(commonParameters.dimensionParameters.size);
-		double sum = 0.0;
-		double sumSq = 0.0;
-		double vmin = act_[0];
-		double vmax = act_[0];
-		for (std::size_t i = 0; i < n; ++i)
-		{
-			const double v = act_[i];
-			sum   += v;
-			sumSq += v * v;
-			if (v < vmin) { vmin = v;
-}
-			if (v > vmax) { vmax = v;
-}
-		}
-		const double norm = std::sqrt(sumSq);
+		const double sum  = stats.sum;
+		const double vmax = stats.max;
+		const double norm = std::sqrt(stats.sumSq);
 		const double avg  = sum / static_cast<double>(n);
 
-		state.lowestActivation  = vmin;
+		state.lowestActivation  = stats.min;
 		state.highestActivation = vmax;
 		state.stable =
 			std::abs(sum  - state.previousActivationSum)  < state.thresholdForStability &&
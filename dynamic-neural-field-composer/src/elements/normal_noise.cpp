@@ -11,7 +11,7 @@
 
 		void NormalNoise::init()
 		{
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 		}
 
 		void NormalNoise::step(double t, double deltaT)
@@ -20,13 +20,13 @@
 			// draw and allocation entirely (behaviour identical, output stays zero).
 			if (parameters.amplitude == 0.0)
 			{
-				std::ranges::fill(components["output"], 0.0);
+				std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 				return;
 			}
 
 			// Fill the output with standard-normal samples in place (no temporary
 			// vector), then scale by amplitude/sqrt(dt) in the same pass.
-			std::vector<double>& out = components["output"];
+			ComponentBuffer& out = components[OUTPUT_SLOT];
 			const int n = commonParameters.dimensionParameters.size;
 			tools::math::fillNormal(out.data(), static_cast<std::size_t>(n));
 			const double scale = parameters.amplitude / std::sqrt(deltaT);
@@ -18,7 +18,7 @@
 
 		void NormalNoise2D::init()
 		{
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 		}
 
 		void NormalNoise2D::step(double t, double deltaT)
@@ -28,13 +28,13 @@
 			// and is only ever written here).
 			if (parameters.amplitude == 0.0)
 			{
-				std::ranges::fill(components["output"], 0.0);
+				std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 				return;
 			}
 
 			// Fill the output with standard-normal samples in place (no temporary
 			// vector), then scale by amplitude/sqrt(dt) in the same pass.
-			std::vector<double>& out = components["output"];
+			ComponentBuffer& out = components[OUTPUT_SLOT];
 			const int n = commonParameters.dimensionParameters.size;
 			tools::math::fillNormal(out.data(), static_cast<std::size_t>(n));
 			const double scale = parameters.amplitude / std::sqrt(deltaT);
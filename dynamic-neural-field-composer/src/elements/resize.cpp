@@ -15,16 +15,16 @@
 
 		void Resize::init()
 		{
-			components["input"].assign(parameters.inputDimensions.size, 0.0);
-			components["output"].assign(commonParameters.dimensionParameters.size, 0.0);
+			components[INPUT_SLOT].assign(parameters.inputDimensions.size, 0.0);
+			components[OUTPUT_SLOT].assign(commonParameters.dimensionParameters.size, 0.0);
 		}
 
 		void Resize::step(double t, double deltaT)
 		{
 			updateInput();
 
-			const auto& in = components["input"];
-			auto& out = components["output"];
+			const auto& in = components[INPUT_SLOT];
+			auto& out = components[OUTPUT_SLOT];
 
 			switch (parameters.method)
 			{
@@ -63,7 +63,7 @@
 			// output size M) before delegating, so the base size check passes and the
 			// input cache is invalidated correctly.
 			parameters.inputDimensions = inputElement->getElementCommonParameters().dimensionParameters;
-			components["input"].assign(inputElement->getComponentPtr("output")->size(), 0.0);
+			components[INPUT_SLOT].assign(inputElement->getComponentPtr("output")->size(), 0.0);
 
 			Element::addInput(inputElement, inputComponent);
 		}
@@ -84,7 +84,7 @@
 		void Resize::changeInputDimensions(const ElementDimensions& newInputDimensions)
 		{
 			parameters.inputDimensions = newInputDimensions;
-			components["input"].assign(newInputDimensions.size, 0.0);
+			components[INPUT_SLOT].assign(newInputDimensions.size, 0.0);
 			init();
 		}
 
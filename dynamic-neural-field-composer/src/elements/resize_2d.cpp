@@ -36,8 +36,8 @@
 
 		void Resize2D::init()
 		{
-			components["input"].assign(parameters.inputDimensions.size, 0.0);
-			components["output"].assign(commonParameters.dimensionParameters.size, 0.0);
+			components[INPUT_SLOT].assign(parameters.inputDimensions.size, 0.0);
+			components[OUTPUT_SLOT].assign(commonParameters.dimensionParameters.size, 0.0);
 
 			// Pre-size the separable-pass scratch buffers so step() does no heap allocation.
 			const int inSizeX = parameters.inputDimensions.size_x;
@@ -55,8 +55,8 @@
 		{
 			updateInput();
 
-			const auto& in = components["input"];
-			auto& out = components["output"];
+			const auto& in = components[INPUT_SLOT];
+			auto& out = components[OUTPUT_SLOT];
 
 			const int inSizeX = parameters.inputDimensions.size_x;
 			const int inSizeY = parameters.inputDimensions.size_y;
@@ -110,7 +110,7 @@
 			// Size the input buffer to the source's output size before delegating, so the
 			// base size check passes and the input cache is invalidated correctly.
 			parameters.inputDimensions = inputElement->getElementCommonParameters().dimensionParameters;
-			components["input"].assign(inputElement->getComponentPtr("output")->size(), 0.0);
+			components[INPUT_SLOT].assign(inputElement->getComponentPtr("output")->size(), 0.0);
 
 			Element::addInput(inputElement, inputComponent);
 		}
@@ -131,7 +131,7 @@
 		void Resize2D::changeInputDimensions(const ElementDimensions& newInputDimensions)
 		{
 			parameters.inputDimensions = newInputDimensions;
-			components["input"].assign(newInputDimensions.size, 0.0);
+			components[INPUT_SLOT].assign(newInputDimensions.size, 0.0);
 			init();
 		}
 
@@ -80,8 +80,8 @@ namespace dnf_composer::element
 			}
 		}
 
-		std::ranges::fill(components["output"], 0.0);
-		std::ranges::fill(components["input"],  0.0);
+		std::ranges::fill(components[OUTPUT_SLOT], 0.0);
+		std::ranges::fill(components[INPUT_SLOT],  0.0);
 	}
 
 	void TimedGaussStimulus2D::step(double t, double deltaT)
@@ -91,9 +91,9 @@ namespace dnf_composer::element
 		});
 
 		if (isOn) {
-			components["output"] = stimulusPattern;
+			components[OUTPUT_SLOT] = stimulusPattern;
 		} else {
-			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components[OUTPUT_SLOT], 0.0);
 }
 	}
 
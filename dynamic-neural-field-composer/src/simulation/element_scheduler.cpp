@@ -0,0 +1,224 @@
+#include "simulation/element_scheduler.h"
+#include "simulation/step_profiler.h"
+#include "tools/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+namespace dnf_composer
+{
+	void ElementScheduler::build(const std::vector<std::shared_ptr<element::Element>>& elements, bool synchronous)
+	{
+		clear();
+		builtRevision = element::Element::getConnectionRevision(elements);
+
+		const std::size_t n = elements.size();
+		nodes.resize(n);
+
+		std::unordered_map<const element::Element*, std::size_t> indexOf;
+		indexOf.reserve(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			nodes[i].element = elements[i];
+			nodes[i].pinned = elements[i]->usesThreadRandomStream();
+			indexOf.emplace(elements[i].get(), i);
+		}
+
+		auto addEdge = [this](std::size_t from, std::size_t to)
+		{
+			nodes[from].successors.push_back(to);
+		};
+
+		std::size_t lastPinned = n;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const auto dependencies = synchronous
+				? elements[i]->getLiveStepDependencies()
+				: elements[i]->getStepDependencies();
+			for (const auto& dependency : dependencies)
+			{
+				// A source that is not registered in this simulation is never
+				// stepped, so reading it can't race with anything.
+				const auto it = indexOf.find(dependency.get());
+				if (it == indexOf.end() || it->second == i)
+				{
+					continue;
+				}
+				const std::size_t j = it->second;
+				if (j < i)
+				{
+					addEdge(j, i);
+				}
+				else
+				{
+					addEdge(i, j);
+				}
+			}
+			if (nodes[i].pinned)
+			{
+				if (lastPinned != n)
+				{
+					addEdge(lastPinned, i);
+				}
+				lastPinned = i;
+			}
+		}
+
+		// Deduplicate (a FieldCoupling and its output field can contribute the
+		// same edge from both ends), then count predecessors.
+		for (auto& node : nodes)
+		{
+			std::ranges::sort(node.successors);
+			const auto [first, last] = std::ranges::unique(node.successors);
+			node.successors.erase(first, last);
+			for (const std::size_t s : node.successors)
+			{
+				++nodes[s].predecessorCount;
+			}
+		}
+
+		// Edges only ever point to a higher index, so a single forward pass in
+		// registry order visits every node after all of its predecessors.
+		std::vector<std::size_t> depth(n, 1);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			if (nodes[i].predecessorCount == 0)
+			{
+				roots.push_back(i);
+			}
+			for (const std::size_t s : nodes[i].successors)
+			{
+				depth[s] = std::max(depth[s], depth[i] + 1);
+			}
+			criticalPathLength = std::max(criticalPathLength, depth[i]);
+		}
+
+		remaining = std::make_unique<std::atomic<std::size_t>[]>(n);
+	}
+
+	bool ElementScheduler::isCurrent(const std::vector<std::shared_ptr<element::Element>>& elements) const
+	{
+		if (elements.size() != nodes.size() || builtRevision != element::Element::getConnectionRevision(elements))
+		{
+			return false;
+		}
+		for (std::size_t i = 0; i < elements.size(); ++i)
+		{
+			if (elements[i] != nodes[i].element)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void ElementScheduler::clear()
+	{
+		nodes.clear();
+		roots.clear();
+		remaining.reset();
+		criticalPathLength = 0;
+	}
+
+	void ElementScheduler::step(tools::threading::ThreadPool& pool, double t, double deltaT, StepProfiler* profiler)
+	{
+		if (nodes.empty())
+		{
+			return;
+		}
+
+		activePool = &pool;
+		stepT = t;
+		stepDeltaT = deltaT;
+		activeProfiler = profiler;
+		tracing = tools::trace::isActive();
+		failed.store(false, std::memory_order_relaxed);
+		error = nullptr;
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			remaining[i].store(nodes[i].predecessorCount, std::memory_order_relaxed);
+		}
+		pending.store(nodes.size(), std::memory_order_release);
+
+		for (const std::size_t root : roots)
+		{
+			enqueue(root);
+		}
+		pool.runUntil(pending);
+		activePool = nullptr;
+		activeProfiler = nullptr;
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ElementScheduler::enqueue(std::size_t index)
+	{
+		const tools::threading::Task task{ &ElementScheduler::runNode, this, index };
+		if (nodes[index].pinned)
+		{
+			activePool->submitPinned(task);
+		}
+		else
+		{
+			activePool->submit(task);
+		}
+	}
+
+	void ElementScheduler::runNode(void* context, std::size_t index)
+	{
+		auto& self = *static_cast<ElementScheduler*>(context);
+		const Node& node = self.nodes[index];
+
+		// After a failure, keep draining the graph (so pending reaches zero and
+		// step() returns) but stop doing work: the serial loop would never have
+		// reached the elements after the one that threw either.
+		if (!self.failed.load(std::memory_order_relaxed))
+		{
+			try
+			{
+				if (self.activeProfiler != nullptr || self.tracing)
+				{
+					const auto t0 = std::chrono::steady_clock::now();
+					node.element->step(self.stepT, self.stepDeltaT);
+					const auto t1 = std::chrono::steady_clock::now();
+					if (self.activeProfiler != nullptr)
+					{
+						self.activeProfiler->record(index, t1 - t0);
+					}
+					if (self.tracing)
+					{
+						tools::trace::record(node.element->getUniqueName(), "element", t0, t1);
+					}
+				}
+				else
+				{
+					node.element->step(self.stepT, self.stepDeltaT);
+				}
+			}
+			catch (...)
+			{
+				const std::lock_guard<std::mutex> lock(self.errorMutex);
+				if (!self.error)
+				{
+					self.error = std::current_exception();
+				}
+				self.failed.store(true, std::memory_order_relaxed);
+			}
+		}
+
+		// acq_rel: the successor that sees its count hit zero must observe every
+		// write its predecessors made to their components.
+		for (const std::size_t s : node.successors)
+		{
+			if (self.remaining[s].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				self.enqueue(s);
+			}
+		}
+		self.pending.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
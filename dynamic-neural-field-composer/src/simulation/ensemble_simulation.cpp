@@ -0,0 +1,699 @@
+#include "simulation/ensemble_simulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <random>
+#include <ranges>
+
+#include "elements/neural_field.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/normal_noise.h"
+#include "exceptions/exception.h"
+#include "tools/simd_dispatch.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		using Overrides = std::map<std::string, double>;
+
+		// The .json keys setParameter accepts for an element, as written by
+		// SimulationFileManager. Empty for an element the ensemble cannot step.
+		std::vector<std::string> parameterNames(const element::Element& element)
+		{
+			switch (element.getLabel())
+			{
+			case element::NEURAL_FIELD:
+			{
+				const auto parameters = dynamic_cast<const element::NeuralField&>(element).getParameters();
+				switch (parameters.activationFunction->type)
+				{
+				case element::SIGMOID: return { "tau", "restingLevel", "steepness", "x_shift" };
+				case element::HEAVISIDE: return { "tau", "restingLevel", "x_shift" };
+				case element::ABSSIGMOID: return { "tau", "restingLevel", "beta", "x_shift" };
+				}
+				return {};
+			}
+			case element::GAUSS_STIMULUS: return { "amplitude", "width", "position" };
+			case element::GAUSS_KERNEL: return { "amplitude", "width", "amplitudeGlobal" };
+			case element::MEXICAN_HAT_KERNEL:
+				return { "amplitudeExc", "widthExc", "amplitudeInh", "widthInh", "amplitudeGlobal" };
+			case element::NORMAL_NOISE: return { "amplitude" };
+			default: return {};
+			}
+		}
+
+		void apply(const Overrides& overrides, const std::string& name, double& field)
+		{
+			if (const auto it = overrides.find(name); it != overrides.end())
+				field = it->second;
+		}
+
+		// A fresh, unconnected copy of `element` with `overrides` applied.
+		std::shared_ptr<element::Element> makeElement(const element::Element& element, const Overrides& overrides)
+		{
+			using namespace element;
+			const ElementCommonParameters common = element.getElementCommonParameters();
+			switch (element.getLabel())
+			{
+			case NEURAL_FIELD:
+			{
+				NeuralFieldParameters p = dynamic_cast<const NeuralField&>(element).getParameters();
+				apply(overrides, "tau", p.tau);
+				apply(overrides, "restingLevel", p.startingRestingLevel);
+				switch (p.activationFunction->type)
+				{
+				case SIGMOID:
+				{
+					const auto& f = dynamic_cast<const SigmoidFunction&>(*p.activationFunction);
+					double xShift = f.getXShift(), steepness = f.getSteepness();
+					apply(overrides, "x_shift", xShift);
+					apply(overrides, "steepness", steepness);
+					p.activationFunction = std::make_unique<SigmoidFunction>(xShift, steepness);
+					break;
+				}
+				case HEAVISIDE:
+				{
+					double xShift = dynamic_cast<const HeavisideFunction&>(*p.activationFunction).getXShift();
+					apply(overrides, "x_shift", xShift);
+					p.activationFunction = std::make_unique<HeavisideFunction>(xShift);
+					break;
+				}
+				case ABSSIGMOID:
+				{
+					const auto& f = dynamic_cast<const AbsSigmoidFunction&>(*p.activationFunction);
+					double xShift = f.x_shift, beta = f.beta;
+					apply(overrides, "x_shift", xShift);
+					apply(overrides, "beta", beta);
+					p.activationFunction = std::make_unique<AbsSigmoidFunction>(xShift, beta);
+					break;
+				}
+				}
+				return std::make_shared<NeuralField>(common, p);
+			}
+			case GAUSS_STIMULUS:
+			{
+				GaussStimulusParameters p = dynamic_cast<const GaussStimulus&>(element).getParameters();
+				apply(overrides, "amplitude", p.amplitude);
+				apply(overrides, "width", p.width);
+				apply(overrides, "position", p.position);
+				return std::make_shared<GaussStimulus>(common, p);
+			}
+			case GAUSS_KERNEL:
+			{
+				GaussKernelParameters p = dynamic_cast<const GaussKernel&>(element).getParameters();
+				apply(overrides, "amplitude", p.amplitude);
+				apply(overrides, "width", p.width);
+				apply(overrides, "amplitudeGlobal", p.amplitudeGlobal);
+				return std::make_shared<GaussKernel>(common, p);
+			}
+			case MEXICAN_HAT_KERNEL:
+			{
+				MexicanHatKernelParameters p = dynamic_cast<const MexicanHatKernel&>(element).getParameters();
+				apply(overrides, "amplitudeExc", p.amplitudeExc);
+				apply(overrides, "widthExc", p.widthExc);
+				apply(overrides, "amplitudeInh", p.amplitudeInh);
+				apply(overrides, "widthInh", p.widthInh);
+				apply(overrides, "amplitudeGlobal", p.amplitudeGlobal);
+				return std::make_shared<MexicanHatKernel>(common, p);
+			}
+			case NORMAL_NOISE:
+			{
+				NormalNoiseParameters p = dynamic_cast<const NormalNoise&>(element).getParameters();
+				apply(overrides, "amplitude", p.amplitude);
+				return std::make_shared<NormalNoise>(common, p);
+			}
+			default:
+				throw Exception("EnsembleSimulation: unsupported element '" + element.getUniqueName() + "'.");
+			}
+		}
+
+		// Per-instance activation-function parameters, as (c, d) of Node.
+		std::pair<double, double> activationParameters(const element::ActivationFunction& f)
+		{
+			switch (f.type)
+			{
+			case element::SIGMOID:
+			{
+				const auto& s = dynamic_cast<const element::SigmoidFunction&>(f);
+				return { s.steepness, s.x_shift };
+			}
+			case element::HEAVISIDE:
+				return { 0.0, dynamic_cast<const element::HeavisideFunction&>(f).x_shift };
+			case element::ABSSIGMOID:
+			{
+				const auto& s = dynamic_cast<const element::AbsSigmoidFunction&>(f);
+				return { s.beta, s.x_shift };
+			}
+			}
+			return { 0.0, 0.0 };
+		}
+	}
+
+	EnsembleSimulation::EnsembleSimulation(const Simulation& prototype, std::size_t instanceCount)
+		: instanceCount(instanceCount), updateMode(prototype.getUpdateMode()),
+		  deltaT(prototype.getDeltaT()), tZero(prototype.getTZero()), t(prototype.getTZero()),
+		  seeds(instanceCount, 0), seeded(instanceCount, false)
+	{
+		if (instanceCount == 0)
+			throw Exception("EnsembleSimulation: the instance count must be at least 1.");
+		if (std::string reason; !supports(prototype, &reason))
+			throw Exception("EnsembleSimulation: " + reason);
+
+		const auto elements = prototype.getElements();
+		nodes.resize(elements.size());
+		for (std::size_t n = 0; n < elements.size(); ++n)
+		{
+			Node& node = nodes[n];
+			const auto& element = elements[n];
+			node.name = element->getUniqueName();
+			node.size = element->getSize();
+			node.prototype = makeElement(*element, {});
+			switch (element->getLabel())
+			{
+			case element::NEURAL_FIELD: node.kind = NodeKind::Field; break;
+			case element::GAUSS_STIMULUS: node.kind = NodeKind::Stimulus; break;
+			case element::NORMAL_NOISE: node.kind = NodeKind::Noise; break;
+			default: node.kind = NodeKind::Kernel; break;
+			}
+		}
+
+		// Only fields and kernels read their inputs; stimuli and noise ignore them.
+		for (std::size_t n = 0; n < elements.size(); ++n)
+		{
+			if (nodes[n].kind != NodeKind::Field && nodes[n].kind != NodeKind::Kernel)
+				continue;
+			std::vector<std::pair<std::string, Source>> named;
+			for (const auto& [source, componentName] : elements[n]->getInputsAndComponents())
+				named.push_back({ source->getUniqueName(), Source{ findNode(source->getUniqueName()), componentName == "activation" } });
+			std::ranges::sort(named, {}, &std::pair<std::string, Source>::first);
+			for (const auto& source : named | std::views::values)
+				nodes[n].sources.push_back(source);
+		}
+	}
+
+	bool EnsembleSimulation::supports(const Simulation& prototype, std::string* reason)
+	{
+		auto fail = [reason](const std::string& why)
+		{
+			if (reason)
+				*reason = why;
+			return false;
+		};
+
+		const auto elements = prototype.getElements();
+		for (const auto& element : elements)
+		{
+			if (element->getElementCommonParameters().dimensionParameters.dimensionality == 2)
+				return fail(std::format("element '{}' ({}) is 2D; ensembles step 1D architectures only.",
+					element->getUniqueName(), element::ElementLabelToString.at(element->getLabel())));
+			if (parameterNames(*element).empty())
+				return fail(std::format("element '{}' ({}) is not supported.", element->getUniqueName(),
+					element::ElementLabelToString.at(element->getLabel())));
+
+			for (const auto& [source, componentName] : element->getInputsAndComponents())
+			{
+				const bool registered = std::ranges::any_of(elements,
+					[&source](const auto& e) { return e == source; });
+				if (!registered)
+					return fail(std::format("'{}' reads '{}', which is not part of the simulation.",
+						element->getUniqueName(), source->getUniqueName()));
+				const bool readsActivation = componentName == "activation" && source->getLabel() == element::NEURAL_FIELD;
+				if (componentName != "output" && !readsActivation)
+					return fail(std::format("'{}' reads component '{}' of '{}'; only \"output\" and a field's \"activation\" are supported.",
+						element->getUniqueName(), componentName, source->getUniqueName()));
+				if (source->getSize() != element->getSize())
+					return fail(std::format("'{}' reads '{}' of a different size.",
+						element->getUniqueName(), source->getUniqueName()));
+			}
+		}
+		return true;
+	}
+
+	void EnsembleSimulation::setParameter(std::size_t instance, const std::string& elementName,
+	                                      const std::string& parameterName, double value)
+	{
+		if (instance >= instanceCount)
+			throw Exception(std::format("EnsembleSimulation: instance {} is out of range (instance count {}).", instance, instanceCount));
+		const std::size_t n = findNode(elementName);
+		const auto names = parameterNames(*nodes[n].prototype);
+		if (std::ranges::find(names, parameterName) == names.end())
+			throw Exception(std::format("EnsembleSimulation: element '{}' has no parameter '{}'.", elementName, parameterName));
+		overrides[{ instance, n, parameterName }] = value;
+	}
+
+	void EnsembleSimulation::setSeed(std::size_t instance, std::uint64_t seed)
+	{
+		if (instance >= instanceCount)
+			throw Exception(std::format("EnsembleSimulation: instance {} is out of range (instance count {}).", instance, instanceCount));
+		seeds[instance] = seed;
+		seeded[instance] = true;
+	}
+
+	void EnsembleSimulation::init()
+	{
+		t = tZero;
+
+		std::random_device device;
+		streams.clear();
+		streams.reserve(instanceCount);
+		for (std::size_t k = 0; k < instanceCount; ++k)
+		{
+			const std::uint64_t seed = seeded[k] ? seeds[k]
+				: (static_cast<std::uint64_t>(device()) << 32) ^ device();
+			streams.emplace_back(seed);
+		}
+
+		std::size_t largest = 0;
+		for (Node& node : nodes)
+		{
+			const std::size_t cells = static_cast<std::size_t>(node.size) * instanceCount;
+			largest = std::max(largest, cells);
+			node.input.assign(cells, 0.0);
+			node.output.assign(cells, 0.0);
+			node.a.assign(instanceCount, 0.0);
+			node.b.assign(instanceCount, 0.0);
+			node.c.assign(instanceCount, 0.0);
+			node.d.assign(instanceCount, 0.0);
+			switch (node.kind)
+			{
+			case NodeKind::Field: initField(node); break;
+			case NodeKind::Stimulus: initStimulus(node); break;
+			case NodeKind::Kernel: initKernel(node); break;
+			case NodeKind::Noise: initNoise(node); break;
+			}
+			if (updateMode == UpdateMode::Synchronous)
+			{
+				node.frontOutput = node.output;
+				node.frontActivation = node.activation;
+			}
+			else
+			{
+				node.frontOutput.clear();
+				node.frontActivation.clear();
+			}
+		}
+		scratch.assign(largest, 0.0);
+		initialized = true;
+	}
+
+	void EnsembleSimulation::step()
+	{
+		if (!initialized)
+			throw Exception("EnsembleSimulation: step() called before init().");
+
+		t += deltaT;
+		for (Node& node : nodes)
+		{
+			switch (node.kind)
+			{
+			case NodeKind::Field:
+				sumInputs(node);
+				stepField(node, true);
+				break;
+			case NodeKind::Kernel:
+				sumInputs(node);
+				stepKernel(node);
+				break;
+			case NodeKind::Noise:
+				stepNoise(node);
+				break;
+			case NodeKind::Stimulus:
+				break;
+			}
+		}
+
+		// Same as Simulation::publishFrontBuffers: copy, don't swap, so the back
+		// buffers keep their values for the next step's integration.
+		if (updateMode == UpdateMode::Synchronous)
+		{
+			for (Node& node : nodes)
+			{
+				std::ranges::copy(node.output, node.frontOutput.begin());
+				std::ranges::copy(node.activation, node.frontActivation.begin());
+			}
+		}
+	}
+
+	std::vector<double> EnsembleSimulation::getComponent(std::size_t instance, const std::string& elementName,
+	                                                     const std::string& componentName) const
+	{
+		if (instance >= instanceCount)
+			throw Exception(std::format("EnsembleSimulation: instance {} is out of range (instance count {}).", instance, instanceCount));
+		const Node& node = nodes[findNode(elementName)];
+
+		const std::vector<double>* buffer = nullptr;
+		if (componentName == "output")
+			buffer = &node.output;
+		else if (componentName == "input")
+			buffer = &node.input;
+		else if (componentName == "activation" && node.kind == NodeKind::Field)
+			buffer = &node.activation;
+		else
+			throw Exception(ErrorCode::ELEM_COMP_NOT_FOUND, elementName, componentName);
+
+		std::vector<double> values(static_cast<std::size_t>(node.size));
+		for (std::size_t i = 0; i < values.size(); ++i)
+			values[i] = (*buffer)[i * instanceCount + instance];
+		return values;
+	}
+
+	const std::vector<double>& EnsembleSimulation::readable(const Source& source) const
+	{
+		const Node& node = nodes[source.node];
+		if (updateMode == UpdateMode::Synchronous)
+			return source.activation ? node.frontActivation : node.frontOutput;
+		return source.activation ? node.activation : node.output;
+	}
+
+	std::size_t EnsembleSimulation::findNode(const std::string& elementName) const
+	{
+		for (std::size_t n = 0; n < nodes.size(); ++n)
+		{
+			if (nodes[n].name == elementName)
+				return n;
+		}
+		throw Exception(ErrorCode::SIM_ELEM_NOT_FOUND, elementName);
+	}
+
+	std::shared_ptr<element::Element> EnsembleSimulation::instantiate(const Node& node, std::size_t instance) const
+	{
+		const std::size_t n = static_cast<std::size_t>(&node - nodes.data());
+		Overrides instanceOverrides;
+		for (auto it = overrides.lower_bound({ instance, n, std::string() });
+			it != overrides.end() && std::get<0>(it->first) == instance && std::get<1>(it->first) == n; ++it)
+		{
+			instanceOverrides.emplace(std::get<2>(it->first), it->second);
+		}
+		auto element = makeElement(*node.prototype, instanceOverrides);
+		element->init();
+		return element;
+	}
+
+	void EnsembleSimulation::initField(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		node.activation.assign(node.output.size(), 0.0);
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			const auto field = std::dynamic_pointer_cast<element::NeuralField>(instantiate(node, k));
+			const auto parameters = field->getParameters();
+			node.a[k] = deltaT / parameters.tau;
+			node.b[k] = parameters.startingRestingLevel;
+			std::tie(node.c[k], node.d[k]) = activationParameters(*parameters.activationFunction);
+			if (k == 0)
+				node.activationFunction = parameters.activationFunction->clone();
+			for (int i = 0; i < node.size; ++i)
+				node.activation[i * K + k] = node.b[k];
+		}
+		node.uniformActivation = std::ranges::all_of(node.c, [&node](double c) { return c == node.c[0]; })
+			&& std::ranges::all_of(node.d, [&node](double d) { return d == node.d[0]; });
+		stepField(node, false);
+	}
+
+	void EnsembleSimulation::initStimulus(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			const std::vector<double> output = instantiate(node, k)->getComponent("output");
+			for (int i = 0; i < node.size; ++i)
+				node.output[i * K + k] = output[i];
+		}
+	}
+
+	void EnsembleSimulation::initKernel(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		std::vector<std::array<int, 2>> ranges(K);
+		std::vector<std::vector<double>> kernels(K);
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			const auto kernel = std::dynamic_pointer_cast<element::Kernel>(instantiate(node, k));
+			ranges[k] = kernel->getKernelRange();
+			kernels[k] = kernel->getComponent("kernel");
+			node.a[k] = node.prototype->getLabel() == element::GAUSS_KERNEL
+				? std::dynamic_pointer_cast<element::GaussKernel>(kernel)->getParameters().amplitudeGlobal
+				: std::dynamic_pointer_cast<element::MexicanHatKernel>(kernel)->getParameters().amplitudeGlobal;
+		}
+		node.circular = node.prototype->getLabel() == element::GAUSS_KERNEL
+			? std::dynamic_pointer_cast<element::GaussKernel>(node.prototype)->getParameters().circular
+			: std::dynamic_pointer_cast<element::MexicanHatKernel>(node.prototype)->getParameters().circular;
+
+		// One tap window covering every instance's support. Instances with a
+		// narrower kernel get zero taps at the ends, which add exact zeros.
+		std::array<int, 2> range{ 0, 0 };
+		for (const auto& r : ranges)
+			range = { std::max(range[0], r[0]), std::max(range[1], r[1]) };
+		node.tapCount = range[0] + range[1] + 1;
+		node.taps.assign(static_cast<std::size_t>(node.tapCount) * K, 0.0);
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			// kernels[k][j] is the tap at offset j - ranges[k][0]; place it at
+			// offset position range[0] + offset of the padded window.
+			for (int j = 0; j < static_cast<int>(kernels[k].size()); ++j)
+			{
+				const int padded = j - ranges[k][0] + range[0];
+				// conv_valid_into reads the kernel backwards over the circularly
+				// extended input; conv_same_into reads it forwards.
+				const int m = node.circular ? node.tapCount - 1 - padded : padded;
+				node.taps[static_cast<std::size_t>(m) * K + k] = kernels[k][j];
+			}
+		}
+
+		node.symmetric = node.tapCount % 2 == 1;
+		for (int j = 0, m = node.tapCount - 1; node.symmetric && j < m; ++j, --m)
+		{
+			node.symmetric = std::equal(node.taps.begin() + j * K, node.taps.begin() + (j + 1) * K,
+				node.taps.begin() + m * K);
+		}
+
+		if (node.circular)
+		{
+			node.extendedIndex = tools::math::createExtendedIndex(node.size, range);
+			node.padding = 0;
+		}
+		else
+		{
+			// Non-circular ranges are symmetric (computeKernelRange).
+			node.extendedIndex.clear();
+			node.padding = range[0];
+		}
+		node.extended.assign(static_cast<std::size_t>(node.size + node.tapCount - 1) * K, 0.0);
+
+		// The instances a standalone kernel would convolve spectrally, decided
+		// on their own tap counts and convolved with their own taps.
+		node.spectralInstances.clear();
+		node.spectral.clear();
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			if (!tools::math::shouldUseSpectral1D(node.circular, static_cast<int>(kernels[k].size()), node.size))
+				continue;
+			node.spectralInstances.push_back(k);
+			tools::math::SpectralConvolver1D& convolver = node.spectral.emplace_back();
+			convolver.init(node.size);
+			convolver.setKernel(tools::math::buildWrappedKernel1D(node.size, kernels[k], ranges[k][0]));
+		}
+		node.column.assign(node.spectral.empty() ? 0 : 2 * static_cast<std::size_t>(node.size), 0.0);
+	}
+
+	void EnsembleSimulation::initNoise(Node& node)
+	{
+		for (std::size_t k = 0; k < instanceCount; ++k)
+		{
+			const auto noise = std::dynamic_pointer_cast<element::NormalNoise>(instantiate(node, k));
+			node.b[k] = noise->getParameters().amplitude;
+			node.a[k] = node.b[k] / std::sqrt(deltaT);
+		}
+	}
+
+	void EnsembleSimulation::sumInputs(Node& node) const
+	{
+		// Element::updateInput: zero without sources, else the first source
+		// copied and the rest added in order.
+		if (node.sources.empty())
+		{
+			std::ranges::fill(node.input, 0.0);
+			return;
+		}
+		std::ranges::copy(readable(node.sources.front()), node.input.begin());
+		const std::size_t cells = node.input.size();
+		double* __restrict in = node.input.data();
+		for (std::size_t s = 1; s < node.sources.size(); ++s)
+		{
+			const double* __restrict src = readable(node.sources[s]).data();
+			for (std::size_t i = 0; i < cells; ++i)
+				in[i] += src[i];
+		}
+	}
+
+	void EnsembleSimulation::stepField(Node& node, bool integrate)
+	{
+		const std::size_t K = instanceCount;
+		const std::size_t N = static_cast<std::size_t>(node.size);
+		double* __restrict act = node.activation.data();
+		double* __restrict out = node.output.data();
+
+		if (integrate)
+		{
+			const double* __restrict in = node.input.data();
+			const double* __restrict dtOverTau = node.a.data();
+			const double* __restrict rest = node.b.data();
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				double* __restrict a = act + i * K;
+				const double* __restrict x = in + i * K;
+				for (std::size_t k = 0; k < K; ++k)
+					a[k] += dtOverTau[k] * (-a[k] + rest[k] + x[k]);
+			}
+		}
+
+		if (node.uniformActivation)
+		{
+			node.activationFunction->apply(node.activation, node.output);
+			return;
+		}
+
+		const double* __restrict c = node.c.data();
+		const double* __restrict d = node.d.data();
+		switch (node.activationFunction->type)
+		{
+		case element::SIGMOID:
+		{
+			// steepness * (x - x_shift) through the unit sigmoid computes exactly
+			// the -steepness * (x - x_shift) exponent SigmoidFunction::apply does,
+			// and keeps its vectorised path. apply() is elementwise, so it can
+			// run in place on the output.
+			static const element::SigmoidFunction unitSigmoid(0.0, 1.0);
+			for (std::size_t i = 0; i < N; ++i)
+				for (std::size_t k = 0; k < K; ++k)
+					out[i * K + k] = c[k] * (act[i * K + k] - d[k]);
+			unitSigmoid.apply(node.output, node.output);
+			break;
+		}
+		case element::HEAVISIDE:
+			for (std::size_t i = 0; i < N; ++i)
+				for (std::size_t k = 0; k < K; ++k)
+					out[i * K + k] = act[i * K + k] > d[k] ? 1.0 : 0.0;
+			break;
+		case element::ABSSIGMOID:
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				for (std::size_t k = 0; k < K; ++k)
+				{
+					const double diff = act[i * K + k] - d[k];
+					out[i * K + k] = 0.5 * (1.0 + c[k] * diff / (1.0 + c[k] * std::abs(diff)));
+				}
+			}
+			break;
+		}
+	}
+
+	void EnsembleSimulation::convolveDirect(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		const std::size_t N = static_cast<std::size_t>(node.size);
+		const double* __restrict in = node.input.data();
+		double* __restrict ext = node.extended.data();
+
+		if (node.circular)
+		{
+			for (std::size_t q = 0; q < node.extendedIndex.size(); ++q)
+				std::copy_n(in + static_cast<std::size_t>(node.extendedIndex[q] - 1) * K, K, ext + q * K);
+		}
+		else
+		{
+			// The padding cells on either side stay zero from init().
+			std::copy_n(in, N * K, ext + static_cast<std::size_t>(node.padding) * K);
+		}
+
+		const double* __restrict taps = node.taps.data();
+		double* __restrict out = node.output.data();
+		// A circular kernel goes through conv_valid_into (whose AVX-512 tier is
+		// bit-identical to AVX2, so the batched AVX2 kernel serves both), a
+		// non-circular one through conv_same_into's portable loop.
+		if (node.circular && tools::math::simdTier() >= tools::math::SimdTier::Avx2)
+		{
+			tools::math::detail::conv_valid_batched_avx2_f64(taps, node.tapCount, node.symmetric, ext, out,
+				node.size, static_cast<int>(K));
+		}
+		else
+		{
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				double* __restrict o = out + i * K;
+				std::fill_n(o, K, 0.0);
+				for (int m = 0; m < node.tapCount; ++m)
+				{
+					const double* __restrict w = taps + static_cast<std::size_t>(m) * K;
+					const double* __restrict x = ext + (i + m) * K;
+					for (std::size_t k = 0; k < K; ++k)
+						o[k] += w[k] * x[k];
+				}
+			}
+		}
+	}
+
+	void EnsembleSimulation::stepKernel(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		const std::size_t N = static_cast<std::size_t>(node.size);
+		const double* __restrict in = node.input.data();
+		double* __restrict out = node.output.data();
+
+		// Same dispatch as the standalone kernels. The batch convolves every
+		// instance directly unless all of them go spectral; the spectral ones
+		// then overwrite their cells with their own convolvers' results.
+		if (node.spectralInstances.size() < K)
+			convolveDirect(node);
+
+		for (std::size_t s = 0; s < node.spectralInstances.size(); ++s)
+		{
+			const std::size_t k = node.spectralInstances[s];
+			double* column = node.column.data();
+			double* result = column + N;
+			for (std::size_t i = 0; i < N; ++i)
+				column[i] = in[i * K + k];
+			node.spectral[s].apply(column, result);
+			for (std::size_t i = 0; i < N; ++i)
+				out[i * K + k] = result[i];
+		}
+
+		// Global inhibition, amplitudeGlobal * sum(input), per instance.
+		const bool hasGlobal = std::ranges::any_of(node.a, [](double a) { return a != 0.0; });
+		if (!hasGlobal)
+			return;
+		double* __restrict sum = scratch.data();
+		std::fill_n(sum, K, 0.0);
+		for (std::size_t i = 0; i < N; ++i)
+			for (std::size_t k = 0; k < K; ++k)
+				sum[k] += in[i * K + k];
+		for (std::size_t k = 0; k < K; ++k)
+			sum[k] *= node.a[k];
+		for (std::size_t i = 0; i < N; ++i)
+			for (std::size_t k = 0; k < K; ++k)
+				out[i * K + k] += sum[k];
+	}
+
+	void EnsembleSimulation::stepNoise(Node& node)
+	{
+		const std::size_t K = instanceCount;
+		const std::size_t N = static_cast<std::size_t>(node.size);
+		for (std::size_t k = 0; k < K; ++k)
+		{
+			if (node.b[k] == 0.0)
+			{
+				for (std::size_t i = 0; i < N; ++i)
+					node.output[i * K + k] = 0.0;
+				continue;
+			}
+			streams[k].fill(scratch.data(), N);
+			for (std::size_t i = 0; i < N; ++i)
+				node.output[i * K + k] = scratch[i] * node.a[k];
+		}
+	}
+}
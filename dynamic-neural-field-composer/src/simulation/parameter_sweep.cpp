@@ -0,0 +1,603 @@
+#include "simulation/parameter_sweep.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+
+#include "simulation/simulation_file_manager.h"
+#include "elements/neural_field.h"
+#include "elements/neural_field_2d.h"
+#include "exceptions/exception.h"
+#include "tools/fft_convolution.h"
+#include "tools/math.h"
+#include "tools/thread_pool.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		using json = nlohmann::json;
+
+		// FNV-1a64 over the architecture file's bytes -- a change detector for
+		// resume, not a cryptographic digest (same hash as the deckbench deck hash).
+		std::string fnv1a64Hex(const std::string& bytes)
+		{
+			std::uint64_t hash = 14695981039346656037ull;
+			for (const unsigned char c : bytes)
+			{
+				hash ^= c;
+				hash *= 1099511628211ull;
+			}
+			return std::format("{:016x}", hash);
+		}
+
+		std::string readFile(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				throw Exception(std::format("ParameterSweep: cannot open '{}'.", path.string()));
+			std::ostringstream contents;
+			contents << file.rdbuf();
+			return contents.str();
+		}
+
+		json& elementsOf(json& root)
+		{
+			// Both .dnf layouts: the legacy bare array, or an object with "elements".
+			return root.is_array() ? root : root.at("elements");
+		}
+
+		// Set `parameter` of the element named `element` in a parsed architecture.
+		// The key is looked up on the element first, then in its activation
+		// function (steepness, x_shift, beta).
+		void patch(json& root, const SweepParameter& parameter, double value)
+		{
+			for (json& element : elementsOf(root))
+			{
+				if (element.value("uniqueName", std::string()) != parameter.element)
+					continue;
+				if (element.contains(parameter.parameter) && element[parameter.parameter].is_number())
+				{
+					element[parameter.parameter] = value;
+					return;
+				}
+				if (element.contains("activationFunction") && element["activationFunction"].is_object())
+				{
+					json& function = element["activationFunction"];
+					if (function.contains(parameter.parameter) && function[parameter.parameter].is_number())
+					{
+						function[parameter.parameter] = value;
+						return;
+					}
+				}
+				throw Exception(std::format("ParameterSweep: element '{}' has no numeric parameter '{}'.",
+					parameter.element, parameter.parameter));
+			}
+			throw Exception(std::format("ParameterSweep: the architecture has no element '{}'.", parameter.element));
+		}
+
+		template <typename Field>
+		SweepFieldSummary summarise(Field& field, std::optional<double> stableSince)
+		{
+			SweepFieldSummary summary;
+			summary.name = field.getUniqueName();
+			summary.stable = field.isStable();
+			summary.stabilityTime = summary.stable ? stableSince : std::nullopt;
+			summary.bumpCount = static_cast<int>(field.getBumps().size());
+			summary.lowestActivation = field.getLowestActivation();
+			summary.highestActivation = field.getHighestActivation();
+			summary.activation = field.getComponent("activation");
+			return summary;
+		}
+
+		bool isStable(const element::Element& element)
+		{
+			if (const auto* field = dynamic_cast<const element::NeuralField*>(&element))
+				return field->isStable();
+			return dynamic_cast<const element::NeuralField2D&>(element).isStable();
+		}
+
+		json specificationWithoutPath(const json& specification)
+		{
+			// The architecture is identified by its hash, so a sweep resumed from
+			// another working directory (a different relative path) still matches.
+			json copy = specification;
+			copy.erase("architecture");
+			return copy;
+		}
+	}
+
+	SweepSpecification SweepSpecification::fromJson(const nlohmann::json& json, const std::filesystem::path& baseDirectory)
+	{
+		auto fail = [](const std::string& why) { return Exception("SweepSpecification: " + why); };
+
+		SweepSpecification specification;
+		try
+		{
+			const std::filesystem::path architecture = json.at("architecture").get<std::string>();
+			specification.architecture = architecture.is_relative() && !baseDirectory.empty()
+				? baseDirectory / architecture : architecture;
+
+			const std::string design = json.value("design", std::string("cartesian"));
+			if (design == "cartesian")
+				specification.design = SweepDesign::Cartesian;
+			else if (design == "latin_hypercube")
+				specification.design = SweepDesign::LatinHypercube;
+			else
+				throw fail(std::format("unknown design '{}' (expected \"cartesian\" or \"latin_hypercube\").", design));
+
+			specification.steps = json.value("steps", 1000);
+			if (specification.steps <= 0)
+				throw fail("\"steps\" must be positive.");
+			specification.seed = json.value("seed", std::uint64_t{ 1 });
+			if (specification.design == SweepDesign::LatinHypercube)
+			{
+				specification.samples = json.at("samples").get<int>();
+				if (specification.samples <= 0)
+					throw fail("\"samples\" must be positive.");
+			}
+
+			for (const auto& entry : json.at("parameters"))
+			{
+				SweepParameter parameter;
+				parameter.element = entry.at("element").get<std::string>();
+				parameter.parameter = entry.at("parameter").get<std::string>();
+				const std::string label = parameter.element + "." + parameter.parameter;
+				if (specification.design == SweepDesign::LatinHypercube)
+				{
+					parameter.min = entry.at("min").get<double>();
+					parameter.max = entry.at("max").get<double>();
+				}
+				else if (entry.contains("values"))
+				{
+					parameter.values = entry.at("values").get<std::vector<double>>();
+					if (parameter.values.empty())
+						throw fail(std::format("\"values\" of {} is empty.", label));
+				}
+				else
+				{
+					parameter.min = entry.at("min").get<double>();
+					parameter.max = entry.at("max").get<double>();
+					const int count = entry.at("count").get<int>();
+					if (count <= 0)
+						throw fail(std::format("\"count\" of {} must be positive.", label));
+					for (int i = 0; i < count; ++i)
+						parameter.values.push_back(count == 1 ? parameter.min
+							: parameter.min + (parameter.max - parameter.min) * i / (count - 1));
+				}
+				specification.parameters.push_back(std::move(parameter));
+			}
+			if (specification.parameters.empty())
+				throw fail("\"parameters\" is empty.");
+		}
+		catch (const nlohmann::json::exception& e)
+		{
+			throw fail(std::format("malformed sweep ({}).", e.what()));
+		}
+		return specification;
+	}
+
+	SweepSpecification SweepSpecification::fromFile(const std::filesystem::path& path)
+	{
+		json document;
+		try
+		{
+			document = json::parse(readFile(path));
+		}
+		catch (const nlohmann::json::exception& e)
+		{
+			throw Exception(std::format("SweepSpecification: '{}' is not valid JSON ({}).", path.string(), e.what()));
+		}
+		return fromJson(document, path.parent_path());
+	}
+
+	nlohmann::json SweepSpecification::toJson() const
+	{
+		json document;
+		document["architecture"] = architecture.generic_string();
+		document["design"] = design == SweepDesign::Cartesian ? "cartesian" : "latin_hypercube";
+		document["steps"] = steps;
+		document["seed"] = seed;
+		if (design == SweepDesign::LatinHypercube)
+			document["samples"] = samples;
+		document["parameters"] = json::array();
+		for (const auto& parameter : parameters)
+		{
+			json entry = { { "element", parameter.element }, { "parameter", parameter.parameter } };
+			if (design == SweepDesign::LatinHypercube)
+			{
+				entry["min"] = parameter.min;
+				entry["max"] = parameter.max;
+			}
+			else
+			{
+				entry["values"] = parameter.values;
+			}
+			document["parameters"].push_back(std::move(entry));
+		}
+		return document;
+	}
+
+	std::vector<SweepVariant> generateSweepVariants(const SweepSpecification& specification)
+	{
+		const std::size_t dimensions = specification.parameters.size();
+		std::vector<SweepVariant> variants;
+
+		if (specification.design == SweepDesign::Cartesian)
+		{
+			std::size_t total = 1;
+			for (const auto& parameter : specification.parameters)
+				total *= parameter.values.size();
+			variants.resize(total);
+			for (std::size_t index = 0; index < total; ++index)
+			{
+				// Mixed-radix digits of the index, last parameter fastest.
+				SweepVariant& variant = variants[index];
+				variant.values.resize(dimensions);
+				std::size_t rest = index;
+				for (std::size_t d = dimensions; d-- > 0;)
+				{
+					const auto& values = specification.parameters[d].values;
+					variant.values[d] = values[rest % values.size()];
+					rest /= values.size();
+				}
+			}
+		}
+		else
+		{
+			// std::mt19937_64's sequence is fixed by the standard, and the draws
+			// below avoid the implementation-defined distributions, so a seed
+			// gives the same design on every platform.
+			const auto samples = static_cast<std::size_t>(specification.samples);
+			std::mt19937_64 rng(specification.seed);
+			auto uniform = [&rng] { return static_cast<double>(rng() >> 11) * 0x1.0p-53; };
+
+			variants.resize(samples);
+			for (auto& variant : variants)
+				variant.values.resize(dimensions);
+			std::vector<std::size_t> strata(samples);
+			for (std::size_t d = 0; d < dimensions; ++d)
+			{
+				for (std::size_t s = 0; s < samples; ++s)
+					strata[s] = s;
+				for (std::size_t s = samples; s-- > 1;)
+					std::swap(strata[s], strata[rng() % (s + 1)]);
+
+				const SweepParameter& parameter = specification.parameters[d];
+				for (std::size_t s = 0; s < samples; ++s)
+				{
+					const double position = (static_cast<double>(strata[s]) + uniform()) / static_cast<double>(samples);
+					variants[s].values[d] = parameter.min + (parameter.max - parameter.min) * position;
+				}
+			}
+		}
+
+		for (std::size_t index = 0; index < variants.size(); ++index)
+		{
+			variants[index].index = index;
+			variants[index].seed = specification.seed + index;
+		}
+		return variants;
+	}
+
+	ParameterSweep::ParameterSweep(SweepSpecification specification)
+		: specification(std::move(specification))
+	{
+		const std::string bytes = readFile(this->specification.architecture);
+		architectureHash = fnv1a64Hex(bytes);
+		try
+		{
+			architecture = json::parse(bytes);
+		}
+		catch (const nlohmann::json::exception& e)
+		{
+			throw Exception(std::format("ParameterSweep: '{}' is not valid JSON ({}).",
+				this->specification.architecture.string(), e.what()));
+		}
+
+		// Fail on a misspelt element or key now, not once per variant.
+		json probe = architecture;
+		for (const auto& parameter : this->specification.parameters)
+			patch(probe, parameter, 0.0);
+
+		variants = generateSweepVariants(this->specification);
+	}
+
+	std::shared_ptr<Simulation> ParameterSweep::buildSimulation(const SweepVariant& variant) const
+	{
+		json document = architecture;
+		for (std::size_t d = 0; d < specification.parameters.size(); ++d)
+			patch(document, specification.parameters[d], variant.values[d]);
+
+		auto simulation = std::make_shared<Simulation>(std::format("sweep variant {}", variant.index));
+		const SimulationFileManager fileManager(simulation, specification.architecture.string());
+		fileManager.loadElementsFromJson(document);
+		if (simulation->getNumberOfElements() == 0)
+			throw Exception(std::format("ParameterSweep: variant {} did not load (see the log).", variant.index));
+		simulation->init();
+		if (tools::math::planRigor() != tools::math::PlanRigor::Estimate)
+		{
+			// A shape first planned here is measured in the background. Wait for
+			// the measured plans and initialise again, so the kernels' spectra are
+			// transformed with them too and the run does not depend on the step at
+			// which they would have arrived.
+			tools::math::waitForFftPlans();
+			simulation->init();
+		}
+		return simulation;
+	}
+
+	void ParameterSweep::prepareFftPlans() const
+	{
+		if (tools::math::planRigor() == tools::math::PlanRigor::Estimate || variants.empty())
+			return;
+		try
+		{
+			// Initialising a variant plans every transform shape the deck uses.
+			buildSimulation(variants.front());
+		}
+		catch (const std::exception&)
+		{
+			// The variant fails again, and is reported, when it runs.
+		}
+		tools::math::waitForFftPlans();
+	}
+
+	SweepResult ParameterSweep::runVariant(const SweepVariant& variant) const
+	{
+		SweepResult result;
+		result.variant = variant;
+		const auto start = std::chrono::steady_clock::now();
+		try
+		{
+			const auto simulation = buildSimulation(variant);
+			tools::math::seedNormal(variant.seed);
+
+			std::vector<std::shared_ptr<element::Element>> fields;
+			for (const auto& element : simulation->getElements())
+			{
+				const auto label = element->getLabel();
+				if (label == element::NEURAL_FIELD || label == element::NEURAL_FIELD_2D)
+					fields.push_back(element);
+			}
+
+			// The time each field last became stable; cleared whenever it is not.
+			std::vector<std::optional<double>> stableSince(fields.size());
+			for (int step = 0; step < specification.steps; ++step)
+			{
+				simulation->step();
+				for (std::size_t f = 0; f < fields.size(); ++f)
+				{
+					if (!isStable(*fields[f]))
+						stableSince[f].reset();
+					else if (!stableSince[f])
+						stableSince[f] = simulation->getT();
+				}
+			}
+
+			for (std::size_t f = 0; f < fields.size(); ++f)
+			{
+				if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(fields[f]))
+					result.fields.push_back(summarise(*field, stableSince[f]));
+				else
+					result.fields.push_back(summarise(*std::dynamic_pointer_cast<element::NeuralField2D>(fields[f]), stableSince[f]));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			result.fields.clear();
+			result.error = e.what();
+		}
+		result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	nlohmann::json ParameterSweep::headerJson() const
+	{
+		return json{ { "sweep", specification.toJson() },
+		             { "architecture_hash", architectureHash },
+		             { "variants", variants.size() } };
+	}
+
+	nlohmann::json ParameterSweep::resultJson(const SweepResult& result) const
+	{
+		json line;
+		line["variant"] = result.variant.index;
+		line["seed"] = result.variant.seed;
+		json parameters = json::object();
+		for (std::size_t d = 0; d < specification.parameters.size(); ++d)
+		{
+			const auto& parameter = specification.parameters[d];
+			parameters[parameter.element + ":" + parameter.parameter] = result.variant.values[d];
+		}
+		line["parameters"] = std::move(parameters);
+		line["wall_seconds"] = result.wallSeconds;
+		if (!result.error.empty())
+		{
+			line["error"] = result.error;
+			return line;
+		}
+		line["fields"] = json::array();
+		for (const auto& field : result.fields)
+		{
+			line["fields"].push_back({
+				{ "name", field.name },
+				{ "stable", field.stable },
+				{ "stability_time", field.stabilityTime ? json(*field.stabilityTime) : json(nullptr) },
+				{ "bump_count", field.bumpCount },
+				{ "lowest_activation", field.lowestActivation },
+				{ "highest_activation", field.highestActivation },
+				{ "final_activation", field.activation },
+			});
+		}
+		return line;
+	}
+
+	namespace
+	{
+		// The header and every intact result line of a results file.
+		std::pair<json, std::vector<json>> readResults(const std::filesystem::path& path)
+		{
+			std::ifstream file(path);
+			std::string text;
+			json header;
+			std::vector<json> lines;
+			if (!file || !std::getline(file, text))
+				return { header, lines };
+			header = json::parse(text, nullptr, false);
+			while (std::getline(file, text))
+			{
+				// A line cut short by the interruption fails to parse; its variant
+				// simply runs again.
+				json line = json::parse(text, nullptr, false);
+				if (!line.is_discarded() && line.contains("variant"))
+					lines.push_back(std::move(line));
+			}
+			return { header, lines };
+		}
+	}
+
+	std::vector<std::size_t> ParameterSweep::completedVariants(const std::filesystem::path& resultsPath) const
+	{
+		if (!std::filesystem::exists(resultsPath))
+			return {};
+		const auto [header, lines] = readResults(resultsPath);
+		const json expected = headerJson();
+		if (header.is_discarded() || !header.is_object() || !header.contains("sweep")
+			|| header.value("architecture_hash", std::string()) != architectureHash
+			|| specificationWithoutPath(header["sweep"]) != specificationWithoutPath(expected["sweep"]))
+		{
+			throw Exception(std::format("ParameterSweep: '{}' holds the results of a different sweep "
+				"(or a different base architecture); refusing to resume into it.", resultsPath.string()));
+		}
+
+		std::unordered_set<std::size_t> seen;
+		std::vector<std::size_t> indices;
+		for (const auto& line : lines)
+		{
+			const auto index = line["variant"].get<std::size_t>();
+			if (index < variants.size() && seen.insert(index).second)
+				indices.push_back(index);
+		}
+		std::ranges::sort(indices);
+		return indices;
+	}
+
+	namespace
+	{
+		struct SweepRun
+		{
+			const ParameterSweep* sweep = nullptr;
+			std::vector<const SweepVariant*> todo;
+			std::vector<SweepResult> results;
+			std::ofstream* out = nullptr;
+			const std::function<void(const SweepResult&, std::size_t, std::size_t)>* onResult = nullptr;
+			std::size_t done = 0;
+			std::size_t total = 0;
+			std::mutex mutex;
+			std::atomic<std::size_t> pending{ 0 };
+
+			static void runOne(void* context, std::size_t index)
+			{
+				auto& self = *static_cast<SweepRun*>(context);
+				SweepResult result = self.sweep->runVariant(*self.todo[index]);
+				{
+					const std::lock_guard<std::mutex> lock(self.mutex);
+					*self.out << self.sweep->resultJson(result).dump() << '\n';
+					self.out->flush();
+					++self.done;
+					if (*self.onResult)
+						(*self.onResult)(result, self.done, self.total);
+					self.results[index] = std::move(result);
+				}
+				self.pending.fetch_sub(1, std::memory_order_acq_rel);
+			}
+		};
+	}
+
+	std::vector<SweepResult> ParameterSweep::run(const std::filesystem::path& resultsPath, int concurrency, bool resume,
+	                                             const std::function<void(const SweepResult&, std::size_t, std::size_t)>& onResult) const
+	{
+		std::vector<json> kept;
+		std::unordered_set<std::size_t> completed;
+		if (resume && std::filesystem::exists(resultsPath))
+		{
+			for (const std::size_t index : completedVariants(resultsPath))
+				completed.insert(index);
+			// Keep one line per completed variant, and drop the torn line (if any)
+			// by rewriting the file rather than appending after it.
+			std::unordered_set<std::size_t> written;
+			for (auto& line : readResults(resultsPath).second)
+			{
+				const auto index = line["variant"].get<std::size_t>();
+				if (completed.contains(index) && written.insert(index).second)
+					kept.push_back(std::move(line));
+			}
+		}
+
+		if (resultsPath.has_parent_path())
+			std::filesystem::create_directories(resultsPath.parent_path());
+		// The header and the kept lines go to a temporary file that replaces the
+		// results only once it is complete, so a crash or a full disk during the
+		// rewrite leaves the completed results where they were.
+		std::filesystem::path temporary = resultsPath;
+		temporary += ".tmp";
+		{
+			std::ofstream rewrite(temporary, std::ios::trunc);
+			if (rewrite)
+			{
+				rewrite << headerJson().dump() << '\n';
+				for (const auto& line : kept)
+					rewrite << line.dump() << '\n';
+				rewrite.close();
+			}
+			std::error_code error;
+			if (rewrite.fail())
+			{
+				std::filesystem::remove(temporary, error);
+				throw Exception(std::format("ParameterSweep: cannot write '{}'.", temporary.string()));
+			}
+			std::filesystem::rename(temporary, resultsPath, error);
+			if (error)
+			{
+				std::error_code ignored;
+				std::filesystem::remove(temporary, ignored);
+				throw Exception(std::format("ParameterSweep: cannot replace '{}': {}.", resultsPath.string(), error.message()));
+			}
+		}
+		std::ofstream out(resultsPath, std::ios::app);
+		if (!out)
+			throw Exception(std::format("ParameterSweep: cannot write '{}'.", resultsPath.string()));
+
+		SweepRun state;
+		state.sweep = this;
+		state.out = &out;
+		state.onResult = &onResult;
+		state.done = completed.size();
+		state.total = variants.size();
+		for (const auto& variant : variants)
+		{
+			if (!completed.contains(variant.index))
+				state.todo.push_back(&variant);
+		}
+		state.results.resize(state.todo.size());
+		if (state.todo.empty())
+			return {};
+		prepareFftPlans();
+
+		// Each variant is one task; a variant's Simulation steps on the thread
+		// that picked it up (its own thread count stays 1).
+		tools::threading::ThreadPool pool(std::clamp(concurrency, 1, static_cast<int>(state.todo.size())));
+		state.pending.store(state.todo.size(), std::memory_order_release);
+		for (std::size_t i = 0; i < state.todo.size(); ++i)
+			pool.submit(tools::threading::Task{ &SweepRun::runOne, &state, i });
+		pool.runUntil(state.pending);
+		return std::move(state.results);
+	}
+}
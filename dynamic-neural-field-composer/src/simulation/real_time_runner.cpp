@@ -0,0 +1,277 @@
+#include "simulation/real_time_runner.h"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "exceptions/exception.h"
+#include "tools/latency_histogram.h"
+#include "tools/logger.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+
+		void addNote(RealTimeStats& stats, const std::string& note)
+		{
+			stats.note += stats.note.empty() ? note : "; " + note;
+		}
+
+		// Gives the calling thread the requested policy and affinity, and puts back
+		// what it had when destroyed.
+		class ThreadScheduling
+		{
+		public:
+			ThreadScheduling(int priority, int cpu, RealTimeStats& stats)
+			{
+#if defined(__linux__)
+				const pthread_t self = pthread_self();
+				if (cpu >= 0)
+				{
+					cpu_set_t set;
+					CPU_ZERO(&set);
+					if (cpu >= CPU_SETSIZE)
+					{
+						addNote(stats, std::format("not pinned: CPU {} is out of range", cpu));
+					}
+					else if (const int error = pthread_getaffinity_np(self, sizeof(previousAffinity), &previousAffinity); error != 0)
+					{
+						addNote(stats, std::format("not pinned: {}", std::strerror(error)));
+					}
+					else
+					{
+						CPU_SET(cpu, &set);
+						const int pinError = pthread_setaffinity_np(self, sizeof(set), &set);
+						pinned = pinError == 0;
+						if (!pinned)
+						{
+							addNote(stats, std::format("not pinned to CPU {}: {}", cpu, std::strerror(pinError)));
+						}
+					}
+				}
+				if (priority > 0)
+				{
+					pthread_getschedparam(self, &previousPolicy, &previousParameters);
+					sched_param parameters{};
+					parameters.sched_priority = priority;
+					const int error = pthread_setschedparam(self, SCHED_FIFO, &parameters);
+					raised = error == 0;
+					if (!raised)
+					{
+						addNote(stats, std::format("SCHED_FIFO priority {} not applied: {}{}", priority, std::strerror(error),
+							error == EPERM ? " (needs CAP_SYS_NICE or an rtprio limit)" : ""));
+					}
+				}
+#else
+				if (priority > 0 || cpu >= 0)
+				{
+					addNote(stats, "SCHED_FIFO and CPU pinning are only supported on Linux");
+				}
+#endif
+				stats.realTimePriority = raised;
+				stats.pinned = pinned;
+			}
+
+			~ThreadScheduling()
+			{
+#if defined(__linux__)
+				const pthread_t self = pthread_self();
+				if (raised)
+				{
+					pthread_setschedparam(self, previousPolicy, &previousParameters);
+				}
+				if (pinned)
+				{
+					pthread_setaffinity_np(self, sizeof(previousAffinity), &previousAffinity);
+				}
+#endif
+			}
+
+			ThreadScheduling(const ThreadScheduling&) = delete;
+			ThreadScheduling& operator=(const ThreadScheduling&) = delete;
+
+		private:
+			bool raised = false;
+			bool pinned = false;
+#if defined(__linux__)
+			int previousPolicy = SCHED_OTHER;
+			sched_param previousParameters{};
+			cpu_set_t previousAffinity{};
+#endif
+		};
+
+		// Returns at once if the deadline has passed.
+		void sleepUntil(Clock::time_point deadline)
+		{
+#if defined(__linux__)
+			// steady_clock is CLOCK_MONOTONIC on Linux, so its time points are
+			// absolute times on the clock clock_nanosleep waits on.
+			const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+			timespec until{};
+			until.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+			until.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR)
+			{
+			}
+#else
+			std::this_thread::sleep_until(deadline);
+#endif
+		}
+	}
+
+	RealTimeRunner::RealTimeRunner(std::shared_ptr<Simulation> simulation, RealTimeOptions options)
+		: simulation(std::move(simulation)), options(options)
+	{
+		if (!this->simulation)
+		{
+			throw Exception("RealTimeRunner: the simulation is null.");
+		}
+		if (options.period <= std::chrono::nanoseconds::zero())
+		{
+			throw Exception(std::format("RealTimeRunner: the period must be positive, got {} ns.", options.period.count()));
+		}
+		if (options.priority < 0 || options.priority > 99)
+		{
+			throw Exception(std::format("RealTimeRunner: SCHED_FIFO priority must be 0 to 99, got {}.", options.priority));
+		}
+	}
+
+	RealTimeStats RealTimeRunner::run(std::uint64_t periods, const std::function<void(const RealTimePeriod&)>& onPeriod)
+	{
+		RealTimeStats stats;
+		stats.period = options.period;
+		stopRequested.store(false, std::memory_order_relaxed);
+		if (periods == 0)
+		{
+			return stats;
+		}
+		if (!simulation->isInitialized())
+		{
+			simulation->init();
+		}
+
+		tools::profiling::LatencyHistogram jitter;
+		tools::profiling::LatencyHistogram stepTimes;
+		tools::profiling::LatencyHistogram slacks;
+		std::int64_t slackTotal = 0;
+		std::int64_t slackMin = std::numeric_limits<std::int64_t>::max();
+
+		const ThreadScheduling scheduling(options.priority, options.cpu, stats);
+		if (!stats.note.empty())
+		{
+			tools::logger::log(tools::logger::LogLevel::WARNING, std::format("Real-time run: {}.", stats.note));
+		}
+		const auto period = std::chrono::duration_cast<Clock::duration>(options.period);
+		const auto start = Clock::now();
+		auto deadline = start;
+		auto end = start;
+		bool catchingUp = false;
+		std::uint64_t index = 0;
+
+		while (index < periods && !stopRequested.load(std::memory_order_relaxed))
+		{
+			if (!catchingUp)
+			{
+				sleepUntil(deadline);
+			}
+			const auto begin = Clock::now();
+			simulation->step();
+			end = Clock::now();
+
+			RealTimePeriod timing;
+			timing.index = index++;
+			timing.lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - deadline);
+			timing.stepTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
+			auto next = deadline + period;
+			timing.slack = std::chrono::duration_cast<std::chrono::nanoseconds>(next - end);
+
+			++stats.steps;
+			if (catchingUp)
+			{
+				++stats.lateStarts;
+			}
+			else
+			{
+				jitter.record(std::max(timing.lateness, std::chrono::nanoseconds::zero()));
+			}
+			stepTimes.record(timing.stepTime);
+			slacks.record(std::max(timing.slack, std::chrono::nanoseconds::zero()));
+			slackTotal += timing.slack.count();
+			slackMin = std::min(slackMin, static_cast<std::int64_t>(timing.slack.count()));
+
+			if (end > next)
+			{
+				if (!catchingUp)
+				{
+					++stats.overruns;
+				}
+				// Deadlines already past when the step ended, the next one included.
+				const auto behind = static_cast<std::uint64_t>((end - next) / period) + 1;
+				std::uint64_t drop = 0;
+				if (options.overrunPolicy == OverrunPolicy::Skip)
+				{
+					drop = behind;
+				}
+				else if (behind > options.maxCatchUp)
+				{
+					drop = behind - options.maxCatchUp;
+				}
+				drop = std::min(drop, periods - index);
+				next += static_cast<Clock::duration::rep>(drop) * period;
+				index += drop;
+				stats.skipped += drop;
+				timing.skipped = drop;
+			}
+			catchingUp = next <= end;
+			deadline = next;
+
+			if (onPeriod)
+			{
+				onPeriod(timing);
+			}
+		}
+
+		stats.periods = index;
+		stats.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+		const auto jitterSnapshot = jitter.snapshot();
+		stats.jitterP50 = jitterSnapshot.percentile(0.50);
+		stats.jitterP99 = jitterSnapshot.percentile(0.99);
+		stats.jitterMax = jitterSnapshot.max;
+		const auto stepSnapshot = stepTimes.snapshot();
+		stats.stepP50 = stepSnapshot.percentile(0.50);
+		stats.stepP99 = stepSnapshot.percentile(0.99);
+		stats.stepMax = stepSnapshot.max;
+		if (stats.steps > 0)
+		{
+			stats.slackMin = std::chrono::nanoseconds(slackMin);
+			stats.slackP01 = slacks.snapshot().percentile(0.01);
+			stats.slackMean = std::chrono::nanoseconds(slackTotal / static_cast<std::int64_t>(stats.steps));
+		}
+
+		tools::logger::log(tools::logger::LogLevel::INFO, std::format(
+			"Real-time run of '{}': {} periods of {} us, {} steps, {} overruns, {} skipped, jitter p99 {} us.",
+			simulation->getUniqueIdentifier(), stats.periods, options.period.count() / 1000, stats.steps,
+			stats.overruns, stats.skipped, stats.jitterP99.count() / 1000));
+		return stats;
+	}
+
+	RealTimeStats RealTimeRunner::runFor(std::chrono::nanoseconds duration, const std::function<void(const RealTimePeriod&)>& onPeriod)
+	{
+		if (duration <= std::chrono::nanoseconds::zero())
+		{
+			return run(0, onPeriod);
+		}
+		return run(static_cast<std::uint64_t>((duration + options.period - std::chrono::nanoseconds(1)) / options.period), onPeriod);
+	}
+}
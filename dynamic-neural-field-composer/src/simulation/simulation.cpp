@@ -1,6 +1,7 @@
 ﻿#include "simulation/simulation.h"
 #include "simulation/simulation_file_manager.h"
 #include "tools/utils.h"
+#include <algorithm>
 #include <format>
 
 
@@ -39,7 +40,10 @@ namespace dnf_composer
 			uniqueIdentifier(other.uniqueIdentifier), 
 			deltaT(other.deltaT),
 			tZero(other.tZero),
-			t(other.t) 
+			t(other.t),
+			threadCount(other.threadCount),
+			updateMode(other.updateMode),
+			spectrumSharing(other.spectrumSharing)
 	{
 		// Deep copy of elements vector, assuming Element has a clone() method
 		elements.reserve(other.elements.size());
@@ -63,6 +67,13 @@ namespace dnf_composer
 		deltaT = other.deltaT;
 		tZero = other.tZero;
 		t = other.t;
+		setThreadCount(other.threadCount);
+		updateMode = other.updateMode;
+		spectrumSharing = other.spectrumSharing;
+		if (spectralSharing)
+		{
+			spectralSharing->clear();
+		}
 
 		// Clear the current elements and deep copy from other
 		elements.clear();
@@ -81,7 +92,15 @@ namespace dnf_composer
 		uniqueIdentifier(std::move(other.uniqueIdentifier)), // std::move for std::string and similar
 		deltaT(other.deltaT),
 		tZero(other.tZero),
-		t(other.t)
+		t(other.t),
+		threadCount(other.threadCount),
+		updateMode(other.updateMode),
+		threadPool(std::move(other.threadPool)),
+		scheduler(std::move(other.scheduler)),
+		spectrumSharing(other.spectrumSharing),
+		spectralSharing(std::move(other.spectralSharing)),
+		profiling(other.profiling),
+		profiler(std::move(other.profiler))
 	{
 		// Set the source object's basic types to default values if necessary
 		other.initialized = false;
@@ -108,6 +127,14 @@ namespace dnf_composer
 		deltaT = other.deltaT;
 		tZero = other.tZero;
 		t = other.t;
+		threadCount = other.threadCount;
+		updateMode = other.updateMode;
+		threadPool = std::move(other.threadPool);
+		scheduler = std::move(other.scheduler);
+		spectrumSharing = other.spectrumSharing;
+		spectralSharing = std::move(other.spectralSharing);
+		profiling = other.profiling;
+		profiler = std::move(other.profiler);
 
 		// Reset the source object's state
 		other.initialized = false;
@@ -124,6 +151,8 @@ namespace dnf_composer
 
 	void Simulation::init()
 	{
+		tools::trace::startFromEnvironment();
+		const tools::trace::Span span("Simulation::init", "simulation");
 		paused = false;
 		t = tZero;
 		accumulatedRunDuration = std::chrono::nanoseconds{ 0 };
@@ -132,10 +161,30 @@ namespace dnf_composer
 		{
 			element->init();
 		}
+		// Front buffers must exist before buildInputCache() so consumers cache a
+		// pointer to the snapshot, not the live component.
+		for (const auto& element : elements)
+		{
+			element->setFrontBuffered(updateMode == UpdateMode::Synchronous);
+		}
+		packComponentArena();
 		for (const auto& element : elements)
 		{
 			element->buildInputCache();
 		}
+		if (threadCount > 1)
+		{
+			if (!scheduler)
+			{
+				scheduler = std::make_unique<ElementScheduler>();
+			}
+			scheduler->build(elements, updateMode == UpdateMode::Synchronous);
+		}
+		if (!spectralSharing)
+		{
+			spectralSharing = std::make_unique<SpectralSharing>();
+		}
+		spectralSharing->build(elements, updateMode == UpdateMode::Synchronous, spectrumSharing);
 
 		const std::string defaultDir = tools::utils::getResourceRoot() + "/data";
 		const std::string simDir = (std::filesystem::path(tools::utils::getResourceRoot()) / "data" / uniqueIdentifier).string();
@@ -161,30 +210,188 @@ namespace dnf_composer
 		{
 			return;
 		}
+		const tools::trace::Span span("Simulation::step", "simulation");
 		if (measureStepDuration)
 		{
 			const auto t0 = std::chrono::steady_clock::now();
 			t += deltaT;
-			for (const auto& element : elements) {
-				element->step(t, deltaT);
-}
+			stepElements();
 			lastStepDuration = std::chrono::duration_cast<std::chrono::nanoseconds>(
 				std::chrono::steady_clock::now() - t0);
 		}
 		else
 		{
 			t += deltaT;
-			for (const auto& element : elements) {
-				element->step(t, deltaT);
-}
+			stepElements();
 		}
 		recorder.update(*this);
+		checkpointer.update(*this);
+	}
+
+	void Simulation::stepElements()
+	{
+		prepareSpectralSharing();
+		if (threadCount <= 1)
+		{
+			// No pool for intra-element chunks either, even when this simulation
+			// is stepped from inside another pool's task (a sweep variant).
+			const tools::threading::ScopedCurrentPool serial(nullptr);
+			const bool tracing = tools::trace::isActive();
+			if (profiling || tracing)
+			{
+				if (profiling)
+				{
+					profiler->sync(elements);
+				}
+				for (std::size_t i = 0; i < elements.size(); ++i)
+				{
+					const auto t0 = std::chrono::steady_clock::now();
+					elements[i]->step(t, deltaT);
+					const auto t1 = std::chrono::steady_clock::now();
+					if (profiling)
+					{
+						profiler->record(i, t1 - t0);
+					}
+					if (tracing)
+					{
+						tools::trace::record(elements[i]->getUniqueName(), "element", t0, t1);
+					}
+				}
+			}
+			else
+			{
+				for (const auto& element : elements) {
+					element->step(t, deltaT);
+}
+			}
+			publishFrontBuffers();
+			return;
+		}
+
+		if (!threadPool)
+		{
+			threadPool = std::make_unique<tools::threading::ThreadPool>(threadCount);
+		}
+		if (!scheduler)
+		{
+			scheduler = std::make_unique<ElementScheduler>();
+		}
+		// Elements can be added, removed, reset or rewired between steps (the GUI
+		// does all of these on a running simulation), so re-validate the graph
+		// every step; the check is a revision compare plus a pointer walk.
+		if (!scheduler->isCurrent(elements))
+		{
+			scheduler->build(elements, updateMode == UpdateMode::Synchronous);
+		}
+		if (profiling)
+		{
+			profiler->sync(elements);
+		}
+		const tools::threading::ScopedCurrentPool current(threadPool.get());
+		scheduler->step(*threadPool, t, deltaT, profiling ? profiler.get() : nullptr);
+		publishFrontBuffers();
+	}
+
+	void Simulation::prepareSpectralSharing()
+	{
+		if (!spectralSharing)
+		{
+			spectralSharing = std::make_unique<SpectralSharing>();
+		}
+		// Same re-validation as the scheduler's: kernels can be re-parameterised
+		// (and so re-planned) between steps, not only rewired.
+		if (!spectralSharing->isCurrent(elements))
+		{
+			spectralSharing->build(elements, updateMode == UpdateMode::Synchronous, spectrumSharing);
+		}
+		spectralSharing->beginStep();
+	}
+
+	void Simulation::publishFrontBuffers() const
+	{
+		if (updateMode != UpdateMode::Synchronous)
+		{
+			return;
+		}
+		// Runs after every element has stepped, so no element is still reading
+		// the buffers being overwritten. A plain serial copy: it is a memcpy of
+		// each element's output (and activation), small next to the step itself.
+		for (const auto& element : elements)
+		{
+			element->publishFrontBuffers();
+		}
+	}
+
+	void Simulation::packComponentArena() const
+	{
+		// Sizes are only final once every element has initialised (kernels size
+		// their "input" and "kernel" in init()), so this runs after init() and
+		// copies the values across. A component that later outgrows its region
+		// (changeDimensions(), a wider kernel) moves to storage of its own until
+		// the next init() packs it again.
+		std::size_t size = 0;
+		for (const auto& element : elements)
+		{
+			size += element->getComponentArenaFootprint();
+		}
+		const auto arena = std::make_shared<element::ComponentArena>(size);
+		std::size_t offset = 0;
+		for (const auto& element : elements)
+		{
+			element->bindComponentArena(arena, offset);
+		}
+	}
+
+	void Simulation::setUpdateMode(UpdateMode mode)
+	{
+		if (mode == updateMode)
+		{
+			return;
+		}
+		updateMode = mode;
+		for (const auto& element : elements)
+		{
+			element->setFrontBuffered(updateMode == UpdateMode::Synchronous);
+		}
+		if (scheduler)
+		{
+			scheduler->clear();
+		}
+		if (spectralSharing)
+		{
+			spectralSharing->clear();
+		}
+	}
+
+	void Simulation::setSpectrumSharing(SpectrumSharing mode)
+	{
+		spectrumSharing = mode;
+		if (spectralSharing)
+		{
+			spectralSharing->clear();
+		}
+	}
+
+	void Simulation::setThreadCount(int threads)
+	{
+		threads = std::max(threads, 1);
+		if (threads == threadCount)
+		{
+			return;
+		}
+		threadCount = threads;
+		threadPool.reset();
+		if (scheduler)
+		{
+			scheduler->clear();
+		}
 	}
 
 	void Simulation::close()
 	{
 		pause();
 		recorder.stopAll();
+		checkpointer.stop();
 		for (const auto& element : elements)
 		{
 			element->close();
@@ -228,8 +435,17 @@ namespace dnf_composer
 	void Simulation::clean()
 	{
 		recorder.stopAll();
+		checkpointer.stop();
 		disconnectAllElements();
+		if (spectralSharing)
+		{
+			spectralSharing->clear();
+		}
 		elements.clear();
+		if (scheduler)
+		{
+			scheduler->clear();
+		}
 		initialized = false;
 		paused = false;
 		t = tZero;
@@ -318,6 +534,10 @@ namespace dnf_composer
 
 		elements.emplace_back(element);
 		element->init();
+		if (updateMode == UpdateMode::Synchronous)
+		{
+			element->setFrontBuffered(true);
+		}
 
 		const std::string logMessage = std::format("Element '{}' was added to the simulation.", newElementName);
 		log(tools::logger::LogLevel::INFO, logMessage);
@@ -334,6 +554,9 @@ namespace dnf_composer
 		{
 			if (elements[i]->getUniqueName() == elementId)
 			{
+				// The caller may keep the element; give it storage of its own
+				// rather than let it pin this simulation's whole arena.
+				elements[i]->releaseComponentArena();
 				elements.erase(elements.begin() + i);
 				const std::string logMessage = std::format("Element '{}' was removed from the simulation.", elementId);
 				log(tools::logger::LogLevel::INFO, logMessage);
@@ -354,6 +577,10 @@ namespace dnf_composer
 			{
 				element = newElement;
 				element->init();
+				if (updateMode == UpdateMode::Synchronous)
+				{
+					element->setFrontBuffered(true);
+				}
 				const std::string logMessage = std::format("Element '{}' was reset in the simulation.", idOfElementToReset);
 				log(tools::logger::LogLevel::INFO, logMessage);
 				elementFound = true;
@@ -402,6 +629,10 @@ namespace dnf_composer
 			return;
 		}
 		elem->setUniqueName(newName);
+		if (profiler)
+		{
+			profiler->rename(elem);
+		}
 		log(tools::logger::LogLevel::INFO, std::format("Element '{}' renamed to '{}'.", oldName, newName));
 	}
 
@@ -488,7 +719,7 @@ namespace dnf_composer
 		return foundElement->getComponent(componentName);
 	}
 
-	std::vector<double>* Simulation::getComponentPtr(const std::string& id, const std::string& componentName) const
+	element::ComponentBuffer* Simulation::getComponentPtr(const std::string& id, const std::string& componentName) const
 	{
 		const std::shared_ptr<element::Element> foundElement = getElement(id);
 		if (!foundElement)
@@ -555,6 +786,48 @@ namespace dnf_composer
 		return lastStepDuration;
 	}
 
+	void Simulation::setProfiling(bool enable)
+	{
+		if (enable && !profiler)
+		{
+			profiler = std::make_unique<StepProfiler>();
+		}
+		profiling = enable;
+	}
+
+	void Simulation::startTrace(const std::string& filePath)
+	{
+		std::string path = filePath;
+		if (path.empty())
+		{
+			const auto time_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+			std::tm tm{};
+			tools::utils::safe_localtime(&time_t, &tm);
+			std::ostringstream name;
+			name << uniqueIdentifier << "_" << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S") << ".json";
+			path = (std::filesystem::path(tools::utils::getResourceRoot()) / "data" / uniqueIdentifier / "traces" / name.str()).string();
+		}
+		tools::trace::start(path);
+	}
+
+	std::string Simulation::stopTrace()
+	{
+		return tools::trace::stop();
+	}
+
+	StepProfile Simulation::getProfile() const
+	{
+		return profiler ? profiler->profile() : StepProfile{};
+	}
+
+	void Simulation::resetProfile()
+	{
+		if (profiler)
+		{
+			profiler->reset();
+		}
+	}
+
 	std::chrono::nanoseconds Simulation::getTotalRunDuration() const
 	{
 		if (paused)
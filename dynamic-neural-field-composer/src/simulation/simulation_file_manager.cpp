@@ -196,6 +196,11 @@ namespace dnf_composer
             return;
         }
 
+        loadElementsFromJson(root);
+    }
+
+    void SimulationFileManager::loadElementsFromJson(const json& root) const
+    {
         // extractElementsAndMetadata() applies "identifier" and "deltaT" as a side effect,
         // but the load is not committed until every element is built. Capture them first
         // so a failed build can put them back: rolling back only the elements would leave
@@ -378,6 +383,8 @@ namespace dnf_composer
             elementJson["learningRule"] = fieldCouplingParameters.learningRule;
             elementJson["scalar"] = fieldCouplingParameters.scalar;
             elementJson["decayRate"] = fieldCouplingParameters.decayRate;
+            elementJson["weightStorage"] = static_cast<int>(fieldCouplingParameters.weightStorage);
+            elementJson["pruneThreshold"] = fieldCouplingParameters.pruneThreshold;
             elementJson["input_x_max"] = fieldCouplingParameters.inputFieldDimensions.x_max;
             elementJson["input_d_x"] = fieldCouplingParameters.inputFieldDimensions.d_x;
         }
@@ -388,6 +395,7 @@ namespace dnf_composer
             const auto gaussFieldCouplingParameters = gaussFieldCoupling->getParameters();
             elementJson["circular"] = gaussFieldCouplingParameters.circular;
             elementJson["normalized"] = gaussFieldCouplingParameters.normalized;
+            elementJson["evaluation"] = static_cast<int>(gaussFieldCouplingParameters.evaluation);
             elementJson["input_x_max"] = gaussFieldCouplingParameters.inputFieldDimensions.x_max;
             elementJson["input_d_x"] = gaussFieldCouplingParameters.inputFieldDimensions.d_x;
             elementJson["couplings"] = json::array();
@@ -860,6 +868,9 @@ namespace dnf_composer
                 // before decayRate existed don't have this key at all, and must still
                 // load (at 0.0, i.e. decay disabled) rather than throw.
                 const double decayRate = elementJson.value("decayRate", 0.0);
+                // Files written before sparse weight storage existed are dense.
+                const auto weightStorage = static_cast<WeightStorage>(elementJson.value("weightStorage", 0));
+                const double pruneThreshold = elementJson.value("pruneThreshold", 0.0);
                 // Unlike the keys above, the input field's own dimensions have a genuine
                 // default: FieldCouplingParameters defaults inputFieldDimensions to
                 // ElementDimensions{} (x_max 100, d_x 1.0) when none is supplied, so an
@@ -877,7 +888,8 @@ namespace dnf_composer
                     ? elementJson["input_d_x"].get<double>() : defaultInputDimensions.d_x;
                 auto coupling = std::make_shared<element::FieldCoupling>(
                     element::ElementCommonParameters(uniqueName, element::ElementDimensions(x_max, d_x)),
-                    element::FieldCouplingParameters(element::ElementDimensions(input_x_max, input_d_x), learningRule, scalar, learningRate, decayRate)
+                    element::FieldCouplingParameters(element::ElementDimensions(input_x_max, input_d_x), learningRule, scalar, learningRate, decayRate,
+                        weightStorage, pruneThreshold)
                 );
                 simulation->addElement(coupling);
             }
@@ -886,6 +898,9 @@ namespace dnf_composer
             {
 				const bool circular = elementJson.at("circular");
                 const bool normalized = elementJson.at("normalized");
+                // Files written before the evaluation modes existed are dense.
+                const auto evaluation = static_cast<element::GaussCouplingEvaluation>(
+                    elementJson.contains("evaluation") ? elementJson["evaluation"].get<int>() : 0);
                 // Same genuine, all-or-nothing default as FIELD_COUPLING above:
                 // GaussFieldCouplingParameters defaults inputFieldDimensions to
                 // ElementDimensions{} (x_max 100, d_x 1.0) unless both keys are present.
@@ -912,7 +927,7 @@ namespace dnf_composer
 
                 auto coupling = std::make_shared<element::GaussFieldCoupling>(
 					element::ElementCommonParameters(uniqueName, element::ElementDimensions(x_max, d_x)),
-                    element::GaussFieldCouplingParameters(element::ElementDimensions(input_x_max, input_d_x), normalized, circular, couplings)
+                    element::GaussFieldCouplingParameters(element::ElementDimensions(input_x_max, input_d_x), normalized, circular, couplings, evaluation)
 				);
                 simulation->addElement(coupling);
             }
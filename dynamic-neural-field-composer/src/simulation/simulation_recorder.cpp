@@ -1,7 +1,11 @@
 #include "simulation/simulation_recorder.h"
 #include "simulation/simulation.h"
+#include "elements/neural_field.h"
+#include "elements/neural_field_2d.h"
 #include "tools/utils.h"
 #include "tools/logger.h"
+#include "tools/recording_file.h"
+#include "tools/trace.h"
 
 #include <algorithm>
 #include <filesystem>
@@ -38,35 +42,74 @@ namespace dnf_composer
 		}
 	}
 
-	void SimulationRecorder::writeHeader(std::ofstream& file, const size_t componentSize,
-	                                     const int sizeX, const int sizeY)
+	SimulationRecorder::SimulationRecorder()
 	{
-		if (sizeY > 1) {
-			file << "# size_x=" << sizeX << ",size_y=" << sizeY << "\n";
-}
-		file << "ticks,ms";
-		for (size_t i = 0; i < componentSize; ++i) {
-			file << "," << i;
-}
-		file << "\n";
+		stats.capacity = queuePolicy.capacity;
 	}
 
-	void SimulationRecorder::writeRow(std::ofstream& file, const int ticks, const double ms,
-	                                  const std::vector<double>& component)
+	SimulationRecorder::~SimulationRecorder()
 	{
-		file << ticks << "," << std::fixed << std::setprecision(6) << ms;
-		for (const double v : component) {
-			file << "," << v;
-}
-		file << "\n";
+		stopWriter();
 	}
 
 	bool SimulationRecorder::startRecording(const std::string& simName,
 	                                        const std::string& elementId,
 	                                        const std::string& componentName,
 	                                        const int sampleInterval,
-	                                        const RecordingIntervalUnit unit)
+	                                        const RecordingIntervalUnit unit,
+	                                        const RecordingFormat format)
 	{
+		RecordingOptions options;
+		options.sampleInterval = sampleInterval;
+		options.unit = unit;
+		options.format = format;
+		return startRecording(simName, elementId, componentName, options);
+	}
+
+	bool SimulationRecorder::startRecording(const std::string& simName,
+	                                        const std::string& elementId,
+	                                        const std::string& componentName,
+	                                        const RecordingOptions& options)
+	{
+		std::string problem;
+		const RecordingRegion& region = options.region;
+		if (region.x < 0 || region.y < 0 || region.width < 0 || region.height < 0)
+		{
+			problem = "the region has a negative position or size";
+		}
+		else if (region.strideX < 1 || region.strideY < 1)
+		{
+			problem = "region strides must be at least 1";
+		}
+		else if (options.trigger.preSamples < 0 || options.trigger.postSamples < 0)
+		{
+			problem = "trigger sample counts must not be negative";
+		}
+		else if (options.codec.codec != tools::recording_file::RecordingCodec::None)
+		{
+			if (options.format != RecordingFormat::Binary)
+			{
+				problem = "codecs apply to binary recordings only";
+			}
+			else
+			{
+				try
+				{
+					tools::recording_file::validate(options.codec);
+				}
+				catch (const std::invalid_argument& e)
+				{
+					problem = e.what();
+				}
+			}
+		}
+		if (!problem.empty())
+		{
+			tools::logger::log(tools::logger::LogLevel::ERROR,
+				std::format("Recording not started for '{}' / '{}': {}.", elementId, componentName, problem));
+			return false;
+		}
+
 		if (isRecording(elementId, componentName))
 		{
 			tools::logger::log(tools::logger::LogLevel::WARNING,
@@ -94,17 +137,16 @@ namespace dnf_composer
 			return false;
 		}
 
-		const std::string filename = (dir / (elementId + "_" + componentName + "_" + makeTimestamp() + ".csv")).string();
+		const bool binary = options.format == RecordingFormat::Binary;
+		const std::string filename = (dir / (elementId + "_" + componentName + "_" + makeTimestamp()
+			+ (binary ? ".dnfr" : ".csv"))).string();
 
-		Session session;
-		session.elementId       = elementId;
-		session.componentName   = componentName;
-		session.sampleInterval  = sampleInterval;
-		session.unit            = unit;
-		session.nextSampleAt    = 0.0;
-		session.file.open(filename);
+		auto sink = std::make_shared<Sink>();
+		sink->format   = options.format;
+		sink->filename = filename;
+		sink->file.open(filename, binary ? std::ios::out | std::ios::binary : std::ios::out);
 
-		if (!session.file.is_open())
+		if (!sink->file.is_open())
 		{
 			tools::logger::log(tools::logger::LogLevel::ERROR,
 				R"(Recording not started: failed to open recording file ")" + filename +
@@ -112,9 +154,17 @@ namespace dnf_composer
 			return false;
 		}
 
+		Session session;
+		session.elementId       = elementId;
+		session.componentName   = componentName;
+		session.options         = options;
+		session.sink            = std::move(sink);
+		session.nextSampleAt    = 0.0;
+
 		tools::logger::log(tools::logger::LogLevel::INFO,
 			std::format("Recording started: {}", filename));
 
+		startWriter();
 		sessions.push_back(std::move(session));
 		return true;
 	}
@@ -131,9 +181,9 @@ namespace dnf_composer
 			return;
 }
 
-		if (it->file.is_open()) {
-			it->file.close();
-}
+		// The session's frames may still be queued; the file closes with the
+		// last reference to its sink, which the writer has released once idle.
+		flush();
 
 		tools::logger::log(tools::logger::LogLevel::INFO,
 			std::format("Recording stopped for '{}' / '{}'.", elementId, componentName));
@@ -143,19 +193,418 @@ namespace dnf_composer
 
 	void SimulationRecorder::stopAll()
 	{
-		for (auto& s : sessions) {
-			if (s.file.is_open()) {
-				s.file.close();
-}
-}
+		stopWriter();
 		sessions.clear();
 	}
 
+	bool SimulationRecorder::setQueuePolicy(const RecordingQueuePolicy& policy)
+	{
+		if (!sessions.empty())
+		{
+			tools::logger::log(tools::logger::LogLevel::WARNING,
+				"Recording queue policy not changed: stop the active recordings first.");
+			return false;
+		}
+		stopWriter();
+		queuePolicy = policy;
+		queuePolicy.capacity = std::max<std::size_t>(queuePolicy.capacity, 1);
+		const std::lock_guard lock(mutex);
+		ring.clear();
+		stats.capacity = queuePolicy.capacity;
+		return true;
+	}
+
+	RecorderStats SimulationRecorder::getStats() const
+	{
+		const std::lock_guard lock(mutex);
+		RecorderStats result = stats;
+		result.queueDepth = depth;
+		return result;
+	}
+
+	void SimulationRecorder::flush()
+	{
+		std::unique_lock lock(mutex);
+		idle.wait(lock, [this] { return !writer.joinable() || (depth == 0 && !writing); });
+	}
+
+	void SimulationRecorder::startWriter()
+	{
+		if (writer.joinable())
+		{
+			return;
+		}
+		{
+			const std::lock_guard lock(mutex);
+			if (ring.size() != queuePolicy.capacity)
+			{
+				ring = std::vector<Frame>(queuePolicy.capacity);
+			}
+			head = 0;
+			depth = 0;
+			writing = false;
+			stopping = false;
+			stats = {};
+			stats.capacity = queuePolicy.capacity;
+		}
+		writer = std::thread(&SimulationRecorder::writerLoop, this);
+	}
+
+	void SimulationRecorder::stopWriter()
+	{
+		if (!writer.joinable())
+		{
+			return;
+		}
+		{
+			const std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		queued.notify_one();
+		writer.join();
+	}
+
+	bool SimulationRecorder::reserveSlot()
+	{
+		// update() is the only producer, so once there is room it stays there
+		// until pushSpare(): the writer can only take frames out.
+		std::unique_lock lock(mutex);
+		if (depth == ring.size())
+		{
+			switch (queuePolicy.overflow)
+			{
+			case RecordingOverflow::Block:
+			{
+				const auto t0 = std::chrono::steady_clock::now();
+				space.wait(lock, [this] { return depth < ring.size(); });
+				stats.blockedTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - t0);
+				break;
+			}
+			case RecordingOverflow::DropNewest:
+				++stats.framesDropped;
+				return false;
+			case RecordingOverflow::DropOldest:
+				ring[head].sink.reset();
+				head = (head + 1) % ring.size();
+				--depth;
+				++stats.framesDropped;
+				break;
+			}
+		}
+		return true;
+	}
+
+	void SimulationRecorder::pushSpare()
+	{
+		// The slot's old buffer becomes the next spare.
+		{
+			const std::lock_guard lock(mutex);
+			std::swap(ring[(head + depth) % ring.size()], spare);
+			++depth;
+			++stats.framesQueued;
+			stats.maxQueueDepth = std::max(stats.maxQueueDepth, depth);
+		}
+		queued.notify_one();
+	}
+
+	void SimulationRecorder::enqueue(const Session& s, const long long ticks, const double ms,
+	                                 const std::span<const double> component)
+	{
+		if (!reserveSlot())
+		{
+			return;
+		}
+		// Copied outside the lock.
+		spare.sink = s.sink;
+		spare.ticks = ticks;
+		spare.ms = ms;
+		s.select(component, spare.values);
+		pushSpare();
+	}
+
+	void SimulationRecorder::enqueueHistory(Session& s)
+	{
+		// The held samples are swapped into the queue rather than copied.
+		for (std::size_t k = 0; k < s.historyDepth; ++k)
+		{
+			Frame& held = s.history[(s.historyHead + k) % s.history.size()];
+			if (!reserveSlot())
+			{
+				continue;
+			}
+			spare.sink = s.sink;
+			spare.ticks = held.ticks;
+			spare.ms = held.ms;
+			std::swap(spare.values, held.values);
+			pushSpare();
+		}
+		s.historyHead = 0;
+		s.historyDepth = 0;
+	}
+
+	void SimulationRecorder::Session::select(const std::span<const double> component, std::vector<double>& out) const
+	{
+		if (whole)
+		{
+			out.assign(component.begin(), component.end());
+			return;
+		}
+		const int columns = sink->info.sizeX;
+		const int rows = sink->info.sizeY;
+		out.resize(frameValues);
+		double* dst = out.data();
+		for (int row = 0; row < rows; ++row)
+		{
+			const double* src = component.data()
+				+ static_cast<std::size_t>(region.originY + row * region.strideY) * static_cast<std::size_t>(sourceSizeX)
+				+ region.originX;
+			if (region.strideX == 1)
+			{
+				dst = std::copy_n(src, columns, dst);
+			}
+			else
+			{
+				for (int column = 0; column < columns; ++column)
+				{
+					*dst++ = src[static_cast<std::size_t>(column) * region.strideX];
+				}
+			}
+		}
+	}
+
+	bool SimulationRecorder::resolveFrame(Session& s, const element::Element& element, const std::size_t componentValues)
+	{
+		// A component that does not fill the element's grid (a kernel, say) is
+		// sampled as a 1D run of values.
+		const auto& dims = element.getElementCommonParameters().dimensionParameters;
+		const bool grid = static_cast<std::size_t>(dims.size_x) * static_cast<std::size_t>(dims.size_y) == componentValues;
+		const int sizeX = grid ? dims.size_x : static_cast<int>(componentValues);
+		const int sizeY = grid ? dims.size_y : 1;
+
+		const RecordingRegion& r = s.options.region;
+		if (r.x >= sizeX || r.y >= sizeY)
+		{
+			tools::logger::log(tools::logger::LogLevel::WARNING,
+				std::format("Stopping recording for '{}' / '{}': region origin ({}, {}) is outside the {} x {} component.",
+					s.elementId, s.componentName, r.x, r.y, sizeX, sizeY));
+			return false;
+		}
+		const int width = (r.width == 0 || r.width > sizeX - r.x) ? sizeX - r.x : r.width;
+		const int height = (r.height == 0 || r.height > sizeY - r.y) ? sizeY - r.y : r.height;
+		const int columns = (width + r.strideX - 1) / r.strideX;
+		const int rows = (height + r.strideY - 1) / r.strideY;
+
+		s.region = { r.x, r.y, r.strideX, r.strideY };
+		s.sourceSizeX = sizeX;
+		s.componentValues = componentValues;
+		s.frameValues = static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
+		s.whole = s.frameValues == componentValues;
+		if (s.whole)
+		{
+			s.region = {};
+		}
+		// Fixed before the writer can see a frame of this sink.
+		s.sink->info = { s.elementId, s.componentName, s.frameValues, grid ? columns : static_cast<int>(s.frameValues),
+			grid ? rows : 1, s.options.sampleInterval,
+			s.options.unit == RecordingIntervalUnit::Ticks ? tools::recording_file::SampleUnit::Ticks
+			                                               : tools::recording_file::SampleUnit::Milliseconds,
+			s.options.codec, s.region };
+		if (s.whole)
+		{
+			// Unchanged from an unrestricted recording, element dimensions included.
+			s.sink->info.sizeX = dims.size_x;
+			s.sink->info.sizeY = dims.size_y;
+		}
+
+		if (s.options.trigger.on != RecordingTrigger::None && s.options.trigger.preSamples > 0)
+		{
+			s.history.resize(static_cast<std::size_t>(s.options.trigger.preSamples));
+			for (Frame& held : s.history)
+			{
+				held.values.reserve(s.frameValues);
+			}
+		}
+		// The ring's buffers grow to the frame now rather than one by one.
+		const std::lock_guard lock(mutex);
+		for (Frame& frame : ring)
+		{
+			frame.values.reserve(s.frameValues);
+		}
+		spare.values.reserve(s.frameValues);
+		return true;
+	}
+
+	int SimulationRecorder::checkTrigger(Session& s, const Simulation& sim)
+	{
+		const RecordingTriggerOptions& trigger = s.options.trigger;
+		const std::string& watchedId = trigger.elementId.empty() ? s.elementId : trigger.elementId;
+		const auto observe = [&trigger](const auto& field) -> long long
+		{
+			switch (trigger.on)
+			{
+			case RecordingTrigger::StabilityChange:
+				return field.isStable() ? 1 : 0;
+			case RecordingTrigger::BumpCountChange:
+				return static_cast<long long>(field.getBumpCount());
+			case RecordingTrigger::ThresholdCrossing:
+				return field.getHighestActivation() >= trigger.threshold ? 1 : 0;
+			default:
+				return 0;
+			}
+		};
+
+		const auto element = sim.getElement(watchedId);
+		long long state = 0;
+		if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element))
+		{
+			state = observe(*field);
+		}
+		else if (const auto field2d = std::dynamic_pointer_cast<element::NeuralField2D>(element))
+		{
+			state = observe(*field2d);
+		}
+		else
+		{
+			tools::logger::log(tools::logger::LogLevel::WARNING,
+				std::format("Stopping recording for '{}' / '{}': trigger element '{}' is not a neural field.",
+					s.elementId, s.componentName, watchedId));
+			return -1;
+		}
+		const bool event = s.watched >= 0 && state != s.watched;
+		s.watched = state;
+		return event ? 1 : 0;
+	}
+
+	void SimulationRecorder::writerLoop()
+	{
+		tools::trace::setThreadName("recording writer");
+		Frame current;
+		std::vector<std::shared_ptr<Sink>> dirty; ///< Sinks written since the last flush.
+		std::unique_lock lock(mutex);
+		while (true)
+		{
+			queued.wait(lock, [this] { return stopping || depth > 0; });
+			if (depth == 0)
+			{
+				break; // stopping, nothing left to write
+			}
+			std::swap(current, ring[head]);
+			head = (head + 1) % ring.size();
+			--depth;
+			writing = true;
+			lock.unlock();
+			space.notify_one();
+
+			{
+				const tools::trace::Span span("recording write", "recorder");
+				writeFrame(current);
+			}
+			if (std::ranges::find(dirty, current.sink) == dirty.end())
+			{
+				dirty.push_back(current.sink);
+			}
+			current.sink.reset();
+
+			lock.lock();
+			++stats.framesWritten;
+			if (depth > 0)
+			{
+				continue;
+			}
+
+			// The queue ran dry: flush what was written, outside the lock.
+			lock.unlock();
+			std::uint64_t bytes = 0;
+			std::uint64_t failures = 0;
+			{
+				const tools::trace::Span span("recording flush", "recorder");
+				for (const auto& sink : dirty)
+				{
+					const bool failedBefore = sink->failed;
+					bytes += flushSink(*sink);
+					if (sink->failed && !failedBefore)
+					{
+						++failures;
+					}
+				}
+			}
+			dirty.clear();
+			lock.lock();
+			stats.bytesWritten += bytes;
+			stats.writeFailures += failures;
+			writing = false;
+			idle.notify_all();
+		}
+		idle.notify_all();
+	}
+
+	void SimulationRecorder::writeFrame(const Frame& frame)
+	{
+		Sink& sink = *frame.sink;
+		if (sink.failed)
+		{
+			return;
+		}
+		if (sink.format == RecordingFormat::Binary)
+		{
+			if (!sink.headerWritten)
+			{
+				tools::recording_file::writeHeader(sink.file, sink.info);
+				if (sink.info.codec.codec != tools::recording_file::RecordingCodec::None)
+				{
+					sink.encoder = std::make_unique<tools::recording_file::FrameEncoder>(sink.info.codec, sink.info.frameValues);
+				}
+				sink.headerWritten = true;
+			}
+			if (sink.encoder)
+			{
+				const bool keyframe = sink.encoder->encode(frame.values, sink.payload);
+				tools::recording_file::writeCodedFrame(sink.file, frame.ticks, frame.ms, keyframe, sink.payload);
+			}
+			else
+			{
+				tools::recording_file::writeFrame(sink.file, frame.ticks, frame.ms, frame.values);
+			}
+		}
+		else
+		{
+			if (!sink.headerWritten)
+			{
+				tools::recording_file::writeCsvHeader(sink.file, sink.info.frameValues, sink.info.sizeX, sink.info.sizeY);
+				sink.headerWritten = true;
+			}
+			tools::recording_file::writeCsvRow(sink.file, frame.ticks, frame.ms, frame.values);
+		}
+	}
+
+	std::uint64_t SimulationRecorder::flushSink(Sink& sink)
+	{
+		if (sink.failed)
+		{
+			return 0;
+		}
+		sink.file.flush();
+		const std::streamoff position = sink.file ? static_cast<std::streamoff>(sink.file.tellp()) : -1;
+		if (position < 0)
+		{
+			sink.failed = true;
+			tools::logger::log(tools::logger::LogLevel::ERROR,
+				std::format("Recording to '{}' failed: the file stopped accepting writes (check disk space).",
+					sink.filename));
+			return 0;
+		}
+		const auto bytes = static_cast<std::uint64_t>(position - sink.flushedBytes);
+		sink.flushedBytes = position;
+		return bytes;
+	}
+
 	void SimulationRecorder::update(const Simulation& sim)
 	{
 		if (sessions.empty()) {
 			return;
 }
+		const tools::trace::Span span("SimulationRecorder::update", "recorder");
 
 		const int    ticks = deriveTicks(sim);
 		const double ms    = sim.t;
@@ -175,7 +624,7 @@ namespace dnf_composer
 				continue;
 			}
 
-			const std::vector<double>* component = element->getComponentPtr(s.componentName);
+			const element::ComponentBuffer* component = element->getComponentPtr(s.componentName);
 			if (component == nullptr)
 			{
 				tools::logger::log(tools::logger::LogLevel::WARNING,
@@ -184,30 +633,85 @@ namespace dnf_composer
 				continue;
 			}
 
-			const double current = (s.unit == RecordingIntervalUnit::Ticks)
+			const double current = (s.options.unit == RecordingIntervalUnit::Ticks)
 				? static_cast<double>(ticks) : ms;
 
-			if (current < s.nextSampleAt) {
+			// Checked every step so that no event between samples is missed.
+			const bool triggered = s.options.trigger.on != RecordingTrigger::None;
+			bool event = false;
+			if (triggered)
+			{
+				const int check = checkTrigger(s, sim);
+				if (check < 0)
+				{
+					toStop.push_back(i);
+					continue;
+				}
+				event = check > 0;
+			}
+
+			if (current < s.nextSampleAt && !event) {
 				continue;
 }
 
-			if (s.file.tellp() == 0)
+			if (s.frameValues == 0)
 			{
-				const auto& dims = element->getElementCommonParameters().dimensionParameters;
-				writeHeader(s.file, component->size(), dims.size_x, dims.size_y);
+				if (!resolveFrame(s, *element, component->size()))
+				{
+					toStop.push_back(i);
+					continue;
+				}
+			}
+			else if ((s.sink->format == RecordingFormat::Binary || !s.whole) && component->size() != s.componentValues)
+			{
+				tools::logger::log(tools::logger::LogLevel::WARNING,
+					std::format("Stopping recording for '{}' / '{}': component resized from {} to {} values.",
+						s.elementId, s.componentName, s.componentValues, component->size()));
+				toStop.push_back(i);
+				continue;
 			}
 
-			writeRow(s.file, ticks, ms, *component);
-			s.file.flush();
+			if (!triggered)
+			{
+				enqueue(s, ticks, ms, *component);
+			}
+			else if (event)
+			{
+				enqueueHistory(s);
+				enqueue(s, ticks, ms, *component);
+				s.postRemaining = s.options.trigger.postSamples;
+				const std::lock_guard lock(mutex);
+				++stats.triggers;
+			}
+			else if (s.postRemaining > 0)
+			{
+				enqueue(s, ticks, ms, *component);
+				--s.postRemaining;
+			}
+			else if (!s.history.empty())
+			{
+				// Between events: overwrite the oldest held sample.
+				Frame& held = s.history[(s.historyHead + s.historyDepth) % s.history.size()];
+				if (s.historyDepth == s.history.size())
+				{
+					s.historyHead = (s.historyHead + 1) % s.history.size();
+				}
+				else
+				{
+					++s.historyDepth;
+				}
+				held.ticks = ticks;
+				held.ms = ms;
+				s.select(*component, held.values);
+			}
 
-			s.nextSampleAt = current + static_cast<double>(s.sampleInterval);
+			s.nextSampleAt = current + static_cast<double>(s.options.sampleInterval);
 		}
 
+		// A stopped session's queued frames keep its sink, and so its file, open
+		// until the writer has written them.
 		for (const std::size_t idx : std::ranges::reverse_view(toStop))
 		{
-			if (sessions[idx].file.is_open()) {
-				sessions[idx].file.close();
-}
 			sessions.erase(sessions.begin() + static_cast<std::ptrdiff_t>(idx));
 		}
 	}
@@ -225,7 +729,7 @@ namespace dnf_composer
 			return;
 		}
 
-		const std::vector<double>* component = element->getComponentPtr(componentName);
+		const element::ComponentBuffer* component = element->getComponentPtr(componentName);
 		if (component == nullptr)
 		{
 			tools::logger::log(tools::logger::LogLevel::ERROR,
@@ -251,8 +755,8 @@ namespace dnf_composer
 		const double ms    = sim.t;
 
 		const auto& dims = element->getElementCommonParameters().dimensionParameters;
-		writeHeader(file, component->size(), dims.size_x, dims.size_y);
-		writeRow(file, ticks, ms, *component);
+		tools::recording_file::writeCsvHeader(file, component->size(), dims.size_x, dims.size_y);
+		tools::recording_file::writeCsvRow(file, ticks, ms, *component);
 
 		tools::logger::log(tools::logger::LogLevel::INFO,
 			std::format("Snapshot exported to: {}", filename));
@@ -0,0 +1,203 @@
+#include "simulation/spectral_sharing.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+
+#include "elements/neural_field_2d.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		struct Candidate
+		{
+			std::shared_ptr<element::Kernel> kernel;
+			tools::math::SpectralConvolver2D* convolver;
+			const element::ComponentBuffer* source;
+			std::size_t index;
+		};
+
+		// The one element that reads @p kernel's output, if it is a field that
+		// sums it with its other inputs; null otherwise.
+		std::shared_ptr<element::Element> soleFieldConsumer(const std::shared_ptr<element::Kernel>& kernel)
+		{
+			const auto consumers = kernel->getOutputs();
+			if (consumers.size() != 1 || !std::dynamic_pointer_cast<element::NeuralField2D>(consumers.front()))
+			{
+				return nullptr;
+			}
+			const auto inputs = consumers.front()->getInputsAndComponents();
+			const auto it = inputs.find(kernel);
+			return it != inputs.end() && it->second == "output" ? consumers.front() : nullptr;
+		}
+	}
+
+	SpectralSharing::~SpectralSharing()
+	{
+		clear();
+	}
+
+	void SpectralSharing::build(const std::vector<std::shared_ptr<element::Element>>& elements,
+		bool synchronous, SpectrumSharing mode)
+	{
+		clear();
+		builtFor = elements;
+		builtConnectionRevision = element::Element::getConnectionRevision(elements);
+		built = true;
+		if (mode == SpectrumSharing::Off)
+		{
+			builtSpectralRevision = element::Kernel::getSpectralRevision();
+			return;
+		}
+
+		std::unordered_map<const element::Element*, std::size_t> indexOf;
+		indexOf.reserve(elements.size());
+		for (std::size_t i = 0; i < elements.size(); ++i)
+		{
+			indexOf.emplace(elements[i].get(), i);
+		}
+
+		// Key: source buffer, whether the kernels see its value from this step,
+		// and the transform geometry. Ordered map, so groups are built in a
+		// deterministic order.
+		using Key = std::tuple<const element::ComponentBuffer*, bool, int, int, tools::math::Precision>;
+		std::map<Key, std::vector<Candidate>> groups;
+		for (std::size_t i = 0; i < elements.size(); ++i)
+		{
+			const auto kernel = std::dynamic_pointer_cast<element::Kernel>(elements[i]);
+			if (!kernel)
+			{
+				continue;
+			}
+			tools::math::SpectralConvolver2D* convolver = kernel->getSpectralConvolver2D();
+			const auto inputs = kernel->getInputsAndComponents();
+			if (convolver == nullptr || inputs.size() != 1)
+			{
+				continue;
+			}
+
+			const auto& [sourceElement, component] = *inputs.begin();
+			const element::ComponentBuffer* source = nullptr;
+			try
+			{
+				source = &sourceElement->getPublishedComponent(component);
+			}
+			catch (const std::out_of_range&)
+			{
+				continue;
+			}
+			if (source->size() != static_cast<std::size_t>(convolver->sizeX()) * convolver->sizeY())
+			{
+				continue;
+			}
+
+			// A source outside the simulation is never stepped, so every kernel
+			// sees the same value of it.
+			const auto sourceIndex = indexOf.find(sourceElement.get());
+			const bool frontBuffered = synchronous && sourceElement->isFrontBuffered(component);
+			const bool readsThisStep = !frontBuffered && sourceIndex != indexOf.end() && sourceIndex->second < i;
+			groups[Key{ source, readsThisStep, convolver->sizeX(), convolver->sizeY(), convolver->precision() }]
+				.push_back(Candidate{ kernel, convolver, source, i });
+		}
+
+		for (const auto& [key, members] : groups)
+		{
+			if (members.size() < 2)
+			{
+				continue;
+			}
+			auto spectrum = std::make_unique<tools::math::SharedSpectrum2D>();
+			spectrum->init(std::get<2>(key), std::get<3>(key), std::get<4>(key));
+			for (const Candidate& member : members)
+			{
+				member.kernel->bindSharedSpectrum(spectrum.get(), member.source);
+				boundKernels.push_back(member.kernel);
+			}
+			spectra.push_back(std::move(spectrum));
+
+			if (mode != SpectrumSharing::Fused)
+			{
+				continue;
+			}
+
+			// Fuse the members that feed the same field. In sequential mode they
+			// must also all step on the same side of it, or the field would see
+			// this step's contribution of one and last step's of another.
+			std::map<const element::Element*, std::vector<const Candidate*>> byConsumer;
+			for (const Candidate& member : members)
+			{
+				if (const auto consumer = soleFieldConsumer(member.kernel))
+				{
+					byConsumer[consumer.get()].push_back(&member);
+				}
+			}
+			for (const auto& [consumer, fused] : byConsumer)
+			{
+				if (fused.size() < 2)
+				{
+					continue;
+				}
+				if (!synchronous)
+				{
+					const auto consumerIndex = indexOf.find(consumer);
+					if (consumerIndex == indexOf.end())
+					{
+						continue;
+					}
+					const bool firstBefore = fused.front()->index < consumerIndex->second;
+					const bool sameSide = std::ranges::all_of(fused, [&](const Candidate* member)
+						{
+							return (member->index < consumerIndex->second) == firstBefore;
+						});
+					if (!sameSide)
+					{
+						continue;
+					}
+				}
+
+				auto sum = std::make_unique<tools::math::SpectralConvolver2D>(*fused.front()->convolver);
+				for (std::size_t k = 1; k < fused.size(); ++k)
+				{
+					sum->addKernelSpectrum(*fused[k]->convolver);
+					fused[k]->kernel->setFusedAway(true);
+					++fusedKernels;
+				}
+				fused.front()->kernel->setFusedSpectral(std::move(sum));
+			}
+		}
+		builtSpectralRevision = element::Kernel::getSpectralRevision();
+	}
+
+	bool SpectralSharing::isCurrent(const std::vector<std::shared_ptr<element::Element>>& elements) const
+	{
+		return built && builtFor == elements &&
+			builtConnectionRevision == element::Element::getConnectionRevision(elements) &&
+			builtSpectralRevision == element::Kernel::getSpectralRevision();
+	}
+
+	void SpectralSharing::beginStep()
+	{
+		for (const auto& spectrum : spectra)
+		{
+			spectrum->invalidate();
+		}
+	}
+
+	void SpectralSharing::clear()
+	{
+		for (const auto& kernel : boundKernels)
+		{
+			kernel->bindSharedSpectrum(nullptr, nullptr);
+			kernel->setFusedSpectral(nullptr);
+			kernel->setFusedAway(false);
+		}
+		boundKernels.clear();
+		spectra.clear();
+		builtFor.clear();
+		fusedKernels = 0;
+		built = false;
+	}
+}
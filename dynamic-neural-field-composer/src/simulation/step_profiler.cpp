@@ -0,0 +1,102 @@
+#include "simulation/step_profiler.h"
+
+#include <algorithm>
+#include <map>
+
+namespace dnf_composer
+{
+	namespace
+	{
+		StepTiming timingOf(std::string name, const tools::profiling::LatencyHistogram::Snapshot& snapshot)
+		{
+			StepTiming timing;
+			timing.name = std::move(name);
+			timing.steps = snapshot.count;
+			timing.p50 = snapshot.percentile(0.50);
+			timing.p99 = snapshot.percentile(0.99);
+			timing.max = snapshot.max;
+			timing.mean = snapshot.mean();
+			timing.total = snapshot.total;
+			return timing;
+		}
+
+		// Same object, not just the same address: a removed element's memory can be
+		// reused by a new one.
+		bool sameElement(const std::weak_ptr<element::Element>& slot, const std::shared_ptr<element::Element>& element)
+		{
+			return !slot.owner_before(element) && !element.owner_before(slot);
+		}
+	}
+
+	void StepProfiler::sync(const std::vector<std::shared_ptr<element::Element>>& elements)
+	{
+		const bool current = slots.size() == elements.size()
+			&& std::equal(elements.begin(), elements.end(), slots.begin(),
+				[](const std::shared_ptr<element::Element>& e, const std::unique_ptr<Slot>& slot) { return sameElement(slot->element, e); });
+		if (current)
+		{
+			return;
+		}
+
+		// Keep the histograms of elements that are still registered.
+		const std::lock_guard lock(mutex);
+		std::vector<std::unique_ptr<Slot>> next;
+		next.reserve(elements.size());
+		for (const auto& element : elements)
+		{
+			const auto kept = std::find_if(slots.begin(), slots.end(),
+				[&](const std::unique_ptr<Slot>& slot) { return slot && sameElement(slot->element, element); });
+			auto slot = kept != slots.end() ? std::move(*kept) : std::make_unique<Slot>();
+			slot->element = element;
+			slot->name = element->getUniqueName();
+			const auto label = element::ElementLabelToString.find(element->getLabel());
+			slot->type = label != element::ElementLabelToString.end() ? label->second : "unknown";
+			next.push_back(std::move(slot));
+		}
+		slots = std::move(next);
+	}
+
+	void StepProfiler::rename(const std::shared_ptr<element::Element>& element)
+	{
+		const std::lock_guard lock(mutex);
+		for (const auto& slot : slots)
+		{
+			if (sameElement(slot->element, element))
+			{
+				slot->name = element->getUniqueName();
+			}
+		}
+	}
+
+	StepProfile StepProfiler::profile() const
+	{
+		StepProfile result;
+		std::map<std::string, tools::profiling::LatencyHistogram::Snapshot> byType;
+		{
+			const std::lock_guard lock(mutex);
+			result.elements.reserve(slots.size());
+			for (const auto& slot : slots)
+			{
+				const auto snapshot = slot->histogram.snapshot();
+				result.elements.push_back(timingOf(slot->name, snapshot));
+				byType[slot->type] += snapshot;
+			}
+		}
+		result.types.reserve(byType.size());
+		for (const auto& [type, snapshot] : byType)
+		{
+			result.types.push_back(timingOf(type, snapshot));
+		}
+		std::ranges::sort(result.types, [](const StepTiming& a, const StepTiming& b) { return a.total > b.total; });
+		return result;
+	}
+
+	void StepProfiler::reset()
+	{
+		const std::lock_guard lock(mutex);
+		for (const auto& slot : slots)
+		{
+			slot->histogram.reset();
+		}
+	}
+}
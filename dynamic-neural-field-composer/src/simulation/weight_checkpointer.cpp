@@ -0,0 +1,394 @@
+#include "simulation/weight_checkpointer.h"
+#include "simulation/simulation.h"
+#include "elements/field_coupling.h"
+#include "tools/logger.h"
+#include "tools/trace.h"
+#include "tools/utils.h"
+#include "tools/weight_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <system_error>
+
+namespace dnf_composer
+{
+	namespace
+	{
+		namespace fs = std::filesystem;
+
+		constexpr const char* kCheckpointPrefix = "checkpoint_";
+
+		long long deriveTicks(const Simulation& sim)
+		{
+			return std::llround((sim.t - sim.tZero) / sim.deltaT);
+		}
+
+		// checkpoint_<sequence>_<ticks>. The sequence number counts checkpoints in
+		// the order they were taken, across restarts of the checkpointer, so it
+		// stays unique and ordered when the simulation clock starts over.
+		std::string checkpointName(std::uint64_t sequence, long long ticks)
+		{
+			// Zero-padded, so name order is write order.
+			return std::format("{}{:010}_{:010}", kCheckpointPrefix, sequence, ticks);
+		}
+
+		bool isCheckpointDirectory(const fs::directory_entry& entry)
+		{
+			return entry.is_directory() && entry.path().filename().string().starts_with(kCheckpointPrefix);
+		}
+
+		// The sequence number of a checkpoint directory name, or -1 for one named
+		// checkpoint_<ticks> before sequence numbers existed.
+		long long sequenceOf(const std::string& name)
+		{
+			const std::size_t digits = std::char_traits<char>::length(kCheckpointPrefix);
+			const std::size_t separator = name.find('_', digits);
+			if (separator == std::string::npos)
+			{
+				return -1;
+			}
+			long long sequence = -1;
+			std::from_chars(name.data() + digits, name.data() + separator, sequence);
+			return sequence;
+		}
+	}
+
+	double CheckpointStats::throughputMBps() const
+	{
+		const double seconds = std::chrono::duration<double>(writeTime).count();
+		return seconds > 0.0 ? static_cast<double>(bytesWritten) / seconds / 1e6 : 0.0;
+	}
+
+	WeightCheckpointer::~WeightCheckpointer()
+	{
+		stop();
+	}
+
+	bool WeightCheckpointer::start(const std::string& dir, const CheckpointPolicy& newPolicy)
+	{
+		stop();
+
+		std::error_code ec;
+		fs::create_directories(dir, ec);
+		if (ec || !fs::is_directory(dir))
+		{
+			tools::logger::log(tools::logger::LogLevel::ERROR,
+				std::format("Checkpointing not started: cannot create directory '{}'{}.", dir,
+					ec ? " (" + ec.message() + ")" : ""));
+			return false;
+		}
+
+		directory = dir;
+		policy = newPolicy;
+		// Continue after the checkpoints already here, so the ones this run takes
+		// are the newest whatever tick they are taken at.
+		nextSequence = 0;
+		for (const std::string& checkpoint : listCheckpoints(directory))
+		{
+			nextSequence = std::max(nextSequence, static_cast<std::uint64_t>(sequenceOf(fs::path(checkpoint).filename().string()) + 1));
+		}
+		stepsSinceCheckpoint = 0;
+		lastCheckpointAt = std::chrono::steady_clock::now();
+		{
+			const std::lock_guard lock(mutex);
+			stats = {};
+			stopping = false;
+		}
+		writer = std::thread(&WeightCheckpointer::writerLoop, this);
+		active = true;
+
+		tools::logger::log(tools::logger::LogLevel::INFO,
+			std::format("Checkpointing weights to '{}' (every {} steps, every {} s, keeping {}).",
+				directory, policy.everySteps, policy.everySeconds, policy.keep));
+		return true;
+	}
+
+	void WeightCheckpointer::stop()
+	{
+		if (!writer.joinable())
+		{
+			return;
+		}
+		{
+			const std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		queued.notify_one();
+		writer.join();
+		active = false;
+	}
+
+	void WeightCheckpointer::update(const Simulation& sim)
+	{
+		if (!active)
+		{
+			return;
+		}
+		++stepsSinceCheckpoint;
+		const bool stepsDue = policy.everySteps > 0 && stepsSinceCheckpoint >= policy.everySteps;
+		// Read the clock only when the time trigger is in use.
+		const bool timeDue = !stepsDue && policy.everySeconds > 0.0
+			&& std::chrono::steady_clock::now() - lastCheckpointAt >= std::chrono::duration<double>(policy.everySeconds);
+		if (stepsDue || timeDue)
+		{
+			takeSnapshot(sim);
+		}
+	}
+
+	bool WeightCheckpointer::checkpointNow(const Simulation& sim)
+	{
+		if (!active)
+		{
+			return false;
+		}
+		takeSnapshot(sim);
+		return true;
+	}
+
+	void WeightCheckpointer::takeSnapshot(const Simulation& sim)
+	{
+		const tools::trace::Span span("checkpoint snapshot", "weights");
+		const auto t0 = std::chrono::steady_clock::now();
+		stepsSinceCheckpoint = 0;
+		lastCheckpointAt = t0;
+
+		// At most one slot is being written, so there is always another one to
+		// fill. A queued snapshot the writer has not started on is overwritten:
+		// the newer weights supersede it.
+		std::size_t slot = 0;
+		bool superseded = false;
+		{
+			const std::lock_guard lock(mutex);
+			const auto queuedSlot = std::ranges::find(states, SlotState::Queued);
+			if (queuedSlot != states.end())
+			{
+				slot = static_cast<std::size_t>(queuedSlot - states.begin());
+				superseded = true;
+			}
+			else
+			{
+				slot = static_cast<std::size_t>(std::ranges::find(states, SlotState::Free) - states.begin());
+			}
+			states[slot] = SlotState::Filling;
+		}
+
+		Snapshot& snapshot = slots[slot];
+		snapshot.ticks = deriveTicks(sim);
+		snapshot.sequence = nextSequence++;
+		std::size_t count = 0;
+		for (const auto& element : sim.getElements())
+		{
+			const auto coupling = std::dynamic_pointer_cast<element::FieldCoupling>(element);
+			if (!coupling)
+			{
+				continue;
+			}
+			if (count == snapshot.couplings.size())
+			{
+				snapshot.couplings.emplace_back();
+			}
+			CouplingWeights& weights = snapshot.couplings[count++];
+			weights.name = coupling->getUniqueName();
+			weights.rows = coupling->getComponentPtr("input")->size();
+			weights.cols = coupling->getComponentPtr("output")->size();
+			weights.sparse = coupling->getParameters().weightStorage == WeightStorage::SPARSE;
+			if (weights.sparse)
+			{
+				// Copy-assigning the vectors reuses their capacity.
+				weights.csr = coupling->getSparseWeights();
+			}
+			else
+			{
+				const element::ComponentBuffer& dense = *coupling->getComponentPtr("weights");
+				weights.dense.assign(dense.begin(), dense.end());
+			}
+		}
+		snapshot.couplings.resize(count);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+		{
+			const std::lock_guard lock(mutex);
+			states[slot] = SlotState::Queued;
+			++stats.snapshotsTaken;
+			if (superseded)
+			{
+				++stats.snapshotsSuperseded;
+			}
+			stats.lastSnapshotTime = elapsed;
+			stats.maxSnapshotTime = std::max(stats.maxSnapshotTime, elapsed);
+		}
+		queued.notify_one();
+	}
+
+	void WeightCheckpointer::writerLoop()
+	{
+		tools::trace::setThreadName("checkpoint writer");
+		std::unique_lock lock(mutex);
+		while (true)
+		{
+			queued.wait(lock, [this] { return stopping || std::ranges::find(states, SlotState::Queued) != states.end(); });
+			const auto next = std::ranges::find(states, SlotState::Queued);
+			if (next == states.end())
+			{
+				break; // stopping, nothing left to write
+			}
+			const auto slot = static_cast<std::size_t>(next - states.begin());
+			states[slot] = SlotState::Writing;
+			lock.unlock();
+
+			const auto t0 = std::chrono::steady_clock::now();
+			std::uint64_t bytes = 0;
+			std::string failure;
+			try
+			{
+				const tools::trace::Span span("checkpoint write", "weights");
+				bytes = writeCheckpoint(slots[slot]);
+				rotate();
+			}
+			catch (const std::exception& e)
+			{
+				failure = e.what();
+			}
+			const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0);
+			if (!failure.empty())
+			{
+				tools::logger::log(tools::logger::LogLevel::ERROR,
+					std::format("Checkpoint at tick {} failed: {}", slots[slot].ticks, failure));
+			}
+
+			lock.lock();
+			states[slot] = SlotState::Free;
+			if (failure.empty())
+			{
+				++stats.checkpointsWritten;
+				stats.bytesWritten += bytes;
+				stats.writeTime += elapsed;
+				stats.lastCheckpoint = (fs::path(directory) / checkpointName(slots[slot].sequence, slots[slot].ticks)).string();
+			}
+			else
+			{
+				++stats.writeFailures;
+			}
+			idle.notify_all();
+		}
+		idle.notify_all();
+	}
+
+	std::uint64_t WeightCheckpointer::writeCheckpoint(const Snapshot& snapshot) const
+	{
+		const std::string name = checkpointName(snapshot.sequence, snapshot.ticks);
+		const fs::path target = fs::path(directory) / name;
+		const fs::path staging = fs::path(directory) / ("." + name + ".tmp");
+
+		fs::remove_all(staging);
+		fs::create_directories(staging);
+		std::uint64_t bytes = 0;
+		for (const CouplingWeights& weights : snapshot.couplings)
+		{
+			const std::string file = (staging / (weights.name + "_weights.dnfw")).string();
+			if (weights.sparse)
+			{
+				tools::weight_file::writeCsr(file, weights.csr);
+			}
+			else
+			{
+				tools::weight_file::writeDense(file, weights.dense, weights.rows, weights.cols);
+			}
+			bytes += fs::file_size(file);
+		}
+		fs::rename(staging, target);
+		return bytes;
+	}
+
+	void WeightCheckpointer::rotate() const
+	{
+		if (policy.keep <= 0)
+		{
+			return;
+		}
+		const auto checkpoints = listCheckpoints(directory);
+		const std::size_t keep = static_cast<std::size_t>(policy.keep);
+		for (std::size_t i = 0; i + keep < checkpoints.size(); ++i)
+		{
+			// The checkpoint just written is complete either way; one that
+			// cannot be deleted now is tried again after the next write.
+			std::error_code ec;
+			fs::remove_all(checkpoints[i], ec);
+			if (ec)
+			{
+				tools::logger::log(tools::logger::LogLevel::WARNING,
+					std::format("Could not delete old checkpoint '{}': {}.", checkpoints[i], ec.message()));
+			}
+		}
+	}
+
+	void WeightCheckpointer::flush()
+	{
+		std::unique_lock lock(mutex);
+		idle.wait(lock, [this]
+		{
+			return !writer.joinable() || std::ranges::all_of(states, [](SlotState s) { return s == SlotState::Free; });
+		});
+	}
+
+	CheckpointStats WeightCheckpointer::getStats() const
+	{
+		const std::lock_guard lock(mutex);
+		return stats;
+	}
+
+	std::vector<std::string> WeightCheckpointer::listCheckpoints(const std::string& dir)
+	{
+		std::vector<std::string> checkpoints;
+		std::error_code ec;
+		for (const auto& entry : fs::directory_iterator(dir, ec))
+		{
+			if (isCheckpointDirectory(entry))
+			{
+				checkpoints.push_back(entry.path().string());
+			}
+		}
+		std::ranges::sort(checkpoints, [](const std::string& a, const std::string& b)
+		{
+			const std::string nameA = fs::path(a).filename().string();
+			const std::string nameB = fs::path(b).filename().string();
+			return std::pair(sequenceOf(nameA), nameA) < std::pair(sequenceOf(nameB), nameB);
+		});
+		return checkpoints;
+	}
+
+	std::string WeightCheckpointer::defaultDirectory(const std::string& simName)
+	{
+		return (fs::path(tools::utils::getResourceRoot()) / "data" / simName / "checkpoints").string();
+	}
+
+	int WeightCheckpointer::restore(const Simulation& sim, const std::string& checkpointDirectory)
+	{
+		int restored = 0;
+		for (const auto& element : sim.getElements())
+		{
+			const auto coupling = std::dynamic_pointer_cast<element::FieldCoupling>(element);
+			if (!coupling || !fs::exists(fs::path(checkpointDirectory) / (coupling->getUniqueName() + "_weights.dnfw")))
+			{
+				continue;
+			}
+			const std::string weightsDirectory = coupling->getWeightsDirectory();
+			const WeightFileFormat format = coupling->getWeightFileFormat();
+			coupling->setWeightsDirectory(checkpointDirectory);
+			const bool loaded = coupling->readWeights();
+			// A checkpoint is rotated away later; a file still mapped as the
+			// weights' storage could not be deleted on Windows.
+			coupling->releaseWeightsFile();
+			coupling->setWeightsDirectory(weightsDirectory);
+			coupling->setWeightFileFormat(format);
+			if (loaded)
+			{
+				++restored;
+			}
+		}
+		return restored;
+	}
+}
@@ -1,10 +1,23 @@
 #include "tools/fft_convolution.h"
 
 #include <fftw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <future>
+#include <map>
 #include <stdexcept>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#include "tools/thread_pool.h"
+#include "tools/trace.h"
+#include "tools/utils.h"
 
 namespace dnf_composer::tools::math
 {
@@ -18,14 +31,684 @@ namespace dnf_composer::tools::math
 			return mode;
 		}
 
-		// FFTW's planner (fftw_plan_dft_*, fftw_destroy_plan) is not reentrant
-		// and must be serialized process-wide. Guards every planner call below;
-		// fftw_malloc/fftw_free are plain aligned allocation and need no guard.
+		std::atomic<PlanRigor>& rigorStorage()
+		{
+			static std::atomic<PlanRigor> rigor{PlanRigor::Estimate};
+			return rigor;
+		}
+
+		unsigned rigorFlags(PlanRigor rigor)
+		{
+			switch (rigor)
+			{
+			case PlanRigor::Measure: return FFTW_MEASURE;
+			case PlanRigor::Patient: return FFTW_PATIENT;
+			case PlanRigor::Estimate: break;
+			}
+			return FFTW_ESTIMATE;
+		}
+
+		bool isBelow(PlanRigor rigor, PlanRigor than)
+		{
+			return static_cast<int>(rigor) < static_cast<int>(than);
+		}
+
+		// FFTW's planner (fftw_plan_dft_*, fftw_destroy_plan, wisdom import and
+		// export) is not reentrant and must be serialized process-wide. Guards
+		// every planner call below and nothing else; executing a plan and
+		// fftw_malloc/fftw_free need no guard. A Measure or Patient plan holds
+		// it for its whole timing run, so nothing that can be answered from the
+		// cache alone ever waits for it.
 		std::mutex& plannerMutex()
 		{
 			static std::mutex m;
 			return m;
 		}
+
+		// Estimate plans queued for plannerMutex(). A Measure or Patient plan
+		// lets them take it first, so a new shape waits out at most one
+		// transform's timing trials before it has a plan to run.
+		std::atomic<int>& estimatesWaiting()
+		{
+			static std::atomic<int> waiting{ 0 };
+			return waiting;
+		}
+
+		// Guards the plan cache's bookkeeping (the slot map and each slot's
+		// shape, plan sets and measuring flag). Never held across a planner
+		// call, and never taken while plannerMutex() is held waiting on it.
+		std::mutex& cacheMutex()
+		{
+			static std::mutex m;
+			return m;
+		}
+
+		// The double (fftw_*) and float (fftwf_*) FFTW APIs behind one name, so
+		// SpectralConvolver2D runs the same code in either precision.
+		template<typename Real> struct Fftw;
+
+		template<> struct Fftw<double>
+		{
+			using Complex = fftw_complex;
+			using Plan    = fftw_plan;
+			static void* allocate(std::size_t bytes) { return fftw_malloc(bytes); }
+			static void release(void* p) { fftw_free(p); }
+			static Plan planForward(int n0, int n1, void* in, void* out, unsigned flags)
+			{
+				return fftw_plan_dft_r2c_2d(n0, n1, static_cast<double*>(in), static_cast<Complex*>(out), flags);
+			}
+			static Plan planInverse(int n0, int n1, void* in, void* out, unsigned flags)
+			{
+				return fftw_plan_dft_c2r_2d(n0, n1, static_cast<Complex*>(in), static_cast<double*>(out), flags);
+			}
+			static Plan planForward1D(int n, void* in, void* out, unsigned flags)
+			{
+				return fftw_plan_dft_r2c_1d(n, static_cast<double*>(in), static_cast<Complex*>(out), flags);
+			}
+			static Plan planInverse1D(int n, void* in, void* out, unsigned flags)
+			{
+				return fftw_plan_dft_c2r_1d(n, static_cast<Complex*>(in), static_cast<double*>(out), flags);
+			}
+			// New-array execution: the cached plans run on each convolver's own
+			// buffers (see planShape()).
+			static void executeForward(const void* plan, void* in, void* out)
+			{
+				fftw_execute_dft_r2c(static_cast<Plan>(const_cast<void*>(plan)), static_cast<double*>(in), static_cast<Complex*>(out));
+			}
+			static void executeInverse(const void* plan, void* in, void* out)
+			{
+				fftw_execute_dft_c2r(static_cast<Plan>(const_cast<void*>(plan)), static_cast<Complex*>(in), static_cast<double*>(out));
+			}
+			static void destroy(void* plan) { fftw_destroy_plan(static_cast<Plan>(plan)); }
+			static void planWithThreads(int jobs) { fftw_plan_with_nthreads(jobs); }
+			static bool importWisdom(const char* path) { return fftw_import_wisdom_from_filename(path) != 0; }
+			static bool exportWisdom(const char* path) { return fftw_export_wisdom_to_filename(path) != 0; }
+		};
+
+		template<> struct Fftw<float>
+		{
+			using Complex = fftwf_complex;
+			using Plan    = fftwf_plan;
+			static void* allocate(std::size_t bytes) { return fftwf_malloc(bytes); }
+			static void release(void* p) { fftwf_free(p); }
+			static Plan planForward(int n0, int n1, void* in, void* out, unsigned flags)
+			{
+				return fftwf_plan_dft_r2c_2d(n0, n1, static_cast<float*>(in), static_cast<Complex*>(out), flags);
+			}
+			static Plan planInverse(int n0, int n1, void* in, void* out, unsigned flags)
+			{
+				return fftwf_plan_dft_c2r_2d(n0, n1, static_cast<Complex*>(in), static_cast<float*>(out), flags);
+			}
+			static Plan planForward1D(int n, void* in, void* out, unsigned flags)
+			{
+				return fftwf_plan_dft_r2c_1d(n, static_cast<float*>(in), static_cast<Complex*>(out), flags);
+			}
+			static Plan planInverse1D(int n, void* in, void* out, unsigned flags)
+			{
+				return fftwf_plan_dft_c2r_1d(n, static_cast<Complex*>(in), static_cast<float*>(out), flags);
+			}
+			static void executeForward(const void* plan, void* in, void* out)
+			{
+				fftwf_execute_dft_r2c(static_cast<Plan>(const_cast<void*>(plan)), static_cast<float*>(in), static_cast<Complex*>(out));
+			}
+			static void executeInverse(const void* plan, void* in, void* out)
+			{
+				fftwf_execute_dft_c2r(static_cast<Plan>(const_cast<void*>(plan)), static_cast<Complex*>(in), static_cast<float*>(out));
+			}
+			static void destroy(void* plan) { fftwf_destroy_plan(static_cast<Plan>(plan)); }
+			static void planWithThreads(int jobs) { fftwf_plan_with_nthreads(jobs); }
+			static bool importWisdom(const char* path) { return fftwf_import_wisdom_from_filename(path) != 0; }
+			static bool exportWisdom(const char* path) { return fftwf_export_wisdom_to_filename(path) != 0; }
+		};
+
+		// FFTW's parallel loop: each of a threaded plan's jobs is one chunk of a
+		// parallelFor on the calling thread's pool (see kFFTThreadedJobs).
+		void runFftwJobs(void* (*work)(char*), char* jobData, std::size_t jobSize, int jobs, void* /*data*/)
+		{
+			threading::parallelFor(static_cast<std::size_t>(jobs), [&](std::size_t job)
+				{
+					work(jobData + job * jobSize);
+				});
+		}
+
+		// Caller holds plannerMutex().
+		void initFftwThreads()
+		{
+			static bool initialized = false;
+			if (initialized) {
+				return;
+			}
+			fftw_init_threads();
+			fftwf_init_threads();
+			fftw_threads_set_callback(&runFftwJobs, nullptr);
+			fftwf_threads_set_callback(&runFftwJobs, nullptr);
+			initialized = true;
+		}
+
+		std::size_t complexBytes(Precision precision)
+		{
+			return precision == Precision::Single ? sizeof(fftwf_complex) : sizeof(fftw_complex);
+		}
+
+		// realCount is the number of real samples transformed (size_x*size_y, or
+		// size in 1D); freqCount the number of complex bins r2c produces from them.
+		template<typename Real>
+		void setKernelSpectrum(const std::vector<double>& wrappedKernelReal, void* fieldReal,
+			void* fieldFreq, void* kernelFreq, const void* forwardPlan, std::size_t realCount, std::size_t freqCount)
+		{
+			using F = Fftw<Real>;
+			std::copy(wrappedKernelReal.begin(), wrappedKernelReal.end(), static_cast<Real*>(fieldReal));
+			F::executeForward(forwardPlan, fieldReal, fieldFreq);
+
+			// Fold FFTW's unnormalized-transform convention (forward+inverse scales
+			// by the number of samples) into the stored kernel spectrum once here,
+			// so every subsequent apply() needs no separate normalization pass.
+			const Real norm = static_cast<Real>(1.0 / static_cast<double>(realCount));
+			auto* kf = static_cast<typename F::Complex*>(kernelFreq);
+			auto* ff = static_cast<typename F::Complex*>(fieldFreq);
+			for (std::size_t i = 0; i < freqCount; ++i)
+			{
+				kf[i][0] = ff[i][0] * norm;
+				kf[i][1] = ff[i][1] * norm;
+			}
+		}
+
+		// fieldFreq = spectrum * kernelFreq, then the inverse transform into out.
+		// spectrum may be fieldFreq itself (apply()) or a SharedSpectrum2D's.
+		template<typename Real, typename Out>
+		void multiplyAndInvert(const void* spectrum, Out* out, void* fieldFreq, void* kernelFreq,
+			void* resultReal, const void* inversePlan, std::size_t realCount, std::size_t freqCount)
+		{
+			using F = Fftw<Real>;
+			const auto* sf = static_cast<const typename F::Complex*>(spectrum);
+			auto* ff = static_cast<typename F::Complex*>(fieldFreq);
+			auto* kf = static_cast<typename F::Complex*>(kernelFreq);
+			for (std::size_t i = 0; i < freqCount; ++i)
+			{
+				const Real re = sf[i][0] * kf[i][0] - sf[i][1] * kf[i][1];
+				const Real im = sf[i][0] * kf[i][1] + sf[i][1] * kf[i][0];
+				ff[i][0] = re;
+				ff[i][1] = im;
+			}
+
+			F::executeInverse(inversePlan, fieldFreq, resultReal);
+			const auto* result = static_cast<const Real*>(resultReal);
+			std::copy(result, result + realCount, out);
+		}
+
+		template<typename Real, typename In, typename Out>
+		void convolveSpectrally(const In* field, Out* out, void* fieldReal, void* fieldFreq,
+			void* kernelFreq, void* resultReal, const void* forwardPlan, const void* inversePlan,
+			std::size_t realCount, std::size_t freqCount)
+		{
+			std::copy(field, field + realCount, static_cast<Real*>(fieldReal));
+			Fftw<Real>::executeForward(forwardPlan, fieldReal, fieldFreq);
+			multiplyAndInvert<Real, Out>(fieldFreq, out, fieldFreq, kernelFreq, resultReal, inversePlan,
+				realCount, freqCount);
+		}
+
+		template<typename Real>
+		void addSpectrum(void* to, const void* from, std::size_t freqCount)
+		{
+			using Complex = typename Fftw<Real>::Complex;
+			auto* dst = static_cast<Complex*>(to);
+			const auto* src = static_cast<const Complex*>(from);
+			for (std::size_t i = 0; i < freqCount; ++i)
+			{
+				dst[i][0] += src[i][0];
+				dst[i][1] += src[i][1];
+			}
+		}
+
+		// Plans whose owner went away while the planner was busy, destroyed by
+		// the next thread to take plannerMutex(), so releasing a slot never
+		// waits out a measurement.
+		struct RetiredPlans
+		{
+			std::mutex mutex;
+			std::vector<std::pair<void*, Precision>> plans; // guarded by mutex
+		};
+
+		RetiredPlans& retiredPlans()
+		{
+			static RetiredPlans retired;
+			return retired;
+		}
+
+		// Caller holds plannerMutex().
+		void destroyPlan(void* plan, Precision precision)
+		{
+			precision == Precision::Single ? Fftw<float>::destroy(plan) : Fftw<double>::destroy(plan);
+		}
+
+		// Caller holds plannerMutex().
+		void destroyRetiredPlans()
+		{
+			std::vector<std::pair<void*, Precision>> plans;
+			{
+				RetiredPlans& retired = retiredPlans();
+				std::lock_guard<std::mutex> lock(retired.mutex);
+				plans.swap(retired.plans);
+			}
+			for (const auto& [plan, precision] : plans) {
+				destroyPlan(plan, precision);
+			}
+		}
+
+		// Destroys the plans now if the planner is free, else hands them to
+		// the next thread that takes it.
+		void retirePlans(std::vector<void*> plans, Precision precision)
+		{
+			std::unique_lock<std::mutex> planner(plannerMutex(), std::try_to_lock);
+			if (planner.owns_lock())
+			{
+				destroyRetiredPlans();
+				for (void* plan : plans) {
+					destroyPlan(plan, precision);
+				}
+				return;
+			}
+			RetiredPlans& retired = retiredPlans();
+			std::lock_guard<std::mutex> lock(retired.mutex);
+			for (void* plan : plans) {
+				retired.plans.emplace_back(plan, precision);
+			}
+		}
+	}
+
+	// The plans of one transform shape. An upgrade to a more rigorous plan adds
+	// a PlanSet and swaps `current`; sets are only destroyed with the slot, so a
+	// convolver that loaded `current` just before a swap still runs a live plan.
+	struct FftPlanSlot
+	{
+		struct PlanSet
+		{
+			void* forward = nullptr;
+			void* inverse = nullptr;
+		};
+
+		FftPlanShape shape;                        // guarded by cacheMutex()
+		std::atomic<const PlanSet*> current{nullptr};
+		std::vector<std::unique_ptr<PlanSet>> sets; // guarded by cacheMutex()
+		bool measuring = false;                    // guarded by cacheMutex()
+
+		FftPlanSlot() = default;
+		FftPlanSlot(const FftPlanSlot&) = delete;
+		FftPlanSlot& operator=(const FftPlanSlot&) = delete;
+
+		~FftPlanSlot()
+		{
+			std::vector<void*> plans;
+			for (const auto& set : sets)
+			{
+				plans.push_back(set->forward);
+				plans.push_back(set->inverse);
+			}
+			retirePlans(std::move(plans), shape.precision);
+		}
+
+		const PlanSet& plans() const { return *current.load(std::memory_order_acquire); }
+	};
+
+	namespace
+	{
+		using PlanKey = std::tuple<int, int, int, Precision>;
+
+		struct PlanCache
+		{
+			std::map<PlanKey, std::shared_ptr<FftPlanSlot>> slots; // guarded by cacheMutex()
+			std::mutex pendingMutex;
+			std::vector<std::shared_future<void>> pending;         // guarded by pendingMutex
+
+			~PlanCache()
+			{
+				for (auto& measurement : pending) {
+					measurement.wait();
+				}
+			}
+		};
+
+		PlanCache& planCache()
+		{
+			// Constructed after the mutexes and the retired list, so destroyed
+			// before them: the slots it still holds use them on their way out.
+			plannerMutex();
+			cacheMutex();
+			retiredPlans();
+			static PlanCache cache;
+			return cache;
+		}
+
+		// Caller holds cacheMutex().
+		std::shared_ptr<FftPlanSlot> slotFor(int rank, int size_x, int size_y, Precision precision)
+		{
+			auto& slot = planCache().slots[PlanKey{ rank, size_x, size_y, precision }];
+			if (!slot)
+			{
+				slot = std::make_shared<FftPlanSlot>();
+				const bool threaded = static_cast<std::size_t>(size_x) * size_y >= static_cast<std::size_t>(kFFTThreadedMinCells);
+				slot->shape = FftPlanShape{ rank, size_x, size_y, precision, PlanRigor::Estimate,
+					threaded ? kFFTThreadedJobs : 1 };
+			}
+			return slot;
+		}
+
+		// Plans one direction of `shape`, or returns null if the planner is busy
+		// and `wait` is false, or if FFTW_WISDOM_ONLY finds no wisdom for it.
+		template<typename Real>
+		void* planTransform(const FftPlanShape& shape, bool forward, unsigned flags, bool wait)
+		{
+			using F = Fftw<Real>;
+			std::unique_lock<std::mutex> planner(plannerMutex(), std::defer_lock);
+			if (!wait)
+			{
+				if (!planner.try_lock()) {
+					return nullptr;
+				}
+			}
+			else if ((flags & FFTW_ESTIMATE) != 0)
+			{
+				estimatesWaiting().fetch_add(1, std::memory_order_relaxed);
+				planner.lock();
+				estimatesWaiting().fetch_sub(1, std::memory_order_relaxed);
+			}
+			else
+			{
+				planner.lock();
+				while (estimatesWaiting().load(std::memory_order_relaxed) > 0)
+				{
+					planner.unlock();
+					std::this_thread::yield();
+					planner.lock();
+				}
+			}
+			destroyRetiredPlans();
+
+			const std::size_t realCount = static_cast<std::size_t>(shape.size_x) * shape.size_y;
+			const std::size_t freqCount = static_cast<std::size_t>(shape.size_y) * freqCols(shape.size_x);
+			// Scratch arrays, freed once planned: the plans only ever run on the
+			// convolvers' own buffers through the new-array execute functions,
+			// which need those to have the planning arrays' alignment, and every
+			// one of them is fftw_malloc'd too. Measure and Patient overwrite
+			// these during their timing trials.
+			void* real = F::allocate(realCount * sizeof(Real));
+			void* freq = F::allocate(freqCount * sizeof(typename F::Complex));
+			initFftwThreads();
+			F::planWithThreads(shape.jobs);
+			void* plan = nullptr;
+			if (forward)
+			{
+				plan = shape.rank == 1
+					? static_cast<void*>(F::planForward1D(shape.size_x, real, freq, flags))
+					: static_cast<void*>(F::planForward(shape.size_y, shape.size_x, real, freq, flags));
+			}
+			else
+			{
+				plan = shape.rank == 1
+					? static_cast<void*>(F::planInverse1D(shape.size_x, freq, real, flags))
+					: static_cast<void*>(F::planInverse(shape.size_y, shape.size_x, freq, real, flags));
+			}
+			F::release(real);
+			F::release(freq);
+			return plan;
+		}
+
+		// Plans `slot`'s shape at `rigor` and makes the result current, unless
+		// another thread made plans at least as rigorous current meanwhile. With
+		// wisdomOnly, succeeds only if the process's wisdom already covers the
+		// shape at that rigor and the planner is free, and then returns without
+		// any timing trials. The two directions are planned under separate
+		// holds of plannerMutex(), so a caller queued behind a measurement waits
+		// out one transform's trials, not both.
+		template<typename Real>
+		bool planShape(FftPlanSlot& slot, PlanRigor rigor, bool wisdomOnly)
+		{
+			const trace::Span span("FFT plan", "fft");
+			FftPlanShape shape;
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex());
+				shape = slot.shape;
+			}
+			const unsigned flags = rigorFlags(rigor) | (wisdomOnly ? FFTW_WISDOM_ONLY : 0u);
+			void* forward = planTransform<Real>(shape, true, flags, !wisdomOnly);
+			void* inverse = forward != nullptr ? planTransform<Real>(shape, false, flags, !wisdomOnly) : nullptr;
+			if (forward == nullptr || inverse == nullptr)
+			{
+				if (forward != nullptr) {
+					retirePlans({ forward }, shape.precision);
+				}
+				return false;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex());
+				if (slot.current.load(std::memory_order_relaxed) == nullptr || isBelow(slot.shape.rigor, rigor))
+				{
+					slot.sets.push_back(std::make_unique<FftPlanSlot::PlanSet>(FftPlanSlot::PlanSet{ forward, inverse }));
+					slot.shape.rigor = rigor;
+					slot.current.store(slot.sets.back().get(), std::memory_order_release);
+					return true;
+				}
+			}
+			retirePlans({ forward, inverse }, shape.precision);
+			return true;
+		}
+
+		bool planShape(FftPlanSlot& slot, PlanRigor rigor, bool wisdomOnly)
+		{
+			// The precision is fixed when the slot is made, so reading it unlocked is safe.
+			return slot.shape.precision == Precision::Single
+				? planShape<float>(slot, rigor, wisdomOnly)
+				: planShape<double>(slot, rigor, wisdomOnly);
+		}
+
+		void measureInBackground(std::shared_ptr<FftPlanSlot> slot, PlanRigor rigor)
+		{
+			PlanCache& cache = planCache();
+			std::lock_guard<std::mutex> lock(cache.pendingMutex);
+			std::erase_if(cache.pending, [](const std::shared_future<void>& measurement)
+				{
+					return measurement.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				});
+			cache.pending.push_back(std::async(std::launch::async, [slot = std::move(slot), rigor]
+				{
+					bool upgrade = false;
+					{
+						std::lock_guard<std::mutex> bookkeeping(cacheMutex());
+						upgrade = isBelow(slot->shape.rigor, rigor);
+					}
+					if (upgrade) {
+						planShape(*slot, rigor, false);
+					}
+					std::lock_guard<std::mutex> bookkeeping(cacheMutex());
+					slot->measuring = false;
+				}).share());
+		}
+
+		// The cached plans for a shape, planned now if the shape is new. Never
+		// runs timing trials in the caller's thread: under Measure or Patient a
+		// shape the wisdom does not cover gets an Estimate plan now and its
+		// measured one in the background. A shape already cached is returned
+		// without touching the planner, even while a measurement runs.
+		std::shared_ptr<FftPlanSlot> acquirePlans(int rank, int size_x, int size_y, Precision precision)
+		{
+			const PlanRigor rigor = planRigor();
+			std::shared_ptr<FftPlanSlot> slot;
+			bool upgrade = false;
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex());
+				slot = slotFor(rank, size_x, size_y, precision);
+				upgrade = rigor != PlanRigor::Estimate && isBelow(slot->shape.rigor, rigor) && !slot->measuring;
+				if (upgrade) {
+					slot->measuring = true;
+				}
+			}
+			// Wisdom-only planning is quick, but is skipped rather than queued
+			// behind a measurement; the background job then finds the wisdom.
+			const bool measure = upgrade && !planShape(*slot, rigor, true);
+			if (upgrade && !measure)
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex());
+				slot->measuring = false;
+			}
+			if (slot->current.load(std::memory_order_acquire) == nullptr) {
+				planShape(*slot, PlanRigor::Estimate, false);
+			}
+			if (measure) {
+				measureInBackground(slot, rigor);
+			}
+			return slot;
+		}
+
+		void preparePlans(int rank, int size_x, int size_y, Precision precision, PlanRigor rigor)
+		{
+			std::shared_ptr<FftPlanSlot> slot;
+			bool plan = false;
+			{
+				std::lock_guard<std::mutex> lock(cacheMutex());
+				slot = slotFor(rank, size_x, size_y, precision);
+				plan = slot->current.load(std::memory_order_relaxed) == nullptr || isBelow(slot->shape.rigor, rigor);
+			}
+			if (plan) {
+				planShape(*slot, rigor, false);
+			}
+		}
+
+		template<typename Real>
+		std::filesystem::path wisdomFile(const std::string& directory)
+		{
+			return std::filesystem::path(directory) / (std::is_same_v<Real, float> ? "single.wisdom" : "double.wisdom");
+		}
+	}
+
+	void setPlanRigor(PlanRigor rigor)
+	{
+		if (rigor != PlanRigor::Estimate)
+		{
+			static std::once_flag wisdomLoaded;
+			std::call_once(wisdomLoaded, [] { loadFftWisdom(defaultFftWisdomDirectory()); });
+		}
+		rigorStorage().store(rigor, std::memory_order_relaxed);
+	}
+
+	PlanRigor planRigor()
+	{
+		return rigorStorage().load(std::memory_order_relaxed);
+	}
+
+	ScopedPlanRigor::ScopedPlanRigor(PlanRigor rigor)
+		: previous_(planRigor())
+	{
+		setPlanRigor(rigor);
+	}
+
+	ScopedPlanRigor::~ScopedPlanRigor()
+	{
+		setPlanRigor(previous_);
+	}
+
+	bool fftJobsRunOnThreadPool()
+	{
+		// fftw_version reads "fftw-3.3.10-sse2-avx" and the like.
+		int major = 0, minor = 0, patch = 0;
+		if (std::sscanf(fftw_version, "fftw-%d.%d.%d", &major, &minor, &patch) != 3) {
+			return false;
+		}
+		return std::tie(major, minor, patch) >= std::make_tuple(3, 3, 9);
+	}
+
+	std::vector<FftPlanShape> cachedFftPlans()
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex());
+		std::vector<FftPlanShape> shapes;
+		shapes.reserve(planCache().slots.size());
+		for (const auto& [key, slot] : planCache().slots) {
+			shapes.push_back(slot->shape);
+		}
+		return shapes;
+	}
+
+	void prepareFftPlans2D(int size_x, int size_y, Precision precision, PlanRigor rigor)
+	{
+		preparePlans(2, size_x, size_y, precision, rigor);
+	}
+
+	void prepareFftPlans1D(int size, PlanRigor rigor)
+	{
+		preparePlans(1, size, 1, Precision::Double, rigor);
+	}
+
+	void waitForFftPlans()
+	{
+		// Copied, not taken: a second thread waiting at the same time must
+		// wait for the same measurements rather than find none.
+		PlanCache& cache = planCache();
+		std::vector<std::shared_future<void>> pending;
+		{
+			std::lock_guard<std::mutex> lock(cache.pendingMutex);
+			pending = cache.pending;
+		}
+		for (const auto& measurement : pending) {
+			measurement.wait();
+		}
+	}
+
+	void clearFftPlanCache()
+	{
+		waitForFftPlans();
+		// Released outside the lock: a slot no convolver holds any more is
+		// destroyed here, and its destructor retires its plans itself.
+		std::map<PlanKey, std::shared_ptr<FftPlanSlot>> released;
+		{
+			std::lock_guard<std::mutex> lock(cacheMutex());
+			released.swap(planCache().slots);
+		}
+		released.clear();
+		std::lock_guard<std::mutex> planner(plannerMutex());
+		destroyRetiredPlans();
+	}
+
+	std::string defaultFftWisdomDirectory()
+	{
+		return (std::filesystem::path(utils::getResourceRoot()) / "data" / "fftw-wisdom").string();
+	}
+
+	bool loadFftWisdom(const std::string& directory)
+	{
+		const auto doubleFile = wisdomFile<double>(directory);
+		const auto singleFile = wisdomFile<float>(directory);
+		std::error_code ec;
+		const bool haveDouble = std::filesystem::is_regular_file(doubleFile, ec);
+		const bool haveSingle = std::filesystem::is_regular_file(singleFile, ec);
+
+		std::lock_guard<std::mutex> lock(plannerMutex());
+		destroyRetiredPlans();
+		// Before the import: wisdom read in ahead of fftw_init_threads() is kept
+		// but never matched, so every shape would be measured again.
+		initFftwThreads();
+		bool loaded = false;
+		if (haveDouble) {
+			loaded = Fftw<double>::importWisdom(doubleFile.string().c_str()) || loaded;
+		}
+		if (haveSingle) {
+			loaded = Fftw<float>::importWisdom(singleFile.string().c_str()) || loaded;
+		}
+		return loaded;
+	}
+
+	bool saveFftWisdom(const std::string& directory)
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (ec) {
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(plannerMutex());
+		destroyRetiredPlans();
+		const bool savedDouble = Fftw<double>::exportWisdom(wisdomFile<double>(directory).string().c_str());
+		const bool savedSingle = Fftw<float>::exportWisdom(wisdomFile<float>(directory).string().c_str());
+		return savedDouble && savedSingle;
 	}
 
 	void setConvolutionModeOverride(ConvolutionMode mode)
@@ -70,28 +753,42 @@ namespace dnf_composer::tools::math
 			size_x >= kFFTMinAxisSize && size_y >= kFFTMinAxisSize;
 	}
 
-	void SpectralConvolver2D::destroy()
+	bool shouldUseSpectral1D(bool circular, int totalTaps, int size)
 	{
-		std::lock_guard<std::mutex> lock(plannerMutex());
-		if (forwardPlan_ != nullptr) {
-			fftw_destroy_plan(static_cast<fftw_plan>(forwardPlan_));
+		// Same structure as shouldUseSpectral2D: legality first, then the
+		// override, then the measured crossover.
+		if (!circular || size <= 0) {
+			return false;
 		}
-		if (inversePlan_ != nullptr) {
-			fftw_destroy_plan(static_cast<fftw_plan>(inversePlan_));
+
+		switch (convolutionModeOverride())
+		{
+		case ConvolutionMode::ForceDirect:   return false;
+		case ConvolutionMode::ForceSpectral: return true;
+		case ConvolutionMode::Auto:          break;
 		}
+
+		return totalTaps > kFFTTapThreshold1D && size >= kFFTMinSize1D;
+	}
+
+	void SpectralConvolver2D::destroy()
+	{
+		const bool single = precision_ == Precision::Single;
+		auto release = [single](void* p) { single ? Fftw<float>::release(p) : Fftw<double>::release(p); };
+
 		if (fieldReal_ != nullptr) {
-			fftw_free(fieldReal_);
+			release(fieldReal_);
 		}
 		if (fieldFreq_ != nullptr) {
-			fftw_free(fieldFreq_);
+			release(fieldFreq_);
 		}
 		if (kernelFreq_ != nullptr) {
-			fftw_free(kernelFreq_);
+			release(kernelFreq_);
 		}
 		if (resultReal_ != nullptr) {
-			fftw_free(resultReal_);
+			release(resultReal_);
 		}
-		forwardPlan_ = inversePlan_ = nullptr;
+		plans_.reset();
 		fieldReal_ = fieldFreq_ = kernelFreq_ = resultReal_ = nullptr;
 		size_x_ = size_y_ = 0;
 	}
@@ -107,11 +804,11 @@ namespace dnf_composer::tools::math
 			return;
 		}
 
-		init(other.size_x_, other.size_y_);
+		init(other.size_x_, other.size_y_, other.precision_);
 		if (other.kernelFreq_ != nullptr)
 		{
 			const std::size_t bytes =
-				static_cast<std::size_t>(size_y_) * freqCols(size_x_) * sizeof(fftw_complex);
+				static_cast<std::size_t>(size_y_) * freqCols(size_x_) * complexBytes(precision_);
 			std::memcpy(kernelFreq_, other.kernelFreq_, bytes);
 		}
 	}
@@ -132,14 +829,13 @@ namespace dnf_composer::tools::math
 	}
 
 	SpectralConvolver2D::SpectralConvolver2D(SpectralConvolver2D&& other) noexcept
-		: size_x_(other.size_x_), size_y_(other.size_y_),
+		: size_x_(other.size_x_), size_y_(other.size_y_), precision_(other.precision_),
 		  fieldReal_(other.fieldReal_), fieldFreq_(other.fieldFreq_),
 		  kernelFreq_(other.kernelFreq_), resultReal_(other.resultReal_),
-		  forwardPlan_(other.forwardPlan_), inversePlan_(other.inversePlan_)
+		  plans_(std::move(other.plans_))
 	{
 		other.size_x_ = other.size_y_ = 0;
 		other.fieldReal_ = other.fieldFreq_ = other.kernelFreq_ = other.resultReal_ = nullptr;
-		other.forwardPlan_ = other.inversePlan_ = nullptr;
 	}
 
 	SpectralConvolver2D& SpectralConvolver2D::operator=(SpectralConvolver2D&& other) noexcept
@@ -147,104 +843,314 @@ namespace dnf_composer::tools::math
 		if (this != &other)
 		{
 			destroy();
-			size_x_ = other.size_x_; size_y_ = other.size_y_;
+			size_x_ = other.size_x_; size_y_ = other.size_y_; precision_ = other.precision_;
 			fieldReal_ = other.fieldReal_; fieldFreq_ = other.fieldFreq_;
 			kernelFreq_ = other.kernelFreq_; resultReal_ = other.resultReal_;
-			forwardPlan_ = other.forwardPlan_; inversePlan_ = other.inversePlan_;
+			plans_ = std::move(other.plans_);
 			other.size_x_ = other.size_y_ = 0;
 			other.fieldReal_ = other.fieldFreq_ = other.kernelFreq_ = other.resultReal_ = nullptr;
-			other.forwardPlan_ = other.inversePlan_ = nullptr;
 		}
 		return *this;
 	}
 
-	void SpectralConvolver2D::init(int size_x, int size_y)
+	void SpectralConvolver2D::init(int size_x, int size_y, Precision precision)
 	{
-		// Same geometry and live plans -> nothing to re-plan. Checking the plan
-		// pointers (not just the sizes) matters: a default-constructed or
-		// moved-from object has size_x_ == size_y_ == 0, and init(0,0) must not
-		// be short-circuited into a no-op. NOTE this preserves kernelFreq_,
-		// which is exactly why every caller must still call setKernel() after
-		// init() whenever the taps may have changed: see setKernel()'s comment.
-		if (size_x == size_x_ && size_y == size_y_ && forwardPlan_ != nullptr && inversePlan_ != nullptr) {
+		// Same geometry, same precision and live plans -> nothing to re-plan.
+		// Checking the plans (not just the sizes) matters: a
+		// default-constructed or moved-from object has size_x_ == size_y_ == 0,
+		// and init(0,0) must not be short-circuited into a no-op. NOTE this
+		// preserves kernelFreq_, which is exactly why every caller must still
+		// call setKernel() after init() whenever the taps may have changed: see
+		// setKernel()'s comment.
+		if (size_x == size_x_ && size_y == size_y_ && precision == precision_ && plans_ != nullptr) {
 			return;
 		}
 
 		destroy();
 		size_x_ = size_x;
 		size_y_ = size_y;
+		precision_ = precision;
 
-		const std::size_t realCount = static_cast<std::size_t>(size_x) * size_y;
-		const std::size_t freqCount = static_cast<std::size_t>(size_y) * freqCols(size_x);
+		const bool single = precision_ == Precision::Single;
+		const std::size_t realBytes = static_cast<std::size_t>(size_x) * size_y * (single ? sizeof(float) : sizeof(double));
+		const std::size_t freqBytes = static_cast<std::size_t>(size_y) * freqCols(size_x) * complexBytes(precision_);
+		auto allocate = [single](std::size_t bytes) { return single ? Fftw<float>::allocate(bytes) : Fftw<double>::allocate(bytes); };
 
-		fieldReal_  = fftw_malloc(sizeof(double) * realCount);
-		resultReal_ = fftw_malloc(sizeof(double) * realCount);
-		fieldFreq_  = fftw_malloc(sizeof(fftw_complex) * freqCount);
-		kernelFreq_ = fftw_malloc(sizeof(fftw_complex) * freqCount);
-		if (fieldReal_ == nullptr || resultReal_ == nullptr || fieldFreq_ == nullptr || kernelFreq_ == nullptr) {
-			throw std::bad_alloc();
-		}
+		fieldReal_  = allocate(realBytes);
+		resultReal_ = allocate(realBytes);
+		fieldFreq_  = allocate(freqBytes);
+		kernelFreq_ = allocate(freqBytes);
 
-		// FFTW_ESTIMATE (a heuristic, no timing trials) rather than
-		// FFTW_MEASURE: every element's setParameters() re-runs init(), and the
-		// UI calls setParameters() on every frame a width slider is dragged
+		// From the plan cache, which never runs timing trials here whatever
+		// planRigor() says: every element's setParameters() re-runs init(), and
+		// the UI calls setParameters() on every frame a width slider is dragged
 		// (no IsItemDeactivatedAfterEdit() gate), so with five elements able to
 		// plan, FFTW_MEASURE's timing trials would otherwise stall the UI for
-		// tens of milliseconds per novel size, repeatedly, during a drag.
-		// ESTIMATE also does not clobber its input buffers, so — unlike
-		// MEASURE — planning here does not require fieldReal_/fieldFreq_ to
-		// already hold anything meaningful.
-		std::lock_guard<std::mutex> lock(plannerMutex());
-		forwardPlan_ = fftw_plan_dft_r2c_2d(
-			size_y, size_x,
-			static_cast<double*>(fieldReal_),
-			static_cast<fftw_complex*>(fieldFreq_),
-			FFTW_ESTIMATE);
-		inversePlan_ = fftw_plan_dft_c2r_2d(
-			size_y, size_x,
-			static_cast<fftw_complex*>(fieldFreq_),
-			static_cast<double*>(resultReal_),
-			FFTW_ESTIMATE);
+		// tens of milliseconds per novel size, repeatedly, during a drag. A
+		// size already seen by the process costs nothing at all.
+		plans_ = acquirePlans(2, size_x, size_y, precision_);
 	}
 
 	void SpectralConvolver2D::setKernel(const std::vector<double>& wrappedKernelReal)
 	{
-		auto* real = static_cast<double*>(fieldReal_);
-		std::memcpy(real, wrappedKernelReal.data(), wrappedKernelReal.size() * sizeof(double));
-		fftw_execute(static_cast<fftw_plan>(forwardPlan_));
-
-		// Fold FFTW's unnormalized-transform convention (forward+inverse scales
-		// by size_x*size_y) into the stored kernel spectrum once here, so every
-		// subsequent apply() needs no separate normalization pass.
-		const double norm = 1.0 / (static_cast<double>(size_x_) * size_y_);
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
 		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
-		auto* kf = static_cast<fftw_complex*>(kernelFreq_);
-		auto* ff = static_cast<fftw_complex*>(fieldFreq_);
-		for (std::size_t i = 0; i < freqCount; ++i)
-		{
-			kf[i][0] = ff[i][0] * norm;
-			kf[i][1] = ff[i][1] * norm;
+		const void* forwardPlan = plans_->plans().forward;
+		if (precision_ == Precision::Single) {
+			setKernelSpectrum<float>(wrappedKernelReal, fieldReal_, fieldFreq_, kernelFreq_, forwardPlan, realCount, freqCount);
+		} else {
+			setKernelSpectrum<double>(wrappedKernelReal, fieldReal_, fieldFreq_, kernelFreq_, forwardPlan, realCount, freqCount);
 		}
 	}
 
 	void SpectralConvolver2D::apply(const double* field, double* out)
 	{
-		auto* real = static_cast<double*>(fieldReal_);
-		std::memcpy(real, field, static_cast<std::size_t>(size_x_) * size_y_ * sizeof(double));
-		fftw_execute(static_cast<fftw_plan>(forwardPlan_));
+		const trace::Span span("SpectralConvolver2D::apply", "fft");
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
+		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
+		// Loaded once, so both transforms come from the same set even if an
+		// upgrade lands mid-call.
+		const FftPlanSlot::PlanSet& plans = plans_->plans();
+		if (precision_ == Precision::Single) {
+			convolveSpectrally<float, double, double>(field, out, fieldReal_, fieldFreq_, kernelFreq_, resultReal_,
+				plans.forward, plans.inverse, realCount, freqCount);
+		} else {
+			convolveSpectrally<double, double, double>(field, out, fieldReal_, fieldFreq_, kernelFreq_, resultReal_,
+				plans.forward, plans.inverse, realCount, freqCount);
+		}
+	}
 
-		auto* ff = static_cast<fftw_complex*>(fieldFreq_);
-		auto* kf = static_cast<fftw_complex*>(kernelFreq_);
+	void SpectralConvolver2D::applySpectrum(const SharedSpectrum2D& spectrum, double* out)
+	{
+		const trace::Span span("SpectralConvolver2D::applySpectrum", "fft");
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
 		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
-		for (std::size_t i = 0; i < freqCount; ++i)
+		const void* inversePlan = plans_->plans().inverse;
+		if (precision_ == Precision::Single) {
+			multiplyAndInvert<float, double>(spectrum.spectrum_, out, fieldFreq_, kernelFreq_, resultReal_,
+				inversePlan, realCount, freqCount);
+		} else {
+			multiplyAndInvert<double, double>(spectrum.spectrum_, out, fieldFreq_, kernelFreq_, resultReal_,
+				inversePlan, realCount, freqCount);
+		}
+	}
+
+	void SpectralConvolver2D::apply(const float* field, float* out)
+	{
+		const trace::Span span("SpectralConvolver2D::apply", "fft");
+		if (precision_ != Precision::Single) {
+			throw std::invalid_argument("SpectralConvolver2D::apply: float buffers need Precision::Single");
+		}
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
+		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
+		const FftPlanSlot::PlanSet& plans = plans_->plans();
+		convolveSpectrally<float, float, float>(field, out, fieldReal_, fieldFreq_, kernelFreq_, resultReal_,
+			plans.forward, plans.inverse, realCount, freqCount);
+	}
+
+	void SpectralConvolver2D::applySpectrum(const SharedSpectrum2D& spectrum, float* out)
+	{
+		const trace::Span span("SpectralConvolver2D::applySpectrum", "fft");
+		if (precision_ != Precision::Single) {
+			throw std::invalid_argument("SpectralConvolver2D::applySpectrum: float buffers need Precision::Single");
+		}
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
+		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
+		multiplyAndInvert<float, float>(spectrum.spectrum_, out, fieldFreq_, kernelFreq_, resultReal_,
+			plans_->plans().inverse, realCount, freqCount);
+	}
+
+	void SpectralConvolver2D::addKernelSpectrum(const SpectralConvolver2D& other)
+	{
+		if (other.size_x_ != size_x_ || other.size_y_ != size_y_ || other.precision_ != precision_ ||
+			kernelFreq_ == nullptr || other.kernelFreq_ == nullptr) {
+			throw std::invalid_argument("SpectralConvolver2D::addKernelSpectrum: size or precision mismatch");
+		}
+
+		const std::size_t freqCount = static_cast<std::size_t>(size_y_) * freqCols(size_x_);
+		if (precision_ == Precision::Single) {
+			addSpectrum<float>(kernelFreq_, other.kernelFreq_, freqCount);
+		} else {
+			addSpectrum<double>(kernelFreq_, other.kernelFreq_, freqCount);
+		}
+	}
+
+	void SharedSpectrum2D::destroy()
+	{
+		const bool single = precision_ == Precision::Single;
+		if (fieldReal_ != nullptr) {
+			single ? Fftw<float>::release(fieldReal_) : Fftw<double>::release(fieldReal_);
+		}
+		if (spectrum_ != nullptr) {
+			single ? Fftw<float>::release(spectrum_) : Fftw<double>::release(spectrum_);
+		}
+		plans_.reset();
+		fieldReal_ = spectrum_ = nullptr;
+		size_x_ = size_y_ = 0;
+		current_ = false;
+	}
+
+	SharedSpectrum2D::~SharedSpectrum2D()
+	{
+		destroy();
+	}
+
+	void SharedSpectrum2D::init(int size_x, int size_y, Precision precision)
+	{
+		current_ = false;
+		if (size_x == size_x_ && size_y == size_y_ && precision == precision_ && plans_ != nullptr) {
+			return;
+		}
+
+		destroy();
+		size_x_ = size_x;
+		size_y_ = size_y;
+		precision_ = precision;
+
+		// The cached forward plan of this shape, the very one
+		// SpectralConvolver2D::apply() runs, on buffers with the same
+		// fftw_malloc alignment, so the shared spectrum matches the one apply()
+		// computes bit for bit.
+		const bool single = precision_ == Precision::Single;
+		const std::size_t realBytes = static_cast<std::size_t>(size_x) * size_y * (single ? sizeof(float) : sizeof(double));
+		const std::size_t freqBytes = static_cast<std::size_t>(size_y) * freqCols(size_x) * complexBytes(precision_);
+		fieldReal_ = single ? Fftw<float>::allocate(realBytes) : Fftw<double>::allocate(realBytes);
+		spectrum_  = single ? Fftw<float>::allocate(freqBytes) : Fftw<double>::allocate(freqBytes);
+		plans_ = acquirePlans(2, size_x, size_y, precision_);
+	}
+
+	void SharedSpectrum2D::forward(const double* field)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (current_) {
+			return;
+		}
+
+		const std::size_t realCount = static_cast<std::size_t>(size_x_) * size_y_;
+		const void* forwardPlan = plans_->plans().forward;
+		if (precision_ == Precision::Single)
+		{
+			std::copy(field, field + realCount, static_cast<float*>(fieldReal_));
+			Fftw<float>::executeForward(forwardPlan, fieldReal_, spectrum_);
+		}
+		else
+		{
+			std::copy(field, field + realCount, static_cast<double*>(fieldReal_));
+			Fftw<double>::executeForward(forwardPlan, fieldReal_, spectrum_);
+		}
+		current_ = true;
+	}
+
+	void SpectralConvolver1D::destroy()
+	{
+		if (fieldReal_ != nullptr) {
+			Fftw<double>::release(fieldReal_);
+		}
+		if (fieldFreq_ != nullptr) {
+			Fftw<double>::release(fieldFreq_);
+		}
+		if (kernelFreq_ != nullptr) {
+			Fftw<double>::release(kernelFreq_);
+		}
+		if (resultReal_ != nullptr) {
+			Fftw<double>::release(resultReal_);
+		}
+		plans_.reset();
+		fieldReal_ = fieldFreq_ = kernelFreq_ = resultReal_ = nullptr;
+		size_ = 0;
+	}
+
+	SpectralConvolver1D::~SpectralConvolver1D()
+	{
+		destroy();
+	}
+
+	void SpectralConvolver1D::copyFrom(const SpectralConvolver1D& other)
+	{
+		if (other.size_ == 0) {
+			return;
+		}
+
+		init(other.size_);
+		if (other.kernelFreq_ != nullptr) {
+			std::memcpy(kernelFreq_, other.kernelFreq_, static_cast<std::size_t>(freqCols(size_)) * sizeof(fftw_complex));
+		}
+	}
+
+	SpectralConvolver1D::SpectralConvolver1D(const SpectralConvolver1D& other)
+	{
+		copyFrom(other);
+	}
+
+	SpectralConvolver1D& SpectralConvolver1D::operator=(const SpectralConvolver1D& other)
+	{
+		if (this != &other)
 		{
-			const double re = ff[i][0] * kf[i][0] - ff[i][1] * kf[i][1];
-			const double im = ff[i][0] * kf[i][1] + ff[i][1] * kf[i][0];
-			ff[i][0] = re;
-			ff[i][1] = im;
+			destroy();
+			copyFrom(other);
 		}
+		return *this;
+	}
 
-		fftw_execute(static_cast<fftw_plan>(inversePlan_));
-		std::memcpy(out, resultReal_, static_cast<std::size_t>(size_x_) * size_y_ * sizeof(double));
+	SpectralConvolver1D::SpectralConvolver1D(SpectralConvolver1D&& other) noexcept
+		: size_(other.size_),
+		  fieldReal_(other.fieldReal_), fieldFreq_(other.fieldFreq_),
+		  kernelFreq_(other.kernelFreq_), resultReal_(other.resultReal_),
+		  plans_(std::move(other.plans_))
+	{
+		other.size_ = 0;
+		other.fieldReal_ = other.fieldFreq_ = other.kernelFreq_ = other.resultReal_ = nullptr;
+	}
+
+	SpectralConvolver1D& SpectralConvolver1D::operator=(SpectralConvolver1D&& other) noexcept
+	{
+		if (this != &other)
+		{
+			destroy();
+			size_ = other.size_;
+			fieldReal_ = other.fieldReal_; fieldFreq_ = other.fieldFreq_;
+			kernelFreq_ = other.kernelFreq_; resultReal_ = other.resultReal_;
+			plans_ = std::move(other.plans_);
+			other.size_ = 0;
+			other.fieldReal_ = other.fieldFreq_ = other.kernelFreq_ = other.resultReal_ = nullptr;
+		}
+		return *this;
+	}
+
+	void SpectralConvolver1D::init(int size)
+	{
+		// Same no-op rule as SpectralConvolver2D::init(): an unchanged size with
+		// live plans keeps the plans and the kernel spectrum.
+		if (size == size_ && plans_ != nullptr) {
+			return;
+		}
+
+		destroy();
+		size_ = size;
+
+		const std::size_t realBytes = static_cast<std::size_t>(size) * sizeof(double);
+		const std::size_t freqBytes = static_cast<std::size_t>(freqCols(size)) * sizeof(fftw_complex);
+		fieldReal_  = Fftw<double>::allocate(realBytes);
+		resultReal_ = Fftw<double>::allocate(realBytes);
+		fieldFreq_  = Fftw<double>::allocate(freqBytes);
+		kernelFreq_ = Fftw<double>::allocate(freqBytes);
+
+		// From the plan cache, for the same reason as in 2D: setParameters()
+		// re-runs init().
+		plans_ = acquirePlans(1, size, 1, Precision::Double);
+	}
+
+	void SpectralConvolver1D::setKernel(const std::vector<double>& wrappedKernelReal)
+	{
+		setKernelSpectrum<double>(wrappedKernelReal, fieldReal_, fieldFreq_, kernelFreq_, plans_->plans().forward,
+			static_cast<std::size_t>(size_), static_cast<std::size_t>(freqCols(size_)));
+	}
+
+	void SpectralConvolver1D::apply(const double* field, double* out)
+	{
+		const trace::Span span("SpectralConvolver1D::apply", "fft");
+		const FftPlanSlot::PlanSet& plans = plans_->plans();
+		convolveSpectrally<double, double, double>(field, out, fieldReal_, fieldFreq_, kernelFreq_, resultReal_,
+			plans.forward, plans.inverse, static_cast<std::size_t>(size_), static_cast<std::size_t>(freqCols(size_)));
 	}
 }
@@ -0,0 +1,117 @@
+#include "tools/latency_histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace dnf_composer::tools::profiling
+{
+	namespace
+	{
+		void increment(std::atomic<std::uint64_t>& counter, std::uint64_t by)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+		}
+	}
+
+	std::size_t LatencyHistogram::bucketOf(std::uint64_t nanoseconds)
+	{
+		if (nanoseconds < kSubBuckets) {
+			return static_cast<std::size_t>(nanoseconds);
+		}
+		const int exponent = std::bit_width(nanoseconds) - 1;
+		if (exponent >= kMaxExponent) {
+			return kBuckets - 1;
+		}
+		const auto sub = static_cast<std::size_t>((nanoseconds >> (exponent - 4)) & (kSubBuckets - 1));
+		return kSubBuckets + static_cast<std::size_t>(exponent - 4) * kSubBuckets + sub;
+	}
+
+	std::uint64_t LatencyHistogram::bucketStart(std::size_t bucket)
+	{
+		if (bucket < kSubBuckets) {
+			return bucket;
+		}
+		const std::size_t exponent = (bucket - kSubBuckets) / kSubBuckets + 4;
+		const std::size_t sub = (bucket - kSubBuckets) % kSubBuckets;
+		return static_cast<std::uint64_t>(kSubBuckets + sub) << (exponent - 4);
+	}
+
+	std::uint64_t LatencyHistogram::bucketWidth(std::size_t bucket)
+	{
+		if (bucket < kSubBuckets) {
+			return 1;
+		}
+		return std::uint64_t{ 1 } << ((bucket - kSubBuckets) / kSubBuckets);
+	}
+
+	void LatencyHistogram::record(std::chrono::nanoseconds duration)
+	{
+		const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+		increment(counts_[bucketOf(ns)], 1);
+		increment(total_, ns);
+		if (ns > max_.load(std::memory_order_relaxed)) {
+			max_.store(ns, std::memory_order_relaxed);
+		}
+	}
+
+	LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+	{
+		Snapshot s;
+		for (std::size_t b = 0; b < kBuckets; ++b)
+		{
+			s.counts[b] = counts_[b].load(std::memory_order_relaxed);
+			s.count += s.counts[b];
+		}
+		s.total = std::chrono::nanoseconds(total_.load(std::memory_order_relaxed));
+		s.max = std::chrono::nanoseconds(max_.load(std::memory_order_relaxed));
+		return s;
+	}
+
+	void LatencyHistogram::reset()
+	{
+		for (auto& c : counts_) {
+			c.store(0, std::memory_order_relaxed);
+		}
+		total_.store(0, std::memory_order_relaxed);
+		max_.store(0, std::memory_order_relaxed);
+	}
+
+	std::chrono::nanoseconds LatencyHistogram::Snapshot::percentile(double q) const
+	{
+		if (count == 0) {
+			return std::chrono::nanoseconds{ 0 };
+		}
+		const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count))));
+		if (rank >= count) {
+			return max;
+		}
+		std::uint64_t seen = 0;
+		for (std::size_t b = 0; b < kBuckets; ++b)
+		{
+			seen += counts[b];
+			if (seen >= rank)
+			{
+				const std::uint64_t middle = bucketStart(b) + bucketWidth(b) / 2;
+				return std::min(std::chrono::nanoseconds(middle), max);
+			}
+		}
+		return max;
+	}
+
+	std::chrono::nanoseconds LatencyHistogram::Snapshot::mean() const
+	{
+		return count == 0 ? std::chrono::nanoseconds{ 0 } : total / static_cast<std::int64_t>(count);
+	}
+
+	LatencyHistogram::Snapshot& LatencyHistogram::Snapshot::operator+=(const Snapshot& other)
+	{
+		for (std::size_t b = 0; b < kBuckets; ++b) {
+			counts[b] += other.counts[b];
+		}
+		count += other.count;
+		total += other.total;
+		max = std::max(max, other.max);
+		return *this;
+	}
+}
@@ -0,0 +1,100 @@
+#include "tools/mapped_file.h"
+
+#include <format>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace dnf_composer::tools
+{
+	MappedFile::MappedFile(const std::string& path, Access access)
+	{
+		const bool copyOnWrite = access == Access::CopyOnWrite;
+#ifdef _WIN32
+		const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error(std::format("Cannot open '{}'", path));
+		}
+		LARGE_INTEGER fileSize{};
+		GetFileSizeEx(file, &fileSize);
+		const auto size = static_cast<std::size_t>(fileSize.QuadPart);
+		if (size > 0)
+		{
+			const HANDLE mapping = CreateFileMappingA(file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+			{
+				data_ = static_cast<const std::byte*>(MapViewOfFile(mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::runtime_error(std::format("Cannot open '{}'", path));
+		}
+		struct stat status{};
+		::fstat(fd, &status);
+		const auto size = static_cast<std::size_t>(status.st_size);
+		if (size > 0)
+		{
+			void* mapped = ::mmap(nullptr, size, copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapped != MAP_FAILED) {
+				data_ = static_cast<const std::byte*>(mapped);
+			}
+		}
+		::close(fd);
+#endif
+		if (size > 0 && data_ == nullptr) {
+			throw std::runtime_error(std::format("Cannot map '{}'", path));
+		}
+		size_ = size;
+		writable_ = copyOnWrite;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		reset();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+		writable_(std::exchange(other.writable_, false))
+	{}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			data_ = std::exchange(other.data_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+			writable_ = std::exchange(other.writable_, false);
+		}
+		return *this;
+	}
+
+	void MappedFile::reset() noexcept
+	{
+		if (data_ == nullptr) {
+			return;
+		}
+#ifdef _WIN32
+		UnmapViewOfFile(data_);
+#else
+		::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+		data_ = nullptr;
+		size_ = 0;
+		writable_ = false;
+	}
+}
@@ -203,28 +203,54 @@
 				return vec;
 			}
 
-			void seedNormal(std::uint64_t seed)
+			namespace
 			{
 				// SplitMix64 expansion of a single seed into the four 64-bit words
-				// Xoshiro256's state needs. Same seed => same subsequent fillNormal
-				// sequence on the calling thread.
-				std::uint64_t state = seed;
-				auto splitmix64 = [&state]() {
-					state += 0x9E3779B97F4A7C15ULL;
-					std::uint64_t z = state;
-					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
-					z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
-					return z ^ (z >> 31);
-				};
-
-				Xoshiro256& eng = threadEngine();
-				for (auto& v : eng.s) {
-					v = splitmix64();
+				// Xoshiro256's state needs.
+				void seedEngine(Xoshiro256& eng, std::uint64_t seed)
+				{
+					std::uint64_t state = seed;
+					auto splitmix64 = [&state]() {
+						state += 0x9E3779B97F4A7C15ULL;
+						std::uint64_t z = state;
+						z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+						z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+						return z ^ (z >> 31);
+					};
+					for (auto& v : eng.s) {
+						v = splitmix64();
+					}
+					// Avoid the degenerate all-zero state (see makeSeededEngine).
+					if ((eng.s[0] | eng.s[1] | eng.s[2] | eng.s[3]) == 0) {
+						eng.s[0] = 0x9E3779B97F4A7C15ULL;
+					}
 				}
-				// Avoid the degenerate all-zero state (see makeSeededEngine).
-				if ((eng.s[0] | eng.s[1] | eng.s[2] | eng.s[3]) == 0) {
-					eng.s[0] = 0x9E3779B97F4A7C15ULL;
+			}
+
+			void seedNormal(std::uint64_t seed)
+			{
+				// Same seed => same subsequent fillNormal sequence on the calling thread.
+				seedEngine(threadEngine(), seed);
+			}
+
+			NormalStream::NormalStream(std::uint64_t seed)
+				: state{}
+			{
+				Xoshiro256 eng{};
+				seedEngine(eng, seed);
+				state = eng.s;
+			}
+
+			void NormalStream::fill(double* dst, std::size_t n)
+			{
+				// Work on a local engine and write the state back once: keeps the
+				// engine in registers for the batch, like fillNormal's thread_local.
+				Xoshiro256 eng{ state };
+				const ZigguratTables& z = zigTables();
+				for (std::size_t i = 0; i < n; ++i) {
+					dst[i] = zigguratNormal(eng, z);
 				}
+				state = eng.s;
 			}
 
 			void embedWrapped1D(std::vector<double>& out, std::span<const double> window, int kR0)
@@ -271,5 +297,16 @@
 				}
 				return combined;
 			}
+
+			std::vector<double> buildWrappedKernel1D(int size, std::span<const double> window, int kR0)
+			{
+				if (size <= 0) {
+					return {};
+				}
+
+				std::vector<double> wrapped(size, 0.0);
+				embedWrapped1D(wrapped, window, kR0);
+				return wrapped;
+			}
 		}
 	
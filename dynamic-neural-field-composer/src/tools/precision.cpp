@@ -0,0 +1,40 @@
+#include "tools/precision.h"
+
+#include <atomic>
+
+namespace dnf_composer::tools::math
+{
+	namespace
+	{
+		std::atomic<Precision>& precisionStorage()
+		{
+#ifdef DNF_COMPOSER_SINGLE_PRECISION
+			static std::atomic<Precision> value{ Precision::Single };
+#else
+			static std::atomic<Precision> value{ Precision::Double };
+#endif
+			return value;
+		}
+	}
+
+	void setPrecision(Precision precision)
+	{
+		precisionStorage().store(precision, std::memory_order_relaxed);
+	}
+
+	Precision precision()
+	{
+		return precisionStorage().load(std::memory_order_relaxed);
+	}
+
+	ScopedPrecision::ScopedPrecision(Precision precision)
+		: previous_(math::precision())
+	{
+		setPrecision(precision);
+	}
+
+	ScopedPrecision::~ScopedPrecision()
+	{
+		setPrecision(previous_);
+	}
+}
@@ -0,0 +1,241 @@
+#include "tools/recording_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+
+namespace dnf_composer::tools::recording_file
+{
+	namespace
+	{
+		// A zero run shorter than this stays inside the literal around it: a
+		// token costs at least a byte.
+		constexpr std::size_t kMinZeroRun = 4;
+		// Quantized values are clamped to +-2^62 steps so their differences fit
+		// an int64.
+		constexpr double kMaxSteps = 4611686018427387904.0;
+
+		void putVarint(std::vector<std::byte>& out, std::uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				out.push_back(static_cast<std::byte>(value | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<std::byte>(value));
+		}
+
+		std::uint64_t getVarint(std::span<const std::byte> in, std::size_t& pos)
+		{
+			std::uint64_t value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (pos >= in.size()) {
+					throw std::runtime_error("Corrupt recording frame: truncated run length");
+				}
+				const auto byte = static_cast<std::uint64_t>(in[pos++]);
+				value |= (byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) {
+					return value;
+				}
+			}
+			throw std::runtime_error("Corrupt recording frame: run length too long");
+		}
+
+		void encodeRuns(std::span<const std::uint8_t> planes, std::vector<std::byte>& out)
+		{
+			const std::size_t size = planes.size();
+			std::size_t literalStart = 0;
+			const auto flushLiteral = [&](std::size_t end)
+			{
+				if (end > literalStart)
+				{
+					putVarint(out, (end - literalStart) << 1);
+					const auto* first = reinterpret_cast<const std::byte*>(planes.data() + literalStart);
+					out.insert(out.end(), first, first + (end - literalStart));
+				}
+			};
+			std::size_t i = 0;
+			while (i < size)
+			{
+				if (planes[i] != 0)
+				{
+					++i;
+					continue;
+				}
+				std::size_t j = i;
+				while (j < size && planes[j] == 0) {
+					++j;
+				}
+				if (j - i >= kMinZeroRun || j == size)
+				{
+					flushLiteral(i);
+					putVarint(out, (j - i) << 1 | 1);
+					literalStart = j;
+				}
+				i = j;
+			}
+			flushLiteral(size);
+		}
+
+		void decodeRuns(std::span<const std::byte> in, std::span<std::uint8_t> planes)
+		{
+			std::size_t pos = 0;
+			std::size_t filled = 0;
+			while (pos < in.size())
+			{
+				const std::uint64_t token = getVarint(in, pos);
+				const std::uint64_t length = token >> 1;
+				if (length > planes.size() - filled) {
+					throw std::runtime_error("Corrupt recording frame: runs overflow the frame");
+				}
+				if ((token & 1) != 0)
+				{
+					std::fill_n(planes.begin() + static_cast<std::ptrdiff_t>(filled), length, std::uint8_t{ 0 });
+				}
+				else
+				{
+					if (length > in.size() - pos) {
+						throw std::runtime_error("Corrupt recording frame: truncated literal run");
+					}
+					std::memcpy(planes.data() + filled, in.data() + pos, length);
+					pos += length;
+				}
+				filled += length;
+			}
+			if (filled != planes.size()) {
+				throw std::runtime_error(std::format("Corrupt recording frame: {} of {} bytes", filled, planes.size()));
+			}
+		}
+
+		std::uint64_t zigzag(std::uint64_t difference)
+		{
+			return (difference << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(difference) >> 63);
+		}
+
+		std::uint64_t unzigzag(std::uint64_t value)
+		{
+			return (value >> 1) ^ (~(value & 1) + 1);
+		}
+
+		std::uint64_t quantize(double value, double step)
+		{
+			const double steps = value / step;
+			if (std::isnan(steps)) {
+				return 0;
+			}
+			return static_cast<std::uint64_t>(std::llround(std::clamp(steps, -kMaxSteps, kMaxSteps)));
+		}
+	}
+
+	void validate(const CodecOptions& options)
+	{
+		switch (options.codec)
+		{
+		case RecordingCodec::None:
+		case RecordingCodec::XorDelta:
+			break;
+		case RecordingCodec::Quantized:
+			if (!(options.tolerance > 0.0) || !std::isfinite(options.tolerance)) {
+				throw std::invalid_argument(std::format("Quantized recordings need a positive tolerance, not {}", options.tolerance));
+			}
+			break;
+		default:
+			throw std::invalid_argument(std::format("Unknown recording codec {}", static_cast<int>(options.codec)));
+		}
+		if (options.keyframeInterval == 0) {
+			throw std::invalid_argument("The keyframe interval must be at least 1");
+		}
+	}
+
+	FrameEncoder::FrameEncoder(const CodecOptions& options, std::size_t frameValues)
+		: options_(options), previous_(frameValues), residuals_(frameValues),
+		  planes_(frameValues * sizeof(std::uint64_t)), framesSinceKeyframe_(options.keyframeInterval)
+	{
+		validate(options_);
+		if (options_.codec == RecordingCodec::None) {
+			throw std::invalid_argument("Uncoded recordings have no frame encoder");
+		}
+	}
+
+	bool FrameEncoder::encode(std::span<const double> values, std::vector<std::byte>& payload)
+	{
+		const bool keyframe = framesSinceKeyframe_ >= options_.keyframeInterval;
+		framesSinceKeyframe_ = keyframe ? 1 : framesSinceKeyframe_ + 1;
+		if (keyframe) {
+			std::ranges::fill(previous_, 0);
+		}
+
+		const std::size_t n = previous_.size();
+		if (options_.codec == RecordingCodec::Quantized)
+		{
+			const double step = 2.0 * options_.tolerance;
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				const std::uint64_t q = quantize(values[i], step);
+				residuals_[i] = zigzag(q - previous_[i]);
+				previous_[i] = q;
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				const auto bits = std::bit_cast<std::uint64_t>(values[i]);
+				residuals_[i] = bits ^ previous_[i];
+				previous_[i] = bits;
+			}
+		}
+
+		for (std::size_t p = 0; p < sizeof(std::uint64_t); ++p)
+		{
+			std::uint8_t* plane = planes_.data() + p * n;
+			for (std::size_t i = 0; i < n; ++i) {
+				plane[i] = static_cast<std::uint8_t>(residuals_[i] >> (8 * p));
+			}
+		}
+		payload.clear();
+		encodeRuns(planes_, payload);
+		return keyframe;
+	}
+
+	FrameDecoder::FrameDecoder(const CodecOptions& options, std::size_t frameValues)
+		: options_(options), previous_(frameValues), planes_(frameValues * sizeof(std::uint64_t))
+	{
+		validate(options_);
+		if (options_.codec == RecordingCodec::None) {
+			throw std::invalid_argument("Uncoded recordings have no frame decoder");
+		}
+	}
+
+	void FrameDecoder::decode(std::span<const std::byte> payload, bool keyframe, std::span<double> values)
+	{
+		decodeRuns(payload, planes_);
+		if (keyframe) {
+			std::ranges::fill(previous_, 0);
+		}
+
+		const std::size_t n = previous_.size();
+		const double step = 2.0 * options_.tolerance;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			std::uint64_t residual = 0;
+			for (std::size_t p = 0; p < sizeof(std::uint64_t); ++p) {
+				residual |= static_cast<std::uint64_t>(planes_[p * n + i]) << (8 * p);
+			}
+			if (options_.codec == RecordingCodec::Quantized)
+			{
+				previous_[i] += unzigzag(residual);
+				values[i] = static_cast<double>(static_cast<std::int64_t>(previous_[i])) * step;
+			}
+			else
+			{
+				previous_[i] ^= residual;
+				values[i] = std::bit_cast<double>(previous_[i]);
+			}
+		}
+	}
+}
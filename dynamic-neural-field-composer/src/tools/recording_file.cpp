@@ -0,0 +1,385 @@
+#include "tools/recording_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little,
+	"recordings store frames in little-endian byte order");
+
+namespace dnf_composer::tools::recording_file
+{
+	namespace
+	{
+		constexpr char kMagic[4] = { 'D', 'N', 'F', 'R' };
+
+		constexpr std::uint8_t kKeyframeFlag = 1;
+		constexpr std::uint8_t kRegionFlag = 1;
+		constexpr std::size_t kRegionSize = 4 * sizeof(std::uint32_t);
+
+		std::size_t headerSizeFor(std::size_t elementIdLength, std::size_t componentNameLength, bool region)
+		{
+			const std::size_t bytes = kFixedHeaderSize + elementIdLength + componentNameLength + (region ? kRegionSize : 0);
+			return (bytes + 63) & ~static_cast<std::size_t>(63);
+		}
+
+		// The options as the header stores them: the fields a codec does not use are dropped.
+		CodecOptions stored(const CodecOptions& options)
+		{
+			switch (options.codec)
+			{
+			case RecordingCodec::None:
+				return {};
+			case RecordingCodec::XorDelta:
+				return { options.codec, 0.0, options.keyframeInterval };
+			default:
+				return options;
+			}
+		}
+
+		struct CodedFrames
+		{
+			std::size_t count = 0;
+			std::size_t end = 0; // Byte after the last whole frame.
+		};
+
+		// Walk the coded frames after the header, optionally noting where each starts.
+		CodedFrames scanCodedFrames(const std::byte* data, std::size_t size, std::size_t headerSize,
+			std::vector<std::size_t>* offsets)
+		{
+			CodedFrames frames{ 0, headerSize };
+			while (size - frames.end >= kCodedFramePrefixSize)
+			{
+				std::uint32_t payloadSize = 0;
+				std::memcpy(&payloadSize, data + frames.end + 16, sizeof(payloadSize));
+				if (payloadSize > size - frames.end - kCodedFramePrefixSize) {
+					break;
+				}
+				if (offsets != nullptr) {
+					offsets->push_back(frames.end);
+				}
+				frames.end += kCodedFramePrefixSize + payloadSize;
+				++frames.count;
+			}
+			return frames;
+		}
+
+		// The info a header describes; validates it against a file of `fileSize`
+		// bytes, or returns the reason it is not a valid recording.
+		std::string parseHeader(const std::byte* data, std::size_t fileSize, RecordingInfo& info)
+		{
+			if (fileSize < kFixedHeaderSize) {
+				return "too small";
+			}
+			RecordingFileHeader h{};
+			std::memcpy(&h, data, sizeof(h));
+			if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+				return "bad magic";
+			}
+			if (h.version > kCodedVersion) {
+				return std::format("version {} is newer than this build reads ({})", h.version, kCodedVersion);
+			}
+			if (h.dtype != RecordingDtype::Float64 || (h.unit != SampleUnit::Ticks && h.unit != SampleUnit::Milliseconds)) {
+				return "unsupported dtype or sample unit";
+			}
+			const bool region = (h.flags & kRegionFlag) != 0;
+			if (h.headerSize != headerSizeFor(h.elementIdLength, h.componentNameLength, region) || h.headerSize > fileSize) {
+				return "header size does not match its names";
+			}
+			const bool coded = h.version == kCodedVersion;
+			if (coded == (h.codec == RecordingCodec::None)) {
+				return std::format("codec {} in a version {} file", static_cast<int>(h.codec), h.version);
+			}
+			const CodecOptions codec{ h.codec, h.tolerance, h.keyframeInterval };
+			try
+			{
+				if (coded) {
+					validate(codec);
+				}
+			}
+			catch (const std::invalid_argument& e)
+			{
+				return e.what();
+			}
+			if (h.frameValues == 0 || h.frameSize != (coded ? 0 : frameSize(h.frameValues))) {
+				return "frame size does not match the values per frame";
+			}
+			const auto* names = reinterpret_cast<const char*>(data + kFixedHeaderSize);
+			info.elementId.assign(names, h.elementIdLength);
+			info.componentName.assign(names + h.elementIdLength, h.componentNameLength);
+			info.frameValues = h.frameValues;
+			info.sizeX = static_cast<int>(h.sizeX);
+			info.sizeY = static_cast<int>(h.sizeY);
+			info.sampleInterval = h.sampleInterval;
+			info.unit = h.unit;
+			info.codec = stored(codec);
+			info.region = {};
+			if (region)
+			{
+				std::uint32_t block[4];
+				std::memcpy(block, names + h.elementIdLength + h.componentNameLength, sizeof(block));
+				constexpr auto maxInt = static_cast<std::uint32_t>(std::numeric_limits<int>::max());
+				if (block[2] == 0 || block[3] == 0 || std::ranges::any_of(block, [](std::uint32_t v) { return v > maxInt; })) {
+					return "invalid region";
+				}
+				info.region = { static_cast<int>(block[0]), static_cast<int>(block[1]),
+					static_cast<int>(block[2]), static_cast<int>(block[3]) };
+			}
+			return {};
+		}
+	}
+
+	void writeHeader(std::ostream& out, const RecordingInfo& info)
+	{
+		constexpr std::size_t maxName = std::numeric_limits<std::uint16_t>::max();
+		if (info.elementId.size() > maxName || info.componentName.size() > maxName) {
+			throw std::invalid_argument("Recording element id or component name is too long");
+		}
+		validate(info.codec);
+		const SampledRegion& r = info.region;
+		if (r.originX < 0 || r.originY < 0 || r.strideX < 1 || r.strideY < 1) {
+			throw std::invalid_argument("Recording region has a negative origin or a stride below 1");
+		}
+		const bool region = r != SampledRegion{};
+		const CodecOptions codec = stored(info.codec);
+		const bool coded = codec.codec != RecordingCodec::None;
+		RecordingFileHeader header{};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = coded ? kCodedVersion : kVersion;
+		header.dtype = RecordingDtype::Float64;
+		header.unit = info.unit;
+		header.headerSize = static_cast<std::uint32_t>(headerSizeFor(info.elementId.size(), info.componentName.size(), region));
+		header.sampleInterval = info.sampleInterval;
+		header.sizeX = static_cast<std::uint32_t>(info.sizeX);
+		header.sizeY = static_cast<std::uint32_t>(info.sizeY);
+		header.frameValues = info.frameValues;
+		header.frameSize = coded ? 0 : frameSize(info.frameValues);
+		header.elementIdLength = static_cast<std::uint16_t>(info.elementId.size());
+		header.componentNameLength = static_cast<std::uint16_t>(info.componentName.size());
+		header.codec = codec.codec;
+		header.flags = region ? kRegionFlag : 0;
+		header.tolerance = codec.tolerance;
+		header.keyframeInterval = coded ? codec.keyframeInterval : 0;
+
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(info.elementId.data(), static_cast<std::streamsize>(info.elementId.size()));
+		out.write(info.componentName.data(), static_cast<std::streamsize>(info.componentName.size()));
+		if (region)
+		{
+			const std::uint32_t block[4] = { static_cast<std::uint32_t>(r.originX), static_cast<std::uint32_t>(r.originY),
+				static_cast<std::uint32_t>(r.strideX), static_cast<std::uint32_t>(r.strideY) };
+			out.write(reinterpret_cast<const char*>(block), sizeof(block));
+		}
+		const std::size_t padding = header.headerSize - kFixedHeaderSize - info.elementId.size() - info.componentName.size()
+			- (region ? kRegionSize : 0);
+		static constexpr char zeros[64] = {};
+		out.write(zeros, static_cast<std::streamsize>(padding));
+	}
+
+	void writeFrame(std::ostream& out, long long ticks, double ms, std::span<const double> values)
+	{
+		const std::int64_t frameTicks = ticks;
+		out.write(reinterpret_cast<const char*>(&frameTicks), sizeof(frameTicks));
+		out.write(reinterpret_cast<const char*>(&ms), sizeof(ms));
+		out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size_bytes()));
+	}
+
+	void writeCodedFrame(std::ostream& out, long long ticks, double ms, bool keyframe, std::span<const std::byte> payload)
+	{
+		const std::int64_t frameTicks = ticks;
+		const auto payloadSize = static_cast<std::uint32_t>(payload.size());
+		const std::uint8_t flags[4] = { keyframe ? kKeyframeFlag : std::uint8_t{ 0 }, 0, 0, 0 };
+		out.write(reinterpret_cast<const char*>(&frameTicks), sizeof(frameTicks));
+		out.write(reinterpret_cast<const char*>(&ms), sizeof(ms));
+		out.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+		out.write(reinterpret_cast<const char*>(flags), sizeof(flags));
+		out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+	}
+
+	std::size_t prepareAppend(const std::string& path, const RecordingInfo& info)
+	{
+		std::error_code ec;
+		const auto size = std::filesystem::file_size(path, ec);
+		if (ec || size == 0) {
+			return 0;
+		}
+		RecordingInfo existing;
+		RecordingInfo expected = info;
+		expected.codec = stored(info.codec);
+		std::size_t frames = 0;
+		std::size_t whole = 0;
+		{
+			const MappedFile file(path);
+			if (const std::string reason = parseHeader(file.data(), file.size(), existing); !reason.empty()) {
+				throw std::runtime_error(std::format("Cannot append to '{}': not a valid recording ({})", path, reason));
+			}
+			if (existing != expected) {
+				throw std::runtime_error(std::format("Cannot append to '{}': it records a different element, component, shape or codec", path));
+			}
+			const std::size_t headerSize = headerSizeFor(info.elementId.size(), info.componentName.size(),
+				info.region != SampledRegion{});
+			if (existing.codec.codec != RecordingCodec::None)
+			{
+				const CodedFrames coded = scanCodedFrames(file.data(), file.size(), headerSize, nullptr);
+				frames = coded.count;
+				whole = coded.end;
+			}
+			else
+			{
+				frames = (size - headerSize) / frameSize(info.frameValues);
+				whole = headerSize + frames * frameSize(info.frameValues);
+			}
+		}
+		if (whole != size) {
+			std::filesystem::resize_file(path, whole);
+		}
+		return frames;
+	}
+
+	void writeCsvHeader(std::ostream& out, std::size_t componentSize, int sizeX, int sizeY, const SampledRegion& region)
+	{
+		if (sizeY > 1) {
+			out << "# size_x=" << sizeX << ",size_y=" << sizeY << "\n";
+		}
+		if (region != SampledRegion{}) {
+			out << "# origin_x=" << region.originX << ",origin_y=" << region.originY
+				<< ",stride_x=" << region.strideX << ",stride_y=" << region.strideY << "\n";
+		}
+		out << "ticks,ms";
+		for (std::size_t i = 0; i < componentSize; ++i) {
+			out << "," << i;
+		}
+		out << "\n";
+	}
+
+	void writeCsvRow(std::ostream& out, long long ticks, double ms, std::span<const double> values)
+	{
+		out << ticks << "," << std::fixed << std::setprecision(6) << ms;
+		for (const double v : values) {
+			out << "," << v;
+		}
+		out << "\n";
+	}
+
+	MappedRecording::MappedRecording(const std::string& path)
+		: file_(path)
+	{
+		if (const std::string reason = parseHeader(file_.data(), file_.size(), info_); !reason.empty())
+		{
+			file_.reset();
+			throw std::runtime_error(std::format("'{}' is not a valid recording: {}", path, reason));
+		}
+		if (coded())
+		{
+			const CodedFrames frames = scanCodedFrames(file_.data(), file_.size(), header().headerSize, &offsets_);
+			frameCount_ = frames.count;
+			end_ = frames.end;
+			decoder_ = std::make_unique<FrameDecoder>(info_.codec, info_.frameValues);
+			decoded_.resize(info_.frameValues);
+		}
+		else
+		{
+			frameCount_ = (file_.size() - header().headerSize) / header().frameSize;
+			end_ = header().headerSize + frameCount_ * header().frameSize;
+		}
+		decodedFrame_ = frameCount_;
+	}
+
+	std::size_t MappedRecording::trailingBytes() const
+	{
+		return file_.size() - end_;
+	}
+
+	void MappedRecording::checkFrame(std::size_t frame) const
+	{
+		if (frame >= frameCount_) {
+			throw std::out_of_range(std::format("Frame {} of a {}-frame recording", frame, frameCount_));
+		}
+	}
+
+	long long MappedRecording::ticks(std::size_t frame) const
+	{
+		checkFrame(frame);
+		std::int64_t value = 0;
+		std::memcpy(&value, frameData(frame), sizeof(value));
+		return value;
+	}
+
+	double MappedRecording::ms(std::size_t frame) const
+	{
+		checkFrame(frame);
+		double value = 0.0;
+		std::memcpy(&value, frameData(frame) + sizeof(std::int64_t), sizeof(value));
+		return value;
+	}
+
+	std::span<const double> MappedRecording::frame(std::size_t frame) const
+	{
+		checkFrame(frame);
+		if (coded()) {
+			throw std::logic_error("Frames of a coded recording are not stored in place; use readFrame()");
+		}
+		// Header and frame sizes are multiples of 8, so the values are aligned.
+		return { reinterpret_cast<const double*>(frameData(frame) + kFramePrefixSize), info_.frameValues };
+	}
+
+	std::span<const double> MappedRecording::readFrame(std::size_t frame) const
+	{
+		if (!coded()) {
+			return this->frame(frame);
+		}
+		checkFrame(frame);
+		if (frame == decodedFrame_) {
+			return decoded_;
+		}
+		const auto isKeyframe = [this](std::size_t k)
+		{
+			return (static_cast<std::uint8_t>(frameData(k)[20]) & kKeyframeFlag) != 0;
+		};
+		// Decode from the last keyframe at or before `frame`, or carry on from the
+		// frame decoded last if that is closer.
+		std::size_t start = frame;
+		while (!isKeyframe(start))
+		{
+			if (start == 0) {
+				throw std::runtime_error(std::format("Frame {} does not follow a keyframe", frame));
+			}
+			if (start - 1 == decodedFrame_) {
+				break;
+			}
+			--start;
+		}
+		decodedFrame_ = frameCount_;
+		for (std::size_t k = start; k <= frame; ++k)
+		{
+			std::uint32_t payloadSize = 0;
+			std::memcpy(&payloadSize, frameData(k) + 16, sizeof(payloadSize));
+			decoder_->decode({ frameData(k) + kCodedFramePrefixSize, payloadSize }, isKeyframe(k), decoded_);
+		}
+		decodedFrame_ = frame;
+		return decoded_;
+	}
+
+	std::vector<double> MappedRecording::column(std::size_t index) const
+	{
+		if (index >= info_.frameValues) {
+			throw std::out_of_range(std::format("Index {} of a {}-value frame", index, info_.frameValues));
+		}
+		std::vector<double> series(frameCount_);
+		for (std::size_t k = 0; k < frameCount_; ++k)
+		{
+			if (coded()) {
+				series[k] = readFrame(k)[index];
+			}
+			else {
+				std::memcpy(&series[k], frameData(k) + kFramePrefixSize + index * sizeof(double), sizeof(double));
+			}
+		}
+		return series;
+	}
+}
@@ -1,9 +1,14 @@
 // Compiled at the toolchain's DEFAULT baseline (no AVX2/FMA flag) — this is the
-// file every other translation unit calls into to ask "is it safe to call the
-// AVX2 kernel", so it must not itself require AVX2 to run.
+// file every other translation unit calls into to ask "which kernels are safe
+// to call", so it must not itself require AVX2 to run. It also holds the
+// scalar tier's kernels, which is why they match the loops their callers used
+// to run inline bit for bit.
 
 #include "tools/simd_dispatch.h"
 
+#include <atomic>
+#include <cmath>
+
 // AVX2 is an x86/x64-only ISA extension. __builtin_cpu_supports("avx2") and
 // <intrin.h>'s cpuid intrinsics are unavailable/meaningless on other
 // architectures (e.g. Apple Silicon's arm64) — gate the whole detection on
@@ -53,4 +58,223 @@ namespace dnf_composer::tools::math::detail
 		}();
 		return result;
 	}
+
+	bool avx512f_available()
+	{
+		static const bool result = []() -> bool
+		{
+#if DNF_COMPOSER_X86 && defined(_MSC_VER)
+			int regs[4] = { 0, 0, 0, 0 };
+			__cpuid(regs, 0);
+			if (regs[0] < 7) return false;
+
+			__cpuid(regs, 1);
+			if ((regs[2] & (1 << 27)) == 0) return false; // ECX.OSXSAVE
+
+			// XCR0[7:5] = opmask + ZMM0-15 upper halves + ZMM16-31, on top of SSE + AVX.
+			const unsigned long long xcr0 = _xgetbv(0);
+			if ((xcr0 & 0xE6) != 0xE6) return false;
+
+			__cpuidex(regs, 7, 0);
+			return (regs[1] & (1 << 16)) != 0; // EBX.AVX512F
+#elif DNF_COMPOSER_X86 && (defined(__GNUC__) || defined(__clang__))
+			// Also checks the OS saves the ZMM state.
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx512f");
+#else
+			return false;
+#endif
+		}();
+		return result;
+	}
+
+	// ── Scalar tier ─────────────────────────────────────────────────────────────
+
+	void conv_valid_into_scalar_f64(const double* kr, int M, const double* mx, double* o, int n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			const double* __restrict w = mx + i;
+			double acc = 0.0;
+			for (int m = 0; m < M; ++m) {
+				acc += kr[m] * w[m];
+			}
+			o[i] = acc;
+		}
+	}
+
+	void conv_valid_into_scalar_f32(const float* kr, int M, const float* mx, float* o, int n)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			const float* __restrict w = mx + i;
+			float acc = 0.0f;
+			for (int m = 0; m < M; ++m) {
+				acc += kr[m] * w[m];
+			}
+			o[i] = acc;
+		}
+	}
+
+	void sigmoid_scalar_f64(const double* in, double* out, std::size_t n, double s, double xs)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			double e = -s * (in[i] - xs);
+			if (e < -88.0) {
+				e = -88.0;
+			} else if (e > 88.0) {
+				e = 88.0;
+			}
+			out[i] = 1.0 / (1.0 + std::exp(e));
+		}
+	}
+
+	void heaviside_scalar_f64(const double* in, double* out, std::size_t n, double xs)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			out[i] = (in[i] > xs) ? 1.0 : 0.0;
+		}
+	}
+
+	void abs_sigmoid_scalar_f64(const double* in, double* out, std::size_t n, double beta, double xs)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			const double diff = in[i] - xs;
+			out[i] = 0.5 * (1.0 + beta * diff / (1.0 + beta * std::abs(diff)));
+		}
+	}
+
+	void euler_scalar_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			act[i] += dtOverTau * (-act[i] + rest + inp[i]);
+		}
+	}
+
+	void memory_trace_scalar_f64(const double* in, double* out, std::size_t n,
+	                             double threshold, double buildRate, double decayRate)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			if (in[i] > threshold) {
+				out[i] += buildRate * (-out[i] + in[i]);
+			} else {
+				out[i] += decayRate * (-out[i]);
+			}
+		}
+	}
+
+	void accumulate_scalar_f64(double* dst, const double* src, std::size_t n)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			dst[i] += src[i];
+		}
+	}
+
+	void scaled_axpy_scalar_f64(double* y, const double* w, std::size_t n, double scale, double x)
+	{
+		for (std::size_t i = 0; i < n; ++i) {
+			y[i] += scale * w[i] * x;
+		}
+	}
+
+	// ── Tables ──────────────────────────────────────────────────────────────────
+
+	namespace
+	{
+		constexpr SimdKernels scalarKernels{
+			SimdTier::Scalar,
+			conv_valid_into_scalar_f64, conv_valid_into_scalar_f32,
+			sigmoid_scalar_f64, heaviside_scalar_f64, abs_sigmoid_scalar_f64,
+			euler_scalar_f64, memory_trace_scalar_f64, accumulate_scalar_f64,
+			scaled_axpy_scalar_f64
+		};
+
+		constexpr SimdKernels avx2Kernels{
+			SimdTier::Avx2,
+			conv_valid_into_avx2_f64, conv_valid_into_avx2_f32,
+			sigmoid_avx2_f64, heaviside_avx2_f64, abs_sigmoid_avx2_f64,
+			euler_avx2_f64, memory_trace_avx2_f64, accumulate_avx2_f64,
+			scaled_axpy_avx2_f64
+		};
+
+		constexpr SimdKernels avx512Kernels{
+			SimdTier::Avx512,
+			conv_valid_into_avx512_f64, conv_valid_into_avx512_f32,
+			sigmoid_avx512_f64, heaviside_avx512_f64, abs_sigmoid_avx512_f64,
+			euler_avx512_f64, memory_trace_avx512_f64, accumulate_avx512_f64,
+			scaled_axpy_avx512_f64
+		};
+
+		const SimdKernels& tableFor(SimdTier tier)
+		{
+			switch (tier)
+			{
+			case SimdTier::Avx512: return avx512Kernels;
+			case SimdTier::Avx2:   return avx2Kernels;
+			default:               return scalarKernels;
+			}
+		}
+
+		std::atomic<const SimdKernels*>& activeKernels()
+		{
+			static std::atomic<const SimdKernels*> active{ &tableFor(detectedSimdTier()) };
+			return active;
+		}
+	}
+
+	const SimdKernels& simdKernels()
+	{
+		return *activeKernels().load(std::memory_order_relaxed);
+	}
+
+	const SimdKernels& simdKernelsFor(SimdTier tier)
+	{
+		return tableFor(tier <= detectedSimdTier() ? tier : detectedSimdTier());
+	}
+}
+
+namespace dnf_composer::tools::math
+{
+	const char* toString(SimdTier tier)
+	{
+		switch (tier)
+		{
+		case SimdTier::Avx512: return "avx512";
+		case SimdTier::Avx2:   return "avx2";
+		default:               return "scalar";
+		}
+	}
+
+	SimdTier detectedSimdTier()
+	{
+		static const SimdTier tier = []
+		{
+			if (!detail::avx2_fma_available()) return SimdTier::Scalar;
+			return detail::avx512f_available() ? SimdTier::Avx512 : SimdTier::Avx2;
+		}();
+		return tier;
+	}
+
+	void setSimdTier(SimdTier tier)
+	{
+		detail::activeKernels().store(&detail::simdKernelsFor(tier), std::memory_order_relaxed);
+	}
+
+	SimdTier simdTier()
+	{
+		return detail::simdKernels().tier;
+	}
+
+	ScopedSimdTier::ScopedSimdTier(SimdTier tier)
+		: previous_(simdTier())
+	{
+		setSimdTier(tier);
+	}
+
+	ScopedSimdTier::~ScopedSimdTier()
+	{
+		setSimdTier(previous_);
+	}
 }
@@ -243,6 +243,206 @@ namespace dnf_composer::tools::math::detail
 			o[i] = acc;
 		}
 	}
+
+	void conv_valid_into_avx2_f32(const float* kr, int M, const float* mx, float* o, int n)
+	{
+		// conv_valid_into_avx2_f64 at 8 lanes: the same symmetric folding, the
+		// same per-output operation order (centre tap, then pairs in ascending
+		// j / taps in ascending m) and the same four-chain unroll, so a float
+		// result differs from the double one only by float rounding.
+		bool symmetric = (M % 2 == 1);
+		if (symmetric) {
+			for (int j = 0, c = M - 1; j < c; ++j, --c) {
+				if (kr[j] != kr[c]) { symmetric = false; break; }
+			}
+		}
+
+		int i = 0;
+		if (symmetric)
+		{
+			const int c = M / 2;
+			const __m256 kc = _mm256_set1_ps(kr[c]);
+			for (; i + 32 <= n; i += 32)
+			{
+				const float* __restrict w = mx + i;
+				__m256 a0 = _mm256_mul_ps(kc, _mm256_loadu_ps(w + c));
+				__m256 a1 = _mm256_mul_ps(kc, _mm256_loadu_ps(w + c + 8));
+				__m256 a2 = _mm256_mul_ps(kc, _mm256_loadu_ps(w + c + 16));
+				__m256 a3 = _mm256_mul_ps(kc, _mm256_loadu_ps(w + c + 24));
+				for (int j = 0; j < c; ++j)
+				{
+					const __m256 kv = _mm256_set1_ps(kr[j]);
+					const int mj = 2 * c - j;
+					a0 = _mm256_fmadd_ps(kv, _mm256_add_ps(_mm256_loadu_ps(w + j),      _mm256_loadu_ps(w + mj)),      a0);
+					a1 = _mm256_fmadd_ps(kv, _mm256_add_ps(_mm256_loadu_ps(w + j + 8),  _mm256_loadu_ps(w + mj + 8)),  a1);
+					a2 = _mm256_fmadd_ps(kv, _mm256_add_ps(_mm256_loadu_ps(w + j + 16), _mm256_loadu_ps(w + mj + 16)), a2);
+					a3 = _mm256_fmadd_ps(kv, _mm256_add_ps(_mm256_loadu_ps(w + j + 24), _mm256_loadu_ps(w + mj + 24)), a3);
+				}
+				_mm256_storeu_ps(o + i,      a0);
+				_mm256_storeu_ps(o + i + 8,  a1);
+				_mm256_storeu_ps(o + i + 16, a2);
+				_mm256_storeu_ps(o + i + 24, a3);
+			}
+			for (; i + 8 <= n; i += 8)
+			{
+				const float* __restrict w = mx + i;
+				__m256 acc = _mm256_mul_ps(kc, _mm256_loadu_ps(w + c));
+				for (int j = 0; j < c; ++j)
+				{
+					const __m256 kv  = _mm256_set1_ps(kr[j]);
+					const __m256 sum = _mm256_add_ps(_mm256_loadu_ps(w + j),
+					                                 _mm256_loadu_ps(w + (2 * c - j)));
+					acc = _mm256_fmadd_ps(kv, sum, acc);
+				}
+				_mm256_storeu_ps(o + i, acc);
+			}
+			for (; i < n; ++i)
+			{
+				const float* __restrict w = mx + i;
+				float acc = kr[c] * w[c];
+				for (int j = 0; j < c; ++j) {
+					acc += kr[j] * (w[j] + w[2 * c - j]);
+				}
+				o[i] = acc;
+			}
+			return;
+		}
+
+		for (; i + 32 <= n; i += 32)
+		{
+			const float* __restrict w = mx + i;
+			__m256 a0 = _mm256_setzero_ps();
+			__m256 a1 = _mm256_setzero_ps();
+			__m256 a2 = _mm256_setzero_ps();
+			__m256 a3 = _mm256_setzero_ps();
+			for (int m = 0; m < M; ++m)
+			{
+				const __m256 kv = _mm256_set1_ps(kr[m]);
+				a0 = _mm256_fmadd_ps(kv, _mm256_loadu_ps(w + m),      a0);
+				a1 = _mm256_fmadd_ps(kv, _mm256_loadu_ps(w + m + 8),  a1);
+				a2 = _mm256_fmadd_ps(kv, _mm256_loadu_ps(w + m + 16), a2);
+				a3 = _mm256_fmadd_ps(kv, _mm256_loadu_ps(w + m + 24), a3);
+			}
+			_mm256_storeu_ps(o + i,      a0);
+			_mm256_storeu_ps(o + i + 8,  a1);
+			_mm256_storeu_ps(o + i + 16, a2);
+			_mm256_storeu_ps(o + i + 24, a3);
+		}
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256 acc = _mm256_setzero_ps();
+			const float* __restrict w = mx + i;
+			for (int m = 0; m < M; ++m) {
+				acc = _mm256_fmadd_ps(_mm256_set1_ps(kr[m]), _mm256_loadu_ps(w + m), acc);
+			}
+			_mm256_storeu_ps(o + i, acc);
+		}
+		for (; i < n; ++i)
+		{
+			const float* __restrict w = mx + i;
+			float acc = 0.0f;
+			for (int m = 0; m < M; ++m) {
+				acc += kr[m] * w[m];
+			}
+			o[i] = acc;
+		}
+	}
+
+	void conv_valid_batched_avx2_f64(const double* taps, int M, bool symmetric,
+	                                 const double* ext, double* o, int n, int K)
+	{
+		// Lanes are batch members, so there is no horizontal work and no
+		// shuffling: each output cell is K contiguous doubles. Per lane this is
+		// exactly conv_valid_into_avx2_f64's sequence -- the centre tap, then
+		// the folded pairs in ascending j when symmetric, else the taps in
+		// ascending m -- so a batch member matches a standalone kernel bit for
+		// bit. Four 4-wide chains hide the fmadd latency, as above.
+		const std::size_t stride = static_cast<std::size_t>(K);
+		const int c = M / 2;
+		auto tap = [&](int m, int k) { return _mm256_loadu_pd(taps + m * stride + k); };
+
+		for (int i = 0; i < n; ++i)
+		{
+			const double* __restrict x = ext + i * stride;
+			double* __restrict out = o + i * stride;
+			auto window = [&](int m, int k) { return _mm256_loadu_pd(x + m * stride + k); };
+			auto pair = [&](int j, int k) { return _mm256_add_pd(window(j, k), window(2 * c - j, k)); };
+
+			int k = 0;
+			for (; k + 16 <= K; k += 16)
+			{
+				__m256d a0, a1, a2, a3;
+				if (symmetric)
+				{
+					a0 = _mm256_mul_pd(tap(c, k),      window(c, k));
+					a1 = _mm256_mul_pd(tap(c, k + 4),  window(c, k + 4));
+					a2 = _mm256_mul_pd(tap(c, k + 8),  window(c, k + 8));
+					a3 = _mm256_mul_pd(tap(c, k + 12), window(c, k + 12));
+					for (int j = 0; j < c; ++j)
+					{
+						a0 = _mm256_fmadd_pd(tap(j, k),      pair(j, k),      a0);
+						a1 = _mm256_fmadd_pd(tap(j, k + 4),  pair(j, k + 4),  a1);
+						a2 = _mm256_fmadd_pd(tap(j, k + 8),  pair(j, k + 8),  a2);
+						a3 = _mm256_fmadd_pd(tap(j, k + 12), pair(j, k + 12), a3);
+					}
+				}
+				else
+				{
+					a0 = a1 = a2 = a3 = _mm256_setzero_pd();
+					for (int m = 0; m < M; ++m)
+					{
+						a0 = _mm256_fmadd_pd(tap(m, k),      window(m, k),      a0);
+						a1 = _mm256_fmadd_pd(tap(m, k + 4),  window(m, k + 4),  a1);
+						a2 = _mm256_fmadd_pd(tap(m, k + 8),  window(m, k + 8),  a2);
+						a3 = _mm256_fmadd_pd(tap(m, k + 12), window(m, k + 12), a3);
+					}
+				}
+				_mm256_storeu_pd(out + k,      a0);
+				_mm256_storeu_pd(out + k + 4,  a1);
+				_mm256_storeu_pd(out + k + 8,  a2);
+				_mm256_storeu_pd(out + k + 12, a3);
+			}
+			for (; k + 4 <= K; k += 4)
+			{
+				__m256d acc;
+				if (symmetric)
+				{
+					acc = _mm256_mul_pd(tap(c, k), window(c, k));
+					for (int j = 0; j < c; ++j) {
+						acc = _mm256_fmadd_pd(tap(j, k), pair(j, k), acc);
+					}
+				}
+				else
+				{
+					acc = _mm256_setzero_pd();
+					for (int m = 0; m < M; ++m) {
+						acc = _mm256_fmadd_pd(tap(m, k), window(m, k), acc);
+					}
+				}
+				_mm256_storeu_pd(out + k, acc);
+			}
+			// Scalar tail, matching conv_valid_into_avx2_f64's own scalar tail.
+			for (; k < K; ++k)
+			{
+				double acc;
+				if (symmetric)
+				{
+					acc = taps[c * stride + k] * x[c * stride + k];
+					for (int j = 0; j < c; ++j) {
+						acc += taps[j * stride + k] * (x[j * stride + k] + x[(2 * c - j) * stride + k]);
+					}
+				}
+				else
+				{
+					acc = 0.0;
+					for (int m = 0; m < M; ++m) {
+						acc += taps[m * stride + k] * x[m * stride + k];
+					}
+				}
+				out[k] = acc;
+			}
+		}
+	}
 }
 
 #else // !DNF_COMPOSER_X86 — unreachable (avx2_fma_available() always returns
@@ -251,6 +451,8 @@ namespace dnf_composer::tools::math::detail
 namespace dnf_composer::tools::math::detail
 {
 	void conv_valid_into_avx2_f64(const double*, int, const double*, double*, int) {}
+	void conv_valid_into_avx2_f32(const float*, int, const float*, float*, int) {}
+	void conv_valid_batched_avx2_f64(const double*, int, bool, const double*, double*, int, int) {}
 	void sigmoid_avx2_f64(const double*, double*, std::size_t, double, double) {}
 }
 
@@ -0,0 +1,151 @@
+// Compiled with AVX2 but WITHOUT FMA (see CMakeLists.txt set_source_files_properties
+// for this file). These are the element-wise kernels of the AVX2 tier, and each one
+// must be bit-identical to its scalar form in simd_dispatch.cpp: with FMA enabled,
+// GCC's default -ffp-contract=fast would be free to fuse a multiply and the add
+// that consumes it, rounding once where the scalar loop rounds twice. The
+// convolution and sigmoid kernels, which do use FMA on purpose, live in
+// simd_dispatch_avx2.cpp instead.
+//
+// Every lane performs the scalar loop's operations in the scalar loop's order.
+// Negation is a sign-bit flip (the same thing unary minus does), never 0 - x,
+// so signed zeros come out as they do in the scalar loop. Tails shorter than a
+// vector run the scalar loop itself.
+
+#include "tools/simd_dispatch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define DNF_COMPOSER_X86 1
+#else
+	#define DNF_COMPOSER_X86 0
+#endif
+
+#if DNF_COMPOSER_X86
+#include <immintrin.h>
+
+namespace dnf_composer::tools::math::detail
+{
+	namespace
+	{
+		inline __m256d negate(__m256d x)
+		{
+			return _mm256_xor_pd(x, _mm256_set1_pd(-0.0));
+		}
+	}
+
+	void heaviside_avx2_f64(const double* in, double* out, std::size_t n, double xs)
+	{
+		const __m256d xsv = _mm256_set1_pd(xs);
+		const __m256d one = _mm256_set1_pd(1.0);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			// Ordered compare: a NaN input gives 0, as `in[i] > xs` does.
+			const __m256d above = _mm256_cmp_pd(_mm256_loadu_pd(in + i), xsv, _CMP_GT_OQ);
+			_mm256_storeu_pd(out + i, _mm256_and_pd(above, one));
+		}
+		heaviside_scalar_f64(in + i, out + i, n - i, xs);
+	}
+
+	void abs_sigmoid_avx2_f64(const double* in, double* out, std::size_t n, double beta, double xs)
+	{
+		const __m256d betav = _mm256_set1_pd(beta);
+		const __m256d xsv   = _mm256_set1_pd(xs);
+		const __m256d one   = _mm256_set1_pd(1.0);
+		const __m256d half  = _mm256_set1_pd(0.5);
+		const __m256d sign  = _mm256_set1_pd(-0.0);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(in + i), xsv);
+			const __m256d absDiff = _mm256_andnot_pd(sign, diff);
+			const __m256d den = _mm256_add_pd(one, _mm256_mul_pd(betav, absDiff));
+			const __m256d ratio = _mm256_div_pd(_mm256_mul_pd(betav, diff), den);
+			_mm256_storeu_pd(out + i, _mm256_mul_pd(half, _mm256_add_pd(one, ratio)));
+		}
+		abs_sigmoid_scalar_f64(in + i, out + i, n - i, beta, xs);
+	}
+
+	void euler_avx2_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest)
+	{
+		const __m256d k     = _mm256_set1_pd(dtOverTau);
+		const __m256d restv = _mm256_set1_pd(rest);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m256d a = _mm256_loadu_pd(act + i);
+			const __m256d drive = _mm256_add_pd(_mm256_add_pd(negate(a), restv), _mm256_loadu_pd(inp + i));
+			_mm256_storeu_pd(act + i, _mm256_add_pd(a, _mm256_mul_pd(k, drive)));
+		}
+		euler_scalar_f64(act + i, inp + i, n - i, dtOverTau, rest);
+	}
+
+	void memory_trace_avx2_f64(const double* in, double* out, std::size_t n,
+	                           double threshold, double buildRate, double decayRate)
+	{
+		const __m256d thresholdv = _mm256_set1_pd(threshold);
+		const __m256d build = _mm256_set1_pd(buildRate);
+		const __m256d decay = _mm256_set1_pd(decayRate);
+		std::size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+		{
+			const __m256d x = _mm256_loadu_pd(in + i);
+			const __m256d o = _mm256_loadu_pd(out + i);
+			const __m256d negO = negate(o);
+			// Both branches are computed exactly as the scalar loop would and the
+			// one it takes is selected per lane.
+			const __m256d building = _mm256_mul_pd(build, _mm256_add_pd(negO, x));
+			const __m256d decaying = _mm256_mul_pd(decay, negO);
+			const __m256d above = _mm256_cmp_pd(x, thresholdv, _CMP_GT_OQ);
+			_mm256_storeu_pd(out + i, _mm256_add_pd(o, _mm256_blendv_pd(decaying, building, above)));
+		}
+		memory_trace_scalar_f64(in + i, out + i, n - i, threshold, buildRate, decayRate);
+	}
+
+	void accumulate_avx2_f64(double* dst, const double* src, std::size_t n)
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			_mm256_storeu_pd(dst + i,     _mm256_add_pd(_mm256_loadu_pd(dst + i),     _mm256_loadu_pd(src + i)));
+			_mm256_storeu_pd(dst + i + 4, _mm256_add_pd(_mm256_loadu_pd(dst + i + 4), _mm256_loadu_pd(src + i + 4)));
+		}
+		for (; i + 4 <= n; i += 4) {
+			_mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i), _mm256_loadu_pd(src + i)));
+		}
+		accumulate_scalar_f64(dst + i, src + i, n - i);
+	}
+
+	void scaled_axpy_avx2_f64(double* y, const double* w, std::size_t n, double scale, double x)
+	{
+		const __m256d s = _mm256_set1_pd(scale);
+		const __m256d xv = _mm256_set1_pd(x);
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			const __m256d t0 = _mm256_mul_pd(_mm256_mul_pd(s, _mm256_loadu_pd(w + i)), xv);
+			const __m256d t1 = _mm256_mul_pd(_mm256_mul_pd(s, _mm256_loadu_pd(w + i + 4)), xv);
+			_mm256_storeu_pd(y + i,     _mm256_add_pd(_mm256_loadu_pd(y + i),     t0));
+			_mm256_storeu_pd(y + i + 4, _mm256_add_pd(_mm256_loadu_pd(y + i + 4), t1));
+		}
+		for (; i + 4 <= n; i += 4) {
+			_mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i),
+				_mm256_mul_pd(_mm256_mul_pd(s, _mm256_loadu_pd(w + i)), xv)));
+		}
+		scaled_axpy_scalar_f64(y + i, w + i, n - i, scale, x);
+	}
+}
+
+#else // !DNF_COMPOSER_X86 — unreachable (detectedSimdTier() is Scalar here),
+      // stubbed so this TU still links on non-x86 architectures.
+
+namespace dnf_composer::tools::math::detail
+{
+	void heaviside_avx2_f64(const double*, double*, std::size_t, double) {}
+	void abs_sigmoid_avx2_f64(const double*, double*, std::size_t, double, double) {}
+	void euler_avx2_f64(double*, const double*, std::size_t, double, double) {}
+	void memory_trace_avx2_f64(const double*, double*, std::size_t, double, double, double) {}
+	void accumulate_avx2_f64(double*, const double*, std::size_t) {}
+	void scaled_axpy_avx2_f64(double*, const double*, std::size_t, double, double) {}
+}
+
+#endif // DNF_COMPOSER_X86
@@ -0,0 +1,142 @@
+// Compiled with AVX-512F and floating-point contraction OFF (see CMakeLists.txt
+// set_source_files_properties for this file): AVX-512F brings FMA with it, and
+// these kernels must stay bit-identical to their scalar forms in
+// simd_dispatch.cpp, for the same reason simd_elementwise_avx2.cpp is built
+// without FMA. Only called once detectedSimdTier() has returned Avx512.
+//
+// simd_elementwise_avx2.cpp at 8 lanes, using only AVX-512F instructions (no
+// DQ: the bitwise ops on doubles go through the integer forms). The tail is
+// one masked vector; the masked-off lanes are neither loaded nor stored.
+
+#include "tools/simd_dispatch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define DNF_COMPOSER_X86 1
+#else
+	#define DNF_COMPOSER_X86 0
+#endif
+
+#if DNF_COMPOSER_X86
+#include <immintrin.h>
+
+namespace dnf_composer::tools::math::detail
+{
+	namespace
+	{
+		inline __m512d negate(__m512d x)
+		{
+			const __m512i sign = _mm512_set1_epi64(static_cast<long long>(0x8000000000000000ULL));
+			return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(x), sign));
+		}
+
+		inline __mmask8 tailMask(std::size_t remaining)
+		{
+			return static_cast<__mmask8>((1u << remaining) - 1u);
+		}
+
+		// Runs body(i, mask) over [0, n) in 8-lane steps, the last one masked.
+		template<typename Body>
+		inline void forEachVector(std::size_t n, Body&& body)
+		{
+			std::size_t i = 0;
+			for (; i + 8 <= n; i += 8) {
+				body(i, static_cast<__mmask8>(0xFF));
+			}
+			if (i < n) {
+				body(i, tailMask(n - i));
+			}
+		}
+	}
+
+	void heaviside_avx512_f64(const double* in, double* out, std::size_t n, double xs)
+	{
+		const __m512d xsv = _mm512_set1_pd(xs);
+		const __m512d one = _mm512_set1_pd(1.0);
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			// Ordered compare: a NaN input gives 0, as `in[i] > xs` does.
+			const __mmask8 above = _mm512_cmp_pd_mask(_mm512_maskz_loadu_pd(m, in + i), xsv, _CMP_GT_OQ);
+			_mm512_mask_storeu_pd(out + i, m, _mm512_maskz_mov_pd(above, one));
+		});
+	}
+
+	void abs_sigmoid_avx512_f64(const double* in, double* out, std::size_t n, double beta, double xs)
+	{
+		const __m512d betav = _mm512_set1_pd(beta);
+		const __m512d xsv   = _mm512_set1_pd(xs);
+		const __m512d one   = _mm512_set1_pd(1.0);
+		const __m512d half  = _mm512_set1_pd(0.5);
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			const __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, in + i), xsv);
+			const __m512d den = _mm512_add_pd(one, _mm512_mul_pd(betav, _mm512_abs_pd(diff)));
+			const __m512d ratio = _mm512_div_pd(_mm512_mul_pd(betav, diff), den);
+			_mm512_mask_storeu_pd(out + i, m, _mm512_mul_pd(half, _mm512_add_pd(one, ratio)));
+		});
+	}
+
+	void euler_avx512_f64(double* act, const double* inp, std::size_t n, double dtOverTau, double rest)
+	{
+		const __m512d k     = _mm512_set1_pd(dtOverTau);
+		const __m512d restv = _mm512_set1_pd(rest);
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			const __m512d a = _mm512_maskz_loadu_pd(m, act + i);
+			const __m512d drive = _mm512_add_pd(_mm512_add_pd(negate(a), restv), _mm512_maskz_loadu_pd(m, inp + i));
+			_mm512_mask_storeu_pd(act + i, m, _mm512_add_pd(a, _mm512_mul_pd(k, drive)));
+		});
+	}
+
+	void memory_trace_avx512_f64(const double* in, double* out, std::size_t n,
+	                             double threshold, double buildRate, double decayRate)
+	{
+		const __m512d thresholdv = _mm512_set1_pd(threshold);
+		const __m512d build = _mm512_set1_pd(buildRate);
+		const __m512d decay = _mm512_set1_pd(decayRate);
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			const __m512d x = _mm512_maskz_loadu_pd(m, in + i);
+			const __m512d o = _mm512_maskz_loadu_pd(m, out + i);
+			const __m512d negO = negate(o);
+			const __m512d building = _mm512_mul_pd(build, _mm512_add_pd(negO, x));
+			const __m512d decaying = _mm512_mul_pd(decay, negO);
+			const __mmask8 above = _mm512_cmp_pd_mask(x, thresholdv, _CMP_GT_OQ);
+			_mm512_mask_storeu_pd(out + i, m, _mm512_add_pd(o, _mm512_mask_blend_pd(above, decaying, building)));
+		});
+	}
+
+	void accumulate_avx512_f64(double* dst, const double* src, std::size_t n)
+	{
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			const __m512d sum = _mm512_add_pd(_mm512_maskz_loadu_pd(m, dst + i), _mm512_maskz_loadu_pd(m, src + i));
+			_mm512_mask_storeu_pd(dst + i, m, sum);
+		});
+	}
+
+	void scaled_axpy_avx512_f64(double* y, const double* w, std::size_t n, double scale, double x)
+	{
+		const __m512d s = _mm512_set1_pd(scale);
+		const __m512d xv = _mm512_set1_pd(x);
+		forEachVector(n, [&](std::size_t i, __mmask8 m)
+		{
+			const __m512d term = _mm512_mul_pd(_mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, w + i)), xv);
+			_mm512_mask_storeu_pd(y + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, y + i), term));
+		});
+	}
+}
+
+#else // !DNF_COMPOSER_X86 — unreachable (detectedSimdTier() is Scalar here),
+      // stubbed so this TU still links on non-x86 architectures.
+
+namespace dnf_composer::tools::math::detail
+{
+	void heaviside_avx512_f64(const double*, double*, std::size_t, double) {}
+	void abs_sigmoid_avx512_f64(const double*, double*, std::size_t, double, double) {}
+	void euler_avx512_f64(double*, const double*, std::size_t, double, double) {}
+	void memory_trace_avx512_f64(const double*, double*, std::size_t, double, double, double) {}
+	void accumulate_avx512_f64(double*, const double*, std::size_t) {}
+	void scaled_axpy_avx512_f64(double*, const double*, std::size_t, double, double) {}
+}
+
+#endif // DNF_COMPOSER_X86
@@ -0,0 +1,178 @@
+#include "tools/sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dnf_composer::tools::math
+{
+	namespace
+	{
+		void requireShape(const CsrMatrix& weights, std::size_t inputSize, std::size_t outputSize)
+		{
+			if (weights.rows != inputSize || weights.cols != outputSize) {
+				throw std::invalid_argument("Weight matrix size mismatch");
+			}
+		}
+	}
+
+	std::size_t CsrMatrix::bytes() const
+	{
+		return rowStart.size() * sizeof(std::size_t)
+			+ columns.size() * sizeof(std::uint32_t)
+			+ values.size() * sizeof(double);
+	}
+
+	CsrMatrix csr_from_dense(std::span<const double> dense, std::size_t rows, std::size_t cols, double threshold)
+	{
+		if (dense.size() != rows * cols) {
+			throw std::invalid_argument("Weight matrix size mismatch");
+		}
+
+		CsrMatrix matrix;
+		matrix.rows = rows;
+		matrix.cols = cols;
+		matrix.rowStart.reserve(rows + 1);
+		matrix.rowStart.push_back(0);
+		for (std::size_t i = 0; i < rows; ++i)
+		{
+			const double* row = dense.data() + i * cols;
+			for (std::size_t j = 0; j < cols; ++j)
+			{
+				// !(|w| <= threshold) rather than |w| > threshold, so a NaN is kept
+				// and shows up in the output as it would have densely.
+				if (!(std::abs(row[j]) <= threshold))
+				{
+					matrix.columns.push_back(static_cast<std::uint32_t>(j));
+					matrix.values.push_back(row[j]);
+				}
+			}
+			matrix.rowStart.push_back(matrix.values.size());
+		}
+		matrix.columns.shrink_to_fit();
+		matrix.values.shrink_to_fit();
+		return matrix;
+	}
+
+	void csr_prune(CsrMatrix& matrix, double threshold)
+	{
+		std::size_t kept = 0;
+		std::size_t begin = 0;
+		for (std::size_t i = 0; i < matrix.rows; ++i)
+		{
+			const std::size_t end = matrix.rowStart[i + 1];
+			for (std::size_t k = begin; k < end; ++k)
+			{
+				if (!(std::abs(matrix.values[k]) <= threshold))
+				{
+					matrix.columns[kept] = matrix.columns[k];
+					matrix.values[kept] = matrix.values[k];
+					++kept;
+				}
+			}
+			begin = end;
+			matrix.rowStart[i + 1] = kept;
+		}
+		matrix.columns.resize(kept);
+		matrix.values.resize(kept);
+		matrix.columns.shrink_to_fit();
+		matrix.values.shrink_to_fit();
+	}
+
+	void csr_to_dense(const CsrMatrix& matrix, std::span<double> dense)
+	{
+		if (dense.size() != matrix.rows * matrix.cols) {
+			throw std::invalid_argument("Weight matrix size mismatch");
+		}
+
+		std::ranges::fill(dense, 0.0);
+		for (std::size_t i = 0; i < matrix.rows; ++i)
+		{
+			double* row = dense.data() + i * matrix.cols;
+			for (std::size_t k = matrix.rowStart[i]; k < matrix.rowStart[i + 1]; ++k) {
+				row[matrix.columns[k]] = matrix.values[k];
+			}
+		}
+	}
+
+	void spmv_into(std::span<double> out, const CsrMatrix& weights, std::span<const double> in, double scale)
+	{
+		requireShape(weights, in.size(), out.size());
+
+		std::ranges::fill(out, 0.0);
+		for (std::size_t i = 0; i < weights.rows; ++i)
+		{
+			const double x = in[i];
+			if (x == 0.0) {
+				continue;
+			}
+			for (std::size_t k = weights.rowStart[i]; k < weights.rowStart[i + 1]; ++k) {
+				out[weights.columns[k]] += scale * weights.values[k] * x;
+			}
+		}
+	}
+
+	void hebbLearningRule(CsrMatrix& weights, std::span<const double> input,
+		std::span<const double> output, double learningRate)
+	{
+		if (input.empty() || output.empty()) {
+			throw std::invalid_argument("Input and output vectors cannot be empty");
+		}
+		requireShape(weights, input.size(), output.size());
+
+		for (std::size_t i = 0; i < weights.rows; ++i)
+		{
+			const double scaledInput = learningRate * input[i];
+			for (std::size_t k = weights.rowStart[i]; k < weights.rowStart[i + 1]; ++k) {
+				weights.values[k] += scaledInput * output[weights.columns[k]];
+			}
+		}
+	}
+
+	void ojaLearningRule(CsrMatrix& weights, std::span<const double> input,
+		std::span<const double> output, double learningRate)
+	{
+		requireShape(weights, input.size(), output.size());
+
+		for (std::size_t i = 0; i < weights.rows; ++i)
+		{
+			for (std::size_t k = weights.rowStart[i]; k < weights.rowStart[i + 1]; ++k)
+			{
+				const std::size_t j = weights.columns[k];
+				double& w = weights.values[k];
+				w += learningRate * (input[i] * output[j] - output[j] * input[i] * w);
+			}
+		}
+	}
+
+	void deltaLearningRuleWidrowHoff(CsrMatrix& weights, std::span<const double> pre,
+		std::span<const double> target, std::span<const double> actual,
+		double learningRate, double decayRate)
+	{
+		if (pre.empty() || target.empty()) {
+			throw std::invalid_argument("Pre-synaptic and target vectors cannot be empty");
+		}
+		if (target.size() != actual.size()) {
+			throw std::invalid_argument("target/actual size mismatch");
+		}
+		requireShape(weights, pre.size(), target.size());
+
+		std::vector<double> err(target.size());
+		for (std::size_t j = 0; j < target.size(); ++j) {
+			err[j] = target[j] - actual[j];
+		}
+
+		for (std::size_t i = 0; i < weights.rows; ++i)
+		{
+			const double scaledPre = learningRate * pre[i];
+			if (scaledPre == 0.0) {
+				continue;
+			}
+			for (std::size_t k = weights.rowStart[i]; k < weights.rowStart[i + 1]; ++k)
+			{
+				double& w = weights.values[k];
+				w += scaledPre * (err[weights.columns[k]] - decayRate * w);
+			}
+		}
+	}
+}
@@ -0,0 +1,222 @@
+#include "tools/thread_pool.h"
+#include "tools/trace.h"
+
+#include <string>
+
+namespace dnf_composer::tools::threading
+{
+	namespace
+	{
+		// Which pool (if any) the current thread belongs to, and its slot in it.
+		// A thread that is not one of the pool's workers is treated as slot 0
+		// (the driving thread) while it is inside runUntil().
+		thread_local ThreadPool* currentPool = nullptr;
+		thread_local std::size_t currentSlot = 0;
+		thread_local bool currentIsDriver = false;
+
+		// How many empty polls an idle worker makes before it parks on the
+		// condition variable. A simulation step submits a fresh wave of tasks
+		// every few microseconds to milliseconds; spinning briefly keeps the
+		// common "next step starts right away" case from paying a futex wake
+		// per worker per step, while still letting an idle pool (simulation
+		// paused, GUI in the foreground) drop to zero CPU.
+		constexpr int kSpinBeforeSleep = 2048;
+	}
+
+	ThreadPool::ThreadPool(int threadCount)
+	{
+		const std::size_t n = threadCount < 1 ? 1 : static_cast<std::size_t>(threadCount);
+		slots.reserve(n);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			slots.emplace_back(std::make_unique<Slot>());
+		}
+		workers.reserve(n - 1);
+		for (std::size_t i = 1; i < n; ++i)
+		{
+			workers.emplace_back([this, i] { workerLoop(i); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping.store(true);
+		}
+		wake.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::submit(const Task& task)
+	{
+		const std::size_t self = currentPool == this ? currentSlot : 0;
+		{
+			std::lock_guard<std::mutex> lock(slots[self]->mutex);
+			slots[self]->tasks.push_back(task);
+		}
+		queued.fetch_add(1);
+
+		// `queued` is incremented before `sleepers` is read (both seq_cst), and a
+		// worker increments `sleepers` before re-checking `queued` under
+		// sleepMutex, so either we see the sleeper here or it sees the task.
+		if (sleepers.load() > 0)
+		{
+			{ std::lock_guard<std::mutex> lock(sleepMutex); }
+			wake.notify_one();
+		}
+	}
+
+	void ThreadPool::submitPinned(const Task& task)
+	{
+		std::lock_guard<std::mutex> lock(pinned.mutex);
+		pinned.tasks.push_back(task);
+	}
+
+	bool ThreadPool::tryRunOne(std::size_t self)
+	{
+		Task task;
+		bool found = false;
+		{
+			Slot& own = *slots[self];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (!own.tasks.empty())
+			{
+				task = own.tasks.back();
+				own.tasks.pop_back();
+				found = true;
+			}
+		}
+		for (std::size_t k = 1; !found && k < slots.size(); ++k)
+		{
+			Slot& victim = *slots[(self + k) % slots.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty())
+			{
+				task = victim.tasks.front();
+				victim.tasks.pop_front();
+				found = true;
+			}
+		}
+		if (!found)
+		{
+			return false;
+		}
+		queued.fetch_sub(1);
+		// Counted before running: a task's last act is usually releasing its
+		// waiter, and the count should be settled by the time runUntil() returns.
+		executed.fetch_add(1, std::memory_order_relaxed);
+		task.run(task.context, task.index);
+		return true;
+	}
+
+	bool ThreadPool::tryRunPinned()
+	{
+		Task task;
+		{
+			std::lock_guard<std::mutex> lock(pinned.mutex);
+			if (pinned.tasks.empty())
+			{
+				return false;
+			}
+			task = pinned.tasks.front();
+			pinned.tasks.pop_front();
+		}
+		// Counted before running: a task's last act is usually releasing its
+		// waiter, and the count should be settled by the time runUntil() returns.
+		executed.fetch_add(1, std::memory_order_relaxed);
+		task.run(task.context, task.index);
+		return true;
+	}
+
+	void ThreadPool::runUntil(const std::atomic<std::size_t>& pending)
+	{
+		ThreadPool* const previousPool = currentPool;
+		const std::size_t previousSlot = currentSlot;
+		const bool previousIsDriver = currentIsDriver;
+		if (currentPool != this)
+		{
+			currentPool = this;
+			currentSlot = 0;
+			currentIsDriver = true;
+		}
+		const std::size_t self = currentSlot;
+		const bool driver = currentIsDriver;
+
+		// The driving thread never parks: it owns the step and returns as soon
+		// as the last task finishes, so a yield is the cheapest wait here.
+		while (pending.load(std::memory_order_acquire) != 0)
+		{
+			if (driver && tryRunPinned())
+			{
+				continue;
+			}
+			if (!tryRunOne(self))
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		currentPool = previousPool;
+		currentSlot = previousSlot;
+		currentIsDriver = previousIsDriver;
+	}
+
+	ThreadPool* ThreadPool::current()
+	{
+		return currentPool;
+	}
+
+	ScopedCurrentPool::ScopedCurrentPool(ThreadPool* pool)
+		: previousPool(currentPool), previousSlot(currentSlot), previousIsDriver(currentIsDriver)
+	{
+		if (pool != currentPool)
+		{
+			currentPool = pool;
+			currentSlot = 0;
+			currentIsDriver = true;
+		}
+	}
+
+	ScopedCurrentPool::~ScopedCurrentPool()
+	{
+		currentPool = previousPool;
+		currentSlot = previousSlot;
+		currentIsDriver = previousIsDriver;
+	}
+
+	void ThreadPool::workerLoop(std::size_t self)
+	{
+		currentPool = this;
+		currentSlot = self;
+		currentIsDriver = false;
+		trace::setThreadName("pool worker " + std::to_string(self));
+
+		while (!stopping.load())
+		{
+			if (tryRunOne(self))
+			{
+				continue;
+			}
+
+			int spins = 0;
+			while (queued.load() == 0 && !stopping.load() && spins < kSpinBeforeSleep)
+			{
+				std::this_thread::yield();
+				++spins;
+			}
+			if (queued.load() != 0)
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepers.fetch_add(1);
+			wake.wait(lock, [this] { return stopping.load() || queued.load() != 0; });
+			sleepers.fetch_sub(1);
+		}
+	}
+}
@@ -0,0 +1,270 @@
+#include "tools/trace.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include "tools/logger.h"
+
+namespace dnf_composer::tools::trace
+{
+	namespace
+	{
+		struct Event
+		{
+			std::string name;
+			const char* category;
+			std::int64_t begin;    // steady_clock nanoseconds
+			std::int64_t duration; // nanoseconds
+		};
+
+		// One per thread that ever recorded an event. Its mutex is only contended
+		// while stop() or start() drains or clears it.
+		struct ThreadBuffer
+		{
+			std::mutex mutex;
+			std::vector<Event> events;
+			std::uint64_t dropped = 0;
+			std::uint32_t tid = 0;
+			std::string name;
+		};
+
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadBuffer>> buffers; // kept after their thread exits
+			std::uint32_t nextTid = 1;
+			std::string path;                                   // of the running session
+			std::int64_t epoch = 0;                             // session start, steady_clock ns
+			std::atomic<std::size_t> capacity{ kDefaultEventsPerThread };
+		};
+
+		Registry& registry()
+		{
+			static Registry instance;
+			return instance;
+		}
+
+		thread_local std::shared_ptr<ThreadBuffer> localBuffer;
+		thread_local std::string localName;
+
+		std::int64_t nanoseconds(std::chrono::steady_clock::time_point time)
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+		}
+
+		ThreadBuffer& buffer()
+		{
+			if (!localBuffer)
+			{
+				auto created = std::make_shared<ThreadBuffer>();
+				Registry& reg = registry();
+				const std::lock_guard lock(reg.mutex);
+				created->tid = reg.nextTid++;
+				created->name = localName.empty() ? std::format("thread {}", created->tid) : localName;
+				reg.buffers.push_back(created);
+				localBuffer = std::move(created);
+			}
+			return *localBuffer;
+		}
+
+		void writeEscaped(std::ostream& out, std::string_view text)
+		{
+			out << '"';
+			for (const char c : text)
+			{
+				switch (c)
+				{
+				case '"': out << "\\\""; break;
+				case '\\': out << "\\\\"; break;
+				case '\n': out << "\\n"; break;
+				case '\t': out << "\\t"; break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+					} else {
+						out << c;
+					}
+				}
+			}
+			out << '"';
+		}
+
+		// Trace-event times are microseconds; three decimals keep the nanoseconds.
+		void writeMicroseconds(std::ostream& out, std::int64_t ns)
+		{
+			out << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+		}
+
+		// Caller holds the registry mutex and has cleared `active`.
+		std::string finishSession(Registry& reg)
+		{
+			std::string path = std::move(reg.path);
+			reg.path.clear();
+
+			const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+			std::error_code ec;
+			if (!parent.empty()) {
+				std::filesystem::create_directories(parent, ec);
+			}
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				logger::log(logger::LogLevel::ERROR, std::format("Could not open trace file '{}'.", path));
+				return {};
+			}
+
+			std::uint64_t written = 0;
+			std::uint64_t dropped = 0;
+			out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+			out << R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"dnf_composer"}})";
+			for (const auto& buf : reg.buffers)
+			{
+				const std::lock_guard lock(buf->mutex);
+				if (buf->events.empty() && buf->dropped == 0) {
+					continue;
+				}
+				out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buf->tid << ",\"args\":{\"name\":";
+				writeEscaped(out, buf->name);
+				out << "}}";
+				for (const Event& event : buf->events)
+				{
+					// Recorded by a span that began before this session started.
+					if (event.begin < reg.epoch) {
+						continue;
+					}
+					out << ",\n{\"name\":";
+					writeEscaped(out, event.name);
+					out << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":";
+					writeMicroseconds(out, event.begin - reg.epoch);
+					out << ",\"dur\":";
+					writeMicroseconds(out, event.duration);
+					out << ",\"pid\":1,\"tid\":" << buf->tid << '}';
+					++written;
+				}
+				dropped += buf->dropped;
+				buf->events.clear();
+				buf->events.shrink_to_fit();
+				buf->dropped = 0;
+			}
+			out << "\n]}\n";
+			out.close();
+			if (!out)
+			{
+				logger::log(logger::LogLevel::ERROR, std::format("Could not write trace file '{}'.", path));
+				return {};
+			}
+
+			if (dropped > 0)
+			{
+				logger::log(logger::LogLevel::WARNING, std::format(
+					"Trace buffers were full: {} events were dropped. Start the trace with a larger per-thread capacity.", dropped));
+			}
+			logger::log(logger::LogLevel::INFO, std::format("Wrote {} trace events to '{}'.", written, path));
+			return path;
+		}
+
+		void stopAtExit()
+		{
+			stop();
+		}
+	}
+
+	void start(const std::string& path, std::size_t eventsPerThread)
+	{
+		Registry& reg = registry();
+		const std::lock_guard lock(reg.mutex);
+		if (detail::active.exchange(false))
+		{
+			finishSession(reg);
+		}
+		for (const auto& buf : reg.buffers)
+		{
+			const std::lock_guard bufferLock(buf->mutex);
+			buf->events.clear();
+			buf->dropped = 0;
+		}
+		reg.path = path;
+		reg.capacity.store(eventsPerThread, std::memory_order_relaxed);
+		reg.epoch = nanoseconds(std::chrono::steady_clock::now());
+		detail::active.store(true);
+		logger::log(logger::LogLevel::INFO, std::format("Tracing to '{}'.", path));
+	}
+
+	std::string stop()
+	{
+		Registry& reg = registry();
+		const std::lock_guard lock(reg.mutex);
+		if (!detail::active.exchange(false))
+		{
+			return {};
+		}
+		return finishSession(reg);
+	}
+
+	std::string outputPath()
+	{
+		Registry& reg = registry();
+		const std::lock_guard lock(reg.mutex);
+		return reg.path;
+	}
+
+	bool startFromEnvironment()
+	{
+		static std::once_flag once;
+		bool started = false;
+		std::call_once(once, [&]
+			{
+				const char* path = std::getenv(kEnvironmentVariable); // NOLINT(concurrency-mt-unsafe) - read once
+				if (path == nullptr || *path == '\0') {
+					return;
+				}
+				// The registry is constructed first, so it is still alive when the
+				// exit handler writes the session.
+				registry();
+				std::atexit(&stopAtExit);
+				start(path);
+				started = true;
+			});
+		return started;
+	}
+
+	void setThreadName(std::string name)
+	{
+		if (localBuffer)
+		{
+			const std::lock_guard lock(localBuffer->mutex);
+			localBuffer->name = name;
+		}
+		localName = std::move(name);
+	}
+
+	void record(std::string_view name, const char* category,
+		std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+	{
+		if (!isActive()) {
+			return;
+		}
+		try
+		{
+			ThreadBuffer& buf = buffer();
+			const std::lock_guard lock(buf.mutex);
+			if (buf.events.size() >= registry().capacity.load(std::memory_order_relaxed))
+			{
+				++buf.dropped;
+				return;
+			}
+			buf.events.push_back(Event{ std::string(name), category, nanoseconds(begin), nanoseconds(end) - nanoseconds(begin) });
+		}
+		catch (...) // NOLINT(bugprone-empty-catch) - called from span destructors; a lost event is not worth an exception
+		{
+		}
+	}
+}
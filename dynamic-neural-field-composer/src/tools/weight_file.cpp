@@ -0,0 +1,312 @@
+#include "tools/weight_file.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little,
+	"weight files store the payload in little-endian byte order");
+
+namespace dnf_composer::tools::weight_file
+{
+	namespace
+	{
+		constexpr char kMagic[4] = { 'D', 'N', 'F', 'W' };
+
+		std::size_t padTo8(std::size_t bytes)
+		{
+			return (bytes + 7) & ~static_cast<std::size_t>(7);
+		}
+
+		// Byte size of a CSR payload with these dimensions.
+		std::size_t csrPayloadSize(std::size_t rows, std::size_t entries)
+		{
+			return (rows + 1) * sizeof(std::uint64_t)
+				+ padTo8(entries * sizeof(std::uint32_t))
+				+ entries * sizeof(double);
+		}
+
+		// The three CSR arrays of a mapped payload.
+		struct CsrView
+		{
+			const std::uint64_t* rowStart;
+			const std::uint32_t* columns;
+			const double* values;
+		};
+
+		CsrView csrView(const WeightFileHeader& header, const std::byte* payload)
+		{
+			const auto* rowStart = reinterpret_cast<const std::uint64_t*>(payload);
+			const auto* columns = reinterpret_cast<const std::uint32_t*>(payload + (header.rows + 1) * sizeof(std::uint64_t));
+			const auto* values = reinterpret_cast<const double*>(
+				reinterpret_cast<const std::byte*>(columns) + padTo8(header.entries * sizeof(std::uint32_t)));
+			return { rowStart, columns, values };
+		}
+
+		void checkCsrRow(const CsrView& csr, const WeightFileHeader& header, std::size_t i)
+		{
+			if (csr.rowStart[i] > csr.rowStart[i + 1] || csr.rowStart[i + 1] > header.entries) {
+				throw std::runtime_error("Weight file has inconsistent row offsets");
+			}
+			for (std::size_t k = csr.rowStart[i]; k < csr.rowStart[i + 1]; ++k) {
+				if (csr.columns[k] >= header.cols) {
+					throw std::runtime_error("Weight file has a column index out of range");
+				}
+			}
+		}
+
+		WeightFileHeader makeHeader(WeightLayout layout, std::size_t rows, std::size_t cols,
+			std::size_t entries, std::size_t payloadSize)
+		{
+			WeightFileHeader header{};
+			std::memcpy(header.magic, kMagic, sizeof(kMagic));
+			header.version = kVersion;
+			header.dtype = WeightDtype::Float64;
+			header.layout = layout;
+			header.headerSize = kHeaderSize;
+			header.rows = rows;
+			header.cols = cols;
+			header.entries = entries;
+			header.payloadSize = payloadSize;
+			return header;
+		}
+
+		// Streams the header and the payload chunks to a temporary file, then
+		// renames it over `path`.
+		void writeFile(const std::string& path, const WeightFileHeader& header,
+			std::initializer_list<std::span<const std::byte>> chunks)
+		{
+			const std::filesystem::path target(path);
+			const std::filesystem::path temporary = target.string() + ".tmp";
+			{
+				std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+				if (!file.is_open()) {
+					throw std::runtime_error(std::format("Cannot open '{}' for writing", temporary.string()));
+				}
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				for (const auto& chunk : chunks) {
+					file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+				}
+				file.flush();
+				if (!file) {
+					std::error_code ignored;
+					file.close();
+					std::filesystem::remove(temporary, ignored);
+					throw std::runtime_error(std::format("Failed writing '{}'", temporary.string()));
+				}
+			}
+			std::error_code error;
+			std::filesystem::rename(temporary, target, error);
+			if (error)
+			{
+				std::error_code ignored;
+				std::filesystem::remove(temporary, ignored);
+				throw std::runtime_error(std::format("Cannot replace '{}': {}", path, error.message()));
+			}
+		}
+
+		std::uint64_t fnvStep(std::uint64_t hash, std::uint64_t value)
+		{
+			constexpr std::uint64_t prime = 0x100000001b3ULL;
+			return (hash ^ value) * prime;
+		}
+
+		constexpr std::uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+
+		// Checksum of several chunks as if they were one contiguous payload.
+		// Every chunk but the last is a multiple of 8 bytes.
+		std::uint64_t chunksChecksum(std::initializer_list<std::span<const std::byte>> chunks)
+		{
+			std::uint64_t hash = kFnvOffset;
+			for (const auto& chunk : chunks)
+			{
+				const std::size_t words = chunk.size() / sizeof(std::uint64_t);
+				for (std::size_t w = 0; w < words; ++w)
+				{
+					std::uint64_t value;
+					std::memcpy(&value, chunk.data() + w * sizeof(value), sizeof(value));
+					hash = fnvStep(hash, value);
+				}
+				for (std::size_t b = words * sizeof(std::uint64_t); b < chunk.size(); ++b) {
+					hash = fnvStep(hash, static_cast<std::uint64_t>(chunk[b]));
+				}
+			}
+			return hash;
+		}
+	}
+
+	const char* toString(WeightLayout layout)
+	{
+		switch (layout)
+		{
+		case WeightLayout::Dense: return "dense";
+		case WeightLayout::Csr: return "csr";
+		}
+		return "unknown";
+	}
+
+	std::uint64_t payloadChecksum(std::span<const std::byte> payload)
+	{
+		return chunksChecksum({ payload });
+	}
+
+	void writeDense(const std::string& path, std::span<const double> weights, std::size_t rows, std::size_t cols)
+	{
+		if (weights.size() != rows * cols) {
+			throw std::invalid_argument("Weight matrix size mismatch");
+		}
+		const auto bytes = std::as_bytes(weights);
+		WeightFileHeader header = makeHeader(WeightLayout::Dense, rows, cols, weights.size(), bytes.size());
+		header.checksum = chunksChecksum({ bytes });
+		writeFile(path, header, { bytes });
+	}
+
+	void writeCsr(const std::string& path, const math::CsrMatrix& weights)
+	{
+		if (weights.rowStart.size() != weights.rows + 1 || weights.columns.size() != weights.values.size()) {
+			throw std::invalid_argument("Malformed CSR matrix");
+		}
+		static_assert(sizeof(std::size_t) == sizeof(std::uint64_t));
+		const auto rowStart = std::as_bytes(std::span(weights.rowStart));
+		const auto columns = std::as_bytes(std::span(weights.columns));
+		const auto values = std::as_bytes(std::span(weights.values));
+
+		const std::size_t entries = weights.values.size();
+		WeightFileHeader header = makeHeader(WeightLayout::Csr, weights.rows, weights.cols,
+			entries, csrPayloadSize(weights.rows, entries));
+		// Padded to whole words, so the chunks checksum like the contiguous payload.
+		std::vector<std::byte> paddedColumns(padTo8(columns.size()));
+		std::ranges::copy(columns, paddedColumns.begin());
+		header.checksum = chunksChecksum({ rowStart, paddedColumns, values });
+		writeFile(path, header, { rowStart, paddedColumns, values });
+	}
+
+	MappedWeightFile::MappedWeightFile(const std::string& path, MappedFile::Access access)
+		: file_(path, access)
+	{
+		if (file_.size() < kHeaderSize) {
+			throw std::runtime_error(std::format("'{}' is too small to be a weight file", path));
+		}
+
+		const auto invalid = [&](const std::string& reason)
+		{
+			file_.reset();
+			return std::runtime_error(std::format("'{}' is not a valid weight file: {}", path, reason));
+		};
+		const WeightFileHeader& h = header();
+		if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+			throw invalid("bad magic");
+		}
+		if (h.version > kVersion) {
+			throw invalid(std::format("version {} is newer than this build reads ({})", h.version, kVersion));
+		}
+		if (h.headerSize != kHeaderSize || h.dtype != WeightDtype::Float64) {
+			throw invalid("unsupported header size or dtype");
+		}
+		if (h.payloadSize != file_.size() - kHeaderSize) {
+			throw invalid(std::format("payload is {} bytes, header says {}", file_.size() - kHeaderSize, h.payloadSize));
+		}
+		switch (h.layout)
+		{
+		case WeightLayout::Dense:
+			if (h.entries != h.rows * h.cols || h.payloadSize != h.entries * sizeof(double)) {
+				throw invalid("dense payload size does not match its dimensions");
+			}
+			break;
+		case WeightLayout::Csr:
+			if (h.entries > h.rows * h.cols || h.payloadSize != csrPayloadSize(h.rows, h.entries)) {
+				throw invalid("CSR payload size does not match its dimensions");
+			}
+			break;
+		default:
+			throw invalid("unknown layout");
+		}
+	}
+
+	bool MappedWeightFile::verifyChecksum() const
+	{
+		return payloadChecksum(payload()) == header().checksum;
+	}
+
+	std::span<const double> MappedWeightFile::dense() const
+	{
+		if (layout() != WeightLayout::Dense) {
+			throw std::logic_error("Weight file is not in the dense layout");
+		}
+		return { reinterpret_cast<const double*>(payload().data()), header().entries };
+	}
+
+	std::span<double> MappedWeightFile::mutableDense() const
+	{
+		if (file_.mutableData() == nullptr) {
+			throw std::logic_error("Weight file is not mapped copy-on-write");
+		}
+		const std::span<const double> values = dense();
+		return { const_cast<double*>(values.data()), values.size() };
+	}
+
+	void MappedWeightFile::copyDenseInto(std::span<double> out) const
+	{
+		const WeightFileHeader& h = header();
+		if (out.size() != h.rows * h.cols) {
+			throw std::invalid_argument("Weight matrix size mismatch");
+		}
+		if (h.layout == WeightLayout::Dense)
+		{
+			std::ranges::copy(dense(), out.begin());
+			return;
+		}
+
+		const CsrView csr = csrView(h, payload().data());
+		std::ranges::fill(out, 0.0);
+		for (std::size_t i = 0; i < h.rows; ++i)
+		{
+			checkCsrRow(csr, h, i);
+			double* row = out.data() + i * h.cols;
+			for (std::size_t k = csr.rowStart[i]; k < csr.rowStart[i + 1]; ++k) {
+				row[csr.columns[k]] = csr.values[k];
+			}
+		}
+	}
+
+	math::CsrMatrix MappedWeightFile::toCsr(double threshold) const
+	{
+		const WeightFileHeader& h = header();
+		if (h.layout == WeightLayout::Dense) {
+			return math::csr_from_dense(dense(), h.rows, h.cols, threshold);
+		}
+
+		const CsrView csr = csrView(h, payload().data());
+		if (csr.rowStart[0] != 0) {
+			throw std::runtime_error("Weight file has inconsistent row offsets");
+		}
+		math::CsrMatrix matrix;
+		matrix.rows = h.rows;
+		matrix.cols = h.cols;
+		matrix.rowStart.reserve(h.rows + 1);
+		matrix.rowStart.push_back(0);
+		for (std::size_t i = 0; i < h.rows; ++i)
+		{
+			checkCsrRow(csr, h, i);
+			for (std::size_t k = csr.rowStart[i]; k < csr.rowStart[i + 1]; ++k)
+			{
+				if (!(std::abs(csr.values[k]) <= threshold))
+				{
+					matrix.columns.push_back(csr.columns[k]);
+					matrix.values.push_back(csr.values[k]);
+				}
+			}
+			matrix.rowStart.push_back(matrix.values.size());
+		}
+		matrix.columns.shrink_to_fit();
+		matrix.values.shrink_to_fit();
+		return matrix;
+	}
+}
@@ -1388,6 +1388,53 @@ namespace dnf_composer::user_interface
 			ewRowDrag("Scalar",        ("##fc_sc"    + uid).c_str(), &scalar,       0.1F, -20.0F, 20.0F);
 			ewRowBool("Activate learning", ("##fc_al" + uid).c_str(), &activateLearning);
 
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0); ImGui::AlignTextToFramePadding(); ImGui::TextUnformatted("Weights");
+			ImGui::TableSetColumnIndex(1); ImGui::SetNextItemWidth(-FLT_MIN);
+			if (ImGui::BeginCombo(("##fc_ws" + uid).c_str(), WeightStorageToString.at(fcp.weightStorage).c_str()))
+			{
+				for (const auto& [storage, name] : WeightStorageToString)
+				{
+					if (ImGui::Selectable(name.c_str(), fcp.weightStorage == storage))
+					{
+						fcp.weightStorage = storage;
+						fieldCoupling->setParameters(fcp);
+					}
+				}
+				ImGui::EndCombo();
+			}
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0); ImGui::AlignTextToFramePadding(); ImGui::TextUnformatted("Weight file");
+			ImGui::TableSetColumnIndex(1); ImGui::SetNextItemWidth(-FLT_MIN);
+			if (ImGui::BeginCombo(("##fc_wf" + uid).c_str(),
+				WeightFileFormatToString.at(fieldCoupling->getWeightFileFormat()).c_str()))
+			{
+				for (const auto& [format, name] : WeightFileFormatToString)
+				{
+					if (ImGui::Selectable(name.c_str(), fieldCoupling->getWeightFileFormat() == format)) {
+						fieldCoupling->setWeightFileFormat(format);
+					}
+				}
+				ImGui::EndCombo();
+			}
+			if (fcp.weightStorage == WeightStorage::SPARSE)
+			{
+				// Pruning is not undoable, so a new threshold is applied once the drag
+				// is released rather than on every intermediate value.
+				auto pruneThreshold = static_cast<float>(fcp.pruneThreshold);
+				ewRowDrag("Prune threshold", ("##fc_pt" + uid).c_str(), &pruneThreshold,
+					1e-4F, 0.0F, 10.0F, "%.3g", ImGuiSliderFlags_Logarithmic);
+				if (ImGui::IsItemDeactivatedAfterEdit())
+					{ fcp.pruneThreshold = pruneThreshold; fieldCoupling->setParameters(fcp); }
+
+				const auto& sparse = fieldCoupling->getSparseWeights();
+				ImGui::TableNextRow();
+				ImGui::TableSetColumnIndex(0); ImGui::AlignTextToFramePadding(); ImGui::TextUnformatted("Stored");
+				ImGui::TableSetColumnIndex(1);
+				ImGui::Text("%zu / %zu (%.1f KiB)", sparse.nonZeros(), sparse.rows * sparse.cols,
+					static_cast<double>(fieldCoupling->getWeightsBytes()) / 1024.0);
+			}
+
 			ewEndTable();
 		}
 
@@ -1579,6 +1626,23 @@ namespace dnf_composer::user_interface
 			ewTableSetup();
 			ewRowBool("Circular",   ("##gfc_c" + uid).c_str(), &circular);
 			ewRowBool("Normalized", ("##gfc_n" + uid).c_str(), &normalized);
+
+			ImGui::TableNextRow();
+			ImGui::TableSetColumnIndex(0); ImGui::AlignTextToFramePadding(); ImGui::TextUnformatted("Evaluation");
+			ImGui::TableSetColumnIndex(1); ImGui::SetNextItemWidth(-FLT_MIN);
+			if (ImGui::BeginCombo(("##gfc_ev" + uid).c_str(),
+				element::GaussCouplingEvaluationToString.at(gfcp.evaluation).c_str()))
+			{
+				for (const auto& [evaluation, name] : element::GaussCouplingEvaluationToString)
+				{
+					if (ImGui::Selectable(name.c_str(), gfcp.evaluation == evaluation))
+					{
+						gfcp.evaluation = evaluation;
+						gfc->setParameters(gfcp);
+					}
+				}
+				ImGui::EndCombo();
+			}
 			ewEndTable();
 		}
 		if (normalized != gfcp.normalized || circular != gfcp.circular)
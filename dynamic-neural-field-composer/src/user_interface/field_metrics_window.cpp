@@ -2,7 +2,9 @@
 
 #include <array>
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <string>
 
 #include "elements/neural_field.h"
 #include "elements/neural_field_2d.h"
@@ -18,6 +20,91 @@ namespace dnf_composer::user_interface
 	static constexpr float  kBarH       = 6.0F;
 	static constexpr float  kDotR       = 5.0F;
 
+	namespace
+	{
+		// The file the last trace started from this window was written to.
+		std::string lastTracePath;
+
+		double toMicroseconds(const std::chrono::nanoseconds ns)
+		{
+			return static_cast<double>(ns.count()) * 1e-3;
+		}
+
+		// One row per timing: name | p50 | p99 | max, in microseconds.
+		void renderTimingTable(const char* id, const char* firstColumn, const std::vector<StepTiming>& timings)
+		{
+			if (!ImGui::BeginTable(id, 4, ImGuiTableFlags_SizingStretchProp | ImGuiTableFlags_RowBg))
+			{
+				return;
+			}
+			ImGui::TableSetupColumn(firstColumn, ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("p50 us", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("p99 us", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableSetupColumn("max us", ImGuiTableColumnFlags_WidthFixed);
+			ImGui::TableHeadersRow();
+			for (const StepTiming& timing : timings)
+			{
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(timing.name.c_str());
+				ImGui::PushFont(g_MonoMediumFont);
+				for (const auto value : { timing.p50, timing.p99, timing.max })
+				{
+					ImGui::TableNextColumn();
+					ImGui::Text("%.1f", toMicroseconds(value));
+				}
+				ImGui::PopFont();
+			}
+			ImGui::EndTable();
+		}
+
+		void renderStepTiming(const std::shared_ptr<Simulation>& simulation)
+		{
+			ImGui::Separator();
+			ImGui::PushFont(g_BoldMediumFont);
+			ImGui::TextUnformatted("Step timing");
+			ImGui::PopFont();
+
+			bool profiling = simulation->isProfiling();
+			if (ImGui::Checkbox("Time element steps", &profiling))
+			{
+				simulation->setProfiling(profiling);
+			}
+			ImGui::SameLine();
+			if (ImGui::SmallButton("Reset"))
+			{
+				simulation->resetProfile();
+			}
+			ImGui::SameLine();
+			bool tracing = simulation->isTracing();
+			if (ImGui::Checkbox("Record trace", &tracing))
+			{
+				if (tracing)
+				{
+					simulation->startTrace();
+				}
+				else
+				{
+					lastTracePath = simulation->stopTrace();
+				}
+			}
+			if (!lastTracePath.empty())
+			{
+				ImGui::TextDisabled("Trace written to %s", lastTracePath.c_str());
+			}
+
+			const StepProfile profile = simulation->getProfile();
+			if (profile.elements.empty())
+			{
+				ImGui::TextDisabled("Enable to time each element's step.");
+				return;
+			}
+			renderTimingTable("##step_timing_elements", "Element", profile.elements);
+			ImGui::Spacing();
+			renderTimingTable("##step_timing_types", "Type", profile.types);
+		}
+	}
+
 	FieldMetricsWindow::FieldMetricsWindow(const std::shared_ptr<Simulation>& simulation)
 		: simulation(simulation)
 	{}
@@ -265,5 +352,7 @@ namespace dnf_composer::user_interface
 		if (!anyNF) {
 			ImGui::TextDisabled("No neural fields in simulation.");
 }
+
+		renderStepTiming(simulation);
 	}
 }
@@ -2045,8 +2045,18 @@ namespace dnf_composer::user_interface
 		static std::string selectedComponent;
 		static int  recordInterval = 10;
 		static int  unitIdx        = 1; // 0 = ms, 1 = ticks
+		static int  formatIdx      = 0; // 0 = CSV, 1 = binary, 2 = binary lossless, 3 = binary lossy
+		static double tolerance    = 1e-6;
+		static int  triggerIdx     = 0; // RecordingTrigger
+		static int  preSamples     = 10;
+		static int  postSamples    = 50;
+		static double threshold    = 0.0;
 
 		static constexpr std::array<const char*, 2> kUnits = { "ms", "ticks" };
+		static constexpr std::array<const char*, 4> kFormats = {
+			"CSV", "Binary (.dnfr)", "Binary, lossless", "Binary, lossy" };
+		static constexpr std::array<const char*, 4> kTriggers = {
+			"Every sample", "Stability change", "Bump count change", "Threshold crossing" };
 
 		const bool hasSelection = !selectedElementId.empty() && !selectedComponent.empty();
 		const bool currentlyRecording = hasSelection &&
@@ -2124,6 +2134,49 @@ namespace dnf_composer::user_interface
 		ImGui::SameLine();
 		ImGui::SetNextItemWidth(-FLT_MIN);
 		ImGui::Combo("##rec_unit", &unitIdx, kUnits.data(), static_cast<int>(kUnits.size()));
+		ImGui::TextUnformatted("Format");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(-FLT_MIN);
+		ImGui::Combo("##rec_format", &formatIdx, kFormats.data(), static_cast<int>(kFormats.size()));
+		if (formatIdx == 3)
+		{
+			ImGui::TextUnformatted("Tolerance");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(-FLT_MIN);
+			ImGui::PushFont(g_MonoMediumFont);
+			ImGui::InputDouble("##rec_tolerance", &tolerance, 0.0, 0.0, "%.2e");
+			ImGui::PopFont();
+			if (tolerance <= 0.0)
+				tolerance = 1e-6;
+		}
+		// Triggers watch the recorded element, which must be a neural field.
+		ImGui::TextUnformatted("Write");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(-FLT_MIN);
+		ImGui::Combo("##rec_trigger", &triggerIdx, kTriggers.data(), static_cast<int>(kTriggers.size()));
+		if (triggerIdx != 0)
+		{
+			ImGui::PushFont(g_MonoMediumFont);
+			ImGui::TextUnformatted("Before");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x * 0.3F);
+			ImGui::InputInt("##rec_pre", &preSamples, 0, 0);
+			ImGui::SameLine();
+			ImGui::TextUnformatted("After");
+			ImGui::SameLine();
+			ImGui::SetNextItemWidth(-FLT_MIN);
+			ImGui::InputInt("##rec_post", &postSamples, 0, 0);
+			if (triggerIdx == 3)
+			{
+				ImGui::TextUnformatted("Threshold");
+				ImGui::SameLine();
+				ImGui::SetNextItemWidth(-FLT_MIN);
+				ImGui::InputDouble("##rec_threshold", &threshold, 0.0, 0.0, "%.3f");
+			}
+			ImGui::PopFont();
+			preSamples = std::max(preSamples, 0);
+			postSamples = std::max(postSamples, 0);
+		}
 		ImGui::EndDisabled();
 		ImGui::Spacing();
 
@@ -2168,11 +2221,24 @@ namespace dnf_composer::user_interface
 					// be opened; it does not enter the "recording" state in that case, so
 					// currentlyRecording/canStart above will correctly reflect the failure on
 					// the next frame — no extra UI bookkeeping is needed here.
+					RecordingOptions options;
+					options.sampleInterval = recordInterval;
+					options.unit   = unitIdx == 0 ? RecordingIntervalUnit::Milliseconds : RecordingIntervalUnit::Ticks;
+					options.format = formatIdx == 0 ? RecordingFormat::Csv : RecordingFormat::Binary;
+					if (formatIdx == 2)
+						options.codec.codec = tools::recording_file::RecordingCodec::XorDelta;
+					if (formatIdx == 3)
+					{
+						options.codec.codec = tools::recording_file::RecordingCodec::Quantized;
+						options.codec.tolerance = tolerance;
+					}
+					options.trigger.on = static_cast<RecordingTrigger>(triggerIdx);
+					options.trigger.threshold = threshold;
+					options.trigger.preSamples = preSamples;
+					options.trigger.postSamples = postSamples;
 					simulation->getRecorder().startRecording(
 						simulation->getUniqueIdentifier(),
-						selectedElementId, selectedComponent,
-						recordInterval,
-						unitIdx == 0 ? RecordingIntervalUnit::Milliseconds : RecordingIntervalUnit::Ticks);
+						selectedElementId, selectedComponent, options);
 }
 			}
 
@@ -2214,6 +2280,15 @@ namespace dnf_composer::user_interface
 			}
 		}
 
+		if (simulation->getRecorder().hasActiveRecordings())
+		{
+			const RecorderStats recStats = simulation->getRecorder().getStats();
+			ImGui::Spacing();
+			ImGui::TextDisabled("Queue %zu/%zu  |  %.1f MB written  |  %llu dropped",
+				recStats.queueDepth, recStats.capacity, static_cast<double>(recStats.bytesWritten) / 1e6,
+				static_cast<unsigned long long>(recStats.framesDropped));
+		}
+
 		ImGui::Spacing();
 		ImGui::Separator();
 		ImGui::Spacing();
@@ -180,7 +180,7 @@ namespace dnf_composer
 	}
 
 	// NOLINTNEXTLINE(readability-function-cognitive-complexity) - linear ImPlot immediate-mode layout; splitting would fragment plot state across functions
-	void Heatmap::render(const std::vector<std::vector<double>*>& data, const std::vector<std::string>& legends)
+	void Heatmap::render(const std::vector<element::ComponentBuffer*>& data, const std::vector<std::string>& legends)
 	{
 		const ImVec2 availableRegionSize = ImGui::GetContentRegionAvail();
 		const ImVec2 plotSize = ImVec2(availableRegionSize.x - 65.0F, availableRegionSize.y - 5.0F);
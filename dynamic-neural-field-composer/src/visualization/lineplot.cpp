@@ -70,7 +70,7 @@ namespace dnf_composer
 	}
 
 	// NOLINTNEXTLINE(readability-function-cognitive-complexity) - linear ImPlot immediate-mode layout; splitting would fragment plot state across functions
-	void LinePlot::render(const std::vector<std::vector<double>*>& data, const std::vector<std::string>& legends)
+	void LinePlot::render(const std::vector<element::ComponentBuffer*>& data, const std::vector<std::string>& legends)
 	{
         static constexpr double safeMargin = 0.01;
 		bool whereDimensionsChangedByUser = false;
@@ -210,7 +210,7 @@ namespace dnf_composer
 		for (size_t j = 0; j < data.size(); ++j) 
 		{
 			const std::string& label = legends[j];
-            const std::vector<double>& line_data = *data[j];
+            const element::ComponentBuffer& line_data = *data[j];
 
             std::vector<double> shiftedXValues(line_data.size());
             for (size_t i = 0; i < line_data.size(); ++i) 
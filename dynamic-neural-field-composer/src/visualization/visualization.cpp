@@ -221,7 +221,7 @@ namespace dnf_composer
 
 		updateHeatmapDimensionHint(it->first, data, simulation);
 
-		std::vector<std::vector<double>*> ptrs;
+		std::vector<element::ComponentBuffer*> ptrs;
 		ptrs.reserve(data.size());
 		for (const auto& [name, comp] : data) {
 			ptrs.emplace_back(simulation->getComponentPtr(name, comp));
@@ -258,7 +258,7 @@ namespace dnf_composer
 				continue;
 			}
 
-			std::vector<std::vector<double>*> allDataToPlotPtr;
+			std::vector<element::ComponentBuffer*> allDataToPlotPtr;
 			allDataToPlotPtr.reserve(data.size());
 			for (const auto&[fst, snd] : data)
 			{
@@ -12,7 +12,11 @@
 // This mirrors examples/benchmark_headless_2d.cpp but covers both dimensions and
 // writes a Markdown report. It is a manual performance run, NOT a unit test.
 //
-// Usage: dnf_composer_benchmark [timed_steps] [n_runs]
+// Usage: dnf_composer_benchmark [--scaling] [timed_steps] [n_runs]
+//   --scaling    instead of the N sweep, time N=100 (1D and 2D) at 1/2/4/8/16
+//                threads (Simulation::setThreadCount) and report steps/s plus
+//                speedup over 1 thread. Appended to results.md as its own
+//                session block, with its own JSON sidecar.
 //   timed_steps  default 2000
 //   n_runs       default 5   (median + IQR reported; 5 is the smallest count that
 //                             gives a usable interquartile range, and the whole
@@ -27,6 +31,7 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "simulation/simulation.h"
@@ -141,8 +146,10 @@ std::shared_ptr<Simulation> build_2d(int N)
 // timedSteps. setMeasureStepDuration(false) disables Simulation::step()'s own internal
 // steady_clock::now() pair, which would otherwise add two clock calls per step on top of
 // the ones this loop already makes around the whole run.
-std::vector<double> timeCellSeconds(const std::shared_ptr<Simulation>& sim, int timedSteps, int nRuns)
+std::vector<double> timeCellSeconds(const std::shared_ptr<Simulation>& sim, int timedSteps, int nRuns,
+                                    int threads = 1)
 {
+	sim->setThreadCount(threads);
 	sim->init();
 	sim->setMeasureStepDuration(false);
 	for (int t = 0; t < WARMUP_STEPS; ++t) sim->step();
@@ -191,14 +198,109 @@ std::string filenameTimestamp()
 	return buf;
 }
 
+// --scaling: thread-count sweep over the largest cell of each table. N=100
+// independent fields is the case the element scheduler is built for (100
+// disjoint stimulus -> field <-> kernel chains), so it bounds the achievable
+// speedup; a single field would show none. Thread counts above
+// hardware_concurrency are still run (and marked) -- oversubscription cost is
+// part of what the table should show.
+int runScaling(int timedSteps, int nRuns)
+{
+	constexpr int N = 100;
+	const std::vector<int> threadCounts = {1, 2, 4, 8, 16};
+	const unsigned hw = std::thread::hardware_concurrency();
+
+	std::printf("dnf_composer benchmark --scaling  (N=%d, %d steps x %d runs, median, %u hw threads)\n",
+	            N, timedSteps, nRuns, hw);
+
+	std::vector<bench_report::Result> results1d, results2d;
+	for (int threads : threadCounts)
+	{
+		const std::string tag = "T" + std::to_string(threads);
+		auto r1 = bench_report::makeResult("scaling-1d-N100-" + tag, "threads=" + std::to_string(threads),
+		                                    "synthetic-1d", "direct-1d",
+		                                    static_cast<long long>(N) * FIELD_SIZE_1D,
+		                                    timeCellSeconds(build_1d(N), timedSteps, nRuns, threads));
+		auto r2 = bench_report::makeResult("scaling-2d-N100-" + tag, "threads=" + std::to_string(threads),
+		                                    "synthetic-2d", "direct-2d",
+		                                    static_cast<long long>(N) * GRID_2D * GRID_2D,
+		                                    timeCellSeconds(build_2d(N), timedSteps, nRuns, threads));
+		std::printf("  threads=%-3d  1D %.1f steps/s   2D %.1f steps/s\n",
+		            threads, r1.stepsPerSec.median, r2.stepsPerSec.median);
+		results1d.push_back(std::move(r1));
+		results2d.push_back(std::move(r2));
+	}
+
+	std::vector<bench_report::Result> allResults = results1d;
+	allResults.insert(allResults.end(), results2d.begin(), results2d.end());
+
+	const auto env = bench_env::capture();
+	const std::filesystem::path resultsMdPath(BENCHMARK_RESULTS_PATH);
+	const std::filesystem::path jsonDir = resultsMdPath.parent_path() / "results";
+	std::filesystem::create_directories(jsonDir);
+	const std::filesystem::path jsonPath =
+		jsonDir / (filenameTimestamp() + "_" + bench_env::fingerprint(env) + "_scaling.json");
+	bench_report::writeJson(jsonPath.string(), env, allResults,
+	                         nlohmann::json{{"warmup_steps", WARMUP_STEPS},
+	                                        {"timed_steps", timedSteps},
+	                                        {"runs", nRuns},
+	                                        {"mode", "scaling"},
+	                                        {"fields", N},
+	                                        {"hardware_concurrency", hw}});
+	std::printf("Wrote %s\n", jsonPath.string().c_str());
+
+	const std::string path = BENCHMARK_RESULTS_PATH;
+	std::ofstream f(path, std::ios::app);
+	if (!f)
+	{
+		std::fprintf(stderr, "Cannot open results file: %s\n", path.c_str());
+		return 1;
+	}
+	f << "\n## " << timestamp()
+	  << "   (dnfc " << DNF_COMPOSER_VERSION_MAJOR << "." << DNF_COMPOSER_VERSION_MINOR
+	  << "." << DNF_COMPOSER_VERSION_PATCH
+	  << ", --scaling, N=" << N << ", " << timedSteps << " steps x " << nRuns << " runs)\n\n";
+	f << bench_env::to_markdown(env) << "\n\n";
+	f << "Thread scaling (Simulation::setThreadCount), " << hw << " hardware threads"
+	  << " -- rows past that are oversubscribed (*).\n\n";
+	f << "| threads | 1D steps/s | 1D speedup | 2D steps/s | 2D speedup |\n";
+	f << "|--------:|-----------:|-----------:|-----------:|-----------:|\n";
+	f.setf(std::ios::fixed);
+	for (std::size_t i = 0; i < threadCounts.size(); ++i)
+	{
+		const bool over = hw != 0 && static_cast<unsigned>(threadCounts[i]) > hw;
+		f.precision(1);
+		f << "| " << threadCounts[i] << (over ? "*" : "") << " | " << results1d[i].stepsPerSec.median << " | ";
+		f.precision(2);
+		f << results1d[i].stepsPerSec.median / results1d[0].stepsPerSec.median << "x | ";
+		f.precision(1);
+		f << results2d[i].stepsPerSec.median << " | ";
+		f.precision(2);
+		f << results2d[i].stepsPerSec.median / results2d[0].stepsPerSec.median << "x |\n";
+	}
+	f << "\nJSON: `results/" << jsonPath.filename().string() << "`\n";
+
+	std::printf("Appended session to %s\n", path.c_str());
+	return 0;
+}
+
 } // namespace
 
 int main(int argc, char* argv[])
 {
 	tools::logger::Logger::setMinLogLevel(tools::logger::LogLevel::FATAL);
 
+	const bool scaling = argc > 1 && std::string(argv[1]) == "--scaling";
+	if (scaling)
+	{
+		--argc;
+		++argv;
+	}
+
 	const int timedSteps = (argc > 1) ? std::stoi(argv[1]) : 2000;
 	const int nRuns      = (argc > 2) ? std::stoi(argv[2]) : 5;
+	if (scaling)
+		return runScaling(timedSteps, nRuns);
 	const std::vector<int> Ns = {10, 50, 100};
 
 	std::printf("dnf_composer benchmark  (%d steps x %d runs, median)\n", timedSteps, nRuns);
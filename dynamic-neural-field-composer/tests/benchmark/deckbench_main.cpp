@@ -8,7 +8,8 @@
 // gtest_discover_tests, same as dnf_composer_benchmark and dnf_composer_profiler.
 //
 // Usage: dnf_composer_deckbench [--decks <manifest.json>] [--steps N] [--runs N]
-//                                [--json <out.json>] [--paths]
+//                                [--json <out.json>] [--paths] [--ensemble K] [--plans]
+//                                [--realtime [--rt-priority P] [--rt-cpu C]]
 //                                [--record [--force] | --check [--threshold PCT]]
 //   --decks   deck manifest, default: the one baked in at configure time
 //   --steps   timed steps per run, default 2000
@@ -20,6 +21,27 @@
 //             convolution path Auto took without instrumenting the library. Ignored (a
 //             warning is printed) together with --record/--check, which always compare
 //             the plain Auto-mode measurement so every deck has exactly one entry.
+//   --ensemble  for every deck EnsembleSimulation supports, ALSO time K instances stepped
+//             as one structure-of-arrays batch. Reported as "<tier>-ensemble<K>" in
+//             instance-steps/s, with the speedup over stepping the deck as K separate
+//             Simulations (the plain measurement of the same deck). Unsupported decks
+//             (2D, couplings, ...) are skipped with the reason. Ignored together with
+//             --record/--check, for the same reason as --paths.
+//   --plans   for every "large*" tier deck Auto sends down the spectral path, ALSO time it
+//             with FFTW plans measured (tools::math::PlanRigor::Measure) and with plans
+//             estimated (the default), each from an empty plan cache, and report the
+//             speedup. Planning itself is excluded: the measured run waits for its
+//             background planning before timing. Ignored together with --record/--check,
+//             for the same reason as --paths.
+//   --realtime  for every deck, ALSO find the shortest period RealTimeRunner sustains:
+//             kRealTimePeriods deadline-paced steps (OverrunPolicy::Skip) with at most
+//             kRealTimeMissBudget of them overrunning or skipped. The search starts just
+//             above the median step time, doubles until a period holds, then bisects to
+//             within 2%. Reported with the wake-up jitter and slack at that period, and
+//             written to the JSON's "realtime" section. --rt-priority runs the paced
+//             thread under SCHED_FIFO and --rt-cpu pins it, when the OS allows (see the
+//             note printed otherwise). Ignored together with --record/--check, for the
+//             same reason as --paths.
 //
 // --record / --check compare against a per-machine baseline at
 // tests/benchmark/baselines/<fingerprint>.json -- see the exit-code table on
@@ -28,6 +50,7 @@
 // .claude/performance-workplan/WP-07-machine-hygiene-scripts.md). This is a local,
 // pre-PR check, ideally run under scripts/bench.ps1 / scripts/bench.sh.
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <filesystem>
@@ -40,6 +63,8 @@
 
 #include "simulation/simulation.h"
 #include "simulation/simulation_file_manager.h"
+#include "simulation/ensemble_simulation.h"
+#include "simulation/real_time_runner.h"
 #include "tools/fft_convolution.h"
 #include "tools/logger.h"
 
@@ -71,6 +96,12 @@ constexpr int WARMUP_STEPS = 200;
 // tests/benchmark/DECKS.md) if that changes materially on a different reference machine.
 constexpr double kDefaultThresholdPct = 5.0;
 
+// --realtime: a period counts as sustained when no more than one in a thousand of its
+// deadlines is overrun or skipped -- one miss in the default trial, so a single stray
+// preemption does not decide the result, while a deck that misses regularly cannot pass.
+constexpr int    kRealTimePeriods    = 1000;
+constexpr double kRealTimeMissBudget = 0.001;
+
 struct DeckSpec
 {
 	std::string tier;
@@ -134,6 +165,9 @@ std::vector<double> timeDeckSeconds(const std::filesystem::path& jsonPath, int t
 {
 	auto sim = loadDeck(jsonPath);
 	sim->init();
+	// Under PlanRigor::Measure, init() starts measured FFTW planning in the background;
+	// time the plans it settles on, not the Estimate ones standing in meanwhile.
+	tools::math::waitForFftPlans();
 	sim->setMeasureStepDuration(false);
 	for (int t = 0; t < WARMUP_STEPS; ++t) sim->step();
 
@@ -151,6 +185,141 @@ std::vector<double> timeDeckSeconds(const std::filesystem::path& jsonPath, int t
 	return perRunStepSeconds;
 }
 
+// Same protocol as timeDeckSeconds, for `instances` copies of the deck stepped as one
+// EnsembleSimulation. Each sample is the wall-clock time of ONE instance-step, so the
+// result is directly comparable with timeDeckSeconds' per-step time.
+std::vector<double> timeEnsembleSeconds(const Simulation& deck, int instances, int timedSteps, int nRuns)
+{
+	EnsembleSimulation ensemble(deck, static_cast<std::size_t>(instances));
+	for (int k = 0; k < instances; ++k)
+		ensemble.setSeed(static_cast<std::size_t>(k), static_cast<std::uint64_t>(k) + 1);
+	ensemble.init();
+	for (int t = 0; t < WARMUP_STEPS; ++t) ensemble.step();
+
+	std::vector<double> perRunStepSeconds;
+	perRunStepSeconds.reserve(nRuns);
+	for (int run = 0; run < nRuns; ++run)
+	{
+		ensemble.init();
+		const auto t0 = std::chrono::high_resolution_clock::now();
+		for (int t = 0; t < timedSteps; ++t) ensemble.step();
+		const auto t1 = std::chrono::high_resolution_clock::now();
+		const double elapsed = std::chrono::duration<double>(t1 - t0).count();
+		perRunStepSeconds.push_back(elapsed / (static_cast<double>(timedSteps) * instances));
+	}
+	return perRunStepSeconds;
+}
+
+struct RealTimeSearch
+{
+	bool          sustained = false; // false: no period up to the search's cap held
+	RealTimeStats stats;             // of the shortest sustained period, or the last one tried
+	int           trials    = 0;
+};
+
+// --realtime: the shortest period, in whole microseconds, that RealTimeRunner sustains on
+// this deck. One warmed-up simulation is reused across trials; each trial continues its
+// state, which does not matter for timing. Below the median step time no period can hold,
+// so that is the lower bound.
+RealTimeSearch findAchievablePeriod(const std::filesystem::path& jsonPath, double medianStepSeconds,
+                                    const RealTimeOptions& base)
+{
+	using std::chrono::microseconds;
+	using std::chrono::nanoseconds;
+
+	auto sim = loadDeck(jsonPath);
+	sim->init();
+	tools::math::waitForFftPlans();
+	sim->setMeasureStepDuration(false);
+	for (int t = 0; t < WARMUP_STEPS; ++t) sim->step();
+
+	RealTimeSearch search;
+	const auto trial = [&](microseconds period, RealTimeStats& stats) {
+		RealTimeOptions options = base;
+		options.period = period;
+		options.overrunPolicy = OverrunPolicy::Skip;
+		stats = RealTimeRunner(sim, options).run(kRealTimePeriods);
+		++search.trials;
+		return stats.missRate() <= kRealTimeMissBudget;
+	};
+
+	const auto median = std::chrono::duration_cast<microseconds>(std::chrono::duration<double>(medianStepSeconds));
+	microseconds low = std::max(median, microseconds(1));
+	microseconds high = low + std::max(low / 4, microseconds(1));
+	RealTimeStats stats;
+	for (int doubling = 0; !trial(high, stats); ++doubling)
+	{
+		if (doubling == 10)
+		{
+			search.stats = stats;
+			return search;
+		}
+		low = high;
+		high *= 2;
+	}
+	search.sustained = true;
+	search.stats = stats;
+
+	while (high - low > std::max(high / 50, microseconds(1)))
+	{
+		const microseconds mid = low + (high - low) / 2;
+		if (trial(mid, stats))
+		{
+			high = mid;
+			search.stats = stats;
+		}
+		else
+		{
+			low = mid;
+		}
+	}
+	return search;
+}
+
+void printRealTimeLine(const RealTimeSearch& search)
+{
+	const RealTimeStats& s = search.stats;
+	const auto us = [](std::chrono::nanoseconds ns) { return static_cast<double>(ns.count()) / 1000.0; };
+	if (!search.sustained)
+	{
+		std::printf("    real-time: no period up to %.0f us sustained (miss rate %.1f%%)\n",
+		            us(s.period), s.missRate() * 100.0);
+		return;
+	}
+	std::printf("    real-time: %.0f us period (%.0f Hz), miss %.2f%%, jitter p99 %.1f us, "
+	            "slack p01 %.1f us, step p99 %.1f us  [%d trials%s%s]\n",
+	            us(s.period), 1e9 / static_cast<double>(s.period.count()), s.missRate() * 100.0,
+	            us(s.jitterP99), us(s.slackP01), us(s.stepP99), search.trials,
+	            s.realTimePriority ? ", SCHED_FIFO" : "", s.pinned ? ", pinned" : "");
+	if (!s.note.empty())
+		std::printf("    real-time note: %s\n", s.note.c_str());
+}
+
+nlohmann::json realTimeToJson(const std::string& tier, const RealTimeSearch& search)
+{
+	const RealTimeStats& s = search.stats;
+	return nlohmann::json{
+		{"name", tier},
+		{"sustained", search.sustained},
+		{"period_ns", s.period.count()},
+		{"periods", s.periods},
+		{"overruns", s.overruns},
+		{"skipped", s.skipped},
+		{"miss_rate", s.missRate()},
+		{"jitter_p50_ns", s.jitterP50.count()},
+		{"jitter_p99_ns", s.jitterP99.count()},
+		{"jitter_max_ns", s.jitterMax.count()},
+		{"slack_min_ns", s.slackMin.count()},
+		{"slack_p01_ns", s.slackP01.count()},
+		{"slack_mean_ns", s.slackMean.count()},
+		{"step_p99_ns", s.stepP99.count()},
+		{"sched_fifo", s.realTimePriority},
+		{"pinned", s.pinned},
+		{"note", s.note},
+		{"trials", search.trials},
+	};
+}
+
 std::string filenameTimestamp()
 {
 	const std::time_t now = std::time(nullptr);
@@ -363,6 +532,10 @@ int main(int argc, char* argv[])
 	int         nRuns       = 5;
 	std::string jsonArg;
 	bool        pathsMode  = false;
+	int         ensembleSize = 0;
+	bool        plansMode  = false;
+	bool        realTimeMode = false;
+	RealTimeOptions realTimeOptions;
 	bool        recordMode = false;
 	bool        checkMode  = false;
 	bool        force      = false;
@@ -405,6 +578,40 @@ int main(int argc, char* argv[])
 		}
 		else if (a == "--json" && i + 1 < argc)     jsonArg      = argv[++i];
 		else if (a == "--paths")                    pathsMode    = true;
+		else if (a == "--ensemble" && i + 1 < argc)
+		{
+			if (!parsePositiveInt(argv[++i], "--ensemble", ensembleSize)) return 1;
+		}
+		else if (a == "--plans")                    plansMode    = true;
+		else if (a == "--realtime")                 realTimeMode = true;
+		else if (a == "--rt-priority" && i + 1 < argc)
+		{
+			if (!parsePositiveInt(argv[++i], "--rt-priority", realTimeOptions.priority)) return 1;
+			if (realTimeOptions.priority > 99)
+			{
+				std::fprintf(stderr, "--rt-priority must be 1 to 99, got %d.\n", realTimeOptions.priority);
+				return 1;
+			}
+		}
+		else if (a == "--rt-cpu" && i + 1 < argc)
+		{
+			// CPU 0 is valid, so this cannot go through parsePositiveInt.
+			const char* text = argv[++i];
+			try
+			{
+				realTimeOptions.cpu = std::stoi(text);
+			}
+			catch (const std::exception&)
+			{
+				std::fprintf(stderr, "--rt-cpu expects an integer, got '%s'.\n", text);
+				return 1;
+			}
+			if (realTimeOptions.cpu < 0)
+			{
+				std::fprintf(stderr, "--rt-cpu must not be negative, got '%s'.\n", text);
+				return 1;
+			}
+		}
 		else if (a == "--record")                   recordMode   = true;
 		else if (a == "--check")                    checkMode    = true;
 		else if (a == "--force")                    force        = true;
@@ -445,6 +652,27 @@ int main(int argc, char* argv[])
 			"Auto-mode measurement so every deck has exactly one baseline entry.\n");
 		pathsMode = false;
 	}
+	if ((recordMode || checkMode) && ensembleSize > 0)
+	{
+		std::fprintf(stderr,
+			"Note: --ensemble is ignored with --record/--check, which always compare the plain\n"
+			"Auto-mode measurement so every deck has exactly one baseline entry.\n");
+		ensembleSize = 0;
+	}
+	if ((recordMode || checkMode) && plansMode)
+	{
+		std::fprintf(stderr,
+			"Note: --plans is ignored with --record/--check, which always compare the plain\n"
+			"Auto-mode measurement so every deck has exactly one baseline entry.\n");
+		plansMode = false;
+	}
+	if ((recordMode || checkMode) && realTimeMode)
+	{
+		std::fprintf(stderr,
+			"Note: --realtime is ignored with --record/--check, which always compare the plain\n"
+			"Auto-mode measurement so every deck has exactly one baseline entry.\n");
+		realTimeMode = false;
+	}
 
 	std::vector<DeckSpec> decks;
 	try
@@ -458,10 +686,14 @@ int main(int argc, char* argv[])
 	}
 
 	const std::filesystem::path dataRoot(DECKBENCH_VALIDATION_DATA_DIR);
-	std::printf("dnf_composer deckbench  (%d steps x %d runs, median)%s\n",
-	            timedSteps, nRuns, pathsMode ? "  [--paths]" : "");
+	const std::string ensembleNote = ensembleSize > 0 ? "  [--ensemble " + std::to_string(ensembleSize) + "]" : "";
+	std::printf("dnf_composer deckbench  (%d steps x %d runs, median)%s%s%s%s\n",
+	            timedSteps, nRuns, pathsMode ? "  [--paths]" : "", ensembleNote.c_str(),
+	            plansMode ? "  [--plans]" : "", realTimeMode ? "  [--realtime]" : "");
 
 	std::vector<bench_report::Result> results;
+	nlohmann::json realTimeResults = nlohmann::json::array();
+	nlohmann::json ensembleSkipped = nlohmann::json::array();
 	bool anyFailure = false;
 
 	for (const auto& spec : decks)
@@ -557,6 +789,68 @@ int main(int argc, char* argv[])
 				printResultLine(result);
 				results.push_back(std::move(result));
 			}
+
+			// results.back() is this deck's plain (Auto) measurement in both branches above.
+			const double plainStepsPerSec = results.back().stepsPerSec.median;
+
+			if (ensembleSize > 0)
+			{
+				const auto deck = loadDeck(fullPath);
+				std::string reason;
+				if (!EnsembleSimulation::supports(*deck, &reason))
+				{
+					std::printf("    --ensemble skipped: %s\n", reason.c_str());
+					ensembleSkipped.push_back({ { "tier", spec.tier }, { "deck", spec.path }, { "reason", reason } });
+				}
+				else
+				{
+					const auto samples = timeEnsembleSeconds(*deck, ensembleSize, timedSteps, nRuns);
+					auto ensembleResult = bench_report::makeResult(
+						spec.tier + "-ensemble" + std::to_string(ensembleSize), spec.tier,
+						spec.architecture, "ensemble", spec.fieldCells, samples);
+					ensembleResult.deckHash = hash;
+					printResultLine(ensembleResult);
+					std::printf("    %.2fx the instance-steps/s of %d separate simulations\n",
+					            ensembleResult.stepsPerSec.median / plainStepsPerSec, ensembleSize);
+					results.push_back(std::move(ensembleResult));
+				}
+			}
+
+			if (plansMode && isLargeTier && spec.expectPath.rfind("spectral", 0) == 0)
+			{
+				// Each from an empty cache, so neither run inherits the other's plans.
+				std::vector<double> estimateSamples, measureSamples;
+				tools::math::clearFftPlanCache();
+				estimateSamples = timeDeckSeconds(fullPath, timedSteps, nRuns);
+				{
+					const tools::math::ScopedPlanRigor guard(tools::math::PlanRigor::Measure);
+					tools::math::clearFftPlanCache();
+					measureSamples = timeDeckSeconds(fullPath, timedSteps, nRuns);
+				}
+				tools::math::clearFftPlanCache();
+
+				auto estimateResult = bench_report::makeResult(spec.tier + "-fftw-estimate", spec.tier,
+				                                                spec.architecture, spec.expectPath,
+				                                                spec.fieldCells, estimateSamples);
+				estimateResult.deckHash = hash;
+				auto measureResult = bench_report::makeResult(spec.tier + "-fftw-measure", spec.tier,
+				                                               spec.architecture, spec.expectPath,
+				                                               spec.fieldCells, measureSamples);
+				measureResult.deckHash = hash;
+				printResultLine(estimateResult);
+				printResultLine(measureResult);
+				std::printf("    measured plans: %.2fx the steps/s of estimated ones\n",
+				            measureResult.stepsPerSec.median / estimateResult.stepsPerSec.median);
+				results.push_back(std::move(estimateResult));
+				results.push_back(std::move(measureResult));
+			}
+
+			if (realTimeMode)
+			{
+				const auto search = findAchievablePeriod(fullPath, 1.0 / plainStepsPerSec, realTimeOptions);
+				printRealTimeLine(search);
+				realTimeResults.push_back(realTimeToJson(spec.tier, search));
+			}
 		}
 		catch (const std::exception& e)
 		{
@@ -580,11 +874,26 @@ int main(int argc, char* argv[])
 		            "(IQR/median > %.0f%%) -- re-run under scripts/bench.\n",
 		            bench_report::kNoisyRelSpread * 100.0);
 
+	// Repeated once the run is over: the per-deck lines are easy to miss
+	// among the timings, and a deck with no ensemble row is otherwise hard
+	// to tell from one whose ensemble run was never attempted.
+	if (!ensembleSkipped.empty())
+	{
+		std::printf("\n--ensemble timed %zu of %zu decks; skipped:\n",
+		            decks.size() - ensembleSkipped.size(), decks.size());
+		for (const auto& skipped : ensembleSkipped)
+			std::printf("  %-24s %s\n", skipped["tier"].get<std::string>().c_str(),
+			            skipped["reason"].get<std::string>().c_str());
+	}
+
 	const auto env = bench_env::capture();
 	const auto config = nlohmann::json{{"warmup_steps", WARMUP_STEPS},
 	                                    {"timed_steps", timedSteps},
 	                                    {"runs", nRuns},
 	                                    {"paths_mode", pathsMode},
+	                                    {"ensemble", ensembleSize},
+	                                    {"plans_mode", plansMode},
+	                                    {"realtime_mode", realTimeMode},
 	                                    {"manifest", manifestArg}};
 
 	if (recordMode)
@@ -604,7 +913,12 @@ int main(int argc, char* argv[])
 		jsonPath = resultsDir / ("deckbench_" + filenameTimestamp() + "_" + bench_env::fingerprint(env) + ".json");
 	}
 
-	bench_report::writeJson(jsonPath.string(), env, results, config);
+	nlohmann::json sections;
+	if (realTimeMode)
+		sections["realtime"] = std::move(realTimeResults);
+	if (ensembleSize > 0)
+		sections["ensemble_skipped"] = std::move(ensembleSkipped);
+	bench_report::writeJson(jsonPath.string(), env, results, config, sections);
 	std::printf("\nWrote %s\n", jsonPath.string().c_str());
 
 	return 0;
@@ -6,21 +6,25 @@
 // caches and no surrounding simulation.
 //
 // Every kernel here is public API (tools/math.h, tools/fft_convolution.h,
-// elements/activation_function.h, elements/neural_field_2d.h) -- no library
-// instrumentation involved.
+// tools/simd_dispatch.h, elements/activation_function.h, elements/neural_field_2d.h)
+// -- no library instrumentation involved.
 //
 // Manual perf run, NOT a unit test -- not registered with gtest_discover_tests.
 // Usage: dnf_composer_kernelbench --benchmark_repetitions=5 [other --benchmark_* flags]
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <string>
 #include <vector>
 
 #include "tools/fft_convolution.h"
 #include "tools/logger.h"
 #include "tools/math.h"
+#include "tools/simd_dispatch.h"
+#include "tools/sparse_matrix.h"
 
 #include "elements/activation_function.h"
 #include "elements/gauss_stimulus_2d.h"
@@ -59,7 +63,68 @@ void BM_ConvValid1D(benchmark::State& state)
 }
 // {field size, kernel taps} -- 100 matches the 1D validation deck size; 200 is the
 // benchmark_main.cpp/profiler_main.cpp 2D grid reused as a bigger 1D case for scale.
-BENCHMARK(BM_ConvValid1D)->Args({100, 7})->Args({100, 31})->Args({200, 7})->Args({200, 31});
+BENCHMARK(BM_ConvValid1D)->Args({100, 7})->Args({100, 31})->Args({200, 7})->Args({200, 31})
+	->Args({2000, 31})->Args({2000, 101})->Args({20000, 31})->Args({20000, 101});
+
+// ── 1D spectral (FFTW) convolution (SpectralConvolver1D) -- the path 1D kernels take
+// above kFFTTapThreshold1D on fields of at least kFFTMinSize1D. ─────────────────────
+void BM_Conv1dSpectral(benchmark::State& state)
+{
+	using namespace tools::math;
+	const int fieldSize  = static_cast<int>(state.range(0));
+	const int kernelTaps = static_cast<int>(state.range(1));
+	const auto field  = makeField(fieldSize);
+	const auto kernel = makeField(kernelTaps);
+
+	SpectralConvolver1D conv;
+	conv.init(fieldSize);
+	conv.setKernel(buildWrappedKernel1D(fieldSize, kernel, kernelTaps / 2));
+	std::vector<double> out(fieldSize);
+
+	for (auto _ : state)
+	{
+		conv.apply(field.data(), out.data());
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_Conv1dSpectral)->Args({2000, 31})->Args({2000, 101})->Args({20000, 31})->Args({20000, 101});
+
+// ── 1D direct circular convolution as the 1D kernel elements run it below the
+// crossover: the wraparound gather, then conv_valid_into with a symmetric window.
+// Timed with BM_Conv1dSpectral over one {field size, taps} grid, the rows that
+// kFFTTapThreshold1D and kFFTMinSize1D are read from. ────────────────────────────
+void BM_Conv1dCircularDirect(benchmark::State& state)
+{
+	using namespace tools::math;
+	const int fieldSize  = static_cast<int>(state.range(0));
+	const int kernelTaps = static_cast<int>(state.range(1));
+	const int half = kernelTaps / 2;
+	const auto field = makeField(fieldSize);
+	std::vector<double> kernel(kernelTaps);
+	for (int i = 0; i < kernelTaps; ++i)
+		kernel[i] = std::exp(-0.5 * (i - half) * (i - half) / (0.2 * kernelTaps * 0.2 * kernelTaps));
+	const auto extIndex = createExtendedIndex(fieldSize, { half, half });
+	std::vector<double> extended(extIndex.size());
+	std::vector<double> out(fieldSize);
+
+	for (auto _ : state)
+	{
+		obtainCircularVector_into(extended, extIndex, field);
+		conv_valid_into(out, extended, kernel);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+}
+
+void Crossover1D(benchmark::internal::Benchmark* b)
+{
+	for (const int fieldSize : { 128, 256, 512, 1024, 2048, 4096, 8192, 16384 })
+		for (const int taps : { 15, 31, 47, 63, 79, 95, 127, 191, 255 })
+			b->Args({ fieldSize, taps });
+}
+BENCHMARK(BM_Conv1dCircularDirect)->Apply(Crossover1D);
+BENCHMARK(BM_Conv1dSpectral)->Name("BM_Conv1dSpectral/crossover")->Apply(Crossover1D);
 
 // ── 2D separable direct convolution (conv2d_separable_into) -- the path every 2D
 // kernel element uses below kFFTTapThreshold / kFFTMinAxisSize. ─────────────────────
@@ -144,6 +209,83 @@ void BM_SigmoidApply(benchmark::State& state)
 // 2500 = 50x50 (decks.json "medium"), 16384 = 128x128 (decks.json "large-a"/"large-b").
 BENCHMARK(BM_SigmoidApply)->Arg(2500)->Arg(16384)->Arg(40000);
 
+// ── Coupling forward pass -- tools::math::gemv_into, what FieldCoupling and
+// GaussFieldCoupling::updateOutput call, on an n x n weight matrix with the given
+// percentage of the input non-zero (a Heaviside field with a few active peaks vs a
+// fully active one). BM_GemvColumnLoop is the column-by-column loop gemv_into
+// replaced, kept as the baseline. ─────────────────────────────────────────────────
+namespace {
+
+std::vector<double> makeSparseInput(int n, int activePercent)
+{
+	std::vector<double> v = makeField(n);
+	for (int i = 0; i < n; ++i)
+		if (i % 100 >= activePercent) v[i] = 0.0;
+	return v;
+}
+
+} // namespace
+
+void BM_GemvInto(benchmark::State& state)
+{
+	const int n = static_cast<int>(state.range(0));
+	const auto in = makeSparseInput(n, static_cast<int>(state.range(1)));
+	const auto weights = makeField(n * n);
+	std::vector<double> out(n);
+
+	for (auto _ : state)
+	{
+		tools::math::gemv_into(out, weights, in, 0.5);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.counters["weightBytes"] = static_cast<double>(weights.size() * sizeof(double));
+}
+BENCHMARK(BM_GemvInto)->Args({200, 100})->Args({1000, 100})->Args({1000, 10})->Args({2500, 100})->Args({2500, 10});
+
+void BM_GemvColumnLoop(benchmark::State& state)
+{
+	const int n = static_cast<int>(state.range(0));
+	const auto in = makeSparseInput(n, static_cast<int>(state.range(1)));
+	const auto weights = makeField(n * n);
+	std::vector<double> out(n);
+
+	for (auto _ : state)
+	{
+		std::ranges::fill(out, 0.0);
+		for (int i = 0; i < n; ++i)
+			for (int j = 0; j < n; ++j)
+				out[i] += 0.5 * weights[static_cast<std::size_t>(j) * n + i] * in[j];
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+}
+BENCHMARK(BM_GemvColumnLoop)->Args({200, 100})->Args({1000, 100})->Args({1000, 10})->Args({2500, 100})->Args({2500, 10});
+
+// ── FieldCoupling's WeightStorage::SPARSE forward pass -- tools::math::spmv_into on
+// an n x n matrix pruned to the given percentage of its entries (fully active
+// input), next to BM_GemvInto's dense n x n. weightBytes is the CSR footprint. ──
+void BM_SpmvInto(benchmark::State& state)
+{
+	const int n = static_cast<int>(state.range(0));
+	const int keptPercent = static_cast<int>(state.range(1));
+	const auto in = makeSparseInput(n, 100);
+	std::vector<double> dense = makeField(n * n);
+	for (std::size_t k = 0; k < dense.size(); ++k)
+		if (static_cast<int>((k * 37) % 100) >= keptPercent) dense[k] = 0.0;
+	const auto weights = tools::math::csr_from_dense(dense, n, n, 0.0);
+	std::vector<double> out(n);
+
+	for (auto _ : state)
+	{
+		tools::math::spmv_into(out, weights, in, 0.5);
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.counters["weightBytes"] = static_cast<double>(weights.bytes());
+}
+BENCHMARK(BM_SpmvInto)->Args({1000, 100})->Args({1000, 10})->Args({2500, 100})->Args({2500, 10})->Args({2500, 1});
+
 // ── NeuralField2D::step -- updateInput + Euler integration + sigmoid combined, so it
 // is expected to cost roughly the sum of BM_SigmoidApply plus a per-cell add/mul, not
 // a new mechanism of its own; benchmarked anyway since it is the actual call site the
@@ -179,6 +321,70 @@ void BM_NeuralField2DStep(benchmark::State& state)
 }
 BENCHMARK(BM_NeuralField2DStep)->Arg(50)->Arg(128);
 
+// ── Per-cell SIMD kernels (tools/simd_dispatch.h), once per tier the host supports --
+// the same call at each tier, so the rows of one kernel compare the instruction sets
+// directly. Registered from main(), since the tiers are only known at run time; named
+// BM_Simd/<kernel>/<tier>/<cells>. ─────────────────────────────────────────────────
+enum class SimdKernel { ConvValid, Sigmoid, Heaviside, AbsSigmoid, Euler, MemoryTrace, Accumulate };
+
+const char* simdKernelName(SimdKernel kernel)
+{
+	switch (kernel)
+	{
+	case SimdKernel::ConvValid:   return "conv_valid";
+	case SimdKernel::Sigmoid:     return "sigmoid";
+	case SimdKernel::Heaviside:   return "heaviside";
+	case SimdKernel::AbsSigmoid:  return "abs_sigmoid";
+	case SimdKernel::Euler:       return "euler";
+	case SimdKernel::MemoryTrace: return "memory_trace";
+	default:                      return "accumulate";
+	}
+}
+
+void BM_Simd(benchmark::State& state, tools::math::SimdTier tier, SimdKernel kernel)
+{
+	const auto& simd = tools::math::detail::simdKernelsFor(tier);
+	const int n = static_cast<int>(state.range(0));
+	constexpr int taps = 31;
+	const auto in = makeField(n + taps - 1);
+	const auto kr = makeField(taps);
+	std::vector<double> out = makeField(n);
+
+	for (auto _ : state)
+	{
+		switch (kernel)
+		{
+		case SimdKernel::ConvValid:   simd.conv_valid_f64(kr.data(), taps, in.data(), out.data(), n); break;
+		case SimdKernel::Sigmoid:     simd.sigmoid_f64(in.data(), out.data(), n, 100.0, 0.0); break;
+		case SimdKernel::Heaviside:   simd.heaviside_f64(in.data(), out.data(), n, 0.0); break;
+		case SimdKernel::AbsSigmoid:  simd.abs_sigmoid_f64(in.data(), out.data(), n, 100.0, 0.0); break;
+		case SimdKernel::Euler:       simd.euler_f64(out.data(), in.data(), n, 0.04, -5.0); break;
+		case SimdKernel::MemoryTrace: simd.memory_trace_f64(in.data(), out.data(), n, 0.5, 0.01, 0.001); break;
+		case SimdKernel::Accumulate:  simd.accumulate_f64(out.data(), in.data(), n); break;
+		}
+		benchmark::DoNotOptimize(out.data());
+		benchmark::ClobberMemory();
+	}
+}
+
+void registerSimdBenchmarks()
+{
+	using tools::math::SimdTier;
+	for (const SimdKernel kernel : { SimdKernel::ConvValid, SimdKernel::Sigmoid, SimdKernel::Heaviside,
+	                                 SimdKernel::AbsSigmoid, SimdKernel::Euler, SimdKernel::MemoryTrace,
+	                                 SimdKernel::Accumulate })
+	{
+		for (const SimdTier tier : { SimdTier::Scalar, SimdTier::Avx2, SimdTier::Avx512 })
+		{
+			if (tier > tools::math::detectedSimdTier())
+				continue;
+			const std::string name = std::string("BM_Simd/") + simdKernelName(kernel) + "/" + tools::math::toString(tier);
+			// 2500 = 50x50 (decks.json "medium"), 16384 = 128x128 ("large-a"/"large-b").
+			benchmark::RegisterBenchmark(name.c_str(), BM_Simd, tier, kernel)->Arg(2500)->Arg(16384);
+		}
+	}
+}
+
 // Not BENCHMARK_MAIN() -- BM_NeuralField2DStep constructs a Simulation per repetition,
 // which logs several INFO lines per construction (element add, input wiring, init) that
 // would otherwise flood every run of this tool. dnf_composer_benchmark/deckbench/
@@ -186,6 +392,7 @@ BENCHMARK(BM_NeuralField2DStep)->Arg(50)->Arg(128);
 int main(int argc, char** argv)
 {
 	tools::logger::Logger::setMinLogLevel(tools::logger::LogLevel::FATAL);
+	registerSimdBenchmarks();
 	benchmark::Initialize(&argc, argv);
 	if (benchmark::ReportUnrecognizedArguments(argc, argv))
 		return 1;
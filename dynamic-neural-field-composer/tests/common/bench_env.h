@@ -70,6 +70,7 @@ struct Env
 	std::string compiler;
 	std::string build_type;
 	bool        avx2 = false;
+	std::string simd;
 	std::string fftw;
 	std::string git;
 
@@ -243,6 +244,7 @@ inline Env capture()
 	e.compiler     = detail::compiler_name();
 	e.build_type   = BENCH_ENV_BUILD_TYPE;
 	e.avx2         = dnf_composer::tools::math::detail::avx2_fma_available();
+	e.simd         = dnf_composer::tools::math::toString(dnf_composer::tools::math::simdTier());
 	e.fftw         = BENCH_ENV_FFTW_VERSION;
 	e.git          = BENCH_ENV_GIT_SHA;
 
@@ -280,6 +282,7 @@ inline nlohmann::json to_json(const Env& e)
 		{"compiler",     e.compiler},
 		{"build_type",   e.build_type},
 		{"avx2",         e.avx2},
+		{"simd",         e.simd},
 		{"fftw",         e.fftw},
 		{"git",          e.git},
 		{"git_dirty",    e.git_dirty},
@@ -301,6 +304,7 @@ inline std::string to_markdown(const Env& e)
 	   + " | " + e.compiler
 	   + " | " + e.build_type
 	   + " | AVX2: " + (e.avx2 ? "yes" : "no")
+	   + " | SIMD: " + e.simd
 	   + " | FFTW " + e.fftw
 	   + " | git " + e.git;
 	return s;
@@ -146,9 +146,12 @@ namespace detail {
 // Schema-versioned JSON report: provenance (Env + fingerprint), the run configuration the
 // caller supplies as opaque JSON (warmup/timed step counts, run count, ...), and every
 // Result. "schema": 1 from the first version, so a baseline file read by a later tool
-// build can tell it is looking at the shape it expects rather than guessing.
+// build can tell it is looking at the shape it expects rather than guessing. `sections`,
+// if an object, adds top-level keys for measurements that are not a Result (deckbench's
+// "realtime"); --check reads only "results", so they never affect a baseline comparison.
 inline void writeJson(const std::string& path, const bench_env::Env& env,
-                       const std::vector<Result>& results, const nlohmann::json& config)
+                       const std::vector<Result>& results, const nlohmann::json& config,
+                       const nlohmann::json& sections = {})
 {
 	nlohmann::json j;
 	j["schema"]      = 1;
@@ -173,6 +176,9 @@ inline void writeJson(const std::string& path, const bench_env::Env& env,
 			{"ns_per_cell_step", detail::statsToJson(r.nsPerCellStep)},
 		});
 	}
+	if (sections.is_object())
+		for (const auto& [key, value] : sections.items())
+			j[key] = value;
 
 	std::ofstream f(path);
 	if (!f)
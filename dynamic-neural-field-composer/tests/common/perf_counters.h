@@ -0,0 +1,281 @@
+#pragma once
+
+// Hardware performance counters for the manual perf tools, through Linux
+// perf_event_open. Wall-clock microseconds say how long an element's step took;
+// cycles, instructions and cache misses say why -- an IPC near 3 with few LLC
+// misses is compute-bound, an IPC under 1 with many is waiting on memory.
+//
+// A CounterGroup opens one counter per Counter below for the calling thread,
+// user space only, as a single perf group so all of them cover the same
+// instructions. Counting accumulates across enable()/disable() windows until
+// read(), so a step can be counted on its own inside a loop that also steps
+// other elements. Each window costs two ioctls; calibrate() measures what an
+// empty window counts so callers can subtract it.
+//
+// Counters are optional everywhere: on non-Linux systems, in containers, under
+// perf_event_paranoid > 2 or on a PMU without a given event, available() is
+// false (or that one counter is absent) and reason() says why. Nothing throws.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf_counters {
+
+enum Counter : std::size_t
+{
+	Cycles,
+	Instructions,
+	L1dMisses,
+	LlcMisses,
+	BranchMisses,
+	CounterCount
+};
+
+inline const char* counterName(Counter c)
+{
+	static constexpr std::array<const char*, CounterCount> names = {
+		"cycles", "instructions", "L1D read misses", "LLC misses", "branch misses" };
+	return names[c];
+}
+
+// Accumulated counts, already scaled up if the kernel multiplexed the group.
+struct Counts
+{
+	std::array<double, CounterCount> values{};
+	std::array<bool, CounterCount>   present{};
+	std::uint64_t                    windows = 0; // enable()/disable() pairs counted
+
+	bool has(Counter c) const { return present[c]; }
+	double operator[](Counter c) const { return values[c]; }
+
+	double ipc() const
+	{
+		return has(Cycles) && has(Instructions) && values[Cycles] > 0.0
+			? values[Instructions] / values[Cycles] : 0.0;
+	}
+
+	// Per window, minus what an empty window counts (clamped at zero).
+	Counts perWindow(const Counts& overhead) const
+	{
+		Counts out = *this;
+		out.windows = 1;
+		for (std::size_t c = 0; c < CounterCount; ++c)
+		{
+			const double mean = windows > 0 ? values[c] / static_cast<double>(windows) : 0.0;
+			const double empty = overhead.present[c] && overhead.windows > 0
+				? overhead.values[c] / static_cast<double>(overhead.windows) : 0.0;
+			out.values[c] = mean > empty ? mean - empty : 0.0;
+		}
+		return out;
+	}
+	Counts perWindow() const { return perWindow(Counts{}); }
+
+	// Sums counts over the same counters; a counter missing on either side is dropped.
+	Counts& operator+=(const Counts& other)
+	{
+		for (std::size_t c = 0; c < CounterCount; ++c)
+		{
+			present[c] = present[c] && other.present[c];
+			values[c] += other.values[c];
+		}
+		windows += other.windows;
+		return *this;
+	}
+};
+
+class CounterGroup
+{
+public:
+	CounterGroup()
+	{
+#if defined(__linux__)
+		for (std::size_t c = 0; c < CounterCount; ++c)
+		{
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			configure(static_cast<Counter>(c), attr);
+			attr.disabled = leader() < 0 ? 1 : 0; // the group starts and stops with its leader
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+				| PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_ID;
+			const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader(), 0UL);
+			if (fd < 0)
+			{
+				const int error = errno;
+				if (c == Cycles)
+				{
+					why = std::string("perf_event_open failed for cycles: ") + std::strerror(error)
+						+ (error == EACCES || error == EPERM
+							? " (check /proc/sys/kernel/perf_event_paranoid)" : "");
+					return;
+				}
+				why += std::string(why.empty() ? "" : "; ") + counterName(static_cast<Counter>(c))
+					+ " unavailable: " + std::strerror(error);
+				continue;
+			}
+			fds[c] = static_cast<int>(fd);
+			ioctl(fds[c], PERF_EVENT_IOC_ID, &ids[c]);
+		}
+#else
+		why = "hardware counters need Linux perf_event_open";
+#endif
+	}
+
+	~CounterGroup()
+	{
+#if defined(__linux__)
+		for (const int fd : fds)
+			if (fd >= 0) close(fd);
+#endif
+	}
+
+	CounterGroup(const CounterGroup&) = delete;
+	CounterGroup& operator=(const CounterGroup&) = delete;
+	CounterGroup(CounterGroup&& other) noexcept
+		: fds(std::exchange(other.fds, emptyFds())), ids(other.ids), why(std::move(other.why)), windows(other.windows) {}
+	CounterGroup& operator=(CounterGroup&&) = delete;
+
+	bool available() const { return leader() >= 0; }
+	// Why the group, or some of its counters, could not be opened; empty if all were.
+	const std::string& reason() const { return why; }
+
+	void enable()
+	{
+#if defined(__linux__)
+		if (available())
+			ioctl(leader(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+	}
+
+	void disable()
+	{
+#if defined(__linux__)
+		if (available())
+		{
+			ioctl(leader(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+			++windows;
+		}
+#endif
+	}
+
+	void reset()
+	{
+#if defined(__linux__)
+		if (available())
+			ioctl(leader(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+#endif
+		windows = 0;
+	}
+
+	// Everything counted since construction or the last reset().
+	Counts read() const
+	{
+		Counts out;
+		out.windows = windows;
+#if defined(__linux__)
+		if (!available())
+			return out;
+		// nr, time_enabled, time_running, then {value, id} per counter.
+		std::array<std::uint64_t, 3 + 2 * CounterCount> buffer{};
+		if (::read(leader(), buffer.data(), sizeof(buffer)) <= 0)
+			return out;
+		const std::uint64_t nr = buffer[0];
+		const std::uint64_t enabled = buffer[1];
+		const std::uint64_t running = buffer[2];
+		// Never scheduled on the PMU: present but meaningless, so report nothing.
+		if (running == 0)
+			return out;
+		const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+		for (std::uint64_t i = 0; i < nr && i < CounterCount; ++i)
+		{
+			const std::uint64_t value = buffer[3 + 2 * i];
+			const std::uint64_t id = buffer[4 + 2 * i];
+			for (std::size_t c = 0; c < CounterCount; ++c)
+			{
+				if (fds[c] >= 0 && ids[c] == id)
+				{
+					out.values[c] = static_cast<double>(value) * scale;
+					out.present[c] = true;
+				}
+			}
+		}
+#endif
+		return out;
+	}
+
+	// What `windows` empty enable()/disable() windows count, for perWindow().
+	static Counts calibrate(int windows = 1000)
+	{
+		CounterGroup group;
+		for (int i = 0; i < windows; ++i)
+		{
+			group.enable();
+			group.disable();
+		}
+		return group.read();
+	}
+
+private:
+	static std::array<int, CounterCount> emptyFds()
+	{
+		std::array<int, CounterCount> fds;
+		fds.fill(-1);
+		return fds;
+	}
+
+	int leader() const { return fds[Cycles]; }
+
+#if defined(__linux__)
+	static void configure(Counter c, perf_event_attr& attr)
+	{
+		switch (c)
+		{
+		case Cycles:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case Instructions:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case L1dMisses:
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_L1D
+				| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case LlcMisses:
+			// The generic "cache-misses" event: last-level misses on Intel and AMD.
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		case BranchMisses:
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		default:
+			break;
+		}
+	}
+#endif
+
+	std::array<int, CounterCount>           fds = emptyFds();
+	std::array<std::uint64_t, CounterCount> ids{};
+	std::string                             why;
+	std::uint64_t                           windows = 0;
+};
+
+} // namespace perf_counters
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "elements/element_components.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
+#include "elements/neural_field.h"
+#include "elements/activation_function.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static std::shared_ptr<GaussStimulus> makeStimulus(const std::string& name, const int size = 100)
+{
+    ElementCommonParameters cp{ name, size };
+    GaussStimulusParameters gsp{ 5.0, 15.0, 50.0, true, false };
+    return std::make_shared<GaussStimulus>(cp, gsp);
+}
+
+static std::shared_ptr<NeuralField> makeField(const std::string& name, const int size = 100)
+{
+    ElementCommonParameters cp{ name, size };
+    const SigmoidFunction sigmoid{ 0.0, 10.0 };
+    NeuralFieldParameters nfp{ 25.0, -5.0, sigmoid };
+    return std::make_shared<NeuralField>(cp, nfp);
+}
+
+static std::shared_ptr<GaussKernel> makeKernel(const std::string& name, const int size = 100)
+{
+    ElementCommonParameters cp{ name, size };
+    return std::make_shared<GaussKernel>(cp, GaussKernelParameters{});
+}
+
+static bool isCacheLineAligned(const double* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % ComponentArena::ALIGNMENT == 0;
+}
+
+// stim -> field <-> kernel, the smallest architecture that exercises every
+// component kind (stimulus output, field state, kernel weights).
+static std::unique_ptr<Simulation> makeSimulation()
+{
+    auto sim = std::make_unique<Simulation>("components", 1.0, 0.0, 0.0);
+    sim->addElement(makeStimulus("stim"));
+    sim->addElement(makeField("field"));
+    sim->addElement(makeKernel("kernel"));
+    sim->createInteraction("stim", "output", "field");
+    sim->createInteraction("field", "output", "kernel");
+    sim->createInteraction("kernel", "output", "field");
+    return sim;
+}
+
+// ---------------------------------------------------------------------------
+// ComponentBuffer
+// ---------------------------------------------------------------------------
+
+TEST(ComponentBuffer, BehavesLikeAVectorOfDoubles)
+{
+    ComponentBuffer buffer(3, 1.5);
+    EXPECT_EQ(buffer, (std::vector<double>{ 1.5, 1.5, 1.5 }));
+
+    buffer.push_back(2.0);
+    buffer.resize(6);
+    EXPECT_EQ(buffer, (std::vector<double>{ 1.5, 1.5, 1.5, 2.0, 0.0, 0.0 }));
+    EXPECT_THROW(buffer.at(6), std::out_of_range);
+
+    buffer = std::vector<double>{ 4.0, 5.0 };
+    EXPECT_EQ(buffer.toVector(), (std::vector<double>{ 4.0, 5.0 }));
+    EXPECT_FALSE(buffer.isArenaBacked());
+}
+
+TEST(ComponentBuffer, OwnStorageIsCacheLineAligned)
+{
+    const ComponentBuffer buffer(13, 0.0);
+    EXPECT_TRUE(isCacheLineAligned(buffer.data()));
+}
+
+TEST(ComponentBuffer, AttachedStorageIsUsedInPlaceUntilOutgrown)
+{
+    auto owner = std::make_shared<std::vector<double>>(std::vector<double>{ 1.0, 2.0, 3.0 });
+    ComponentBuffer buffer;
+    buffer.attach(owner->data(), owner->size(), owner);
+    EXPECT_TRUE(buffer.isExternallyBacked());
+    EXPECT_FALSE(buffer.isArenaBacked());
+    EXPECT_EQ(buffer.data(), owner->data());
+
+    buffer[1] = 5.0;
+    EXPECT_EQ((*owner)[1], 5.0);
+
+    // Moving hands the storage and its owner over without a copy.
+    ComponentBuffer moved;
+    moved = std::move(buffer);
+    EXPECT_EQ(moved.data(), owner->data());
+    EXPECT_FALSE(buffer.isExternallyBacked());
+
+    const std::weak_ptr<std::vector<double>> watch = owner;
+    owner.reset();
+    EXPECT_FALSE(watch.expired());
+    moved.push_back(4.0);
+    EXPECT_FALSE(moved.isExternallyBacked());
+    EXPECT_TRUE(watch.expired());
+    EXPECT_EQ(moved, (std::vector<double>{ 1.0, 5.0, 3.0, 4.0 }));
+}
+
+// ---------------------------------------------------------------------------
+// ComponentTable slots
+// ---------------------------------------------------------------------------
+
+TEST(ComponentTable, OutputAndInputHoldTheFixedSlots)
+{
+    const auto field = makeField("field");
+    const ComponentTable& components = *field->getComponents();
+    EXPECT_EQ(components.slot("output"), OUTPUT_SLOT);
+    EXPECT_EQ(components.slot("input"), INPUT_SLOT);
+    EXPECT_EQ(&components[components.slot("activation")], &components.at("activation"));
+}
+
+TEST(ComponentTable, SlotOfMissingComponentThrows)
+{
+    const auto field = makeField("field");
+    EXPECT_THROW(static_cast<void>(field->getComponents()->slot("missing")), std::out_of_range);
+}
+
+TEST(ComponentTable, BufferAddressesSurviveAddingComponents)
+{
+    ComponentTable table;
+    const ComponentBuffer* first = &table["a"];
+    for (int i = 0; i < 100; ++i)
+        table["c" + std::to_string(i)].resize(4);
+    EXPECT_EQ(first, &table["a"]);
+    EXPECT_EQ(table.slot("c99").index, 100u);
+}
+
+// ---------------------------------------------------------------------------
+// Arena packing by Simulation::init()
+// ---------------------------------------------------------------------------
+
+TEST(ComponentArena, InitPacksEveryComponentInStepOrder)
+{
+    const auto sim = makeSimulation();
+    sim->init();
+
+    const double* previous = nullptr;
+    for (const auto& element : sim->getElements())
+    {
+        for (const auto& [name, buffer] : *element->getComponents())
+        {
+            EXPECT_TRUE(buffer.isArenaBacked()) << element->getUniqueName() << " - " << name;
+            EXPECT_TRUE(isCacheLineAligned(buffer.data())) << element->getUniqueName() << " - " << name;
+            // Laid out back to back in registry (= step) order.
+            EXPECT_LT(previous, buffer.data()) << element->getUniqueName() << " - " << name;
+            previous = buffer.data();
+        }
+    }
+}
+
+TEST(ComponentArena, PackingPreservesValuesAndDynamics)
+{
+    const auto sim = makeSimulation();
+    sim->init();
+    for (int i = 0; i < 20; ++i)
+        sim->step();
+    const std::vector<double> packed = sim->getComponent("field", "activation");
+
+    // The same run with every component moved back to storage of its own.
+    const auto reference = makeSimulation();
+    reference->init();
+    for (const auto& element : reference->getElements())
+        element->releaseComponentArena();
+    for (int i = 0; i < 20; ++i)
+        reference->step();
+
+    EXPECT_FALSE(reference->getComponentPtr("field", "activation")->isArenaBacked());
+    EXPECT_EQ(packed, reference->getComponent("field", "activation"));
+}
+
+TEST(ComponentArena, OutgrowingTheRegionMovesToOwnStorage)
+{
+    const auto sim = makeSimulation();
+    sim->init();
+    sim->step();
+
+    ComponentBuffer* output = sim->getComponentPtr("stim", "output");
+    const std::vector<double> before = output->toVector();
+    output->resize(before.size() + 64, 7.0);
+
+    EXPECT_FALSE(output->isArenaBacked());
+    EXPECT_TRUE(std::equal(before.begin(), before.end(), output->begin()));
+    EXPECT_DOUBLE_EQ(output->back(), 7.0);
+
+    output->resize(before.size());
+    sim->init();
+    EXPECT_TRUE(sim->getComponentPtr("stim", "output")->isArenaBacked());
+}
+
+TEST(ComponentArena, CloneOwnsItsStorage)
+{
+    const auto sim = makeSimulation();
+    sim->init();
+    sim->step();
+
+    const auto original = sim->getElement("field");
+    const auto copy = original->clone();
+    ComponentBuffer* copied = copy->getComponentPtr("activation");
+    EXPECT_FALSE(copied->isArenaBacked());
+    EXPECT_EQ(*copied, *original->getComponentPtr("activation"));
+
+    copied->assign(copied->size(), 42.0);
+    EXPECT_NE(original->getComponentPtr("activation")->front(), 42.0);
+}
+
+TEST(ComponentArena, ElementOutlivesItsSimulation)
+{
+    std::shared_ptr<Element> field;
+    std::vector<double> expected;
+    {
+        const auto sim = makeSimulation();
+        sim->init();
+        sim->step();
+        field = sim->getElement("field");
+        expected = field->getComponent("activation");
+    }
+    // The arena is shared-owned, so the element's buffers are still valid.
+    EXPECT_TRUE(field->getComponentPtr("activation")->isArenaBacked());
+    EXPECT_EQ(field->getComponent("activation"), expected);
+}
+
+TEST(ComponentArena, RemovedElementGetsItsOwnStorage)
+{
+    const auto sim = makeSimulation();
+    sim->init();
+    const auto stim = sim->getElement("stim");
+    const std::vector<double> expected = stim->getComponent("output");
+
+    sim->removeElement("stim");
+    EXPECT_FALSE(stim->getComponentPtr("output")->isArenaBacked());
+    EXPECT_EQ(stim->getComponent("output"), expected);
+}
@@ -5,6 +5,7 @@
 #include <algorithm>
 
 #include "elements/field_coupling.h"
+#include "tools/weight_file.h"
 #include "elements/neural_field.h"
 #include "elements/activation_function.h"
 #include "simulation/simulation.h"
@@ -917,3 +918,373 @@ TEST(FieldCouplingTest, SetDecayRateUpdatesParameter)
     fc->setDecayRate(0.15);
     EXPECT_DOUBLE_EQ(fc->getParameters().decayRate, 0.15);
 }
+
+// ---------------------------------------------------------------------------
+// Sparse (pruned) weight storage
+// ---------------------------------------------------------------------------
+
+TEST(FieldCouplingParametersTest, DifferentWeightStorageComparesNotEqual)
+{
+    ElementDimensions dim{ 100, 1.0 };
+    const FieldCouplingParameters a{ dim, LearningRule::HEBB, 1.0, 0.01 };
+    const FieldCouplingParameters b{ dim, LearningRule::HEBB, 1.0, 0.01, 0.0, WeightStorage::SPARSE };
+    const FieldCouplingParameters c{ dim, LearningRule::HEBB, 1.0, 0.01, 0.0, WeightStorage::SPARSE, 0.1 };
+    EXPECT_EQ(a.weightStorage, WeightStorage::DENSE);
+    EXPECT_NE(a, b);
+    EXPECT_NE(b, c);
+}
+
+TEST(FieldCouplingSparseWeights, LosslessSparseStepsBitIdenticalToDense)
+{
+    // Every weight non-zero, so a threshold of 0 keeps them all and DELTA
+    // learning touches the same entries in both storage modes.
+    constexpr int size = 6;
+    const auto makeCoupling = [&](const std::string& name, WeightStorage storage)
+    {
+        const auto inputField = makeField(name + "-in", size);
+        const auto outputField = makeField(name + "-out", size);
+        const auto targetField = makeField(name + "-target", size);
+        FieldCouplingParameters fcp{ ElementDimensions{ size, 1.0 }, LearningRule::DELTA, 1.5, 0.05, 0.01 };
+        const auto fc = std::make_shared<FieldCoupling>(ElementCommonParameters{ name + "-fc", size }, fcp);
+        wireCouplingWithTarget(inputField, fc, outputField, targetField);
+        for (int i = 0; i < size; ++i)
+        {
+            (*inputField->getComponentPtr("output"))[i] = (i == 2) ? 0.0 : 0.3 + 0.1 * i;
+            (*targetField->getComponentPtr("output"))[i] = 1.0 - 0.05 * i;
+        }
+        auto* weights = fc->getComponentPtr("weights");
+        for (std::size_t k = 0; k < weights->size(); ++k)
+            (*weights)[k] = std::cos(0.7 * static_cast<double>(k)) + 1.5;
+        fcp.weightStorage = storage;
+        fc->setParameters(fcp);
+        fc->setLearning(true);
+        return fc;
+    };
+    const auto dense = makeCoupling("lossless-dense", WeightStorage::DENSE);
+    const auto sparse = makeCoupling("lossless-sparse", WeightStorage::SPARSE);
+
+    EXPECT_TRUE(sparse->getComponentPtr("weights")->empty());
+    EXPECT_EQ(sparse->getSparseWeights().nonZeros(), static_cast<std::size_t>(size * size));
+
+    for (int step = 0; step < 5; ++step)
+    {
+        dense->step(0.0, 0.1);
+        sparse->step(0.0, 0.1);
+        const auto& expected = *dense->getComponentPtr("output");
+        const auto& actual = *sparse->getComponentPtr("output");
+        for (int j = 0; j < size; ++j)
+            ASSERT_EQ(actual[j], expected[j]) << "step " << step << ", output " << j;
+    }
+
+    auto fcp = sparse->getParameters();
+    fcp.weightStorage = WeightStorage::DENSE;
+    sparse->setParameters(fcp);
+    EXPECT_EQ(sparse->getSparseWeights().nonZeros(), 0u);
+    const auto& expected = *dense->getComponentPtr("weights");
+    const auto& actual = *sparse->getComponentPtr("weights");
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t k = 0; k < expected.size(); ++k)
+        EXPECT_EQ(actual[k], expected[k]) << "at " << k;
+}
+
+TEST(FieldCouplingSparseWeights, PruningDropsSmallWeightsAndShrinksStorage)
+{
+    const auto fc = makeFC("prune-fc", 40, 50);
+    auto* weights = fc->getComponentPtr("weights");
+    for (std::size_t k = 0; k < weights->size(); ++k)
+        (*weights)[k] = (k % 10 == 0) ? 1.0 + static_cast<double>(k) : 1e-3;
+    const std::size_t denseBytes = fc->getWeightsBytes();
+
+    auto fcp = fc->getParameters();
+    fcp.weightStorage = WeightStorage::SPARSE;
+    fcp.pruneThreshold = 0.01;
+    fc->setParameters(fcp);
+
+    EXPECT_EQ(fc->getSparseWeights().nonZeros(), 40u * 50u / 10u);
+    EXPECT_LT(fc->getWeightsBytes(), denseBytes / 4);
+
+    // Raising the threshold prunes the retained entries further.
+    fcp.pruneThreshold = 1000.0;
+    fc->setParameters(fcp);
+    for (const double w : fc->getSparseWeights().values)
+        EXPECT_GT(w, 1000.0);
+
+    fc->clearWeights();
+    for (const double w : fc->getSparseWeights().values)
+        EXPECT_EQ(w, 0.0);
+}
+
+TEST_F(FieldCouplingFileTest, SparseWeightsRoundTripThroughDenseFile)
+{
+    const auto writer = makeFC("sparse-file", 8, 12);
+    writer->setWeightsDirectory(tempDir);
+    auto* weights = writer->getComponentPtr("weights");
+    for (std::size_t k = 0; k < weights->size(); ++k)
+        (*weights)[k] = (k % 3 == 0) ? 0.5 * static_cast<double>(k) : 0.0;
+    const std::vector<double> expected(weights->begin(), weights->end());
+
+    auto fcp = writer->getParameters();
+    fcp.weightStorage = WeightStorage::SPARSE;
+    writer->setParameters(fcp);
+    writer->writeWeights();
+
+    // The file is dense text, so it loads into a DENSE coupling as-is...
+    const auto denseReader = makeFC("sparse-file", 8, 12);
+    denseReader->setWeightsDirectory(tempDir);
+    denseReader->readWeights();
+    const auto& read = *denseReader->getComponentPtr("weights");
+    ASSERT_EQ(read.size(), expected.size());
+    for (std::size_t k = 0; k < expected.size(); ++k)
+        EXPECT_DOUBLE_EQ(read[k], expected[k]);
+
+    // ...and is pruned on load into a SPARSE one.
+    const auto sparseReader = std::make_shared<FieldCoupling>(ElementCommonParameters{ "sparse-file", 12 }, fcp);
+    sparseReader->setWeightsDirectory(tempDir);
+    sparseReader->readWeights();
+    EXPECT_TRUE(sparseReader->getComponentPtr("weights")->empty());
+    EXPECT_EQ(sparseReader->getSparseWeights().nonZeros(), writer->getSparseWeights().nonZeros());
+}
+
+// ---------------------------------------------------------------------------
+// Binary weight files
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    void fillWeights(const std::shared_ptr<FieldCoupling>& fc, double phase)
+    {
+        auto* weights = fc->getComponentPtr("weights");
+        for (std::size_t k = 0; k < weights->size(); ++k)
+            (*weights)[k] = (k % 3 == 0) ? std::sin(phase + 0.1 * static_cast<double>(k)) / 7.0 : 0.0;
+    }
+}
+
+TEST_F(FieldCouplingFileTest, BinaryWeightsRoundTripExactly)
+{
+    const auto writer = makeFC("bin-rt", 30, 20);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    fillWeights(writer, 0.4);
+    writer->writeWeights();
+
+    EXPECT_TRUE(fs::exists(tempDir + "/bin-rt_weights.dnfw"));
+    EXPECT_FALSE(fs::exists(tempDir + "/bin-rt_weights.txt"));
+
+    const auto reader = makeFC("bin-rt", 30, 20);
+    reader->setWeightsDirectory(tempDir);
+    EXPECT_EQ(reader->getWeightFileFormat(), WeightFileFormat::TEXT);
+    reader->tryReadWeights();
+    EXPECT_EQ(reader->getWeightFileFormat(), WeightFileFormat::BINARY);
+    const auto& expected = *writer->getComponentPtr("weights");
+    const auto& actual = *reader->getComponentPtr("weights");
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t k = 0; k < expected.size(); ++k)
+        ASSERT_EQ(actual[k], expected[k]) << "at " << k; // text would round to 6 digits
+}
+
+TEST_F(FieldCouplingFileTest, ReadPrefersBinaryAndFallsBackToText)
+{
+    const auto writer = makeFC("prefer", 6, 4);
+    writer->setWeightsDirectory(tempDir);
+    std::ranges::fill(*writer->getComponentPtr("weights"), 1.0);
+    writer->writeWeights();
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    std::ranges::fill(*writer->getComponentPtr("weights"), 2.0);
+    writer->writeWeights();
+
+    const auto reader = makeFC("prefer", 6, 4);
+    reader->setWeightsDirectory(tempDir);
+    reader->readWeights();
+    EXPECT_EQ((*reader->getComponentPtr("weights"))[0], 2.0);
+
+    fs::remove(tempDir + "/prefer_weights.dnfw");
+    reader->readWeights();
+    EXPECT_EQ((*reader->getComponentPtr("weights"))[0], 1.0);
+    EXPECT_EQ(reader->getWeightFileFormat(), WeightFileFormat::TEXT);
+}
+
+TEST_F(FieldCouplingFileTest, WritingTextRemovesStaleBinary)
+{
+    const auto fc = makeFC("stale", 6, 4);
+    fc->setWeightsDirectory(tempDir);
+    fc->setWeightFileFormat(WeightFileFormat::BINARY);
+    fc->writeWeights();
+    ASSERT_TRUE(fs::exists(tempDir + "/stale_weights.dnfw"));
+
+    fc->setWeightFileFormat(WeightFileFormat::TEXT);
+    fc->writeWeights();
+    EXPECT_TRUE(fs::exists(tempDir + "/stale_weights.txt"));
+    EXPECT_FALSE(fs::exists(tempDir + "/stale_weights.dnfw"));
+}
+
+TEST_F(FieldCouplingFileTest, ChecksumIsVerifiedOnlyOnRequest)
+{
+    const auto writer = makeFC("corrupt", 6, 4);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    std::ranges::fill(*writer->getComponentPtr("weights"), 3.0);
+    writer->writeWeights();
+    {
+        std::fstream file(tempDir + "/corrupt_weights.dnfw", std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(tools::weight_file::kHeaderSize));
+        const double other = 4.0;
+        file.write(reinterpret_cast<const char*>(&other), sizeof(other));
+    }
+
+    // By default the payload is not read up front, so the damage goes unseen.
+    const auto reader = makeFC("corrupt", 6, 4);
+    reader->setWeightsDirectory(tempDir);
+    EXPECT_FALSE(reader->getVerifyWeightChecksum());
+    EXPECT_TRUE(reader->readWeights());
+    EXPECT_EQ((*reader->getComponentPtr("weights"))[0], 4.0);
+
+    const auto verifying = makeFC("corrupt", 6, 4);
+    verifying->setWeightsDirectory(tempDir);
+    verifying->setVerifyWeightChecksum(true);
+    EXPECT_FALSE(verifying->readWeights());
+    for (const double w : *verifying->getComponentPtr("weights"))
+        EXPECT_EQ(w, 0.0);
+
+    const auto wrongSize = makeFC("corrupt", 4, 6);
+    wrongSize->setWeightsDirectory(tempDir);
+    EXPECT_FALSE(wrongSize->readWeights());
+    for (const double w : *wrongSize->getComponentPtr("weights"))
+        EXPECT_EQ(w, 0.0);
+}
+
+TEST_F(FieldCouplingFileTest, DenseBinaryWeightsAreMappedNotCopied)
+{
+    const auto writer = makeFC("mapped", 8, 6);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    fillWeights(writer, 0.7);
+    writer->writeWeights();
+    const std::vector<double> saved = writer->getComponentPtr("weights")->toVector();
+
+    auto simulation = std::make_shared<Simulation>("mapped-weights", 1.0, 0.0, 0.0);
+    const auto input = makeField("in", 8);
+    const auto output = makeField("out", 6);
+    const auto reader = makeFC("mapped", 8, 6);
+    simulation->addElement(input);
+    simulation->addElement(output);
+    simulation->addElement(reader);
+    simulation->createInteraction("in", "output", "mapped");
+    simulation->createInteraction("mapped", "output", "out");
+    reader->setWeightsDirectory(tempDir);
+    ASSERT_TRUE(reader->readWeights());
+
+    // The mapping is the storage, and arena packing leaves it there.
+    simulation->init();
+    simulation->step();
+    const ComponentBuffer& weights = *reader->getComponentPtr("weights");
+    EXPECT_TRUE(weights.isExternallyBacked());
+    EXPECT_EQ(weights, saved);
+
+    // Changing the weights never writes the file; writeWeights() replaces it.
+    (*reader->getComponentPtr("weights"))[0] = 9.0;
+    EXPECT_EQ(tools::weight_file::MappedWeightFile(tempDir + "/mapped_weights.dnfw").dense()[0], saved[0]);
+    reader->writeWeights();
+    EXPECT_EQ(tools::weight_file::MappedWeightFile(tempDir + "/mapped_weights.dnfw").dense()[0], 9.0);
+    EXPECT_EQ((*reader->getComponentPtr("weights"))[1], saved[1]);
+
+    ASSERT_TRUE(reader->readWeights());
+    EXPECT_TRUE(reader->getComponentPtr("weights")->isExternallyBacked());
+    reader->clearWeights();
+    EXPECT_FALSE(reader->getComponentPtr("weights")->isExternallyBacked());
+    EXPECT_EQ(reader->getComponentPtr("weights")->size(), saved.size());
+}
+
+TEST_F(FieldCouplingFileTest, WritingBackOverTheMappedFileReleasesIt)
+{
+    const auto writer = makeFC("write-back", 8, 6);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    fillWeights(writer, 0.2);
+    writer->writeWeights();
+
+    // Load, change, save to the same path: the mapping is copied into memory
+    // first, since Windows cannot replace a file while a view of it is mapped.
+    const auto fc = makeFC("write-back", 8, 6);
+    fc->setWeightsDirectory(tempDir);
+    ASSERT_TRUE(fc->readWeights());
+    ASSERT_TRUE(fc->getComponentPtr("weights")->isExternallyBacked());
+    fillWeights(fc, 1.1);
+    const std::vector<double> trained = fc->getComponentPtr("weights")->toVector();
+    fc->writeWeights();
+    EXPECT_FALSE(fc->getComponentPtr("weights")->isExternallyBacked());
+    EXPECT_EQ(fc->getComponentPtr("weights")->toVector(), trained);
+
+    const auto reader = makeFC("write-back", 8, 6);
+    reader->setWeightsDirectory(tempDir);
+    ASSERT_TRUE(reader->readWeights());
+    EXPECT_EQ(reader->getComponentPtr("weights")->toVector(), trained);
+
+    // Saving as text removes the file the weights were mapped from, so the
+    // next load reads the text rather than the stale binary.
+    fillWeights(reader, 2.5);
+    const std::vector<double> retrained = reader->getComponentPtr("weights")->toVector();
+    reader->setWeightFileFormat(WeightFileFormat::TEXT);
+    reader->writeWeights();
+    EXPECT_FALSE(reader->getComponentPtr("weights")->isExternallyBacked());
+    EXPECT_FALSE(fs::exists(tempDir + "/write-back_weights.dnfw"));
+    ASSERT_TRUE(reader->readWeights());
+    EXPECT_EQ(reader->getWeightFileFormat(), WeightFileFormat::TEXT);
+    const auto& reloaded = *reader->getComponentPtr("weights");
+    for (std::size_t k = 0; k < retrained.size(); ++k)
+        EXPECT_NEAR(reloaded[k], retrained[k], 1e-5) << "at " << k;
+}
+
+TEST_F(FieldCouplingFileTest, SavingElsewhereKeepsTheMapping)
+{
+    const auto writer = makeFC("elsewhere", 8, 6);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    fillWeights(writer, 0.3);
+    writer->writeWeights();
+
+    const auto fc = makeFC("elsewhere", 8, 6);
+    fc->setWeightsDirectory(tempDir);
+    ASSERT_TRUE(fc->readWeights());
+    const std::string other = tempDir + "/other";
+    fs::create_directories(other);
+    fc->setWeightsDirectory(other);
+    fc->writeWeights();
+    EXPECT_TRUE(fc->getComponentPtr("weights")->isExternallyBacked());
+    const tools::weight_file::MappedWeightFile saved(other + "/elsewhere_weights.dnfw");
+    EXPECT_TRUE(std::ranges::equal(saved.dense(), *writer->getComponentPtr("weights")));
+
+    fc->releaseWeightsFile();
+    EXPECT_FALSE(fc->getComponentPtr("weights")->isExternallyBacked());
+    EXPECT_EQ(fc->getComponentPtr("weights")->toVector(), writer->getComponentPtr("weights")->toVector());
+}
+
+TEST_F(FieldCouplingFileTest, SparseCouplingWritesCsrThatLoadsIntoEitherStorage)
+{
+    const auto writer = makeFC("bin-sparse", 12, 16);
+    writer->setWeightsDirectory(tempDir);
+    writer->setWeightFileFormat(WeightFileFormat::BINARY);
+    fillWeights(writer, 1.3);
+    const std::vector<double> expected(writer->getComponentPtr("weights")->begin(), writer->getComponentPtr("weights")->end());
+    auto fcp = writer->getParameters();
+    fcp.weightStorage = WeightStorage::SPARSE;
+    writer->setParameters(fcp);
+    writer->writeWeights();
+
+    const tools::weight_file::MappedWeightFile file(tempDir + "/bin-sparse_weights.dnfw");
+    EXPECT_EQ(file.layout(), tools::weight_file::WeightLayout::Csr);
+    EXPECT_EQ(file.header().entries, writer->getSparseWeights().nonZeros());
+
+    const auto denseReader = makeFC("bin-sparse", 12, 16);
+    denseReader->setWeightsDirectory(tempDir);
+    denseReader->readWeights();
+    const auto& actual = *denseReader->getComponentPtr("weights");
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t k = 0; k < expected.size(); ++k)
+        ASSERT_EQ(actual[k], expected[k]) << "at " << k;
+
+    const auto sparseReader = std::make_shared<FieldCoupling>(ElementCommonParameters{ "bin-sparse", 16 }, fcp);
+    sparseReader->setWeightsDirectory(tempDir);
+    sparseReader->readWeights();
+    EXPECT_TRUE(sparseReader->getComponentPtr("weights")->empty());
+    EXPECT_EQ(sparseReader->getSparseWeights().values, writer->getSparseWeights().values);
+}
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <memory>
 #include <numeric>
 
@@ -222,6 +223,76 @@ TEST(GaussFieldCouplingIntegration, StepProducesNonZeroOutputWhenInputIsActive)
     EXPECT_GT(absSum, 0.0);
 }
 
+// ANALYTIC mode against DENSE on the same input, one element of each mode fed
+// by the same field. Couplings near the edges exercise clipping (non-circular)
+// and wrap-around (circular).
+static void expectAnalyticMatchesDense(const bool circular)
+{
+    Simulation sim("gfc-analytic", 1.0, 0.0, 0.0);
+    const auto stim = makeStimulus("stim", 50.0, 100);
+    const auto inputField = makeField("input-field", 100, -5.0);
+
+    const std::vector<GaussCoupling> couplings{
+        { 50.0, 40.0, 3.0, 3.0 }, { 2.0, 97.0, 2.0, 4.0 }, { 95.0, 3.0, 1.5, 2.5 } };
+    const ElementDimensions inputDim{ 100, 1.0 };
+    const auto dense = std::make_shared<GaussFieldCoupling>(ElementCommonParameters{ std::string("dense"), 100 },
+        GaussFieldCouplingParameters{ inputDim, true, circular, couplings, GaussCouplingEvaluation::DENSE });
+    const auto analytic = std::make_shared<GaussFieldCoupling>(ElementCommonParameters{ std::string("analytic"), 100 },
+        GaussFieldCouplingParameters{ inputDim, true, circular, couplings, GaussCouplingEvaluation::ANALYTIC });
+
+    sim.addElement(stim);
+    sim.addElement(inputField);
+    sim.addElement(dense);
+    sim.addElement(analytic);
+    sim.createInteraction("stim", "output", "input-field");
+    sim.createInteraction("input-field", "output", "dense");
+    sim.createInteraction("input-field", "output", "analytic");
+    sim.init();
+    for (int i = 0; i < 20; ++i)
+        sim.step();
+
+    const auto expected = sim.getComponent("dense", "output");
+    const auto got = sim.getComponent("analytic", "output");
+    ASSERT_EQ(got.size(), expected.size());
+    const double peak = *std::ranges::max_element(expected);
+    ASSERT_GT(peak, 0.0);
+    // Only the tails beyond 5 widths (exp(-12.5) of the peak) are dropped.
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        EXPECT_NEAR(got[i], expected[i], 1e-5 * peak) << "at " << i;
+    EXPECT_TRUE(sim.getComponent("analytic", "weights").empty());
+}
+
+TEST(GaussFieldCouplingAnalytic, MatchesDense)
+{
+    expectAnalyticMatchesDense(false);
+}
+
+TEST(GaussFieldCouplingAnalytic, MatchesDenseWhenCircular)
+{
+    expectAnalyticMatchesDense(true);
+}
+
+TEST(GaussFieldCouplingAnalytic, NeverAllocatesWeights)
+{
+    const ElementCommonParameters cp{ std::string("gfc"), 80 };
+    GaussFieldCouplingParameters gfcp{ ElementDimensions{ 100, 1.0 }, false, false,
+        { { 50.0, 40.0, 3.0, 3.0 } }, GaussCouplingEvaluation::ANALYTIC };
+    GaussFieldCoupling gfc(cp, gfcp);
+    EXPECT_EQ(gfc.getComponent("weights").size(), 0u);
+    gfc.init();
+    EXPECT_EQ(gfc.getComponent("weights").size(), 0u);
+    gfc.changeDimensions(ElementDimensions{ 120, 1.0 });
+    EXPECT_EQ(gfc.getComponent("weights").size(), 0u);
+
+    // Switching to DENSE builds the matrix at the current sizes, and back frees it.
+    gfcp.evaluation = GaussCouplingEvaluation::DENSE;
+    gfc.setParameters(gfcp);
+    EXPECT_EQ(gfc.getComponent("weights").size(), 100u * 120u);
+    gfcp.evaluation = GaussCouplingEvaluation::ANALYTIC;
+    gfc.setParameters(gfcp);
+    EXPECT_EQ(gfc.getComponent("weights").size(), 0u);
+}
+
 TEST(GaussFieldCouplingClone, CloneHasSameParameters)
 {
     const ElementCommonParameters cp{ std::string("gfc"), 100 };
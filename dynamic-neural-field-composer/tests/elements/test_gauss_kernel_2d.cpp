@@ -6,7 +6,11 @@
 
 #include "elements/gauss_kernel_2d.h"
 #include "elements/gauss_stimulus_2d.h"
+#include "elements/neural_field_2d.h"
+#include "simulation/simulation.h"
 #include "exceptions/exception.h"
+#include "tools/fft_convolution.h"
+#include "tools/precision.h"
 
 using namespace dnf_composer;
 using namespace dnf_composer::element;
@@ -166,3 +170,40 @@ TEST(GaussKernel2DEdgeCases, OutputNoNaNOrInfAfterMultipleSteps)
     for (double v : gk->getComponent("output"))
         EXPECT_TRUE(std::isfinite(v));
 }
+
+// ---------------------------------------------------------------------------
+// Precision::Single
+// ---------------------------------------------------------------------------
+
+// A kernel whose only input is a NeuralField2D convolves the field's float
+// copy of its output; one with any other input narrows its own. Both must
+// give the same result, on either convolution path.
+TEST(GaussKernel2DSinglePrecision, FieldFloatCopyMatchesNarrowingTheInput)
+{
+    const tools::math::ScopedPrecision precision(tools::math::Precision::Single);
+    for (const auto mode : { tools::math::ConvolutionMode::ForceDirect, tools::math::ConvolutionMode::ForceSpectral })
+    {
+        const tools::math::ScopedConvolutionMode convolution(mode);
+        SCOPED_TRACE(mode == tools::math::ConvolutionMode::ForceDirect ? "direct" : "spectral");
+
+        Simulation sim("single", 1.0, 0.0, 0.0);
+        sim.addElement(std::make_shared<GaussStimulus2D>(makeCP("stim"),
+            GaussStimulus2DParameters{ 3.0, 6.0, 8.0, 12.0, true, false }));
+        sim.addElement(std::make_shared<GaussStimulus2D>(makeCP("zero"),
+            GaussStimulus2DParameters{ 3.0, 0.0, 8.0, 12.0, true, false }));
+        sim.addElement(std::make_shared<NeuralField2D>(makeCP("u"),
+            NeuralField2DParameters{ 5.0, -1.0, SigmoidFunction(0.0, 4.0) }));
+        sim.addElement(std::make_shared<GaussKernel2D>(makeCP("k copy"), makeGKP(2.0, 2.0, -0.01)));
+        sim.addElement(std::make_shared<GaussKernel2D>(makeCP("k narrowed"), makeGKP(2.0, 2.0, -0.01)));
+        sim.createInteraction("stim", "output", "u");
+        sim.createInteraction("u", "output", "k copy");
+        sim.createInteraction("u", "output", "k narrowed");
+        sim.createInteraction("zero", "output", "k narrowed");
+        sim.init();
+        for (int s = 0; s < 10; ++s)
+            sim.step();
+
+        EXPECT_FALSE(std::dynamic_pointer_cast<NeuralField2D>(sim.getElement("u"))->getSingleOutput().empty());
+        EXPECT_EQ(sim.getComponent("k copy", "output"), sim.getComponent("k narrowed", "output"));
+    }
+}
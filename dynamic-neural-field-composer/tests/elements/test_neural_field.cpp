@@ -7,6 +7,7 @@
 #include "elements/neural_field.h"
 #include "elements/activation_function.h"
 #include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
 #include "simulation/simulation.h"
 
 using namespace dnf_composer;
@@ -727,7 +728,7 @@ namespace
         ThrowingCloneFunction() { type = SIGMOID; }
 
         std::vector<double> operator()(const std::vector<double>& input) override { return input; }
-        void apply(const std::vector<double>& input, std::vector<double>& out) const override { out = input; }
+        void apply(std::span<const double> input, std::span<double> out) const override { std::ranges::copy(input, out.begin()); }
         [[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override
         {
             throw std::runtime_error("clone failed");
@@ -756,3 +757,91 @@ TEST(NeuralFieldParametersCopy, FailedCopyAssignmentLeavesDestinationUnchanged)
     EXPECT_DOUBLE_EQ(dest.startingRestingLevel, -2.0);
     EXPECT_EQ(dest.activationFunction.get(), destFunctionBefore);
 }
+
+// ---------------------------------------------------------------------------
+// Fused step
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    /// Forwards to a built-in activation function through a type the fused step
+    /// does not recognise, so a field using it takes the unfused path.
+    template<typename Function>
+    struct UnfusedFunction final : ActivationFunction
+    {
+        Function function;
+
+        explicit UnfusedFunction(const Function& f) : function(f) { type = f.type; }
+
+        std::vector<double> operator()(const std::vector<double>& input) override { return Function(function)(input); }
+        void apply(std::span<const double> input, std::span<double> out) const override { function.apply(input, out); }
+        [[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override
+        {
+            return std::make_unique<UnfusedFunction>(*this);
+        }
+        [[nodiscard]] std::string toString() const override { return function.toString(); }
+        void print() const override {}
+    };
+
+    // 700 cells: two full tiles of the fused step plus a partial one.
+    std::unique_ptr<Simulation> makeFusedStepSimulation(const NeuralFieldParameters& nfp)
+    {
+        constexpr int size = 700;
+        auto sim = std::make_unique<Simulation>("fused step", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "field", size }, nfp));
+        sim->addElement(makeStimulus("stim a", 200.0, 8.0, size));
+        sim->addElement(makeStimulus("stim b", 520.0, 6.0, size));
+        sim->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "kernel", size },
+                                                      GaussKernelParameters{ 4.0, 6.0, -0.2 }));
+        sim->createInteraction("stim a", "output", "field");
+        sim->createInteraction("stim b", "output", "field");
+        sim->createInteraction("field", "output", "kernel");
+        sim->createInteraction("kernel", "output", "field");
+        return sim;
+    }
+
+    template<typename Function>
+    void expectFusedStepMatchesUnfused(const Function& function)
+    {
+        const auto fused = makeFusedStepSimulation(NeuralFieldParameters{ 25.0, -5.0, function });
+        const auto unfused = makeFusedStepSimulation(NeuralFieldParameters{ 25.0, -5.0, UnfusedFunction<Function>{ function } });
+        fused->init();
+        unfused->init();
+
+        for (int i = 0; i < 60; ++i)
+        {
+            fused->step();
+            unfused->step();
+        }
+
+        for (const std::string component : { "input", "activation", "output" }) {
+            EXPECT_EQ(fused->getComponent("field", component), unfused->getComponent("field", component)) << component;
+        }
+
+        const auto a = std::dynamic_pointer_cast<NeuralField>(fused->getElement("field"));
+        const auto b = std::dynamic_pointer_cast<NeuralField>(unfused->getElement("field"));
+        EXPECT_EQ(a->getLowestActivation(), b->getLowestActivation());
+        EXPECT_EQ(a->getHighestActivation(), b->getHighestActivation());
+        EXPECT_EQ(a->isStable(), b->isStable());
+        ASSERT_EQ(a->getBumps().size(), b->getBumps().size());
+        ASSERT_FALSE(a->getBumps().empty());
+        for (std::size_t i = 0; i < a->getBumps().size(); ++i) {
+            EXPECT_EQ(a->getBumps()[i].centroid, b->getBumps()[i].centroid);
+        }
+    }
+}
+
+TEST(NeuralFieldFusedStep, SigmoidMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(SigmoidFunction{ 0.0, 4.0 });
+}
+
+TEST(NeuralFieldFusedStep, HeavisideMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(HeavisideFunction{ 0.0 });
+}
+
+TEST(NeuralFieldFusedStep, AbsSigmoidMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(AbsSigmoidFunction{ 0.0, 4.0 });
+}
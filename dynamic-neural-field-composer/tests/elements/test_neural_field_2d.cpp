@@ -5,7 +5,10 @@
 
 #include "elements/neural_field_2d.h"
 #include "elements/gauss_stimulus_2d.h"
+#include "elements/gauss_kernel_2d.h"
+#include "simulation/simulation.h"
 #include "exceptions/exception.h"
+#include "tools/precision.h"
 
 using namespace dnf_composer;
 using namespace dnf_composer::element;
@@ -417,3 +420,132 @@ TEST(NeuralField2DMetricsToggle, DisabledSkipsStateAndBumps)
     EXPECT_TRUE(nf->getBumps().empty());
     EXPECT_DOUBLE_EQ(nf->getHighestActivation(), 0.0);
 }
+
+// ---------------------------------------------------------------------------
+// Fused step
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    /// See test_neural_field.cpp: hides a built-in activation function from
+    /// the fused step, so the field takes the unfused path.
+    template<typename Function>
+    struct UnfusedFunction final : ActivationFunction
+    {
+        Function function;
+
+        explicit UnfusedFunction(const Function& f) : function(f) { type = f.type; }
+
+        std::vector<double> operator()(const std::vector<double>& input) override { return Function(function)(input); }
+        void apply(std::span<const double> input, std::span<double> out) const override { function.apply(input, out); }
+        [[nodiscard]] std::unique_ptr<ActivationFunction> clone() const override
+        {
+            return std::make_unique<UnfusedFunction>(*this);
+        }
+        [[nodiscard]] std::string toString() const override { return function.toString(); }
+        void print() const override {}
+    };
+
+    // 30x30 = 900 cells: three full tiles of the fused step plus a partial one.
+    std::unique_ptr<Simulation> makeFusedStepSimulation(const NeuralField2DParameters& nfp)
+    {
+        auto sim = std::make_unique<Simulation>("fused step 2d", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<NeuralField2D>(
+            ElementCommonParameters{ "field", ElementDimensions(30, 30, 1.0, 1.0) }, nfp));
+        sim->addElement(makeStim2D("stim a", 8.0, 10.0));
+        sim->addElement(makeStim2D("stim b", 22.0, 19.0, 3.0, 12.0));
+        sim->addElement(std::make_shared<GaussKernel2D>(
+            ElementCommonParameters{ "kernel", ElementDimensions(30, 30, 1.0, 1.0) },
+            GaussKernel2DParameters{ 2.0, 4.0, -0.05 }));
+        sim->createInteraction("stim a", "output", "field");
+        sim->createInteraction("stim b", "output", "field");
+        sim->createInteraction("field", "output", "kernel");
+        sim->createInteraction("kernel", "output", "field");
+        return sim;
+    }
+
+    template<typename Function>
+    void expectFusedStepMatchesUnfused(const Function& function)
+    {
+        const auto fused = makeFusedStepSimulation(NeuralField2DParameters{ 10.0, -5.0, function });
+        const auto unfused = makeFusedStepSimulation(NeuralField2DParameters{ 10.0, -5.0, UnfusedFunction<Function>{ function } });
+        fused->init();
+        unfused->init();
+
+        for (int i = 0; i < 40; ++i)
+        {
+            fused->step();
+            unfused->step();
+        }
+
+        for (const std::string component : { "input", "activation", "output" }) {
+            EXPECT_EQ(fused->getComponent("field", component), unfused->getComponent("field", component)) << component;
+        }
+
+        const auto a = std::dynamic_pointer_cast<NeuralField2D>(fused->getElement("field"));
+        const auto b = std::dynamic_pointer_cast<NeuralField2D>(unfused->getElement("field"));
+        EXPECT_EQ(a->getLowestActivation(), b->getLowestActivation());
+        EXPECT_EQ(a->getHighestActivation(), b->getHighestActivation());
+        EXPECT_EQ(a->isStable(), b->isStable());
+        ASSERT_EQ(a->getBumps().size(), b->getBumps().size());
+        ASSERT_FALSE(a->getBumps().empty());
+        for (std::size_t i = 0; i < a->getBumps().size(); ++i)
+        {
+            EXPECT_EQ(a->getBumps()[i].centroid_x, b->getBumps()[i].centroid_x);
+            EXPECT_EQ(a->getBumps()[i].centroid_y, b->getBumps()[i].centroid_y);
+        }
+    }
+}
+
+TEST(NeuralField2DFusedStep, SigmoidMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(SigmoidFunction{ 0.0, 4.0 });
+}
+
+TEST(NeuralField2DFusedStep, HeavisideMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(HeavisideFunction{ 0.0 });
+}
+
+TEST(NeuralField2DFusedStep, AbsSigmoidMatchesUnfusedBitForBit)
+{
+    expectFusedStepMatchesUnfused(AbsSigmoidFunction{ 0.0, 4.0 });
+}
+
+// ---------------------------------------------------------------------------
+// Precision::Single
+// ---------------------------------------------------------------------------
+
+TEST(NeuralField2DSinglePrecision, KeepsAFloatCopyOfItsOutput)
+{
+    const tools::math::ScopedPrecision precision(tools::math::Precision::Single);
+    auto stim = std::make_shared<GaussStimulus2D>(makeCP("stim"),
+        GaussStimulus2DParameters{ 2.0, 8.0, 5.0, 5.0, true, false });
+    auto nf = std::make_shared<NeuralField2D>(makeCP("nf"), makeNFP(5.0, -1.0));
+    nf->addInput(stim);
+    stim->init();
+    nf->init();
+
+    const auto expectNarrowedOutput = [&nf]
+    {
+        const auto output = nf->getComponent("output");
+        const std::span<const float> copy = nf->getSingleOutput();
+        ASSERT_EQ(copy.size(), output.size());
+        for (std::size_t i = 0; i < output.size(); ++i)
+            ASSERT_EQ(copy[i], static_cast<float>(output[i])) << "at " << i;
+    };
+    expectNarrowedOutput();
+    for (int s = 0; s < 5; ++s)
+    {
+        stim->step(s, 1.0);
+        nf->step(s, 1.0);
+    }
+    expectNarrowedOutput();
+}
+
+TEST(NeuralField2DSinglePrecision, KeepsNoCopyInDoublePrecision)
+{
+    NeuralField2D nf(makeCP("nf"), makeNFP());
+    nf.init();
+    EXPECT_TRUE(nf.getSingleOutput().empty());
+}
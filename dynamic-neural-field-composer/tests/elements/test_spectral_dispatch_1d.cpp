@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "elements/gauss_kernel.h"
+#include "elements/asymmetric_gauss_kernel.h"
+#include "elements/oscillatory_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/correlated_normal_noise.h"
+#include "elements/gauss_stimulus.h"
+#include "tools/fft_convolution.h"
+#include "tools/math.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+using namespace dnf_composer::tools::math;
+
+// ---------------------------------------------------------------------------
+// Direct-vs-spectral differential coverage for the 1D convolution elements,
+// the 1D counterpart of test_spectral_dispatch_2d.cpp. Same open-loop rule:
+// each kernel element is driven for a single step from a fixed stimulus, never
+// through a NeuralField closed loop.
+// ---------------------------------------------------------------------------
+
+namespace {
+    constexpr int N = 2000; // >= kFFTMinSize1D
+
+    std::shared_ptr<GaussStimulus> makeStimulus(int size)
+    {
+        auto stim = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim", size },
+            GaussStimulusParameters{ 20.0, 10.0, size / 3.0, true, false });
+        stim->init();
+        return stim;
+    }
+
+    // Tolerance rationale as in test_spectral_dispatch_2d.cpp.
+    void expectNearlyEqual(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        ASSERT_EQ(a.size(), b.size());
+        double maxAbsDev = 0.0, maxAbsRef = 0.0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            maxAbsDev = std::max(maxAbsDev, std::abs(a[i] - b[i]));
+            maxAbsRef = std::max(maxAbsRef, std::abs(a[i]));
+        }
+        EXPECT_LT(maxAbsDev, 1e-9) << "max abs deviation = " << maxAbsDev;
+        if (maxAbsRef > 0.0)
+            EXPECT_LT(maxAbsDev / maxAbsRef, 1e-10) << "max relative deviation = " << (maxAbsDev / maxAbsRef);
+    }
+
+    void expectBitIdentical(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i)
+            EXPECT_DOUBLE_EQ(a[i], b[i]) << "mismatch at " << i;
+    }
+
+    // Builds a direct and a spectral twin of the same kernel element, both fed
+    // by `stim`, steps each once and returns their outputs.
+    template<typename KernelElement, typename Parameters>
+    std::pair<std::vector<double>, std::vector<double>> stepTwins(
+        const std::shared_ptr<GaussStimulus>& stim, const Parameters& p, int size = N)
+    {
+        std::shared_ptr<KernelElement> direct, spectral;
+        {
+            ScopedConvolutionMode mode(ConvolutionMode::ForceDirect);
+            direct = std::make_shared<KernelElement>(ElementCommonParameters{ "direct", size }, p);
+            direct->addInput(stim);
+            direct->init();
+        }
+        {
+            ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+            spectral = std::make_shared<KernelElement>(ElementCommonParameters{ "spectral", size }, p);
+            spectral->addInput(stim);
+            spectral->init();
+        }
+        direct->step(0.0, 1.0);
+        spectral->step(0.0, 1.0);
+        return { direct->getComponent("output"), spectral->getComponent("output") };
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch rule
+// ---------------------------------------------------------------------------
+
+TEST(SpectralDispatchRule1D, AutoRespectsTapThresholdAndSizeFloor)
+{
+    ScopedConvolutionMode mode(ConvolutionMode::Auto);
+    EXPECT_FALSE(shouldUseSpectral1D(true, kFFTTapThreshold1D, kFFTMinSize1D));
+    EXPECT_TRUE(shouldUseSpectral1D(true, kFFTTapThreshold1D + 1, kFFTMinSize1D));
+    EXPECT_FALSE(shouldUseSpectral1D(true, 1000, kFFTMinSize1D - 1));
+    EXPECT_FALSE(shouldUseSpectral1D(false, 1000, 20000));
+}
+
+TEST(SpectralDispatchRule1D, OverrideAppliesButNeverToNonCircular)
+{
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceDirect);
+        EXPECT_FALSE(shouldUseSpectral1D(true, 1000, 20000));
+    }
+    ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+    EXPECT_TRUE(shouldUseSpectral1D(true, 3, 10));
+    EXPECT_FALSE(shouldUseSpectral1D(false, 1000, 20000));
+}
+
+// ---------------------------------------------------------------------------
+// One differential test per element
+// ---------------------------------------------------------------------------
+
+TEST(SpectralDispatch1D, GaussKernelDirectMatchesSpectral)
+{
+    const auto [direct, spectral] = stepTwins<GaussKernel>(makeStimulus(N),
+        GaussKernelParameters{ 20.0, 2.0, 0.0, true, true });
+    expectNearlyEqual(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, AsymmetricGaussKernelDirectMatchesSpectral)
+{
+    // Non-palindromic taps: the case that catches a reversed wrap embedding.
+    const auto [direct, spectral] = stepTwins<AsymmetricGaussKernel>(makeStimulus(N),
+        AsymmetricGaussKernelParameters{ 20.0, 2.0, 0.0, 1.5, true, true });
+    expectNearlyEqual(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, OscillatoryKernelDirectMatchesSpectral)
+{
+    const auto [direct, spectral] = stepTwins<OscillatoryKernel>(makeStimulus(N),
+        OscillatoryKernelParameters{ 1.0, 0.02, 0.3, 0.0, true, true });
+    expectNearlyEqual(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, MexicanHatKernelDirectMatchesSpectral)
+{
+    const auto [direct, spectral] = stepTwins<MexicanHatKernel>(makeStimulus(N),
+        MexicanHatKernelParameters{ 10.0, 11.0, 40.0, 15.0, 0.0, true, true });
+    expectNearlyEqual(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, GlobalOffsetIdenticalOnBothPaths)
+{
+    const auto [direct, spectral] = stepTwins<MexicanHatKernel>(makeStimulus(N),
+        MexicanHatKernelParameters{ 10.0, 11.0, 40.0, 15.0, -0.05, true, true });
+    expectNearlyEqual(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, CorrelatedNormalNoiseDirectMatchesSpectral)
+{
+    // Re-seed before each step so both paths convolve the same white noise.
+    const CorrelatedNormalNoiseParameters p{ 1.0, 15.0, true };
+
+    std::shared_ptr<CorrelatedNormalNoise> direct, spectral;
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceDirect);
+        direct = std::make_shared<CorrelatedNormalNoise>(ElementCommonParameters{ "cnn_direct", N }, p);
+        direct->init();
+    }
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+        spectral = std::make_shared<CorrelatedNormalNoise>(ElementCommonParameters{ "cnn_spectral", N }, p);
+        spectral->init();
+    }
+
+    seedNormal(2024);
+    direct->step(0.0, 1.0);
+    seedNormal(2024);
+    spectral->step(0.0, 1.0);
+
+    expectNearlyEqual(direct->getComponent("output"), spectral->getComponent("output"));
+}
+
+// ---------------------------------------------------------------------------
+// Cross-cutting cases
+// ---------------------------------------------------------------------------
+
+TEST(SpectralDispatch1D, NonCircularUnderForceSpectralStaysDirect)
+{
+    const auto [direct, spectral] = stepTwins<GaussKernel>(makeStimulus(N),
+        GaussKernelParameters{ 20.0, 2.0, 0.0, /*circular=*/false, true });
+    expectBitIdentical(direct, spectral);
+}
+
+TEST(SpectralDispatch1D, KernelWiderThanTheFieldAliasesLikeTheDirectPath)
+{
+    // A correlation width of 15 gives 151 taps on a 100-sample field, so
+    // offsets 100 apart land on the same sample in the direct path's extended
+    // index. The wrap embedding must sum them the same way.
+    const CorrelatedNormalNoiseParameters p{ 1.0, 15.0, true };
+
+    std::shared_ptr<CorrelatedNormalNoise> direct, spectral;
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceDirect);
+        direct = std::make_shared<CorrelatedNormalNoise>(ElementCommonParameters{ "cnn_direct", 100 }, p);
+        direct->init();
+    }
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+        spectral = std::make_shared<CorrelatedNormalNoise>(ElementCommonParameters{ "cnn_spectral", 100 }, p);
+        spectral->init();
+    }
+
+    seedNormal(7);
+    direct->step(0.0, 1.0);
+    seedNormal(7);
+    spectral->step(0.0, 1.0);
+
+    expectNearlyEqual(direct->getComponent("output"), spectral->getComponent("output"));
+}
+
+TEST(SpectralDispatch1DRuntime, WidthIncreaseFlipsToSpectralAndMatchesSpectralTwin)
+{
+    auto stim = makeStimulus(N);
+    auto gk = std::make_shared<GaussKernel>(ElementCommonParameters{ "gk_grow", N },
+        GaussKernelParameters{ 2.0, 2.0, 0.0, true, true });
+    gk->addInput(stim);
+    gk->init(); // 21 taps: Auto picks direct
+
+    const GaussKernelParameters wide{ 20.0, 2.0, 0.0, true, true };
+    gk->setParameters(wide); // ~200 taps at N=2000: Auto flips to spectral
+    gk->step(0.0, 1.0);
+
+    // Bit-identical to a ForceSpectral twin only if Auto took the same branch.
+    std::shared_ptr<GaussKernel> twin;
+    {
+        ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+        twin = std::make_shared<GaussKernel>(ElementCommonParameters{ "gk_twin", N }, wide);
+        twin->addInput(stim);
+        twin->init();
+    }
+    twin->step(0.0, 1.0);
+
+    expectBitIdentical(gk->getComponent("output"), twin->getComponent("output"));
+}
+
+TEST(SpectralDispatch1DRuntime, RepeatedSetParametersSameSizeStaysCorrect)
+{
+    // Same size every time, so SpectralConvolver1D::init() keeps its plans:
+    // fails if setKernel() were skipped along with the re-plan.
+    auto stim = makeStimulus(N);
+    auto gk = std::make_shared<GaussKernel>(ElementCommonParameters{ "gk_repeat", N },
+        GaussKernelParameters{ 20.0, 2.0, 0.0, true, true });
+    gk->addInput(stim);
+    gk->init();
+
+    for (const double w : { 20.0, 25.0, 22.5, 30.0 })
+    {
+        SCOPED_TRACE(::testing::Message() << "width=" << w);
+        const GaussKernelParameters p{ w, 2.0, 0.0, true, true };
+        gk->setParameters(p);
+        gk->step(0.0, 1.0);
+
+        auto fresh = std::make_shared<GaussKernel>(ElementCommonParameters{ "gk_fresh", N }, p);
+        fresh->addInput(stim);
+        fresh->init();
+        fresh->step(0.0, 1.0);
+
+        expectBitIdentical(gk->getComponent("output"), fresh->getComponent("output"));
+    }
+}
+
+TEST(SpectralDispatch1DRuntime, ClonedSpectralKernelMatchesOriginal)
+{
+    auto stim = makeStimulus(N);
+    ScopedConvolutionMode mode(ConvolutionMode::ForceSpectral);
+    auto gk = std::make_shared<GaussKernel>(ElementCommonParameters{ "gk_clone", N },
+        GaussKernelParameters{ 20.0, 2.0, 0.0, true, true });
+    gk->addInput(stim);
+    gk->init();
+
+    const auto copy = gk->clone();
+    gk->step(0.0, 1.0);
+    copy->step(0.0, 1.0);
+    expectBitIdentical(gk->getComponent("output"), copy->getComponent("output"));
+}
@@ -0,0 +1,239 @@
+// ----------------------------------------------------------------------------
+//  Golden test — composed architectures in UpdateMode::Synchronous
+//
+//  The same five architectures as test_golden_architectures.cpp (identical
+//  elements and parameters), run with Jacobi-style double-buffered updates:
+//  every element reads the previous step's published "output"/"activation".
+//  Each trajectory is frozen as <slug>_sync.csv, and then re-checked against
+//  that same CSV with the elements registered in REVERSE order and stepped on
+//  four threads -- the two properties the mode exists for. Under the default
+//  sequential mode a reversed registry produces a different trajectory.
+//
+//  Architecture A (stimulus -> field, no feedback) reads a constant stimulus,
+//  so both modes coincide there and it is additionally checked against the
+//  existing sequential golden CSVs.
+// ----------------------------------------------------------------------------
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "elements/neural_field.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/gauss_field_coupling.h"
+#include "elements/memory_trace.h"
+#include "simulation/simulation.h"
+#include "../golden/golden_test_utils.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+namespace g = dnf_composer::golden;
+
+namespace
+{
+    using Targets = std::vector<std::pair<std::string, std::string>>;
+
+    struct RunOptions
+    {
+        bool reversed = false;  // register elements in reverse construction order
+        int threads = 1;
+    };
+
+    std::shared_ptr<NeuralField> makeField(const std::string& name)
+    {
+        const SigmoidFunction sf(0.0, 10.0);
+        const NeuralFieldParameters nfp(25.0, -5.0, sf);
+        return std::make_shared<NeuralField>(ElementCommonParameters(name, 100), nfp);
+    }
+
+    std::shared_ptr<GaussStimulus> makeStimulus(const std::string& name, double amplitude, double position)
+    {
+        const GaussStimulusParameters gsp(5.0, amplitude, position, true, false);
+        return std::make_shared<GaussStimulus>(ElementCommonParameters(name, 100), gsp);
+    }
+
+    // Register `elements` (in construction order, or reversed), wire `links`
+    // (source, component, destination), and switch to the synchronous mode.
+    std::shared_ptr<Simulation> assemble(const std::string& slug,
+                                         std::vector<std::shared_ptr<Element>> elements,
+                                         const std::vector<std::tuple<std::string, std::string, std::string>>& links,
+                                         const RunOptions& options)
+    {
+        auto sim = createSimulation(slug, 1.0);
+        sim->setUpdateMode(UpdateMode::Synchronous);
+        sim->setThreadCount(options.threads);
+        if (options.reversed)
+            std::reverse(elements.begin(), elements.end());
+        for (const auto& e : elements)
+            sim->addElement(e);
+        for (const auto& [source, component, destination] : links)
+            sim->createInteraction(source, component, destination);
+        sim->init();
+        return sim;
+    }
+
+    g::Grid captureMulti(Simulation& sim, const Targets& targets, int steps)
+    {
+        g::Grid traj;
+        traj.reserve(static_cast<std::size_t>(steps));
+        for (int i = 0; i < steps; ++i)
+        {
+            sim.step();
+            g::Row row;
+            for (const auto& [name, comp] : targets)
+            {
+                const auto v = sim.getElement(name)->getComponent(comp);
+                row.insert(row.end(), v.begin(), v.end());
+            }
+            traj.push_back(std::move(row));
+        }
+        return traj;
+    }
+
+    // A. field + Gauss stimulus
+    g::Grid runFieldStimulus(const std::string& slug, double amplitude, const RunOptions& o)
+    {
+        auto sim = assemble(slug,
+            { makeField(slug + "_field"), makeStimulus(slug + "_stim", amplitude, 50.0) },
+            { { slug + "_stim", "output", slug + "_field" } }, o);
+        return captureMulti(*sim, { { slug + "_field", "activation" } }, 60);
+    }
+
+    // B. field + self-excitation Gauss kernel
+    g::Grid runSelfExcitation(const std::string& slug, const RunOptions& o)
+    {
+        const GaussKernelParameters gkp(5.0, 8.0, -0.005, true, false);
+        auto sim = assemble(slug,
+            { makeField(slug + "_field"), makeStimulus(slug + "_stim", 10.0, 50.0),
+              std::make_shared<GaussKernel>(ElementCommonParameters(slug + "_kernel", 100), gkp) },
+            { { slug + "_stim", "output", slug + "_field" },
+              { slug + "_field", "output", slug + "_kernel" },
+              { slug + "_kernel", "output", slug + "_field" } }, o);
+        return captureMulti(*sim, { { slug + "_field", "activation" } }, 150);
+    }
+
+    // C. field + Mexican-hat kernel, two competing stimuli
+    g::Grid runMexicanHatSelection(const std::string& slug, const RunOptions& o)
+    {
+        const MexicanHatKernelParameters mhkp(3.0, 10.0, 8.0, 6.0, -0.02, true, false);
+        auto sim = assemble(slug,
+            { makeField(slug + "_field"), makeStimulus(slug + "_stimA", 10.0, 30.0),
+              makeStimulus(slug + "_stimB", 6.0, 70.0),
+              std::make_shared<MexicanHatKernel>(ElementCommonParameters(slug + "_kernel", 100), mhkp) },
+            { { slug + "_stimA", "output", slug + "_field" },
+              { slug + "_stimB", "output", slug + "_field" },
+              { slug + "_field", "output", slug + "_kernel" },
+              { slug + "_kernel", "output", slug + "_field" } }, o);
+        return captureMulti(*sim, { { slug + "_field", "activation" } }, 200);
+    }
+
+    // D. two fields coupled via GaussFieldCoupling
+    g::Grid runGaussCoupling(const std::string& slug, const RunOptions& o)
+    {
+        ElementDimensions inputDims(100, 1.0);
+        GaussFieldCouplingParameters gfcp(inputDims, false, true, {});
+        gfcp.addCoupling(GaussCoupling(30.0, 30.0, 6.0, 4.0));
+        gfcp.addCoupling(GaussCoupling(50.0, 50.0, 6.0, 4.0));
+        gfcp.addCoupling(GaussCoupling(70.0, 70.0, 6.0, 4.0));
+        auto sim = assemble(slug,
+            { makeField(slug + "_fieldA"), makeStimulus(slug + "_stim", 10.0, 30.0),
+              makeField(slug + "_fieldB"),
+              std::make_shared<GaussFieldCoupling>(ElementCommonParameters(slug + "_coupling", 100), gfcp) },
+            { { slug + "_stim", "output", slug + "_fieldA" },
+              { slug + "_fieldA", "output", slug + "_coupling" },
+              { slug + "_coupling", "output", slug + "_fieldB" } }, o);
+        return captureMulti(*sim,
+            { { slug + "_fieldA", "activation" }, { slug + "_fieldB", "activation" } }, 80);
+    }
+
+    // E. memory trace driven by a field, stimulus switched off after 40 steps
+    g::Grid runMemoryTrace(const std::string& slug, const RunOptions& o)
+    {
+        const MemoryTraceParameters mtp(50.0, 400.0, 0.5);
+        const auto stim = makeStimulus(slug + "_stim", 10.0, 50.0);
+        auto sim = assemble(slug,
+            { makeField(slug + "_field"), stim,
+              std::make_shared<MemoryTrace>(ElementCommonParameters(slug + "_trace", 100), mtp) },
+            { { slug + "_stim", "output", slug + "_field" },
+              { slug + "_field", "output", slug + "_trace" } }, o);
+        const Targets targets = { { slug + "_field", "activation" }, { slug + "_trace", "output" } };
+        g::Grid traj = captureMulti(*sim, targets, 40);
+        stim->setParameters(GaussStimulusParameters(5.0, 0.0, 50.0, true, false));
+        const g::Grid trajOff = captureMulti(*sim, targets, 60);
+        traj.insert(traj.end(), trajOff.begin(), trajOff.end());
+        return traj;
+    }
+
+    // Freeze the forward/serial run, then require the reversed and the
+    // multi-threaded runs to reproduce that same golden.
+    template <typename Run>
+    void checkSynchronousGolden(const std::string& goldenName, Run&& run)
+    {
+        g::checkCharacterization(goldenName, run(RunOptions{ false, 1 }));
+        EXPECT_TRUE(g::gridNear(run(RunOptions{ true, 1 }), g::readCsv(goldenName), g::kTol,
+                                goldenName + " [reversed registry]"));
+        EXPECT_TRUE(g::gridNear(run(RunOptions{ false, 4 }), g::readCsv(goldenName), g::kTol,
+                                goldenName + " [4 threads]"));
+    }
+}
+
+TEST(GoldenSynchronous, FieldPlusGaussStimulusMatchesSequentialGolden)
+{
+    struct Regime { std::string slug; double amplitude; };
+    const std::vector<Regime> regimes = {
+        { "arch_field_stimulus_subthreshold",   2.0 },
+        { "arch_field_stimulus_suprathreshold", 12.0 },
+    };
+    for (const auto& r : regimes)
+    {
+        // No feedback and a constant source: Jacobi and Gauss-Seidel agree, so
+        // the sequential mode's frozen CSV is the golden here too.
+        ASSERT_TRUE(g::fileExists(g::csvPath(r.slug))) << r.slug;
+        const g::Grid sequentialGolden = g::readCsv(r.slug);
+        for (const RunOptions o : { RunOptions{ false, 1 }, RunOptions{ true, 1 }, RunOptions{ false, 4 } })
+        {
+            EXPECT_TRUE(g::gridNear(runFieldStimulus(r.slug, r.amplitude, o), sequentialGolden, g::kTol,
+                                    r.slug + " [synchronous]"));
+        }
+    }
+}
+
+TEST(GoldenSynchronous, FieldSelfExcitationStableBump)
+{
+    const std::string slug = "arch_field_self_excitation_stable_bump";
+    checkSynchronousGolden(slug + "_sync", [&](const RunOptions& o) { return runSelfExcitation(slug, o); });
+}
+
+TEST(GoldenSynchronous, FieldMexicanHatSelection)
+{
+    const std::string slug = "arch_field_mexican_hat_selection";
+    checkSynchronousGolden(slug + "_sync", [&](const RunOptions& o) { return runMexicanHatSelection(slug, o); });
+}
+
+TEST(GoldenSynchronous, TwoFieldsCoupledViaGaussFieldCoupling)
+{
+    const std::string slug = "arch_two_fields_gauss_coupling";
+    checkSynchronousGolden(slug + "_sync", [&](const RunOptions& o) { return runGaussCoupling(slug, o); });
+}
+
+TEST(GoldenSynchronous, FieldDrivenMemoryTraceFormation)
+{
+    const std::string slug = "arch_field_memory_trace_formation";
+    checkSynchronousGolden(slug + "_sync", [&](const RunOptions& o) { return runMemoryTrace(slug, o); });
+}
+
+TEST(GoldenSynchronous, DiffersFromSequentialWhereFeedbackExists)
+{
+    // Guard against the mode silently degrading to sequential: with a lateral
+    // kernel in the loop, the two semantics must produce different trajectories.
+    const std::string slug = "arch_field_self_excitation_stable_bump";
+    const g::Grid sync = runSelfExcitation(slug, RunOptions{});
+    const g::Grid sequential = g::readCsv(slug);
+    ASSERT_EQ(sync.size(), sequential.size());
+    EXPECT_FALSE(g::gridNear(sync, sequential, g::kTol, slug));
+}
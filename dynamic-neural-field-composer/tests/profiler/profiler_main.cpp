@@ -11,7 +11,14 @@
 // Granularity is per element step() (no library instrumentation). Manual perf
 // run, NOT a unit test.
 //
-// Usage: dnf_composer_profiler [iterations]   (default 20000)
+// Usage: dnf_composer_profiler [iterations] [--counters]   (default 20000)
+//
+// --counters: after each timing pass, a second pass counts cycles, instructions,
+// L1D/LLC misses and branch misses per element step() through Linux
+// perf_event_open (perf_counters.h), and the session gains a table of them per
+// element type and grid size. The timing pass itself is never counted. Where
+// counters are unavailable (not Linux, a container, perf_event_paranoid) the
+// table is replaced by the reason and everything else runs as usual.
 //
 // --deck / --decks: profile an arbitrary committed simulation's per-element breakdown
 // instead of the hardcoded detection sims above, and write JSON (no profile.md append).
@@ -21,10 +28,13 @@
 //
 //   dnf_composer_profiler --deck <path/to/sim.json> [--iters N] [--json <out.json>]
 //   dnf_composer_profiler --decks <manifest.json>   [--iters N] [--json <out.json>]
+//
+// --counters works here too: each element in the JSON gains a "counters" object.
 
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <ctime>
 #include <filesystem>
@@ -32,6 +42,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "simulation/simulation.h"
@@ -39,6 +50,7 @@
 #include "tools/logger.h"
 
 #include "bench_env.h"
+#include "perf_counters.h"
 
 #include "elements/neural_field.h"
 #include "elements/gauss_stimulus.h"
@@ -108,11 +120,46 @@ Stats timeCalls(F&& fn, int iters)
 // under test, returns {sim, elementToTime}. We init() the sim, warm up, then
 // time only the element-under-test's step().
 
-struct TypeResult { std::string name; Stats stats; bool ok; std::string note; };
+struct TypeResult
+{
+	std::string name; Stats stats; bool ok; std::string note;
+	std::string grid; perf_counters::Counts counters; // per step(); counters only with --counters
+};
 
 ElementDimensions dims1d() { return ElementDimensions(SIZE_1D, 1.0); }
 ElementDimensions dims2d() { return ElementDimensions(GRID_2D, GRID_2D, 1.0, 1.0); }
 
+// "100" for a 1D element, "50x50" for a 2D one.
+std::string gridOf(const Element& e)
+{
+	const ElementDimensions d = e.getElementCommonParameters().dimensionParameters;
+	return d.dimensionality == 2 ? std::to_string(d.size_x) + "x" + std::to_string(d.size_y)
+	                             : std::to_string(d.size);
+}
+
+// Counts `iters` calls of step() on each of `elements`, interleaved the way the
+// timing loops run them, one counter group per element; t advances by tStep per
+// iteration. Per step, with the cost of an empty enable/disable window subtracted.
+std::vector<perf_counters::Counts> countSteps(const std::vector<Element*>& elements, double t, double tStep, int iters)
+{
+	std::vector<perf_counters::CounterGroup> groups(elements.size());
+	for (int it = 0; it < iters; ++it)
+	{
+		t += tStep;
+		for (size_t e = 0; e < elements.size(); ++e)
+		{
+			groups[e].enable();
+			elements[e]->step(t, 25.0);
+			groups[e].disable();
+		}
+	}
+	const auto overhead = perf_counters::CounterGroup::calibrate();
+	std::vector<perf_counters::Counts> out;
+	for (const auto& g : groups)
+		out.push_back(g.read().perWindow(overhead));
+	return out;
+}
+
 // Build a source NeuralField of the given dims with a stimulus so its output is
 // non-trivial, returning the source element (already added to sim).
 std::shared_ptr<Element> add1dSource(const std::shared_ptr<Simulation>& sim, const std::string& nm)
@@ -139,7 +186,7 @@ std::shared_ptr<Element> add2dSource(const std::shared_ptr<Simulation>& sim, con
 // Run one type entry: build, init, warm, time the target's step().
 TypeResult runType(const std::string& name,
                    const std::function<std::pair<std::shared_ptr<Simulation>, std::shared_ptr<Element>>()>& build,
-                   int iters)
+                   int iters, bool counters)
 {
 	try
 	{
@@ -148,18 +195,21 @@ TypeResult runType(const std::string& name,
 		for (int i = 0; i < 200; ++i) sim->step();
 		Element* e = target.get();
 		const Stats s = timeCalls([&] { e->step(0.0, 25.0); }, iters);
-		return { name, s, true, "" };
+		TypeResult r{ name, s, true, "", gridOf(*e), {} };
+		if (counters)
+			r.counters = countSteps({ e }, 0.0, 0.0, iters)[0]; // same fixed t as the timing loop
+		return r;
 	}
-	catch (const std::exception& ex) { return { name, {}, false, ex.what() }; }
-	catch (...)                      { return { name, {}, false, "unknown exception" }; }
+	catch (const std::exception& ex) { return { name, {}, false, ex.what(), "", {} }; }
+	catch (...)                      { return { name, {}, false, "unknown exception", "", {} }; }
 }
 
-std::vector<TypeResult> sweepTypes(int iters)
+std::vector<TypeResult> sweepTypes(int iters, bool counters)
 {
 	std::vector<TypeResult> out;
 	auto add = [&](const std::string& nm,
 	               std::function<std::pair<std::shared_ptr<Simulation>, std::shared_ptr<Element>>()> b)
-	{ out.push_back(runType(nm, b, iters)); };
+	{ out.push_back(runType(nm, b, iters, counters)); };
 
 	// Helper macros-as-lambdas: a sim with a source feeding `target`.
 	auto with1dSource = [](std::function<std::shared_ptr<Element>(const ElementDimensions&)> makeTarget) {
@@ -277,7 +327,11 @@ std::vector<TypeResult> sweepTypes(int iters)
 }
 
 // ── Section 2: representative sim, per-instance breakdown ───────────────────
-struct InstanceResult { std::string label; std::string type; double mean_us; };
+struct InstanceResult
+{
+	std::string label; std::string type; double mean_us;
+	std::string grid; perf_counters::Counts counters; // per step(); counters only with --counters
+};
 
 std::shared_ptr<Simulation> buildDetection1d()
 {
@@ -310,7 +364,7 @@ std::shared_ptr<Simulation> buildDetection2d()
 
 const char* labelName(ElementLabel l); // fwd
 
-std::vector<InstanceResult> profileSim(const std::shared_ptr<Simulation>& sim, int iters)
+std::vector<InstanceResult> profileSim(const std::shared_ptr<Simulation>& sim, int iters, bool counters = false)
 {
 	sim->init();
 	for (int i = 0; i < 200; ++i) sim->step();
@@ -331,7 +385,16 @@ std::vector<InstanceResult> profileSim(const std::shared_ptr<Simulation>& sim, i
 	}
 	std::vector<InstanceResult> out;
 	for (size_t e = 0; e < elems.size(); ++e)
-		out.push_back({ elems[e]->getUniqueName(), labelName(elems[e]->getLabel()), totals[e] / iters });
+		out.push_back({ elems[e]->getUniqueName(), labelName(elems[e]->getLabel()), totals[e] / iters,
+		                gridOf(*elems[e]), {} });
+	if (counters)
+	{
+		std::vector<Element*> raw;
+		for (const auto& e : elems) raw.push_back(e.get());
+		const auto counts = countSteps(raw, t, 25.0, iters);
+		for (size_t e = 0; e < elems.size(); ++e)
+			out[e].counters = counts[e];
+	}
 	return out;
 }
 
@@ -462,12 +525,19 @@ std::vector<MicroResult> microPrimitives(int grid, int iters)
 
 const char* labelName(ElementLabel l)
 {
+	// Same names as the Section 1 sweep, so hardware counters group across sections.
 	switch (l)
 	{
 	case ElementLabel::NEURAL_FIELD: return "NeuralField";
 	case ElementLabel::NEURAL_FIELD_2D: return "NeuralField2D";
 	case ElementLabel::GAUSS_KERNEL: return "GaussKernel";
 	case ElementLabel::GAUSS_KERNEL_2D: return "GaussKernel2D";
+	case ElementLabel::MEXICAN_HAT_KERNEL: return "MexicanHatKernel";
+	case ElementLabel::MEXICAN_HAT_KERNEL_2D: return "MexicanHatKernel2D";
+	case ElementLabel::OSCILLATORY_KERNEL: return "OscillatoryKernel";
+	case ElementLabel::OSCILLATORY_KERNEL_2D: return "OscillatoryKernel2D";
+	case ElementLabel::ASYMMETRIC_GAUSS_KERNEL: return "AsymmetricGaussKernel";
+	case ElementLabel::ASYMMETRIC_GAUSS_KERNEL_2D: return "AsymmetricGaussKernel2D";
 	case ElementLabel::GAUSS_STIMULUS: return "GaussStimulus";
 	case ElementLabel::GAUSS_STIMULUS_2D: return "GaussStimulus2D";
 	case ElementLabel::NORMAL_NOISE: return "NormalNoise";
@@ -513,6 +583,47 @@ std::string filenameTimestamp()
 #define PROFILER_JSON_DIR "results"
 #endif
 
+// ── Hardware counters: per element type and grid size ───────────────────────
+
+// Counter totals over every counted step() of one element type at one grid size,
+// across all sections of a session.
+struct CounterRow { std::string type, grid; perf_counters::Counts total; };
+
+void addCounters(std::vector<CounterRow>& rows, const std::string& type, const std::string& grid,
+                 const perf_counters::Counts& perStep, int steps)
+{
+	perf_counters::Counts total = perStep;
+	for (double& v : total.values) v *= steps;
+	total.windows = static_cast<std::uint64_t>(steps);
+	const auto it = std::find_if(rows.begin(), rows.end(),
+		[&](const CounterRow& r) { return r.type == type && r.grid == grid; });
+	if (it == rows.end())
+		rows.push_back({ type, grid, total });
+	else
+		it->total += total;
+}
+
+std::string counterCell(const perf_counters::Counts& c, perf_counters::Counter counter)
+{
+	if (!c.has(counter)) return "n/a";
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%.0f", c[counter]);
+	return buf;
+}
+
+nlohmann::json countersToJson(const perf_counters::Counts& c)
+{
+	using namespace perf_counters;
+	nlohmann::json j = nlohmann::json::object();
+	const std::pair<Counter, const char*> keys[] = {
+		{ Cycles, "cycles" }, { Instructions, "instructions" }, { L1dMisses, "l1d_misses" },
+		{ LlcMisses, "llc_misses" }, { BranchMisses, "branch_misses" } };
+	for (const auto& [counter, key] : keys)
+		if (c.has(counter)) j[key] = c[counter];
+	if (c.has(Cycles) && c.has(Instructions)) j["ipc"] = c.ipc();
+	return j;
+}
+
 // ── --deck / --decks: arbitrary-deck per-element breakdown, JSON output ─────────────
 
 struct DeckModeSpec { std::string tier, path, architecture; };
@@ -545,20 +656,25 @@ std::shared_ptr<Simulation> loadDeckForProfiling(const std::filesystem::path& js
 // element, so "8% slower" from dnf_composer_deckbench --check narrows to a specific
 // element without adding any timing mechanism this file didn't already have.
 nlohmann::json profileDeckToJson(const std::filesystem::path& jsonPath, const std::string& tier,
-                                  const std::string& architecture, int iters)
+                                  const std::string& architecture, int iters, bool counters)
 {
-	const auto instances = profileSim(loadDeckForProfiling(jsonPath), iters);
+	const auto instances = profileSim(loadDeckForProfiling(jsonPath), iters, counters);
 	double total = 0.0;
 	for (const auto& r : instances) total += r.mean_us;
 
 	auto elements = nlohmann::json::array();
 	for (const auto& r : instances)
-		elements.push_back({
+	{
+		nlohmann::json element{
 			{"name", r.label},
 			{"type", r.type},
 			{"mean_us", r.mean_us},
 			{"share_pct", total > 0.0 ? 100.0 * r.mean_us / total : 0.0},
-		});
+		};
+		if (counters)
+			element["counters"] = countersToJson(r.counters);
+		elements.push_back(std::move(element));
+	}
 
 	return nlohmann::json{
 		{"tier", tier},
@@ -578,7 +694,7 @@ void printDeckBreakdown(const nlohmann::json& entry)
 }
 
 int runDeckMode(const std::string& deckArg, const std::string& decksArg, int iters,
-                 const std::string& jsonArg)
+                 const std::string& jsonArg, bool counters)
 {
 	auto decksOut = nlohmann::json::array();
 
@@ -588,7 +704,7 @@ int runDeckMode(const std::string& deckArg, const std::string& decksArg, int ite
 		std::printf("Profiling deck: %s\n", p.string().c_str());
 		try
 		{
-			auto entry = profileDeckToJson(p, "manual", "unknown", iters);
+			auto entry = profileDeckToJson(p, "manual", "unknown", iters, counters);
 			printDeckBreakdown(entry);
 			decksOut.push_back(std::move(entry));
 		}
@@ -622,7 +738,7 @@ int runDeckMode(const std::string& deckArg, const std::string& decksArg, int ite
 			std::printf("\n%s (%s):\n", spec.tier.c_str(), spec.path.c_str());
 			try
 			{
-				auto entry = profileDeckToJson(fullPath, spec.tier, spec.architecture, iters);
+				auto entry = profileDeckToJson(fullPath, spec.tier, spec.architecture, iters, counters);
 				printDeckBreakdown(entry);
 				decksOut.push_back(std::move(entry));
 			}
@@ -639,7 +755,7 @@ int runDeckMode(const std::string& deckArg, const std::string& decksArg, int ite
 	out["schema"]      = 1;
 	out["fingerprint"] = bench_env::fingerprint(env);
 	out["env"]         = bench_env::to_json(env);
-	out["config"]      = nlohmann::json{ {"iters", iters} };
+	out["config"]      = nlohmann::json{ {"iters", iters}, {"counters", counters} };
 	out["decks"]       = decksOut;
 
 	std::filesystem::path jsonPath;
@@ -677,7 +793,9 @@ int main(int argc, char* argv[])
 	// [iterations] argument below is even looked at.
 	std::string deckArg, decksArg, jsonArg;
 	int deckIters = 5000;
+	int iters = 20000;
 	bool deckMode = false;
+	bool counters = false;
 	for (int i = 1; i < argc; ++i)
 	{
 		const std::string a = argv[i];
@@ -685,17 +803,44 @@ int main(int argc, char* argv[])
 		else if (a == "--decks" && i + 1 < argc) { decksArg = argv[++i]; deckMode = true; }
 		else if (a == "--iters" && i + 1 < argc) { deckIters = std::stoi(argv[++i]); }
 		else if (a == "--json" && i + 1 < argc)  { jsonArg  = argv[++i]; }
+		else if (a == "--counters")              { counters = true; }
+		else if (a.rfind("--", 0) != 0)          { iters = std::stoi(a); }
 	}
-	if (deckMode)
-		return runDeckMode(deckArg, decksArg, deckIters, jsonArg);
 
-	const int iters = (argc > 1) ? std::stoi(argv[1]) : 20000;
+	// Opened once up front so an unavailable PMU is reported before any timing runs.
+	std::string countersNote;
+	if (counters)
+	{
+		const perf_counters::CounterGroup probe;
+		if (!probe.available())
+		{
+			std::fprintf(stderr, "Hardware counters unavailable: %s\n", probe.reason().c_str());
+			countersNote = "_Hardware counters unavailable: " + probe.reason() + "._";
+			counters = false;
+		}
+		else if (!probe.reason().empty())
+		{
+			std::fprintf(stderr, "Some hardware counters unavailable: %s\n", probe.reason().c_str());
+			countersNote = "_Not counted: " + probe.reason() + "._";
+		}
+	}
 
-	std::printf("dnf_composer profiler  (%d iterations)\n", iters);
+	if (deckMode)
+		return runDeckMode(deckArg, decksArg, deckIters, jsonArg, counters);
 
-	const auto types = sweepTypes(iters);
-	const auto sim1d = profileSim(buildDetection1d(), iters);
-	const auto sim2d = profileSim(buildDetection2d(), iters);
+	std::printf("dnf_composer profiler  (%d iterations%s)\n", iters, counters ? ", hardware counters" : "");
+
+	std::vector<CounterRow> counterRows;
+	const auto types = sweepTypes(iters, counters);
+	const auto sim1d = profileSim(buildDetection1d(), iters, counters);
+	const auto sim2d = profileSim(buildDetection2d(), iters, counters);
+	if (counters)
+	{
+		for (const auto& r : types)
+			if (r.ok) addCounters(counterRows, r.name, r.grid, r.counters, iters);
+		for (const auto* rs : { &sim1d, &sim2d })
+			for (const auto& r : *rs) addCounters(counterRows, r.type, r.grid, r.counters, iters);
+	}
 
 	for (const auto& r : types)
 		std::printf("  %-26s %s\n", r.name.c_str(),
@@ -749,7 +894,8 @@ int main(int argc, char* argv[])
 	auto section3 = [&](int grid) {
 		for (const bool mem : { false, true })
 		{
-			const auto rs = profileSim(buildBench2d(grid, mem), bIters);
+			const auto rs = profileSim(buildBench2d(grid, mem), bIters, counters);
+			for (const auto& r : rs) if (counters) addCounters(counterRows, r.type, r.grid, r.counters, bIters);
 			double total = 0.0; for (const auto& r : rs) total += r.mean_us;
 			std::printf("-- bench %s@%d (total %.1f us/step) --\n",
 				mem ? "memory" : "detection", grid, total);
@@ -760,7 +906,8 @@ int main(int argc, char* argv[])
 				+ " sim @" + std::to_string(grid)).c_str(), rs);
 		}
 		{
-			const auto rs = profileSim(buildFieldOnly2d(grid), bIters);
+			const auto rs = profileSim(buildFieldOnly2d(grid), bIters, counters);
+			for (const auto& r : rs) if (counters) addCounters(counterRows, r.type, r.grid, r.counters, bIters);
 			std::printf("-- ablation field+stim only @%d --\n", grid);
 			for (const auto& r : rs)
 				std::printf("  %-12s %-18s %8.2f us\n", r.label.c_str(), r.type.c_str(), r.mean_us);
@@ -778,6 +925,40 @@ int main(int argc, char* argv[])
 	section3(100);
 	section3(200);
 
+	// Hardware counters, per step(), grouped over every section above.
+	if (counters || !countersNote.empty())
+	{
+		f << "\n### Hardware counters per element type and grid\n\n";
+		if (!counterRows.empty())
+		{
+			using namespace perf_counters;
+			// By type, then by grid: shorter strings first so "50x50" sorts before "100x100".
+			std::sort(counterRows.begin(), counterRows.end(), [](const CounterRow& a, const CounterRow& b) {
+				if (a.type != b.type) return a.type < b.type;
+				if (a.grid.size() != b.grid.size()) return a.grid.size() < b.grid.size();
+				return a.grid < b.grid; });
+			f << "Per step(), user space only, excluding the counting overhead. LLC MPKI = LLC misses per 1000 instructions.\n\n";
+			f << "| element type | grid | cycles | instructions | IPC | L1D misses | LLC misses | LLC MPKI | branch misses |\n";
+			f << "|--------------|------|-------:|-------------:|----:|-----------:|-----------:|---------:|--------------:|\n";
+			std::printf("-- hardware counters per step --\n");
+			for (const auto& row : counterRows)
+			{
+				const Counts c = row.total.perWindow();
+				const bool mpki = c.has(LlcMisses) && c.has(Instructions) && c[Instructions] > 0.0;
+				f << "| " << row.type << " | " << row.grid << " | " << counterCell(c, Cycles)
+				  << " | " << counterCell(c, Instructions) << " | ";
+				if (c.has(Cycles) && c.has(Instructions)) f << c.ipc(); else f << "n/a";
+				f << " | " << counterCell(c, L1dMisses) << " | " << counterCell(c, LlcMisses) << " | ";
+				if (mpki) f << 1000.0 * c[LlcMisses] / c[Instructions]; else f << "n/a";
+				f << " | " << counterCell(c, BranchMisses) << " |\n";
+				std::printf("  %-24s %-9s %12s cycles  IPC %.2f  LLC %s\n", row.type.c_str(), row.grid.c_str(),
+					counterCell(c, Cycles).c_str(), c.ipc(), counterCell(c, LlcMisses).c_str());
+			}
+		}
+		if (!countersNote.empty())
+			f << (counterRows.empty() ? "" : "\n") << countersNote << "\n";
+	}
+
 	std::printf("Appended session to %s\n", path.c_str());
 	return 0;
 }
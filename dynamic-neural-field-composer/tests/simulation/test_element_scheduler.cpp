@@ -0,0 +1,320 @@
+// Tests for the parallel step path (Simulation::setThreadCount /
+// ElementScheduler). The contract is strict: any thread count must produce
+// bit-identical component values to the single-threaded registry-order loop,
+// including architectures with noise (seeded through tools::math::seedNormal),
+// lateral kernels that read a field registered before or after them, and
+// connections rewired between steps.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "simulation/element_scheduler.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/neural_field.h"
+#include "elements/normal_noise.h"
+#include "elements/correlated_normal_noise.h"
+#include "elements/activation_function.h"
+#include "elements/gauss_stimulus_2d.h"
+#include "elements/mexican_hat_kernel_2d.h"
+#include "elements/neural_field_2d.h"
+#include "tools/math.h"
+#include "scoped_min_log_level.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+
+namespace
+{
+    constexpr int kSize = 100;
+
+    std::shared_ptr<NeuralField> makeField(const std::string& name)
+    {
+        return std::make_shared<NeuralField>(
+            ElementCommonParameters{ name, kSize },
+            NeuralFieldParameters{ 25.0, -5.0, SigmoidFunction{ 0.0, 10.0 } });
+    }
+
+    // Two fields with their own stimulus, lateral kernel and noise, plus a
+    // u -> v projection through a Gauss kernel registered *after* v, so the
+    // graph has both "reads an earlier element" and "reads a later element"
+    // edges and two noise streams that must be consumed in registry order.
+    std::shared_ptr<Simulation> buildTwoFieldSim()
+    {
+        auto sim = std::make_shared<Simulation>("scheduler", 1.0, 0.0, 0.0);
+
+        auto stimU = std::make_shared<GaussStimulus>(
+            ElementCommonParameters{ "stim u", kSize },
+            GaussStimulusParameters{ 5.0, 8.0, 30.0, true, false });
+        auto stimV = std::make_shared<GaussStimulus>(
+            ElementCommonParameters{ "stim v", kSize },
+            GaussStimulusParameters{ 5.0, 6.0, 70.0, true, false });
+        auto u = makeField("u");
+        auto v = makeField("v");
+        auto kernelU = std::make_shared<MexicanHatKernel>(
+            ElementCommonParameters{ "k u", kSize },
+            MexicanHatKernelParameters{ 3.0, 15.0, 6.0, 10.0, -0.5, true, true });
+        auto kernelV = std::make_shared<GaussKernel>(
+            ElementCommonParameters{ "k v", kSize },
+            GaussKernelParameters{ 3.0, 8.0, -0.2, true, true });
+        auto noiseU = std::make_shared<NormalNoise>(
+            ElementCommonParameters{ "noise u", kSize }, NormalNoiseParameters{ 0.5 });
+        auto noiseV = std::make_shared<CorrelatedNormalNoise>(
+            ElementCommonParameters{ "noise v", kSize }, CorrelatedNormalNoiseParameters{ 0.5, 2.0, true });
+        auto uToV = std::make_shared<GaussKernel>(
+            ElementCommonParameters{ "u -> v", kSize },
+            GaussKernelParameters{ 4.0, 4.0, 0.0, true, true });
+
+        sim->addElement(stimU);
+        sim->addElement(stimV);
+        sim->addElement(u);
+        sim->addElement(v);
+        sim->addElement(kernelU);
+        sim->addElement(kernelV);
+        sim->addElement(noiseU);
+        sim->addElement(noiseV);
+        sim->addElement(uToV);
+
+        u->addInput(stimU);
+        u->addInput(kernelU);
+        u->addInput(noiseU);
+        kernelU->addInput(u);
+        v->addInput(stimV);
+        v->addInput(kernelV);
+        v->addInput(noiseV);
+        v->addInput(uToV);
+        kernelV->addInput(v);
+        uToV->addInput(u);
+        return sim;
+    }
+
+    struct Snapshot
+    {
+        std::vector<double> u;
+        std::vector<double> v;
+        std::vector<double> noiseV;
+    };
+
+    Snapshot run(int threads, int steps)
+    {
+        auto sim = buildTwoFieldSim();
+        sim->setThreadCount(threads);
+        tools::math::seedNormal(1234);
+        sim->init();
+        for (int i = 0; i < steps; ++i)
+            sim->step();
+        return { sim->getComponent("u", "activation"),
+                 sim->getComponent("v", "activation"),
+                 sim->getComponent("noise v", "output") };
+    }
+
+    // Minimal element that fails on a chosen step, to check error propagation.
+    class ThrowingElement final : public Element
+    {
+    public:
+        explicit ThrowingElement(const std::string& name)
+            : Element(ElementCommonParameters{ name, kSize }) {}
+        void init() override {}
+        void step(double t, double) override
+        {
+            if (t >= 3.0)
+                throw std::runtime_error("boom");
+        }
+        std::shared_ptr<Element> clone() const override { return std::make_shared<ThrowingElement>(*this); }
+        std::string toString() const override { return "throwing element"; }
+    };
+}
+
+TEST(ElementScheduler, EdgesFollowRegistryOrderSemantics)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    auto sim = buildTwoFieldSim();
+    ElementScheduler scheduler;
+    scheduler.build(sim->getElements());
+
+    // Registry: 0 stim u, 1 stim v, 2 u, 3 v, 4 k u, 5 k v, 6 noise u, 7 noise v, 8 u -> v
+    ASSERT_EQ(scheduler.getNumberOfNodes(), 9u);
+    EXPECT_EQ(scheduler.getSuccessors(0), (std::vector<std::size_t>{ 2 }));
+    // u must step before k u (new value), before noise u and before u -> v
+    // (u reads their previous-step output, so they may not overwrite it first).
+    EXPECT_EQ(scheduler.getSuccessors(2), (std::vector<std::size_t>{ 4, 6, 8 }));
+    EXPECT_EQ(scheduler.getSuccessors(3), (std::vector<std::size_t>{ 5, 7, 8 }));
+    // noise u -> noise v: the two random-stream consumers are chained.
+    EXPECT_EQ(scheduler.getSuccessors(6), (std::vector<std::size_t>{ 7 }));
+    EXPECT_EQ(scheduler.getPredecessorCount(0), 0u);
+    EXPECT_EQ(scheduler.getPredecessorCount(1), 0u);
+    EXPECT_EQ(scheduler.getPredecessorCount(8), 2u);
+    EXPECT_EQ(scheduler.getCriticalPathLength(), 4u); // stim u -> u -> noise u -> noise v
+}
+
+TEST(ElementScheduler, ParallelStepIsBitIdenticalToSerial)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    constexpr int kSteps = 200;
+    const Snapshot serial = run(1, kSteps);
+
+    for (const int threads : { 2, 4, 8 })
+    {
+        const Snapshot parallel = run(threads, kSteps);
+        // Exact equality on purpose: same operations in the same order per element.
+        EXPECT_EQ(parallel.u, serial.u) << "threads=" << threads;
+        EXPECT_EQ(parallel.v, serial.v) << "threads=" << threads;
+        EXPECT_EQ(parallel.noiseV, serial.noiseV) << "threads=" << threads;
+    }
+}
+
+TEST(ElementScheduler, SynchronousModeKeepsEdgesForLiveComponents)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    // "u -> v" reads u's "input", which has no front buffer, so even in
+    // synchronous mode it must see u's input in registry order.
+    auto runSynchronous = [](int threads)
+    {
+        auto sim = buildTwoFieldSim();
+        sim->getElement("u -> v")->removeInput("u");
+        sim->createInteraction("u", "input", "u -> v");
+        sim->setUpdateMode(UpdateMode::Synchronous);
+        sim->setThreadCount(threads);
+        tools::math::seedNormal(77);
+        sim->init();
+
+        ElementScheduler scheduler;
+        scheduler.build(sim->getElements(), true);
+        EXPECT_EQ(scheduler.getSuccessors(2), (std::vector<std::size_t>{ 8 }));
+        EXPECT_EQ(scheduler.getSuccessors(6), (std::vector<std::size_t>{ 7 }));
+        EXPECT_TRUE(scheduler.getSuccessors(0).empty());
+        EXPECT_TRUE(scheduler.getSuccessors(3).empty());
+
+        for (int i = 0; i < 50; ++i)
+            sim->step();
+        return sim->getComponent("v", "activation");
+    };
+
+    const auto serial = runSynchronous(1);
+    EXPECT_EQ(runSynchronous(4), serial);
+}
+
+TEST(ElementScheduler, RewiringBetweenStepsRebuildsTheGraph)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    auto runRewired = [](int threads)
+    {
+        auto sim = buildTwoFieldSim();
+        sim->setThreadCount(threads);
+        tools::math::seedNormal(99);
+        sim->init();
+        for (int i = 0; i < 20; ++i)
+            sim->step();
+        sim->getElement("v")->removeInput("u -> v");
+        sim->createInteraction("stim u", "output", "v");
+        for (int i = 0; i < 20; ++i)
+            sim->step();
+        sim->removeElement("noise u");
+        for (int i = 0; i < 20; ++i)
+            sim->step();
+        return sim->getComponent("v", "activation");
+    };
+
+    const auto serial = runRewired(1);
+    EXPECT_EQ(runRewired(4), serial);
+}
+
+TEST(ElementScheduler, OnlyEditsToItsOwnElementsMakeTheGraphStale)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    auto sim = buildTwoFieldSim();
+    auto other = buildTwoFieldSim();
+    ElementScheduler scheduler;
+    scheduler.build(sim->getElements());
+    ASSERT_TRUE(scheduler.isCurrent(sim->getElements()));
+
+    other->getElement("v")->removeInput("u -> v");
+    other->createInteraction("stim u", "output", "v");
+    EXPECT_TRUE(scheduler.isCurrent(sim->getElements()));
+
+    sim->getElement("v")->removeInput("u -> v");
+    EXPECT_FALSE(scheduler.isCurrent(sim->getElements()));
+}
+
+TEST(ElementScheduler, ThreadCountCanChangeMidRun)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    auto runSwitching = [](bool switchThreads)
+    {
+        auto sim = buildTwoFieldSim();
+        tools::math::seedNormal(5);
+        sim->init();
+        for (int i = 0; i < 30; ++i)
+        {
+            if (switchThreads)
+                sim->setThreadCount(1 + i % 4);
+            sim->step();
+        }
+        return sim->getComponent("u", "activation");
+    };
+    EXPECT_EQ(runSwitching(true), runSwitching(false));
+}
+
+TEST(ElementScheduler, SplitTwoDimensionalConvolutionIsBitIdenticalToSerial)
+{
+    // A grid above kParallelConvMinCells: with more than one thread the
+    // kernel's row and column passes also run on the simulation's pool.
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    const tools::math::ScopedConvolutionMode direct(tools::math::ConvolutionMode::ForceDirect);
+    constexpr int kGrid = 136;
+    auto runGrid = [](int threads)
+    {
+        const ElementDimensions dims(kGrid, kGrid, 1.0, 1.0);
+        auto sim = std::make_shared<Simulation>("split convolution", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus2D>(ElementCommonParameters{ "stim", dims },
+            GaussStimulus2DParameters{ 4.0, 8.0, 40.0, 70.0, true, false }));
+        sim->addElement(std::make_shared<NeuralField2D>(ElementCommonParameters{ "u", dims },
+            NeuralField2DParameters{ 10.0, -3.0, SigmoidFunction{ 0.0, 4.0 } }));
+        sim->addElement(std::make_shared<MexicanHatKernel2D>(ElementCommonParameters{ "k", dims },
+            MexicanHatKernel2DParameters{ 2.5, 11.0, 5.0, 15.0, -0.1, true, true }));
+        sim->createInteraction("stim", "output", "u");
+        sim->createInteraction("u", "output", "k");
+        sim->createInteraction("k", "output", "u");
+        sim->setThreadCount(threads);
+        sim->init();
+        for (int i = 0; i < 8; ++i)
+            sim->step();
+        return sim->getComponent("u", "activation");
+    };
+    ASSERT_GE(static_cast<std::size_t>(kGrid) * kGrid, tools::math::kParallelConvMinCells);
+    const auto serial = runGrid(1);
+    EXPECT_EQ(runGrid(4), serial);
+}
+
+TEST(ElementScheduler, ThreadCountIsClampedToOne)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    Simulation sim("clamp", 1.0, 0.0, 0.0);
+    EXPECT_EQ(sim.getThreadCount(), 1);
+    sim.setThreadCount(0);
+    EXPECT_EQ(sim.getThreadCount(), 1);
+    sim.setThreadCount(-2);
+    EXPECT_EQ(sim.getThreadCount(), 1);
+    sim.setThreadCount(6);
+    EXPECT_EQ(sim.getThreadCount(), 6);
+}
+
+TEST(ElementScheduler, ElementExceptionPropagatesToCaller)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    auto sim = buildTwoFieldSim();
+    sim->addElement(std::make_shared<ThrowingElement>("thrower"));
+    sim->setThreadCount(4);
+    sim->init();
+    sim->step();
+    sim->step();
+    EXPECT_THROW(sim->step(), std::runtime_error);
+    // The pool is still usable: the next step throws again rather than hanging.
+    EXPECT_THROW(sim->step(), std::runtime_error);
+}
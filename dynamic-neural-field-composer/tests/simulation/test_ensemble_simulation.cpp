@@ -0,0 +1,285 @@
+// Tests for EnsembleSimulation. Every instance of the batch must follow the
+// trajectory of a standalone Simulation built with that instance's parameters
+// and noise seed. The kernels here are symmetric, so the two runs perform the
+// same operations; the tolerance only absorbs a build that lets the compiler
+// contract the two loops into fused multiply-adds differently.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "simulation/ensemble_simulation.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/neural_field.h"
+#include "elements/neural_field_2d.h"
+#include "elements/normal_noise.h"
+#include "elements/memory_trace.h"
+#include "elements/activation_function.h"
+#include "exceptions/exception.h"
+#include "tools/fft_convolution.h"
+#include "tools/math.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+
+namespace
+{
+    constexpr int kSize = 80;
+    constexpr double kTolerance = 1e-9;
+
+    struct Variant
+    {
+        double tauU = 20.0;
+        double steepnessU = 4.0;
+        double xShiftV = 0.0;
+        double betaV = 100.0;
+        double thresholdW = 0.5;
+        double stimulusPosition = 30.0;
+        double widthExc = 3.0;
+        double amplitudeGlobal = -0.05;
+        double noiseAmplitude = 0.1;
+        std::uint64_t seed = 1;
+    };
+
+    // A stimulus drives u (sigmoid), which has a circular Mexican-hat kernel
+    // and noise. u projects to v (abs-sigmoid) through a non-circular Gauss
+    // kernel, and v's activation drives w (heaviside) directly.
+    std::shared_ptr<Simulation> buildSim(const Variant& p, UpdateMode mode)
+    {
+        auto sim = std::make_shared<Simulation>("ensemble", 1.0, 0.0, 0.0);
+        sim->setUpdateMode(mode);
+        sim->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim", kSize },
+            GaussStimulusParameters{ 4.0, 9.0, p.stimulusPosition, true, false }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "u", kSize },
+            NeuralFieldParameters{ p.tauU, -5.0, SigmoidFunction{ 0.0, p.steepnessU } }));
+        sim->addElement(std::make_shared<MexicanHatKernel>(ElementCommonParameters{ "k uu", kSize },
+            MexicanHatKernelParameters{ p.widthExc, 15.0, 6.0, 10.0, p.amplitudeGlobal, true, true }));
+        sim->addElement(std::make_shared<NormalNoise>(ElementCommonParameters{ "noise u", kSize },
+            NormalNoiseParameters{ p.noiseAmplitude }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "v", kSize },
+            NeuralFieldParameters{ 10.0, -3.0, AbsSigmoidFunction{ p.xShiftV, p.betaV } }));
+        sim->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "k uv", kSize },
+            GaussKernelParameters{ 4.0, 6.0, 0.0, false, true }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "w", kSize },
+            NeuralFieldParameters{ 15.0, -1.0, HeavisideFunction{ p.thresholdW } }));
+
+        sim->createInteraction("stim", "output", "u");
+        sim->createInteraction("u", "output", "k uu");
+        sim->createInteraction("k uu", "output", "u");
+        sim->createInteraction("noise u", "output", "u");
+        sim->createInteraction("u", "output", "k uv");
+        sim->createInteraction("k uv", "output", "v");
+        sim->createInteraction("v", "activation", "w");
+        return sim;
+    }
+
+    std::vector<Variant> variants()
+    {
+        std::vector<Variant> v(4);
+        v[1].tauU = 12.0; v[1].stimulusPosition = 55.0; v[1].seed = 2;
+        v[2].steepnessU = 9.0; v[2].xShiftV = 0.3; v[2].widthExc = 5.0; v[2].seed = 3;
+        v[3].betaV = 20.0; v[3].thresholdW = -0.5; v[3].amplitudeGlobal = 0.0; v[3].noiseAmplitude = 0.0; v[3].seed = 4;
+        return v;
+    }
+
+    void applyVariant(EnsembleSimulation& ensemble, std::size_t k, const Variant& p)
+    {
+        ensemble.setParameter(k, "u", "tau", p.tauU);
+        ensemble.setParameter(k, "u", "steepness", p.steepnessU);
+        ensemble.setParameter(k, "v", "x_shift", p.xShiftV);
+        ensemble.setParameter(k, "v", "beta", p.betaV);
+        ensemble.setParameter(k, "w", "x_shift", p.thresholdW);
+        ensemble.setParameter(k, "stim", "position", p.stimulusPosition);
+        ensemble.setParameter(k, "k uu", "widthExc", p.widthExc);
+        ensemble.setParameter(k, "k uu", "amplitudeGlobal", p.amplitudeGlobal);
+        ensemble.setParameter(k, "noise u", "amplitude", p.noiseAmplitude);
+        ensemble.setSeed(k, p.seed);
+    }
+
+    void expectNear(const std::vector<double>& actual, const std::vector<double>& expected,
+                    const std::string& what)
+    {
+        ASSERT_EQ(actual.size(), expected.size()) << what;
+        for (std::size_t i = 0; i < actual.size(); ++i)
+            ASSERT_NEAR(actual[i], expected[i], kTolerance) << what << " at cell " << i;
+    }
+
+    void expectMatchesStandalone(UpdateMode mode, int steps)
+    {
+        const auto all = variants();
+        EnsembleSimulation ensemble(*buildSim(Variant{}, mode), all.size());
+        for (std::size_t k = 0; k < all.size(); ++k)
+            applyVariant(ensemble, k, all[k]);
+        ensemble.init();
+        for (int s = 0; s < steps; ++s)
+            ensemble.step();
+
+        for (std::size_t k = 0; k < all.size(); ++k)
+        {
+            const auto sim = buildSim(all[k], mode);
+            sim->init();
+            tools::math::seedNormal(all[k].seed);
+            for (int s = 0; s < steps; ++s)
+                sim->step();
+
+            for (const std::string field : { "u", "v", "w" })
+            {
+                const std::string what = "instance " + std::to_string(k) + ", field " + field;
+                expectNear(ensemble.getComponent(k, field, "activation"), sim->getComponent(field, "activation"), what);
+                expectNear(ensemble.getComponent(k, field, "output"), sim->getComponent(field, "output"), what);
+            }
+        }
+        EXPECT_DOUBLE_EQ(ensemble.getT(), steps * 1.0);
+    }
+}
+
+TEST(EnsembleSimulation, EachInstanceMatchesStandaloneSimulation)
+{
+    expectMatchesStandalone(UpdateMode::Sequential, 120);
+}
+
+TEST(EnsembleSimulation, EachInstanceMatchesStandaloneSimulationSynchronous)
+{
+    expectMatchesStandalone(UpdateMode::Synchronous, 120);
+}
+
+TEST(EnsembleSimulation, InstancesWithoutOverridesFollowThePrototype)
+{
+    const auto prototype = buildSim(Variant{}, UpdateMode::Sequential);
+    EnsembleSimulation ensemble(*prototype, 3);
+    for (std::size_t k = 0; k < 3; ++k)
+        ensemble.setSeed(k, 7);
+    ensemble.setParameter(1, "u", "tau", 5.0);
+    ensemble.init();
+    for (int s = 0; s < 40; ++s)
+        ensemble.step();
+
+    EXPECT_EQ(ensemble.getComponent(0, "u", "activation"), ensemble.getComponent(2, "u", "activation"));
+    EXPECT_NE(ensemble.getComponent(0, "u", "activation"), ensemble.getComponent(1, "u", "activation"));
+}
+
+TEST(EnsembleSimulation, InitResetsState)
+{
+    EnsembleSimulation ensemble(*buildSim(Variant{}, UpdateMode::Sequential), 2);
+    ensemble.setSeed(0, 11);
+    ensemble.setSeed(1, 12);
+    ensemble.init();
+    const auto initial = ensemble.getComponent(1, "u", "activation");
+    for (int s = 0; s < 10; ++s)
+        ensemble.step();
+    const auto afterTen = ensemble.getComponent(1, "u", "activation");
+
+    ensemble.init();
+    EXPECT_EQ(ensemble.getT(), 0.0);
+    EXPECT_EQ(ensemble.getComponent(1, "u", "activation"), initial);
+    for (int s = 0; s < 10; ++s)
+        ensemble.step();
+    EXPECT_EQ(ensemble.getComponent(1, "u", "activation"), afterTen);
+}
+
+TEST(EnsembleSimulation, RejectsUnsupportedElements)
+{
+    auto sim = buildSim(Variant{}, UpdateMode::Sequential);
+    sim->addElement(std::make_shared<MemoryTrace>(ElementCommonParameters{ "trace", kSize },
+        MemoryTraceParameters{ 50.0, 400.0, 0.5 }));
+
+    std::string reason;
+    EXPECT_FALSE(EnsembleSimulation::supports(*sim, &reason));
+    EXPECT_NE(reason.find("trace"), std::string::npos) << reason;
+    EXPECT_THROW(EnsembleSimulation(*sim, 2), Exception);
+    EXPECT_TRUE(EnsembleSimulation::supports(*buildSim(Variant{}, UpdateMode::Sequential)));
+}
+
+TEST(EnsembleSimulation, RejectsTwoDimensionalElementsAndSaysSo)
+{
+    Simulation sim("2d", 1.0, 0.0, 0.0);
+    sim.addElement(std::make_shared<NeuralField2D>(ElementCommonParameters{ "u2d", ElementDimensions(20, 20, 1.0, 1.0) },
+        NeuralField2DParameters{ 10.0, -3.0, SigmoidFunction{ 0.0, 4.0 } }));
+
+    std::string reason;
+    EXPECT_FALSE(EnsembleSimulation::supports(sim, &reason));
+    EXPECT_NE(reason.find("u2d"), std::string::npos) << reason;
+    EXPECT_NE(reason.find("2D"), std::string::npos) << reason;
+}
+
+TEST(EnsembleSimulation, RejectsInvalidArguments)
+{
+    const auto prototype = buildSim(Variant{}, UpdateMode::Sequential);
+    EXPECT_THROW(EnsembleSimulation(*prototype, 0), Exception);
+
+    EnsembleSimulation ensemble(*prototype, 2);
+    EXPECT_THROW(ensemble.setParameter(2, "u", "tau", 1.0), Exception);
+    EXPECT_THROW(ensemble.setParameter(0, "missing", "tau", 1.0), Exception);
+    EXPECT_THROW(ensemble.setParameter(0, "u", "beta", 1.0), Exception);  // u is a sigmoid field
+    EXPECT_THROW(ensemble.setSeed(2, 1), Exception);
+    EXPECT_THROW(ensemble.step(), Exception);
+
+    ensemble.init();
+    EXPECT_THROW(ensemble.getComponent(0, "stim", "activation"), Exception);
+    EXPECT_THROW(ensemble.getComponent(5, "u", "output"), Exception);
+}
+
+TEST(EnsembleSimulation, WideCircularKernelsTakeTheStandaloneSpectralPath)
+{
+    // A circular Gauss kernel wider than kFFTTapThreshold1D on a field of at
+    // least kFFTMinSize1D samples is convolved spectrally when standalone.
+    // Instance 1 narrows it back onto the direct path, so the batch mixes both.
+    constexpr int size = 200;
+    const auto build = [](double width)
+    {
+        auto sim = std::make_shared<Simulation>("ensemble spectral", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim", size },
+            GaussStimulusParameters{ 4.0, 9.0, 70.0, true, false }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "u", size },
+            NeuralFieldParameters{ 20.0, -5.0, SigmoidFunction{ 0.0, 4.0 } }));
+        sim->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "k uu", size },
+            GaussKernelParameters{ width, 2.0, -0.02, true, true }));
+        sim->addElement(std::make_shared<NormalNoise>(ElementCommonParameters{ "noise u", size },
+            NormalNoiseParameters{ 0.1 }));
+        sim->createInteraction("stim", "output", "u");
+        sim->createInteraction("u", "output", "k uu");
+        sim->createInteraction("k uu", "output", "u");
+        sim->createInteraction("noise u", "output", "u");
+        return sim;
+    };
+    const std::vector<double> widths = { 12.0, 3.0, 20.0 };
+    constexpr int steps = 60;
+
+    EnsembleSimulation ensemble(*build(widths[0]), widths.size());
+    for (std::size_t k = 0; k < widths.size(); ++k)
+    {
+        ensemble.setParameter(k, "k uu", "width", widths[k]);
+        ensemble.setSeed(k, k + 1);
+    }
+    ensemble.init();
+    for (int s = 0; s < steps; ++s)
+        ensemble.step();
+
+    for (std::size_t k = 0; k < widths.size(); ++k)
+    {
+        const auto sim = build(widths[k]);
+        sim->init();
+        const int taps = static_cast<int>(sim->getComponent("k uu", "kernel").size());
+        ASSERT_EQ(tools::math::shouldUseSpectral1D(true, taps, size), k != 1) << "instance " << k << ", " << taps << " taps";
+        tools::math::seedNormal(k + 1);
+        for (int s = 0; s < steps; ++s)
+            sim->step();
+
+        // A spectral instance runs the same convolver as its standalone kernel,
+        // so the two agree exactly; convolving it directly instead would differ
+        // by rounding.
+        const std::string what = "instance " + std::to_string(k);
+        if (k != 1)
+        {
+            EXPECT_EQ(ensemble.getComponent(k, "k uu", "output"), sim->getComponent("k uu", "output")) << what;
+            EXPECT_EQ(ensemble.getComponent(k, "u", "activation"), sim->getComponent("u", "activation")) << what;
+        }
+        expectNear(ensemble.getComponent(k, "k uu", "output"), sim->getComponent("k uu", "output"), what);
+        expectNear(ensemble.getComponent(k, "u", "activation"), sim->getComponent("u", "activation"), what);
+    }
+}
@@ -0,0 +1,352 @@
+// Tests for ParameterSweep: variant generation, specification parsing, and a
+// small sweep over the sim_001 validation deck -- that the swept values reach
+// the simulation, that every variant gets exactly one result line, and that an
+// interrupted results file resumes to the same results without risking the
+// lines already written.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "simulation/parameter_sweep.h"
+#include "simulation/simulation_file_manager.h"
+#include "elements/neural_field.h"
+#include "exceptions/exception.h"
+#include "tools/fft_convolution.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace
+{
+    constexpr int kSteps = 60;
+
+    fs::path deckPath()
+    {
+        return fs::path(VALIDATION_DATA_DIR) / "1d" / "simulations" / "sim_001_sigmoid_b100.json";
+    }
+
+    json cartesianSweep()
+    {
+        return json{
+            { "architecture", deckPath().string() },
+            { "steps", kSteps },
+            { "parameters", json::array({
+                { { "element", "neural field u" }, { "parameter", "restingLevel" }, { "values", { -8.0, -6.0, -4.0 } } },
+                { { "element", "gauss kernel" }, { "parameter", "amplitude" }, { "min", 4.0 }, { "max", 12.0 }, { "count", 2 } },
+            }) },
+        };
+    }
+
+    std::vector<json> readLines(const fs::path& path)
+    {
+        std::ifstream file(path);
+        std::vector<json> lines;
+        std::string text;
+        while (std::getline(file, text))
+            lines.push_back(json::parse(text));
+        return lines;
+    }
+
+    class ParameterSweepTest : public ::testing::Test
+    {
+    protected:
+        fs::path tempDir;
+
+        void SetUp() override
+        {
+            if (!fs::exists(deckPath()))
+                GTEST_SKIP() << "Validation deck not found: " << deckPath();
+            const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+            tempDir = fs::temp_directory_path() / "dnf_sweep_tests" / info->name();
+            fs::remove_all(tempDir);
+            fs::create_directories(tempDir);
+        }
+
+        void TearDown() override
+        {
+            std::error_code ec;
+            fs::remove_all(tempDir, ec);
+        }
+    };
+}
+
+TEST(SweepVariants, CartesianEnumeratesEveryCombinationLastParameterFastest)
+{
+    const auto specification = SweepSpecification::fromJson(cartesianSweep());
+    const auto variants = generateSweepVariants(specification);
+
+    ASSERT_EQ(variants.size(), 6u);
+    const std::vector<std::vector<double>> expected = {
+        { -8, 4 }, { -8, 12 }, { -6, 4 }, { -6, 12 }, { -4, 4 }, { -4, 12 } };
+    for (std::size_t i = 0; i < variants.size(); ++i)
+    {
+        EXPECT_EQ(variants[i].index, i);
+        EXPECT_EQ(variants[i].values, expected[i]);
+        EXPECT_EQ(variants[i].seed, specification.seed + i);
+    }
+}
+
+TEST(SweepVariants, LatinHypercubeHitsEveryStratumOnceAndIsDeterministic)
+{
+    json document = cartesianSweep();
+    document["design"] = "latin_hypercube";
+    document["samples"] = 10;
+    document["seed"] = 42;
+    document["parameters"] = json::array({
+        { { "element", "neural field u" }, { "parameter", "restingLevel" }, { "min", -10.0 }, { "max", 0.0 } },
+        { { "element", "gauss kernel" }, { "parameter", "width" }, { "min", 1.0 }, { "max", 6.0 } },
+    });
+    const auto specification = SweepSpecification::fromJson(document);
+    const auto variants = generateSweepVariants(specification);
+
+    ASSERT_EQ(variants.size(), 10u);
+    for (std::size_t d = 0; d < 2; ++d)
+    {
+        const auto& parameter = specification.parameters[d];
+        std::set<int> strata;
+        for (const auto& variant : variants)
+        {
+            const double position = (variant.values[d] - parameter.min) / (parameter.max - parameter.min);
+            ASSERT_GE(position, 0.0);
+            ASSERT_LT(position, 1.0);
+            strata.insert(static_cast<int>(position * 10));
+        }
+        EXPECT_EQ(strata.size(), 10u) << "parameter " << d;
+    }
+
+    const auto again = generateSweepVariants(specification);
+    for (std::size_t i = 0; i < variants.size(); ++i)
+        EXPECT_EQ(variants[i].values, again[i].values);
+
+    document["seed"] = 43;
+    EXPECT_NE(generateSweepVariants(SweepSpecification::fromJson(document))[0].values, variants[0].values);
+}
+
+TEST(SweepSpecification, RejectsMalformedSpecifications)
+{
+    auto without = [](const std::string& key) { json d = cartesianSweep(); d.erase(key); return d; };
+    EXPECT_THROW(SweepSpecification::fromJson(without("architecture")), Exception);
+    EXPECT_THROW(SweepSpecification::fromJson(without("parameters")), Exception);
+
+    json document = cartesianSweep();
+    document["design"] = "random";
+    EXPECT_THROW(SweepSpecification::fromJson(document), Exception);
+
+    document = cartesianSweep();
+    document["steps"] = 0;
+    EXPECT_THROW(SweepSpecification::fromJson(document), Exception);
+
+    document = cartesianSweep();
+    document["parameters"] = json::array();
+    EXPECT_THROW(SweepSpecification::fromJson(document), Exception);
+
+    document = cartesianSweep();
+    document["parameters"][0]["values"] = json::array();
+    EXPECT_THROW(SweepSpecification::fromJson(document), Exception);
+
+    document = cartesianSweep();
+    document["design"] = "latin_hypercube";  // no "samples", no min/max on parameter 0
+    EXPECT_THROW(SweepSpecification::fromJson(document), Exception);
+}
+
+TEST(SweepSpecification, ResolvesRelativeArchitectureAgainstBaseDirectory)
+{
+    json document = cartesianSweep();
+    document["architecture"] = "deck.json";
+    EXPECT_EQ(SweepSpecification::fromJson(document, "sweeps").architecture, fs::path("sweeps") / "deck.json");
+
+    const auto specification = SweepSpecification::fromJson(cartesianSweep());
+    EXPECT_EQ(SweepSpecification::fromJson(specification.toJson()).toJson(), specification.toJson());
+}
+
+TEST_F(ParameterSweepTest, RejectsUnknownElementsAndParameters)
+{
+    json document = cartesianSweep();
+    document["parameters"][0]["element"] = "neural field z";
+    EXPECT_THROW(ParameterSweep(SweepSpecification::fromJson(document)), Exception);
+
+    document = cartesianSweep();
+    document["parameters"][0]["parameter"] = "restinglevel";
+    EXPECT_THROW(ParameterSweep(SweepSpecification::fromJson(document)), Exception);
+
+    document = cartesianSweep();
+    document["architecture"] = (tempDir / "missing.json").string();
+    EXPECT_THROW(ParameterSweep(SweepSpecification::fromJson(document)), Exception);
+}
+
+TEST_F(ParameterSweepTest, AppliesSweptValuesToTheSimulation)
+{
+    json document = cartesianSweep();
+    document["parameters"][1] = { { "element", "neural field u" }, { "parameter", "steepness" }, { "values", { 20.0 } } };
+    const ParameterSweep sweep(SweepSpecification::fromJson(document));
+    const SweepVariant& variant = sweep.getVariants()[1];  // restingLevel -6, steepness 20
+
+    const auto swept = sweep.buildSimulation(variant);
+    const auto parameters = std::dynamic_pointer_cast<NeuralField>(swept->getElement("neural field u"))->getParameters();
+    EXPECT_EQ(parameters.startingRestingLevel, -6.0);
+    EXPECT_EQ(dynamic_cast<const SigmoidFunction&>(*parameters.activationFunction).getSteepness(), 20.0);
+
+    // The same run with the values set by hand must end in the same state.
+    const auto manual = std::make_shared<Simulation>();
+    SimulationFileManager(manual, deckPath().string()).loadElementsFromJson();
+    const auto field = std::dynamic_pointer_cast<NeuralField>(manual->getElement("neural field u"));
+    NeuralFieldParameters manualParameters(parameters.tau, -6.0, SigmoidFunction{ 0.0, 20.0 });
+    field->setParameters(manualParameters);
+    manual->init();
+    for (int s = 0; s < kSteps; ++s)
+        manual->step();
+
+    const SweepResult result = sweep.runVariant(variant);
+    ASSERT_TRUE(result.error.empty()) << result.error;
+    ASSERT_EQ(result.fields.size(), 1u);
+    EXPECT_EQ(result.fields[0].name, "neural field u");
+    EXPECT_EQ(result.fields[0].activation, manual->getComponent("neural field u", "activation"));
+    EXPECT_EQ(result.fields[0].stable, field->isStable());
+    EXPECT_EQ(result.fields[0].bumpCount, static_cast<int>(field->getBumps().size()));
+    EXPECT_EQ(result.fields[0].highestActivation, field->getHighestActivation());
+}
+
+TEST_F(ParameterSweepTest, RunWritesHeaderAndOneLinePerVariant)
+{
+    const ParameterSweep sweep(SweepSpecification::fromJson(cartesianSweep()));
+    const fs::path out = tempDir / "results.jsonl";
+
+    std::vector<std::size_t> reported;
+    const auto results = sweep.run(out, 2, false, [&](const SweepResult&, std::size_t done, std::size_t total) {
+        reported.push_back(done);
+        EXPECT_EQ(total, 6u);
+    });
+    EXPECT_EQ(results.size(), 6u);
+    EXPECT_EQ(reported, (std::vector<std::size_t>{ 1, 2, 3, 4, 5, 6 }));
+
+    const auto lines = readLines(out);
+    ASSERT_EQ(lines.size(), 7u);
+    EXPECT_EQ(lines[0], sweep.headerJson());
+    std::set<std::size_t> variants;
+    for (std::size_t i = 1; i < lines.size(); ++i)
+    {
+        EXPECT_FALSE(lines[i].contains("error")) << lines[i].dump();
+        variants.insert(lines[i]["variant"].get<std::size_t>());
+        const auto& field = lines[i]["fields"][0];
+        EXPECT_EQ(field["final_activation"].size(), 100u);
+        EXPECT_TRUE(field.contains("stability_time"));
+        EXPECT_TRUE(field.contains("bump_count"));
+    }
+    EXPECT_EQ(variants.size(), 6u);
+    EXPECT_EQ(sweep.completedVariants(out).size(), 6u);
+
+    // A variant's line does not depend on the concurrency it ran at.
+    const auto serial = sweep.runVariant(sweep.getVariants()[4]);
+    const auto it = std::ranges::find_if(results, [](const SweepResult& r) { return r.variant.index == 4; });
+    ASSERT_NE(it, results.end());
+    EXPECT_EQ(it->fields[0].activation, serial.fields[0].activation);
+}
+
+TEST_F(ParameterSweepTest, ResumeDropsTornLineAndRunsOnlyTheRest)
+{
+    const ParameterSweep sweep(SweepSpecification::fromJson(cartesianSweep()));
+    const fs::path complete = tempDir / "complete.jsonl";
+    sweep.run(complete, 1, false);
+    const auto expected = readLines(complete);
+
+    // Interrupted after two variants, half-way through writing the third.
+    const fs::path out = tempDir / "results.jsonl";
+    {
+        std::ifstream in(complete);
+        std::ofstream partial(out);
+        std::string text;
+        for (int i = 0; i < 3 && std::getline(in, text); ++i)
+            partial << text << '\n';
+        std::getline(in, text);
+        partial << text.substr(0, text.size() / 2);
+    }
+    EXPECT_EQ(sweep.completedVariants(out).size(), 2u);
+
+    const auto results = sweep.run(out, 2, true);
+    EXPECT_EQ(results.size(), 4u);
+
+    auto lines = readLines(out);
+    ASSERT_EQ(lines.size(), expected.size());
+    auto byVariant = [](const json& a, const json& b) { return a["variant"] < b["variant"]; };
+    auto withoutTiming = [](std::vector<json> v) {
+        for (auto& line : v)
+            line.erase("wall_seconds");
+        return v;
+    };
+    std::vector<json> resumed(lines.begin() + 1, lines.end());
+    std::vector<json> reference(expected.begin() + 1, expected.end());
+    std::ranges::sort(resumed, byVariant);
+    std::ranges::sort(reference, byVariant);
+    EXPECT_EQ(withoutTiming(resumed), withoutTiming(reference));
+
+    EXPECT_TRUE(sweep.run(out, 2, true).empty());
+    EXPECT_EQ(readLines(out).size(), expected.size());
+    EXPECT_FALSE(fs::exists(fs::path(out.string() + ".tmp")));
+}
+
+TEST_F(ParameterSweepTest, ResumeThatCannotRewriteKeepsTheResults)
+{
+    const ParameterSweep sweep(SweepSpecification::fromJson(cartesianSweep()));
+    const fs::path out = tempDir / "results.jsonl";
+    sweep.run(out, 2, false);
+    const auto before = readLines(out);
+
+    // Something in the way of the rewrite: the results must survive it.
+    const fs::path blocker = out.string() + ".tmp";
+    fs::create_directories(blocker / "occupied");
+    EXPECT_THROW(sweep.run(out, 2, true), Exception);
+    EXPECT_EQ(readLines(out), before);
+}
+
+TEST_F(ParameterSweepTest, ResumeRefusesADifferentSweep)
+{
+    const ParameterSweep sweep(SweepSpecification::fromJson(cartesianSweep()));
+    const fs::path out = tempDir / "results.jsonl";
+    sweep.run(out, 2, false);
+
+    json document = cartesianSweep();
+    document["steps"] = kSteps + 1;
+    const ParameterSweep other(SweepSpecification::fromJson(document));
+    EXPECT_THROW(other.completedVariants(out), Exception);
+    EXPECT_THROW(other.run(out, 2, true), Exception);
+    EXPECT_EQ(readLines(out).size(), 7u);  // left untouched
+}
+
+TEST_F(ParameterSweepTest, MeasuredPlansAreInUseFromTheFirstStep)
+{
+    const fs::path spectralDeck = fs::path(VALIDATION_DATA_DIR) / "2d_spectral" / "simulations" / "golden_006_mexican_hat.json";
+    if (!fs::exists(spectralDeck))
+        GTEST_SKIP() << "Validation deck not found: " << spectralDeck;
+    const ParameterSweep sweep(SweepSpecification::fromJson(json{
+        { "architecture", spectralDeck.string() },
+        { "steps", 20 },
+        { "parameters", json::array({
+            { { "element", "neural field u" }, { "parameter", "restingLevel" }, { "values", { -5.0 } } },
+        }) },
+    }));
+
+    tools::math::clearFftPlanCache();
+    {
+        const tools::math::ScopedPlanRigor measured(tools::math::PlanRigor::Measure);
+        const SweepResult first = sweep.runVariant(sweep.getVariants()[0]);
+        ASSERT_TRUE(first.error.empty()) << first.error;
+        for (const auto& shape : tools::math::cachedFftPlans())
+            EXPECT_EQ(shape.rigor, tools::math::PlanRigor::Measure);
+
+        // A second run finds the measured plans cached and uses them from its
+        // first step; the first run must have done the same to end identically.
+        const SweepResult second = sweep.runVariant(sweep.getVariants()[0]);
+        ASSERT_EQ(first.fields.size(), 1u);
+        ASSERT_EQ(second.fields.size(), 1u);
+        EXPECT_EQ(first.fields[0].activation, second.fields[0].activation);
+    }
+    tools::math::clearFftPlanCache();
+}
@@ -0,0 +1,174 @@
+// Tests for deadline-driven stepping (simulation/real_time_runner.h). Periods
+// are a few milliseconds and overruns are forced by sleeping in the period
+// callback, so the checks hold on a loaded machine: they count steps, skipped
+// periods and late starts, never how close to a deadline a step began.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "simulation/real_time_runner.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/neural_field.h"
+#include "elements/activation_function.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+using namespace std::chrono_literals;
+
+namespace
+{
+    constexpr int kSize = 50;
+
+    std::shared_ptr<Simulation> makeSimulation()
+    {
+        auto sim = createSimulation("real time runner", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus>(
+            ElementCommonParameters{ "stim", kSize },
+            GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false }));
+        sim->addElement(std::make_shared<NeuralField>(
+            ElementCommonParameters{ "nf", kSize },
+            NeuralFieldParameters{ 25.0, -5.0, SigmoidFunction{ 0.0, 10.0 } }));
+        sim->createInteraction("stim", "output", "nf");
+        return sim;
+    }
+
+    RealTimeOptions options(OverrunPolicy policy, std::uint32_t maxCatchUp = 1000)
+    {
+        RealTimeOptions result;
+        result.period = 2ms;
+        result.overrunPolicy = policy;
+        result.maxCatchUp = maxCatchUp;
+        return result;
+    }
+
+    // Makes the step after period 5 start about three periods late.
+    void stallAfterFifth(const RealTimePeriod& period)
+    {
+        if (period.index == 5)
+            std::this_thread::sleep_for(7ms);
+    }
+}
+
+TEST(RealTimeRunner, StepsOncePerPeriod)
+{
+    auto sim = makeSimulation();
+    RealTimeRunner runner(sim, options(OverrunPolicy::CatchUp));
+    int callbacks = 0;
+    const RealTimeStats stats = runner.run(50, [&](const RealTimePeriod&) { ++callbacks; });
+
+    EXPECT_TRUE(sim->isInitialized());
+    EXPECT_EQ(stats.periods, 50u);
+    EXPECT_EQ(stats.steps, 50u);
+    EXPECT_EQ(stats.skipped, 0u);
+    EXPECT_EQ(callbacks, 50);
+    EXPECT_DOUBLE_EQ(sim->getT(), 50.0);
+    // The last step starts on the deadline of period 49.
+    EXPECT_GE(stats.wallTime, 49 * stats.period);
+    EXPECT_LE(stats.jitterP50, stats.jitterP99);
+    EXPECT_LE(stats.jitterP99, stats.jitterMax);
+    EXPECT_LE(stats.stepP50, stats.stepMax);
+    EXPECT_LE(stats.slackMin, stats.slackMean);
+}
+
+TEST(RealTimeRunner, SkipDropsMissedPeriods)
+{
+    auto sim = makeSimulation();
+    RealTimeRunner runner(sim, options(OverrunPolicy::Skip));
+    std::uint64_t reportedSkips = 0;
+    const RealTimeStats stats = runner.run(20, [&](const RealTimePeriod& period)
+        {
+            reportedSkips += period.skipped;
+            stallAfterFifth(period);
+        });
+
+    EXPECT_EQ(stats.periods, 20u);
+    EXPECT_GE(stats.overruns, 1u);
+    EXPECT_GE(stats.skipped, 1u);
+    EXPECT_EQ(stats.steps + stats.skipped, stats.periods);
+    EXPECT_EQ(reportedSkips, stats.skipped);
+    EXPECT_EQ(stats.lateStarts, 0u);
+    EXPECT_LT(stats.slackMin, std::chrono::nanoseconds::zero());
+    EXPECT_GT(stats.missRate(), 0.0);
+}
+
+TEST(RealTimeRunner, CatchUpStepsEveryPeriod)
+{
+    auto sim = makeSimulation();
+    RealTimeRunner runner(sim, options(OverrunPolicy::CatchUp));
+    const RealTimeStats stats = runner.run(20, stallAfterFifth);
+
+    EXPECT_EQ(stats.periods, 20u);
+    EXPECT_EQ(stats.steps, 20u);
+    EXPECT_EQ(stats.skipped, 0u);
+    EXPECT_GE(stats.overruns, 1u);
+    EXPECT_GE(stats.lateStarts, 1u);
+    EXPECT_DOUBLE_EQ(sim->getT(), 20.0);
+}
+
+TEST(RealTimeRunner, CatchUpIsBounded)
+{
+    auto sim = makeSimulation();
+    RealTimeRunner runner(sim, options(OverrunPolicy::CatchUp, 0));
+    const RealTimeStats stats = runner.run(20, stallAfterFifth);
+
+    // With no backlog allowed, catching up degenerates to skipping.
+    EXPECT_GE(stats.skipped, 1u);
+    EXPECT_EQ(stats.lateStarts, 0u);
+    EXPECT_EQ(stats.steps + stats.skipped, stats.periods);
+}
+
+TEST(RealTimeRunner, StopAndRunFor)
+{
+    auto sim = makeSimulation();
+    RealTimeRunner runner(sim, options(OverrunPolicy::Skip));
+    const RealTimeStats stopped = runner.run(1000, [&](const RealTimePeriod& period)
+        {
+            if (period.index == 3)
+                runner.stop();
+        });
+    EXPECT_EQ(stopped.steps, 4u);
+
+    // 21 ms at 2 ms rounds up to 11 periods.
+    const RealTimeStats timed = runner.runFor(21ms);
+    EXPECT_EQ(timed.periods, 11u);
+    EXPECT_EQ(runner.run(0).periods, 0u);
+}
+
+TEST(RealTimeRunner, SchedulingIsBestEffortAndRestored)
+{
+    auto sim = makeSimulation();
+    RealTimeOptions requested = options(OverrunPolicy::Skip);
+    requested.priority = 10;
+    requested.cpu = 0;
+    RealTimeRunner runner(sim, requested);
+#if defined(__linux__)
+    const int policyBefore = sched_getscheduler(0);
+#endif
+    const RealTimeStats stats = runner.run(5);
+
+    EXPECT_EQ(stats.steps + stats.skipped, 5u);
+    EXPECT_TRUE(stats.realTimePriority || !stats.note.empty());
+    EXPECT_TRUE(stats.pinned || !stats.note.empty());
+#if defined(__linux__)
+    EXPECT_EQ(sched_getscheduler(0), policyBefore);
+#endif
+}
+
+TEST(RealTimeRunner, RejectsInvalidOptions)
+{
+    auto sim = makeSimulation();
+    RealTimeOptions zeroPeriod;
+    zeroPeriod.period = 0ns;
+    EXPECT_THROW(RealTimeRunner(sim, zeroPeriod), Exception);
+    RealTimeOptions badPriority;
+    badPriority.priority = 100;
+    EXPECT_THROW(RealTimeRunner(sim, badPriority), Exception);
+    EXPECT_THROW(RealTimeRunner(nullptr), Exception);
+}
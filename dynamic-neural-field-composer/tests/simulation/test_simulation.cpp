@@ -527,3 +527,75 @@ TEST(ElementLifetime, RecurrentFieldAndKernelAreReleased)
     EXPECT_TRUE(fieldObserver.expired()) << "recurrent field outlived every owner";
     EXPECT_TRUE(kernelObserver.expired()) << "recurrent kernel outlived every owner";
 }
+
+// ---------------------------------------------------------------------------
+// Update mode
+//
+// stim -> A -> B, registered in that order. Sequential: B reads A's output from
+// the current step. Synchronous: B reads A's output from the previous step.
+// ---------------------------------------------------------------------------
+
+namespace
+{
+    struct Chain
+    {
+        Simulation sim{ "update-mode", 1.0, 0.0, 0.0 };
+        std::shared_ptr<NeuralField> a = makeField("A");
+        std::shared_ptr<NeuralField> b = makeField("B");
+
+        explicit Chain(UpdateMode mode)
+        {
+            sim.setUpdateMode(mode);
+            sim.addElement(makeStimulus("stim"));
+            sim.addElement(a);
+            sim.addElement(b);
+            sim.createInteraction("stim", "output", "A");
+            sim.createInteraction("A", "output", "B");
+            sim.init();
+        }
+    };
+}
+
+TEST(SimulationUpdateMode, DefaultIsSequential)
+{
+    const Simulation sim("update-mode-default", 1.0, 0.0, 0.0);
+    EXPECT_EQ(sim.getUpdateMode(), UpdateMode::Sequential);
+}
+
+TEST(SimulationUpdateMode, SequentialConsumerSeesCurrentStep)
+{
+    Chain chain(UpdateMode::Sequential);
+    const std::vector<double> before = chain.a->getComponent("output");
+    chain.sim.step();
+    ASSERT_NE(chain.a->getComponent("output"), before);
+    EXPECT_EQ(chain.b->getComponent("input"), chain.a->getComponent("output"));
+    EXPECT_FALSE(chain.a->isFrontBuffered());
+}
+
+TEST(SimulationUpdateMode, SynchronousConsumerSeesPreviousStep)
+{
+    Chain chain(UpdateMode::Synchronous);
+    EXPECT_TRUE(chain.a->isFrontBuffered());
+
+    const std::vector<double> before = chain.a->getComponent("output");
+    chain.sim.step();
+    ASSERT_NE(chain.a->getComponent("output"), before);
+    EXPECT_EQ(chain.b->getComponent("input"), before);
+
+    // The step's results are published once every element has stepped.
+    EXPECT_EQ(chain.a->getPublishedComponent("output"), chain.a->getComponent("output"));
+    const std::vector<double> published = chain.a->getComponent("output");
+    chain.sim.step();
+    EXPECT_EQ(chain.b->getComponent("input"), published);
+}
+
+TEST(SimulationUpdateMode, SwitchingBackToSequentialDropsFrontBuffers)
+{
+    Chain chain(UpdateMode::Synchronous);
+    chain.sim.step();
+    chain.sim.setUpdateMode(UpdateMode::Sequential);
+    EXPECT_FALSE(chain.a->isFrontBuffered());
+
+    chain.sim.step();
+    EXPECT_EQ(chain.b->getComponent("input"), chain.a->getComponent("output"));
+}
@@ -1015,6 +1015,45 @@ TEST_F(SimulationFileManagerTest, RoundTripPreservesGaussFieldCouplingWithCoupli
         EXPECT_EQ(params.couplings[i], couplings[i]);
 }
 
+TEST_F(SimulationFileManagerTest, RoundTripPreservesGaussFieldCouplingEvaluation)
+{
+    const GaussFieldCouplingParameters gfcp{ ElementDimensions(100, 1.0), true, false,
+        { GaussCoupling{ 25.0, 30.0, 3.0, 5.0 } }, GaussCouplingEvaluation::ANALYTIC };
+    const auto simA = createSimulation("rt-gfc-evaluation", 1.0, 0.0, 0.0);
+    simA->addElement(std::make_shared<GaussFieldCoupling>(ElementCommonParameters{ "gfc rt3", 100 }, gfcp));
+
+    const SimulationFileManager sfmSave{ simA, tempDir };
+    sfmSave.saveElementsToJson();
+
+    const auto simB = createSimulation("rt-gfc-evaluation-loaded", 1.0, 0.0, 0.0);
+    const SimulationFileManager sfmLoad{ simB, tempDir + "rt-gfc-evaluation/rt-gfc-evaluation.dnf" };
+    sfmLoad.loadElementsFromJson();
+
+    const auto loaded = std::dynamic_pointer_cast<GaussFieldCoupling>(simB->getElement("gfc rt3"));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getParameters().evaluation, GaussCouplingEvaluation::ANALYTIC);
+}
+
+TEST_F(SimulationFileManagerTest, RoundTripPreservesFieldCouplingWeightStorage)
+{
+    const FieldCouplingParameters fcp{ ElementDimensions(100, 1.0), LearningRule::HEBB, 1.0, 0.01, 0.0,
+        WeightStorage::SPARSE, 0.025 };
+    const auto simA = createSimulation("rt-fc-storage", 1.0, 0.0, 0.0);
+    simA->addElement(std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc storage", 100 }, fcp));
+
+    const SimulationFileManager sfmSave{ simA, tempDir };
+    sfmSave.saveElementsToJson();
+
+    const auto simB = createSimulation("rt-fc-storage-loaded", 1.0, 0.0, 0.0);
+    const SimulationFileManager sfmLoad{ simB, tempDir + "rt-fc-storage/rt-fc-storage.dnf" };
+    sfmLoad.loadElementsFromJson();
+
+    const auto loaded = std::dynamic_pointer_cast<FieldCoupling>(simB->getElement("fc storage"));
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getParameters().weightStorage, WeightStorage::SPARSE);
+    EXPECT_DOUBLE_EQ(loaded->getParameters().pruneThreshold, 0.025);
+}
+
 TEST_F(SimulationFileManagerTest, RoundTripPreservesMemoryTraceParameters)
 {
     const MemoryTraceParameters mtp{ 150.0, 800.0, 0.3 };
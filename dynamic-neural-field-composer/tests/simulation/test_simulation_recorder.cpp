@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -10,6 +11,7 @@
 #include "elements/neural_field_2d.h"
 #include "elements/activation_function.h"
 #include "tools/utils.h"
+#include "tools/recording_file.h"
 
 using namespace dnf_composer;
 using namespace dnf_composer::element;
@@ -495,3 +497,266 @@ TEST(SimulationRecorderFailure, StartRecordingFailsWhenFileCannotBeOpened)
 
     cleanSimDir(simId);
 }
+
+// ---------------------------------------------------------------------------
+// Binary format (RecordingFormat::Binary)
+// ---------------------------------------------------------------------------
+
+static std::string findRecording(const std::string& simId, const std::string& extension)
+{
+    for (const auto& entry : fs::directory_iterator(recDir(simId)))
+        if (entry.path().extension() == extension)
+            return entry.path().string();
+    return {};
+}
+
+TEST(SimulationRecorderBinary, FramesAreExactAndHeaderDescribesTheRecording)
+{
+    const std::string simId = "rec-binary-2d";
+    cleanSimDir(simId);
+
+    const element::ElementDimensions dims2d{ 4, 5, 1.0, 1.0 };
+    element::NeuralField2DParameters nfp;
+    auto nf2d = std::make_shared<element::NeuralField2D>(
+        element::ElementCommonParameters{ "nf2d", dims2d }, nfp);
+    auto sim = createSimulation(simId, 1.0, 0.0, 0.0);
+    sim->addElement(nf2d);
+    sim->init();
+
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf2d", "activation", 1,
+        RecordingIntervalUnit::Ticks, RecordingFormat::Binary));
+    for (int i = 0; i < 3; ++i)
+        sim->step();
+    const std::vector<double> last = sim->getComponent("nf2d", "activation");
+    sim->getRecorder().stopAll();
+
+    EXPECT_TRUE(findRecording(simId, ".csv").empty());
+    const std::string path = findRecording(simId, ".dnfr");
+    ASSERT_FALSE(path.empty());
+    {
+        const tools::recording_file::MappedRecording recording(path);
+        const tools::recording_file::RecordingInfo expected{ "nf2d", "activation", 20, 4, 5, 1,
+            tools::recording_file::SampleUnit::Ticks };
+        EXPECT_EQ(recording.info(), expected);
+        ASSERT_EQ(recording.frameCount(), 3u);
+        EXPECT_EQ(recording.ticks(0), 1);
+        EXPECT_EQ(recording.ticks(2), 3);
+        EXPECT_EQ(recording.ms(2), sim->getT());
+        const auto frame = recording.frame(2);
+        EXPECT_EQ(std::vector<double>(frame.begin(), frame.end()), last);
+    }
+    cleanSimDir(simId);
+}
+
+TEST(SimulationRecorderBinary, ResizedComponentStopsTheRecording)
+{
+    const std::string simId = "rec-binary-resize";
+    cleanSimDir(simId);
+    auto sim = makeRunningSimulation(simId);
+
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", 1,
+        RecordingIntervalUnit::Ticks, RecordingFormat::Binary));
+    sim->step();
+    sim->changeDimensions("nf", element::ElementDimensions{ 20, 1.0 });
+    sim->step();
+    EXPECT_FALSE(sim->getRecorder().isRecording("nf", "activation"));
+
+    const tools::recording_file::MappedRecording recording(findRecording(simId, ".dnfr"));
+    EXPECT_EQ(recording.frameCount(), 1u);
+    EXPECT_EQ(recording.frameValues(), 10u);
+    cleanSimDir(simId);
+}
+
+// ---------------------------------------------------------------------------
+// Background writer (RecordingQueuePolicy / RecorderStats)
+// ---------------------------------------------------------------------------
+
+TEST(SimulationRecorderQueue, StatsAccountForEveryFrame)
+{
+    const std::string simId = "rec-queue-stats";
+    cleanSimDir(simId);
+    auto sim = makeRunningSimulation(simId);
+
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", 1, RecordingIntervalUnit::Ticks));
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+    sim->getRecorder().flush();
+
+    const RecorderStats stats = sim->getRecorder().getStats();
+    EXPECT_EQ(stats.framesQueued, 10u);
+    EXPECT_EQ(stats.framesWritten, 10u);
+    EXPECT_EQ(stats.framesDropped, 0u);
+    EXPECT_EQ(stats.queueDepth, 0u);
+    EXPECT_GE(stats.maxQueueDepth, 1u);
+    EXPECT_EQ(stats.capacity, RecordingQueuePolicy{}.capacity);
+    EXPECT_EQ(stats.bytesWritten, fs::file_size(findRecording(simId, ".csv")));
+
+    sim->getRecorder().stopAll();
+    cleanSimDir(simId);
+}
+
+TEST(SimulationRecorderQueue, DroppingPoliciesKeepTheFileConsistent)
+{
+    for (const auto overflow : { RecordingOverflow::DropNewest, RecordingOverflow::DropOldest })
+    {
+        const std::string simId = "rec-queue-drop";
+        cleanSimDir(simId);
+        auto sim = createSimulation(simId, 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<element::NeuralField2D>(
+            element::ElementCommonParameters{ "nf2d", element::ElementDimensions{ 64, 64, 1.0, 1.0 } },
+            element::NeuralField2DParameters{}));
+        sim->init();
+
+        ASSERT_TRUE(sim->getRecorder().setQueuePolicy({ 1, overflow }));
+        ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf2d", "activation", 1,
+            RecordingIntervalUnit::Ticks, RecordingFormat::Binary));
+        constexpr int steps = 50;
+        for (int i = 0; i < steps; ++i)
+            sim->step();
+        sim->getRecorder().stopAll();
+
+        // Whatever was dropped, every sample is accounted for and every frame
+        // that reached the file is whole and in order.
+        const RecorderStats stats = sim->getRecorder().getStats();
+        EXPECT_EQ(stats.framesQueued + (overflow == RecordingOverflow::DropNewest ? stats.framesDropped : 0),
+            static_cast<std::uint64_t>(steps));
+        EXPECT_EQ(stats.framesWritten + (overflow == RecordingOverflow::DropOldest ? stats.framesDropped : 0),
+            stats.framesQueued);
+        EXPECT_EQ(stats.blockedTime, std::chrono::nanoseconds{ 0 });
+        {
+            const tools::recording_file::MappedRecording recording(findRecording(simId, ".dnfr"));
+            EXPECT_EQ(recording.frameCount(), stats.framesWritten);
+            EXPECT_EQ(recording.trailingBytes(), 0u);
+            for (std::size_t k = 1; k < recording.frameCount(); ++k)
+                EXPECT_LT(recording.ticks(k - 1), recording.ticks(k));
+        }
+        cleanSimDir(simId);
+    }
+}
+
+TEST(SimulationRecorderQueue, PolicyCannotChangeWhileRecording)
+{
+    const std::string simId = "rec-queue-policy";
+    cleanSimDir(simId);
+    auto sim = makeRunningSimulation(simId);
+
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", 1, RecordingIntervalUnit::Ticks));
+    EXPECT_FALSE(sim->getRecorder().setQueuePolicy({ 8, RecordingOverflow::DropNewest }));
+    sim->getRecorder().stopAll();
+
+    EXPECT_TRUE(sim->getRecorder().setQueuePolicy({ 0, RecordingOverflow::DropNewest }));
+    EXPECT_EQ(sim->getRecorder().getQueuePolicy().capacity, 1u);
+    EXPECT_EQ(sim->getRecorder().getStats().capacity, 1u);
+    cleanSimDir(simId);
+}
+
+// ---------------------------------------------------------------------------
+// Regions and triggers (RecordingOptions::region / RecordingOptions::trigger)
+// ---------------------------------------------------------------------------
+
+TEST(SimulationRecorderRegion, StridedWindowOfA2DFieldIsRecorded)
+{
+    const std::string simId = "rec-region-2d";
+    cleanSimDir(simId);
+    auto sim = createSimulation(simId, 1.0, 0.0, 0.0);
+    sim->addElement(std::make_shared<element::NeuralField2D>(
+        element::ElementCommonParameters{ "nf2d", element::ElementDimensions{ 6, 5, 1.0, 1.0 } },
+        element::NeuralField2DParameters{}));
+    sim->init();
+
+    RecordingOptions options;
+    options.format = RecordingFormat::Binary;
+    options.region = { 1, 1, 4, 0, 2, 2 }; // columns 1 and 3, rows 1 and 3
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf2d", "activation", options));
+    sim->step();
+    sim->step();
+    const std::vector<double> last = sim->getComponent("nf2d", "activation");
+    sim->getRecorder().stopAll();
+
+    const tools::recording_file::MappedRecording recording(findRecording(simId, ".dnfr"));
+    EXPECT_EQ(recording.info().sizeX, 2);
+    EXPECT_EQ(recording.info().sizeY, 2);
+    EXPECT_EQ(recording.info().region, (tools::recording_file::SampledRegion{ 1, 1, 2, 2 }));
+    ASSERT_EQ(recording.frameCount(), 2u);
+    const auto frame = recording.frame(1);
+    EXPECT_EQ(std::vector<double>(frame.begin(), frame.end()),
+        (std::vector<double>{ last[1 * 6 + 1], last[1 * 6 + 3], last[3 * 6 + 1], last[3 * 6 + 3] }));
+    cleanSimDir(simId);
+}
+
+TEST(SimulationRecorderRegion, InvalidRegionsAreRejected)
+{
+    const std::string simId = "rec-region-invalid";
+    cleanSimDir(simId);
+    auto sim = makeRunningSimulation(simId);
+
+    RecordingOptions options;
+    options.region.strideX = 0;
+    EXPECT_FALSE(sim->getRecorder().startRecording(simId, "nf", "activation", options));
+
+    // Only the first step knows the component is 10 values long.
+    options.region = { 10, 0, 0, 0, 1, 1 };
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", options));
+    sim->step();
+    EXPECT_FALSE(sim->getRecorder().isRecording("nf", "activation"));
+    cleanSimDir(simId);
+}
+
+TEST(SimulationRecorderTrigger, ThresholdCrossingWritesTheSamplesAroundIt)
+{
+    const std::string simId = "rec-trigger-threshold";
+    cleanSimDir(simId);
+    auto sim = createSimulation(simId, 1.0, 0.0, 0.0);
+    auto stim = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim", 10 },
+        GaussStimulusParameters{ 2.0, 10.0, 5.0, true, false });
+    auto nf = makeField("nf");
+    nf->addInput(stim);
+    sim->addElement(stim);
+    sim->addElement(nf);
+    sim->init();
+
+    RecordingOptions options;
+    options.format = RecordingFormat::Binary;
+    options.trigger.on = RecordingTrigger::ThresholdCrossing;
+    options.trigger.threshold = 0.0;
+    options.trigger.preSamples = 2;
+    options.trigger.postSamples = 3;
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", options));
+
+    // The field rises from -5 towards 5 at the stimulus and crosses 0 once.
+    long long crossedAt = -1;
+    for (int i = 1; i <= 100; ++i)
+    {
+        sim->step();
+        if (crossedAt < 0 && nf->getHighestActivation() >= 0.0)
+            crossedAt = i;
+    }
+    ASSERT_GT(crossedAt, 3);
+    sim->getRecorder().stopAll();
+    EXPECT_EQ(sim->getRecorder().getStats().triggers, 1u);
+
+    const tools::recording_file::MappedRecording recording(findRecording(simId, ".dnfr"));
+    ASSERT_EQ(recording.frameCount(), 6u);
+    for (std::size_t k = 0; k < 6; ++k)
+        EXPECT_EQ(recording.ticks(k), crossedAt - 2 + static_cast<long long>(k));
+    const auto before = recording.frame(1);
+    const auto at = recording.frame(2);
+    EXPECT_LT(*std::max_element(before.begin(), before.end()), 0.0);
+    EXPECT_GE(*std::max_element(at.begin(), at.end()), 0.0);
+    cleanSimDir(simId);
+}
+
+TEST(SimulationRecorderTrigger, TriggerElementMustBeANeuralField)
+{
+    const std::string simId = "rec-trigger-element";
+    cleanSimDir(simId);
+    auto sim = makeRunningSimulation(simId);
+
+    RecordingOptions options;
+    options.trigger.on = RecordingTrigger::StabilityChange;
+    options.trigger.elementId = "stim";
+    ASSERT_TRUE(sim->getRecorder().startRecording(simId, "nf", "activation", options));
+    sim->step();
+    EXPECT_FALSE(sim->getRecorder().isRecording("nf", "activation"));
+    cleanSimDir(simId);
+}
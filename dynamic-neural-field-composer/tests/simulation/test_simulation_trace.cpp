@@ -0,0 +1,119 @@
+// Tests for timeline tracing through Simulation::startTrace / stopTrace
+// (tools/trace.h). Durations depend on the machine; only which spans appear
+// and on how many threads are checked.
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "simulation/simulation.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/neural_field.h"
+#include "elements/activation_function.h"
+#include "tools/utils.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr int kSize = 50;
+
+    std::shared_ptr<Simulation> makeSimulation(const std::string& id)
+    {
+        auto sim = createSimulation(id, 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus>(
+            ElementCommonParameters{ "stim", kSize },
+            GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false }));
+        sim->addElement(std::make_shared<NeuralField>(
+            ElementCommonParameters{ "nf", kSize },
+            NeuralFieldParameters{ 25.0, -5.0, SigmoidFunction{ 0.0, 10.0 } }));
+        sim->createInteraction("stim", "output", "nf");
+        return sim;
+    }
+
+    // Complete events per name, and the threads they ran on.
+    struct TraceSummary
+    {
+        std::map<std::string, int> counts;
+        std::set<int> elementThreads;
+    };
+
+    TraceSummary summarize(const std::string& path)
+    {
+        std::ifstream in(path);
+        const nlohmann::json trace = nlohmann::json::parse(in);
+        TraceSummary summary;
+        for (const auto& event : trace["traceEvents"])
+        {
+            if (event["ph"] != "X")
+                continue;
+            ++summary.counts[event["name"].get<std::string>()];
+            if (event["cat"] == "element")
+                summary.elementThreads.insert(event["tid"].get<int>());
+        }
+        return summary;
+    }
+
+    void cleanSimDir(const std::string& simId)
+    {
+        const fs::path dir = fs::path(tools::utils::getResourceRoot()) / "data" / simId;
+        if (fs::exists(dir))
+            fs::remove_all(dir);
+    }
+}
+
+TEST(SimulationTrace, StepsAndElementsAreTraced)
+{
+    const std::string simId = "trace-serial-test";
+    auto sim = makeSimulation(simId);
+    sim->startTrace();
+    EXPECT_TRUE(sim->isTracing());
+    sim->init();
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+    const std::string path = sim->stopTrace();
+    EXPECT_FALSE(sim->isTracing());
+
+    ASSERT_FALSE(path.empty());
+    EXPECT_EQ(fs::path(path).parent_path(),
+              fs::path(tools::utils::getResourceRoot()) / "data" / simId / "traces");
+    const TraceSummary summary = summarize(path);
+    EXPECT_EQ(summary.counts.at("Simulation::init"), 1);
+    EXPECT_EQ(summary.counts.at("Simulation::step"), 10);
+    EXPECT_EQ(summary.counts.at("stim"), 10);
+    EXPECT_EQ(summary.counts.at("nf"), 10);
+    EXPECT_EQ(summary.elementThreads.size(), 1u);
+
+    // Stepping after the trace records nothing more.
+    sim->step();
+    EXPECT_EQ(sim->stopTrace(), "");
+    cleanSimDir(simId);
+}
+
+TEST(SimulationTrace, ScheduledStepsAreTraced)
+{
+    const std::string simId = "trace-threaded-test";
+    auto sim = makeSimulation(simId);
+    sim->setThreadCount(2);
+    sim->init();
+    const std::string path = (fs::path(tools::utils::getResourceRoot()) / "data" / simId / "custom.json").string();
+    sim->startTrace(path);
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+    EXPECT_EQ(sim->stopTrace(), path);
+
+    const TraceSummary summary = summarize(path);
+    EXPECT_EQ(summary.counts.count("Simulation::init"), 0u);
+    EXPECT_EQ(summary.counts.at("stim"), 10);
+    EXPECT_EQ(summary.counts.at("nf"), 10);
+    cleanSimDir(simId);
+}
@@ -0,0 +1,223 @@
+// Tests for spectrum sharing between 2D spectral kernels (SpectralSharing,
+// Simulation::setSpectrumSharing). ForwardTransforms must be bit-identical to
+// Off in every update mode and at any thread count; Fused must give the
+// consumers the same input up to rounding.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "simulation/spectral_sharing.h"
+#include "elements/gauss_stimulus_2d.h"
+#include "elements/gauss_kernel_2d.h"
+#include "elements/mexican_hat_kernel_2d.h"
+#include "elements/oscillatory_kernel_2d.h"
+#include "elements/asymmetric_gauss_kernel_2d.h"
+#include "elements/neural_field_2d.h"
+#include "elements/activation_function.h"
+#include "tools/fft_convolution.h"
+#include "scoped_min_log_level.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+
+namespace
+{
+    constexpr int kGrid = 32;
+
+    ElementCommonParameters makeCP(const std::string& name)
+    {
+        return ElementCommonParameters{ name, ElementDimensions(kGrid, kGrid, 1.0, 1.0) };
+    }
+
+    // Five spectral kernels all reading u's output:
+    //  - "early a"/"early b" (u -> v) registered before u, so they read u's
+    //    previous-step value;
+    //  - "self" and "osc" (u -> u) and "mex" (u -> v) registered after u,
+    //    so they read this step's value.
+    // Must be built under ConvolutionMode::ForceSpectral: 32x32 is below the
+    // Auto rule's axis floor.
+    std::shared_ptr<Simulation> buildSim()
+    {
+        auto sim = std::make_shared<Simulation>("spectral sharing", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus2D>(makeCP("stim"),
+            GaussStimulus2DParameters{ 3.0, 8.0, 12.0, 20.0, true, false }));
+        sim->addElement(std::make_shared<AsymmetricGaussKernel2D>(makeCP("early a"),
+            AsymmetricGaussKernel2DParameters{ 2.0, 1.5, 0.0, 0.5, -0.5, true, true }));
+        sim->addElement(std::make_shared<GaussKernel2D>(makeCP("early b"),
+            GaussKernel2DParameters{ 3.0, 2.0, -0.01, true, true }));
+        sim->addElement(std::make_shared<NeuralField2D>(makeCP("u"),
+            NeuralField2DParameters{ 10.0, -3.0, SigmoidFunction{ 0.0, 4.0 } }));
+        sim->addElement(std::make_shared<NeuralField2D>(makeCP("v"),
+            NeuralField2DParameters{ 10.0, -3.0, SigmoidFunction{ 0.0, 4.0 } }));
+        sim->addElement(std::make_shared<GaussKernel2D>(makeCP("self"),
+            GaussKernel2DParameters{ 2.0, 4.0, -0.02, true, true }));
+        sim->addElement(std::make_shared<MexicanHatKernel2D>(makeCP("mex"),
+            MexicanHatKernel2DParameters{ 2.0, 6.0, 4.0, 5.0, -0.05, true, true }));
+        sim->addElement(std::make_shared<OscillatoryKernel2D>(makeCP("osc"),
+            OscillatoryKernel2DParameters{ 1.0, 0.2, 0.3, 0.0, true, true }));
+
+        sim->createInteraction("stim", "output", "u");
+        for (const std::string kernel : { "early a", "early b", "self", "mex", "osc" })
+            sim->createInteraction("u", "output", kernel);
+        sim->createInteraction("early a", "output", "v");
+        sim->createInteraction("early b", "output", "v");
+        sim->createInteraction("self", "output", "u");
+        sim->createInteraction("osc", "output", "u");
+        sim->createInteraction("mex", "output", "v");
+        return sim;
+    }
+
+    const std::vector<std::string> kObserved{ "u", "v", "early a", "early b", "self", "mex", "osc" };
+
+    std::vector<std::vector<double>> run(Simulation& sim, int steps)
+    {
+        for (int i = 0; i < steps; ++i)
+            sim.step();
+        std::vector<std::vector<double>> values;
+        for (const auto& name : kObserved)
+            values.push_back(sim.getComponent(name, "output"));
+        values.push_back(sim.getComponent("u", "activation"));
+        values.push_back(sim.getComponent("v", "activation"));
+        return values;
+    }
+
+    std::vector<std::vector<double>> runWith(SpectrumSharing sharing, UpdateMode mode, int threads, int steps = 12)
+    {
+        const auto sim = buildSim();
+        sim->setSpectrumSharing(sharing);
+        sim->setUpdateMode(mode);
+        sim->setThreadCount(threads);
+        sim->init();
+        return run(*sim, steps);
+    }
+}
+
+TEST(SpectralSharing, GroupsKernelsBySourceAndSide)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    tools::math::ScopedConvolutionMode spectral(tools::math::ConvolutionMode::ForceSpectral);
+    const auto sim = buildSim();
+
+    SpectralSharing sequential;
+    sequential.build(sim->getElements(), false, SpectrumSharing::ForwardTransforms);
+    EXPECT_EQ(sequential.getNumberOfSharedSpectra(), 2u); // before u, after u
+    EXPECT_EQ(sequential.getNumberOfFusedKernels(), 0u);
+    EXPECT_TRUE(sequential.isCurrent(sim->getElements()));
+
+    sim->setUpdateMode(UpdateMode::Synchronous);
+    SpectralSharing synchronous;
+    synchronous.build(sim->getElements(), true, SpectrumSharing::ForwardTransforms);
+    EXPECT_EQ(synchronous.getNumberOfSharedSpectra(), 1u); // everyone reads u's front buffer
+}
+
+TEST(SpectralSharing, FusesKernelsFeedingTheSameFieldFromTheSameSide)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    tools::math::ScopedConvolutionMode spectral(tools::math::ConvolutionMode::ForceSpectral);
+    const auto sim = buildSim();
+
+    SpectralSharing sequential;
+    sequential.build(sim->getElements(), false, SpectrumSharing::Fused);
+    // "osc" into "self" (both -> u, after u), "early b" into "early a"
+    // (both -> v, before v). "mex" reads the new u, the early pair the old one.
+    EXPECT_EQ(sequential.getNumberOfFusedKernels(), 2u);
+    EXPECT_TRUE(std::dynamic_pointer_cast<Kernel>(sim->getElement("osc"))->isFusedAway());
+    EXPECT_FALSE(std::dynamic_pointer_cast<Kernel>(sim->getElement("self"))->isFusedAway());
+
+    sim->setUpdateMode(UpdateMode::Synchronous);
+    SpectralSharing synchronous;
+    synchronous.build(sim->getElements(), true, SpectrumSharing::Fused);
+    // One spectrum: "early b" and "mex" fuse into "early a" as well.
+    EXPECT_EQ(synchronous.getNumberOfFusedKernels(), 3u);
+
+    synchronous.clear();
+    EXPECT_FALSE(std::dynamic_pointer_cast<Kernel>(sim->getElement("osc"))->isFusedAway());
+}
+
+TEST(SpectralSharing, SharedForwardTransformsAreBitIdenticalToUnshared)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    tools::math::ScopedConvolutionMode spectral(tools::math::ConvolutionMode::ForceSpectral);
+
+    for (const UpdateMode mode : { UpdateMode::Sequential, UpdateMode::Synchronous })
+    {
+        const auto reference = runWith(SpectrumSharing::Off, mode, 1);
+        for (const int threads : { 1, 3 })
+        {
+            SCOPED_TRACE(::testing::Message() << (mode == UpdateMode::Synchronous ? "synchronous" : "sequential")
+                                              << ", threads=" << threads);
+            const auto shared = runWith(SpectrumSharing::ForwardTransforms, mode, threads);
+            ASSERT_EQ(shared.size(), reference.size());
+            for (size_t i = 0; i < shared.size(); ++i)
+                EXPECT_EQ(shared[i], reference[i]) << "component " << i;
+        }
+    }
+}
+
+TEST(SpectralSharing, FusedKernelsGiveTheFieldsTheSameInput)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    tools::math::ScopedConvolutionMode spectral(tools::math::ConvolutionMode::ForceSpectral);
+
+    const auto reference = buildSim();
+    reference->setSpectrumSharing(SpectrumSharing::Off);
+    reference->init();
+    const auto fused = buildSim();
+    fused->setSpectrumSharing(SpectrumSharing::Fused);
+    fused->init();
+
+    for (int i = 0; i < 12; ++i)
+    {
+        reference->step();
+        fused->step();
+    }
+
+    for (const std::string field : { "u", "v" })
+    {
+        const auto expected = reference->getComponent(field, "activation");
+        const auto got = fused->getComponent(field, "activation");
+        for (size_t i = 0; i < expected.size(); ++i)
+            EXPECT_NEAR(got[i], expected[i], 1e-9) << field << " at " << i;
+    }
+
+    // "osc" has no global term, so with its convolution carried by "self" its
+    // output is all zeros; "self" carries both.
+    const auto osc = fused->getComponent("osc", "output");
+    EXPECT_TRUE(std::ranges::all_of(osc, [](double v) { return v == 0.0; }));
+    const auto selfRef = reference->getComponent("self", "output");
+    const auto oscRef = reference->getComponent("osc", "output");
+    const auto self = fused->getComponent("self", "output");
+    for (size_t i = 0; i < self.size(); ++i)
+        EXPECT_NEAR(self[i], selfRef[i] + oscRef[i], 1e-9) << "at " << i;
+
+    // A clone is not part of the simulation's plan.
+    const auto clone = std::dynamic_pointer_cast<Kernel>(fused->getElement("osc")->clone());
+    EXPECT_FALSE(clone->isFusedAway());
+}
+
+TEST(SpectralSharing, ReparameterisedKernelIsReplanned)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    tools::math::ScopedConvolutionMode spectral(tools::math::ConvolutionMode::ForceSpectral);
+
+    const auto reference = buildSim();
+    reference->setSpectrumSharing(SpectrumSharing::Off);
+    reference->init();
+    const auto shared = buildSim();
+    shared->init();
+
+    run(*reference, 5);
+    run(*shared, 5);
+
+    const MexicanHatKernel2DParameters wider{ 3.0, 6.0, 6.0, 5.0, -0.05, true, true };
+    for (const auto& sim : { reference, shared })
+        std::dynamic_pointer_cast<MexicanHatKernel2D>(sim->getElement("mex"))->setParameters(wider);
+
+    EXPECT_EQ(run(*shared, 5), run(*reference, 5));
+}
@@ -0,0 +1,193 @@
+// Tests for per-element step-time profiling (Simulation::setProfiling /
+// StepProfiler). Durations depend on the machine, so only counts, names and
+// the ordering of the percentiles are checked.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "simulation/simulation.h"
+#include "simulation/step_profiler.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/neural_field.h"
+#include "elements/activation_function.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+
+namespace
+{
+    constexpr int kSize = 50;
+
+    std::shared_ptr<Simulation> makeSimulation()
+    {
+        auto sim = createSimulation("step profiler", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus>(
+            ElementCommonParameters{ "stim", kSize },
+            GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false }));
+        sim->addElement(std::make_shared<NeuralField>(
+            ElementCommonParameters{ "nf", kSize },
+            NeuralFieldParameters{ 25.0, -5.0, SigmoidFunction{ 0.0, 10.0 } }));
+        sim->createInteraction("stim", "output", "nf");
+        return sim;
+    }
+
+    const StepTiming* find(const std::vector<StepTiming>& timings, const std::string& name)
+    {
+        const auto it = std::ranges::find(timings, name, &StepTiming::name);
+        return it != timings.end() ? &*it : nullptr;
+    }
+
+    void expectOrdered(const StepTiming& timing)
+    {
+        EXPECT_LE(timing.p50, timing.p99) << timing.name;
+        EXPECT_LE(timing.p99, timing.max) << timing.name;
+        EXPECT_LE(timing.mean, timing.max) << timing.name;
+        EXPECT_GE(timing.total, timing.max) << timing.name;
+    }
+}
+
+TEST(StepProfiler, OffByDefault)
+{
+    auto sim = makeSimulation();
+    sim->init();
+    for (int i = 0; i < 5; ++i)
+        sim->step();
+    EXPECT_FALSE(sim->isProfiling());
+    EXPECT_TRUE(sim->getProfile().elements.empty());
+    EXPECT_TRUE(sim->getProfile().types.empty());
+}
+
+TEST(StepProfiler, TimesEveryElementStep)
+{
+    auto sim = makeSimulation();
+    sim->setProfiling(true);
+    sim->init();
+    for (int i = 0; i < 20; ++i)
+        sim->step();
+
+    const StepProfile profile = sim->getProfile();
+    ASSERT_EQ(profile.elements.size(), 2u);
+    EXPECT_EQ(profile.elements[0].name, "stim");
+    EXPECT_EQ(profile.elements[1].name, "nf");
+    for (const auto& timing : profile.elements)
+    {
+        EXPECT_EQ(timing.steps, 20u) << timing.name;
+        expectOrdered(timing);
+    }
+
+    ASSERT_EQ(profile.types.size(), 2u);
+    EXPECT_NE(find(profile.types, "neural field"), nullptr);
+    EXPECT_NE(find(profile.types, "gauss stimulus"), nullptr);
+    EXPECT_GE(profile.types[0].total, profile.types[1].total);
+}
+
+TEST(StepProfiler, TimesStepsOnTheScheduler)
+{
+    auto sim = makeSimulation();
+    sim->setThreadCount(2);
+    sim->setProfiling(true);
+    sim->init();
+    for (int i = 0; i < 20; ++i)
+        sim->step();
+
+    const StepProfile profile = sim->getProfile();
+    ASSERT_EQ(profile.elements.size(), 2u);
+    for (const auto& timing : profile.elements)
+    {
+        EXPECT_EQ(timing.steps, 20u) << timing.name;
+        expectOrdered(timing);
+    }
+}
+
+TEST(StepProfiler, KeepsHistogramsWhenElementsAreAdded)
+{
+    auto sim = makeSimulation();
+    sim->setProfiling(true);
+    sim->init();
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+
+    sim->addElement(std::make_shared<GaussStimulus>(
+        ElementCommonParameters{ "stim 2", kSize },
+        GaussStimulusParameters{ 5.0, 6.0, 10.0, true, false }));
+    for (int i = 0; i < 5; ++i)
+        sim->step();
+
+    const StepProfile profile = sim->getProfile();
+    ASSERT_EQ(profile.elements.size(), 3u);
+    EXPECT_EQ(find(profile.elements, "nf")->steps, 15u);
+    EXPECT_EQ(find(profile.elements, "stim 2")->steps, 5u);
+    EXPECT_EQ(find(profile.types, "gauss stimulus")->steps, 20u);
+
+    sim->resetProfile();
+    for (const auto& timing : sim->getProfile().elements)
+    {
+        EXPECT_EQ(timing.steps, 0u) << timing.name;
+        EXPECT_EQ(timing.max.count(), 0) << timing.name;
+    }
+}
+
+TEST(StepProfiler, DisablingKeepsTheRecordedSteps)
+{
+    auto sim = makeSimulation();
+    sim->setProfiling(true);
+    sim->init();
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+
+    sim->setProfiling(false);
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+
+    EXPECT_FALSE(sim->isProfiling());
+    EXPECT_EQ(find(sim->getProfile().elements, "nf")->steps, 10u);
+}
+
+TEST(StepProfiler, ReplacedElementsStartAfreshAndRenamesKeepTheirSteps)
+{
+    auto sim = makeSimulation();
+    sim->setProfiling(true);
+    sim->init();
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+
+    // A new element under an old name, possibly at the old element's address.
+    sim->removeElement("stim");
+    sim->addElement(std::make_shared<GaussStimulus>(
+        ElementCommonParameters{ "stim", kSize },
+        GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false }));
+    sim->renameElement("nf", "field");
+    for (int i = 0; i < 5; ++i)
+        sim->step();
+
+    const StepProfile profile = sim->getProfile();
+    ASSERT_EQ(profile.elements.size(), 2u);
+    ASSERT_NE(find(profile.elements, "stim"), nullptr);
+    EXPECT_EQ(find(profile.elements, "stim")->steps, 5u);
+    ASSERT_NE(find(profile.elements, "field"), nullptr);
+    EXPECT_EQ(find(profile.elements, "field")->steps, 15u);
+    EXPECT_EQ(find(profile.elements, "nf"), nullptr);
+}
+
+TEST(StepProfiler, SlotsFollowElementsNotAddresses)
+{
+    StepProfiler profiler;
+    auto first = std::make_shared<GaussStimulus>(
+        ElementCommonParameters{ "first", kSize }, GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false });
+    profiler.sync({ first });
+    profiler.record(0, std::chrono::microseconds(10));
+
+    // Another element: its slot starts empty even if it shares the address.
+    auto second = std::make_shared<GaussStimulus>(
+        ElementCommonParameters{ "second", kSize }, GaussStimulusParameters{ 5.0, 6.0, 25.0, true, false });
+    first.reset();
+    profiler.sync({ second });
+    const StepProfile profile = profiler.profile();
+    ASSERT_EQ(profile.elements.size(), 1u);
+    EXPECT_EQ(profile.elements[0].name, "second");
+    EXPECT_EQ(profile.elements[0].steps, 0u);
+}
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simulation/simulation.h"
+#include "simulation/weight_checkpointer.h"
+#include "elements/field_coupling.h"
+#include "tools/weight_file.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::element;
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::shared_ptr<FieldCoupling> makeFC(const std::string& name, int inSize, int outSize,
+        WeightStorage storage = WeightStorage::DENSE)
+    {
+        FieldCouplingParameters fcp{ ElementDimensions{ inSize, 1.0 }, LearningRule::HEBB, 1.0, 0.01, 0.0, storage };
+        return std::make_shared<FieldCoupling>(ElementCommonParameters{ name, outSize }, fcp);
+    }
+
+    void fillWeights(FieldCoupling& fc, double phase)
+    {
+        auto& weights = *fc.getComponentPtr("weights");
+        for (std::size_t k = 0; k < weights.size(); ++k)
+            weights[k] = (k % 3 == 0) ? 0.0 : std::sin(phase + 0.1 * static_cast<double>(k));
+    }
+
+    std::vector<double> readDense(const std::string& file)
+    {
+        const tools::weight_file::MappedWeightFile mapped(file);
+        std::vector<double> dense(mapped.rows() * mapped.cols());
+        mapped.copyDenseInto(dense);
+        return dense;
+    }
+}
+
+class WeightCheckpointerTest : public ::testing::Test
+{
+protected:
+    std::string tempDir;
+    std::shared_ptr<Simulation> sim;
+    std::shared_ptr<FieldCoupling> fc;
+
+    void SetUp() override
+    {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        tempDir = (fs::temp_directory_path() / "dnf_checkpoint_tests" / info->name()).string();
+        fs::remove_all(tempDir);
+
+        sim = createSimulation("checkpoint-test", 1.0, 0.0, 0.0);
+        fc = makeFC("fc", 12, 20);
+        sim->addElement(fc);
+        sim->init();
+        fillWeights(*fc, 0.0);
+    }
+
+    void TearDown() override
+    {
+        sim->getCheckpointer().stop();
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    std::string checkpointFile(const std::string& checkpoint, const std::string& name = "fc") const
+    {
+        return (fs::path(checkpoint) / (name + "_weights.dnfw")).string();
+    }
+};
+
+TEST_F(WeightCheckpointerTest, InactiveByDefault)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    EXPECT_FALSE(checkpointer.isActive());
+    EXPECT_FALSE(checkpointer.checkpointNow(*sim));
+    sim->step();
+    EXPECT_EQ(checkpointer.getStats().snapshotsTaken, 0u);
+    checkpointer.flush(); // no writer: returns at once
+}
+
+TEST_F(WeightCheckpointerTest, StepTriggerWritesAndRotates)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, { .everySteps = 2, .keep = 2 }));
+    for (int i = 0; i < 10; ++i)
+        sim->step();
+    checkpointer.flush();
+
+    const auto stats = checkpointer.getStats();
+    EXPECT_EQ(stats.snapshotsTaken, 5u);
+    EXPECT_EQ(stats.checkpointsWritten + stats.snapshotsSuperseded, 5u);
+    EXPECT_EQ(stats.writeFailures, 0u);
+    EXPECT_GT(stats.bytesWritten, 0u);
+
+    // The last snapshot is never superseded, and only the newest two are kept.
+    const auto checkpoints = WeightCheckpointer::listCheckpoints(tempDir);
+    ASSERT_FALSE(checkpoints.empty());
+    EXPECT_LE(checkpoints.size(), 2u);
+    EXPECT_EQ(fs::path(checkpoints.back()).filename(), "checkpoint_0000000004_0000000010");
+    EXPECT_EQ(stats.lastCheckpoint, checkpoints.back());
+    for (const auto& entry : fs::directory_iterator(tempDir))
+        EXPECT_FALSE(entry.path().filename().string().ends_with(".tmp")) << entry.path();
+}
+
+TEST_F(WeightCheckpointerTest, SnapshotIsTheStateAtTheStepBoundary)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, {}));
+    const std::vector<double> expected = fc->getComponentPtr("weights")->toVector();
+    ASSERT_TRUE(checkpointer.checkpointNow(*sim));
+    fillWeights(*fc, 1.0); // changed before the writer is likely to have run
+    checkpointer.flush();
+
+    EXPECT_EQ(readDense(checkpointFile(checkpointer.getStats().lastCheckpoint)), expected);
+    EXPECT_TRUE(tools::weight_file::MappedWeightFile(checkpointFile(checkpointer.getStats().lastCheckpoint)).verifyChecksum());
+}
+
+TEST_F(WeightCheckpointerTest, SparseCouplingWritesCsr)
+{
+    const auto sparse = makeFC("sparse-fc", 8, 10, WeightStorage::SPARSE);
+    sim->addElement(sparse);
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, {}));
+    ASSERT_TRUE(checkpointer.checkpointNow(*sim));
+    checkpointer.flush();
+
+    const std::string checkpoint = checkpointer.getStats().lastCheckpoint;
+    EXPECT_EQ(tools::weight_file::MappedWeightFile(checkpointFile(checkpoint, "sparse-fc")).layout(),
+        tools::weight_file::WeightLayout::Csr);
+    EXPECT_EQ(tools::weight_file::MappedWeightFile(checkpointFile(checkpoint)).layout(),
+        tools::weight_file::WeightLayout::Dense);
+}
+
+TEST_F(WeightCheckpointerTest, RestoreLoadsWeightsAndKeepsCouplingSettings)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, {}));
+    const std::vector<double> saved = fc->getComponentPtr("weights")->toVector();
+    ASSERT_TRUE(checkpointer.checkpointNow(*sim));
+    checkpointer.flush();
+
+    fc->setWeightsDirectory("elsewhere");
+    fc->clearWeights();
+    EXPECT_EQ(WeightCheckpointer::restore(*sim, checkpointer.getStats().lastCheckpoint), 1);
+    EXPECT_EQ(fc->getComponentPtr("weights")->toVector(), saved);
+    // Not left mapped, or rotation could not delete the checkpoint on Windows.
+    EXPECT_FALSE(fc->getComponentPtr("weights")->isExternallyBacked());
+    EXPECT_EQ(fc->getWeightsDirectory(), "elsewhere");
+    EXPECT_EQ(fc->getWeightFileFormat(), WeightFileFormat::TEXT);
+}
+
+TEST_F(WeightCheckpointerTest, RestoreCountsOnlyCouplingsThatLoaded)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, {}));
+    ASSERT_TRUE(checkpointer.checkpointNow(*sim));
+    checkpointer.flush();
+
+    // A file of the wrong size is logged and skipped, not counted.
+    const std::string checkpoint = checkpointer.getStats().lastCheckpoint;
+    const std::vector<double> wrongSize(3 * 4, 1.0);
+    tools::weight_file::writeDense(checkpointFile(checkpoint), wrongSize, 3, 4);
+    EXPECT_EQ(WeightCheckpointer::restore(*sim, checkpoint), 0);
+}
+
+TEST_F(WeightCheckpointerTest, RestartedSimulationRotatesByWriteOrder)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, { .everySteps = 2, .keep = 2 }));
+    for (int i = 0; i < 6; ++i)
+    {
+        sim->step();
+        checkpointer.flush(); // no snapshot superseded
+    }
+    checkpointer.stop();
+    const auto before = WeightCheckpointer::listCheckpoints(tempDir);
+    ASSERT_EQ(before.size(), 2u);
+
+    // The restarted simulation counts ticks from 0 again: its checkpoints at
+    // ticks 2 and 4 are the newest, and replace the old run's rather than being
+    // deleted first or overwriting the old tick-4 checkpoint.
+    auto restarted = createSimulation("checkpoint-test", 1.0, 0.0, 0.0);
+    const auto restartedFc = makeFC("fc", 12, 20);
+    restarted->addElement(restartedFc);
+    restarted->init();
+    fillWeights(*restartedFc, 2.0);
+    const std::vector<double> newest = restartedFc->getComponentPtr("weights")->toVector();
+    auto& again = restarted->getCheckpointer();
+    ASSERT_TRUE(again.start(tempDir, { .everySteps = 2, .keep = 2 }));
+    for (int i = 0; i < 4; ++i)
+    {
+        restarted->step();
+        again.flush();
+    }
+
+    const auto after = WeightCheckpointer::listCheckpoints(tempDir);
+    ASSERT_EQ(after.size(), 2u);
+    for (const auto& old : before)
+        EXPECT_FALSE(fs::exists(old)) << old;
+    EXPECT_TRUE(fs::path(after.front()).filename().string().ends_with("_0000000002"));
+    EXPECT_EQ(after.back(), again.getStats().lastCheckpoint);
+    EXPECT_EQ(readDense(checkpointFile(after.back())), newest);
+    again.stop();
+}
+
+TEST_F(WeightCheckpointerTest, TimeTriggerFires)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, { .everySeconds = 0.001 }));
+    sim->step();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    sim->step();
+    checkpointer.flush();
+    EXPECT_EQ(checkpointer.getStats().snapshotsTaken, 1u);
+    EXPECT_EQ(WeightCheckpointer::listCheckpoints(tempDir).size(), 1u);
+}
+
+TEST_F(WeightCheckpointerTest, CloseWritesQueuedCheckpointAndStops)
+{
+    auto& checkpointer = sim->getCheckpointer();
+    ASSERT_TRUE(checkpointer.start(tempDir, { .everySteps = 1, .keep = 0 }));
+    sim->step();
+    sim->close();
+    EXPECT_FALSE(checkpointer.isActive());
+    const auto stats = checkpointer.getStats();
+    EXPECT_EQ(stats.snapshotsTaken, 1u);
+    EXPECT_EQ(stats.checkpointsWritten, 1u);
+    EXPECT_EQ(WeightCheckpointer::listCheckpoints(tempDir).size(), 1u);
+}
+
+TEST_F(WeightCheckpointerTest, StartFailsWhenDirectoryCannotBeCreated)
+{
+    fs::create_directories(tempDir);
+    const std::string file = tempDir + "/not-a-directory";
+    std::ofstream(file) << "x";
+    EXPECT_FALSE(sim->getCheckpointer().start(file, {}));
+    EXPECT_FALSE(sim->getCheckpointer().isActive());
+}
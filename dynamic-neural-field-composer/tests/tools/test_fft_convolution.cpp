@@ -5,6 +5,9 @@
 #include <numeric>
 #include <algorithm>
 #include <stdexcept>
+#include <filesystem>
+#include <chrono>
+#include <thread>
 
 #include "tools/math.h"
 #include "tools/fft_convolution.h"
@@ -329,6 +332,362 @@ TEST(SpectralConvolver2DLifecycle, SelfCopyAssignIsSafe)
     for (size_t i = 0; i < before.size(); ++i) EXPECT_DOUBLE_EQ(before[i], after[i]);
 }
 
+// ---------------------------------------------------------------------------
+// Precision::Single -- the fftwf-backed path. Float transforms put the
+// round-trip noise near 1e-7 of the spectral magnitudes instead of 1e-16, so
+// the comparison is relative to the output scale at float tolerance.
+// ---------------------------------------------------------------------------
+
+TEST(SpectralConvolver2DSingle, MatchesDirectWithinFloatTolerance)
+{
+    const int sx = 100, sy = 128;
+    std::vector<double> taps_x(15), taps_y(11);
+    for (size_t i = 0; i < taps_x.size(); ++i) taps_x[i] = 1.0 + 0.3 * static_cast<double>(i);
+    for (size_t i = 0; i < taps_y.size(); ++i) taps_y[i] = 0.5 + 0.1 * static_cast<double>(i * i);
+    const auto field = ramp(sx * sy);
+    const auto direct = directConvolve(field, taps_x, 4, taps_y, 7, sx, sy);
+
+    SpectralConvolver2D conv;
+    conv.init(sx, sy, Precision::Single);
+    conv.setKernel(buildWrappedSeparableKernel2D(sx, sy,
+        { SeparableKernelTerm2D{ taps_x, 4, taps_y, 7, +1.0 } }));
+    std::vector<double> spectral(static_cast<size_t>(sx) * sy);
+    conv.apply(field.data(), spectral.data());
+
+    double maxAbsDev = 0.0, maxAbsRef = 0.0;
+    for (size_t i = 0; i < direct.size(); ++i)
+    {
+        maxAbsDev = std::max(maxAbsDev, std::abs(spectral[i] - direct[i]));
+        maxAbsRef = std::max(maxAbsRef, std::abs(direct[i]));
+    }
+    EXPECT_LT(maxAbsDev / maxAbsRef, 1e-5) << "max abs deviation = " << maxAbsDev;
+}
+
+TEST(SpectralConvolver2DSingle, PrecisionChangeReplansAndCopiesCarryIt)
+{
+    const int sx = 64, sy = 64;
+    const auto taps = gaussianTaps(8, 3.0);
+    const auto field = ramp(sx * sy);
+    const auto kernel = buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 8, taps, 8, 1.0 } });
+
+    SpectralConvolver2D conv;
+    conv.init(sx, sy, Precision::Double);
+    conv.setKernel(kernel);
+    std::vector<double> asDouble(sx * sy);
+    conv.apply(field.data(), asDouble.data());
+
+    // Same size, other precision: must not be short-circuited as a no-op.
+    conv.init(sx, sy, Precision::Single);
+    conv.setKernel(kernel);
+    std::vector<double> asSingle(sx * sy);
+    conv.apply(field.data(), asSingle.data());
+
+    const SpectralConvolver2D copy(conv);
+    SpectralConvolver2D copyMutable(copy);
+    std::vector<double> fromCopy(sx * sy);
+    copyMutable.apply(field.data(), fromCopy.data());
+
+    bool anyDifferent = false;
+    for (size_t i = 0; i < asDouble.size(); ++i)
+    {
+        EXPECT_NEAR(asSingle[i], asDouble[i], 1e-4);
+        EXPECT_DOUBLE_EQ(fromCopy[i], asSingle[i]);
+        anyDifferent = anyDifferent || asSingle[i] != asDouble[i];
+    }
+    EXPECT_TRUE(anyDifferent) << "Single produced bit-identical output; the float path did not run";
+}
+
+TEST(SpectralConvolver2DSingle, FloatBuffersGiveTheSameResultAsDoubleOnes)
+{
+    const int sx = 64, sy = 48;
+    const auto taps = gaussianTaps(6, 2.5);
+    const auto field = ramp(sx * sy);
+    const auto kernel = buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 6, taps, 6, 1.0 } });
+
+    SpectralConvolver2D conv;
+    conv.init(sx, sy, Precision::Single);
+    conv.setKernel(kernel);
+    std::vector<double> viaDouble(sx * sy);
+    conv.apply(field.data(), viaDouble.data());
+
+    const std::vector<float> narrowed(field.begin(), field.end());
+    std::vector<float> viaFloat(sx * sy);
+    conv.apply(narrowed.data(), viaFloat.data());
+    for (size_t i = 0; i < viaDouble.size(); ++i)
+        ASSERT_EQ(static_cast<double>(viaFloat[i]), viaDouble[i]) << "at " << i;
+
+    SpectralConvolver2D asDouble;
+    asDouble.init(sx, sy, Precision::Double);
+    asDouble.setKernel(kernel);
+    EXPECT_THROW(asDouble.apply(narrowed.data(), viaFloat.data()), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// SharedSpectrum2D — one forward transform feeding several convolvers
+// ---------------------------------------------------------------------------
+
+TEST(SharedSpectrum2D, ApplySpectrumIsBitIdenticalToApply)
+{
+    for (const Precision precision : { Precision::Double, Precision::Single })
+    {
+        SCOPED_TRACE(precision == Precision::Single ? "Single" : "Double");
+        const int sx = 48, sy = 40;
+        const auto field = ramp(sx * sy);
+        const auto narrow = gaussianTaps(5, 2.0);
+        const auto wide = gaussianTaps(12, 5.0);
+
+        SpectralConvolver2D a, b;
+        a.init(sx, sy, precision);
+        a.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ narrow, 5, narrow, 5, 1.0 } }));
+        b.init(sx, sy, precision);
+        b.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ wide, 12, narrow, 5, -0.5 } }));
+
+        SharedSpectrum2D spectrum;
+        spectrum.init(sx, sy, precision);
+        spectrum.forward(field.data());
+
+        std::vector<double> viaApply(sx * sy), viaSpectrum(sx * sy);
+        for (SpectralConvolver2D* conv : { &a, &b })
+        {
+            ASSERT_TRUE(spectrum.matches(*conv));
+            conv->apply(field.data(), viaApply.data());
+            conv->applySpectrum(spectrum, viaSpectrum.data());
+            EXPECT_EQ(viaApply, viaSpectrum);
+        }
+    }
+}
+
+TEST(SharedSpectrum2D, ForwardTransformsOncePerInvalidate)
+{
+    const int sx = 32, sy = 32;
+    const auto taps = gaussianTaps(4, 2.0);
+    const auto first = ramp(sx * sy);
+    std::vector<double> second(first.size());
+    std::ranges::transform(first, second.begin(), [](double v) { return 2.0 * v; });
+
+    SpectralConvolver2D conv;
+    conv.init(sx, sy);
+    conv.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 4, taps, 4, 1.0 } }));
+    SharedSpectrum2D spectrum;
+    spectrum.init(sx, sy);
+
+    std::vector<double> expected(sx * sy), got(sx * sy);
+    conv.apply(first.data(), expected.data());
+    spectrum.forward(first.data());
+    spectrum.forward(second.data()); // already current: ignored
+    conv.applySpectrum(spectrum, got.data());
+    EXPECT_EQ(got, expected);
+
+    spectrum.invalidate();
+    spectrum.forward(second.data());
+    conv.apply(second.data(), expected.data());
+    conv.applySpectrum(spectrum, got.data());
+    EXPECT_EQ(got, expected);
+}
+
+TEST(SharedSpectrum2D, AddedKernelSpectraSumTheConvolutions)
+{
+    const int sx = 40, sy = 36;
+    const auto field = ramp(sx * sy);
+    const auto narrow = gaussianTaps(4, 1.5);
+    const auto wide = gaussianTaps(10, 4.0);
+
+    SpectralConvolver2D a, b;
+    a.init(sx, sy);
+    a.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ narrow, 4, narrow, 4, 2.0 } }));
+    b.init(sx, sy);
+    b.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ wide, 10, wide, 10, -1.0 } }));
+
+    std::vector<double> outA(sx * sy), outB(sx * sy), fused(sx * sy);
+    a.apply(field.data(), outA.data());
+    b.apply(field.data(), outB.data());
+
+    SpectralConvolver2D sum(a);
+    sum.addKernelSpectrum(b);
+    sum.apply(field.data(), fused.data());
+    for (size_t i = 0; i < fused.size(); ++i)
+        EXPECT_NEAR(fused[i], outA[i] + outB[i], kSpectralAbsTolerance) << "at " << i;
+
+    SpectralConvolver2D otherSize;
+    otherSize.init(sx, sy + 1);
+    EXPECT_THROW(sum.addKernelSpectrum(otherSize), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// Plan cache, PlanRigor and wisdom. Each test starts and ends with an empty
+// cache, so measured plans never leak into the rest of the suite.
+// ---------------------------------------------------------------------------
+
+namespace {
+    class FftPlanCache : public ::testing::Test
+    {
+    protected:
+        void SetUp() override { clearFftPlanCache(); }
+        void TearDown() override { clearFftPlanCache(); }
+
+        static const FftPlanShape* find(const std::vector<FftPlanShape>& shapes, int rank, int sx, int sy,
+            Precision precision)
+        {
+            const auto it = std::ranges::find_if(shapes, [&](const FftPlanShape& s) {
+                return s.rank == rank && s.size_x == sx && s.size_y == sy && s.precision == precision;
+            });
+            return it == shapes.end() ? nullptr : &*it;
+        }
+    };
+}
+
+TEST_F(FftPlanCache, ConvolversOfOneShapeShareItsPlans)
+{
+    SpectralConvolver2D a, b, single;
+    a.init(24, 20);
+    b.init(24, 20);
+    single.init(24, 20, Precision::Single);
+    SpectralConvolver1D line;
+    line.init(1500);
+    const SpectralConvolver2D copy(a);
+    SharedSpectrum2D spectrum;
+    spectrum.init(24, 20);
+
+    const auto shapes = cachedFftPlans();
+    EXPECT_EQ(shapes.size(), 3u);
+    ASSERT_NE(find(shapes, 2, 24, 20, Precision::Double), nullptr);
+    EXPECT_EQ(find(shapes, 2, 24, 20, Precision::Double)->rigor, PlanRigor::Estimate);
+    EXPECT_NE(find(shapes, 2, 24, 20, Precision::Single), nullptr);
+    EXPECT_NE(find(shapes, 1, 1500, 1, Precision::Double), nullptr);
+}
+
+TEST_F(FftPlanCache, AheadOfTimeMeasuredPlansReachLiveConvolvers)
+{
+    const int sx = 40, sy = 32;
+    const auto field = ramp(sx * sy);
+    const auto taps = gaussianTaps(6, 2.5);
+    SpectralConvolver2D conv;
+    conv.init(sx, sy);
+    conv.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 6, taps, 6, 1.0 } }));
+    std::vector<double> estimated(sx * sy), measured(sx * sy), fresh(sx * sy);
+    conv.apply(field.data(), estimated.data());
+
+    prepareFftPlans2D(sx, sy, Precision::Double, PlanRigor::Measure);
+    const auto shapes = cachedFftPlans();
+    ASSERT_NE(find(shapes, 2, sx, sy, Precision::Double), nullptr);
+    EXPECT_EQ(find(shapes, 2, sx, sy, Precision::Double)->rigor, PlanRigor::Measure);
+
+    // A different algorithm, so equal to rounding only; a convolver made now
+    // runs the same measured plan as the live one, so bit-identical to it.
+    conv.apply(field.data(), measured.data());
+    expectSpectralMatchesDirect(estimated, measured);
+    SpectralConvolver2D later(conv);
+    later.apply(field.data(), fresh.data());
+    EXPECT_EQ(fresh, measured);
+
+    // Never downgraded.
+    prepareFftPlans2D(sx, sy, Precision::Double, PlanRigor::Estimate);
+    EXPECT_EQ(find(cachedFftPlans(), 2, sx, sy, Precision::Double)->rigor, PlanRigor::Measure);
+}
+
+TEST_F(FftPlanCache, MeasureRigorPlansNewShapesInTheBackground)
+{
+    const int sx = 36, sy = 30;
+    const auto field = ramp(sx * sy);
+    const auto taps = gaussianTaps(5, 2.0);
+    const auto direct = directConvolve(field, taps, 5, taps, 5, sx, sy);
+
+    const ScopedPlanRigor rigor(PlanRigor::Measure);
+    SpectralConvolver2D conv;
+    conv.init(sx, sy); // usable at once, whether or not the measured plan is ready
+    conv.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 5, taps, 5, 1.0 } }));
+    std::vector<double> out(sx * sy);
+    conv.apply(field.data(), out.data());
+    expectSpectralMatchesDirect(direct, out);
+
+    waitForFftPlans();
+    EXPECT_EQ(find(cachedFftPlans(), 2, sx, sy, Precision::Double)->rigor, PlanRigor::Measure);
+    conv.apply(field.data(), out.data());
+    expectSpectralMatchesDirect(direct, out);
+}
+
+TEST_F(FftPlanCache, CachedShapesDoNotWaitForABackgroundMeasurement)
+{
+    SpectralConvolver2D cached;
+    cached.init(24, 20);
+
+    const ScopedPlanRigor rigor(PlanRigor::Measure);
+    SpectralConvolver2D big;
+    big.init(256, 256); // an Estimate plan now, its measured one in the background
+    if (find(cachedFftPlans(), 2, 256, 256, Precision::Double)->rigor == PlanRigor::Measure)
+        GTEST_SKIP() << "256x256 is already in this process's wisdom, so nothing is measured";
+    // Let the measurement get into its timing trials (hundreds of ms at this size).
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    SpectralConvolver2D again;
+    again.init(24, 20);
+    const auto shapes = cachedFftPlans();
+    // Both calls returned before the measurement was done.
+    ASSERT_NE(find(shapes, 2, 256, 256, Precision::Double), nullptr);
+    EXPECT_EQ(find(shapes, 2, 256, 256, Precision::Double)->rigor, PlanRigor::Estimate);
+    ASSERT_NE(find(shapes, 2, 24, 20, Precision::Double), nullptr);
+
+    waitForFftPlans();
+    EXPECT_EQ(find(cachedFftPlans(), 2, 256, 256, Precision::Double)->rigor, PlanRigor::Measure);
+}
+
+TEST_F(FftPlanCache, WisdomRoundTripsThroughADirectory)
+{
+    const auto dir = std::filesystem::path(::testing::TempDir()) / "dnf_composer_fftw_wisdom";
+    std::filesystem::remove_all(dir);
+
+    prepareFftPlans2D(16, 16, Precision::Double, PlanRigor::Measure);
+    ASSERT_TRUE(saveFftWisdom(dir.string()));
+    EXPECT_TRUE(std::filesystem::is_regular_file(dir / "double.wisdom"));
+    EXPECT_TRUE(std::filesystem::is_regular_file(dir / "single.wisdom"));
+    EXPECT_TRUE(loadFftWisdom(dir.string()));
+    EXPECT_FALSE(loadFftWisdom((dir / "missing").string()));
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_F(FftPlanCache, LargeShapesGetThreadedPlansThatRunOnTheCurrentPool)
+{
+    const int sx = 256, sy = 256;
+    ASSERT_GE(sx * sy, kFFTThreadedMinCells);
+    const auto field = ramp(sx * sy);
+    const auto taps = gaussianTaps(4, 1.5);
+    SpectralConvolver2D conv, small;
+    conv.init(sx, sy);
+    conv.setKernel(buildWrappedSeparableKernel2D(sx, sy, { SeparableKernelTerm2D{ taps, 4, taps, 4, 1.0 } }));
+    small.init(64, 64);
+
+    const auto shapes = cachedFftPlans();
+    ASSERT_NE(find(shapes, 2, sx, sy, Precision::Double), nullptr);
+    EXPECT_EQ(find(shapes, 2, sx, sy, Precision::Double)->jobs, kFFTThreadedJobs);
+    ASSERT_NE(find(shapes, 2, 64, 64, Precision::Double), nullptr);
+    EXPECT_EQ(find(shapes, 2, 64, 64, Precision::Double)->jobs, 1);
+
+    // The plan's jobs are the same whoever runs them, so a pool changes
+    // nothing in the result.
+    std::vector<double> inline_(sx * sy), pooled(sx * sy);
+    {
+        const dnf_composer::tools::threading::ScopedCurrentPool none(nullptr);
+        conv.apply(field.data(), inline_.data());
+    }
+    std::size_t poolTasks = 0;
+    {
+        dnf_composer::tools::threading::ThreadPool pool(4);
+        const dnf_composer::tools::threading::ScopedCurrentPool current(&pool);
+        conv.apply(field.data(), pooled.data());
+        poolTasks = pool.getExecutedTaskCount();
+    }
+    EXPECT_EQ(pooled, inline_);
+    expectSpectralMatchesDirect(directConvolve(field, taps, 4, taps, 4, sx, sy), pooled);
+
+    // parallelFor keeps one job on the calling thread and queues the rest,
+    // so every threaded transform must have put work on the pool.
+    if (!fftJobsRunOnThreadPool())
+        GTEST_SKIP() << "the FFTW loaded predates fftw_threads_set_callback (3.3.9); "
+                        "its threaded plans run on FFTW's own threads";
+    EXPECT_GT(poolTasks, 0u);
+}
+
 // ---------------------------------------------------------------------------
 // shouldUseSpectral2D / ConvolutionMode override — the single dispatch rule
 // every 2D convolution element uses.
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+
+#include "tools/latency_histogram.h"
+
+using namespace dnf_composer::tools::profiling;
+using std::chrono::nanoseconds;
+
+TEST(LatencyHistogram, BucketsTileTheRange)
+{
+    // Every bucket starts where the previous one ends, and values map back to
+    // the bucket that contains them.
+    std::uint64_t expectedStart = 0;
+    for (std::size_t b = 0; b + 1 < LatencyHistogram::kBuckets; ++b)
+    {
+        ASSERT_EQ(LatencyHistogram::bucketStart(b), expectedStart) << "bucket " << b;
+        EXPECT_EQ(LatencyHistogram::bucketOf(expectedStart), b);
+        const std::uint64_t last = expectedStart + LatencyHistogram::bucketWidth(b) - 1;
+        EXPECT_EQ(LatencyHistogram::bucketOf(last), b);
+        expectedStart += LatencyHistogram::bucketWidth(b);
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(UINT64_MAX), LatencyHistogram::kBuckets - 1);
+}
+
+TEST(LatencyHistogram, PercentilesAreWithinTheBucketError)
+{
+    LatencyHistogram histogram;
+    // 1 us to 1 ms, one value per microsecond.
+    for (int us = 1; us <= 1000; ++us)
+        histogram.record(std::chrono::microseconds(us));
+
+    const LatencyHistogram::Snapshot s = histogram.snapshot();
+    EXPECT_EQ(s.count, 1000u);
+    EXPECT_EQ(s.max, std::chrono::milliseconds(1));
+    EXPECT_EQ(s.mean(), nanoseconds(500500));
+    for (const double q : { 0.01, 0.5, 0.9, 0.99 })
+    {
+        const double exact = q * 1000.0 * 1000.0;
+        EXPECT_NEAR(static_cast<double>(s.percentile(q).count()), exact, exact / 32.0) << "q " << q;
+    }
+    EXPECT_EQ(s.percentile(1.0), s.max);
+}
+
+TEST(LatencyHistogram, SnapshotsMergeAndReset)
+{
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 99; ++i)
+        fast.record(nanoseconds(100));
+    slow.record(nanoseconds(5'000'000));
+
+    LatencyHistogram::Snapshot merged = fast.snapshot();
+    merged += slow.snapshot();
+    EXPECT_EQ(merged.count, 100u);
+    EXPECT_NEAR(static_cast<double>(merged.percentile(0.5).count()), 100.0, 4.0);
+    EXPECT_NEAR(static_cast<double>(merged.percentile(0.99).count()), 100.0, 4.0);
+    EXPECT_EQ(merged.max, nanoseconds(5'000'000));
+
+    fast.reset();
+    EXPECT_EQ(fast.snapshot().count, 0u);
+    EXPECT_EQ(fast.snapshot().percentile(0.5), nanoseconds(0));
+    EXPECT_EQ(fast.snapshot().mean(), nanoseconds(0));
+}
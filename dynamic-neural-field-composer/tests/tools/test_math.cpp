@@ -3,6 +3,8 @@
 #include <cmath>
 #include <numeric>
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 
 #include "tools/math.h"
 
@@ -487,6 +489,64 @@ TEST(HebbLearningRule, SizeMismatchThrows)
     EXPECT_THROW(hebbLearningRule(weights, input, output, 0.1), std::invalid_argument);
 }
 
+// ---------------------------------------------------------------------------
+// gemv_into
+// ---------------------------------------------------------------------------
+
+namespace {
+    // The column-by-column forward pass the couplings used to run.
+    std::vector<double> naiveGemv(const std::vector<double>& weights, const std::vector<double>& in,
+                                  std::size_t outputSize, double scale)
+    {
+        std::vector<double> out(outputSize, 0.0);
+        for (std::size_t j = 0; j < outputSize; ++j)
+            for (std::size_t i = 0; i < in.size(); ++i)
+                out[j] += scale * weights[i * outputSize + j] * in[i];
+        return out;
+    }
+}
+
+TEST(GemvInto, BitIdenticalToColumnLoop)
+{
+    // More outputs than one kGemvBlock, and not a multiple of it or of any
+    // vector width; some inputs exactly zero (of both signs) so they are skipped.
+    constexpr std::size_t inputSize = 37;
+    const std::size_t outputSize = kGemvBlock + 77;
+    std::vector<double> in(inputSize), weights(inputSize * outputSize);
+    for (std::size_t i = 0; i < inputSize; ++i)
+        in[i] = (i % 3 == 0) ? 0.0 : std::sin(0.61 * static_cast<double>(i));
+    in[4] = -0.0;
+    for (std::size_t k = 0; k < weights.size(); ++k)
+        weights[k] = std::cos(0.013 * static_cast<double>(k)) * 1.7;
+
+    std::vector<double> out(outputSize, 123.0);
+    gemv_into(out, weights, in, 0.35);
+    const auto expected = naiveGemv(weights, in, outputSize, 0.35);
+    for (std::size_t j = 0; j < outputSize; ++j)
+        ASSERT_EQ(std::bit_cast<std::uint64_t>(out[j]), std::bit_cast<std::uint64_t>(expected[j])) << "at " << j;
+}
+
+TEST(GemvInto, AllZeroInputGivesPositiveZeros)
+{
+    const std::vector<double> in(5, 0.0);
+    const std::vector<double> weights(5 * 9, -2.0);
+    std::vector<double> out(9, 1.0);
+    gemv_into(out, weights, in, 3.0);
+    for (const double v : out)
+    {
+        EXPECT_EQ(v, 0.0);
+        EXPECT_FALSE(std::signbit(v));
+    }
+}
+
+TEST(GemvInto, SizeMismatchThrows)
+{
+    const std::vector<double> in(3, 1.0);
+    const std::vector<double> weights(3 * 4 - 1, 1.0);
+    std::vector<double> out(4);
+    EXPECT_THROW(gemv_into(out, weights, in, 1.0), std::invalid_argument);
+}
+
 // ---------------------------------------------------------------------------
 // normalize (scalar)
 // ---------------------------------------------------------------------------
@@ -1311,6 +1371,58 @@ TEST(Conv2dSeparableInto, EvenLengthKernelMatchesReference)
     expectConv2dMatchesReference(ramp(15 * 12), kx, kx, 15, 12, /*circular=*/false);
 }
 
+TEST(Conv2dSeparableInto, SplitPassesAreBitIdenticalToSerial)
+{
+    // Above kParallelConvMinCells the passes are split in row blocks and
+    // column-tile blocks over the current pool; every cell must come out
+    // exactly as in the single-chunk run. Two kernel widths share one scratch,
+    // as MexicanHat's two terms do, and the grid is not a multiple of the tile
+    // width or of the chunk count.
+    const int sx = 150, sy = 130;
+    ASSERT_GE(static_cast<std::size_t>(sx) * sy, kParallelConvMinCells);
+    const auto narrow = gaussianTaps(5, 2.0);
+    const auto wide = gaussianTaps(14, 5.0);
+    const auto field = ramp(sx * sy);
+
+    for (const bool circular : { true, false })
+    {
+        std::vector<int> extNarrowX, extNarrowY, extWideX, extWideY;
+        if (circular)
+        {
+            extNarrowX = createExtendedIndex(sx, { 5, 5 });
+            extNarrowY = createExtendedIndex(sy, { 5, 5 });
+            extWideX = createExtendedIndex(sx, { 14, 14 });
+            extWideY = createExtendedIndex(sy, { 14, 14 });
+        }
+        const auto convolveBoth = [&](Conv2dScratch<double>& scratch)
+            {
+                std::vector<double> a(sx * sy), b(sx * sy), tmp(sx * sy);
+                conv2d_separable_into<double>(a, tmp, scratch, field, wide, wide, sx, sy, extWideX, extWideY);
+                conv2d_separable_into<double>(b, tmp, scratch, field, narrow, narrow, sx, sy, extNarrowX, extNarrowY);
+                a.insert(a.end(), b.begin(), b.end());
+                return a;
+            };
+
+        Conv2dScratch<double> serialScratch;
+        serialScratch.ensure(sx, sy, extWideX.size(), extWideY.size());
+        std::vector<double> serial;
+        {
+            const dnf_composer::tools::threading::ScopedCurrentPool none(nullptr);
+            serial = convolveBoth(serialScratch);
+        }
+
+        for (const int threads : { 2, 3, 8 })
+        {
+            dnf_composer::tools::threading::ThreadPool pool(threads);
+            const dnf_composer::tools::threading::ScopedCurrentPool current(&pool);
+            Conv2dScratch<double> scratch;
+            scratch.ensure(sx, sy, extWideX.size(), extWideY.size());
+            for (int repeat = 0; repeat < 2; ++repeat)
+                EXPECT_EQ(convolveBoth(scratch), serial) << "threads=" << threads << " circular=" << circular;
+        }
+    }
+}
+
 TEST(ConvValidInto, SymmetricFoldingMatchesNaive)
 {
     // Direct check of the symmetric fold in conv_valid_into.
@@ -1510,6 +1622,26 @@ TEST(SeedNormal, DifferentSeedDifferentSequence)
     EXPECT_TRUE(anyDifferent);
 }
 
+TEST(NormalStream, MatchesSeedNormalAndIsIndependent)
+{
+    seedNormal(99);
+    std::vector<double> expected(37);
+    fillNormal(expected.data(), expected.size());
+
+    // Two fills of one stream continue the sequence, and interleaved draws
+    // from another stream (or from fillNormal) do not disturb it.
+    NormalStream stream(99);
+    NormalStream other(99);
+    std::vector<double> a(37), scratch(50);
+    stream.fill(a.data(), 20);
+    other.fill(scratch.data(), scratch.size());
+    fillNormal(scratch.data(), scratch.size());
+    stream.fill(a.data() + 20, 17);
+
+    for (size_t i = 0; i < a.size(); ++i)
+        EXPECT_DOUBLE_EQ(a[i], expected[i]);
+}
+
 // ---------------------------------------------------------------------------
 // obtainCircularVector / obtainCircularVector_into — issue #121
 //
@@ -1588,3 +1720,60 @@ TEST(ObtainCircularVectorInto, TooLargeIndexDoesNotReadOutOfBounds)
     EXPECT_DOUBLE_EQ(out[1], 0.0);
     EXPECT_DOUBLE_EQ(out[2], 0.0);
 }
+
+// ---------------------------------------------------------------------------
+// Single precision — the float instantiations agree with the double ones to
+// float rounding (relative ~1e-6 of the output scale)
+// ---------------------------------------------------------------------------
+
+TEST(ConvValidInto, FloatMatchesDouble)
+{
+    // Long enough for the AVX2 kernel's 32-wide blocks, the 8-wide block and
+    // the scalar tail; an odd, asymmetric kernel exercises the fold's edges.
+    std::vector<double> f(301), g(31);
+    for (size_t i = 0; i < f.size(); ++i) f[i] = std::sin(0.05 * static_cast<double>(i)) + 0.5;
+    for (size_t i = 0; i < g.size(); ++i)
+    {
+        const double d = static_cast<double>(i) - 12.0;
+        g[i] = std::exp(-0.01 * d * d);
+    }
+
+    std::vector<double> expected(f.size() - g.size() + 1);
+    conv_valid_into(expected, f, g);
+
+    const std::vector<float> ff(f.begin(), f.end()), gf(g.begin(), g.end());
+    std::vector<float> out(expected.size());
+    conv_valid_into(out, ff, gf);
+
+    for (size_t i = 0; i < out.size(); ++i)
+        EXPECT_NEAR(out[i], expected[i], 1e-5 * std::abs(expected[i]) + 1e-6) << "i=" << i;
+}
+
+TEST(SeparableConvolver2DSingle, MatchesDoubleCircularConvolution)
+{
+    const int sx = 40, sy = 30;
+    const auto rangeX = computeKernelRange(3.0, 5, sx, true);
+    const auto rangeY = computeKernelRange(3.0, 5, sy, true);
+    const auto extX = createExtendedIndex(sx, rangeX);
+    const auto extY = createExtendedIndex(sy, rangeY);
+
+    std::vector<int> rx(rangeX[0] + rangeX[1] + 1), ry(rangeY[0] + rangeY[1] + 1);
+    std::iota(rx.begin(), rx.end(), -static_cast<int>(rangeX[0]));
+    std::iota(ry.begin(), ry.end(), -static_cast<int>(rangeY[0]));
+    const auto kx = gaussNorm(rx, 0.0, 3.0);
+    const auto ky = gaussNorm(ry, 0.0, 3.0);
+
+    std::vector<double> field(static_cast<size_t>(sx) * sy);
+    for (size_t i = 0; i < field.size(); ++i) field[i] = std::cos(0.03 * static_cast<double>(i)) * 5.0;
+
+    std::vector<double> expected(field.size()), tmp(field.size());
+    conv2d_separable_into(expected, tmp, field, kx, ky, sx, sy, extX, extY);
+
+    SeparableConvolver2DSingle single;
+    single.setKernel(kx, ky, sx, sy, extX, extY);
+    std::vector<double> out(field.size());
+    single.apply(field, out);
+
+    for (size_t i = 0; i < out.size(); ++i)
+        EXPECT_NEAR(out[i], expected[i], 1e-5) << "i=" << i;
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "tools/recording_codec.h"
+#include "tools/recording_file.h"
+
+using namespace dnf_composer::tools::recording_file;
+
+namespace
+{
+    // A bump relaxing towards its attractor: neighbouring frames differ less
+    // and less, like a field settling after a stimulus.
+    std::vector<double> relaxingBump(std::size_t n, int frame)
+    {
+        std::vector<double> values(n);
+        const double approach = 1.0 - std::exp(-0.05 * frame);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const double x = static_cast<double>(i) - static_cast<double>(n) / 2.0;
+            values[i] = -5.0 + 9.0 * approach * std::exp(-x * x / 50.0);
+        }
+        return values;
+    }
+}
+
+TEST(RecordingCodec, XorDeltaIsBitExact)
+{
+    const CodecOptions options{ RecordingCodec::XorDelta, 0.0, 4 };
+    const std::vector<std::vector<double>> frames = {
+        { 0.0, -0.0, 1.5, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(),
+          std::numeric_limits<double>::denorm_min(), -1e300 },
+        { 0.0, -0.0, 1.5, -std::numeric_limits<double>::infinity(), 2.0, 3.0, -1e300 },
+        { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0 },
+    };
+    FrameEncoder encoder(options, 7);
+    FrameDecoder decoder(options, 7);
+    std::vector<std::byte> payload;
+    std::vector<double> decoded(7);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (std::size_t k = 0; k < frames.size(); ++k)
+        {
+            const bool keyframe = encoder.encode(frames[k], payload);
+            EXPECT_EQ(keyframe, (round * frames.size() + k) % 4 == 0);
+            decoder.decode(payload, keyframe, decoded);
+            for (std::size_t i = 0; i < 7; ++i)
+                EXPECT_EQ(std::bit_cast<std::uint64_t>(decoded[i]), std::bit_cast<std::uint64_t>(frames[k][i]));
+        }
+    }
+}
+
+TEST(RecordingCodec, QuantizedStaysWithinTolerance)
+{
+    constexpr double tolerance = 1e-4;
+    const CodecOptions options{ RecordingCodec::Quantized, tolerance, 16 };
+    constexpr std::size_t n = 200;
+    FrameEncoder encoder(options, n);
+    FrameDecoder decoder(options, n);
+    std::vector<std::byte> payload;
+    std::vector<double> decoded(n);
+    for (int k = 0; k < 100; ++k)
+    {
+        // Values moving up and down, so the differences take both signs.
+        std::vector<double> values = relaxingBump(n, k);
+        for (std::size_t i = 0; i < n; ++i)
+            values[i] += 0.3 * std::sin(0.7 * k + static_cast<double>(i));
+        decoder.decode(payload, encoder.encode(values, payload), decoded);
+        for (std::size_t i = 0; i < n; ++i)
+            ASSERT_LE(std::abs(decoded[i] - values[i]), tolerance * (1.0 + 1e-9)) << "frame " << k << ", value " << i;
+    }
+}
+
+TEST(RecordingCodec, ShrinksATypicalRunTenfold)
+{
+    // A bump forms over the first 150 of 2000 frames and then holds, as a
+    // field does for most of a long run. Sizes include the per-frame prefixes.
+    constexpr std::size_t n = 100;
+    constexpr int frames = 2000;
+    for (const CodecOptions options : { CodecOptions{ RecordingCodec::XorDelta, 0.0, 256 },
+                                        CodecOptions{ RecordingCodec::Quantized, 1e-6, 256 } })
+    {
+        FrameEncoder encoder(options, n);
+        std::vector<std::byte> payload;
+        std::size_t coded = 0;
+        std::size_t codedWhileForming = 0;
+        for (int k = 0; k < frames; ++k)
+        {
+            encoder.encode(relaxingBump(n, std::min(k, 150)), payload);
+            coded += kCodedFramePrefixSize + payload.size();
+            if (k < 150)
+                codedWhileForming += kCodedFramePrefixSize + payload.size();
+        }
+        EXPECT_GE(frames * frameSize(n), 10 * coded) << "codec " << static_cast<int>(options.codec);
+        // While every value changes, only the lossy codec stays far below raw.
+        if (options.codec == RecordingCodec::Quantized)
+            EXPECT_GE(150 * frameSize(n), 5 * codedWhileForming);
+        else
+            EXPECT_GE(150 * frameSize(n), 2 * codedWhileForming);
+    }
+}
+
+TEST(RecordingCodec, UnchangedFramesCostAFewBytes)
+{
+    const CodecOptions options{ RecordingCodec::XorDelta, 0.0, 64 };
+    const std::vector<double> frame = relaxingBump(10000, 3);
+    FrameEncoder encoder(options, frame.size());
+    std::vector<std::byte> payload;
+    EXPECT_TRUE(encoder.encode(frame, payload));
+    EXPECT_FALSE(encoder.encode(frame, payload));
+    EXPECT_LE(payload.size(), 4u);
+
+    encoder.reset();
+    EXPECT_TRUE(encoder.encode(frame, payload));
+}
+
+TEST(RecordingCodec, RejectsInvalidOptionsAndCorruptPayloads)
+{
+    EXPECT_THROW(validate({ RecordingCodec::Quantized, 0.0, 64 }), std::invalid_argument);
+    EXPECT_THROW(validate({ RecordingCodec::Quantized, std::numeric_limits<double>::infinity(), 64 }), std::invalid_argument);
+    EXPECT_THROW(validate({ RecordingCodec::XorDelta, 0.0, 0 }), std::invalid_argument);
+    EXPECT_THROW(FrameEncoder({}, 4), std::invalid_argument);
+    EXPECT_NO_THROW(validate({}));
+
+    const CodecOptions options{ RecordingCodec::XorDelta, 0.0, 64 };
+    FrameEncoder encoder(options, 4);
+    FrameDecoder decoder(options, 4);
+    std::vector<std::byte> payload;
+    std::vector<double> decoded(4);
+    encoder.encode(std::vector<double>{ 1.0, 2.0, 3.0, 4.0 }, payload);
+
+    std::vector<std::byte> truncated(payload.begin(), payload.end() - 1);
+    EXPECT_THROW(decoder.decode(truncated, true, decoded), std::runtime_error);
+    std::vector<std::byte> padded = payload;
+    padded.push_back(std::byte{ 2 }); // a literal run past the frame
+    padded.push_back(std::byte{ 1 });
+    EXPECT_THROW(decoder.decode(padded, true, decoded), std::runtime_error);
+}
@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tools/recording_file.h"
+
+using namespace dnf_composer::tools::recording_file;
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::vector<double> makeFrame(std::size_t n, double phase)
+    {
+        std::vector<double> frame(n);
+        for (std::size_t i = 0; i < n; ++i)
+            frame[i] = std::sin(phase + 0.37 * static_cast<double>(i)) / 7.0;
+        return frame;
+    }
+
+    RecordingInfo makeInfo(std::size_t values = 12)
+    {
+        return { "nf 1", "activation", values, 4, 3, 5, SampleUnit::Ticks };
+    }
+
+    void writeRecording(const std::string& path, const RecordingInfo& info, int frames,
+        std::ios::openmode mode = std::ios::trunc)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::out | mode);
+        if (mode == std::ios::trunc)
+            writeHeader(out, info);
+        for (int k = 0; k < frames; ++k)
+            writeFrame(out, 5 * k, 5.0 * k + 0.5, makeFrame(info.frameValues, k));
+    }
+}
+
+class RecordingFileTest : public ::testing::Test
+{
+protected:
+    std::string tempDir;
+
+    void SetUp() override
+    {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        tempDir = (fs::temp_directory_path() / "dnf_recording_file_tests" / info->name()).string();
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    std::string path(const std::string& name) const { return tempDir + "/" + name; }
+};
+
+TEST_F(RecordingFileTest, RoundTripIsExact)
+{
+    const RecordingInfo info = makeInfo();
+    writeRecording(path("a.dnfr"), info, 7);
+
+    const MappedRecording recording(path("a.dnfr"));
+    EXPECT_EQ(recording.info(), info);
+    EXPECT_EQ(recording.header().version, kVersion);
+    EXPECT_EQ(recording.header().headerSize % 64, 0u);
+    ASSERT_EQ(recording.frameCount(), 7u);
+    EXPECT_EQ(recording.trailingBytes(), 0u);
+    for (std::size_t k = 0; k < 7; ++k)
+    {
+        EXPECT_EQ(recording.ticks(k), static_cast<long long>(5 * k));
+        EXPECT_EQ(recording.ms(k), 5.0 * static_cast<double>(k) + 0.5);
+        const auto frame = recording.frame(k);
+        EXPECT_EQ(std::vector<double>(frame.begin(), frame.end()), makeFrame(info.frameValues, static_cast<double>(k)));
+    }
+    EXPECT_EQ(fs::file_size(path("a.dnfr")), recording.header().headerSize + 7 * frameSize(info.frameValues));
+    EXPECT_THROW((void)recording.frame(7), std::out_of_range);
+}
+
+TEST_F(RecordingFileTest, ColumnIsTheTimeSeriesOfOneValue)
+{
+    const RecordingInfo info = makeInfo();
+    writeRecording(path("b.dnfr"), info, 5);
+    const MappedRecording recording(path("b.dnfr"));
+    const auto series = recording.column(3);
+    ASSERT_EQ(series.size(), 5u);
+    for (std::size_t k = 0; k < series.size(); ++k)
+        EXPECT_EQ(series[k], makeFrame(info.frameValues, static_cast<double>(k))[3]);
+    EXPECT_THROW((void)recording.column(info.frameValues), std::out_of_range);
+}
+
+TEST_F(RecordingFileTest, AppendTruncatesATornFrameAndContinues)
+{
+    const RecordingInfo info = makeInfo();
+    writeRecording(path("c.dnfr"), info, 3);
+    {
+        // A frame cut short, as a crash mid-write leaves it.
+        std::ofstream out(path("c.dnfr"), std::ios::binary | std::ios::app);
+        out.write("partial", 7);
+    }
+    EXPECT_EQ(MappedRecording(path("c.dnfr")).trailingBytes(), 7u);
+
+    EXPECT_EQ(prepareAppend(path("c.dnfr"), info), 3u);
+    writeRecording(path("c.dnfr"), info, 2, std::ios::app);
+
+    const MappedRecording recording(path("c.dnfr"));
+    ASSERT_EQ(recording.frameCount(), 5u);
+    EXPECT_EQ(recording.trailingBytes(), 0u);
+    EXPECT_EQ(recording.ticks(3), 0);
+    EXPECT_EQ(recording.ticks(4), 5);
+
+    EXPECT_EQ(prepareAppend(path("missing.dnfr"), info), 0u);
+    EXPECT_THROW(prepareAppend(path("c.dnfr"), makeInfo(13)), std::runtime_error);
+}
+
+TEST_F(RecordingFileTest, RejectsInvalidFiles)
+{
+    EXPECT_THROW(MappedRecording(path("missing.dnfr")), std::runtime_error);
+
+    { std::ofstream(path("short.dnfr"), std::ios::binary) << "DNFR"; }
+    EXPECT_THROW(MappedRecording(path("short.dnfr")), std::runtime_error);
+
+    writeRecording(path("magic.dnfr"), makeInfo(), 1);
+    {
+        std::fstream file(path("magic.dnfr"), std::ios::binary | std::ios::in | std::ios::out);
+        file.write("XNFR", 4);
+    }
+    EXPECT_THROW(MappedRecording(path("magic.dnfr")), std::runtime_error);
+
+    writeRecording(path("size.dnfr"), makeInfo(), 1);
+    {
+        const std::uint64_t wrongFrameSize = 8;
+        std::fstream file(path("size.dnfr"), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(32);
+        file.write(reinterpret_cast<const char*>(&wrongFrameSize), sizeof(wrongFrameSize));
+    }
+    EXPECT_THROW(MappedRecording(path("size.dnfr")), std::runtime_error);
+}
+
+TEST(RecordingCsv, MatchesTheRecorderFormat)
+{
+    std::ostringstream out;
+    writeCsvHeader(out, 3, 3, 1);
+    writeCsvRow(out, 4, 4.0, std::vector<double>{ 0.5, -1.0 / 3.0, 2.0 });
+    writeCsvRow(out, 5, 5.0, std::vector<double>{ 0.0, 1e-9, -2.25 });
+    EXPECT_EQ(out.str(),
+        "ticks,ms,0,1,2\n"
+        "4,4.000000,0.500000,-0.333333,2.000000\n"
+        "5,5.000000,0.000000,0.000000,-2.250000\n");
+
+    std::ostringstream grid;
+    writeCsvHeader(grid, 4, 2, 2);
+    EXPECT_EQ(grid.str(), "# size_x=2,size_y=2\nticks,ms,0,1,2,3\n");
+}
+
+TEST_F(RecordingFileTest, RegionIsStoredWithTheRecording)
+{
+    RecordingInfo info = makeInfo(6);
+    info.sizeX = 3;
+    info.sizeY = 2;
+    info.region = { 2, 1, 4, 3 };
+    // 50 bytes of names and the 16-byte region block need a third 64-byte block.
+    info.elementId = std::string(40, 'e');
+    writeRecording(path("region.dnfr"), info, 2);
+    {
+        const MappedRecording recording(path("region.dnfr"));
+        EXPECT_EQ(recording.info(), info);
+        EXPECT_EQ(recording.header().headerSize, 192u);
+        EXPECT_EQ(recording.frameCount(), 2u);
+    }
+
+    std::ostringstream csv;
+    writeCsvHeader(csv, 6, 3, 2, info.region);
+    EXPECT_EQ(csv.str(), "# size_x=3,size_y=2\n# origin_x=2,origin_y=1,stride_x=4,stride_y=3\nticks,ms,0,1,2,3,4,5\n");
+
+    info.region.strideX = 0;
+    std::ostringstream out;
+    EXPECT_THROW(writeHeader(out, info), std::invalid_argument);
+}
+
+TEST_F(RecordingFileTest, CodedRecordingsReadBackInAnyOrder)
+{
+    RecordingInfo info = makeInfo();
+    info.codec = { RecordingCodec::XorDelta, 0.0, 3 };
+    {
+        std::ofstream out(path("coded.dnfr"), std::ios::binary);
+        writeHeader(out, info);
+        FrameEncoder encoder(info.codec, info.frameValues);
+        std::vector<std::byte> payload;
+        for (int k = 0; k < 10; ++k)
+        {
+            const bool keyframe = encoder.encode(makeFrame(info.frameValues, k), payload);
+            writeCodedFrame(out, 5 * k, 5.0 * k + 0.5, keyframe, payload);
+        }
+    }
+
+    const MappedRecording recording(path("coded.dnfr"));
+    EXPECT_TRUE(recording.coded());
+    EXPECT_EQ(recording.header().version, kCodedVersion);
+    EXPECT_EQ(recording.info(), info);
+    ASSERT_EQ(recording.frameCount(), 10u);
+    EXPECT_EQ(recording.trailingBytes(), 0u);
+    EXPECT_THROW((void)recording.frame(0), std::logic_error);
+    for (const std::size_t k : { 0u, 1u, 2u, 7u, 4u, 5u, 9u, 3u, 3u })
+    {
+        EXPECT_EQ(recording.ticks(k), static_cast<long long>(5 * k));
+        const auto frame = recording.readFrame(k);
+        EXPECT_EQ(std::vector<double>(frame.begin(), frame.end()), makeFrame(info.frameValues, static_cast<double>(k)));
+    }
+    const auto series = recording.column(2);
+    for (std::size_t k = 0; k < series.size(); ++k)
+        EXPECT_EQ(series[k], makeFrame(info.frameValues, static_cast<double>(k))[2]);
+}
+
+TEST_F(RecordingFileTest, AppendToACodedRecordingTruncatesATornFrame)
+{
+    RecordingInfo info = makeInfo();
+    info.codec = { RecordingCodec::Quantized, 1e-3, 64 };
+    const auto append = [&](int first, int count)
+    {
+        std::ofstream out(path("d.dnfr"), std::ios::binary | std::ios::app);
+        if (first == 0)
+            writeHeader(out, info);
+        FrameEncoder encoder(info.codec, info.frameValues);
+        std::vector<std::byte> payload;
+        for (int k = first; k < first + count; ++k)
+        {
+            const bool keyframe = encoder.encode(makeFrame(info.frameValues, k), payload);
+            writeCodedFrame(out, k, static_cast<double>(k), keyframe, payload);
+        }
+    };
+    append(0, 3);
+    {
+        std::ofstream out(path("d.dnfr"), std::ios::binary | std::ios::app);
+        out.write("torn frame prefix, no payload", 29);
+    }
+    EXPECT_EQ(MappedRecording(path("d.dnfr")).trailingBytes(), 29u);
+
+    EXPECT_EQ(prepareAppend(path("d.dnfr"), info), 3u);
+    append(3, 2);
+    const MappedRecording recording(path("d.dnfr"));
+    ASSERT_EQ(recording.frameCount(), 5u);
+    EXPECT_EQ(recording.trailingBytes(), 0u);
+    for (std::size_t k = 0; k < 5; ++k)
+    {
+        const auto frame = recording.readFrame(k);
+        const auto expected = makeFrame(info.frameValues, static_cast<double>(k));
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            EXPECT_NEAR(frame[i], expected[i], 1e-3);
+    }
+
+    RecordingInfo raw = info;
+    raw.codec = {};
+    EXPECT_THROW(prepareAppend(path("d.dnfr"), raw), std::runtime_error);
+}
@@ -0,0 +1,309 @@
+// Tests for the tiered SIMD kernels (tools/simd_dispatch.h). Every tier the
+// host supports is checked against the scalar tier: the element-wise kernels
+// bit for bit, the convolutions and the sigmoid to rounding, and the AVX-512
+// convolutions and sigmoid bit for bit against AVX2. Tiers the host lacks are
+// skipped.
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tools/simd_dispatch.h"
+#include "simulation/simulation.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/neural_field.h"
+#include "elements/memory_trace.h"
+#include "elements/activation_function.h"
+#include "scoped_min_log_level.h"
+
+using namespace dnf_composer;
+using namespace dnf_composer::tools::math;
+
+namespace
+{
+    // Lengths around every vector width and unroll, so each body and tail runs.
+    const std::vector<std::size_t> kLengths{ 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 100, 257 };
+
+    std::vector<SimdTier> vectorTiers()
+    {
+        std::vector<SimdTier> tiers;
+        for (const SimdTier tier : { SimdTier::Avx2, SimdTier::Avx512 })
+            if (tier <= detectedSimdTier())
+                tiers.push_back(tier);
+        return tiers;
+    }
+
+    // Deterministic values in [-2, 2], with the edge cases the kernels must
+    // treat like the scalar loop: both signed zeros and values equal to the
+    // 0.25 threshold/shift the tests use.
+    std::vector<double> makeInput(std::size_t n, double phase = 0.0)
+    {
+        std::vector<double> v(n);
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = 2.0 * std::sin(0.37 * static_cast<double>(i) + phase);
+        if (n > 2) v[2] = 0.25;
+        if (n > 5) v[5] = -0.0;
+        if (n > 6) v[6] = 0.0;
+        return v;
+    }
+
+    ::testing::AssertionResult sameBits(const std::vector<double>& expected, const std::vector<double>& got)
+    {
+        if (expected.size() != got.size())
+            return ::testing::AssertionFailure() << "size " << got.size() << " != " << expected.size();
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            if (std::bit_cast<std::uint64_t>(expected[i]) != std::bit_cast<std::uint64_t>(got[i]))
+                return ::testing::AssertionFailure() << "at " << i << ": " << got[i] << " != " << expected[i];
+        return ::testing::AssertionSuccess();
+    }
+
+    template<typename T>
+    std::vector<T> makeTaps(int M, bool symmetric)
+    {
+        std::vector<T> taps(M);
+        for (int m = 0; m < M; ++m)
+        {
+            const double x = m - (M - 1) / 2.0;
+            taps[m] = static_cast<T>(symmetric ? std::exp(-x * x / 18.0) : std::cos(0.4 * m) + 0.1 * m);
+        }
+        return taps;
+    }
+
+    template<typename T, typename Conv>
+    std::vector<T> runConv(Conv conv, const std::vector<T>& taps, const std::vector<T>& window, int n)
+    {
+        std::vector<T> out(n);
+        conv(taps.data(), static_cast<int>(taps.size()), window.data(), out.data(), n);
+        return out;
+    }
+}
+
+TEST(SimdDispatch, DetectedTierMatchesTheCpuFeatures)
+{
+    const SimdTier detected = detectedSimdTier();
+    EXPECT_EQ(detected >= SimdTier::Avx2, detail::avx2_fma_available());
+    if (detected == SimdTier::Avx512)
+        EXPECT_TRUE(detail::avx512f_available());
+    EXPECT_EQ(simdTier(), detected);
+    EXPECT_EQ(detail::simdKernels().tier, detected);
+}
+
+TEST(SimdDispatch, SetSimdTierIsCappedAtTheDetectedTier)
+{
+    const SimdTier detected = detectedSimdTier();
+    {
+        const ScopedSimdTier scalar(SimdTier::Scalar);
+        EXPECT_EQ(simdTier(), SimdTier::Scalar);
+        EXPECT_EQ(detail::simdKernels().heaviside_f64, &detail::heaviside_scalar_f64);
+        {
+            const ScopedSimdTier widest(SimdTier::Avx512);
+            EXPECT_EQ(simdTier(), detected);
+        }
+        EXPECT_EQ(simdTier(), SimdTier::Scalar);
+    }
+    EXPECT_EQ(simdTier(), detected);
+    EXPECT_EQ(detail::simdKernelsFor(SimdTier::Avx512).tier, detected);
+    EXPECT_STREQ(toString(SimdTier::Avx512), "avx512");
+}
+
+TEST(SimdDispatch, ElementwiseKernelsAreBitIdenticalToScalar)
+{
+    const auto& scalar = detail::simdKernelsFor(SimdTier::Scalar);
+    for (const SimdTier tier : vectorTiers())
+    {
+        const auto& simd = detail::simdKernelsFor(tier);
+        for (const std::size_t n : kLengths)
+        {
+            SCOPED_TRACE(::testing::Message() << toString(tier) << ", n=" << n);
+            const auto in = makeInput(n);
+            const auto other = makeInput(n, 1.3);
+
+            std::vector<double> expected(n), got(n);
+            scalar.heaviside_f64(in.data(), expected.data(), n, 0.25);
+            simd.heaviside_f64(in.data(), got.data(), n, 0.25);
+            EXPECT_TRUE(sameBits(expected, got)) << "heaviside";
+
+            scalar.abs_sigmoid_f64(in.data(), expected.data(), n, 4.0, 0.25);
+            simd.abs_sigmoid_f64(in.data(), got.data(), n, 4.0, 0.25);
+            EXPECT_TRUE(sameBits(expected, got)) << "abs sigmoid";
+
+            expected = in;
+            got = in;
+            scalar.euler_f64(expected.data(), other.data(), n, 0.1, -5.0);
+            simd.euler_f64(got.data(), other.data(), n, 0.1, -5.0);
+            EXPECT_TRUE(sameBits(expected, got)) << "euler";
+
+            expected = other;
+            got = other;
+            scalar.memory_trace_f64(in.data(), expected.data(), n, 0.25, 0.01, 0.001);
+            simd.memory_trace_f64(in.data(), got.data(), n, 0.25, 0.01, 0.001);
+            EXPECT_TRUE(sameBits(expected, got)) << "memory trace";
+
+            expected = in;
+            got = in;
+            scalar.accumulate_f64(expected.data(), other.data(), n);
+            simd.accumulate_f64(got.data(), other.data(), n);
+            EXPECT_TRUE(sameBits(expected, got)) << "accumulate";
+
+            expected = other;
+            got = other;
+            scalar.scaled_axpy_f64(expected.data(), in.data(), n, 0.7, -1.9);
+            simd.scaled_axpy_f64(got.data(), in.data(), n, 0.7, -1.9);
+            EXPECT_TRUE(sameBits(expected, got)) << "scaled axpy";
+        }
+    }
+}
+
+TEST(SimdDispatch, HeavisideTreatsNaNAsBelowTheShift)
+{
+    const std::vector<double> in(11, std::numeric_limits<double>::quiet_NaN());
+    for (const SimdTier tier : vectorTiers())
+    {
+        std::vector<double> out(in.size(), -1.0);
+        detail::simdKernelsFor(tier).heaviside_f64(in.data(), out.data(), in.size(), 0.0);
+        EXPECT_EQ(out, std::vector<double>(in.size(), 0.0)) << toString(tier);
+    }
+}
+
+TEST(SimdDispatch, SigmoidMatchesScalarToRounding)
+{
+    const auto& scalar = detail::simdKernelsFor(SimdTier::Scalar);
+    for (const SimdTier tier : vectorTiers())
+    {
+        for (const std::size_t n : kLengths)
+        {
+            SCOPED_TRACE(::testing::Message() << toString(tier) << ", n=" << n);
+            // Steep enough that part of the input hits the +-88 exponent clamp.
+            const auto in = makeInput(n);
+            std::vector<double> expected(n), got(n);
+            scalar.sigmoid_f64(in.data(), expected.data(), n, 60.0, 0.25);
+            detail::simdKernelsFor(tier).sigmoid_f64(in.data(), got.data(), n, 60.0, 0.25);
+            for (std::size_t i = 0; i < n; ++i)
+                EXPECT_NEAR(got[i], expected[i], 1e-14) << "at " << i;
+        }
+    }
+}
+
+TEST(SimdDispatch, ConvolutionsMatchScalarToRounding)
+{
+    const auto& scalar = detail::simdKernelsFor(SimdTier::Scalar);
+    for (const SimdTier tier : vectorTiers())
+    {
+        const auto& simd = detail::simdKernelsFor(tier);
+        for (const bool symmetric : { true, false })
+        {
+            for (const int n : { 1, 5, 37, 100, 131 })
+            {
+                SCOPED_TRACE(::testing::Message() << toString(tier) << ", n=" << n << ", symmetric=" << symmetric);
+                const int M = 15;
+                const auto taps = makeTaps<double>(M, symmetric);
+                const auto window = makeInput(static_cast<std::size_t>(n + M - 1));
+                const auto expected = runConv(scalar.conv_valid_f64, taps, window, n);
+                const auto got = runConv(simd.conv_valid_f64, taps, window, n);
+                for (int i = 0; i < n; ++i)
+                    EXPECT_NEAR(got[i], expected[i], 1e-12) << "at " << i;
+
+                const auto tapsF = makeTaps<float>(M, symmetric);
+                const std::vector<float> windowF(window.begin(), window.end());
+                const auto expectedF = runConv(scalar.conv_valid_f32, tapsF, windowF, n);
+                const auto gotF = runConv(simd.conv_valid_f32, tapsF, windowF, n);
+                for (int i = 0; i < n; ++i)
+                    EXPECT_NEAR(gotF[i], expectedF[i], 1e-4f) << "at " << i;
+            }
+        }
+    }
+}
+
+TEST(SimdDispatch, Avx512ConvolutionsAndSigmoidAreBitIdenticalToAvx2)
+{
+    if (detectedSimdTier() < SimdTier::Avx512)
+        GTEST_SKIP() << "host has no AVX-512F";
+
+    const auto& avx2 = detail::simdKernelsFor(SimdTier::Avx2);
+    const auto& avx512 = detail::simdKernelsFor(SimdTier::Avx512);
+    for (const bool symmetric : { true, false })
+    {
+        for (const int M : { 1, 7, 31 })
+        {
+            for (const int n : { 1, 3, 7, 8, 12, 15, 16, 33, 63, 64, 71, 100, 200 })
+            {
+                SCOPED_TRACE(::testing::Message() << "M=" << M << ", n=" << n << ", symmetric=" << symmetric);
+                const auto taps = makeTaps<double>(M, symmetric);
+                const auto window = makeInput(static_cast<std::size_t>(n + M - 1));
+                EXPECT_TRUE(sameBits(runConv(avx2.conv_valid_f64, taps, window, n),
+                                     runConv(avx512.conv_valid_f64, taps, window, n)));
+
+                const auto tapsF = makeTaps<float>(M, symmetric);
+                const std::vector<float> windowF(window.begin(), window.end());
+                EXPECT_EQ(runConv(avx2.conv_valid_f32, tapsF, windowF, n),
+                          runConv(avx512.conv_valid_f32, tapsF, windowF, n));
+            }
+        }
+    }
+
+    for (const std::size_t n : kLengths)
+    {
+        const auto in = makeInput(n);
+        std::vector<double> expected(n), got(n);
+        avx2.sigmoid_f64(in.data(), expected.data(), n, 60.0, 0.25);
+        avx512.sigmoid_f64(in.data(), got.data(), n, 60.0, 0.25);
+        EXPECT_TRUE(sameBits(expected, got)) << "sigmoid, n=" << n;
+    }
+}
+
+// The element-wise kernels end to end: input accumulation, the Euler update,
+// AbsSigmoid, Heaviside and the memory trace give the same fields at every
+// tier. (No kernels: the convolutions only agree to rounding.)
+TEST(SimdDispatch, ElementsStepIdenticallyAtEveryTier)
+{
+    test::ScopedMinLogLevel quiet(tools::logger::LogLevel::ERROR);
+    using namespace dnf_composer::element;
+    constexpr int kSize = 101; // not a multiple of any vector width
+
+    const auto run = [&](SimdTier tier)
+    {
+        const ScopedSimdTier scoped(tier);
+        auto sim = std::make_shared<Simulation>("simd tiers", 1.0, 0.0, 0.0);
+        sim->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim a", kSize },
+            GaussStimulusParameters{ 4.0, 8.0, 30.0 }));
+        sim->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stim b", kSize },
+            GaussStimulusParameters{ 6.0, 5.0, 60.0 }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "u", kSize },
+            NeuralFieldParameters{ 20.0, -4.0, AbsSigmoidFunction{ 0.0, 4.0 } }));
+        sim->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "v", kSize },
+            NeuralFieldParameters{ 15.0, -3.0, HeavisideFunction{ 0.0 } }));
+        sim->addElement(std::make_shared<MemoryTrace>(ElementCommonParameters{ "trace", kSize },
+            MemoryTraceParameters{ 20.0, 200.0, 0.4 }));
+        sim->createInteraction("stim a", "output", "u");
+        sim->createInteraction("stim b", "output", "u");
+        sim->createInteraction("stim b", "output", "v");
+        sim->createInteraction("u", "output", "trace");
+        sim->init();
+        for (int i = 0; i < 60; ++i)
+            sim->step();
+
+        std::vector<std::vector<double>> values;
+        for (const std::string name : { "u", "v" })
+        {
+            values.push_back(sim->getComponent(name, "activation"));
+            values.push_back(sim->getComponent(name, "output"));
+        }
+        values.push_back(sim->getComponent("trace", "output"));
+        return values;
+    };
+
+    const auto reference = run(SimdTier::Scalar);
+    for (const SimdTier tier : vectorTiers())
+    {
+        const auto got = run(tier);
+        ASSERT_EQ(got.size(), reference.size());
+        for (std::size_t i = 0; i < got.size(); ++i)
+            EXPECT_TRUE(sameBits(reference[i], got[i])) << toString(tier) << ", component " << i;
+    }
+}
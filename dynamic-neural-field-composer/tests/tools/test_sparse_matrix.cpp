@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "tools/math.h"
+#include "tools/sparse_matrix.h"
+
+using namespace dnf_composer::tools::math;
+
+namespace
+{
+    // A weight matrix where about a third of the entries are exact zeros and
+    // the rest span several orders of magnitude, so thresholds bite.
+    std::vector<double> makeWeights(std::size_t rows, std::size_t cols)
+    {
+        std::vector<double> weights(rows * cols);
+        for (std::size_t k = 0; k < weights.size(); ++k)
+            weights[k] = (k % 3 == 1) ? 0.0 : std::cos(0.37 * static_cast<double>(k)) * std::pow(10.0, -static_cast<double>(k % 4));
+        return weights;
+    }
+
+    std::vector<double> makeSignal(std::size_t n, double phase)
+    {
+        std::vector<double> signal(n);
+        for (std::size_t i = 0; i < n; ++i)
+            signal[i] = (i % 5 == 0) ? 0.0 : std::sin(phase + 0.71 * static_cast<double>(i));
+        return signal;
+    }
+
+    void expectBitIdentical(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        ASSERT_EQ(a.size(), b.size());
+        for (std::size_t k = 0; k < a.size(); ++k)
+            ASSERT_EQ(std::bit_cast<std::uint64_t>(a[k]), std::bit_cast<std::uint64_t>(b[k])) << "at " << k;
+    }
+
+    std::vector<double> toDense(const CsrMatrix& matrix)
+    {
+        std::vector<double> dense(matrix.rows * matrix.cols);
+        csr_to_dense(matrix, dense);
+        return dense;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Conversion
+// ---------------------------------------------------------------------------
+
+TEST(CsrMatrix, ThresholdZeroRoundTripsExactly)
+{
+    const auto weights = makeWeights(23, 41);
+    const CsrMatrix matrix = csr_from_dense(weights, 23, 41, 0.0);
+    EXPECT_EQ(matrix.rows, 23u);
+    EXPECT_EQ(matrix.cols, 41u);
+    EXPECT_EQ(matrix.rowStart.size(), 24u);
+    EXPECT_EQ(matrix.nonZeros(), static_cast<std::size_t>(std::ranges::count_if(weights, [](double w) { return w != 0.0; })));
+    expectBitIdentical(toDense(matrix), weights);
+}
+
+TEST(CsrMatrix, PrunesAtOrBelowThreshold)
+{
+    const std::vector<double> weights{ 0.5, -0.1, 0.0, 0.05,
+                                       -0.2, 0.1, 1e-9, -3.0 };
+    const CsrMatrix matrix = csr_from_dense(weights, 2, 4, 0.1);
+    ASSERT_EQ(matrix.nonZeros(), 3u);
+    EXPECT_EQ(matrix.rowStart, (std::vector<std::size_t>{ 0, 1, 3 }));
+    EXPECT_EQ(matrix.columns, (std::vector<std::uint32_t>{ 0, 0, 3 }));
+    EXPECT_EQ(matrix.values, (std::vector<double>{ 0.5, -0.2, -3.0 }));
+    EXPECT_LT(matrix.bytes(), weights.size() * sizeof(double));
+}
+
+TEST(CsrMatrix, KeepsNaN)
+{
+    const std::vector<double> weights{ std::numeric_limits<double>::quiet_NaN(), 0.0 };
+    const CsrMatrix matrix = csr_from_dense(weights, 1, 2, 1.0);
+    ASSERT_EQ(matrix.nonZeros(), 1u);
+    EXPECT_TRUE(std::isnan(matrix.values[0]));
+}
+
+TEST(CsrMatrix, PruneInPlaceMatchesPruningFromDense)
+{
+    const auto weights = makeWeights(17, 29);
+    CsrMatrix matrix = csr_from_dense(weights, 17, 29, 0.0);
+    csr_prune(matrix, 0.05);
+    const CsrMatrix expected = csr_from_dense(weights, 17, 29, 0.05);
+    EXPECT_EQ(matrix.rowStart, expected.rowStart);
+    EXPECT_EQ(matrix.columns, expected.columns);
+    EXPECT_EQ(matrix.values, expected.values);
+}
+
+TEST(CsrMatrix, SizeMismatchThrows)
+{
+    const std::vector<double> weights(3 * 4 - 1, 1.0);
+    EXPECT_THROW(csr_from_dense(weights, 3, 4, 0.0), std::invalid_argument);
+
+    const CsrMatrix matrix = csr_from_dense(std::vector<double>(12, 1.0), 3, 4, 0.0);
+    std::vector<double> dense(11);
+    EXPECT_THROW(csr_to_dense(matrix, dense), std::invalid_argument);
+    std::vector<double> out(4);
+    const std::vector<double> in(2, 1.0);
+    EXPECT_THROW(spmv_into(out, matrix, in, 1.0), std::invalid_argument);
+}
+
+// ---------------------------------------------------------------------------
+// spmv_into
+// ---------------------------------------------------------------------------
+
+TEST(SpmvInto, BitIdenticalToGemvAtThresholdZero)
+{
+    constexpr std::size_t inputSize = 37;
+    const std::size_t outputSize = kGemvBlock + 77;
+    const auto weights = makeWeights(inputSize, outputSize);
+    const auto in = makeSignal(inputSize, 0.3);
+
+    std::vector<double> dense(outputSize, 123.0), sparse(outputSize, -7.0);
+    gemv_into(dense, weights, in, 0.35);
+    spmv_into(sparse, csr_from_dense(weights, inputSize, outputSize, 0.0), in, 0.35);
+    expectBitIdentical(sparse, dense);
+}
+
+TEST(SpmvInto, PrunedMatchesGemvOnPrunedDense)
+{
+    constexpr std::size_t inputSize = 31, outputSize = 53;
+    const auto weights = makeWeights(inputSize, outputSize);
+    const auto in = makeSignal(inputSize, 1.1);
+    const CsrMatrix matrix = csr_from_dense(weights, inputSize, outputSize, 0.01);
+
+    std::vector<double> dense(outputSize), sparse(outputSize);
+    gemv_into(dense, toDense(matrix), in, -1.5);
+    spmv_into(sparse, matrix, in, -1.5);
+    expectBitIdentical(sparse, dense);
+}
+
+// ---------------------------------------------------------------------------
+// Learning rules on the retained entries
+// ---------------------------------------------------------------------------
+
+class SparseLearningRule : public ::testing::Test
+{
+protected:
+    static constexpr std::size_t inputSize = 19;
+    static constexpr std::size_t outputSize = 27;
+    const std::vector<double> input = makeSignal(inputSize, 0.2);
+    const std::vector<double> output = makeSignal(outputSize, 0.9);
+    const std::vector<double> actual = makeSignal(outputSize, 2.4);
+    CsrMatrix matrix = csr_from_dense(makeWeights(inputSize, outputSize), inputSize, outputSize, 0.01);
+    // The pruned matrix, densely: the dense rule's result on the retained
+    // entries is what the sparse rule must produce.
+    std::vector<double> dense = toDense(matrix);
+
+    void expectMatchesDenseOnRetained()
+    {
+        const auto updated = toDense(matrix);
+        std::vector<bool> retained(dense.size(), false);
+        for (std::size_t i = 0; i < matrix.rows; ++i)
+            for (std::size_t k = matrix.rowStart[i]; k < matrix.rowStart[i + 1]; ++k)
+                retained[i * outputSize + matrix.columns[k]] = true;
+        for (std::size_t k = 0; k < dense.size(); ++k)
+        {
+            if (retained[k])
+                ASSERT_EQ(std::bit_cast<std::uint64_t>(updated[k]), std::bit_cast<std::uint64_t>(dense[k])) << "at " << k;
+            else
+                ASSERT_EQ(updated[k], 0.0) << "pruned entry " << k << " changed";
+        }
+    }
+};
+
+TEST_F(SparseLearningRule, HebbMatchesDense)
+{
+    hebbLearningRule(dense, input, output, 0.05);
+    hebbLearningRule(matrix, input, output, 0.05);
+    expectMatchesDenseOnRetained();
+}
+
+TEST_F(SparseLearningRule, OjaMatchesDense)
+{
+    ojaLearningRule(dense, input, output, 0.05);
+    ojaLearningRule(matrix, input, output, 0.05);
+    expectMatchesDenseOnRetained();
+}
+
+TEST_F(SparseLearningRule, DeltaMatchesDense)
+{
+    deltaLearningRuleWidrowHoff(dense, input, output, actual, 0.05, 0.1);
+    deltaLearningRuleWidrowHoff(matrix, input, output, actual, 0.05, 0.1);
+    expectMatchesDenseOnRetained();
+}
+
+TEST_F(SparseLearningRule, SizeMismatchThrows)
+{
+    const std::vector<double> shortInput(inputSize - 1, 1.0);
+    EXPECT_THROW(hebbLearningRule(matrix, shortInput, output, 0.1), std::invalid_argument);
+    EXPECT_THROW(ojaLearningRule(matrix, shortInput, output, 0.1), std::invalid_argument);
+    EXPECT_THROW(deltaLearningRuleWidrowHoff(matrix, shortInput, output, actual, 0.1), std::invalid_argument);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "tools/thread_pool.h"
+
+using namespace dnf_composer::tools::threading;
+
+namespace
+{
+    struct CountingContext
+    {
+        std::atomic<std::size_t> pending{ 0 };
+        std::vector<std::atomic<int>> hits;
+        explicit CountingContext(std::size_t n) : hits(n) {}
+    };
+
+    void countHit(void* context, std::size_t index)
+    {
+        auto& ctx = *static_cast<CountingContext*>(context);
+        ctx.hits[index].fetch_add(1);
+        ctx.pending.fetch_sub(1);
+    }
+
+    struct ThreadIdContext
+    {
+        std::atomic<std::size_t> pending{ 0 };
+        std::vector<std::thread::id> ranOn;
+        explicit ThreadIdContext(std::size_t n) : ranOn(n) {}
+    };
+
+    void recordThread(void* context, std::size_t index)
+    {
+        auto& ctx = *static_cast<ThreadIdContext*>(context);
+        ctx.ranOn[index] = std::this_thread::get_id();
+        ctx.pending.fetch_sub(1);
+    }
+
+    constexpr std::size_t kOuterTasks = 8;
+    constexpr std::size_t kInnerTasks = 16;
+
+    struct NestedContext
+    {
+        ThreadPool* pool = nullptr;
+        std::atomic<std::size_t> pending{ 0 };
+        std::atomic<int> innerDone{ 0 };
+    };
+
+    struct InnerContext
+    {
+        std::atomic<std::size_t> pending{ 0 };
+        std::atomic<int>* done = nullptr;
+    };
+
+    void innerWork(void* context, std::size_t)
+    {
+        auto& inner = *static_cast<InnerContext*>(context);
+        inner.done->fetch_add(1);
+        inner.pending.fetch_sub(1);
+    }
+
+    void fanOut(void* context, std::size_t)
+    {
+        auto& outer = *static_cast<NestedContext*>(context);
+        InnerContext inner;
+        inner.done = &outer.innerDone;
+        inner.pending.store(kInnerTasks);
+        for (std::size_t i = 0; i < kInnerTasks; ++i)
+            outer.pool->submit({ &innerWork, &inner, i });
+        outer.pool->runUntil(inner.pending);
+        outer.pending.fetch_sub(1);
+    }
+}
+
+TEST(ThreadPool, ThreadCountIsClampedToAtLeastOne)
+{
+    ThreadPool zero(0);
+    EXPECT_EQ(zero.getThreadCount(), 1);
+    ThreadPool negative(-3);
+    EXPECT_EQ(negative.getThreadCount(), 1);
+    ThreadPool four(4);
+    EXPECT_EQ(four.getThreadCount(), 4);
+}
+
+TEST(ThreadPool, RunsEverySubmittedTaskExactlyOnce)
+{
+    for (const int threads : { 1, 2, 4, 8 })
+    {
+        ThreadPool pool(threads);
+        for (int round = 0; round < 50; ++round)
+        {
+            constexpr std::size_t kTasks = 64;
+            CountingContext ctx(kTasks);
+            ctx.pending.store(kTasks);
+            for (std::size_t i = 0; i < kTasks; ++i)
+                pool.submit({ &countHit, &ctx, i });
+            pool.runUntil(ctx.pending);
+
+            for (std::size_t i = 0; i < kTasks; ++i)
+                ASSERT_EQ(ctx.hits[i].load(), 1) << "threads=" << threads << " task=" << i;
+        }
+        EXPECT_EQ(pool.getExecutedTaskCount(), 50u * 64u) << "threads=" << threads;
+    }
+}
+
+TEST(ThreadPool, PinnedTasksRunOnTheDrivingThread)
+{
+    ThreadPool pool(4);
+    constexpr std::size_t kTasks = 32;
+    ThreadIdContext ctx(kTasks);
+    ctx.pending.store(kTasks);
+    for (std::size_t i = 0; i < kTasks; ++i)
+        pool.submitPinned({ &recordThread, &ctx, i });
+    pool.runUntil(ctx.pending);
+
+    for (std::size_t i = 0; i < kTasks; ++i)
+        EXPECT_EQ(ctx.ranOn[i], std::this_thread::get_id()) << "task " << i;
+}
+
+TEST(ThreadPool, TasksMaySubmitAndWaitOnNestedWork)
+{
+    // A task that fans out more work and waits for it (what a parallel loop
+    // inside an element's step() does) must not deadlock, even when every
+    // pool thread is running such a task at once.
+    ThreadPool pool(4);
+    NestedContext outer;
+    outer.pool = &pool;
+    outer.pending.store(kOuterTasks);
+    for (std::size_t i = 0; i < kOuterTasks; ++i)
+        pool.submit({ &fanOut, &outer, i });
+    pool.runUntil(outer.pending);
+
+    EXPECT_EQ(outer.innerDone.load(), static_cast<int>(kOuterTasks * kInnerTasks));
+}
+
+TEST(ThreadPool, IdlePoolCanBeReusedAfterWorkersPark)
+{
+    ThreadPool pool(3);
+    for (int round = 0; round < 3; ++round)
+    {
+        // Long enough for idle workers to stop spinning and park on the
+        // condition variable; the next submit must still wake them.
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CountingContext ctx(16);
+        ctx.pending.store(16);
+        for (std::size_t i = 0; i < 16; ++i)
+            pool.submit({ &countHit, &ctx, i });
+        pool.runUntil(ctx.pending);
+        for (std::size_t i = 0; i < 16; ++i)
+            EXPECT_EQ(ctx.hits[i].load(), 1);
+    }
+}
+
+TEST(ParallelFor, RunsInlineInOrderWithoutACurrentPool)
+{
+    const ScopedCurrentPool none(nullptr);
+    EXPECT_EQ(currentParallelism(), 1);
+    std::vector<std::size_t> order;
+    parallelFor(5, [&](std::size_t i) { order.push_back(i); });
+    EXPECT_EQ(order, (std::vector<std::size_t>{ 0, 1, 2, 3, 4 }));
+}
+
+TEST(ParallelFor, SpreadsOverTheCurrentPoolAndRunsEveryIndexOnce)
+{
+    ThreadPool pool(4);
+    const ScopedCurrentPool current(&pool);
+    EXPECT_EQ(ThreadPool::current(), &pool);
+    EXPECT_EQ(currentParallelism(), 4);
+    for (int round = 0; round < 50; ++round)
+    {
+        std::vector<std::atomic<int>> hits(37);
+        parallelFor(hits.size(), [&](std::size_t i) { hits[i].fetch_add(1); });
+        for (std::size_t i = 0; i < hits.size(); ++i)
+            ASSERT_EQ(hits[i].load(), 1) << "round " << round << " index " << i;
+    }
+}
+
+TEST(ParallelFor, NestsInsideTasksOfThePool)
+{
+    // What an element's split convolution does when the scheduler runs it on
+    // a worker: the loop must use the worker's pool and finish.
+    ThreadPool pool(3);
+    struct Outer
+    {
+        ThreadPool* pool = nullptr;
+        std::atomic<std::size_t> pending{ 0 };
+        std::atomic<int> inner{ 0 };
+        std::atomic<int> wrongPool{ 0 };
+    } outer;
+    outer.pool = &pool;
+    outer.pending.store(kOuterTasks);
+    const auto task = [](void* context, std::size_t)
+        {
+            auto& self = *static_cast<Outer*>(context);
+            if (ThreadPool::current() != self.pool)
+                self.wrongPool.fetch_add(1);
+            parallelFor(kInnerTasks, [&](std::size_t) { self.inner.fetch_add(1); });
+            self.pending.fetch_sub(1);
+        };
+    for (std::size_t i = 0; i < kOuterTasks; ++i)
+        pool.submit({ task, &outer, i });
+    pool.runUntil(outer.pending);
+
+    EXPECT_EQ(outer.wrongPool.load(), 0);
+    EXPECT_EQ(outer.inner.load(), static_cast<int>(kOuterTasks * kInnerTasks));
+    EXPECT_EQ(ThreadPool::current(), nullptr);
+}
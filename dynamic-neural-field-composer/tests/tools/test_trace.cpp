@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "tools/trace.h"
+
+namespace fs = std::filesystem;
+using namespace dnf_composer::tools;
+
+namespace
+{
+    fs::path tracePath(const std::string& name)
+    {
+        return fs::temp_directory_path() / "dnf_composer_trace_test" / (name + ".json");
+    }
+
+    nlohmann::json readTrace(const fs::path& path)
+    {
+        std::ifstream in(path);
+        return nlohmann::json::parse(in);
+    }
+
+    // The complete ("X") events of a trace, without the metadata.
+    std::vector<nlohmann::json> spans(const nlohmann::json& trace)
+    {
+        std::vector<nlohmann::json> result;
+        for (const auto& event : trace["traceEvents"])
+            if (event["ph"] == "X")
+                result.push_back(event);
+        return result;
+    }
+}
+
+TEST(Trace, SpansAreWrittenPerThread)
+{
+    const fs::path path = tracePath("per_thread");
+    trace::start(path.string());
+    ASSERT_TRUE(trace::isActive());
+    {
+        const trace::Span outer("outer", "test");
+        const trace::Span inner("inner", "test");
+    }
+    std::thread worker([]
+        {
+            trace::setThreadName("trace test worker");
+            const trace::Span span("on worker", "test");
+        });
+    worker.join();
+    EXPECT_EQ(trace::stop(), path.string());
+    EXPECT_FALSE(trace::isActive());
+
+    const nlohmann::json trace = readTrace(path);
+    const auto events = spans(trace);
+    ASSERT_EQ(events.size(), 3u);
+    std::set<int> tids;
+    for (const auto& event : events)
+    {
+        EXPECT_EQ(event["cat"], "test");
+        EXPECT_GE(event["ts"].get<double>(), 0.0);
+        EXPECT_GE(event["dur"].get<double>(), 0.0);
+        tids.insert(event["tid"].get<int>());
+    }
+    EXPECT_EQ(tids.size(), 2u);
+
+    // Inner closes first and lies within outer.
+    EXPECT_EQ(events[0]["name"], "inner");
+    EXPECT_EQ(events[1]["name"], "outer");
+    EXPECT_GE(events[0]["ts"].get<double>(), events[1]["ts"].get<double>());
+    EXPECT_LE(events[0]["ts"].get<double>() + events[0]["dur"].get<double>(),
+              events[1]["ts"].get<double>() + events[1]["dur"].get<double>() + 1e-3);
+
+    bool named = false;
+    for (const auto& event : trace["traceEvents"])
+        if (event["ph"] == "M" && event["name"] == "thread_name" && event["args"]["name"] == "trace test worker")
+            named = event["tid"] == events[2]["tid"];
+    EXPECT_TRUE(named);
+    fs::remove_all(path.parent_path());
+}
+
+TEST(Trace, NothingIsRecordedOutsideASession)
+{
+    EXPECT_EQ(trace::stop(), "");
+    {
+        const trace::Span before("before", "test");
+    }
+
+    const fs::path first = tracePath("first");
+    const fs::path second = tracePath("second");
+    trace::start(first.string());
+    std::optional<trace::Span> straddling;
+    straddling.emplace("straddling", "test");
+    // Writes the first session; the open span belongs to neither.
+    trace::start(second.string());
+    straddling.reset();
+    const auto now = std::chrono::steady_clock::now();
+    trace::record("recorded", "test", now, now);
+    trace::stop();
+    {
+        const trace::Span after("after", "test");
+    }
+
+    EXPECT_TRUE(spans(readTrace(first)).empty());
+    const auto events = spans(readTrace(second));
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0]["name"], "recorded");
+    EXPECT_EQ(events[0]["dur"].get<double>(), 0.0);
+    fs::remove_all(first.parent_path());
+}
+
+TEST(Trace, NamesAreEscapedAndFullBuffersDrop)
+{
+    const fs::path path = tracePath("capacity");
+    trace::start(path.string(), 4);
+    const std::string name = "quote \" backslash \\ tab\t";
+    for (int i = 0; i < 10; ++i)
+    {
+        const trace::Span span(name, "test");
+    }
+    trace::stop();
+
+    const auto events = spans(readTrace(path));
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0]["name"], name);
+    fs::remove_all(path.parent_path());
+}
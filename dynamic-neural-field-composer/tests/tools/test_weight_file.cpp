@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "tools/sparse_matrix.h"
+#include "tools/weight_file.h"
+
+using namespace dnf_composer::tools;
+using namespace dnf_composer::tools::weight_file;
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::vector<double> makeWeights(std::size_t rows, std::size_t cols)
+    {
+        std::vector<double> weights(rows * cols);
+        for (std::size_t k = 0; k < weights.size(); ++k)
+            weights[k] = (k % 4 == 0) ? std::sin(0.3 * static_cast<double>(k)) / 3.0 : 0.0;
+        return weights;
+    }
+
+    // Overwrites `count` bytes of `path` at `offset`.
+    void patch(const std::string& path, std::size_t offset, const void* bytes, std::size_t count)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+    }
+}
+
+class WeightFileTest : public ::testing::Test
+{
+protected:
+    std::string tempDir;
+
+    void SetUp() override
+    {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        tempDir = (fs::temp_directory_path() / "dnf_weight_file_tests" / info->name()).string();
+        fs::create_directories(tempDir);
+    }
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        fs::remove_all(tempDir, ec);
+    }
+
+    std::string path(const std::string& name) const { return tempDir + "/" + name; }
+};
+
+TEST_F(WeightFileTest, DenseRoundTripIsExact)
+{
+    auto weights = makeWeights(13, 21);
+    weights[5] = std::numeric_limits<double>::denorm_min();
+    weights[6] = -0.0;
+    writeDense(path("a_weights.dnfw"), weights, 13, 21);
+
+    const MappedWeightFile file(path("a_weights.dnfw"));
+    EXPECT_EQ(file.rows(), 13u);
+    EXPECT_EQ(file.cols(), 21u);
+    EXPECT_EQ(file.layout(), WeightLayout::Dense);
+    EXPECT_EQ(file.header().version, kVersion);
+    EXPECT_EQ(fs::file_size(path("a_weights.dnfw")), kHeaderSize + weights.size() * sizeof(double));
+    EXPECT_TRUE(file.verifyChecksum());
+
+    const auto mapped = file.dense();
+    ASSERT_EQ(mapped.size(), weights.size());
+    EXPECT_EQ(std::memcmp(mapped.data(), weights.data(), weights.size() * sizeof(double)), 0);
+    EXPECT_FALSE(fs::exists(path("a_weights.dnfw.tmp")));
+}
+
+TEST_F(WeightFileTest, CopyOnWriteMappingNeverWritesTheFile)
+{
+    const auto weights = makeWeights(4, 6);
+    writeDense(path("cow_weights.dnfw"), weights, 4, 6);
+
+    EXPECT_THROW(MappedWeightFile(path("cow_weights.dnfw")).mutableDense(), std::logic_error);
+    {
+        const MappedWeightFile file(path("cow_weights.dnfw"), MappedFile::Access::CopyOnWrite);
+        const auto values = file.mutableDense();
+        ASSERT_EQ(values.size(), weights.size());
+        values[0] = 42.0;
+        EXPECT_EQ(file.dense()[0], 42.0);
+    }
+    const MappedWeightFile reopened(path("cow_weights.dnfw"));
+    EXPECT_EQ(reopened.dense()[0], weights[0]);
+    EXPECT_TRUE(reopened.verifyChecksum());
+}
+
+TEST_F(WeightFileTest, CsrRoundTripDensifiesAndRePrunes)
+{
+    const auto weights = makeWeights(9, 15);
+    const auto csr = math::csr_from_dense(weights, 9, 15, 0.0);
+    writeCsr(path("b_weights.dnfw"), csr);
+
+    const MappedWeightFile file(path("b_weights.dnfw"));
+    EXPECT_EQ(file.layout(), WeightLayout::Csr);
+    EXPECT_EQ(file.header().entries, csr.nonZeros());
+    EXPECT_TRUE(file.verifyChecksum());
+    EXPECT_THROW(file.dense(), std::logic_error);
+
+    std::vector<double> dense(weights.size(), 7.0);
+    file.copyDenseInto(dense);
+    EXPECT_EQ(dense, weights);
+
+    const auto pruned = file.toCsr(0.2);
+    const auto expected = math::csr_from_dense(weights, 9, 15, 0.2);
+    EXPECT_EQ(pruned.rowStart, expected.rowStart);
+    EXPECT_EQ(pruned.columns, expected.columns);
+    EXPECT_EQ(pruned.values, expected.values);
+}
+
+TEST_F(WeightFileTest, DenseFileConvertsToCsr)
+{
+    const auto weights = makeWeights(6, 10);
+    writeDense(path("c_weights.dnfw"), weights, 6, 10);
+    const auto csr = MappedWeightFile(path("c_weights.dnfw")).toCsr(0.0);
+    const auto expected = math::csr_from_dense(weights, 6, 10, 0.0);
+    EXPECT_EQ(csr.columns, expected.columns);
+    EXPECT_EQ(csr.values, expected.values);
+}
+
+TEST_F(WeightFileTest, CorruptPayloadFailsChecksum)
+{
+    const auto weights = makeWeights(8, 8);
+    writeDense(path("d_weights.dnfw"), weights, 8, 8);
+    const double flipped = 42.0;
+    patch(path("d_weights.dnfw"), kHeaderSize + 3 * sizeof(double), &flipped, sizeof(flipped));
+    EXPECT_FALSE(MappedWeightFile(path("d_weights.dnfw")).verifyChecksum());
+}
+
+TEST_F(WeightFileTest, RejectsInvalidFiles)
+{
+    const auto weights = makeWeights(4, 5);
+    const std::string file = path("e_weights.dnfw");
+
+    EXPECT_THROW(MappedWeightFile(path("missing.dnfw")), std::runtime_error);
+
+    { std::ofstream(file, std::ios::binary) << "DNFW"; }
+    EXPECT_THROW(MappedWeightFile{ file }, std::runtime_error); // shorter than a header
+
+    writeDense(file, weights, 4, 5);
+    patch(file, 0, "XNFW", 4);
+    EXPECT_THROW(MappedWeightFile{ file }, std::runtime_error); // magic
+
+    writeDense(file, weights, 4, 5);
+    const std::uint16_t newer = kVersion + 1;
+    patch(file, 4, &newer, sizeof(newer));
+    EXPECT_THROW(MappedWeightFile{ file }, std::runtime_error); // version
+
+    writeDense(file, weights, 4, 5);
+    const std::uint64_t rows = 5;
+    patch(file, 16, &rows, sizeof(rows));
+    EXPECT_THROW(MappedWeightFile{ file }, std::runtime_error); // dimensions vs payload
+
+    writeDense(file, weights, 4, 5);
+    fs::resize_file(file, fs::file_size(file) - 8);
+    EXPECT_THROW(MappedWeightFile{ file }, std::runtime_error); // truncated
+}
+
+TEST_F(WeightFileTest, SizeMismatchThrows)
+{
+    const std::vector<double> weights(11, 1.0);
+    EXPECT_THROW(writeDense(path("f_weights.dnfw"), weights, 3, 4), std::invalid_argument);
+
+    writeDense(path("f_weights.dnfw"), std::vector<double>(12, 1.0), 3, 4);
+    std::vector<double> dense(11);
+    EXPECT_THROW(MappedWeightFile(path("f_weights.dnfw")).copyDenseInto(dense), std::invalid_argument);
+}
@@ -0,0 +1,95 @@
+// Single-precision accuracy report — 2D.
+//
+// Re-runs every vendored 2D validation deck under tools::math::Precision::Single
+// (float convolution, see include/tools/precision.h) and compares the result
+// with the same double-precision reference CSVs test_field_dynamics_2d.cpp
+// uses. It writes a per-deck report (single_precision_2d_<dim>.csv in
+// GoogleTest's temporary directory, ::testing::TempDir(), plus a summary line
+// per dimension, so a test run leaves nothing in the working tree) listing how
+// far each deck moves, and requires every deck to stay within kAbsTolerance
+// except the two knife-edge ones the double-precision suite also excludes
+// (test_field_dynamics_2d.cpp): sim_049/sim_050_abssigmoid_b100, whose
+// self-sustained bump survives or decays after the stimulus is removed
+// depending on sub-ULP differences. For those, only the phase with the
+// stimulus is held to kAbsTolerance.
+
+#include "validation_common.h"
+#include "tools/precision.h"
+
+#include <iostream>
+
+using namespace dnf_composer::test_validation;
+using namespace dnf_composer::tools::math;
+
+namespace
+{
+	bool isKnifeEdge(const std::string& stem)
+	{
+		return stem == "sim_049_abssigmoid_b100" || stem == "sim_050_abssigmoid_b100";
+	}
+
+	bool allFinite(const std::vector<double>& values)
+	{
+		return std::ranges::all_of(values, [](double v) { return std::isfinite(v); });
+	}
+
+	void reportSinglePrecision(const std::string& dim)
+	{
+		const auto quiet = silenceLogging();
+		const ScopedPrecision precision(Precision::Single);
+
+		const auto stems = collectSimStems(dim);
+		if (stems.empty())
+			GTEST_SKIP() << "No " << dim << " validation sims found under " << VALIDATION_DATA_DIR
+			             << "/" << dim << "/simulations";
+
+		const fs::path reportPath = fs::path(::testing::TempDir()) / ("single_precision_2d_" + dim + ".csv");
+		std::ofstream report(reportPath);
+		report << "deck,max_abs_dev_with_stimulus,max_abs_dev_without_stimulus,within_tolerance\n";
+
+		std::size_t within = 0;
+		double worst = 0.0;
+		std::string worstStem;
+		for (const auto& stem : stems)
+		{
+			SCOPED_TRACE(dim + " sim (Single): " + stem);
+			try
+			{
+				const ProtocolResult got = runProtocol(simJsonPath(dim, stem));
+				EXPECT_TRUE(allFinite(got.with_stimulus) && allFinite(got.without_stimulus))
+					<< stem << " produced a non-finite activation in single precision";
+
+				const double devWith = maxAbsDeviation(got.with_stimulus, loadCsv(expectedCsvPath(dim, stem, true)));
+				const double devWithout = maxAbsDeviation(got.without_stimulus, loadCsv(expectedCsvPath(dim, stem, false)));
+				const bool ok = devWith <= kAbsTolerance && devWithout <= kAbsTolerance;
+				EXPECT_LE(devWith, kAbsTolerance) << stem << " with stimulus";
+				if (!isKnifeEdge(stem))
+					EXPECT_LE(devWithout, kAbsTolerance) << stem << " without stimulus";
+				within += ok ? 1 : 0;
+				if (std::max(devWith, devWithout) > worst)
+				{
+					worst = std::max(devWith, devWithout);
+					worstStem = stem;
+				}
+				report << stem << ',' << devWith << ',' << devWithout << ',' << (ok ? "yes" : "no") << '\n';
+			}
+			catch (const std::exception& e) { ADD_FAILURE() << dim << " sim " << stem << " threw: " << e.what(); }
+		}
+
+		std::cout << "[ single precision ] " << dim << ": " << within << "/" << stems.size()
+		          << " decks within " << kAbsTolerance << ", worst " << worstStem << " (" << worst
+		          << "), report: " << reportPath.string() << '\n';
+		::testing::Test::RecordProperty("decks", static_cast<int>(stems.size()));
+		::testing::Test::RecordProperty("within_tolerance", static_cast<int>(within));
+	}
+}
+
+TEST(SinglePrecision2D, ValidationDecksReport)
+{
+	reportSinglePrecision("2d");
+}
+
+TEST(SinglePrecision2D, SpectralDecksReport)
+{
+	reportSinglePrecision("2d_spectral");
+}